@@ -0,0 +1,1220 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Base header file.  Must be first.
+#include <xalanc/Include/PlatformDefinitions.hpp>
+
+
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+
+
+
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLUni.hpp>
+
+
+
+#include <xalanc/XalanDOM/XalanNamedNodeMap.hpp>
+#include <xalanc/XalanDOM/XalanNode.hpp>
+
+
+
+#include <xalanc/PlatformSupport/XalanArenaMemoryManager.hpp>
+#include <xalanc/PlatformSupport/XalanChunkedOutputStream.hpp>
+#include <xalanc/PlatformSupport/XalanMemoryManagerDefault.hpp>
+#include <xalanc/PlatformSupport/XalanMemoryOutputStream.hpp>
+#include <xalanc/PlatformSupport/XalanOutputStreamPrintWriter.hpp>
+#include <xalanc/PlatformSupport/XalanStdOutputStream.hpp>
+#include <xalanc/PlatformSupport/XalanThreadCachingMemoryManager.hpp>
+
+
+
+#include <xalanc/XMLSupport/FormatterToXMLUnicode.hpp>
+#include <xalanc/XMLSupport/XalanDummyIndentWriter.hpp>
+#include <xalanc/XMLSupport/XalanOtherEncodingWriter.hpp>
+
+
+
+#include <xalanc/XSLT/ElemTemplateElement.hpp>
+#include <xalanc/XSLT/StylesheetConstructionContext.hpp>
+#include <xalanc/XSLT/StylesheetRoot.hpp>
+#include <xalanc/XSLT/TraceListener.hpp>
+#include <xalanc/XSLT/TracerEvent.hpp>
+
+
+
+#include <xalanc/XalanTransformer/XalanCompiledStylesheet.hpp>
+#include <xalanc/XalanTransformer/XalanParsedSource.hpp>
+#include <xalanc/XalanTransformer/XalanTransformer.hpp>
+
+
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::ostringstream;
+using std::string;
+
+using xalanc::ElemTemplateElement;
+using xalanc::FormatterListener;
+using xalanc::GenerateEvent;
+using xalanc::MemoryManager;
+using xalanc::SelectionEvent;
+using xalanc::StylesheetConstructionContext;
+using xalanc::TraceListener;
+using xalanc::TracerEvent;
+using xalanc::XalanArenaMemoryManager;
+using xalanc::XalanChunkedOutputStream;
+using xalanc::XalanCompiledStylesheet;
+using xalanc::XalanDOMString;
+using xalanc::XalanFormatterWriter;
+using xalanc::XalanMemMgrAutoPtr;
+using xalanc::XalanMemoryManager;
+using xalanc::XalanMemoryManagerDefault;
+using xalanc::XalanMemoryOutputStream;
+using xalanc::XalanNamedNodeMap;
+using xalanc::XalanNode;
+using xalanc::XalanOutputStreamPrintWriter;
+using xalanc::XalanParsedSource;
+using xalanc::XalanSize_t;
+using xalanc::XalanStdOutputStream;
+using xalanc::XalanThreadCachingMemoryManager;
+using xalanc::XalanTransformer;
+using xalanc::XalanXMLSerializerBase;
+using xalanc::XSLTInputSource;
+using xalanc::XSLTResultTarget;
+
+
+
+namespace {
+
+
+
+// Each mode function runs one transformation with a transformer and a
+// stylesheet compiled by it, and returns the result in theOutput.
+typedef int (*ModeFunctionType)(
+            XalanTransformer&               theTransformer,
+            const XalanCompiledStylesheet*  theStylesheet,
+            const char*                     theSourceFileName,
+            MemoryManager&                  theManager,
+            string&                         theOutput);
+
+
+
+int
+transformNormal(
+            XalanTransformer&               theTransformer,
+            const XalanCompiledStylesheet*  theStylesheet,
+            const char*                     theSourceFileName,
+            MemoryManager&                  theManager,
+            string&                         theOutput)
+{
+    ostringstream   theStream;
+
+    const int   theResult =
+        theTransformer.transform(
+            XSLTInputSource(theSourceFileName, theManager),
+            theStylesheet,
+            XSLTResultTarget(theStream, theManager));
+
+    theOutput = theStream.str();
+
+    return theResult;
+}
+
+
+
+// An image whose header counts don't match its size must be refused,
+// instead of being read past its end.  The counts are the 32-bit
+// words after the magic number, version, byte order mark, character
+// size and URI index.
+bool
+testDamagedImages(MemoryManager&    theManager)
+{
+    const char* const   theName = "Damaged source images";
+
+    const char* const   theImageFileName = "damaged.img";
+
+    XalanTransformer    theTransformer(theManager);
+
+    if (theTransformer.createSourceImage(
+            XSLTInputSource("image.xml", theManager),
+            theImageFileName) != 0)
+    {
+        cerr << theName << ": the image could not be created." << endl;
+
+        return false;
+    }
+
+    string  theImage;
+
+    {
+        std::ifstream   theStream(theImageFileName, std::ios::binary);
+
+        theImage.assign(
+            std::istreambuf_iterator<char>(theStream),
+            std::istreambuf_iterator<char>());
+    }
+
+    bool    fResult = true;
+
+    // Each count in turn is made far larger than the image, and
+    // then the image is cut short.
+    for (size_t theWord = 5; theWord <= 8 && fResult == true; ++theWord)
+    {
+        string  theDamagedImage(theImage);
+
+        if (theWord < 8)
+        {
+            std::memset(&theDamagedImage[theWord * 4], 0xFF, 4);
+        }
+        else
+        {
+            theDamagedImage.resize(theDamagedImage.size() - 4);
+        }
+
+        {
+            std::ofstream   theStream(theImageFileName, std::ios::binary);
+
+            theStream.write(theDamagedImage.data(), theDamagedImage.size());
+        }
+
+        const XalanParsedSource*    theParsedSource = 0;
+
+        if (theTransformer.parseSourceImage(
+                theImageFileName,
+                theParsedSource) == 0)
+        {
+            cerr << theName << ": a damaged image was loaded." << endl;
+
+            fResult = false;
+        }
+    }
+
+    std::remove(theImageFileName);
+
+    if (fResult == true)
+    {
+        cout << theName << ": passed." << endl;
+    }
+
+    return fResult;
+}
+
+
+
+// Determine if two elements, and their descendants, have attributes
+// with the same names, namespace URIs, local names and prefixes.
+bool
+haveSameAttributeNames(
+            const XalanNode&    theFirst,
+            const XalanNode&    theSecond)
+{
+    const XalanNamedNodeMap* const  theFirstAttributes = theFirst.getAttributes();
+    const XalanNamedNodeMap* const  theSecondAttributes = theSecond.getAttributes();
+
+    if (theFirstAttributes != 0 && theSecondAttributes != 0)
+    {
+        if (theFirstAttributes->getLength() != theSecondAttributes->getLength())
+        {
+            return false;
+        }
+
+        for (XalanSize_t i = 0; i < theFirstAttributes->getLength(); ++i)
+        {
+            const XalanNode* const  theFirstAttribute = theFirstAttributes->item(i);
+            const XalanNode* const  theSecondAttribute = theSecondAttributes->item(i);
+
+            if (theFirstAttribute->getNodeName() != theSecondAttribute->getNodeName() ||
+                theFirstAttribute->getNamespaceURI() != theSecondAttribute->getNamespaceURI() ||
+                theFirstAttribute->getLocalName() != theSecondAttribute->getLocalName() ||
+                theFirstAttribute->getPrefix() != theSecondAttribute->getPrefix())
+            {
+                return false;
+            }
+        }
+    }
+    else if (theFirstAttributes != theSecondAttributes)
+    {
+        return false;
+    }
+
+    const XalanNode*    theFirstChild = theFirst.getFirstChild();
+    const XalanNode*    theSecondChild = theSecond.getFirstChild();
+
+    while (theFirstChild != 0 && theSecondChild != 0)
+    {
+        if (haveSameAttributeNames(*theFirstChild, *theSecondChild) == false)
+        {
+            return false;
+        }
+
+        theFirstChild = theFirstChild->getNextSibling();
+        theSecondChild = theSecondChild->getNextSibling();
+    }
+
+    return theFirstChild == theSecondChild;
+}
+
+
+
+// The attributes of a document loaded from an image must have the
+// names they have when it's parsed, including default namespace
+// declarations, which have no prefix.
+bool
+testImageAttributeNames(MemoryManager&  theManager)
+{
+    const char* const   theName = "Source image attribute names";
+
+    const char* const   theImageFileName = "namespaces.img";
+
+    XalanTransformer    theTransformer(theManager);
+
+    const XalanParsedSource*    theParsedSource = 0;
+    const XalanParsedSource*    theImageSource = 0;
+
+    bool    fResult = false;
+
+    if (theTransformer.parseSource(
+            XSLTInputSource("namespaces.xml", theManager),
+            theParsedSource) != 0 ||
+        theTransformer.createSourceImage(
+            XSLTInputSource("namespaces.xml", theManager),
+            theImageFileName) != 0 ||
+        theTransformer.parseSourceImage(
+            theImageFileName,
+            theImageSource) != 0)
+    {
+        cerr << theName << ": "
+             << theTransformer.getLastError()
+             << endl;
+    }
+    else if (haveSameAttributeNames(
+                *theParsedSource->getDocument(),
+                *theImageSource->getDocument()) == false)
+    {
+        cerr << theName << ": the attribute names don't match the parsed document." << endl;
+    }
+    else
+    {
+        fResult = true;
+    }
+
+    std::remove(theImageFileName);
+
+    if (fResult == true)
+    {
+        cout << theName << ": passed." << endl;
+    }
+
+    return fResult;
+}
+
+
+
+// The document is written to an image, which is loaded again
+// and transformed in place of the original.
+int
+transformSourceImage(
+            XalanTransformer&               theTransformer,
+            const XalanCompiledStylesheet*  theStylesheet,
+            const char*                     theSourceFileName,
+            MemoryManager&                  theManager,
+            string&                         theOutput)
+{
+    const char* const   theImageFileName = "modes.img";
+
+    int     theResult =
+        theTransformer.createSourceImage(
+            XSLTInputSource(theSourceFileName, theManager),
+            theImageFileName);
+
+    if (theResult == 0)
+    {
+        const XalanParsedSource*    theParsedSource = 0;
+
+        theResult =
+            theTransformer.parseSourceImage(
+                theImageFileName,
+                theParsedSource);
+
+        if (theResult == 0)
+        {
+            ostringstream   theStream;
+
+            theResult =
+                theTransformer.transform(
+                    *theParsedSource,
+                    theStylesheet,
+                    XSLTResultTarget(theStream, theManager));
+
+            theOutput = theStream.str();
+
+            theTransformer.destroyParsedSource(theParsedSource);
+        }
+    }
+
+    std::remove(theImageFileName);
+
+    return theResult;
+}
+
+
+
+int
+transformStreaming(
+            XalanTransformer&               theTransformer,
+            const XalanCompiledStylesheet*  theStylesheet,
+            const char*                     theSourceFileName,
+            MemoryManager&                  theManager,
+            string&                         theOutput)
+{
+    // Make sure the transformation really takes the streamed path.
+    if (theStylesheet->getStylesheetRoot()->isStreamable() == false)
+    {
+        cerr << "The stylesheet is not streamable." << endl;
+
+        return -1;
+    }
+
+    theTransformer.setStreamingMode(true);
+
+    return transformNormal(
+                theTransformer,
+                theStylesheet,
+                theSourceFileName,
+                theManager,
+                theOutput);
+}
+
+
+
+int
+transformProjected(
+            XalanTransformer&               theTransformer,
+            const XalanCompiledStylesheet*  theStylesheet,
+            const char*                     theSourceFileName,
+            MemoryManager&                  theManager,
+            string&                         theOutput)
+{
+    // Make sure the source tree is really pruned.
+    if (theStylesheet->getStylesheetRoot()->getSourceProjection() == 0)
+    {
+        cerr << "The stylesheet has no source projection." << endl;
+
+        return -1;
+    }
+
+    theTransformer.setUseSourceProjection(true);
+
+    return transformNormal(
+                theTransformer,
+                theStylesheet,
+                theSourceFileName,
+                theManager,
+                theOutput);
+}
+
+
+
+// The output streams start small, so they must grow, or add
+// chunks, many times during the transformation.
+int
+transformMemoryOutputStream(
+            XalanTransformer&               theTransformer,
+            const XalanCompiledStylesheet*  theStylesheet,
+            const char*                     theSourceFileName,
+            MemoryManager&                  theManager,
+            string&                         theOutput)
+{
+    XalanMemoryOutputStream     theStream(theManager, 64);
+
+    const int   theResult =
+        theTransformer.transform(
+            XSLTInputSource(theSourceFileName, theManager),
+            theStylesheet,
+            XSLTResultTarget(theStream, theManager));
+
+    theOutput.assign(theStream.getData(), theStream.getSize());
+
+    return theResult;
+}
+
+
+
+int
+transformChunkedOutputStream(
+            XalanTransformer&               theTransformer,
+            const XalanCompiledStylesheet*  theStylesheet,
+            const char*                     theSourceFileName,
+            MemoryManager&                  theManager,
+            string&                         theOutput)
+{
+    XalanChunkedOutputStream    theStream(theManager, 256);
+
+    const int   theResult =
+        theTransformer.transform(
+            XSLTInputSource(theSourceFileName, theManager),
+            theStylesheet,
+            XSLTResultTarget(theStream, theManager));
+
+    if (theResult == 0 && theStream.getChunkCount() < 2)
+    {
+        cerr << "The output fit in one chunk." << endl;
+
+        return -1;
+    }
+
+    theOutput.clear();
+
+    for (XalanChunkedOutputStream::size_type i = 0; i < theStream.getChunkCount(); ++i)
+    {
+        theOutput.append(theStream.getChunkData(i), theStream.getChunkSize(i));
+    }
+
+    if (theOutput.size() != theStream.getSize())
+    {
+        cerr << "The chunk sizes don't add up to the size of the output." << endl;
+
+        return -1;
+    }
+
+    return theResult;
+}
+
+
+
+int
+transformWithArena(
+            XalanTransformer&               theTransformer,
+            const XalanCompiledStylesheet*  theStylesheet,
+            const char*                     theSourceFileName,
+            MemoryManager&                  theManager,
+            string&                         theOutput)
+{
+    theTransformer.setUseTransformArena(true);
+
+    return transformNormal(
+                theTransformer,
+                theStylesheet,
+                theSourceFileName,
+                theManager,
+                theOutput);
+}
+
+
+
+// Counts the blocks which the arena has obtained and not given back.
+class BlockCountingMemoryManager : public XalanMemoryManager
+{
+public:
+
+    BlockCountingMemoryManager() :
+        m_parent(),
+        m_outstanding(0)
+    {
+    }
+
+    virtual
+    ~BlockCountingMemoryManager()
+    {
+    }
+
+    virtual void*
+    allocate(size_type  size)
+    {
+        void* const     theResult = m_parent.allocate(size);
+
+        ++m_outstanding;
+
+        return theResult;
+    }
+
+    virtual void
+    deallocate(void*    pointer)
+    {
+        if (pointer != 0)
+        {
+            --m_outstanding;
+        }
+
+        m_parent.deallocate(pointer);
+    }
+
+    virtual MemoryManager*
+    getExceptionMemoryManager()
+    {
+        return m_parent.getExceptionMemoryManager();
+    }
+
+    size_t
+    getOutstanding() const
+    {
+        return m_outstanding;
+    }
+
+private:
+
+    XalanMemoryManagerDefault   m_parent;
+
+    size_t                      m_outstanding;
+};
+
+
+
+// Strings of many sizes are created and destroyed in the arena, and
+// grown, as they are during a transformation.  The freed memory must
+// be reused, so the arena never needs more than a few blocks,
+// however many strings it has made.
+bool
+testArenaReuse()
+{
+    const char* const   theName = "Transform arena reuse";
+
+    BlockCountingMemoryManager  theParent;
+
+    bool    fResult = true;
+
+    {
+        XalanArenaMemoryManager     theArena(theParent);
+
+        for (int i = 0; i < 100000 && fResult == true; ++i)
+        {
+            XalanDOMString  theString(XalanDOMString::size_type(i % 500), xalanc::XalanDOMChar('a'), theArena);
+
+            theString.append(XalanDOMString::size_type(i % 4000), xalanc::XalanDOMChar('b'));
+
+            XalanDOMString  theCopy(theString, theArena);
+
+            if (theCopy.length() != XalanDOMString::size_type(i % 500 + i % 4000))
+            {
+                cerr << theName << ": a string has the wrong length." << endl;
+
+                fResult = false;
+            }
+        }
+
+        if (theParent.getOutstanding() > 4)
+        {
+            cerr << theName
+                 << ": the arena holds "
+                 << theParent.getOutstanding()
+                 << " blocks."
+                 << endl;
+
+            fResult = false;
+        }
+
+        theArena.reset();
+
+        if (theParent.getOutstanding() > 1)
+        {
+            cerr << theName << ": reset() didn't release the blocks." << endl;
+
+            fResult = false;
+        }
+    }
+
+    if (theParent.getOutstanding() != 0)
+    {
+        cerr << theName << ": the arena didn't release its blocks." << endl;
+
+        fResult = false;
+    }
+
+    if (fResult == true)
+    {
+        cout << theName << ": passed." << endl;
+    }
+
+    return fResult;
+}
+
+
+
+// Counts the literal result elements and text which are traced as
+// children of a literal result element.  The engine has to refuse
+// pre-serialized content when there's a trace listener, so these
+// must be executed one by one.
+class LiteralTraceListener : public TraceListener
+{
+public:
+
+    LiteralTraceListener() :
+        m_literalChildren(0)
+    {
+    }
+
+    virtual void
+    trace(const TracerEvent&    ev)
+    {
+        if (isLiteral(ev.m_styleNode) == true)
+        {
+            const ElemTemplateElement* const    theParent =
+                ev.m_styleNode.getParentNodeElem();
+
+            if (theParent != 0 &&
+                theParent->getXSLToken() == StylesheetConstructionContext::ELEMNAME_LITERAL_RESULT)
+            {
+                ++m_literalChildren;
+            }
+        }
+    }
+
+    virtual void
+    selected(const SelectionEvent&  /* ev */)
+    {
+    }
+
+    virtual void
+    generated(const GenerateEvent&  /* ev */)
+    {
+    }
+
+    int
+    getLiteralChildren() const
+    {
+        return m_literalChildren;
+    }
+
+private:
+
+    static bool
+    isLiteral(const ElemTemplateElement&    theElement)
+    {
+        const int   theToken = theElement.getXSLToken();
+
+        return theToken == StylesheetConstructionContext::ELEMNAME_LITERAL_RESULT ||
+               theToken == StylesheetConstructionContext::ELEMNAME_TEXT_LITERAL_RESULT;
+    }
+
+    int     m_literalChildren;
+};
+
+
+
+int
+transformTraced(
+            XalanTransformer&               theTransformer,
+            const XalanCompiledStylesheet*  theStylesheet,
+            const char*                     theSourceFileName,
+            MemoryManager&                  theManager,
+            string&                         theOutput)
+{
+    LiteralTraceListener    theListener;
+
+    theTransformer.addTraceListener(&theListener);
+
+    const int   theResult =
+        transformNormal(
+            theTransformer,
+            theStylesheet,
+            theSourceFileName,
+            theManager,
+            theOutput);
+
+    theTransformer.removeTraceListener(&theListener);
+
+    if (theResult == 0 && theListener.getLiteralChildren() == 0)
+    {
+        cerr << "The children of the literal result elements were not traced." << endl;
+
+        return -1;
+    }
+
+    return theResult;
+}
+
+
+
+// The encodings which the XML serializer writes directly, instead
+// of through the output stream's transcoder.
+enum SingleByteEncoding { eLatin1, eASCII, eWindows1252 };
+
+const char* const   thSingleByteEncodings[] =
+{
+    "ISO-8859-1",
+    "US-ASCII",
+    "WINDOWS-1252"
+};
+
+
+
+template <SingleByteEncoding theEncoding>
+int
+transformEncoding(
+            XalanTransformer&               theTransformer,
+            const XalanCompiledStylesheet*  theStylesheet,
+            const char*                     theSourceFileName,
+            MemoryManager&                  theManager,
+            string&                         theOutput)
+{
+    theTransformer.setOutputEncoding(
+        XalanDOMString(thSingleByteEncodings[theEncoding], theManager));
+
+    return transformNormal(
+                theTransformer,
+                theStylesheet,
+                theSourceFileName,
+                theManager,
+                theOutput);
+}
+
+
+
+// Serializes with the writer used for every other encoding, which
+// transcodes each character through the output stream.  This is how
+// the single-byte encodings were written before they had their own
+// writers, so it's the reference for them.
+template <SingleByteEncoding theEncoding>
+int
+transformTranscoded(
+            XalanTransformer&               theTransformer,
+            const XalanCompiledStylesheet*  theStylesheet,
+            const char*                     theSourceFileName,
+            MemoryManager&                  theManager,
+            string&                         theOutput)
+{
+    typedef xalanc::XalanOtherEncodingWriter<
+                XalanFormatterWriter::CommonRepresentableCharFunctor,
+                XalanXMLSerializerBase::UTF16>  WriterType;
+
+    typedef xalanc::FormatterToXMLUnicode<
+                WriterType,
+                XalanXMLSerializerBase::UTF16,
+                XalanXMLSerializerBase::CharFunctor1_0,
+                xalanc::XalanDummyIndentWriter<WriterType>,
+                FormatterListener::XML_VERSION_1_0>     FormatterType;
+
+    const XalanDOMString    theEncodingString(thSingleByteEncodings[theEncoding], theManager);
+
+    ostringstream   theStream;
+
+    XalanStdOutputStream            theOutputStream(theStream, theManager);
+    XalanOutputStreamPrintWriter    thePrintWriter(theOutputStream);
+
+    theOutputStream.setOutputEncoding(theEncodingString);
+
+    XalanMemMgrAutoPtr<FormatterListener>   theFormatter(
+            theManager,
+            FormatterType::create(
+                theManager,
+                thePrintWriter,
+                theEncodingString));
+
+    const int   theResult =
+        theTransformer.transform(
+            XSLTInputSource(theSourceFileName, theManager),
+            theStylesheet,
+            XSLTResultTarget(*theFormatter, theManager));
+
+    thePrintWriter.flush();
+
+    theOutput = theStream.str();
+
+    return theResult;
+}
+
+
+
+// Each case transforms a document with a stylesheet in one of the
+// optional modes, and compares the result with the result of the
+// same transformation by the reference function, which is normally
+// the normal mode.  A case with more than one run transforms again
+// with the same transformer, which shows that the mode's state is
+// reset properly.
+struct ModeCase
+{
+    const char*         m_name;
+
+    const char*         m_sourceFileName;
+
+    const char*         m_stylesheetFileName;
+
+    ModeFunctionType    m_function;
+
+    int                 m_runs;
+
+    ModeFunctionType    m_reference;
+};
+
+
+
+const ModeCase  theCases[] =
+{
+    { "Source image", "image.xml", "image.xsl", transformSourceImage, 2, transformNormal },
+    { "Streaming", "modes.xml", "modes.xsl", transformStreaming, 1, transformNormal },
+    { "Streaming nested templates", "modes.xml", "nested.xsl", transformStreaming, 1, transformNormal },
+    { "Streaming with predicates and node tests", "modes.xml", "streaming-select.xsl", transformStreaming, 2, transformNormal },
+    { "Streaming with sort keys", "modes.xml", "streaming-sort.xsl", transformStreaming, 1, transformNormal },
+    { "Projection with built-in rules", "projection.xml", "projection-builtin.xsl", transformProjected, 1, transformNormal },
+    { "Projection with the descendant axis", "projection.xml", "projection-descendant.xsl", transformProjected, 1, transformNormal },
+    { "Projection with name tests", "projection.xml", "projection-names.xsl", transformProjected, 1, transformNormal },
+    { "Projection with sort keys", "projection.xml", "projection-sort.xsl", transformProjected, 1, transformNormal },
+    { "Memory output stream", "modes.xml", "modes.xsl", transformMemoryOutputStream, 1, transformNormal },
+    { "Chunked output stream", "modes.xml", "modes.xsl", transformChunkedOutputStream, 1, transformNormal },
+    { "Transform arena", "modes.xml", "modes.xsl", transformWithArena, 2, transformNormal },
+    { "Static literal content", "modes.xml", "literal.xsl", transformNormal, 2, transformTraced },
+    { "Static literal content in ISO-8859-1", "modes.xml", "literal-latin1.xsl", transformNormal, 2, transformTraced },
+    { "Static literal content with indentation", "modes.xml", "literal-indent.xsl", transformNormal, 2, transformTraced },
+    { "Static literal content with CDATA sections", "modes.xml", "literal-cdata.xsl", transformNormal, 2, transformTraced },
+    { "Static literal content with a trace listener", "modes.xml", "literal.xsl", transformTraced, 2, transformNormal },
+    { "ISO-8859-1 writer", "encoding.xml", "encoding.xsl", transformEncoding<eLatin1>, 2, transformTranscoded<eLatin1> },
+    { "US-ASCII writer", "encoding.xml", "encoding.xsl", transformEncoding<eASCII>, 2, transformTranscoded<eASCII> },
+    { "Windows-1252 writer", "encoding.xml", "encoding.xsl", transformEncoding<eWindows1252>, 2, transformTranscoded<eWindows1252> },
+};
+
+
+
+int
+transform(
+            const char*         theSourceFileName,
+            const char*         theStylesheetFileName,
+            ModeFunctionType    theFunction,
+            int                 theRuns,
+            MemoryManager&      theManager,
+            string&             theOutput,
+            const string*       theExpected)
+{
+    XalanTransformer    theTransformer(theManager);
+
+    const XalanCompiledStylesheet*  theStylesheet = 0;
+
+    int     theResult =
+        theTransformer.compileStylesheet(
+            XSLTInputSource(theStylesheetFileName, theManager),
+            theStylesheet);
+
+    for (int i = 0; i < theRuns && theResult == 0; ++i)
+    {
+        theResult =
+            theFunction(
+                theTransformer,
+                theStylesheet,
+                theSourceFileName,
+                theManager,
+                theOutput);
+
+        if (theExpected != 0 && theOutput != *theExpected)
+        {
+            break;
+        }
+    }
+
+    if (theResult != 0)
+    {
+        cerr << "The transformation failed: "
+             << theTransformer.getLastError()
+             << endl;
+    }
+
+    return theResult;
+}
+
+
+
+bool
+checkResult(
+            const char*     theName,
+            int             theResult,
+            const string&   theExpected,
+            const string&   theActual)
+{
+    if (theResult != 0)
+    {
+        cerr << theName << ": failed." << endl;
+
+        return false;
+    }
+    else if (theActual != theExpected)
+    {
+        cerr << theName
+             << ": the result differs from the reference."
+             << endl
+             << "Expected: "
+             << theExpected
+             << endl
+             << "Actual:   "
+             << theActual
+             << endl;
+
+        return false;
+    }
+    else
+    {
+        cout << theName << ": passed." << endl;
+
+        return true;
+    }
+}
+
+
+
+bool
+runCase(
+            const ModeCase&     theCase,
+            MemoryManager&      theManager)
+{
+    string  theExpected;
+
+    if (transform(
+            theCase.m_sourceFileName,
+            theCase.m_stylesheetFileName,
+            theCase.m_reference,
+            1,
+            theManager,
+            theExpected,
+            0) != 0)
+    {
+        cerr << theCase.m_name << ": the reference transformation failed." << endl;
+
+        return false;
+    }
+
+    string  theOutput;
+
+    const int   theResult =
+        transform(
+            theCase.m_sourceFileName,
+            theCase.m_stylesheetFileName,
+            theCase.m_function,
+            theCase.m_runs,
+            theManager,
+            theOutput,
+            &theExpected);
+
+    return checkResult(theCase.m_name, theResult, theExpected, theOutput);
+}
+
+
+
+struct ThreadInfo
+{
+    ThreadInfo() :
+        m_result(0),
+        m_output()
+    {
+    }
+
+    int         m_result;
+
+    string      m_output;
+};
+
+
+
+void
+transformThread(
+            MemoryManager*  theManager,
+            const string*   theExpected,
+            ThreadInfo*     theInfo)
+{
+    try
+    {
+        theInfo->m_result =
+            transform(
+                "modes.xml",
+                "modes.xsl",
+                transformNormal,
+                5,
+                *theManager,
+                theInfo->m_output,
+                theExpected);
+    }
+    catch(...)
+    {
+        theInfo->m_result = -1;
+    }
+}
+
+
+
+// Xalan and Xerces-C must both use the thread-caching manager, so
+// this case runs after they have been terminated and initialized
+// again with it.  Several threads transform at the same time, each
+// with its own transformer.
+bool
+testThreadCaching(
+            XalanThreadCachingMemoryManager&    theManager,
+            const string&                       theExpected)
+{
+    enum { eThreadCount = 4 };
+
+    ThreadInfo      theInfo[eThreadCount];
+
+    std::thread     theThreads[eThreadCount];
+
+    for (int i = 0; i < eThreadCount; ++i)
+    {
+        theThreads[i] =
+            std::thread(
+                transformThread,
+                &theManager,
+                &theExpected,
+                &theInfo[i]);
+    }
+
+    for (int i = 0; i < eThreadCount; ++i)
+    {
+        theThreads[i].join();
+    }
+
+    const char* const   theName = "Thread-caching memory manager";
+
+    for (int i = 0; i < eThreadCount; ++i)
+    {
+        if (theInfo[i].m_result != 0 || theInfo[i].m_output != theExpected)
+        {
+            return checkResult(
+                        theName,
+                        theInfo[i].m_result,
+                        theExpected,
+                        theInfo[i].m_output);
+        }
+    }
+
+    XalanThreadCachingMemoryManager::Statistics     theStatistics;
+
+    theManager.getStatistics(theStatistics);
+
+    if (theStatistics.m_batchFetches == 0)
+    {
+        cerr << theName << ": the thread caches were not used." << endl;
+
+        return false;
+    }
+
+    cout << theName << ": passed." << endl;
+
+    return true;
+}
+
+
+
+}
+
+
+
+int
+main(
+            int     argc,
+            char*   /* argv */[])
+{
+    if (argc != 1)
+    {
+        cerr << "Usage: ModesTest" << endl;
+
+        return 1;
+    }
+
+    int     theFailures = 0;
+
+    try
+    {
+        using xercesc::XMLPlatformUtils;
+
+        XMLPlatformUtils::Initialize();
+
+        XalanTransformer::initialize();
+
+        MemoryManager&  theManager = xalanc::XalanMemMgrs::getDefaultXercesMemMgr();
+
+        for (size_t i = 0; i < sizeof(theCases) / sizeof(theCases[0]); ++i)
+        {
+            if (runCase(theCases[i], theManager) == false)
+            {
+                ++theFailures;
+            }
+        }
+
+        if (testDamagedImages(theManager) == false)
+        {
+            ++theFailures;
+        }
+
+        if (testImageAttributeNames(theManager) == false)
+        {
+            ++theFailures;
+        }
+
+        if (testArenaReuse() == false)
+        {
+            ++theFailures;
+        }
+
+        string  theExpected;
+
+        if (transform(
+                "modes.xml",
+                "modes.xsl",
+                transformNormal,
+                1,
+                theManager,
+                theExpected,
+                0) != 0)
+        {
+            ++theFailures;
+        }
+
+        XalanTransformer::terminate();
+
+        XMLPlatformUtils::Terminate();
+
+        if (theExpected.empty() == false)
+        {
+            XalanMemoryManagerDefault           theParent;
+
+            XalanThreadCachingMemoryManager     theCachingManager(theParent);
+
+            XMLPlatformUtils::Initialize(
+                xercesc::XMLUni::fgXercescDefaultLocale,
+                0,
+                0,
+                &theCachingManager);
+
+            XalanTransformer::initialize(theCachingManager);
+
+            if (testThreadCaching(theCachingManager, theExpected) == false)
+            {
+                ++theFailures;
+            }
+
+            XalanTransformer::terminate();
+
+            XMLPlatformUtils::Terminate();
+        }
+
+        XalanTransformer::ICUCleanUp();
+    }
+    catch(...)
+    {
+        cerr << "Initialization failed!" << endl;
+
+        return 1;
+    }
+
+    return theFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,10 @@
+<?xml version="1.0"?>
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="xml" cdata-section-elements="code"/>
+
+<xsl:template match="/">
+  <xsl:copy-of select="samples"/>
+</xsl:template>
+
+</xsl:stylesheet>
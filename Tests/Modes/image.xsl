@@ -0,0 +1,26 @@
+<?xml version="1.0"?>
+<xsl:stylesheet version="1.0"
+    xmlns:xsl="http://www.w3.org/1999/XSL/Transform"
+    xmlns:l="urn:example:library">
+
+<xsl:output method="xml" encoding="UTF-8"/>
+
+<xsl:template match="/">
+  <image>
+    <copy><xsl:copy-of select="node()"/></copy>
+    <xsl:apply-templates select="//node() | //@*"/>
+    <id><xsl:value-of select="id('s2')/@id"/></id>
+    <entity><xsl:value-of select="unparsed-entity-uri('cover')"/></entity>
+  </image>
+</xsl:template>
+
+<xsl:template match="node() | @*">
+  <node type="{name(.)}" order="{count(preceding::node() | ancestor::node())}">
+    <xsl:for-each select="namespace::*">
+      <xsl:sort select="name()"/>
+      <ns prefix="{name()}" uri="{.}"/>
+    </xsl:for-each>
+  </node>
+</xsl:template>
+
+</xsl:stylesheet>
@@ -0,0 +1,12 @@
+<?xml version="1.0"?>
+<!--
+  The constant literal content of literal.xsl, indented, so the
+  serializer must refuse the pre-serialized markup.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:import href="literal.xsl"/>
+
+<xsl:output method="xml" indent="yes"/>
+
+</xsl:stylesheet>
@@ -0,0 +1,11 @@
+<?xml version="1.0"?>
+<!--
+  The constant literal content of literal.xsl, written in ISO-8859-1.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:import href="literal.xsl"/>
+
+<xsl:output method="xml" encoding="ISO-8859-1"/>
+
+</xsl:stylesheet>
@@ -0,0 +1,33 @@
+<?xml version="1.0" encoding="UTF-8"?>
+<!--
+  Literal result elements whose content is constant, so that it's
+  serialized when the stylesheet is compiled.  The stylesheets which
+  import this one only change the output.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="xml" encoding="UTF-8"/>
+
+<xsl:template match="/">
+  <inventory>
+    <header>
+      <title lang="fr" alt="Crème &quot;brûlée&quot; &amp; &lt;café&gt;">Crème brûlée &amp; café</title>
+      <note>Prices in € – „quoted“ – 中文 😀 &lt;tag&gt; ]]&gt; end</note>
+      <empty flag="yes"/>
+      <lines>first
+second	tabbed</lines>
+    </header>
+    <xsl:apply-templates/>
+  </inventory>
+</xsl:template>
+
+<xsl:template match="book">
+  <item id="{@id}">
+    <label kind="book">Title: <name>naïve – <b>Ø</b></name></label>
+    <xsl:value-of select="title"/>
+  </item>
+</xsl:template>
+
+<xsl:template match="text()"/>
+
+</xsl:stylesheet>
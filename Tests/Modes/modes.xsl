@@ -0,0 +1,28 @@
+<?xml version="1.0"?>
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="xml" encoding="UTF-8"/>
+
+<xsl:template match="/">
+  <inventory>
+    <xsl:apply-templates/>
+  </inventory>
+</xsl:template>
+
+<xsl:template match="catalog">
+  <xsl:apply-templates/>
+</xsl:template>
+
+<xsl:template match="book">
+  <item id="{@id}" lang="{@lang}">
+    <xsl:value-of select="title"/>
+    <xsl:text>, </xsl:text>
+    <xsl:value-of select="concat(translate(author, 'abcdefghijklmnopqrstuvwxyz', 'ABCDEFGHIJKLMNOPQRSTUVWXYZ'), ' (', substring-after(year, '19'), ')')"/>
+    <xsl:text>: </xsl:text>
+    <xsl:value-of select="round(price * 120) div 100"/>
+  </item>
+</xsl:template>
+
+<xsl:template match="text()"/>
+
+</xsl:stylesheet>
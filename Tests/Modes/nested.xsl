@@ -0,0 +1,49 @@
+<?xml version="1.0"?>
+<!--
+  Every template is streamable, so the children of each book are
+  streamed as well as the books.  The book template also selects
+  attributes, which exist before the children are parsed.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="xml" encoding="UTF-8"/>
+
+<xsl:template match="/">
+  <inventory>
+    <xsl:apply-templates select="catalog"/>
+  </inventory>
+</xsl:template>
+
+<xsl:template match="catalog">
+  <xsl:apply-templates select="book[@lang = 'en'] | book[@lang = 'fr']"/>
+</xsl:template>
+
+<xsl:template match="book">
+  <item>
+    <xsl:apply-templates select="@id | @lang | title | author | price"/>
+  </item>
+</xsl:template>
+
+<xsl:template match="@*">
+  <xsl:attribute name="{name()}">
+    <xsl:value-of select="string()"/>
+  </xsl:attribute>
+</xsl:template>
+
+<xsl:template match="title | author">
+  <xsl:element name="{name()}">
+    <xsl:apply-templates/>
+  </xsl:element>
+</xsl:template>
+
+<xsl:template match="price">
+  <cost currency="EUR">
+    <xsl:apply-templates mode="text"/>
+  </cost>
+</xsl:template>
+
+<xsl:template match="text()" mode="text">
+  <xsl:copy/>
+</xsl:template>
+
+</xsl:stylesheet>
@@ -0,0 +1,24 @@
+<?xml version="1.0"?>
+<!--
+  The notes inside para and em are only reached through the built-in
+  template rule for elements, since no template names para or em.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="xml" encoding="UTF-8"/>
+
+<xsl:template match="/">
+  <notes>
+    <xsl:apply-templates select="library/section" mode="notes"/>
+  </notes>
+</xsl:template>
+
+<xsl:template match="note" mode="notes">
+  <note section="{ancestor::section/@id}">
+    <xsl:value-of select="."/>
+  </note>
+</xsl:template>
+
+<xsl:template match="text()" mode="notes"/>
+
+</xsl:stylesheet>
@@ -0,0 +1,20 @@
+<?xml version="1.0"?>
+<!--
+  The entries and colophon are only reached with the descendant axis.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="xml" encoding="UTF-8"/>
+
+<xsl:template match="/">
+  <index count="{count(//entry)}">
+    <xsl:for-each select="//entry">
+      <entry key="{@key}">
+        <xsl:value-of select="."/>
+      </entry>
+    </xsl:for-each>
+    <xsl:copy-of select="/library//colophon"/>
+  </index>
+</xsl:template>
+
+</xsl:stylesheet>
@@ -0,0 +1,26 @@
+<?xml version="1.0"?>
+<!--
+  The last step of each path is a wildcard with a name() or
+  local-name() test, rather than a name test.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="xml" encoding="UTF-8"/>
+
+<xsl:template match="/">
+  <names>
+    <xsl:for-each select="library/section/para/*[local-name() = 'note']">
+      <local><xsl:value-of select="."/></local>
+    </xsl:for-each>
+    <xsl:for-each select="library/appendix/index/*[name() = 'entry']">
+      <qualified key="{@key}"><xsl:value-of select="."/></qualified>
+    </xsl:for-each>
+    <xsl:apply-templates select="library/meta"/>
+  </names>
+</xsl:template>
+
+<xsl:template match="meta">
+  <meta><xsl:value-of select="*[name() = 'owner']"/></meta>
+</xsl:template>
+
+</xsl:stylesheet>
@@ -0,0 +1,27 @@
+<?xml version="1.0"?>
+<!--
+  The sort keys are the string values of the selected nodes, and
+  the order comes from the source, but only the ids and keys are
+  output, so the text must be kept for the sorts alone.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="xml" encoding="UTF-8"/>
+
+<xsl:template match="/">
+  <sorted>
+    <xsl:for-each select="library/section/title">
+      <xsl:sort/>
+      <section id="{../@id}"/>
+    </xsl:for-each>
+    <xsl:apply-templates select="library/appendix/index/entry">
+      <xsl:sort select="@key" order="{library/meta/order}"/>
+    </xsl:apply-templates>
+  </sorted>
+</xsl:template>
+
+<xsl:template match="entry">
+  <entry key="{@key}"/>
+</xsl:template>
+
+</xsl:stylesheet>
@@ -0,0 +1,44 @@
+<?xml version="1.0"?>
+<!--
+  The books are selected by their attributes, along with the comments
+  and processing instructions between them, as they're parsed.  Some
+  of the templates need the whole element, so it's parsed before they
+  are executed.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="xml" encoding="UTF-8"/>
+
+<xsl:template match="/">
+  <inventory>
+    <xsl:apply-templates select="catalog"/>
+  </inventory>
+</xsl:template>
+
+<xsl:template match="catalog">
+  <xsl:apply-templates select="book[@lang = 'en' and @id != 'b01'] | comment() | processing-instruction('shelf')"/>
+</xsl:template>
+
+<xsl:template match="book">
+  <item position="{position()}">
+    <xsl:apply-templates select="title | year"/>
+  </item>
+</xsl:template>
+
+<xsl:template match="title">
+  <name><xsl:value-of select="."/></name>
+</xsl:template>
+
+<xsl:template match="year">
+  <xsl:copy-of select="."/>
+</xsl:template>
+
+<xsl:template match="comment()">
+  <note><xsl:value-of select="."/></note>
+</xsl:template>
+
+<xsl:template match="processing-instruction()">
+  <shelf><xsl:value-of select="."/></shelf>
+</xsl:template>
+
+</xsl:stylesheet>
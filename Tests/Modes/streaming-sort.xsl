@@ -0,0 +1,34 @@
+<?xml version="1.0"?>
+<!--
+  A sorted xsl:apply-templates can't process the books as they're
+  parsed, so the whole catalog is built first.  The sort keys include
+  a key of ".", and an order which is an attribute value template.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="xml" encoding="UTF-8"/>
+
+<xsl:template match="/">
+  <inventory>
+    <xsl:apply-templates select="catalog"/>
+  </inventory>
+</xsl:template>
+
+<xsl:template match="catalog">
+  <xsl:apply-templates select="book">
+    <xsl:sort select="year" data-type="number" order="{concat('de', 'scending')}"/>
+    <xsl:sort select="@id"/>
+  </xsl:apply-templates>
+</xsl:template>
+
+<xsl:template match="book">
+  <item id="{@id}">
+    <xsl:for-each select="title | author">
+      <xsl:sort/>
+      <xsl:value-of select="."/>
+      <xsl:text>;</xsl:text>
+    </xsl:for-each>
+  </item>
+</xsl:template>
+
+</xsl:stylesheet>
@@ -0,0 +1,417 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Base header file.  Must be first.
+#include <xalanc/Include/PlatformDefinitions.hpp>
+
+
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+
+
+#include <xercesc/util/PlatformUtils.hpp>
+
+
+
+#include <xalanc/PlatformSupport/DOMStringHelper.hpp>
+#include <xalanc/PlatformSupport/DoubleSupport.hpp>
+
+
+
+#include <xalanc/XalanTransformer/XalanTransformer.hpp>
+
+
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+
+using xalanc::DoubleSupport;
+using xalanc::MemoryManager;
+using xalanc::XalanDOMString;
+using xalanc::XalanTransformer;
+
+
+
+namespace {
+
+
+
+// The expected strings are what XalanDOMString formatting produced
+// before it used Grisu3, except where noted.  A value's string must
+// be in XPath's fixed notation, and must convert back to the value.
+struct FormatCase
+{
+    double          m_value;
+
+    // The number of zeros between "0." and the digits, for values
+    // too small to write out in the table.
+    unsigned int    m_zeros;
+
+    const char*     m_expected;
+};
+
+
+
+const FormatCase    theFormatCases[] =
+{
+    // Integral values at and above 2^53 keep all of their digits.
+    { 9007199254740992.0, 0, "9007199254740992" },
+    { 9007199254740994.0, 0, "9007199254740994" },
+    { 18014398509481988.0, 0, "18014398509481988" },
+    { 123456789012345678.0, 0, "123456789012345680" },
+    { 9223372036854775808.0, 0, "9223372036854775808" },
+    { -1152921504606846976.0, 0, "-1152921504606846976" },
+    { 1e21, 0, "1000000000000000000000" },
+    // The old formatting overran its buffer for this one.
+    { 1.7976931348623157e308, 0,
+        "17976931348623157081452742373170435679807056752584499659891747680315726078002853876058955"
+        "86327668781715404589535143824642343213268894641827684675467035375169860499105765512820762"
+        "45490090389328944075868508455133942304583236903222948165808559332123348274797826204144723"
+        "168738177180919299881250404026184124858368" },
+
+    // Subnormals, and other values which need more than 35 fractional
+    // digits, used to print as "0".
+    { 4.9406564584124654e-324, 323, "5" },
+    { 2.2250738585072009e-308, 307, "2225073858507201" },
+    { 1e-310, 309, "1" },
+    { 1.5e-40, 39, "15" },
+
+    // Grisu3 can't decide these, so the digits are found by the
+    // fallback.  The old formatting wrote more digits than needed for
+    // the first three: 887451493886341.25, 221826395616254.875 and
+    // 10468448.3998452425.
+    { 887451493886341.25, 0, "887451493886341.3" },
+    { 221826395616254.88, 0, "221826395616254.88" },
+    { 10468448.399845243, 0, "10468448.399845243" },
+    { 2.2163598110190472, 0, "2.216359811019047" },
+
+    { -0.0, 0, "0" },
+    { 0.1, 0, "0.1" },
+    { -2.5, 0, "-2.5" },
+    { 123.456, 0, "123.456" },
+    { 1.0 / 3.0, 0, "0.3333333333333333" },
+    { 0.30000000000000004, 0, "0.30000000000000004" },
+    { 1e-7, 0, "0.0000001" }
+};
+
+
+
+// A string which the parser accepts must convert to the value, and
+// the value must format to a string which converts back to it.  A
+// string which the parser rejects converts to NaN.  The values are
+// the ones atof() produced for every string before the parser
+// converted simple decimals itself.
+struct ParseCase
+{
+    const char*     m_string;
+
+    bool            m_accepted;
+
+    double          m_expected;
+};
+
+
+
+const ParseCase     theParseCases[] =
+{
+    { "12.5", true, 12.5 },
+    { "-0.001", true, -0.001 },
+    { "  42\t\n", true, 42.0 },
+    { ".5", true, 0.5 },
+    { "-.5", true, -0.5 },
+    { "5.", true, 5.0 },
+    { "00012.50000", true, 12.5 },
+    { "-007", true, -7.0 },
+    { "-0.000", true, -0.0 },
+    { "0.1234567890123456789012", true, 0.1234567890123456789012 },
+    { "0.0000000000000000000001", true, 1e-22 },
+    { "123456789012345.6", true, 123456789012345.6 },
+    { "9007199254740991", true, 9007199254740991.0 },
+
+    // These are too long for the direct conversion.
+    { "9007199254740993", true, 9007199254740992.0 },
+    { "0.12345678901234567890123", true, 0.12345678901234567890123 },
+
+    { "1e5", false, 0 },
+    { "4.9406564584124654e-324", false, 0 },
+    { "+1", false, 0 },
+    { "", false, 0 },
+    { "   ", false, 0 },
+    { "12.5.3", false, 0 },
+    { "0x10", false, 0 },
+    { "-", false, 0 },
+    { ".", false, 0 },
+    { "- 1", false, 0 },
+    { "1 2", false, 0 },
+    { "Infinity", false, 0 },
+    { "NaN", false, 0 }
+};
+
+
+
+// Compares the bits, so the sign of zero counts.
+bool
+isIdentical(
+            double  theFirst,
+            double  theSecond)
+{
+    return std::memcmp(&theFirst, &theSecond, sizeof(double)) == 0;
+}
+
+
+
+string
+format(
+            double          theValue,
+            MemoryManager&  theManager)
+{
+    XalanDOMString  theString(theManager);
+
+    xalanc::NumberToDOMString(theValue, theString);
+
+    return string(theString.begin(), theString.end());
+}
+
+
+
+double
+parse(
+            const string&   theString,
+            MemoryManager&  theManager)
+{
+    return DoubleSupport::toDouble(
+                XalanDOMString(theString.c_str(), theManager),
+                theManager);
+}
+
+
+
+bool
+checkFormat(
+            const FormatCase&   theCase,
+            MemoryManager&      theManager)
+{
+    string  theExpected;
+
+    if (theCase.m_zeros != 0)
+    {
+        theExpected = "0.";
+        theExpected.append(theCase.m_zeros, '0');
+    }
+
+    theExpected += theCase.m_expected;
+
+    const string    theResult = format(theCase.m_value, theManager);
+
+    if (theResult != theExpected)
+    {
+        cerr << "Formatting " << theExpected << " gave " << theResult << "." << endl;
+
+        return false;
+    }
+
+    const double    theValue = parse(theResult, theManager);
+
+    if (theCase.m_value != 0 && isIdentical(theValue, theCase.m_value) == false)
+    {
+        cerr << theResult << " doesn't convert back to the same value." << endl;
+
+        return false;
+    }
+
+    return true;
+}
+
+
+
+bool
+checkParse(
+            const ParseCase&    theCase,
+            MemoryManager&      theManager)
+{
+    const double    theValue = parse(theCase.m_string, theManager);
+
+    if (theCase.m_accepted == false)
+    {
+        if (DoubleSupport::isNaN(theValue) == false)
+        {
+            cerr << "\"" << theCase.m_string << "\" was accepted." << endl;
+
+            return false;
+        }
+    }
+    else if (isIdentical(theValue, theCase.m_expected) == false)
+    {
+        cerr << "\"" << theCase.m_string << "\" was converted to "
+             << format(theValue, theManager) << "." << endl;
+
+        return false;
+    }
+    else if (isIdentical(parse(format(theValue, theManager), theManager), theValue) == false &&
+             theValue != 0)
+    {
+        cerr << "\"" << theCase.m_string << "\" doesn't round trip." << endl;
+
+        return false;
+    }
+
+    return true;
+}
+
+
+
+bool
+checkSpecialValues(MemoryManager&   theManager)
+{
+    const struct
+    {
+        double          m_value;
+
+        const char*     m_expected;
+    } theCases[] =
+    {
+        { DoubleSupport::getNaN(), "NaN" },
+        { DoubleSupport::getPositiveInfinity(), "Infinity" },
+        { DoubleSupport::getNegativeInfinity(), "-Infinity" }
+    };
+
+    bool    fResult = true;
+
+    for (size_t i = 0; i < sizeof(theCases) / sizeof(theCases[0]); ++i)
+    {
+        const string    theResult = format(theCases[i].m_value, theManager);
+
+        if (theResult != theCases[i].m_expected)
+        {
+            cerr << "Formatting " << theCases[i].m_expected << " gave " << theResult << "." << endl;
+
+            fResult = false;
+        }
+    }
+
+    return fResult;
+}
+
+
+
+bool
+report(
+            const char*     theName,
+            int             theFailures)
+{
+    if (theFailures == 0)
+    {
+        cout << theName << ": passed." << endl;
+
+        return true;
+    }
+    else
+    {
+        cerr << theName << ": failed." << endl;
+
+        return false;
+    }
+}
+
+
+
+}
+
+
+
+int
+main(
+            int     argc,
+            char*   /* argv */[])
+{
+    if (argc != 1)
+    {
+        cerr << "Usage: NumbersTest" << endl;
+
+        return 1;
+    }
+
+    int     theFailures = 0;
+
+    try
+    {
+        using xercesc::XMLPlatformUtils;
+
+        XMLPlatformUtils::Initialize();
+
+        XalanTransformer::initialize();
+
+        {
+            MemoryManager&  theManager = xalanc::XalanMemMgrs::getDefaultXercesMemMgr();
+
+            int     theFormatFailures = 0;
+
+            for (size_t i = 0; i < sizeof(theFormatCases) / sizeof(theFormatCases[0]); ++i)
+            {
+                if (checkFormat(theFormatCases[i], theManager) == false)
+                {
+                    ++theFormatFailures;
+                }
+            }
+
+            if (checkSpecialValues(theManager) == false)
+            {
+                ++theFormatFailures;
+            }
+
+            if (report("Formatting", theFormatFailures) == false)
+            {
+                ++theFailures;
+            }
+
+            int     theParseFailures = 0;
+
+            for (size_t i = 0; i < sizeof(theParseCases) / sizeof(theParseCases[0]); ++i)
+            {
+                if (checkParse(theParseCases[i], theManager) == false)
+                {
+                    ++theParseFailures;
+                }
+            }
+
+            if (report("Parsing", theParseFailures) == false)
+            {
+                ++theFailures;
+            }
+        }
+
+        XalanTransformer::terminate();
+
+        XMLPlatformUtils::Terminate();
+
+        XalanTransformer::ICUCleanUp();
+    }
+    catch(...)
+    {
+        cerr << "Initialization failed!" << endl;
+
+        return 1;
+    }
+
+    return theFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,560 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Base header file.  Must be first.
+#include <xalanc/Include/PlatformDefinitions.hpp>
+
+
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+
+
+#include <xercesc/util/PlatformUtils.hpp>
+
+
+
+#include <xalanc/XalanTransformer/XalanTransformer.hpp>
+
+
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::istringstream;
+using std::ostringstream;
+using std::string;
+using std::vector;
+
+using xalanc::MemoryManager;
+using xalanc::XalanCompiledStylesheet;
+using xalanc::XalanParsedSource;
+using xalanc::XalanTransformer;
+using xalanc::XSLTInputSource;
+using xalanc::XSLTResultTarget;
+
+
+
+namespace {
+
+
+
+// Enough nodes for the radix sort, and for a parallel sort to be
+// split into three runs.
+const size_t    theNodeCount = 20000;
+
+
+
+// Every tenth value is NaN, -0, 0 or empty, which is also NaN.  The
+// rest fall in a small range, so there are many equal keys, and the
+// order of equal keys shows whether a sort is stable.
+string
+getValue(size_t     theIndex)
+{
+    switch(theIndex % 10)
+    {
+    case 0:
+        return "abc";
+
+    case 1:
+        return "-0";
+
+    case 2:
+        return "0";
+
+    case 3:
+        return "";
+
+    default:
+        {
+            ostringstream   theStream;
+
+            theStream << long((theIndex * 7919) % 2001) - 1000;
+
+            if (theIndex % 10 == 4)
+            {
+                theStream << ".5";
+            }
+
+            return theStream.str();
+        }
+    }
+}
+
+
+
+string
+getText(size_t  theIndex)
+{
+    string  theText;
+
+    theText += char('a' + (theIndex * 31) % 26);
+    theText += char('a' + (theIndex * 17) % 26);
+
+    return theText;
+}
+
+
+
+string
+makeSource()
+{
+    ostringstream   theStream;
+
+    theStream << "<doc xmlns:p=\"urn:p\">";
+
+    // The text of each node is the same as its s attribute, and its
+    // p:s attribute has the text of the next node.
+    for (size_t i = 0; i < theNodeCount; ++i)
+    {
+        theStream << "<i n=\"" << i
+                  << "\" v=\"" << getValue(i)
+                  << "\" s=\"" << getText(i)
+                  << "\" p:s=\"" << getText(i + 1)
+                  << "\">" << getText(i) << "</i>";
+    }
+
+    theStream << "</doc>";
+
+    return theStream.str();
+}
+
+
+
+double
+getNumber(size_t    theIndex)
+{
+    const string    theValue = getValue(theIndex);
+
+    if (theValue.empty() == true || theValue == "abc")
+    {
+        return std::nan("");
+    }
+    else
+    {
+        return std::strtod(theValue.c_str(), 0);
+    }
+}
+
+
+
+// The order XSLT requires for numbers: NaN comes before every other
+// number, and -0 is equal to 0.
+struct AscendingNumbers
+{
+    AscendingNumbers(const vector<double>&  theNumbers) :
+        m_numbers(theNumbers)
+    {
+    }
+
+    bool
+    operator()(
+            size_t  theLHS,
+            size_t  theRHS) const
+    {
+        const double    theLHSNumber = m_numbers[theLHS];
+        const double    theRHSNumber = m_numbers[theRHS];
+
+        if (std::isnan(theLHSNumber) == true)
+        {
+            return std::isnan(theRHSNumber) == false;
+        }
+        else
+        {
+            return std::isnan(theRHSNumber) == false && theLHSNumber < theRHSNumber;
+        }
+    }
+
+    const vector<double>&   m_numbers;
+};
+
+
+
+struct DescendingNumbers
+{
+    DescendingNumbers(const vector<double>&     theNumbers) :
+        m_ascending(theNumbers)
+    {
+    }
+
+    bool
+    operator()(
+            size_t  theLHS,
+            size_t  theRHS) const
+    {
+        return m_ascending(theRHS, theLHS);
+    }
+
+    const AscendingNumbers  m_ascending;
+};
+
+
+
+// The expected result is the document order of the nodes, stable
+// sorted by their numbers, independently of NodeSorter.
+string
+makeExpected(bool   fDescending)
+{
+    vector<double>  theNumbers;
+    vector<size_t>  theOrder;
+
+    for (size_t i = 0; i < theNodeCount; ++i)
+    {
+        theNumbers.push_back(getNumber(i));
+        theOrder.push_back(i);
+    }
+
+    if (fDescending == true)
+    {
+        std::stable_sort(theOrder.begin(), theOrder.end(), DescendingNumbers(theNumbers));
+    }
+    else
+    {
+        std::stable_sort(theOrder.begin(), theOrder.end(), AscendingNumbers(theNumbers));
+    }
+
+    ostringstream   theStream;
+
+    for (size_t i = 0; i < theOrder.size(); ++i)
+    {
+        theStream << theOrder[i] << ' ';
+    }
+
+    return theStream.str();
+}
+
+
+
+string
+makeStylesheet(const char*  theSortElements)
+{
+    return string(
+        "<xsl:stylesheet version=\"1.0\" xmlns:xsl=\"http://www.w3.org/1999/XSL/Transform\" xmlns:q=\"urn:p\">"
+        "<xsl:output method=\"text\"/>"
+        "<xsl:template match=\"/\">"
+        "<xsl:for-each select=\"doc/i\">") +
+        theSortElements +
+        "<xsl:value-of select=\"@n\"/>"
+        "<xsl:text> </xsl:text>"
+        "</xsl:for-each>"
+        "</xsl:template>"
+        "</xsl:stylesheet>";
+}
+
+
+
+enum eExpected
+{
+    eAscending,
+    eDescending,
+    // The same sort, without splitting it between threads.
+    eUnsplit
+};
+
+
+
+// A single number key is sorted with the radix sort.  A constant
+// second key, which doesn't change the order, makes NodeSorter
+// use the comparison sort instead.  Keys of "." and of attributes
+// are extracted by several threads when the sort is split, and
+// other keys are evaluated by the transforming thread.
+struct SortCase
+{
+    const char*     m_name;
+
+    const char*     m_sortElements;
+
+    bool            m_split;
+
+    eExpected       m_expected;
+};
+
+
+
+const SortCase  theCases[] =
+{
+    {
+        "Radix sort ascending",
+        "<xsl:sort select=\"@v\" data-type=\"number\"/>",
+        false,
+        eAscending
+    },
+    {
+        "Radix sort descending",
+        "<xsl:sort select=\"@v\" data-type=\"number\" order=\"descending\"/>",
+        false,
+        eDescending
+    },
+    {
+        "Comparison sort ascending",
+        "<xsl:sort select=\"@v\" data-type=\"number\"/>"
+        "<xsl:sort select=\"0\" data-type=\"number\"/>",
+        false,
+        eAscending
+    },
+    {
+        "Comparison sort descending",
+        "<xsl:sort select=\"@v\" data-type=\"number\" order=\"descending\"/>"
+        "<xsl:sort select=\"0\" data-type=\"number\"/>",
+        false,
+        eDescending
+    },
+    {
+        "Parallel sort ascending",
+        "<xsl:sort select=\"@v\" data-type=\"number\"/>"
+        "<xsl:sort select=\"0\" data-type=\"number\"/>",
+        true,
+        eAscending
+    },
+    {
+        "Parallel sort descending",
+        "<xsl:sort select=\"@v\" data-type=\"number\" order=\"descending\"/>"
+        "<xsl:sort select=\"0\" data-type=\"number\"/>",
+        true,
+        eDescending
+    },
+    {
+        "Parallel sort of text",
+        "<xsl:sort select=\"@s\"/>"
+        "<xsl:sort select=\"@v\" data-type=\"number\" order=\"descending\"/>",
+        true,
+        eUnsplit
+    },
+    {
+        "Parallel radix sort",
+        "<xsl:sort select=\"@v\" data-type=\"number\"/>",
+        true,
+        eAscending
+    },
+    {
+        "Parallel sort of the text of the nodes",
+        "<xsl:sort select=\".\"/>"
+        "<xsl:sort select=\"@v\" data-type=\"number\" order=\"descending\"/>",
+        true,
+        eUnsplit
+    },
+    {
+        "Parallel sort of attributes with a prefix",
+        "<xsl:sort select=\"@q:s\"/>"
+        "<xsl:sort select=\"@n\" data-type=\"number\" order=\"descending\"/>",
+        true,
+        eUnsplit
+    },
+    {
+        "Parallel sort of computed keys",
+        "<xsl:sort select=\"concat(@s, '')\"/>"
+        "<xsl:sort select=\"number(@v)\" data-type=\"number\" order=\"descending\"/>",
+        true,
+        eUnsplit
+    }
+};
+
+
+
+int
+transform(
+            XalanTransformer&           theTransformer,
+            const XalanParsedSource*    theSource,
+            const string&               theStylesheet,
+            bool                        fSplit,
+            MemoryManager&              theManager,
+            string&                     theOutput)
+{
+    istringstream   theStylesheetStream(theStylesheet);
+
+    const XalanCompiledStylesheet*  theCompiledStylesheet = 0;
+
+    int     theResult =
+        theTransformer.compileStylesheet(
+            XSLTInputSource(&theStylesheetStream, theManager),
+            theCompiledStylesheet);
+
+    if (theResult == 0)
+    {
+        // Three threads, so one of the merges has an odd run.
+        theTransformer.setParallelSortThreshold(fSplit == true ? 1 : 0);
+        theTransformer.setParallelSortThreadCount(3);
+
+        ostringstream   theStream;
+
+        theResult =
+            theTransformer.transform(
+                *theSource,
+                theCompiledStylesheet,
+                XSLTResultTarget(theStream, theManager));
+
+        theOutput = theStream.str();
+    }
+
+    if (theResult != 0)
+    {
+        cerr << "The transformation failed: "
+             << theTransformer.getLastError()
+             << endl;
+    }
+
+    return theResult;
+}
+
+
+
+bool
+runCase(
+            const SortCase&             theCase,
+            XalanTransformer&           theTransformer,
+            const XalanParsedSource*    theSource,
+            MemoryManager&              theManager)
+{
+    const string    theStylesheet = makeStylesheet(theCase.m_sortElements);
+
+    string  theExpected;
+
+    if (theCase.m_expected != eUnsplit)
+    {
+        theExpected = makeExpected(theCase.m_expected == eDescending);
+    }
+    else if (transform(
+                theTransformer,
+                theSource,
+                theStylesheet,
+                false,
+                theManager,
+                theExpected) != 0)
+    {
+        cerr << theCase.m_name << ": the reference transformation failed." << endl;
+
+        return false;
+    }
+
+    string  theOutput;
+
+    if (transform(
+            theTransformer,
+            theSource,
+            theStylesheet,
+            theCase.m_split,
+            theManager,
+            theOutput) != 0)
+    {
+        cerr << theCase.m_name << ": failed." << endl;
+
+        return false;
+    }
+    else if (theOutput != theExpected)
+    {
+        cerr << theCase.m_name
+             << ": the order differs from the expected order."
+             << endl;
+
+        return false;
+    }
+    else
+    {
+        cout << theCase.m_name << ": passed." << endl;
+
+        return true;
+    }
+}
+
+
+
+}
+
+
+
+int
+main(
+            int     argc,
+            char*   /* argv */[])
+{
+    if (argc != 1)
+    {
+        cerr << "Usage: SortTest" << endl;
+
+        return 1;
+    }
+
+    int     theFailures = 0;
+
+    try
+    {
+        using xercesc::XMLPlatformUtils;
+
+        XMLPlatformUtils::Initialize();
+
+        XalanTransformer::initialize();
+
+        {
+            MemoryManager&  theManager = xalanc::XalanMemMgrs::getDefaultXercesMemMgr();
+
+            XalanTransformer    theTransformer(theManager);
+
+            if (theTransformer.getParallelSortThreshold() == 0)
+            {
+                cerr << "Sorts are never split between threads by default." << endl;
+
+                ++theFailures;
+            }
+
+            istringstream   theSourceStream(makeSource());
+
+            const XalanParsedSource*    theSource = 0;
+
+            if (theTransformer.parseSource(
+                    XSLTInputSource(&theSourceStream, theManager),
+                    theSource) != 0)
+            {
+                cerr << "The source document could not be parsed: "
+                     << theTransformer.getLastError()
+                     << endl;
+
+                ++theFailures;
+            }
+            else
+            {
+                for (size_t i = 0; i < sizeof(theCases) / sizeof(theCases[0]); ++i)
+                {
+                    if (runCase(theCases[i], theTransformer, theSource, theManager) == false)
+                    {
+                        ++theFailures;
+                    }
+                }
+            }
+        }
+
+        XalanTransformer::terminate();
+
+        XMLPlatformUtils::Terminate();
+
+        XalanTransformer::ICUCleanUp();
+    }
+    catch(...)
+    {
+        cerr << "Initialization failed!" << endl;
+
+        return 1;
+    }
+
+    return theFailures == 0 ? 0 : 1;
+}
@@ -0,0 +1,1159 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Base header file.  Must be first.
+#include <xalanc/Include/PlatformDefinitions.hpp>
+
+
+
+#include <iostream>
+#include <vector>
+
+
+
+#include <xercesc/util/PlatformUtils.hpp>
+
+
+
+#include <xalanc/Include/XalanSmallVector.hpp>
+
+
+
+#include <xalanc/PlatformSupport/DOMStringHelper.hpp>
+#include <xalanc/PlatformSupport/XalanCharScanner.hpp>
+#include <xalanc/PlatformSupport/XalanMemoryManagerDefault.hpp>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+#include <xalanc/XPath/XalanTranslationTable.hpp>
+
+
+
+#include <xalanc/XalanTransformer/XalanTransformer.hpp>
+
+
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::vector;
+
+using xalanc::MemoryManager;
+using xalanc::XalanCharScanner;
+using xalanc::XalanDOMChar;
+using xalanc::XalanDOMString;
+using xalanc::XalanMemoryManager;
+using xalanc::XalanMemoryManagerDefault;
+using xalanc::XalanSmallVector;
+using xalanc::XalanTransformer;
+using xalanc::XalanTranslationTable;
+
+
+
+namespace {
+
+
+
+// Counts the blocks allocated, and the blocks which are still
+// allocated, so a test can tell when memory is allocated or freed.
+class CountingMemoryManager : public XalanMemoryManager
+{
+public:
+
+    CountingMemoryManager() :
+        m_parent(),
+        m_allocations(0),
+        m_outstanding(0)
+    {
+    }
+
+    virtual
+    ~CountingMemoryManager()
+    {
+    }
+
+    virtual void*
+    allocate(size_type  size)
+    {
+        void* const     theResult = m_parent.allocate(size);
+
+        ++m_allocations;
+        ++m_outstanding;
+
+        return theResult;
+    }
+
+    virtual void
+    deallocate(void*    pointer)
+    {
+        if (pointer != 0)
+        {
+            --m_outstanding;
+        }
+
+        m_parent.deallocate(pointer);
+    }
+
+    virtual MemoryManager*
+    getExceptionMemoryManager()
+    {
+        return m_parent.getExceptionMemoryManager();
+    }
+
+    size_t
+    getAllocations() const
+    {
+        return m_allocations;
+    }
+
+    size_t
+    getOutstanding() const
+    {
+        return m_outstanding;
+    }
+
+private:
+
+    XalanMemoryManagerDefault   m_parent;
+
+    size_t                      m_allocations;
+
+    size_t                      m_outstanding;
+};
+
+
+
+// Tracks the failures for one group of checks.
+class Checker
+{
+public:
+
+    Checker(const char*     theName) :
+        m_name(theName),
+        m_failures(0)
+    {
+    }
+
+    void
+    check(
+            bool            fResult,
+            const char*     theDescription)
+    {
+        if (fResult == false)
+        {
+            cerr << m_name << ": " << theDescription << endl;
+
+            ++m_failures;
+        }
+    }
+
+    bool
+    report() const
+    {
+        if (m_failures == 0)
+        {
+            cout << m_name << ": passed." << endl;
+
+            return true;
+        }
+        else
+        {
+            cerr << m_name << ": failed." << endl;
+
+            return false;
+        }
+    }
+
+private:
+
+    const char* const   m_name;
+
+    int                 m_failures;
+};
+
+
+
+typedef XalanSmallVector<int, 4>    SmallVectorType;
+
+
+
+// Each element of a vector made by fill() is its index plus a base,
+// so the contents of two vectors can be told apart.
+void
+fill(
+            SmallVectorType&    theVector,
+            int                 theCount,
+            int                 theBase)
+{
+    for (int i = 0; i < theCount; ++i)
+    {
+        theVector.push_back(theBase + i);
+    }
+}
+
+
+
+bool
+hasContents(
+            const SmallVectorType&  theVector,
+            int                     theCount,
+            int                     theBase)
+{
+    if (theVector.size() != SmallVectorType::size_type(theCount))
+    {
+        return false;
+    }
+
+    for (int i = 0; i < theCount; ++i)
+    {
+        if (theVector[i] != theBase + i)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+bool
+testSmallVectorGrowth()
+{
+    Checker     theChecker("Small vector growth");
+
+    CountingMemoryManager   theManager;
+
+    {
+        SmallVectorType     theVector(theManager);
+
+        fill(theVector, 4, 0);
+
+        theChecker.check(hasContents(theVector, 4, 0), "The inline elements are wrong.");
+        theChecker.check(theVector.capacity() == 4, "The inline capacity is wrong.");
+        theChecker.check(theManager.getAllocations() == 0, "The inline elements allocated memory.");
+
+        theVector.push_back(4);
+
+        theChecker.check(hasContents(theVector, 5, 0), "The elements changed when the buffer moved to the heap.");
+        theChecker.check(theVector.capacity() >= 5, "The capacity didn't grow.");
+        theChecker.check(theManager.getAllocations() == 1, "Moving to the heap didn't allocate once.");
+
+        for (int i = 5; i < 1000; ++i)
+        {
+            theVector.push_back(i);
+        }
+
+        theChecker.check(hasContents(theVector, 1000, 0), "The elements changed as the vector grew.");
+        theChecker.check(theManager.getOutstanding() == 1, "The old buffers weren't freed as the vector grew.");
+
+        // Shrinking keeps the heap buffer...
+        theVector.resize(2);
+
+        theChecker.check(hasContents(theVector, 2, 0), "Shrinking changed the elements.");
+        theChecker.check(theManager.getOutstanding() == 1, "Shrinking freed the buffer.");
+
+        theVector.resize(6, 7);
+
+        theChecker.check(
+            theVector.size() == 6 && theVector[1] == 1 && theVector[2] == 7 && theVector[5] == 7,
+            "Growing with a value gave the wrong elements.");
+
+        // Assigning and inserting parts of the vector to itself...
+        theVector.assign(theVector.begin(), theVector.begin() + 4);
+        theVector.insert(theVector.begin() + 1, theVector.begin(), theVector.end());
+
+        const int   theExpected[] = { 0, 0, 1, 7, 7, 1, 7, 7 };
+
+        bool    fInserted = theVector.size() == 8;
+
+        for (int i = 0; i < 8 && fInserted == true; ++i)
+        {
+            fInserted = theVector[i] == theExpected[i];
+        }
+
+        theChecker.check(fInserted, "Inserting the vector into itself gave the wrong elements.");
+
+        theVector.erase(theVector.begin(), theVector.begin() + 3);
+
+        theChecker.check(
+            theVector.size() == 5 && theVector[0] == 7 && theVector[4] == 7,
+            "Erasing gave the wrong elements.");
+    }
+
+    theChecker.check(theManager.getOutstanding() == 0, "The heap buffer wasn't freed.");
+
+    {
+        SmallVectorType     theVector(theManager);
+
+        fill(theVector, 3, 0);
+
+        // Inserting the vector into itself, when the insertion doesn't
+        // fit in the inline buffer...
+        theVector.insert(theVector.end(), theVector.begin(), theVector.end());
+
+        theChecker.check(
+            theVector.size() == 6 && theVector[3] == 0 && theVector[5] == 2,
+            "Inserting the inline elements into themselves gave the wrong elements.");
+    }
+
+    theChecker.check(theManager.getOutstanding() == 0, "The buffer for the insertion wasn't freed.");
+
+    return theChecker.report();
+}
+
+
+
+bool
+testSmallVectorSwap()
+{
+    Checker     theChecker("Small vector swap");
+
+    CountingMemoryManager   theManager;
+
+    {
+        SmallVectorType     theInline1(theManager);
+        SmallVectorType     theInline2(theManager);
+        SmallVectorType     theHeap1(theManager);
+        SmallVectorType     theHeap2(theManager);
+
+        fill(theInline1, 2, 100);
+        fill(theInline2, 4, 200);
+        fill(theHeap1, 10, 300);
+        fill(theHeap2, 20, 400);
+
+        const size_t    theAllocations = theManager.getAllocations();
+
+        theInline1.swap(theInline2);
+
+        theChecker.check(
+            hasContents(theInline1, 4, 200) && hasContents(theInline2, 2, 100),
+            "Swapping two inline vectors gave the wrong elements.");
+
+        theHeap1.swap(theHeap2);
+
+        theChecker.check(
+            hasContents(theHeap1, 20, 400) && hasContents(theHeap2, 10, 300),
+            "Swapping two heap vectors gave the wrong elements.");
+
+        // The heap buffer changes owners, and the inline elements are
+        // copied.
+        theInline1.swap(theHeap1);
+
+        theChecker.check(
+            hasContents(theInline1, 20, 400) && hasContents(theHeap1, 4, 200),
+            "Swapping an inline vector with a heap vector gave the wrong elements.");
+
+        theHeap2.swap(theInline2);
+
+        theChecker.check(
+            hasContents(theHeap2, 2, 100) && hasContents(theInline2, 10, 300),
+            "Swapping a heap vector with an inline vector gave the wrong elements.");
+
+        theChecker.check(
+            theManager.getAllocations() == theAllocations,
+            "Swapping allocated memory.");
+
+        theChecker.check(theManager.getOutstanding() == 2, "Swapping freed a heap buffer.");
+
+        // The vectors which now hold inline elements must still grow.
+        fill(theHeap1, 10, 4);
+        fill(theHeap2, 10, 2);
+
+        theChecker.check(
+            theHeap1.size() == 14 && theHeap1[3] == 203 && theHeap1[4] == 4 &&
+            theHeap2.size() == 12 && theHeap2[1] == 101 && theHeap2[2] == 2,
+            "A vector couldn't grow after a swap.");
+
+        theInline1.swap(theInline1);
+
+        theChecker.check(hasContents(theInline1, 20, 400), "Swapping a vector with itself changed it.");
+    }
+
+    theChecker.check(theManager.getOutstanding() == 0, "The heap buffers weren't freed.");
+
+    return theChecker.report();
+}
+
+
+
+bool
+testInlineStrings()
+{
+    Checker     theChecker("Inline strings");
+
+    CountingMemoryManager   theManager;
+
+    {
+        const XalanDOMString::size_type     theInlineCapacity =
+            XalanDOMString::eInlineCapacity;
+
+        XalanDOMString  theShort(theInlineCapacity, XalanDOMChar('a'), theManager);
+
+        theChecker.check(theManager.getAllocations() == 0, "A short string allocated memory.");
+
+        XalanDOMString  theLong(theInlineCapacity + 1, XalanDOMChar('b'), theManager);
+
+        theChecker.check(theManager.getAllocations() == 1, "A long string didn't allocate once.");
+
+        theShort.swap(theLong);
+
+        theChecker.check(
+            theShort.length() == theInlineCapacity + 1 && theShort[0] == 'b' &&
+            theLong.length() == theInlineCapacity && theLong[0] == 'a',
+            "Swapping a short and a long string gave the wrong strings.");
+
+        theChecker.check(
+            theShort.c_str()[theInlineCapacity + 1] == 0 &&
+            theLong.c_str()[theInlineCapacity] == 0,
+            "Swapped strings aren't null-terminated.");
+
+        theLong.append(1, XalanDOMChar('c'));
+
+        theChecker.check(
+            theLong.length() == theInlineCapacity + 1 &&
+            theLong[theInlineCapacity] == 'c' &&
+            theLong.c_str()[theInlineCapacity + 1] == 0,
+            "Growing a string out of the inline buffer gave the wrong string.");
+
+        theShort.assign(theLong, 0, 1);
+
+        theChecker.check(
+            theShort.length() == 1 && theShort[0] == 'a' && theShort.c_str()[1] == 0,
+            "Assigning a short string to a long one gave the wrong string.");
+    }
+
+    theChecker.check(theManager.getOutstanding() == 0, "The string buffers weren't freed.");
+
+    return theChecker.report();
+}
+
+
+typedef XalanDOMString::size_type   size_type;
+
+typedef vector<XalanDOMChar>        CharVectorType;
+
+
+
+// The lengths on either side of the blocks the scanner compares at
+// once, so that both the vector loops and the loops which finish the
+// text see a match in the last position.
+const size_type     theLengths[] =
+{
+    0, 1, 2, 7, 8, 9, 15, 16, 17, 23, 24, 25, 31, 32, 33, 47, 48, 49
+};
+
+const size_t    theLengthCount = sizeof(theLengths) / sizeof(theLengths[0]);
+
+
+
+struct CharPair
+{
+    XalanDOMChar    m_filler;
+
+    XalanDOMChar    m_target;
+};
+
+
+
+// The targets share a byte with the filler, are above the 256-entry
+// translation table, or are negative as a signed 16-bit value.
+const CharPair  theSearchPairs[] =
+{
+    { XalanDOMChar('a'), XalanDOMChar('x') },
+    { XalanDOMChar(0x0041), XalanDOMChar(0x4100) },
+    { XalanDOMChar(0x4100), XalanDOMChar(0x0041) },
+    { XalanDOMChar(0x0100), XalanDOMChar(0x00FF) },
+    { XalanDOMChar(0x00FF), XalanDOMChar(0x0100) },
+    { XalanDOMChar('a'), XalanDOMChar(0x8000) },
+    { XalanDOMChar(0xFFFD), XalanDOMChar(0xFFFC) }
+};
+
+
+
+bool
+testFindChar()
+{
+    Checker     theChecker("Character search");
+
+    for (size_t i = 0; i < sizeof(theSearchPairs) / sizeof(theSearchPairs[0]); ++i)
+    {
+        const CharPair&     thePair = theSearchPairs[i];
+
+        for (size_t j = 0; j < theLengthCount; ++j)
+        {
+            const size_type     theLength = theLengths[j];
+
+            // The target follows the text, where it must not be found.
+            CharVectorType  theBuffer(theLength + 1, thePair.m_filler);
+
+            theBuffer[theLength] = thePair.m_target;
+
+            const XalanDOMChar* const   theChars = &theBuffer[0];
+
+            theChecker.check(
+                XalanCharScanner::findChar(theChars, theLength, thePair.m_target) == theLength &&
+                xalanc::indexOf(theChars, theLength, thePair.m_target) == theLength,
+                "A character was found past the end of the text.");
+
+            if (theLength > 0)
+            {
+                theBuffer[theLength - 1] = thePair.m_target;
+
+                theChecker.check(
+                    XalanCharScanner::findChar(theChars, theLength, thePair.m_target) == theLength - 1 &&
+                    xalanc::indexOf(theChars, theLength, thePair.m_target) == theLength - 1,
+                    "A character in the last position wasn't found.");
+
+                theBuffer[0] = thePair.m_target;
+
+                theChecker.check(
+                    XalanCharScanner::findChar(theChars, theLength, thePair.m_target) == 0,
+                    "The first occurrence of a character wasn't found.");
+            }
+        }
+    }
+
+    CountingMemoryManager   theManager;
+
+    const XalanDOMString    theEmptyString(theManager);
+
+    theChecker.check(
+        xalanc::indexOf(theEmptyString, XalanDOMChar('a')) == 0,
+        "A character was found in an empty string.");
+
+    return theChecker.report();
+}
+
+
+
+// Characters at and below the space character which aren't
+// whitespace, and characters which match whitespace in one byte.
+const XalanDOMChar  theNonWhitespace[] =
+{
+    XalanDOMChar('a'),
+    XalanDOMChar(0x0000),
+    XalanDOMChar(0x0008),
+    XalanDOMChar(0x001F),
+    XalanDOMChar(0x0021),
+    XalanDOMChar(0x0120),
+    XalanDOMChar(0x2000),
+    XalanDOMChar(0x0A0D),
+    XalanDOMChar(0xFF20)
+};
+
+const XalanDOMChar  theWhitespace[] =
+{
+    XalanDOMChar(0x0020),
+    XalanDOMChar(0x0009),
+    XalanDOMChar(0x000A),
+    XalanDOMChar(0x000D)
+};
+
+
+
+bool
+testScanNonWhitespace()
+{
+    Checker     theChecker("Whitespace scan");
+
+    for (size_t i = 0; i < sizeof(theNonWhitespace) / sizeof(theNonWhitespace[0]); ++i)
+    {
+        for (size_t j = 0; j < sizeof(theWhitespace) / sizeof(theWhitespace[0]); ++j)
+        {
+            for (size_t k = 0; k < theLengthCount; ++k)
+            {
+                const size_type     theLength = theLengths[k];
+
+                CharVectorType  theBuffer(theLength + 1, theNonWhitespace[i]);
+
+                theBuffer[theLength] = theWhitespace[j];
+
+                const XalanDOMChar* const   theChars = &theBuffer[0];
+
+                theChecker.check(
+                    XalanCharScanner::scanNonWhitespace(theChars, theLength) == theLength,
+                    "The scan didn't stop at the end of the text.");
+
+                if (theLength > 0)
+                {
+                    theBuffer[theLength - 1] = theWhitespace[j];
+
+                    theChecker.check(
+                        XalanCharScanner::scanNonWhitespace(theChars, theLength) == theLength - 1,
+                        "The scan didn't stop at whitespace in the last position.");
+                }
+            }
+        }
+    }
+
+    return theChecker.report();
+}
+
+
+// The characters which end a run of text that needs no escaping.  Some
+// share a byte with '<', '>', '&' or '"', and some are negative as a
+// signed 16-bit value, so a comparison of the wrong width or sign
+// would miss them.
+const XalanDOMChar  theEscapable[] =
+{
+    XalanDOMChar('<'),
+    XalanDOMChar('>'),
+    XalanDOMChar('&'),
+    XalanDOMChar(0x0000),
+    XalanDOMChar(0x0009),
+    XalanDOMChar(0x000A),
+    XalanDOMChar(0x001F),
+    XalanDOMChar(0x007F),
+    XalanDOMChar(0x0080),
+    XalanDOMChar(0x00E9),
+    XalanDOMChar(0x013C),
+    XalanDOMChar(0x3C00),
+    XalanDOMChar(0x2028),
+    XalanDOMChar(0x8020),
+    XalanDOMChar(0xFFFF)
+};
+
+// The characters at the edges of the printable range, which never end
+// a run, and '"', which ends a run only in an attribute value.
+const XalanDOMChar  thePrintable[] =
+{
+    XalanDOMChar('a'),
+    XalanDOMChar(0x0020),
+    XalanDOMChar(0x007E),
+    XalanDOMChar('"')
+};
+
+
+
+size_type
+referenceScan(
+            const XalanDOMChar*     theChars,
+            size_type               theLength,
+            bool                    fAttribute)
+{
+    size_type   i = 0;
+
+    while (i < theLength &&
+           theChars[i] >= 0x20 &&
+           theChars[i] < 0x7F &&
+           theChars[i] != XalanDOMChar('<') &&
+           theChars[i] != XalanDOMChar('>') &&
+           theChars[i] != XalanDOMChar('&') &&
+           (fAttribute == false || theChars[i] != XalanDOMChar('"')))
+    {
+        ++i;
+    }
+
+    return i;
+}
+
+
+
+// Checks both scans of the text against the reference scan.
+void
+checkScans(
+            Checker&                theChecker,
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+{
+    theChecker.check(
+        XalanCharScanner::scanContent(theChars, theLength) ==
+            referenceScan(theChars, theLength, false),
+        "A content scan stopped at the wrong character.");
+
+    theChecker.check(
+        XalanCharScanner::scanAttribute(theChars, theLength) ==
+            referenceScan(theChars, theLength, true),
+        "An attribute scan stopped at the wrong character.");
+}
+
+
+
+bool
+testScanEscapable()
+{
+    Checker     theChecker("Escapable character scan");
+
+    for (size_t i = 0; i < sizeof(thePrintable) / sizeof(thePrintable[0]); ++i)
+    {
+        for (size_t j = 0; j < sizeof(theEscapable) / sizeof(theEscapable[0]); ++j)
+        {
+            for (size_t k = 0; k < theLengthCount; ++k)
+            {
+                const size_type     theLength = theLengths[k];
+
+                // The escapable character follows the text, where it
+                // must not be seen.
+                CharVectorType  theBuffer(theLength + 1, thePrintable[i]);
+
+                theBuffer[theLength] = theEscapable[j];
+
+                const XalanDOMChar* const   theChars = &theBuffer[0];
+
+                checkScans(theChecker, theChars, theLength);
+
+                // Put the escapable character in every lane, and then
+                // behind an earlier one.
+                for (size_type thePosition = 0; thePosition < theLength; ++thePosition)
+                {
+                    theBuffer[thePosition] = theEscapable[j];
+
+                    checkScans(theChecker, theChars, theLength);
+
+                    if (thePosition + 1 < theLength)
+                    {
+                        theBuffer[theLength - 1] = theEscapable[j];
+
+                        checkScans(theChecker, theChars, theLength);
+
+                        theBuffer[theLength - 1] = thePrintable[i];
+                    }
+
+                    theBuffer[thePosition] = thePrintable[i];
+                }
+            }
+        }
+    }
+
+    return theChecker.report();
+}
+
+
+
+// Characters which are just outside ASCII, or which have an ASCII
+// byte, or are negative as a signed 16-bit value.
+const XalanDOMChar  theNonASCII[] =
+{
+    XalanDOMChar(0x0080),
+    XalanDOMChar(0x00FF),
+    XalanDOMChar(0x0100),
+    XalanDOMChar(0x0141),
+    XalanDOMChar(0x4100),
+    XalanDOMChar(0x8000),
+    XalanDOMChar(0xFFFF)
+};
+
+
+
+bool
+testScanASCII()
+{
+    Checker     theChecker("ASCII scan");
+
+    for (size_t i = 0; i < sizeof(theNonASCII) / sizeof(theNonASCII[0]); ++i)
+    {
+        for (size_t j = 0; j < theLengthCount; ++j)
+        {
+            const size_type     theLength = theLengths[j];
+
+            // The text holds every ASCII character, including the
+            // first and the last.
+            CharVectorType  theBuffer(theLength + 1);
+
+            for (size_type k = 0; k < theLength; ++k)
+            {
+                theBuffer[k] = XalanDOMChar((k * 37 + 0x7F) % 0x80);
+            }
+
+            theBuffer[theLength] = theNonASCII[i];
+
+            const XalanDOMChar* const   theChars = &theBuffer[0];
+
+            theChecker.check(
+                XalanCharScanner::scanASCII(theChars, theLength) == theLength,
+                "The scan didn't stop at the end of the text.");
+
+            for (size_type thePosition = 0; thePosition < theLength; ++thePosition)
+            {
+                const XalanDOMChar  theSaved = theBuffer[thePosition];
+
+                theBuffer[thePosition] = theNonASCII[i];
+
+                theChecker.check(
+                    XalanCharScanner::scanASCII(theChars, theLength) == thePosition,
+                    "The scan didn't stop at a non-ASCII character.");
+
+                theBuffer[thePosition] = theSaved;
+            }
+        }
+    }
+
+    return theChecker.report();
+}
+
+
+
+bool
+testNarrowASCII()
+{
+    Checker     theChecker("ASCII narrowing");
+
+    for (size_t i = 0; i < theLengthCount; ++i)
+    {
+        const size_type     theLength = theLengths[i];
+
+        CharVectorType  theChars(theLength + 1);
+
+        for (size_type j = 0; j < theLength; ++j)
+        {
+            theChars[j] = XalanDOMChar((j * 37 + 0x7F) % 0x80);
+        }
+
+        // The byte after the text must not be written.
+        vector<char>    theBuffer(theLength + 1, char(0x55));
+
+        XalanCharScanner::narrowASCII(&theChars[0], theLength, &theBuffer[0]);
+
+        bool    fMatched = true;
+
+        for (size_type j = 0; j < theLength; ++j)
+        {
+            if (theBuffer[j] != char(theChars[j]))
+            {
+                fMatched = false;
+            }
+        }
+
+        theChecker.check(fMatched == true, "A character was narrowed to the wrong byte.");
+
+        theChecker.check(
+            theBuffer[theLength] == char(0x55),
+            "A byte past the end of the buffer was written.");
+    }
+
+    return theChecker.report();
+}
+
+
+
+
+struct SubstringCase
+{
+    const char*     m_string;
+
+    // The length of the string to search, which may be shorter than
+    // m_string, so the rest must be ignored.
+    size_type       m_length;
+
+    const char*     m_substring;
+
+    size_type       m_expected;
+};
+
+
+
+const SubstringCase     theSubstringCases[] =
+{
+    { "", 0, "", 0 },
+    { "abc", 3, "", 0 },
+    { "", 0, "a", 0 },
+    { "ab", 2, "abc", 2 },
+    { "abc", 3, "abc", 0 },
+    { "abcabd", 6, "abd", 3 },
+    { "xxab", 4, "abc", 4 },
+    { "xxabc", 4, "abc", 4 },
+    { "xxabc", 4, "ab", 2 },
+    { "aaaaaaaaaaaaaaaaab", 18, "aab", 15 },
+    { "xxxxxxxxxxxxxxxxxxxxa", 21, "a", 20 },
+    { "xxxxxxxxxxxxxxxxxxxxab", 21, "ab", 21 },
+    { "abababababababababababc", 23, "abc", 20 }
+};
+
+
+
+bool
+testSubstringSearch()
+{
+    Checker     theChecker("Substring search");
+
+    CountingMemoryManager   theManager;
+
+    for (size_t i = 0; i < sizeof(theSubstringCases) / sizeof(theSubstringCases[0]); ++i)
+    {
+        const SubstringCase&    theCase = theSubstringCases[i];
+
+        const XalanDOMString    theString(theCase.m_string, theManager);
+        const XalanDOMString    theSubstring(theCase.m_substring, theManager);
+
+        const size_type     theResult =
+            xalanc::indexOf(
+                theString.c_str(),
+                theCase.m_length,
+                theSubstring.c_str(),
+                theSubstring.length());
+
+        if (theResult != theCase.m_expected)
+        {
+            cerr << "Searching for \"" << theCase.m_substring
+                 << "\" in the first " << theCase.m_length
+                 << " characters of \"" << theCase.m_string
+                 << "\" gave " << theResult
+                 << " instead of " << theCase.m_expected
+                 << "." << endl;
+
+            theChecker.check(false, "A substring search gave the wrong index.");
+        }
+    }
+
+    // A substring starting with a character above the table, after
+    // characters which share its bytes...
+    CharVectorType  theChars(17, XalanDOMChar(0x0041));
+
+    theChars.push_back(XalanDOMChar(0x4100));
+    theChars.push_back(XalanDOMChar(0x0041));
+
+    const XalanDOMChar  theSubstring[] = { XalanDOMChar(0x4100), XalanDOMChar(0x0041) };
+
+    theChecker.check(
+        xalanc::indexOf(&theChars[0], size_type(theChars.size()), theSubstring, 2) == 17,
+        "A substring of wide characters wasn't found.");
+
+    return theChecker.report();
+}
+
+
+
+// Translate the way the XPath recommendation describes it.
+void
+referenceTranslate(
+            const XalanDOMString&   theString,
+            const XalanDOMString&   theFromString,
+            const XalanDOMString&   theToString,
+            XalanDOMString&         theResult)
+{
+    for (size_type i = 0; i < theString.length(); ++i)
+    {
+        size_type   j = 0;
+
+        while (j < theFromString.length() && theFromString[j] != theString[i])
+        {
+            ++j;
+        }
+
+        if (j == theFromString.length())
+        {
+            theResult.append(1, theString[i]);
+        }
+        else if (j < theToString.length())
+        {
+            theResult.append(1, theToString[j]);
+        }
+    }
+}
+
+
+
+struct TranslationCase
+{
+    const char*             m_name;
+
+    const XalanDOMChar*     m_from;
+
+    const XalanDOMChar*     m_to;
+};
+
+
+
+// Duplicate characters in the from string, a from string longer than
+// the to string, and characters on both sides of the table's end.
+const XalanDOMChar  theFrom1[] = { 'a', 'b', 'a', 'c', 0 };
+const XalanDOMChar  theTo1[] = { 'x', 'y', 'z', 0 };
+
+const XalanDOMChar  theFrom2[] = { 0 };
+const XalanDOMChar  theTo2[] = { 'a', 'b', 0 };
+
+const XalanDOMChar  theFrom3[] = { 'a', 0x00FF, 0x4100, 0 };
+const XalanDOMChar  theTo3[] = { 0 };
+
+const XalanDOMChar  theFrom4[] = { 0x00FF, 0x0100, 'a', 0x0100, 0x4100, 0x00FF, 0 };
+const XalanDOMChar  theTo4[] = { 0x0100, 0x00FF, 'b', 'c', 'd', 'e', 0 };
+
+const XalanDOMChar  theFrom5[] = { 0x4100, 0xFFFD, 0x4100, 0x8000, 0 };
+const XalanDOMChar  theTo5[] = { 'A', 0x4100, 'B', 0 };
+
+const XalanDOMChar  theFrom6[] = { 0x0041, 0x00FE, 0 };
+const XalanDOMChar  theTo6[] = { 0x4100, 0x00FF, 0x0100, 0 };
+
+const TranslationCase   theTranslationCases[] =
+{
+    { "duplicates", theFrom1, theTo1 },
+    { "empty from string", theFrom2, theTo2 },
+    { "empty to string", theFrom3, theTo3 },
+    { "table boundary", theFrom4, theTo4 },
+    { "wide characters only", theFrom5, theTo5 },
+    { "wide replacements", theFrom6, theTo6 }
+};
+
+
+
+bool
+testTranslationTable()
+{
+    Checker     theChecker("Translation table");
+
+    CountingMemoryManager   theManager;
+
+    // Every character in the table, and some beyond it...
+    CharVectorType  theChars;
+
+    for (XalanDOMChar i = 1; i < 0x0110; ++i)
+    {
+        theChars.push_back(i);
+    }
+
+    theChars.push_back(XalanDOMChar(0x4100));
+    theChars.push_back(XalanDOMChar(0x4141));
+    theChars.push_back(XalanDOMChar(0x8000));
+    theChars.push_back(XalanDOMChar(0xFFFD));
+    theChars.push_back(XalanDOMChar('a'));
+
+    const XalanDOMString    theString(&theChars[0], theManager, size_type(theChars.size()));
+    const XalanDOMString    theEmptyString(theManager);
+
+    for (size_t i = 0; i < sizeof(theTranslationCases) / sizeof(theTranslationCases[0]); ++i)
+    {
+        const TranslationCase&  theCase = theTranslationCases[i];
+
+        const XalanDOMString    theFromString(theCase.m_from, theManager);
+        const XalanDOMString    theToString(theCase.m_to, theManager);
+
+        const XalanTranslationTable     theTable(theFromString, theToString);
+
+        XalanDOMString  theExpected(theManager);
+
+        referenceTranslate(theString, theFromString, theToString, theExpected);
+
+        XalanDOMString  theResult(theManager);
+
+        theTable.translate(theString, theResult);
+
+        if (theResult != theExpected)
+        {
+            cerr << "The translation differs for the case: " << theCase.m_name << endl;
+
+            theChecker.check(false, "A string was translated incorrectly.");
+        }
+
+        theResult.clear();
+
+        theTable.translate(theEmptyString, theResult);
+
+        theChecker.check(theResult.empty() == true, "Translating an empty string gave characters.");
+    }
+
+    return theChecker.report();
+}
+
+
+
+}
+
+
+
+int
+main(
+            int     argc,
+            char*   /* argv */[])
+{
+    if (argc != 1)
+    {
+        cerr << "Usage: StringsTest" << endl;
+
+        return 1;
+    }
+
+    int     theFailures = 0;
+
+    try
+    {
+        using xercesc::XMLPlatformUtils;
+
+        XMLPlatformUtils::Initialize();
+
+        XalanTransformer::initialize();
+
+        if (testSmallVectorGrowth() == false)
+        {
+            ++theFailures;
+        }
+
+        if (testSmallVectorSwap() == false)
+        {
+            ++theFailures;
+        }
+
+        if (testInlineStrings() == false)
+        {
+            ++theFailures;
+        }
+
+        if (testFindChar() == false)
+        {
+            ++theFailures;
+        }
+
+        if (testScanNonWhitespace() == false)
+        {
+            ++theFailures;
+        }
+
+        if (testScanEscapable() == false)
+        {
+            ++theFailures;
+        }
+
+        if (testScanASCII() == false)
+        {
+            ++theFailures;
+        }
+
+        if (testNarrowASCII() == false)
+        {
+            ++theFailures;
+        }
+
+        if (testSubstringSearch() == false)
+        {
+            ++theFailures;
+        }
+
+        if (testTranslationTable() == false)
+        {
+            ++theFailures;
+        }
+
+        XalanTransformer::terminate();
+
+        XMLPlatformUtils::Terminate();
+
+        XalanTransformer::ICUCleanUp();
+    }
+    catch(...)
+    {
+        cerr << "Initialization failed!" << endl;
+
+        return 1;
+    }
+
+    return theFailures == 0 ? 0 : 1;
+}
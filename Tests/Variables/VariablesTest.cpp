@@ -0,0 +1,495 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Base header file.  Must be first.
+#include <xalanc/Include/PlatformDefinitions.hpp>
+
+
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+
+
+#include <xercesc/util/PlatformUtils.hpp>
+
+
+
+#include <xalanc/XPath/XObjectFactoryDefault.hpp>
+
+
+
+#include <xalanc/XSLT/StylesheetRoot.hpp>
+
+
+
+#include <xalanc/XalanTransformer/XalanCompiledStylesheet.hpp>
+#include <xalanc/XalanTransformer/XalanTransformer.hpp>
+
+
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::istringstream;
+using std::ostringstream;
+using std::string;
+
+using xalanc::MemoryManager;
+using xalanc::XalanCompiledStylesheet;
+using xalanc::XalanDOMString;
+using xalanc::XalanGlobalValueCache;
+using xalanc::XalanParsedSource;
+using xalanc::XalanTransformer;
+using xalanc::XObject;
+using xalanc::XObjectFactoryDefault;
+using xalanc::XObjectPtr;
+using xalanc::XSLTInputSource;
+using xalanc::XSLTResultTarget;
+
+
+
+namespace {
+
+
+
+// References are resolved to the slots of globals, or to the slots of
+// locals in their template, when the stylesheet is compiled, so each
+// stylesheet checks a reference with and without a local in scope.
+struct VariablesCase
+{
+    const char*     m_name;
+
+    const char*     m_stylesheet;
+
+    const char*     m_expected;
+};
+
+
+
+const VariablesCase     theCases[] =
+{
+    {
+        "Locals which shadow globals",
+        "scope.xsl",
+        "global,local global,local global,global,local global,default global,global rtf"
+    },
+    {
+        "Params and forward references",
+        "params.xsl",
+        "2,20,22,21,121,25,100"
+    },
+    {
+        "Import precedence",
+        "imports.xsl",
+        "main,b,a,c;main,b,a,c"
+    },
+    {
+        "Sort keys and attribute sets",
+        "sort.xsl",
+        "<doc>abc,bac,"
+        "<r id=\"item-3\">local-</r>"
+        "<r id=\"item-1\">local-</r>"
+        "<r id=\"item-2\">local-</r>"
+        "</doc>"
+    },
+    {
+        "Variables which hold only text",
+        "text.xsl",
+        "abcd,4,true,true,1,abcd,1,1,1,0,1,abcd,abcd,2,1,ef"
+    },
+    {
+        "Locals and params in template slots",
+        "locals.xsl",
+        "[1:3y2][3:w3ly][2:3y2dza]|3-2-1-0123|416121|gg12"
+    }
+};
+
+
+
+// The XML output method may end the document with a newline.
+string
+trimOutput(const string&    theOutput)
+{
+    string::size_type   theLength = theOutput.length();
+
+    while (theLength > 0 &&
+           (theOutput[theLength - 1] == '\n' || theOutput[theLength - 1] == '\r'))
+    {
+        --theLength;
+    }
+
+    return theOutput.substr(0, theLength);
+}
+
+
+
+int
+transform(
+            XalanTransformer&               theTransformer,
+            const XalanParsedSource*        theSource,
+            const XalanCompiledStylesheet*  theStylesheet,
+            MemoryManager&                  theManager,
+            string&                         theOutput)
+{
+    ostringstream   theStream;
+
+    const int   theResult =
+        theTransformer.transform(
+            *theSource,
+            theStylesheet,
+            XSLTResultTarget(theStream, theManager));
+
+    theOutput = trimOutput(theStream.str());
+
+    return theResult;
+}
+
+
+
+bool
+runCase(
+            const VariablesCase&        theCase,
+            XalanTransformer&           theTransformer,
+            const XalanParsedSource*    theSource,
+            MemoryManager&              theManager)
+{
+    const XalanCompiledStylesheet*  theStylesheet = 0;
+
+    string  theOutput;
+
+    if (theTransformer.compileStylesheet(
+            XSLTInputSource(theCase.m_stylesheet, theManager),
+            theStylesheet) != 0 ||
+        transform(
+            theTransformer,
+            theSource,
+            theStylesheet,
+            theManager,
+            theOutput) != 0)
+    {
+        cerr << theCase.m_name
+             << ": failed: "
+             << theTransformer.getLastError()
+             << endl;
+
+        return false;
+    }
+    else if (theOutput != theCase.m_expected)
+    {
+        cerr << theCase.m_name
+             << ": expected \""
+             << theCase.m_expected
+             << "\", got \""
+             << theOutput
+             << "\"."
+             << endl;
+
+        return false;
+    }
+    else
+    {
+        cout << theCase.m_name << ": passed." << endl;
+
+        return true;
+    }
+}
+
+
+
+// Each run of globals.xsl uses the same compiled stylesheet, with a
+// different value for the param, or with a different source.
+struct GlobalsRun
+{
+    // The expression for the param, or 0 to use its default.
+    const char*     m_param;
+
+    bool            m_useSecondSource;
+
+    const char*     m_expected;
+
+    // The entries of the stylesheet's cache after the run.
+    const char*     m_cached;
+};
+
+
+
+const char* const   theSecondSource = "<doc><item>x</item></doc>";
+
+
+
+const GlobalsRun    theGlobalsRuns[] =
+{
+    {
+        "'one'",
+        false,
+        "constant,14,22,p=one,3,b c a,constant:3",
+        "none,constant,14,22"
+    },
+    {
+        0,
+        true,
+        "constant,14,22,p=default,1,x,constant:1",
+        "default,constant,14,22"
+    },
+    {
+        "'three'",
+        false,
+        "constant,14,22,p=three,3,b c a,constant:3",
+        "default,constant,14,22"
+    }
+};
+
+
+
+string
+getCachedValues(
+            const XalanGlobalValueCache&    theCache,
+            MemoryManager&                  theManager)
+{
+    XObjectFactoryDefault   theFactory(theManager);
+
+    ostringstream   theStream;
+
+    for (XalanGlobalValueCache::size_type i = 0; i < theCache.size(); ++i)
+    {
+        if (i != 0)
+        {
+            theStream << ',';
+        }
+
+        const XObjectPtr    theValue(theCache.get(i, theFactory));
+
+        if (theValue.null() == true)
+        {
+            theStream << "none";
+        }
+        else if (theValue->getType() == XObject::eTypeString)
+        {
+            const XalanDOMString&   theString = theValue->str();
+
+            for (XalanDOMString::size_type j = 0; j < theString.length(); ++j)
+            {
+                theStream << char(theString[j]);
+            }
+        }
+        else
+        {
+            theStream << theValue->num();
+        }
+    }
+
+    return theStream.str();
+}
+
+
+
+bool
+runGlobals(
+            XalanTransformer&           theTransformer,
+            const XalanParsedSource*    theSource,
+            MemoryManager&              theManager)
+{
+    const char* const   theName = "Cached global values";
+
+    istringstream   theSecondStream(theSecondSource);
+
+    const XalanParsedSource*        theSecondParsedSource = 0;
+    const XalanCompiledStylesheet*  theStylesheet = 0;
+
+    if (theTransformer.parseSource(
+            XSLTInputSource(&theSecondStream, theManager),
+            theSecondParsedSource) != 0 ||
+        theTransformer.compileStylesheet(
+            XSLTInputSource("globals.xsl", theManager),
+            theStylesheet) != 0)
+    {
+        cerr << theName
+             << ": failed: "
+             << theTransformer.getLastError()
+             << endl;
+
+        return false;
+    }
+
+    const XalanGlobalValueCache&    theCache =
+        theStylesheet->getStylesheetRoot()->getGlobalValueCache();
+
+    bool    fResult = true;
+
+    if (getCachedValues(theCache, theManager) != "none,none,none,none")
+    {
+        cerr << theName
+             << ": expected four empty entries before the first run, got \""
+             << getCachedValues(theCache, theManager)
+             << "\"."
+             << endl;
+
+        fResult = false;
+    }
+
+    for (size_t i = 0; i < sizeof(theGlobalsRuns) / sizeof(theGlobalsRuns[0]); ++i)
+    {
+        const GlobalsRun&   theRun = theGlobalsRuns[i];
+
+        theTransformer.clearStylesheetParams();
+
+        if (theRun.m_param != 0)
+        {
+            theTransformer.setStylesheetParam("p", theRun.m_param);
+        }
+
+        string  theOutput;
+
+        if (transform(
+                theTransformer,
+                theRun.m_useSecondSource == true ? theSecondParsedSource : theSource,
+                theStylesheet,
+                theManager,
+                theOutput) != 0)
+        {
+            cerr << theName
+                 << ": run "
+                 << i + 1
+                 << " failed: "
+                 << theTransformer.getLastError()
+                 << endl;
+
+            fResult = false;
+        }
+        else if (theOutput != theRun.m_expected)
+        {
+            cerr << theName
+                 << ": run "
+                 << i + 1
+                 << " expected \""
+                 << theRun.m_expected
+                 << "\", got \""
+                 << theOutput
+                 << "\"."
+                 << endl;
+
+            fResult = false;
+        }
+
+        const string    theCached = getCachedValues(theCache, theManager);
+
+        if (theCached != theRun.m_cached)
+        {
+            cerr << theName
+                 << ": after run "
+                 << i + 1
+                 << " expected the cache to hold \""
+                 << theRun.m_cached
+                 << "\", got \""
+                 << theCached
+                 << "\"."
+                 << endl;
+
+            fResult = false;
+        }
+    }
+
+    theTransformer.clearStylesheetParams();
+
+    if (fResult == true)
+    {
+        cout << theName << ": passed." << endl;
+    }
+
+    return fResult;
+}
+
+
+
+}
+
+
+
+int
+main(
+            int     argc,
+            char*   /* argv */[])
+{
+    if (argc != 1)
+    {
+        cerr << "Usage: VariablesTest" << endl;
+
+        return 1;
+    }
+
+    int     theFailures = 0;
+
+    try
+    {
+        using xercesc::XMLPlatformUtils;
+
+        XMLPlatformUtils::Initialize();
+
+        XalanTransformer::initialize();
+
+        {
+            MemoryManager&  theManager = xalanc::XalanMemMgrs::getDefaultXercesMemMgr();
+
+            XalanTransformer    theTransformer(theManager);
+
+            const XalanParsedSource*    theSource = 0;
+
+            if (theTransformer.parseSource(
+                    XSLTInputSource("variables.xml", theManager),
+                    theSource) != 0)
+            {
+                cerr << "The source document could not be parsed: "
+                     << theTransformer.getLastError()
+                     << endl;
+
+                ++theFailures;
+            }
+            else
+            {
+                for (size_t i = 0; i < sizeof(theCases) / sizeof(theCases[0]); ++i)
+                {
+                    if (runCase(theCases[i], theTransformer, theSource, theManager) == false)
+                    {
+                        ++theFailures;
+                    }
+                }
+
+                if (runGlobals(theTransformer, theSource, theManager) == false)
+                {
+                    ++theFailures;
+                }
+            }
+        }
+
+        XalanTransformer::terminate();
+
+        XMLPlatformUtils::Terminate();
+
+        XalanTransformer::ICUCleanUp();
+    }
+    catch(...)
+    {
+        cerr << "Initialization failed!" << endl;
+
+        return 1;
+    }
+
+    return theFailures == 0 ? 0 : 1;
+}
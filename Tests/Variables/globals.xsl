@@ -0,0 +1,33 @@
+<?xml version="1.0"?>
+<!--
+  The first four globals depend only on the stylesheet, so their values
+  are cached by the compiled stylesheet, in the order they're declared.
+  The param's default is cached, but a variable which refers to the
+  param is not.  The rest depend on the source.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="text"/>
+
+<xsl:param name="p" select="'default'"/>
+
+<xsl:variable name="constant" select="concat('const', 'ant')"/>
+
+<xsl:variable name="number" select="floor(7.5) * 2"/>
+
+<xsl:variable name="derived" select="string-length($constant) + $number"/>
+
+<xsl:variable name="uses-param" select="concat('p=', $p)"/>
+
+<xsl:variable name="uses-source" select="count(/doc/item)"/>
+
+<xsl:variable name="uses-context" select="normalize-space()"/>
+
+<xsl:variable name="uses-both" select="concat($constant, ':', $uses-source)"/>
+
+<xsl:template match="/">
+  <xsl:value-of select="concat($constant, ',', $number, ',', $derived, ',', $uses-param, ',')"/>
+  <xsl:value-of select="concat($uses-source, ',', $uses-context, ',', $uses-both)"/>
+</xsl:template>
+
+</xsl:stylesheet>
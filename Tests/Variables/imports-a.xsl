@@ -0,0 +1,16 @@
+<?xml version="1.0"?>
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:variable name="g" select="'a'"/>
+
+<xsl:variable name="h" select="'a'"/>
+
+<xsl:variable name="k" select="'a'"/>
+
+<xsl:variable name="m" select="'a'"/>
+
+<xsl:template name="a">
+  <xsl:value-of select="concat($g, ',', $h, ',', $k, ',', $m)"/>
+</xsl:template>
+
+</xsl:stylesheet>
@@ -0,0 +1,10 @@
+<?xml version="1.0"?>
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:import href="imports-c.xsl"/>
+
+<xsl:variable name="g" select="'b'"/>
+
+<xsl:variable name="h" select="'b'"/>
+
+</xsl:stylesheet>
@@ -0,0 +1,10 @@
+<?xml version="1.0"?>
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:variable name="g" select="'c'"/>
+
+<xsl:variable name="h" select="'c'"/>
+
+<xsl:variable name="m" select="'c'"/>
+
+</xsl:stylesheet>
@@ -0,0 +1,23 @@
+<?xml version="1.0"?>
+<!--
+  The same globals are declared in several imported stylesheets.  The
+  import precedence, from highest to lowest, is this stylesheet,
+  imports-b.xsl, imports-c.xsl, which imports-b.xsl imports, and
+  imports-a.xsl.  A template in imports-a.xsl sees the same values.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:import href="imports-a.xsl"/>
+<xsl:import href="imports-b.xsl"/>
+
+<xsl:output method="text"/>
+
+<xsl:variable name="g" select="'main'"/>
+
+<xsl:template match="/">
+  <xsl:value-of select="concat($g, ',', $h, ',', $k, ',', $m)"/>
+  <xsl:text>;</xsl:text>
+  <xsl:call-template name="a"/>
+</xsl:template>
+
+</xsl:stylesheet>
@@ -0,0 +1,79 @@
+<?xml version="1.0"?>
+<!--
+  Local variables and params are assigned slots in their template.
+  The templates applied in one frame reuse the same slots for params
+  and locals with different names, and one declares a local with the
+  name of a param passed to the others.  Params are passed, and
+  defaulted from a select and from content.  A recursive template
+  uses its locals after each call returns, a for-each pushes a local
+  for each item, and a global's content has its own local.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="text"/>
+
+<xsl:variable name="g">
+  <xsl:variable name="a" select="'g'"/>
+  <xsl:value-of select="concat($a, $a)"/>
+</xsl:variable>
+
+<xsl:template match="/">
+  <xsl:variable name="a" select="1"/>
+  <xsl:variable name="b" select="2"/>
+  <xsl:apply-templates select="doc/item">
+    <xsl:with-param name="x" select="$a + $b"/>
+    <xsl:with-param name="y">y<xsl:value-of select="$b"/></xsl:with-param>
+  </xsl:apply-templates>
+  <xsl:text>|</xsl:text>
+  <xsl:call-template name="down">
+    <xsl:with-param name="n" select="3"/>
+  </xsl:call-template>
+  <xsl:text>|</xsl:text>
+  <xsl:for-each select="doc/item">
+    <xsl:variable name="i" select="@n * $b"/>
+    <xsl:value-of select="concat($i, $a)"/>
+  </xsl:for-each>
+  <xsl:text>|</xsl:text>
+  <xsl:value-of select="concat($g, $a, $b)"/>
+</xsl:template>
+
+<xsl:template match="item[@m = 1]">
+  <xsl:param name="x"/>
+  <xsl:param name="y"/>
+  <xsl:variable name="v" select="concat($x, $y)"/>
+  <xsl:value-of select="concat('[1:', $v, ']')"/>
+</xsl:template>
+
+<xsl:template match="item[@m = 2]">
+  <xsl:param name="y"/>
+  <xsl:param name="z" select="'dz'"/>
+  <xsl:param name="x"/>
+  <xsl:variable name="v" select="."/>
+  <xsl:value-of select="concat('[2:', $x, $y, $z, $v, ']')"/>
+</xsl:template>
+
+<xsl:template match="item">
+  <xsl:param name="w">w<xsl:value-of select="@n"/></xsl:param>
+  <xsl:variable name="y" select="'ly'"/>
+  <xsl:value-of select="concat('[3:', $w, $y, ']')"/>
+</xsl:template>
+
+<xsl:template name="down">
+  <xsl:param name="n"/>
+  <xsl:param name="acc" select="''"/>
+  <xsl:variable name="s" select="concat($acc, $n)"/>
+  <xsl:choose>
+    <xsl:when test="$n &gt; 0">
+      <xsl:call-template name="down">
+        <xsl:with-param name="n" select="$n - 1"/>
+        <xsl:with-param name="acc" select="concat($s, '-')"/>
+      </xsl:call-template>
+      <xsl:value-of select="$n"/>
+    </xsl:when>
+    <xsl:otherwise>
+      <xsl:value-of select="$s"/>
+    </xsl:otherwise>
+  </xsl:choose>
+</xsl:template>
+
+</xsl:stylesheet>
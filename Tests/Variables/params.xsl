@@ -0,0 +1,38 @@
+<?xml version="1.0"?>
+<!--
+  Globals which refer to a param declared before them, and to a
+  variable declared after them.  The template's param shadows a
+  global, and a later sibling refers to both.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="text"/>
+
+<xsl:param name="p" select="2"/>
+
+<xsl:variable name="v" select="$p * 10"/>
+
+<xsl:variable name="early" select="$late + 1"/>
+
+<xsl:variable name="late" select="$v + 1"/>
+
+<xsl:variable name="q" select="100"/>
+
+<xsl:template match="/">
+  <xsl:value-of select="concat($p, ',', $v, ',', $early, ',', $late, ',')"/>
+  <xsl:call-template name="sum"/>
+  <xsl:text>,</xsl:text>
+  <xsl:call-template name="sum">
+    <xsl:with-param name="q" select="5"/>
+  </xsl:call-template>
+  <xsl:text>,</xsl:text>
+  <xsl:value-of select="$q"/>
+</xsl:template>
+
+<xsl:template name="sum">
+  <xsl:param name="q" select="$q + 1"/>
+  <xsl:variable name="w" select="$q + $v"/>
+  <xsl:value-of select="$w"/>
+</xsl:template>
+
+</xsl:stylesheet>
@@ -0,0 +1,51 @@
+<?xml version="1.0"?>
+<!--
+  Locals which shadow a global, in a template, in the content of a
+  global variable, and in the select of a param.  A variable is not
+  in scope in its own select or content, and a called template sees
+  the global.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="text"/>
+
+<xsl:variable name="g" select="'global'"/>
+
+<xsl:variable name="rtf">
+  <xsl:value-of select="$g"/>
+  <xsl:text> </xsl:text>
+  <xsl:variable name="g" select="'rtf'"/>
+  <xsl:value-of select="$g"/>
+</xsl:variable>
+
+<xsl:template match="/">
+  <xsl:value-of select="$g"/>
+  <xsl:text>,</xsl:text>
+  <xsl:variable name="g" select="concat('local ', $g)"/>
+  <xsl:value-of select="$g"/>
+  <xsl:text>,</xsl:text>
+  <xsl:for-each select="doc/item[1]">
+    <xsl:value-of select="$g"/>
+  </xsl:for-each>
+  <xsl:text>,</xsl:text>
+  <xsl:call-template name="global"/>
+  <xsl:text>,</xsl:text>
+  <xsl:call-template name="param">
+    <xsl:with-param name="g" select="$g"/>
+  </xsl:call-template>
+  <xsl:text>,</xsl:text>
+  <xsl:call-template name="param"/>
+  <xsl:text>,</xsl:text>
+  <xsl:value-of select="$rtf"/>
+</xsl:template>
+
+<xsl:template name="global">
+  <xsl:value-of select="$g"/>
+</xsl:template>
+
+<xsl:template name="param">
+  <xsl:param name="g" select="concat('default ', $g)"/>
+  <xsl:value-of select="$g"/>
+</xsl:template>
+
+</xsl:stylesheet>
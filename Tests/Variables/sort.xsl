@@ -0,0 +1,48 @@
+<?xml version="1.0"?>
+<!--
+  Globals referred to by sort keys, before and after a local with the
+  same name, and by an attribute set used where a local has the same
+  name.  The attribute set is outside the template, so it sees the
+  global.
+-->
+<xsl:stylesheet version="1.0" xmlns:xsl="http://www.w3.org/1999/XSL/Transform">
+
+<xsl:output method="xml" omit-xml-declaration="yes"/>
+
+<xsl:variable name="key" select="'n'"/>
+
+<xsl:variable name="prefix" select="'item-'"/>
+
+<xsl:attribute-set name="item">
+  <xsl:attribute name="id">
+    <xsl:value-of select="concat($prefix, @n)"/>
+  </xsl:attribute>
+</xsl:attribute-set>
+
+<xsl:template match="/">
+  <doc>
+    <xsl:for-each select="doc/item">
+      <xsl:sort select="@*[name() = $key]" data-type="number"/>
+      <xsl:value-of select="."/>
+    </xsl:for-each>
+    <xsl:text>,</xsl:text>
+    <xsl:variable name="key" select="'m'"/>
+    <xsl:for-each select="doc/item">
+      <xsl:sort select="@*[name() = $key]" data-type="number"/>
+      <xsl:value-of select="."/>
+    </xsl:for-each>
+    <xsl:text>,</xsl:text>
+    <xsl:apply-templates select="doc/item">
+      <xsl:sort select="@*[name() = $key]" data-type="number" order="descending"/>
+    </xsl:apply-templates>
+  </doc>
+</xsl:template>
+
+<xsl:template match="item">
+  <xsl:variable name="prefix" select="'local-'"/>
+  <r xsl:use-attribute-sets="item">
+    <xsl:value-of select="$prefix"/>
+  </r>
+</xsl:template>
+
+</xsl:stylesheet>
@@ -0,0 +1,60 @@
+<?xml version="1.0"?>
+<!--
+  Variables and params whose content is only text keep the text for
+  their string, number and boolean values.  Their nodes must still
+  have a parent and a root when they are reached through node-set(),
+  and copy-of must output the text.
+-->
+<xsl:stylesheet version="1.0"
+    xmlns:xsl="http://www.w3.org/1999/XSL/Transform"
+    xmlns:exsl="http://exslt.org/common"
+    exclude-result-prefixes="exsl">
+
+<xsl:output method="text"/>
+
+<xsl:template match="/">
+  <xsl:variable name="v">ab<xsl:value-of select="'cd'"/></xsl:variable>
+  <xsl:variable name="n"><xsl:value-of select="1 + 1"/></xsl:variable>
+  <xsl:value-of select="$v"/>
+  <xsl:text>,</xsl:text>
+  <xsl:value-of select="$n * 2"/>
+  <xsl:text>,</xsl:text>
+  <xsl:value-of select="boolean($v)"/>
+  <xsl:text>,</xsl:text>
+  <xsl:value-of select="$v = 'abcd'"/>
+  <xsl:text>,</xsl:text>
+  <xsl:value-of select="count(exsl:node-set($v)/node())"/>
+  <xsl:text>,</xsl:text>
+  <xsl:value-of select="exsl:node-set($v)/text()"/>
+  <xsl:text>,</xsl:text>
+  <xsl:value-of select="count(exsl:node-set($v)/text()/..)"/>
+  <xsl:text>,</xsl:text>
+  <xsl:value-of select="count(exsl:node-set($v)/text()/../text())"/>
+  <xsl:text>,</xsl:text>
+  <xsl:value-of select="count(exsl:node-set($v)/text()/ancestor::node())"/>
+  <xsl:text>,</xsl:text>
+  <xsl:value-of select="count(exsl:node-set($v)/text()/preceding::node())"/>
+  <xsl:text>,</xsl:text>
+  <xsl:for-each select="exsl:node-set($v)/text()">
+    <xsl:value-of select="count(/)"/>
+    <xsl:text>,</xsl:text>
+    <xsl:value-of select="string(/)"/>
+    <xsl:text>,</xsl:text>
+  </xsl:for-each>
+  <xsl:copy-of select="$v"/>
+  <xsl:text>,</xsl:text>
+  <xsl:copy-of select="$n"/>
+  <xsl:text>,</xsl:text>
+  <xsl:call-template name="parent">
+    <xsl:with-param name="p">ef</xsl:with-param>
+  </xsl:call-template>
+</xsl:template>
+
+<xsl:template name="parent">
+  <xsl:param name="p"/>
+  <xsl:value-of select="count(exsl:node-set($p)/text()/..)"/>
+  <xsl:text>,</xsl:text>
+  <xsl:copy-of select="$p"/>
+</xsl:template>
+
+</xsl:stylesheet>
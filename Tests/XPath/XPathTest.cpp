@@ -0,0 +1,812 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Base header file.  Must be first.
+#include <xalanc/Include/PlatformDefinitions.hpp>
+
+
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+
+
+#include <xercesc/util/PlatformUtils.hpp>
+
+
+
+#include <xalanc/XalanTransformer/XalanTransformer.hpp>
+
+
+
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::istringstream;
+using std::ostringstream;
+using std::string;
+
+using xalanc::MemoryManager;
+using xalanc::XalanCompiledStylesheet;
+using xalanc::XalanParsedSource;
+using xalanc::XalanTransformer;
+using xalanc::XSLTInputSource;
+using xalanc::XSLTResultTarget;
+
+
+
+namespace {
+
+
+
+// Text is split across nodes by elements and comments, with the
+// whitespace on either side of the splits.
+const char* const   theStringsSource =
+    "<doc>"
+    "<t from=\"aan\" to=\"xyz\">banana</t>"
+    "<long>abcdefghijklmnopqrstuvwxyzabcdefghijklmn</long>"
+    "<w>&#x4E00;a&#x100;&#xFF;</w>"
+    "<p>one<b>two </b> three<i>  four</i><!-- c -->five  <b/>six</p>"
+    "<q>  a<b> </b>b <!-- x --> c<b>d  </b></q>"
+    "<r> <b>  </b>\n x<b> </b></r>"
+    "<s> <b> </b> <!-- y --> </s>"
+    "</doc>";
+
+
+
+// The same strings and numbers, split across nodes in different
+// places, so a match or a mismatch spans a node boundary.
+const char* const   theCompareSource =
+    "<doc>"
+    "<a>ab<b>cd</b>ef</a>"
+    "<a>abc<!-- x -->def</a>"
+    "<a>abcdeg</a>"
+    "<c>aab<b>aab</b>ab</c>"
+    "<n>1<b>2</b>.5</n>"
+    "<n> 3<!-- y -->0 </n>"
+    "<n>x</n>"
+    "<m>  1 <b> </b></m>"
+    "<sp>a<b> </b>b</sp>"
+    "</doc>";
+
+
+
+// Elements, attributes and other nodes in and out of a namespace,
+// for the node tests of each axis.
+const char* const   theStepsSource =
+    "<doc xmlns:p=\"urn:p\">"
+    "<a id=\"1\"><b>x</b><p:b>y</p:b><!--c--><?pi one?><c><b>w</b></c></a>"
+    "<a id=\"2\" p:id=\"q\"><b>z</b>t</a>"
+    "</doc>";
+
+
+
+struct XPathCase
+{
+    const char*     m_name;
+
+    const char*     m_source;
+
+    // The top-level elements of the stylesheet, other than xsl:output.
+    const char*     m_stylesheet;
+
+    const char*     m_expected;
+};
+
+
+
+// Each translate() call with literal arguments is compiled with a
+// translation table, so each is paired with a call whose arguments
+// are not literals.
+const XPathCase     theCases[] =
+{
+    {
+        "translate() with duplicate characters",
+        theStringsSource,
+        "<xsl:template match=\"/\">"
+        "<xsl:value-of select=\"translate(doc/t, 'aan', 'xyz')\"/>|"
+        "<xsl:value-of select=\"translate(doc/t, doc/t/@from, doc/t/@to)\"/>"
+        "</xsl:template>",
+        "bxzxzx|bxzxzx"
+    },
+    {
+        "translate() with a longer from string",
+        theStringsSource,
+        "<xsl:template match=\"/\">"
+        "<xsl:value-of select=\"translate('--aaa--b', 'a-b', 'A')\"/>|"
+        "<xsl:value-of select=\"translate('--aaa--b', concat('a-', 'b'), 'A')\"/>|"
+        "<xsl:value-of select=\"translate('abc', 'abc', '')\"/>|"
+        "<xsl:value-of select=\"translate('', 'a', 'b')\"/>|"
+        "<xsl:value-of select=\"translate('abc', '', 'xyz')\"/>"
+        "</xsl:template>",
+        "AAA|AAA|||abc"
+    },
+    {
+        "translate() with characters above 0xFF",
+        theStringsSource,
+        "<xsl:template match=\"/\">"
+        "<xsl:value-of select=\"translate(doc/w, '&#x4E00;&#x100;&#xFF;', 'XYZ')\"/>|"
+        "<xsl:value-of select=\"translate(doc/w, string(doc/w), 'XYZ')\"/>|"
+        "<xsl:value-of select=\"translate('bcd', 'bcd', '&#x4E00;&#x100;&#xFF;') = translate(doc/w, 'a', '')\"/>|"
+        "<xsl:value-of select=\"translate('a&#x4E00;b', '&#x4E00;a', 'a&#x4E00;') = '&#x4E00;ab'\"/>"
+        "</xsl:template>",
+        "XaYZ|XYZ|true|true"
+    },
+    {
+        "translate() of a long string",
+        theStringsSource,
+        "<xsl:template match=\"/\">"
+        "<xsl:value-of select=\"translate(doc/long, 'abcdefghijklmnopqrstuvwxyzabcdefghijklmn', 'ABCDEFGHIJKLMNOPQRSTUVWXYZ')\"/>|"
+        "<xsl:value-of select=\"translate(doc/long, string(doc/long), 'ABCDEFGHIJKLMNOPQRSTUVWXYZ')\"/>|"
+        "<xsl:value-of select=\"translate(doc/long, string(doc/long), 'ABC')\"/>"
+        "</xsl:template>",
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJKLMN|"
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZABCDEFGHIJKLMN|"
+        "ABCABC"
+    },
+    {
+        "translate() as a boolean, a number and a variable",
+        theStringsSource,
+        "<xsl:template match=\"/\">"
+        "<xsl:variable name=\"v\" select=\"translate('abc', 'b', 'B')\"/>"
+        "<xsl:if test=\"translate('ab', 'ab', '')\">X</xsl:if>"
+        "<xsl:if test=\"translate('ab', 'a', '')\">Y</xsl:if>|"
+        "<xsl:value-of select=\"translate('1,5', ',', '.') + 1\"/>|"
+        "<xsl:value-of select=\"$v\"/>|"
+        "<xsl:value-of select=\"string-length(translate('a&#x4E00;b', '&#x4E00;', ''))\"/>|"
+        "<xsl:value-of select=\"concat(translate('ab', 'a', 'A'), translate('ab', 'b', 'B'))\"/>"
+        "</xsl:template>",
+        "Y|2.5|aBc|2|AbaB"
+    },
+    {
+        "normalize-space() of text split across nodes",
+        theStringsSource,
+        "<xsl:template match=\"/\">"
+        "<xsl:for-each select=\"doc/p | doc/q | doc/r | doc/s\">"
+        "[<xsl:value-of select=\"normalize-space()\"/>]"
+        "[<xsl:value-of select=\"concat(normalize-space(), '')\"/>]"
+        "[<xsl:value-of select=\"string-length(normalize-space())\"/>]"
+        "</xsl:for-each>|"
+        "<xsl:for-each select=\"doc/q/text()\">"
+        "[<xsl:value-of select=\"normalize-space()\"/>]"
+        "</xsl:for-each>|"
+        "<xsl:for-each select=\"doc/q\">"
+        "<xsl:if test=\"normalize-space() = 'a b cd'\">equal</xsl:if>"
+        "<xsl:if test=\"normalize-space() = normalize-space(.)\">-same</xsl:if>"
+        "</xsl:for-each>|"
+        "<xsl:for-each select=\"doc/s\">"
+        "<xsl:if test=\"not(normalize-space())\">empty</xsl:if>"
+        "</xsl:for-each>"
+        "</xsl:template>",
+        "[onetwo three fourfive six][onetwo three fourfive six][25]"
+        "[a b cd][a b cd][6]"
+        "[x][x][1]"
+        "[][][0]|"
+        "[a][b][c]|"
+        "equal-same|"
+        "empty"
+    },
+    {
+        "normalize-space() with whitespace stripped",
+        theStringsSource,
+        "<xsl:strip-space elements=\"*\"/>"
+        "<xsl:template match=\"/\">"
+        "<xsl:for-each select=\"doc/q | doc/r\">"
+        "[<xsl:value-of select=\"normalize-space()\"/>]"
+        "</xsl:for-each>"
+        "</xsl:template>",
+        "[ab cd][x]"
+    },
+    {
+        "= and != with text split across nodes",
+        theCompareSource,
+        "<xsl:template match=\"/\">"
+        "<xsl:value-of select=\"doc/a[1] = 'abcdef'\"/>,"
+        "<xsl:value-of select=\"doc/a[1] = 'abcdeg'\"/>,"
+        "<xsl:value-of select=\"doc/a[1] = 'abcdefg'\"/>,"
+        "<xsl:value-of select=\"doc/a[1] = 'abcde'\"/>,"
+        "<xsl:value-of select=\"doc/a[1] = 'abcxef'\"/>,"
+        "<xsl:value-of select=\"doc/a[1] != 'abcdef'\"/>,"
+        "<xsl:value-of select=\"doc/a != 'abcdef'\"/>,"
+        "<xsl:value-of select=\"doc/a[1] = doc/a[2]\"/>,"
+        "<xsl:value-of select=\"doc/a[1] = doc/a[3]\"/>,"
+        "<xsl:value-of select=\"doc/a[2] != doc/a[1]\"/>,"
+        "<xsl:value-of select=\"count(doc/a[. = 'abcdef'])\"/>,"
+        "<xsl:value-of select=\"'abcdef' = doc/a[2]\"/>,"
+        "<xsl:value-of select=\"doc/a[1] = ''\"/>,"
+        "<xsl:value-of select=\"doc/a[3] = doc/a\"/>"
+        "</xsl:template>",
+        "true,false,false,false,false,false,true,true,false,false,2,true,false,true"
+    },
+    {
+        "Relational operators with numbers split across nodes",
+        theCompareSource,
+        "<xsl:template match=\"/\">"
+        "<xsl:value-of select=\"doc/n[1] &gt; 12\"/>,"
+        "<xsl:value-of select=\"doc/n[1] &lt; 12.5\"/>,"
+        "<xsl:value-of select=\"doc/n[1] &lt;= 12.5\"/>,"
+        "<xsl:value-of select=\"doc/n[2] = 30\"/>,"
+        "<xsl:value-of select=\"doc/n[2] &gt;= '30'\"/>,"
+        "<xsl:value-of select=\"doc/n[3] &lt; 1\"/>,"
+        "<xsl:value-of select=\"doc/n[3] &gt;= 1\"/>,"
+        "<xsl:value-of select=\"doc/n &gt; doc/m\"/>,"
+        "<xsl:value-of select=\"doc/m &gt; doc/n\"/>,"
+        "<xsl:value-of select=\"doc/n[3] &lt; doc/n\"/>,"
+        "<xsl:value-of select=\"doc/n &lt; doc/n[3]\"/>,"
+        "<xsl:value-of select=\"doc/n[1] &lt; doc/n\"/>,"
+        "<xsl:value-of select=\"doc/n[2] &lt;= doc/n[1]\"/>,"
+        "<xsl:value-of select=\"12 &lt; doc/n[1]\"/>,"
+        "<xsl:value-of select=\"doc/n = 12.5\"/>,"
+        "<xsl:value-of select=\"doc/n != 12.5\"/>"
+        "</xsl:template>",
+        "true,false,true,true,true,false,false,true,false,false,false,true,false,true,true,true"
+    },
+    {
+        "contains(), starts-with() and string-length() of text split across nodes",
+        theCompareSource,
+        "<xsl:template match=\"/\">"
+        "<xsl:value-of select=\"contains(doc/a[1], 'bcd')\"/>,"
+        "<xsl:value-of select=\"contains(doc/a[1], 'bcde')\"/>,"
+        "<xsl:value-of select=\"contains(doc/a[1], 'abcdef')\"/>,"
+        "<xsl:value-of select=\"contains(doc/a[1], 'abcdefg')\"/>,"
+        "<xsl:value-of select=\"contains(doc/a[1], 'ce')\"/>,"
+        "<xsl:value-of select=\"contains(doc/a[1], '')\"/>,"
+        "<xsl:value-of select=\"contains(doc/a[2], 'cd')\"/>,"
+        "<xsl:value-of select=\"contains(doc/a[1], 'dea')\"/>,"
+        "<xsl:value-of select=\"contains(doc/c, 'aabab')\"/>,"
+        "<xsl:value-of select=\"contains(doc/c, 'abaa')\"/>,"
+        "<xsl:value-of select=\"contains(doc/c, 'bb')\"/>,"
+        "<xsl:value-of select=\"starts-with(doc/a[1], 'abc')\"/>,"
+        "<xsl:value-of select=\"starts-with(doc/a[1], 'abd')\"/>,"
+        "<xsl:value-of select=\"starts-with(doc/a[1], 'abcdefg')\"/>,"
+        "<xsl:value-of select=\"starts-with(doc/a[1], '')\"/>,"
+        "<xsl:value-of select=\"starts-with(doc/a[1], 'ab')\"/>,"
+        "<xsl:value-of select=\"starts-with(doc/a[1], 'abcdef')\"/>,"
+        "<xsl:value-of select=\"string-length(doc/a[1])\"/>,"
+        "<xsl:value-of select=\"string-length(doc/n[2])\"/>,"
+        "<xsl:value-of select=\"string-length(doc/sp)\"/>,"
+        "<xsl:value-of select=\"string-length(doc/nothing)\"/>,"
+        "<xsl:value-of select=\"contains(doc/nothing, '')\"/>,"
+        "<xsl:value-of select=\"starts-with(doc/a, 'abcdeg')\"/>,"
+        "<xsl:value-of select=\"doc/sp = 'a b'\"/>"
+        "</xsl:template>",
+        "true,true,true,false,false,true,true,false,true,true,false,"
+        "true,false,false,true,true,true,"
+        "6,4,3,0,true,false,true"
+    },
+    {
+        "Node data comparisons with whitespace stripped",
+        theCompareSource,
+        "<xsl:strip-space elements=\"*\"/>"
+        "<xsl:template match=\"/\">"
+        "<xsl:value-of select=\"doc/sp = 'ab'\"/>,"
+        "<xsl:value-of select=\"string-length(doc/sp)\"/>,"
+        "<xsl:value-of select=\"contains(doc/sp, 'ab')\"/>,"
+        "<xsl:value-of select=\"starts-with(doc/sp, 'ab')\"/>,"
+        "<xsl:value-of select=\"doc/m = '  1 '\"/>,"
+        "<xsl:value-of select=\"doc/m &lt; 2\"/>,"
+        "<xsl:value-of select=\"doc/sp != 'a b'\"/>"
+        "</xsl:template>",
+        "true,2,true,true,true,true,true"
+    },
+    {
+        "Node data comparisons with result tree fragments",
+        theCompareSource,
+        "<xsl:template match=\"/\">"
+        "<xsl:variable name=\"r\">ab<x>cd</x>ef</xsl:variable>"
+        "<xsl:variable name=\"t\">abcdef</xsl:variable>"
+        "<xsl:variable name=\"num\">1<x>2</x>.5</xsl:variable>"
+        "<xsl:value-of select=\"$r = doc/a[1]\"/>,"
+        "<xsl:value-of select=\"doc/a[1] = $r\"/>,"
+        "<xsl:value-of select=\"doc/a[3] = $r\"/>,"
+        "<xsl:value-of select=\"$r != doc/a[3]\"/>,"
+        "<xsl:value-of select=\"$t = doc/a[2]\"/>,"
+        "<xsl:value-of select=\"doc/a = $t\"/>,"
+        "<xsl:value-of select=\"doc/n[1] = $num\"/>,"
+        "<xsl:value-of select=\"$num &lt; doc/n\"/>,"
+        "<xsl:value-of select=\"doc/n &gt; $num\"/>,"
+        "<xsl:value-of select=\"doc/n[1] &gt;= $num\"/>,"
+        "<xsl:value-of select=\"doc/n[1] &gt; $num\"/>,"
+        "<xsl:value-of select=\"contains($r, 'bcd')\"/>,"
+        "<xsl:value-of select=\"starts-with($r, 'abc')\"/>,"
+        "<xsl:value-of select=\"string-length($r)\"/>,"
+        "<xsl:value-of select=\"$r = 'abcdef'\"/>,"
+        "<xsl:value-of select=\"$num = 12.5\"/>"
+        "</xsl:template>",
+        "true,true,false,true,true,true,true,true,true,true,false,true,true,6,true,true"
+    },
+    {
+        "Node tests of select expressions",
+        theStepsSource,
+        "<xsl:template match=\"/\" xmlns:q=\"urn:p\">"
+        "<xsl:value-of select=\"count(//b)\"/>,"
+        "<xsl:value-of select=\"count(//q:b)\"/>,"
+        "<xsl:value-of select=\"count(//q:*)\"/>,"
+        "<xsl:value-of select=\"count(//@q:*)\"/>,"
+        "<xsl:value-of select=\"count(//@*)\"/>,"
+        "<xsl:value-of select=\"count(//comment())\"/>,"
+        "<xsl:value-of select=\"count(//processing-instruction('pi'))\"/>,"
+        "<xsl:value-of select=\"count(//processing-instruction('other'))\"/>,"
+        "<xsl:value-of select=\"count(//text())\"/>,"
+        "<xsl:value-of select=\"count(doc/a[b = 'z']/preceding-sibling::a)\"/>,"
+        "<xsl:value-of select=\"count(doc/a/c/b/ancestor::*)\"/>,"
+        "<xsl:value-of select=\"count(doc/a/c/b/ancestor-or-self::a)\"/>,"
+        "<xsl:value-of select=\"count(doc/a[1]/b/following::b)\"/>,"
+        "<xsl:value-of select=\"count(doc/a[1]/c/preceding::node())\"/>,"
+        "<xsl:value-of select=\"count(doc/a[2]/b/following-sibling::text())\"/>,"
+        "<xsl:value-of select=\"count(doc/a[@id = 2]/@*)\"/>,"
+        "<xsl:value-of select=\"name(doc/a[@q:id]/@q:id)\"/>,"
+        "<xsl:value-of select=\"count(doc/a | doc/a/b | doc/a[1]/c)\"/>,"
+        "<xsl:value-of select=\"count(doc/a[count(b | q:b) = 2])\"/>,"
+        "<xsl:value-of select=\"count(doc/a/self::a)\"/>,"
+        "<xsl:value-of select=\"count(//b/parent::a)\"/>,"
+        "<xsl:value-of select=\"count(doc/descendant::b)\"/>,"
+        "<xsl:value-of select=\"string(doc/a[q:b]/@id)\"/>,"
+        "<xsl:value-of select=\"sum(doc/a/@id)\"/>|"
+        "<xsl:for-each select=\"doc/a\">"
+        "<xsl:if test=\"c/b\">[<xsl:value-of select=\"@id\"/>]</xsl:if>"
+        "</xsl:for-each>"
+        "</xsl:template>",
+        "3,1,1,1,3,1,1,0,5,1,3,1,2,6,1,2,p:id,5,1,2,2,3,1,3|[1]"
+    },
+    {
+        "Node tests of match patterns",
+        theStepsSource,
+        "<xsl:template match=\"/\">"
+        "<xsl:apply-templates select=\"//node() | //@*\"/>"
+        "</xsl:template>"
+        "<xsl:template match=\"/doc\">D,</xsl:template>"
+        "<xsl:template match=\"*\">E,</xsl:template>"
+        "<xsl:template match=\"@*\">A,</xsl:template>"
+        "<xsl:template match=\"text()\"/>"
+        "<xsl:template match=\"a\">[a<xsl:value-of select=\"@id\"/>],</xsl:template>"
+        "<xsl:template match=\"b\">b,</xsl:template>"
+        "<xsl:template match=\"a[2]/b\">B2,</xsl:template>"
+        "<xsl:template match=\"c//b\">cb,</xsl:template>"
+        "<xsl:template match=\"q:b\" xmlns:q=\"urn:p\">qb,</xsl:template>"
+        "<xsl:template match=\"@q:*\" xmlns:q=\"urn:p\">qa,</xsl:template>"
+        "<xsl:template match=\"comment()\">C,</xsl:template>"
+        "<xsl:template match=\"processing-instruction('pi')\">P,</xsl:template>"
+        "<xsl:template match=\"processing-instruction() | c\">X,</xsl:template>"
+        "<xsl:template match=\"a/text()\">T,</xsl:template>",
+        "D,[a1],A,b,qb,C,P,X,cb,[a2],A,qa,B2,T,"
+    }
+};
+
+
+
+string
+makeStylesheet(const char*  theContent)
+{
+    return string(
+        "<xsl:stylesheet version=\"1.0\" xmlns:xsl=\"http://www.w3.org/1999/XSL/Transform\">"
+        "<xsl:output method=\"text\"/>") +
+        theContent +
+        "</xsl:stylesheet>";
+}
+
+
+
+bool
+runCase(
+            const XPathCase&    theCase,
+            XalanTransformer&   theTransformer,
+            MemoryManager&      theManager)
+{
+    istringstream   theSourceStream(theCase.m_source);
+    istringstream   theStylesheetStream(makeStylesheet(theCase.m_stylesheet));
+
+    const XalanParsedSource*        theSource = 0;
+    const XalanCompiledStylesheet*  theStylesheet = 0;
+
+    ostringstream   theOutput;
+
+    if (theTransformer.parseSource(
+            XSLTInputSource(&theSourceStream, theManager),
+            theSource) != 0 ||
+        theTransformer.compileStylesheet(
+            XSLTInputSource(&theStylesheetStream, theManager),
+            theStylesheet) != 0 ||
+        theTransformer.transform(
+            *theSource,
+            theStylesheet,
+            XSLTResultTarget(theOutput, theManager)) != 0)
+    {
+        cerr << theCase.m_name
+             << ": failed: "
+             << theTransformer.getLastError()
+             << endl;
+
+        return false;
+    }
+    else if (theOutput.str() != theCase.m_expected)
+    {
+        cerr << theCase.m_name
+             << ": expected \""
+             << theCase.m_expected
+             << "\", got \""
+             << theOutput.str()
+             << "\"."
+             << endl;
+
+        return false;
+    }
+    else
+    {
+        cout << theCase.m_name << ": passed." << endl;
+
+        return true;
+    }
+}
+
+
+
+// The number values of attributes, text nodes, and elements with a
+// single text child are cached, and the rest are not.  One of the
+// values is the number which once marked an uncached entry.
+const char* const   theNodeNumbersSource =
+    "<doc>"
+    "<n v=\"123456789\">123456789</n>"
+    "<n v=\"NaN\">NaN</n>"
+    "<n v=\"-0\">-0</n>"
+    "<n v=\" 12 \"> 12 </n>"
+    "<n v=\"\"/>"
+    "<n v=\"1.5\">1<b/>.5</n>"
+    "<n v=\"7\"><![CDATA[7]]></n>"
+    "</doc>";
+
+
+
+const char* const   theNodeNumbersStylesheet =
+    "<xsl:template match=\"/\">"
+    "<xsl:for-each select=\"doc/n\">"
+    "<xsl:value-of select=\"concat(@v &gt; 10, ',', @v = 123456789, ',', @v = 0, ',', @v &gt;= ., ';')\"/>"
+    "</xsl:for-each>"
+    "<xsl:value-of select=\"concat(count(doc/n[. &gt; 10]), ',', count(doc/n/@v[. = 0]))\"/>"
+    "</xsl:template>";
+
+
+
+const char* const   theNodeNumbersExpected =
+    "true,true,false,true;"
+    "false,false,false,false;"
+    "false,false,true,true;"
+    "true,false,false,true;"
+    "false,false,false,false;"
+    "false,false,false,true;"
+    "false,false,false,true;"
+    "2,1";
+
+
+
+// Parses the source and compiles the stylesheet once, then transforms
+// the source twice, so the second transformation reads the values the
+// first one cached.
+bool
+transformTwice(
+            XalanTransformer&   theTransformer,
+            MemoryManager&      theManager,
+            string&             theFirstOutput,
+            string&             theSecondOutput)
+{
+    istringstream   theSourceStream(theNodeNumbersSource);
+    istringstream   theStylesheetStream(makeStylesheet(theNodeNumbersStylesheet));
+
+    const XalanParsedSource*        theSource = 0;
+    const XalanCompiledStylesheet*  theStylesheet = 0;
+
+    ostringstream   theFirstStream;
+    ostringstream   theSecondStream;
+
+    if (theTransformer.parseSource(
+            XSLTInputSource(&theSourceStream, theManager),
+            theSource) != 0 ||
+        theTransformer.compileStylesheet(
+            XSLTInputSource(&theStylesheetStream, theManager),
+            theStylesheet) != 0 ||
+        theTransformer.transform(
+            *theSource,
+            theStylesheet,
+            XSLTResultTarget(theFirstStream, theManager)) != 0 ||
+        theTransformer.transform(
+            *theSource,
+            theStylesheet,
+            XSLTResultTarget(theSecondStream, theManager)) != 0)
+    {
+        cerr << "Node number cache: failed: "
+             << theTransformer.getLastError()
+             << endl;
+
+        return false;
+    }
+    else
+    {
+        theFirstOutput = theFirstStream.str();
+        theSecondOutput = theSecondStream.str();
+
+        return true;
+    }
+}
+
+
+
+bool
+runNodeNumberCase(MemoryManager&    theManager)
+{
+    XalanTransformer    theTransformer(theManager);
+    XalanTransformer    theCachingTransformer(theManager);
+
+    if (theTransformer.getCacheNodeNumbers() == true)
+    {
+        cerr << "Node number cache: on by default." << endl;
+
+        return false;
+    }
+
+    theCachingTransformer.setCacheNodeNumbers(true);
+
+    string  theOutputs[4];
+
+    if (transformTwice(theTransformer, theManager, theOutputs[0], theOutputs[1]) == false ||
+        transformTwice(theCachingTransformer, theManager, theOutputs[2], theOutputs[3]) == false)
+    {
+        return false;
+    }
+
+    const char* const   theNames[] =
+    {
+        "uncached",
+        "uncached again",
+        "cached on first use",
+        "cached"
+    };
+
+    bool    fResult = true;
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        if (theOutputs[i] != theNodeNumbersExpected)
+        {
+            cerr << "Node number cache, "
+                 << theNames[i]
+                 << ": expected \""
+                 << theNodeNumbersExpected
+                 << "\", got \""
+                 << theOutputs[i]
+                 << "\"."
+                 << endl;
+
+            fResult = false;
+        }
+    }
+
+    if (fResult == true)
+    {
+        cout << "Node number cache: passed." << endl;
+    }
+
+    return fResult;
+}
+
+
+
+}
+
+
+
+// Key indexes built for a parsed source are shared between stylesheets
+// which declare the same key.  These keys have the same text, but the
+// prefix is bound to a different namespace in the second stylesheet,
+// so it must not use the index the first one built.  The others differ
+// from the first only in whitespace, quotes and the prefix, so their
+// results are the same.
+const char* const   theKeysSource =
+    "<doc xmlns:a=\"urn:a\" xmlns:b=\"urn:b\">"
+    "<a:i id=\"1\">A1</a:i>"
+    "<b:i id=\"1\">B1</b:i>"
+    "<a:i id=\"2\">A2</a:i>"
+    "</doc>";
+
+
+
+struct KeysCase
+{
+    const char*     m_namespaces;
+
+    const char*     m_key;
+
+    const char*     m_expected;
+};
+
+
+
+const KeysCase  theKeysCases[] =
+{
+    {
+        "xmlns:p=\"urn:a\"",
+        "<xsl:key name=\"k\" match=\"p:i\" use=\"concat(@id, '')\"/>",
+        "A1,1"
+    },
+    {
+        "xmlns:p=\"urn:b\"",
+        "<xsl:key name=\"k\" match=\"p:i\" use=\"concat(@id, '')\"/>",
+        "B1,0"
+    },
+    {
+        "xmlns:p=\"urn:a\"",
+        "<xsl:key name=\"k\" match=\" p:i \" use='concat( @id , \"\" )'/>",
+        "A1,1"
+    },
+    {
+        "xmlns:q=\"urn:a\"",
+        "<xsl:key name=\"k\" match=\"q:i\" use=\"concat(@id, '')\"/>",
+        "A1,1"
+    }
+};
+
+
+
+bool
+runKeysCase(MemoryManager&  theManager)
+{
+    XalanTransformer    theTransformer(theManager);
+
+    istringstream   theSourceStream(theKeysSource);
+
+    const XalanParsedSource*    theSource = 0;
+
+    if (theTransformer.parseSource(
+            XSLTInputSource(&theSourceStream, theManager),
+            theSource) != 0)
+    {
+        cerr << "Shared key indexes: failed: "
+             << theTransformer.getLastError()
+             << endl;
+
+        return false;
+    }
+
+    bool    fResult = true;
+
+    for (size_t i = 0; i < sizeof(theKeysCases) / sizeof(theKeysCases[0]); ++i)
+    {
+        const KeysCase&     theCase = theKeysCases[i];
+
+        istringstream   theStylesheetStream(
+            string(
+                "<xsl:stylesheet version=\"1.0\" xmlns:xsl=\"http://www.w3.org/1999/XSL/Transform\" ") +
+                theCase.m_namespaces +
+                ">"
+                "<xsl:output method=\"text\"/>" +
+                theCase.m_key +
+                "<xsl:template match=\"/\">"
+                "<xsl:value-of select=\"concat(key('k', '1'), ',', count(key('k', '2')))\"/>"
+                "</xsl:template>"
+                "</xsl:stylesheet>");
+
+        const XalanCompiledStylesheet*  theStylesheet = 0;
+
+        ostringstream   theOutput;
+
+        if (theTransformer.compileStylesheet(
+                XSLTInputSource(&theStylesheetStream, theManager),
+                theStylesheet) != 0 ||
+            theTransformer.transform(
+                *theSource,
+                theStylesheet,
+                XSLTResultTarget(theOutput, theManager)) != 0)
+        {
+            cerr << "Shared key indexes, stylesheet "
+                 << i + 1
+                 << ": failed: "
+                 << theTransformer.getLastError()
+                 << endl;
+
+            fResult = false;
+        }
+        else if (theOutput.str() != theCase.m_expected)
+        {
+            cerr << "Shared key indexes, stylesheet "
+                 << i + 1
+                 << ": expected \""
+                 << theCase.m_expected
+                 << "\", got \""
+                 << theOutput.str()
+                 << "\"."
+                 << endl;
+
+            fResult = false;
+        }
+    }
+
+    if (fResult == true)
+    {
+        cout << "Shared key indexes: passed." << endl;
+    }
+
+    return fResult;
+}
+
+
+
+}
+
+
+
+int
+main(
+            int     argc,
+            char*   /* argv */[])
+{
+    if (argc != 1)
+    {
+        cerr << "Usage: XPathTest" << endl;
+
+        return 1;
+    }
+
+    int     theFailures = 0;
+
+    try
+    {
+        using xercesc::XMLPlatformUtils;
+
+        XMLPlatformUtils::Initialize();
+
+        XalanTransformer::initialize();
+
+        {
+            MemoryManager&  theManager = xalanc::XalanMemMgrs::getDefaultXercesMemMgr();
+
+            XalanTransformer    theTransformer(theManager);
+
+            for (size_t i = 0; i < sizeof(theCases) / sizeof(theCases[0]); ++i)
+            {
+                if (runCase(theCases[i], theTransformer, theManager) == false)
+                {
+                    ++theFailures;
+                }
+            }
+
+            if (runNodeNumberCase(theManager) == false)
+            {
+                ++theFailures;
+            }
+
+            if (runKeysCase(theManager) == false)
+            {
+                ++theFailures;
+            }
+        }
+
+        XalanTransformer::terminate();
+
+        XMLPlatformUtils::Terminate();
+
+        XalanTransformer::ICUCleanUp();
+    }
+    catch(...)
+    {
+        cerr << "Initialization failed!" << endl;
+
+        return 1;
+    }
+
+    return theFailures == 0 ? 0 : 1;
+}
@@ -40,6 +40,7 @@
 
 
 #include "DOMSupportException.hpp"
+#include "XalanNodeDataIterator.hpp"
 
 
 
@@ -851,6 +852,229 @@ DOMServices::doGetNodeData(
 
 
 
+bool
+DOMServices::nodeDataEquals(
+            const XalanNode&        node,
+            ExecutionContext&       context,
+            const XalanDOMString&   theString)
+{
+    XalanNodeDataIterator   theIterator(node, context);
+
+    const XalanDOMChar* const           theChars = theString.c_str();
+    const XalanDOMString::size_type     theLength = theString.length();
+
+    XalanDOMString::size_type   thePosition = 0;
+
+    for (const XalanDOMString* theData = theIterator.next();
+            theData != 0;
+                theData = theIterator.next())
+    {
+        const XalanDOMString::size_type     theDataLength = theData->length();
+
+        // Stop as soon as the data is longer than the string, or
+        // a character differs.
+        if (theDataLength > theLength - thePosition ||
+            equals(theData->c_str(), theChars + thePosition, theDataLength) == false)
+        {
+            return false;
+        }
+
+        thePosition += theDataLength;
+    }
+
+    return thePosition == theLength;
+}
+
+
+
+bool
+DOMServices::nodeDataEquals(
+            const XalanNode&    node1,
+            const XalanNode&    node2,
+            ExecutionContext&   context)
+{
+    XalanNodeDataIterator   theIterator1(node1, context);
+    XalanNodeDataIterator   theIterator2(node2, context);
+
+    const XalanDOMString*   theData1 = theIterator1.next();
+    const XalanDOMString*   theData2 = theIterator2.next();
+
+    XalanDOMString::size_type   thePosition1 = 0;
+    XalanDOMString::size_type   thePosition2 = 0;
+
+    // The pieces of data from the nodes need not line up, so compare
+    // as much as is available from both, then move on in one or both.
+    while (theData1 != 0 && theData2 != 0)
+    {
+        const XalanDOMString::size_type     theRemaining1 =
+            theData1->length() - thePosition1;
+
+        const XalanDOMString::size_type     theRemaining2 =
+            theData2->length() - thePosition2;
+
+        const XalanDOMString::size_type     theCount =
+            theRemaining1 < theRemaining2 ? theRemaining1 : theRemaining2;
+
+        if (equals(
+                theData1->c_str() + thePosition1,
+                theData2->c_str() + thePosition2,
+                theCount) == false)
+        {
+            return false;
+        }
+
+        if (theCount == theRemaining1)
+        {
+            theData1 = theIterator1.next();
+            thePosition1 = 0;
+        }
+        else
+        {
+            thePosition1 += theCount;
+        }
+
+        if (theCount == theRemaining2)
+        {
+            theData2 = theIterator2.next();
+            thePosition2 = 0;
+        }
+        else
+        {
+            thePosition2 += theCount;
+        }
+    }
+
+    return theData1 == 0 && theData2 == 0;
+}
+
+
+
+bool
+DOMServices::nodeDataStartsWith(
+            const XalanNode&        node,
+            ExecutionContext&       context,
+            const XalanDOMString&   theString)
+{
+    XalanNodeDataIterator   theIterator(node, context);
+
+    const XalanDOMChar* const           theChars = theString.c_str();
+    const XalanDOMString::size_type     theLength = theString.length();
+
+    XalanDOMString::size_type   thePosition = 0;
+
+    for (const XalanDOMString* theData = theIterator.next();
+            theData != 0 && thePosition < theLength;
+                theData = theIterator.next())
+    {
+        const XalanDOMString::size_type     theRemaining = theLength - thePosition;
+
+        const XalanDOMString::size_type     theCount =
+            theData->length() < theRemaining ? theData->length() : theRemaining;
+
+        if (equals(theData->c_str(), theChars + thePosition, theCount) == false)
+        {
+            return false;
+        }
+
+        thePosition += theCount;
+    }
+
+    return thePosition == theLength;
+}
+
+
+
+bool
+DOMServices::nodeDataContains(
+            const XalanNode&        node,
+            ExecutionContext&       context,
+            const XalanDOMString&   theString)
+{
+    const XalanDOMString::size_type     theLength = theString.length();
+
+    if (theLength == 0)
+    {
+        return true;
+    }
+
+    XalanNodeDataIterator   theIterator(node, context);
+
+    // A match may span pieces of data, so this holds the last
+    // theLength - 1 characters seen.
+    const XalanDOMString::size_type     theOverlapLength = theLength - 1;
+
+    XalanDOMString  theOverlap(context.getMemoryManager());
+
+    for (const XalanDOMString* theData = theIterator.next();
+            theData != 0;
+                theData = theIterator.next())
+    {
+        const XalanDOMChar* const           theChars = theData->c_str();
+        const XalanDOMString::size_type     theDataLength = theData->length();
+
+        if (theOverlap.empty() == false)
+        {
+            // Look for a match that starts in the previous data...
+            theOverlap.append(
+                theChars,
+                theDataLength < theOverlapLength ? theDataLength : theOverlapLength);
+
+            if (indexOf(theOverlap, theString) < theOverlap.length())
+            {
+                return true;
+            }
+        }
+
+        if (indexOf(theChars, theDataLength, theString.c_str(), theLength) < theDataLength)
+        {
+            return true;
+        }
+
+        if (theDataLength >= theOverlapLength)
+        {
+            theOverlap.assign(theChars + theDataLength - theOverlapLength, theOverlapLength);
+        }
+        else
+        {
+            if (theOverlap.empty() == true)
+            {
+                theOverlap.assign(theChars, theDataLength);
+            }
+
+            // All of the data was appended, so keep only the end.
+            if (theOverlap.length() > theOverlapLength)
+            {
+                theOverlap.erase(0, theOverlap.length() - theOverlapLength);
+            }
+        }
+    }
+
+    return false;
+}
+
+
+
+XalanDOMString::size_type
+DOMServices::getNodeDataLength(
+            const XalanNode&    node,
+            ExecutionContext&   context)
+{
+    XalanNodeDataIterator   theIterator(node, context);
+
+    XalanDOMString::size_type   theLength = 0;
+
+    for (const XalanDOMString* theData = theIterator.next();
+            theData != 0;
+                theData = theIterator.next())
+    {
+        theLength += theData->length();
+    }
+
+    return theLength;
+}
+
+
+
 const XalanDOMString&
 DOMServices::getNameOfNode(const XalanNode&     n)
 {
@@ -554,6 +554,79 @@ public:
         }
     }
 
+    /**
+     * Determine if the data for a node is equal to a string, without
+     * retrieving the data into a string.
+     * 
+     * @param node DOM node whose data is compared
+     * @param context The current execution context
+     * @param theString The string to compare
+     * @return true if the data is equal to the string
+     */
+    static bool
+    nodeDataEquals(
+            const XalanNode&        node,
+            ExecutionContext&       context,
+            const XalanDOMString&   theString);
+
+    /**
+     * Determine if the data for two nodes is equal, without retrieving
+     * the data into strings.
+     * 
+     * @param node1 The first DOM node
+     * @param node2 The second DOM node
+     * @param context The current execution context
+     * @return true if the data is equal
+     */
+    static bool
+    nodeDataEquals(
+            const XalanNode&    node1,
+            const XalanNode&    node2,
+            ExecutionContext&   context);
+
+    /**
+     * Determine if the data for a node starts with a string, without
+     * retrieving the data into a string.
+     * 
+     * @param node DOM node whose data is examined
+     * @param context The current execution context
+     * @param theString The prefix to look for
+     * @return true if the data starts with the string
+     */
+    static bool
+    nodeDataStartsWith(
+            const XalanNode&        node,
+            ExecutionContext&       context,
+            const XalanDOMString&   theString);
+
+    /**
+     * Determine if the data for a node contains a string, without
+     * retrieving the data into a string.
+     * 
+     * @param node DOM node whose data is searched
+     * @param context The current execution context
+     * @param theString The string to search for
+     * @return true if the data contains the string
+     */
+    static bool
+    nodeDataContains(
+            const XalanNode&        node,
+            ExecutionContext&       context,
+            const XalanDOMString&   theString);
+
+    /**
+     * Get the length of the data for a node, without retrieving
+     * the data into a string.
+     * 
+     * @param node DOM node whose data is measured
+     * @param context The current execution context
+     * @return the length of the data
+     */
+    static XalanDOMString::size_type
+    getNodeDataLength(
+            const XalanNode&    node,
+            ExecutionContext&   context);
+
     /**
      * Retrieve the name of the node, taking into
      * account the differences between the DOM and
@@ -35,4 +35,14 @@ DOMSupport::~DOMSupport()
 
 
 
+bool
+DOMSupport::getNodeNumber(
+            const XalanNode&    /* theNode */,
+            double&             /* theNumber */) const
+{
+    return false;
+}
+
+
+
 }
@@ -78,6 +78,20 @@ public:
     isNodeAfter(
             const XalanNode&    node1,
             const XalanNode&    node2) const = 0;
+
+    /**
+     * Get the number value of a node, if the implementation can supply
+     * it without converting the node's string-value.  The default
+     * implementation always returns false.
+     *
+     * @param theNode The node
+     * @param theNumber The number value of the node, if available
+     * @return true if theNumber was set, or false if it was not.
+     */
+    virtual bool
+    getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const;
 };
 
 
@@ -0,0 +1,160 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "XalanNodeDataIterator.hpp"
+
+
+
+#include <xalanc/XalanDOM/XalanAttr.hpp>
+#include <xalanc/XalanDOM/XalanComment.hpp>
+#include <xalanc/XalanDOM/XalanProcessingInstruction.hpp>
+#include <xalanc/XalanDOM/XalanText.hpp>
+
+
+
+#include <xalanc/PlatformSupport/ExecutionContext.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanNodeDataIterator::XalanNodeDataIterator(
+            const XalanNode&    theNode,
+            ExecutionContext&   theContext) :
+    m_root(theNode),
+    m_stripContext(theContext.hasPreserveOrStripSpaceConditions() == true ? &theContext : 0),
+    m_current(0),
+    m_data(0)
+{
+    switch(theNode.getNodeType())
+    {
+    case XalanNode::DOCUMENT_FRAGMENT_NODE:
+    case XalanNode::DOCUMENT_NODE:
+    case XalanNode::ELEMENT_NODE:
+        m_current = theNode.getFirstChild();
+        break;
+
+    case XalanNode::TEXT_NODE:
+    case XalanNode::CDATA_SECTION_NODE:
+        // The node itself is the only text node to visit.
+        m_current = &theNode;
+        break;
+
+    case XalanNode::ATTRIBUTE_NODE:
+        m_data = &static_cast<const XalanAttr&>(theNode).getValue();
+        break;
+
+    case XalanNode::COMMENT_NODE:
+        m_data = &static_cast<const XalanComment&>(theNode).getData();
+        break;
+
+    case XalanNode::PROCESSING_INSTRUCTION_NODE:
+        m_data = &static_cast<const XalanProcessingInstruction&>(theNode).getData();
+        break;
+
+    default:
+        // ignore
+        break;
+    }
+
+    if (m_data != 0 && m_data->empty() == true)
+    {
+        m_data = 0;
+    }
+}
+
+
+
+const XalanDOMString*
+XalanNodeDataIterator::next()
+{
+    if (m_data != 0)
+    {
+        const XalanDOMString* const     theData = m_data;
+
+        m_data = 0;
+
+        return theData;
+    }
+
+    while (m_current != 0)
+    {
+        const XalanNode* const  theNode = m_current;
+
+        m_current = nextNode(theNode);
+
+        const XalanNode::NodeType   theType = theNode->getNodeType();
+
+        if (theType == XalanNode::TEXT_NODE ||
+            theType == XalanNode::CDATA_SECTION_NODE)
+        {
+            const XalanText&    theText =
+                static_cast<const XalanText&>(*theNode);
+
+            const XalanDOMString&   theData = theText.getData();
+
+            if (theData.empty() == false &&
+                (m_stripContext == 0 ||
+                 m_stripContext->shouldStripSourceNode(theText) == false))
+            {
+                return &theData;
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+
+const XalanNode*
+XalanNodeDataIterator::nextNode(const XalanNode*    theNode) const
+{
+    if (theNode == &m_root)
+    {
+        return 0;
+    }
+    else if (theNode->getNodeType() == XalanNode::ELEMENT_NODE)
+    {
+        const XalanNode* const  theFirstChild = theNode->getFirstChild();
+
+        if (theFirstChild != 0)
+        {
+            return theFirstChild;
+        }
+    }
+
+    // Find the next sibling of the node, or of the nearest ancestor
+    // that has one, without leaving the root.
+    while (theNode->getNextSibling() == 0)
+    {
+        theNode = theNode->getParentNode();
+
+        if (theNode == &m_root || theNode == 0)
+        {
+            return 0;
+        }
+    }
+
+    return theNode->getNextSibling();
+}
+
+
+
+}
@@ -0,0 +1,97 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANNODEDATAITERATOR_HEADER_GUARD_1357924680)
+#define XALANNODEDATAITERATOR_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/DOMSupport/DOMSupportDefinitions.hpp>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+class ExecutionContext;
+class XalanNode;
+
+
+
+/**
+ * Iterates over the data of a node, as DOMServices::getNodeData()
+ * would produce it, without concatenating it.  Each step yields
+ * the data of one text node, or the entire data of a node that is
+ * not a container, such as an attribute or a comment.  Empty data
+ * is never yielded.
+ */
+class XALAN_DOMSUPPORT_EXPORT XalanNodeDataIterator
+{
+public:
+
+    /**
+     * Construct an iterator.  Text nodes are skipped if the
+     * execution context says they should be stripped.
+     *
+     * @param theNode The node whose data is iterated
+     * @param theContext The current execution context
+     */
+    XalanNodeDataIterator(
+            const XalanNode&    theNode,
+            ExecutionContext&   theContext);
+
+    /**
+     * Get the next piece of data.
+     *
+     * @return a pointer to the data, or 0 if there is none left
+     */
+    const XalanDOMString*
+    next();
+
+private:
+
+    // Not implemented...
+    XalanNodeDataIterator(const XalanNodeDataIterator&);
+
+    XalanNodeDataIterator&
+    operator=(const XalanNodeDataIterator&);
+
+    const XalanNode*
+    nextNode(const XalanNode*   theNode) const;
+
+    const XalanNode&        m_root;
+
+    ExecutionContext* const m_stripContext;
+
+    const XalanNode*        m_current;
+
+    const XalanDOMString*   m_data;
+};
+
+
+
+}
+
+
+
+#endif  // XALANNODEDATAITERATOR_HEADER_GUARD_1357924680
@@ -0,0 +1,659 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#if !defined(XALANSMALLVECTOR_HEADER_GUARD_1357924680)
+#define XALANSMALLVECTOR_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/Include/PlatformDefinitions.hpp>
+
+
+
+#include <cstddef>
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <iterator>
+#include <stdexcept>
+
+
+
+#include <xalanc/Include/XalanMemoryManagement.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+using xercesc::MemoryManager;
+
+
+
+/**
+ * A vector that stores up to InlineCount elements in the object itself,
+ * and only allocates memory from the memory manager when it grows beyond
+ * that.  Elements are copied by assignment and are never constructed or
+ * destroyed, so Type must be a simple type, such as a character type.
+ */
+template <class Type, size_t InlineCount>
+class XalanSmallVector
+{
+public:
+
+    typedef Type                value_type;
+    typedef value_type*         pointer;
+    typedef const value_type*   const_pointer;
+    typedef value_type&         reference;
+    typedef const value_type&   const_reference;
+    typedef size_t              size_type;
+    typedef ptrdiff_t           difference_type;
+
+    typedef value_type*             iterator;
+    typedef const value_type*       const_iterator;
+
+    typedef std::reverse_iterator<iterator>          reverse_iterator;
+    typedef std::reverse_iterator<const_iterator>    const_reverse_iterator;
+
+    typedef XalanSmallVector<Type, InlineCount>     ThisType;
+
+    explicit
+    XalanSmallVector(MemoryManager&     theManager) :
+        m_memoryManager(&theManager),
+        m_size(0),
+        m_allocation(InlineCount),
+        m_data(m_buffer)
+    {
+        invariants();
+    }
+
+    ~XalanSmallVector()
+    {
+        invariants();
+
+        if (isInline() == false)
+        {
+            deallocate(m_data);
+        }
+    }
+
+    void
+    push_back(const value_type&     data)
+    {
+        invariants();
+
+        if (m_size == m_allocation)
+        {
+            // The data might be in the buffer we're about to free.
+            const value_type    theValue(data);
+
+            reallocate(m_size + 1);
+
+            m_data[m_size++] = theValue;
+        }
+        else
+        {
+            m_data[m_size++] = data;
+        }
+
+        invariants();
+    }
+
+    void
+    pop_back()
+    {
+        assert(m_size > 0);
+
+        --m_size;
+    }
+
+    iterator
+    erase(
+            iterator    theFirst,
+            iterator    theLast)
+    {
+        invariants();
+
+        assert(theFirst <= theLast);
+
+        if (theFirst != theLast)
+        {
+            std::copy(
+                theLast,
+                end(),
+                theFirst);
+
+            m_size -= size_type(theLast - theFirst);
+        }
+
+        invariants();
+
+        return theFirst;
+    }
+
+    iterator
+    erase(iterator  position)
+    {
+        return erase(position, position + 1);
+    }
+
+    void
+    insert(
+            iterator        thePosition,
+            const_iterator  theFirst,
+            const_iterator  theLast)
+    {
+        invariants();
+
+        assert(theFirst <= theLast);
+        assert(thePosition >= begin() && thePosition <= end());
+
+        const size_type     theCount = size_type(theLast - theFirst);
+
+        if (theCount == 0)
+        {
+            return;
+        }
+        else if (contains(theFirst) == true)
+        {
+            // Inserting part of ourselves, so make a copy first.
+            ThisType    theTemp(*m_memoryManager);
+
+            theTemp.insert(theTemp.end(), theFirst, theLast);
+
+            insert(thePosition, theTemp.begin(), theTemp.end());
+        }
+        else
+        {
+            thePosition = makeSpace(thePosition, theCount);
+
+            std::copy(theFirst, theLast, thePosition);
+        }
+
+        invariants();
+    }
+
+    void
+    insert(
+            iterator            thePosition,
+            size_type           theCount,
+            const value_type&   theData)
+    {
+        invariants();
+
+        assert(thePosition >= begin() && thePosition <= end());
+
+        if (theCount > 0)
+        {
+            const value_type    theValue(theData);
+
+            thePosition = makeSpace(thePosition, theCount);
+
+            std::fill(thePosition, thePosition + theCount, theValue);
+        }
+
+        invariants();
+    }
+
+    iterator
+    insert(
+            iterator            thePosition,
+            const value_type&   theData)
+    {
+        const size_type     theOffset = size_type(thePosition - begin());
+
+        insert(thePosition, 1, theData);
+
+        return begin() + theOffset;
+    }
+
+    void
+    assign(
+            const_iterator  theFirst,
+            const_iterator  theLast)
+    {
+        invariants();
+
+        if (contains(theFirst) == true)
+        {
+            ThisType    theTemp(*m_memoryManager);
+
+            theTemp.insert(theTemp.end(), theFirst, theLast);
+
+            assign(theTemp.begin(), theTemp.end());
+        }
+        else
+        {
+            clear();
+
+            insert(end(), theFirst, theLast);
+        }
+
+        invariants();
+    }
+
+    size_type
+    size() const
+    {
+        invariants();
+
+        return m_size;
+    }
+
+    size_type
+    max_size() const
+    {
+        invariants();
+
+        return ~size_type(0) / sizeof(value_type);
+    }
+
+    void
+    resize(
+            size_type           theSize,
+            const value_type&   theValue)
+    {
+        invariants();
+
+        if (m_size > theSize)
+        {
+            m_size = theSize;
+        }
+        else if (m_size < theSize)
+        {
+            insert(end(), theSize - m_size, theValue);
+        }
+
+        invariants();
+    }
+
+    void
+    resize(size_type    theSize)
+    {
+        resize(theSize, value_type());
+    }
+
+    size_type
+    capacity() const
+    {
+        invariants();
+
+        return m_allocation;
+    }
+
+    bool
+    empty() const
+    {
+        invariants();
+
+        return m_size == 0 ? true : false;
+    }
+
+    void
+    reserve(size_type   theSize)
+    {
+        invariants();
+
+        if (theSize > m_allocation)
+        {
+            reallocate(theSize);
+        }
+
+        invariants();
+    }
+
+    reference
+    front()
+    {
+        assert(m_size > 0);
+
+        return m_data[0];
+    }
+
+    const_reference
+    front() const
+    {
+        assert(m_size > 0);
+
+        return m_data[0];
+    }
+
+    reference
+    back()
+    {
+        assert(m_size > 0);
+
+        return m_data[m_size - 1];
+    }
+
+    const_reference
+    back() const
+    {
+        assert(m_size > 0);
+
+        return m_data[m_size - 1];
+    }
+
+    iterator
+    begin()
+    {
+        invariants();
+
+        return m_data;
+    }
+
+    const_iterator
+    begin() const
+    {
+        invariants();
+
+        return m_data;
+    }
+
+    iterator
+    end()
+    {
+        invariants();
+
+        return m_data + m_size;
+    }
+
+    const_iterator
+    end() const
+    {
+        invariants();
+
+        return m_data + m_size;
+    }
+
+    reverse_iterator
+    rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    const_reverse_iterator
+    rbegin() const
+    {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator
+    rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    const_reverse_iterator
+    rend() const
+    {
+        return const_reverse_iterator(begin());
+    }
+
+    reference
+    at(size_type    theIndex)
+    {
+        if (theIndex >= m_size)
+        {
+            outOfRange();
+        }
+
+        return m_data[theIndex];
+    }
+
+    const_reference
+    at(size_type    theIndex) const
+    {
+        if (theIndex >= m_size)
+        {
+            outOfRange();
+        }
+
+        return m_data[theIndex];
+    }
+
+    reference
+    operator[](size_type    theIndex)
+    {
+        assert(theIndex < m_size);
+
+        return m_data[theIndex];
+    }
+
+    const_reference
+    operator[](size_type    theIndex) const
+    {
+        assert(theIndex < m_size);
+
+        return m_data[theIndex];
+    }
+
+    void
+    clear()
+    {
+        invariants();
+
+        m_size = 0;
+    }
+
+    ThisType&
+    operator=(const ThisType&   theRHS)
+    {
+        if (&theRHS != this)
+        {
+            assign(theRHS.begin(), theRHS.end());
+        }
+
+        return *this;
+    }
+
+    void
+    swap(ThisType&  theOther)
+    {
+        invariants();
+
+        if (isInline() == false && theOther.isInline() == false)
+        {
+            std::swap(m_memoryManager, theOther.m_memoryManager);
+            std::swap(m_size, theOther.m_size);
+            std::swap(m_allocation, theOther.m_allocation);
+            std::swap(m_data, theOther.m_data);
+        }
+        else
+        {
+            ThisType    theTemp(*theOther.m_memoryManager);
+
+            theTemp.take(theOther);
+            theOther.take(*this);
+            take(theTemp);
+        }
+
+        invariants();
+    }
+
+    const MemoryManager&
+    getMemoryManager() const
+    {
+        assert(m_memoryManager != 0);
+
+        return *m_memoryManager;
+    }
+
+    MemoryManager&
+    getMemoryManager()
+    {
+        assert(m_memoryManager != 0);
+
+        return *m_memoryManager;
+    }
+
+private:
+
+    // Not implemented...
+    XalanSmallVector(const ThisType&);
+
+    void
+    invariants() const
+    {
+        assert(m_allocation >= m_size);
+        assert(m_allocation >= InlineCount);
+        assert(m_data != 0);
+    }
+
+    bool
+    isInline() const
+    {
+        return m_data == m_buffer;
+    }
+
+    bool
+    contains(const_iterator     thePointer) const
+    {
+        return std::less_equal<const_iterator>()(begin(), thePointer) &&
+               std::less<const_iterator>()(thePointer, end());
+    }
+
+    /**
+     * Open a gap of theCount elements at the given position, growing the
+     * storage if necessary.
+     *
+     * @return the position of the gap, which may have moved
+     */
+    iterator
+    makeSpace(
+            iterator    thePosition,
+            size_type   theCount)
+    {
+        const size_type     theOffset = size_type(thePosition - begin());
+
+        if (m_size + theCount > m_allocation)
+        {
+            reallocate(m_size + theCount);
+        }
+
+        thePosition = begin() + theOffset;
+
+        std::copy_backward(
+            thePosition,
+            end(),
+            end() + theCount);
+
+        m_size += theCount;
+
+        return thePosition;
+    }
+
+    void
+    reallocate(size_type    theMinimumSize)
+    {
+        assert(theMinimumSize > m_allocation);
+
+        const size_type     theGrowth = size_type((m_allocation * 1.6) + 0.5);
+
+        const size_type     theNewAllocation =
+            theGrowth > theMinimumSize ? theGrowth : theMinimumSize;
+
+        value_type* const   theNewData = allocate(theNewAllocation);
+
+        std::copy(begin(), end(), theNewData);
+
+        if (isInline() == false)
+        {
+            deallocate(m_data);
+        }
+
+        m_data = theNewData;
+        m_allocation = theNewAllocation;
+    }
+
+    /**
+     * Take the contents of another instance, which is left empty.  This
+     * instance must be empty and must not own any memory.
+     */
+    void
+    take(ThisType&  theSource)
+    {
+        assert(m_size == 0 && isInline() == true);
+
+        m_memoryManager = theSource.m_memoryManager;
+        m_size = theSource.m_size;
+
+        if (theSource.isInline() == true)
+        {
+            std::copy(theSource.begin(), theSource.end(), m_buffer);
+        }
+        else
+        {
+            m_data = theSource.m_data;
+            m_allocation = theSource.m_allocation;
+
+            theSource.m_data = theSource.m_buffer;
+            theSource.m_allocation = InlineCount;
+        }
+
+        theSource.m_size = 0;
+    }
+
+    value_type*
+    allocate(size_type  size)
+    {
+        assert(m_memoryManager != 0);
+
+        void* const     pointer = m_memoryManager->allocate(size * sizeof(value_type));
+
+        assert(pointer != 0);
+
+        return static_cast<value_type*>(pointer);
+    }
+
+    void
+    deallocate(value_type*  pointer)
+    {
+        assert(m_memoryManager != 0);
+
+        m_memoryManager->deallocate(pointer);
+    }
+
+    static void
+    outOfRange()
+    {
+        throw std::out_of_range("");
+    }
+
+
+    // Data members...
+    MemoryManager*      m_memoryManager;
+
+    size_type           m_size;
+
+    size_type           m_allocation;
+
+    value_type*         m_data;
+
+    value_type          m_buffer[InlineCount];
+};
+
+
+
+}
+
+
+
+#endif  // XALANSMALLVECTOR_HEADER_GUARD_1357924680
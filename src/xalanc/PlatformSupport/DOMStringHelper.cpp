@@ -44,6 +44,8 @@
 
 
 #include "DoubleSupport.hpp"
+#include "XalanCharScanner.hpp"
+#include "XalanDoubleFormatter.hpp"
 #include "XalanOutputStream.hpp"
 #include "XalanUnicode.hpp"
 
@@ -110,6 +112,19 @@ static const XalanDOMChar   theZeroString[] =
 
 
 
+XALAN_PLATFORMSUPPORT_EXPORT_FUNCTION(XalanDOMString::size_type)
+indexOf(
+            const XalanDOMChar*         theString,
+            XalanDOMString::size_type   theStringLength,
+            XalanDOMChar                theChar)
+{
+    assert(theString != 0);
+
+    return XalanCharScanner::findChar(theString, theStringLength, theChar);
+}
+
+
+
 XALAN_PLATFORMSUPPORT_EXPORT_FUNCTION(XalanDOMString::size_type)
 indexOf(
             const XalanDOMChar*         theString,
@@ -126,57 +141,49 @@ indexOf(
     {
         return theStringLength;
     }
+    else if (theSubstringLength == 0)
+    {
+        return 0;
+    }
     else
     {
-        bool                        fMatch = false;
+        const XalanDOMChar  theFirstChar = theSubstring[0];
+
+        // The last position where the substring could start.
+        const XalanDOMString::size_type     theLastIndex =
+            theStringLength - theSubstringLength;
 
         XalanDOMString::size_type   theStringIndex = 0;
 
-        // While we haven't matched, and we haven't finished with the
-        // first string, and the number of characters left in the first
-        // string is greater than the length of the second string, try
-        // to match the strings.
-        while(fMatch == false &&
-              theStringIndex < theStringLength &&
-              theStringLength - theStringIndex >= theSubstringLength)
+        // Find each occurrence of the first character of the
+        // substring, and compare the rest of it from there.
+        for (;;)
         {
-            // We always start over from the beginning of the second string.
-            XalanDOMString::size_type   theSubstringIndex = 0;
-
-            // This variable will be incremented to index into the first
-            // string.  That way, we preserve the first string index for
-            // when we have to restart the following loop with the next
-            // position in the first string.
-            XalanDOMString::size_type   theOffset = 0;
-
-            // Compare the characters in the two strings, at the
-            // current indices, until the characters don't match.
-            while(theStringIndex < theStringLength &&
-                  theSubstringIndex < theSubstringLength &&
-                  theString[theStringIndex + theOffset] ==
-                        theSubstring[theSubstringIndex])
-            {
-                theOffset++;
-                theSubstringIndex++;
-            }
+            theStringIndex +=
+                XalanCharScanner::findChar(
+                    theString + theStringIndex,
+                    theLastIndex - theStringIndex + 1,
+                    theFirstChar);
 
-            // If we've reached the end of the second string,
-            // then we've found a match.
-            if (theSubstringIndex == theSubstringLength)
+            if (theStringIndex > theLastIndex)
             {
-                fMatch = true;
+                return theStringLength;
             }
-            else
+            else if (std::equal(
+                        theSubstring + 1,
+                        theSubstring + theSubstringLength,
+                        theString + theStringIndex + 1) == true)
             {
-                theStringIndex++;
+                return theStringIndex;
             }
-        }
 
-        return fMatch == false ? theStringLength : theStringIndex;
+            ++theStringIndex;
+        }
     }
 }
 
 
+
 XALAN_PLATFORMSUPPORT_EXPORT_FUNCTION(XalanDOMString::size_type)
 indexOf(
             const XalanDOMString&   theString,
@@ -192,7 +199,11 @@ indexOf(
     }
     else
     {
-        return indexOf(theString.c_str(), theSubstring.c_str());
+        return indexOf(
+                    theString.c_str(),
+                    theString.length(),
+                    theSubstring.c_str(),
+                    theSubstring.length());
     }
 }
 
@@ -1344,40 +1355,6 @@ TranscodeNumber(
 
 
 
-static const char* const    thePrintfStrings[] =
-{
-    "%.10f",
-    "%.11f",
-    "%.12f",
-    "%.13f",
-    "%.14f",
-    "%.15f",
-    "%.16f",
-    "%.17f",
-    "%.18f",
-    "%.19f",
-    "%.20f",
-    "%.21f",
-    "%.22f",
-    "%.23f",
-    "%.24f",
-    "%.25f",
-    "%.26f",
-    "%.27f",
-    "%.28f",
-    "%.29f",
-    "%.30f",
-    "%.31f",
-    "%.32f",
-    "%.33f",
-    "%.34f",
-    "%.35f",
-    0
-};
-
-
-
-
 XALAN_PLATFORMSUPPORT_EXPORT_FUNCTION(XalanDOMString&)
 PointerToDOMString(
             const void*         theValue,
@@ -1439,80 +1416,14 @@ DOMStringHelper::NumberToCharacters(
     }
     else
     {
-        char            theBuffer[MAX_PRINTF_DIGITS + 1];
-
-        using std::sprintf;
-        using std::atof;
-        using std::isdigit;
+        XalanDOMChar    theBuffer[XalanDoubleFormatter::eMaxCharacters];
 
-        const char* const *     thePrintfString = thePrintfStrings;
-
-        int     theCharsWritten = 0;
-
-        do
-        {
-            theCharsWritten = sprintf(theBuffer, *thePrintfString, theValue);
-            assert(theCharsWritten != 0);
-
-            ++thePrintfString;
-        }
-        while(atof(theBuffer) != theValue && *thePrintfString != 0);
-
-        // First, cleanup the output to conform to the XPath standard,
-        // which says no trailing '0's for the decimal portion.
-        // So start with the last digit, and search until we find
-        // the last correct character for the output.
-        // Also, according to the XPath standard, any values without
-        // a fractional part are printed as integers.  There's always
-        // a decimal point, so we have to strip stuff away...
-
-        // Now, move back while there are zeros...
-        while(theBuffer[--theCharsWritten] == '0')
-        {
-        }
-
-        int     theCurrentIndex = theCharsWritten;
-
-        // If a decimal point stopped the loop, then
-        // we don't want to preserve it.  Otherwise,
-        // another digit stopped the loop, so we must
-        // preserve it.
-        if(isdigit(theBuffer[theCharsWritten]))
-        {
-            ++theCharsWritten;
-        }
-
-        // Some other character other than '.' can be the
-        // separator.  This can happen if the locale is
-        // not the "C" locale, etc.  If that's the case,
-        // replace it with '.'.
-        while(theCurrentIndex > 0)
-        {
-            if (isdigit(theBuffer[theCurrentIndex]))
-            {
-                --theCurrentIndex;
-            }
-            else
-            {
-                if (theBuffer[theCurrentIndex] != '.')
-                {
-                    theBuffer[theCurrentIndex] = '.';
-                }
-
-                break;
-            }
-        }
-
-        XalanDOMChar    theResult[MAX_PRINTF_DIGITS + 1];
-
-        TranscodeNumber(
-                theBuffer,
-                theBuffer + theCharsWritten,
-                &theResult[0]);
+        const XalanDoubleFormatter::size_type   theLength =
+            XalanDoubleFormatter::format(theValue, theBuffer);
 
         (formatterListener.*function)(
-            theResult,
-            theCharsWritten);
+            theBuffer,
+            theLength);
     }
 }
 
@@ -1739,76 +1650,12 @@ NumberToDOMString(
     }
     else
     {
-        char            theBuffer[MAX_PRINTF_DIGITS + 1];
-
-        using std::sprintf;
-        using std::atof;
-        using std::isdigit;
-
-        const char* const *     thePrintfString = thePrintfStrings;
-
-        int     theCharsWritten = 0;
-
-        do
-        {
-            theCharsWritten = sprintf(theBuffer, *thePrintfString, theValue);
-            assert(theCharsWritten != 0);
-
-            ++thePrintfString;
-        }
-        while(atof(theBuffer) != theValue && *thePrintfString != 0);
-
-        // First, cleanup the output to conform to the XPath standard,
-        // which says no trailing '0's for the decimal portion.
-        // So start with the last digit, and search until we find
-        // the last correct character for the output.
-        // Also, according to the XPath standard, any values without
-        // a fractional part are printed as integers.  There's always
-        // a decimal point, so we have to strip stuff away...
-
-        // Now, move back while there are zeros...
-        while(theBuffer[--theCharsWritten] == '0')
-        {
-        }
-
-        int     theCurrentIndex = theCharsWritten;
-
-        // If a decimal point stopped the loop, then
-        // we don't want to preserve it.  Otherwise,
-        // another digit stopped the loop, so we must
-        // preserve it.
-        if(isdigit(theBuffer[theCharsWritten]))
-        {
-            ++theCharsWritten;
-        }
-
-        // Some other character other than '.' can be the
-        // separator.  This can happen if the locale is
-        // not the "C" locale, etc.  If that's the case,
-        // replace it with '.'.
-        while(theCurrentIndex > 0)
-        {
-            if (isdigit(theBuffer[theCurrentIndex]))
-            {
-                --theCurrentIndex;
-            }
-            else
-            {
-                if (theBuffer[theCurrentIndex] != '.')
-                {
-                    theBuffer[theCurrentIndex] = '.';
-                }
-
-                break;
-            }
-        }
+        XalanDOMChar    theBuffer[XalanDoubleFormatter::eMaxCharacters];
 
-        theResult.reserve(theResult.length() + theCharsWritten);
+        const XalanDoubleFormatter::size_type   theLength =
+            XalanDoubleFormatter::format(theValue, theBuffer);
 
-        TranscodeNumber(
-                theBuffer,
-                theBuffer + theCharsWritten,
-                std::back_inserter(theResult));
+        theResult.append(theBuffer, theLength);
     }
 
     return theResult;
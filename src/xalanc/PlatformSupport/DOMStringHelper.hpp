@@ -333,24 +333,11 @@ indexOf(
  * or length(theString) if the character is not
  * found.    
  */
-inline XalanDOMString::size_type
+XALAN_PLATFORMSUPPORT_EXPORT_FUNCTION(XalanDOMString::size_type)
 indexOf(
             const XalanDOMChar*         theString,
             XalanDOMString::size_type   theStringLength,
-            XalanDOMChar                theChar)
-{
-    assert(theString != 0);
-
-    const XalanDOMChar*         thePointer = theString;
-    const XalanDOMChar* const   theEndPointer = theString + theStringLength;
-
-    while(*thePointer != theChar && thePointer != theEndPointer)
-    {
-        ++thePointer;
-    }
-
-    return XalanDOMString::size_type(thePointer - theString);
-}
+            XalanDOMChar                theChar);
 
 
 
@@ -368,7 +355,7 @@ indexOf(
             const XalanDOMString&   theString,
             XalanDOMChar            theChar)
 {
-    return theString.length() == 0 ? 0 : indexOf(theString.c_str(), theChar);
+    return indexOf(theString.c_str(), theString.length(), theChar);
 }
 
 
@@ -552,6 +552,87 @@ translateWideString(
 
 
 
+// Converts a validated number directly when its significand is exact in
+// a double and its scale is an exact power of 10, so a single correctly
+// rounded division gives the right answer.  Returns false for anything
+// else, which is left to the C library.
+static bool
+fastConvert(
+            const XalanDOMChar*     theString,
+            double&                 theResult)
+{
+    static const double     thePowersOf10[] =
+    {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    const int   theMaxScale =
+        int(sizeof(thePowersOf10) / sizeof(thePowersOf10[0])) - 1;
+
+    // The largest significand a double holds exactly.
+    const XMLUInt64     theMaxSignificand = XMLUInt64(1) << 53;
+
+    consumeWhitespace(theString);
+
+    const bool  fNegative = *theString == XalanUnicode::charHyphenMinus;
+
+    if (fNegative == true)
+    {
+        ++theString;
+    }
+
+    XMLUInt64   theSignificand = 0;
+    int         theScale = 0;
+    bool        fGotDecimalPoint = false;
+
+    for(;; ++theString)
+    {
+        const XalanDOMChar  theChar = *theString;
+
+        if (theChar >= XalanUnicode::charDigit_0 &&
+            theChar <= XalanUnicode::charDigit_9)
+        {
+            if (theSignificand >= theMaxSignificand / 10)
+            {
+                return false;
+            }
+
+            theSignificand =
+                theSignificand * 10 + (theChar - XalanUnicode::charDigit_0);
+
+            if (fGotDecimalPoint == true)
+            {
+                ++theScale;
+            }
+        }
+        else if (theChar == XalanUnicode::charFullStop)
+        {
+            fGotDecimalPoint = true;
+        }
+        else
+        {
+            // doValidate() has checked that only whitespace follows.
+            break;
+        }
+    }
+
+    if (theScale > theMaxScale)
+    {
+        return false;
+    }
+
+    const double    theValue =
+        double(theSignificand) / thePowersOf10[theScale];
+
+    theResult = fNegative == true ? -theValue : theValue;
+
+    return true;
+}
+
+
+
 inline double
 convertHelper(
             const XalanDOMChar*     theString,
@@ -572,6 +653,13 @@ convertHelper(
     }
     else
     {
+        double  theResult;
+
+        if (fastConvert(theString, theResult) == true)
+        {
+            return theResult;
+        }
+
         using std::localeconv;
         using std::atof;
 
@@ -49,6 +49,16 @@ FormatterListener::~FormatterListener()
 
 
 
+bool
+FormatterListener::preSerializedMarkup(
+            const XMLCh* const  /* chars */,
+            const size_type     /* length */)
+{
+    return false;
+}
+
+
+
 Writer*
 FormatterListener::getWriter() const
 {
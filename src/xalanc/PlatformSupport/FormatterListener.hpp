@@ -197,6 +197,26 @@ public:
     virtual void
     entityReference(const XMLCh* const  name) = 0;
 
+    /**
+     * Receive a run of markup which has already been serialized, such as
+     * the constant content of a literal result element.  The markup uses
+     * a single line feed for each line break, and contains no characters
+     * which need different treatment in different encodings or XML versions,
+     * except that characters may need to be written as character references.
+     *
+     * A listener which does not write markup directly should return false
+     * without doing anything, and the caller will then generate the
+     * equivalent events instead.
+     *
+     * @param chars  pointer to the markup
+     * @param length number of characters in the markup
+     * @return true if the markup was written, false if not.
+     */
+    virtual bool
+    preSerializedMarkup(
+            const XMLCh* const  chars,
+            const size_type     length);
+
 
 // These methods are inherited from DocumentHandler ...
 
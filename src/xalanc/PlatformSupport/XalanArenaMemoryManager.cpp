@@ -0,0 +1,297 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "XalanArenaMemoryManager.hpp"
+
+
+
+#include <cassert>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanArenaMemoryManager::XalanArenaMemoryManager(
+            MemoryManager&  theParent,
+            size_type       theBlockSize) :
+    m_parent(theParent),
+    m_blockSize(align(theBlockSize)),
+    m_blocks(0),
+    m_largeBlocks(0),
+    m_current(0),
+    m_end(0)
+{
+    clearFreeLists();
+}
+
+
+
+XalanArenaMemoryManager::~XalanArenaMemoryManager()
+{
+    releaseBlocks(m_largeBlocks);
+    releaseBlocks(m_blocks);
+}
+
+
+
+void*
+XalanArenaMemoryManager::allocate(size_type     size)
+{
+    const size_type     theSize = size == 0 ? 1 : size;
+
+    if (theSize > m_blockSize / 4)
+    {
+        return allocateLarge(theSize);
+    }
+
+    const size_type     theSizeClass = getSizeClass(theSize);
+
+    const size_type     theClassSize = getClassSize(theSizeClass);
+
+    if (theClassSize > m_blockSize / 4)
+    {
+        // Rounding up would leave too little of a block to share.
+        return allocateLarge(theSize);
+    }
+
+    FreeBlock*&     theFreeList = m_freeLists[theSizeClass];
+
+    if (theFreeList != 0)
+    {
+        FreeBlock* const    theBlock = theFreeList;
+
+        theFreeList = theBlock->m_next;
+
+        return theBlock;
+    }
+
+    const size_type     theHeaderSize = align(sizeof(AllocationHeader));
+
+    if (theHeaderSize + theClassSize > size_type(m_end - m_current))
+    {
+        m_current = allocateBlock(m_blockSize, m_blocks);
+        m_end = m_current + m_blockSize;
+    }
+
+    AllocationHeader* const     theHeader =
+        reinterpret_cast<AllocationHeader*>(m_current);
+
+    theHeader->m_sizeClass = theSizeClass;
+
+    m_current += theHeaderSize + theClassSize;
+
+    return reinterpret_cast<char*>(theHeader) + theHeaderSize;
+}
+
+
+
+void
+XalanArenaMemoryManager::deallocate(void*   pointer)
+{
+    if (pointer != 0)
+    {
+        AllocationHeader* const     theHeader = getAllocationHeader(pointer);
+
+        const size_type     theSizeClass = theHeader->m_sizeClass;
+
+        if (theSizeClass == eLargeClass)
+        {
+            deallocateLarge(theHeader);
+        }
+        else
+        {
+            assert(theSizeClass < eClassCount);
+
+            FreeBlock* const    theBlock = static_cast<FreeBlock*>(pointer);
+
+            theBlock->m_next = m_freeLists[theSizeClass];
+
+            m_freeLists[theSizeClass] = theBlock;
+        }
+    }
+}
+
+
+
+MemoryManager*
+XalanArenaMemoryManager::getExceptionMemoryManager()
+{
+    // Exceptions can outlive the arena, so they use the parent.
+    return m_parent.getExceptionMemoryManager();
+}
+
+
+
+void
+XalanArenaMemoryManager::reset()
+{
+    releaseBlocks(m_largeBlocks);
+
+    m_largeBlocks = 0;
+
+    if (m_blocks != 0)
+    {
+        releaseBlocks(m_blocks->m_next);
+
+        m_blocks->m_next = 0;
+
+        m_current = reinterpret_cast<char*>(m_blocks) + align(sizeof(BlockHeader));
+        m_end = m_current + m_blockSize;
+    }
+
+    clearFreeLists();
+}
+
+
+
+XalanArenaMemoryManager::size_type
+XalanArenaMemoryManager::getSizeClass(size_type     theSize)
+{
+    assert(theSize != 0);
+
+    if (theSize <= eSmallClassLimit)
+    {
+        return (theSize - 1) / eAlignment;
+    }
+    else
+    {
+        size_type   theSizeClass = eSmallClassCount;
+
+        for (size_type theClassSize = eSmallClassLimit * 2;
+                theClassSize < theSize;
+                    theClassSize *= 2)
+        {
+            ++theSizeClass;
+        }
+
+        assert(theSizeClass < eClassCount);
+
+        return theSizeClass;
+    }
+}
+
+
+
+XalanArenaMemoryManager::size_type
+XalanArenaMemoryManager::getClassSize(size_type     theSizeClass)
+{
+    assert(theSizeClass < eClassCount);
+
+    return theSizeClass < eSmallClassCount ?
+                (theSizeClass + 1) * eAlignment :
+                size_type(eSmallClassLimit) << (theSizeClass - eSmallClassCount + 1);
+}
+
+
+
+void*
+XalanArenaMemoryManager::allocateLarge(size_type    theSize)
+{
+    const size_type     theHeaderSize = align(sizeof(AllocationHeader));
+
+    char* const     theStart = allocateBlock(theHeaderSize + align(theSize), m_largeBlocks);
+
+    if (m_largeBlocks->m_next != 0)
+    {
+        m_largeBlocks->m_next->m_previous = m_largeBlocks;
+    }
+
+    reinterpret_cast<AllocationHeader*>(theStart)->m_sizeClass = eLargeClass;
+
+    return theStart + theHeaderSize;
+}
+
+
+
+void
+XalanArenaMemoryManager::deallocateLarge(AllocationHeader*  theHeader)
+{
+    BlockHeader* const  theBlock =
+        reinterpret_cast<BlockHeader*>(
+            reinterpret_cast<char*>(theHeader) - align(sizeof(BlockHeader)));
+
+    if (theBlock->m_previous == 0)
+    {
+        assert(m_largeBlocks == theBlock);
+
+        m_largeBlocks = theBlock->m_next;
+    }
+    else
+    {
+        theBlock->m_previous->m_next = theBlock->m_next;
+    }
+
+    if (theBlock->m_next != 0)
+    {
+        theBlock->m_next->m_previous = theBlock->m_previous;
+    }
+
+    m_parent.deallocate(theBlock);
+}
+
+
+
+char*
+XalanArenaMemoryManager::allocateBlock(
+            size_type       theSize,
+            BlockHeader*&   theList)
+{
+    const size_type     theHeaderSize = align(sizeof(BlockHeader));
+
+    BlockHeader* const  theBlock =
+        static_cast<BlockHeader*>(m_parent.allocate(theHeaderSize + theSize));
+    assert(theBlock != 0);
+
+    theBlock->m_next = theList;
+    theBlock->m_previous = 0;
+
+    theList = theBlock;
+
+    return reinterpret_cast<char*>(theBlock) + theHeaderSize;
+}
+
+
+
+void
+XalanArenaMemoryManager::releaseBlocks(BlockHeader*     theList)
+{
+    while (theList != 0)
+    {
+        BlockHeader* const  theNext = theList->m_next;
+
+        m_parent.deallocate(theList);
+
+        theList = theNext;
+    }
+}
+
+
+
+void
+XalanArenaMemoryManager::clearFreeLists()
+{
+    for (size_type i = 0; i < eClassCount; ++i)
+    {
+        m_freeLists[i] = 0;
+    }
+}
+
+
+
+}
@@ -0,0 +1,207 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANARENAMEMORYMANAGER_HEADER_GUARD_1357924680)
+#define XALANARENAMEMORYMANAGER_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/PlatformSupport/PlatformSupportDefinitions.hpp>
+
+
+
+#include "xalanc/Include/XalanMemoryManagement.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * A memory manager which allocates by bumping a pointer through large
+ * blocks obtained from another memory manager.  Each allocation is
+ * rounded up to a size class, and deallocated memory is kept on a free
+ * list for its class, so memory which is freed during a transformation
+ * is reused by later requests.  Requests too large to share a block get
+ * a block of their own, which is given back to the other memory manager
+ * when it's deallocated.  Everything else is released at once by
+ * calling reset().
+ *
+ * Each allocation is preceded by a 16-byte header which records its size
+ * class, and the classes above 256 bytes double in size, so the arena
+ * trades some space for the speed of allocation.
+ *
+ * This is meant for objects which only live as long as a single
+ * transformation.  An instance is not synchronized, so it must only be
+ * used by one thread at a time.
+ */
+class XALAN_PLATFORMSUPPORT_EXPORT XalanArenaMemoryManager : public XalanMemoryManager
+{
+public:
+
+    enum { eDefaultBlockSize = 64 * 1024 };
+
+    /**
+     * Construct an instance.  No memory is allocated until the first
+     * request.
+     *
+     * @param theParent The memory manager for the blocks
+     * @param theBlockSize The size of each block
+     */
+    explicit
+    XalanArenaMemoryManager(
+            MemoryManager&  theParent,
+            size_type       theBlockSize = eDefaultBlockSize);
+
+    virtual
+    ~XalanArenaMemoryManager();
+
+    virtual void*
+    allocate(size_type  size);
+
+    virtual void
+    deallocate(void*    pointer);
+
+    virtual MemoryManager*
+    getExceptionMemoryManager();
+
+    /**
+     * Release all of the memory allocated from the instance.  The first
+     * block is kept for the next allocations.  Any objects allocated from
+     * the instance must already have been destroyed.
+     */
+    void
+    reset();
+
+    /**
+     * Get the memory manager for the blocks.
+     *
+     * @return The parent memory manager
+     */
+    MemoryManager&
+    getParent() const
+    {
+        return m_parent;
+    }
+
+private:
+
+    struct BlockHeader
+    {
+        BlockHeader*    m_next;
+
+        // Only the blocks for large requests are linked both ways,
+        // so they can be released one at a time.
+        BlockHeader*    m_previous;
+    };
+
+    // The header which precedes each allocation.
+    struct AllocationHeader
+    {
+        size_type       m_sizeClass;
+    };
+
+    // A deallocated block on the free list for its size class.
+    struct FreeBlock
+    {
+        FreeBlock*      m_next;
+    };
+
+    enum
+    {
+        eAlignment = 16,
+
+        // The classes up to this size are multiples of the alignment,
+        // and the rest are powers of two.
+        eSmallClassLimit = 256,
+        eSmallClassCount = eSmallClassLimit / eAlignment,
+        eClassCount = eSmallClassCount + 24,
+
+        // The size class of a request with a block of its own.
+        eLargeClass = eClassCount
+    };
+
+    static size_type
+    align(size_type     theSize)
+    {
+        return (theSize + eAlignment - 1) & ~size_type(eAlignment - 1);
+    }
+
+    static size_type
+    getSizeClass(size_type  theSize);
+
+    static size_type
+    getClassSize(size_type  theSizeClass);
+
+    static AllocationHeader*
+    getAllocationHeader(void*   thePointer)
+    {
+        return reinterpret_cast<AllocationHeader*>(
+                    static_cast<char*>(thePointer) - align(sizeof(AllocationHeader)));
+    }
+
+    void*
+    allocateLarge(size_type     theSize);
+
+    void
+    deallocateLarge(AllocationHeader*   theHeader);
+
+    char*
+    allocateBlock(
+            size_type       theSize,
+            BlockHeader*&   theList);
+
+    void
+    releaseBlocks(BlockHeader*  theList);
+
+    void
+    clearFreeLists();
+
+    // These are not implemented.
+    XalanArenaMemoryManager(const XalanArenaMemoryManager&);
+
+    XalanArenaMemoryManager&
+    operator=(const XalanArenaMemoryManager&);
+
+
+    // Data members...
+    MemoryManager&      m_parent;
+
+    const size_type     m_blockSize;
+
+    // The blocks of m_blockSize, the first of which is being filled.
+    BlockHeader*        m_blocks;
+
+    // The blocks for requests too large to share a block.
+    BlockHeader*        m_largeBlocks;
+
+    char*               m_current;
+
+    char*               m_end;
+
+    FreeBlock*          m_freeLists[eClassCount];
+};
+
+
+
+}
+
+
+
+#endif  // XALANARENAMEMORYMANAGER_HEADER_GUARD_1357924680
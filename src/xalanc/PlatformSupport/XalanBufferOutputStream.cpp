@@ -0,0 +1,78 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Class header file...
+#include "XalanBufferOutputStream.hpp"
+
+
+
+#include <cstring>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanBufferOutputStream::XalanBufferOutputStream(MemoryManager&     theManager) :
+    XalanOutputStream(theManager)
+{
+}
+
+
+
+XalanBufferOutputStream::~XalanBufferOutputStream()
+{
+}
+
+
+
+void
+XalanBufferOutputStream::writeData(
+            const char*     theBuffer,
+            size_type       theBufferLength)
+{
+    while (theBufferLength != 0)
+    {
+        size_type   theSize = 0;
+
+        char* const     theDestination =
+            getDirectBuffer(1, theSize);
+        assert(theDestination != 0 && theSize != 0);
+
+        const size_type     theCount =
+            theBufferLength < theSize ? theBufferLength : theSize;
+
+        std::memcpy(theDestination, theBuffer, theCount);
+
+        commitDirectBuffer(theCount);
+
+        theBuffer += theCount;
+        theBufferLength -= theCount;
+    }
+}
+
+
+
+void
+XalanBufferOutputStream::doFlush()
+{
+}
+
+
+
+}
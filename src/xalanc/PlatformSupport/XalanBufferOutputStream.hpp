@@ -0,0 +1,86 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANBUFFEROUTPUTSTREAM_HEADER_GUARD_1357924680)
+#define XALANBUFFEROUTPUTSTREAM_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/PlatformSupport/PlatformSupportDefinitions.hpp>
+
+
+
+// Base class header file.
+#include <xalanc/PlatformSupport/XalanOutputStream.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * A base class for output streams that keep the output in memory
+ * supplied by the derived class.  Serializers that produce encoded
+ * bytes themselves write them straight into that memory through
+ * getDirectBuffer(), and anything else is copied into it.
+ */
+class XALAN_PLATFORMSUPPORT_EXPORT XalanBufferOutputStream : public XalanOutputStream
+{
+public:
+
+    explicit
+    XalanBufferOutputStream(MemoryManager&  theManager);
+
+    virtual
+    ~XalanBufferOutputStream();
+
+    virtual char*
+    getDirectBuffer(
+            size_type   theMinimumSize,
+            size_type&  theSize) = 0;
+
+    virtual void
+    commitDirectBuffer(size_type    theCount) = 0;
+
+protected:
+
+    virtual void
+    writeData(
+            const char*     theBuffer,
+            size_type       theBufferLength);
+
+    virtual void
+    doFlush();
+
+private:
+
+    // These are not implemented...
+    XalanBufferOutputStream(const XalanBufferOutputStream&);
+
+    XalanBufferOutputStream&
+    operator=(const XalanBufferOutputStream&);
+};
+
+
+
+}
+
+
+
+#endif  // XALANBUFFEROUTPUTSTREAM_HEADER_GUARD_1357924680
@@ -0,0 +1,485 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANCHARSCANNER_HEADER_GUARD_1357924680)
+#define XALANCHARSCANNER_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/PlatformSupport/PlatformSupportDefinitions.hpp>
+
+
+
+#include <cassert>
+
+
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define XALAN_CHARSCANNER_USE_AVX2
+#define XALAN_CHARSCANNER_USE_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define XALAN_CHARSCANNER_USE_SSE2
+#endif
+
+#if defined(_MSC_VER) && defined(XALAN_CHARSCANNER_USE_SSE2)
+#include <intrin.h>
+#endif
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * This class scans UTF-16 text for the characters that a serializer or
+ * a string function must look at one by one, so the runs of text between
+ * them can be skipped or copied in bulk.  When the compiler targets SSE2
+ * or AVX2, 8 or 16 code units are examined at a time.
+ */
+class XalanCharScanner
+{
+public:
+
+    typedef XalanSize_t     size_type;
+
+    /**
+     * Find the length of the run of characters at the start of the text
+     * which never need to be escaped in character content.  Every
+     * character in the run is printable ASCII, other than '<', '>'
+     * and '&'.  The run may end before a character which doesn't need
+     * escaping.
+     *
+     * @param theChars The text
+     * @param theLength The length of the text
+     * @return The length of the run
+     */
+    static size_type
+    scanContent(
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+    {
+        return scan<false>(theChars, theLength);
+    }
+
+    /**
+     * Find the length of the run of characters at the start of the text
+     * which never need to be escaped in an attribute value.  This is
+     * the same as scanContent(), except that '"' also ends the run.
+     *
+     * @param theChars The text
+     * @param theLength The length of the text
+     * @return The length of the run
+     */
+    static size_type
+    scanAttribute(
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+    {
+        return scan<true>(theChars, theLength);
+    }
+
+    /**
+     * Find the length of the run of ASCII characters at the start of
+     * the text.
+     *
+     * @param theChars The text
+     * @param theLength The length of the text
+     * @return The length of the run
+     */
+    static size_type
+    scanASCII(
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+    {
+        size_type   i = 0;
+
+#if defined(XALAN_CHARSCANNER_USE_AVX2)
+        const __m256i   theLimit256 = _mm256_set1_epi16(0x7F);
+
+        for (; i + 16 <= theLength; i += 16)
+        {
+            const __m256i   theBlock =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(theChars + i));
+
+            const unsigned int  theMask = static_cast<unsigned int>(
+                _mm256_movemask_epi8(
+                    _mm256_cmpeq_epi16(
+                        _mm256_subs_epu16(theBlock, theLimit256),
+                        _mm256_setzero_si256())));
+
+            if (theMask != 0xFFFFFFFFu)
+            {
+                return i + firstClear(theMask) / 2;
+            }
+        }
+#endif
+
+#if defined(XALAN_CHARSCANNER_USE_SSE2)
+        const __m128i   theLimit = _mm_set1_epi16(0x7F);
+
+        for (; i + 8 <= theLength; i += 8)
+        {
+            const __m128i   theBlock =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(theChars + i));
+
+            const unsigned int  theMask = static_cast<unsigned int>(
+                _mm_movemask_epi8(
+                    _mm_cmpeq_epi16(
+                        _mm_subs_epu16(theBlock, theLimit),
+                        _mm_setzero_si128())));
+
+            if (theMask != 0xFFFFu)
+            {
+                return i + firstClear(theMask) / 2;
+            }
+        }
+#endif
+
+        while (i < theLength && theChars[i] < 0x80)
+        {
+            ++i;
+        }
+
+        return i;
+    }
+
+    /**
+     * Find the first occurrence of a character.
+     *
+     * @param theChars The text
+     * @param theLength The length of the text
+     * @param theChar The character to find
+     * @return The index of the character, or theLength if it's not found
+     */
+    static size_type
+    findChar(
+            const XalanDOMChar*     theChars,
+            size_type               theLength,
+            XalanDOMChar            theChar)
+    {
+        size_type   i = 0;
+
+#if defined(XALAN_CHARSCANNER_USE_AVX2)
+        const __m256i   theTarget256 = _mm256_set1_epi16(short(theChar));
+
+        for (; i + 16 <= theLength; i += 16)
+        {
+            const __m256i   theBlock =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(theChars + i));
+
+            const unsigned int  theMask = static_cast<unsigned int>(
+                _mm256_movemask_epi8(_mm256_cmpeq_epi16(theBlock, theTarget256)));
+
+            if (theMask != 0)
+            {
+                return i + firstClear(~theMask) / 2;
+            }
+        }
+#endif
+
+#if defined(XALAN_CHARSCANNER_USE_SSE2)
+        const __m128i   theTarget = _mm_set1_epi16(short(theChar));
+
+        for (; i + 8 <= theLength; i += 8)
+        {
+            const __m128i   theBlock =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(theChars + i));
+
+            const unsigned int  theMask = static_cast<unsigned int>(
+                _mm_movemask_epi8(_mm_cmpeq_epi16(theBlock, theTarget)));
+
+            if (theMask != 0)
+            {
+                return i + firstClear(~theMask) / 2;
+            }
+        }
+#endif
+
+        while (i < theLength && theChars[i] != theChar)
+        {
+            ++i;
+        }
+
+        return i;
+    }
+
+    /**
+     * Find the length of the run of characters at the start of the text
+     * which are not XML whitespace.
+     *
+     * @param theChars The text
+     * @param theLength The length of the text
+     * @return The length of the run
+     */
+    static size_type
+    scanNonWhitespace(
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+    {
+        size_type   i = 0;
+
+        // Whitespace is never greater than the space character, so only
+        // blocks with such a character need to be looked at closely.
+#if defined(XALAN_CHARSCANNER_USE_AVX2)
+        const __m256i   theSpace256 = _mm256_set1_epi16(0x20);
+
+        for (; i + 16 <= theLength; i += 16)
+        {
+            const __m256i   theBlock =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(theChars + i));
+
+            const unsigned int  theMask = static_cast<unsigned int>(
+                _mm256_movemask_epi8(
+                    _mm256_cmpeq_epi16(
+                        _mm256_subs_epu16(theBlock, theSpace256),
+                        _mm256_setzero_si256())));
+
+            if (theMask != 0)
+            {
+                break;
+            }
+        }
+#endif
+
+#if defined(XALAN_CHARSCANNER_USE_SSE2)
+        const __m128i   theSpace = _mm_set1_epi16(0x20);
+
+        for (; i + 8 <= theLength; i += 8)
+        {
+            const __m128i   theBlock =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(theChars + i));
+
+            const unsigned int  theMask = static_cast<unsigned int>(
+                _mm_movemask_epi8(
+                    _mm_cmpeq_epi16(
+                        _mm_subs_epu16(theBlock, theSpace),
+                        _mm_setzero_si128())));
+
+            if (theMask != 0)
+            {
+                break;
+            }
+        }
+#endif
+
+        while (i < theLength && isWhitespace(theChars[i]) == false)
+        {
+            ++i;
+        }
+
+        return i;
+    }
+
+    /**
+     * Determine if a character is XML whitespace.
+     */
+    static bool
+    isWhitespace(XalanDOMChar   theChar)
+    {
+        return theChar == 0x20 ||
+               theChar == 0x0A ||
+               theChar == 0x09 ||
+               theChar == 0x0D;
+    }
+
+    /**
+     * Copy ASCII characters to a narrow buffer.
+     *
+     * @param theChars The characters, which must all be ASCII
+     * @param theLength The number of characters
+     * @param theBuffer The buffer, which must hold theLength bytes
+     */
+    static void
+    narrowASCII(
+            const XalanDOMChar*     theChars,
+            size_type               theLength,
+            char*                   theBuffer)
+    {
+        size_type   i = 0;
+
+#if defined(XALAN_CHARSCANNER_USE_SSE2)
+        for (; i + 16 <= theLength; i += 16)
+        {
+            const __m128i   theLow =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(theChars + i));
+
+            const __m128i   theHigh =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(theChars + i + 8));
+
+            _mm_storeu_si128(
+                reinterpret_cast<__m128i*>(theBuffer + i),
+                _mm_packus_epi16(theLow, theHigh));
+        }
+#endif
+
+        for (; i < theLength; ++i)
+        {
+            assert(theChars[i] < 0x80);
+
+            theBuffer[i] = static_cast<char>(theChars[i]);
+        }
+    }
+
+private:
+
+    template <bool fAttribute>
+    static bool
+    isSpecial(XalanDOMChar  theChar)
+    {
+        return theChar < 0x20 ||
+               theChar >= 0x7F ||
+               theChar == XalanDOMChar('<') ||
+               theChar == XalanDOMChar('>') ||
+               theChar == XalanDOMChar('&') ||
+               (fAttribute == true && theChar == XalanDOMChar('"'));
+    }
+
+    template <bool fAttribute>
+    static size_type
+    scan(
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+    {
+        size_type   i = 0;
+
+        // A character is in the printable range if it's between 0x20
+        // and 0x7E, which is when subtracting 0x20 leaves less than 0x5F.
+#if defined(XALAN_CHARSCANNER_USE_AVX2)
+        {
+            const __m256i   theBase = _mm256_set1_epi16(0x20);
+            const __m256i   theRange = _mm256_set1_epi16(0x5E);
+            const __m256i   theLessThan = _mm256_set1_epi16('<');
+            const __m256i   theGreaterThan = _mm256_set1_epi16('>');
+            const __m256i   theAmpersand = _mm256_set1_epi16('&');
+            const __m256i   theQuote = _mm256_set1_epi16('"');
+
+            for (; i + 16 <= theLength; i += 16)
+            {
+                const __m256i   theBlock =
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(theChars + i));
+
+                const __m256i   thePrintable =
+                    _mm256_cmpeq_epi16(
+                        _mm256_subs_epu16(_mm256_sub_epi16(theBlock, theBase), theRange),
+                        _mm256_setzero_si256());
+
+                __m256i     theMarkup =
+                    _mm256_or_si256(
+                        _mm256_or_si256(
+                            _mm256_cmpeq_epi16(theBlock, theLessThan),
+                            _mm256_cmpeq_epi16(theBlock, theGreaterThan)),
+                        _mm256_cmpeq_epi16(theBlock, theAmpersand));
+
+                if (fAttribute == true)
+                {
+                    theMarkup = _mm256_or_si256(theMarkup, _mm256_cmpeq_epi16(theBlock, theQuote));
+                }
+
+                const unsigned int  theMask = static_cast<unsigned int>(
+                    _mm256_movemask_epi8(_mm256_andnot_si256(theMarkup, thePrintable)));
+
+                if (theMask != 0xFFFFFFFFu)
+                {
+                    return i + firstClear(theMask) / 2;
+                }
+            }
+        }
+#endif
+
+#if defined(XALAN_CHARSCANNER_USE_SSE2)
+        {
+            const __m128i   theBase = _mm_set1_epi16(0x20);
+            const __m128i   theRange = _mm_set1_epi16(0x5E);
+            const __m128i   theLessThan = _mm_set1_epi16('<');
+            const __m128i   theGreaterThan = _mm_set1_epi16('>');
+            const __m128i   theAmpersand = _mm_set1_epi16('&');
+            const __m128i   theQuote = _mm_set1_epi16('"');
+
+            for (; i + 8 <= theLength; i += 8)
+            {
+                const __m128i   theBlock =
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(theChars + i));
+
+                const __m128i   thePrintable =
+                    _mm_cmpeq_epi16(
+                        _mm_subs_epu16(_mm_sub_epi16(theBlock, theBase), theRange),
+                        _mm_setzero_si128());
+
+                __m128i     theMarkup =
+                    _mm_or_si128(
+                        _mm_or_si128(
+                            _mm_cmpeq_epi16(theBlock, theLessThan),
+                            _mm_cmpeq_epi16(theBlock, theGreaterThan)),
+                        _mm_cmpeq_epi16(theBlock, theAmpersand));
+
+                if (fAttribute == true)
+                {
+                    theMarkup = _mm_or_si128(theMarkup, _mm_cmpeq_epi16(theBlock, theQuote));
+                }
+
+                const unsigned int  theMask = static_cast<unsigned int>(
+                    _mm_movemask_epi8(_mm_andnot_si128(theMarkup, thePrintable)));
+
+                if (theMask != 0xFFFFu)
+                {
+                    return i + firstClear(theMask) / 2;
+                }
+            }
+        }
+#endif
+
+        while (i < theLength && isSpecial<fAttribute>(theChars[i]) == false)
+        {
+            ++i;
+        }
+
+        return i;
+    }
+
+#if defined(XALAN_CHARSCANNER_USE_SSE2)
+    /**
+     * Find the index of the lowest bit which is not set in a mask.
+     */
+    static unsigned int
+    firstClear(unsigned int     theMask)
+    {
+        assert(theMask != 0xFFFFFFFFu);
+
+#if defined(_MSC_VER)
+        unsigned long   theIndex = 0;
+
+        _BitScanForward(&theIndex, ~theMask);
+
+        return static_cast<unsigned int>(theIndex);
+#else
+        return static_cast<unsigned int>(__builtin_ctz(~theMask));
+#endif
+    }
+#endif
+};
+
+
+
+}
+
+
+
+#endif  // XALANCHARSCANNER_HEADER_GUARD_1357924680
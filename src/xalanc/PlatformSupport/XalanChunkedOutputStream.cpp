@@ -0,0 +1,136 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Class header file...
+#include "XalanChunkedOutputStream.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanChunkedOutputStream::XalanChunkedOutputStream(
+            MemoryManager&  theManager,
+            size_type       theChunkSize) :
+    XalanBufferOutputStream(theManager),
+    m_chunkSize(theChunkSize == 0 ? 1 : theChunkSize),
+    m_chunks(theManager),
+    m_size(0)
+{
+}
+
+
+
+XalanChunkedOutputStream*
+XalanChunkedOutputStream::create(
+            MemoryManager&  theManager,
+            size_type       theChunkSize)
+{
+    typedef XalanChunkedOutputStream    ThisType;
+
+    XalanAllocationGuard    theGuard(theManager, theManager.allocate(sizeof(ThisType)));
+
+    ThisType* const     theResult =
+        new (theGuard.get()) ThisType(
+                        theManager,
+                        theChunkSize);
+
+    theGuard.release();
+
+    return theResult;
+}
+
+
+
+XalanChunkedOutputStream::~XalanChunkedOutputStream()
+{
+    clear();
+}
+
+
+
+void
+XalanChunkedOutputStream::clear()
+{
+    MemoryManager&  theManager = getMemoryManager();
+
+    for (ChunkVectorType::size_type i = 0; i < m_chunks.size(); ++i)
+    {
+        theManager.deallocate(m_chunks[i].m_data);
+    }
+
+    m_chunks.clear();
+
+    m_size = 0;
+}
+
+
+
+char*
+XalanChunkedOutputStream::getDirectBuffer(
+            size_type   theMinimumSize,
+            size_type&  theSize)
+{
+    if (m_chunks.empty() == true ||
+        m_chunks.back().m_capacity - m_chunks.back().m_size < theMinimumSize)
+    {
+        const size_type     theCapacity =
+            theMinimumSize < m_chunkSize ? m_chunkSize : theMinimumSize;
+
+        XalanAllocationGuard    theGuard(
+                                    getMemoryManager(),
+                                    getMemoryManager().allocate(theCapacity));
+
+        const Chunk     theChunk =
+        {
+            static_cast<char*>(theGuard.get()),
+            0,
+            theCapacity
+        };
+
+        m_chunks.push_back(theChunk);
+
+        theGuard.release();
+    }
+
+    Chunk&  theChunk = m_chunks.back();
+
+    theSize = theChunk.m_capacity - theChunk.m_size;
+
+    return theChunk.m_data + theChunk.m_size;
+}
+
+
+
+void
+XalanChunkedOutputStream::commitDirectBuffer(size_type  theCount)
+{
+    assert(m_chunks.empty() == false);
+
+    Chunk&  theChunk = m_chunks.back();
+
+    assert(theCount <= theChunk.m_capacity - theChunk.m_size);
+
+    theChunk.m_size += theCount;
+
+    m_size += theCount;
+}
+
+
+
+}
@@ -0,0 +1,168 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANCHUNKEDOUTPUTSTREAM_HEADER_GUARD_1357924680)
+#define XALANCHUNKEDOUTPUTSTREAM_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/PlatformSupport/PlatformSupportDefinitions.hpp>
+
+
+
+#include <xalanc/Include/XalanVector.hpp>
+
+
+
+// Base class header file.
+#include <xalanc/PlatformSupport/XalanBufferOutputStream.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * An output stream that collects the output in a list of separately
+ * allocated chunks, so it never has to move data as it grows.  The
+ * chunks are suitable for scatter/gather output, such as writev().
+ */
+class XALAN_PLATFORMSUPPORT_EXPORT XalanChunkedOutputStream : public XalanBufferOutputStream
+{
+public:
+
+    enum { eDefaultChunkSize = 16384u };
+
+    /**
+     * Construct a XalanChunkedOutputStream instance.
+     *
+     * @param theManager The MemoryManager instance for the chunks
+     * @param theChunkSize The size of each chunk
+     */
+    explicit
+    XalanChunkedOutputStream(
+            MemoryManager&  theManager XALAN_DEFAULT_MEMMGR,
+            size_type       theChunkSize = eDefaultChunkSize);
+
+    static XalanChunkedOutputStream*
+    create(
+            MemoryManager&  theManager,
+            size_type       theChunkSize = eDefaultChunkSize);
+
+    virtual
+    ~XalanChunkedOutputStream();
+
+    /**
+     * Get the number of chunks that contain output.
+     *
+     * @return The number of chunks.
+     */
+    size_type
+    getChunkCount() const
+    {
+        return size_type(m_chunks.size());
+    }
+
+    /**
+     * Get the data in a chunk.
+     *
+     * @param theIndex The index of the chunk.
+     * @return A pointer to the data.
+     */
+    const char*
+    getChunkData(size_type  theIndex) const
+    {
+        assert(theIndex < m_chunks.size());
+
+        return m_chunks[theIndex].m_data;
+    }
+
+    /**
+     * Get the number of bytes in a chunk.
+     *
+     * @param theIndex The index of the chunk.
+     * @return The size of the chunk.
+     */
+    size_type
+    getChunkSize(size_type  theIndex) const
+    {
+        assert(theIndex < m_chunks.size());
+
+        return m_chunks[theIndex].m_size;
+    }
+
+    /**
+     * Get the total number of bytes written.
+     *
+     * @return The size of the output.
+     */
+    size_type
+    getSize() const
+    {
+        return m_size;
+    }
+
+    /**
+     * Discard the output and free the chunks.
+     */
+    void
+    clear();
+
+    virtual char*
+    getDirectBuffer(
+            size_type   theMinimumSize,
+            size_type&  theSize);
+
+    virtual void
+    commitDirectBuffer(size_type    theCount);
+
+private:
+
+    // These are not implemented...
+    XalanChunkedOutputStream(const XalanChunkedOutputStream&);
+
+    XalanChunkedOutputStream&
+    operator=(const XalanChunkedOutputStream&);
+
+    struct Chunk
+    {
+        char*       m_data;
+
+        size_type   m_size;
+
+        size_type   m_capacity;
+    };
+
+    typedef XalanVector<Chunk>  ChunkVectorType;
+
+    // Data members...
+    const size_type     m_chunkSize;
+
+    ChunkVectorType     m_chunks;
+
+    size_type           m_size;
+};
+
+
+
+}
+
+
+
+#endif  // XALANCHUNKEDOUTPUTSTREAM_HEADER_GUARD_1357924680
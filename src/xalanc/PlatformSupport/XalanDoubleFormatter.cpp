@@ -0,0 +1,742 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Class header file.
+#include "XalanDoubleFormatter.hpp"
+
+
+
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+
+
+#include "XalanUnicode.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+// This is the Grisu3 algorithm from Florian Loitsch's paper "Printing
+// Floating-Point Numbers Quickly and Accurately with Integers".  It finds
+// the shortest string that converts back to the original value using only
+// 64-bit integer arithmetic, and detects the small fraction of values for
+// which it can't be sure.  Those are checked with the C library.
+
+
+
+// A floating point value f * 2^e with a 64-bit significand.
+struct DiyFp
+{
+    DiyFp(
+            XMLUInt64   f,
+            int         e) :
+        m_f(f),
+        m_e(e)
+    {
+    }
+
+    XMLUInt64   m_f;
+
+    int         m_e;
+};
+
+
+
+struct CachedPower
+{
+    XMLUInt64   m_f;
+
+    int         m_e;
+
+    int         m_k;
+};
+
+
+
+// Normalized approximations of 10^k for k = -300, -292, ..., 324.
+static const CachedPower    theCachedPowers[] =
+{
+        { 0xAB70FE17C79AC6CAull, -1060, -300 },
+        { 0xFF77B1FCBEBCDC4Full, -1034, -292 },
+        { 0xBE5691EF416BD60Cull, -1007, -284 },
+        { 0x8DD01FAD907FFC3Cull,  -980, -276 },
+        { 0xD3515C2831559A83ull,  -954, -268 },
+        { 0x9D71AC8FADA6C9B5ull,  -927, -260 },
+        { 0xEA9C227723EE8BCBull,  -901, -252 },
+        { 0xAECC49914078536Dull,  -874, -244 },
+        { 0x823C12795DB6CE57ull,  -847, -236 },
+        { 0xC21094364DFB5637ull,  -821, -228 },
+        { 0x9096EA6F3848984Full,  -794, -220 },
+        { 0xD77485CB25823AC7ull,  -768, -212 },
+        { 0xA086CFCD97BF97F4ull,  -741, -204 },
+        { 0xEF340A98172AACE5ull,  -715, -196 },
+        { 0xB23867FB2A35B28Eull,  -688, -188 },
+        { 0x84C8D4DFD2C63F3Bull,  -661, -180 },
+        { 0xC5DD44271AD3CDBAull,  -635, -172 },
+        { 0x936B9FCEBB25C996ull,  -608, -164 },
+        { 0xDBAC6C247D62A584ull,  -582, -156 },
+        { 0xA3AB66580D5FDAF6ull,  -555, -148 },
+        { 0xF3E2F893DEC3F126ull,  -529, -140 },
+        { 0xB5B5ADA8AAFF80B8ull,  -502, -132 },
+        { 0x87625F056C7C4A8Bull,  -475, -124 },
+        { 0xC9BCFF6034C13053ull,  -449, -116 },
+        { 0x964E858C91BA2655ull,  -422, -108 },
+        { 0xDFF9772470297EBDull,  -396, -100 },
+        { 0xA6DFBD9FB8E5B88Full,  -369,  -92 },
+        { 0xF8A95FCF88747D94ull,  -343,  -84 },
+        { 0xB94470938FA89BCFull,  -316,  -76 },
+        { 0x8A08F0F8BF0F156Bull,  -289,  -68 },
+        { 0xCDB02555653131B6ull,  -263,  -60 },
+        { 0x993FE2C6D07B7FACull,  -236,  -52 },
+        { 0xE45C10C42A2B3B06ull,  -210,  -44 },
+        { 0xAA242499697392D3ull,  -183,  -36 },
+        { 0xFD87B5F28300CA0Eull,  -157,  -28 },
+        { 0xBCE5086492111AEBull,  -130,  -20 },
+        { 0x8CBCCC096F5088CCull,  -103,  -12 },
+        { 0xD1B71758E219652Cull,   -77,   -4 },
+        { 0x9C40000000000000ull,   -50,    4 },
+        { 0xE8D4A51000000000ull,   -24,   12 },
+        { 0xAD78EBC5AC620000ull,     3,   20 },
+        { 0x813F3978F8940984ull,    30,   28 },
+        { 0xC097CE7BC90715B3ull,    56,   36 },
+        { 0x8F7E32CE7BEA5C70ull,    83,   44 },
+        { 0xD5D238A4ABE98068ull,   109,   52 },
+        { 0x9F4F2726179A2245ull,   136,   60 },
+        { 0xED63A231D4C4FB27ull,   162,   68 },
+        { 0xB0DE65388CC8ADA8ull,   189,   76 },
+        { 0x83C7088E1AAB65DBull,   216,   84 },
+        { 0xC45D1DF942711D9Aull,   242,   92 },
+        { 0x924D692CA61BE758ull,   269,  100 },
+        { 0xDA01EE641A708DEAull,   295,  108 },
+        { 0xA26DA3999AEF774Aull,   322,  116 },
+        { 0xF209787BB47D6B85ull,   348,  124 },
+        { 0xB454E4A179DD1877ull,   375,  132 },
+        { 0x865B86925B9BC5C2ull,   402,  140 },
+        { 0xC83553C5C8965D3Dull,   428,  148 },
+        { 0x952AB45CFA97A0B3ull,   455,  156 },
+        { 0xDE469FBD99A05FE3ull,   481,  164 },
+        { 0xA59BC234DB398C25ull,   508,  172 },
+        { 0xF6C69A72A3989F5Cull,   534,  180 },
+        { 0xB7DCBF5354E9BECEull,   561,  188 },
+        { 0x88FCF317F22241E2ull,   588,  196 },
+        { 0xCC20CE9BD35C78A5ull,   614,  204 },
+        { 0x98165AF37B2153DFull,   641,  212 },
+        { 0xE2A0B5DC971F303Aull,   667,  220 },
+        { 0xA8D9D1535CE3B396ull,   694,  228 },
+        { 0xFB9B7CD9A4A7443Cull,   720,  236 },
+        { 0xBB764C4CA7A44410ull,   747,  244 },
+        { 0x8BAB8EEFB6409C1Aull,   774,  252 },
+        { 0xD01FEF10A657842Cull,   800,  260 },
+        { 0x9B10A4E5E9913129ull,   827,  268 },
+        { 0xE7109BFBA19C0C9Dull,   853,  276 },
+        { 0xAC2820D9623BF429ull,   880,  284 },
+        { 0x80444B5E7AA7CF85ull,   907,  292 },
+        { 0xBF21E44003ACDD2Dull,   933,  300 },
+        { 0x8E679C2F5E44FF8Full,   960,  308 },
+        { 0xD433179D9C8CB841ull,   986,  316 },
+        { 0x9E19DB92B4E31BA9ull,  1013,  324 },
+};
+
+static const int    theCachedPowersMinDecimalExponent = -300;
+
+static const int    theCachedPowersDecimalStep = 8;
+
+// The range for the binary exponent of the scaled upper boundary.
+static const int    theAlpha = -60;
+
+static const int    theGamma = -32;
+
+
+
+inline DiyFp
+subtract(
+            const DiyFp&    x,
+            const DiyFp&    y)
+{
+    assert(x.m_e == y.m_e);
+    assert(x.m_f >= y.m_f);
+
+    return DiyFp(x.m_f - y.m_f, x.m_e);
+}
+
+
+
+// Returns x * y, rounded to 64 bits.
+inline DiyFp
+multiply(
+            const DiyFp&    x,
+            const DiyFp&    y)
+{
+    const XMLUInt64     theMask = 0xFFFFFFFFu;
+
+    const XMLUInt64     u_lo = x.m_f & theMask;
+    const XMLUInt64     u_hi = x.m_f >> 32;
+    const XMLUInt64     v_lo = y.m_f & theMask;
+    const XMLUInt64     v_hi = y.m_f >> 32;
+
+    const XMLUInt64     p0 = u_lo * v_lo;
+    const XMLUInt64     p1 = u_lo * v_hi;
+    const XMLUInt64     p2 = u_hi * v_lo;
+    const XMLUInt64     p3 = u_hi * v_hi;
+
+    XMLUInt64   theMiddle = (p0 >> 32) + (p1 & theMask) + (p2 & theMask);
+
+    // Round the discarded low half.
+    theMiddle += XMLUInt64(1) << 31;
+
+    return DiyFp(
+            p3 + (p1 >> 32) + (p2 >> 32) + (theMiddle >> 32),
+            x.m_e + y.m_e + 64);
+}
+
+
+
+inline DiyFp
+normalize(DiyFp     x)
+{
+    assert(x.m_f != 0);
+
+    while ((x.m_f >> 63) == 0)
+    {
+        x.m_f <<= 1;
+        --x.m_e;
+    }
+
+    return x;
+}
+
+
+
+inline DiyFp
+normalizeTo(
+            const DiyFp&    x,
+            int             theExponent)
+{
+    const int   theDelta = x.m_e - theExponent;
+
+    assert(theDelta >= 0);
+    assert(((x.m_f << theDelta) >> theDelta) == x.m_f);
+
+    return DiyFp(x.m_f << theDelta, theExponent);
+}
+
+
+
+// Computes the normalized value and the boundaries m- and m+ of the
+// interval of real numbers that round to it.  Both boundaries share the
+// exponent of m+.
+static void
+computeBoundaries(
+            double      theValue,
+            DiyFp&      theNormalizedValue,
+            DiyFp&      theLowerBoundary,
+            DiyFp&      theUpperBoundary)
+{
+    const int           theBias = 1023 + 52;
+    const XMLUInt64     theHiddenBit = XMLUInt64(1) << 52;
+
+    XMLUInt64   theBits;
+
+    assert(sizeof(theBits) == sizeof(theValue));
+
+    std::memcpy(&theBits, &theValue, sizeof(theBits));
+
+    const XMLUInt64     E = (theBits >> 52) & 0x7FF;
+    const XMLUInt64     F = theBits & (theHiddenBit - 1);
+
+    const DiyFp     v = E == 0 ?
+        DiyFp(F, 1 - theBias) :
+        DiyFp(F + theHiddenBit, int(E) - theBias);
+
+    // The lower boundary is closer when the significand is a power of two,
+    // since the gap to the next smaller double is half as wide.
+    const bool  fLowerIsCloser = F == 0 && E > 1;
+
+    const DiyFp     theUpper = normalize(DiyFp(2 * v.m_f + 1, v.m_e - 1));
+
+    const DiyFp     theLower = fLowerIsCloser ?
+        DiyFp(4 * v.m_f - 1, v.m_e - 2) :
+        DiyFp(2 * v.m_f - 1, v.m_e - 1);
+
+    theNormalizedValue = normalize(v);
+    theLowerBoundary = normalizeTo(theLower, theUpper.m_e);
+    theUpperBoundary = theUpper;
+}
+
+
+
+// Returns a cached power c = 10^k such that the binary exponent of
+// c * 2^e lies in [theAlpha, theGamma].
+static const CachedPower&
+getCachedPower(int  e)
+{
+    const int   f = theAlpha - e - 1;
+
+    // ceil(f * log10(2))
+    const int   k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+
+    const int   theIndex =
+        (-theCachedPowersMinDecimalExponent + k + (theCachedPowersDecimalStep - 1)) /
+            theCachedPowersDecimalStep;
+
+    assert(theIndex >= 0);
+    assert(theIndex < int(sizeof(theCachedPowers) / sizeof(theCachedPowers[0])));
+
+    const CachedPower&  theResult = theCachedPowers[theIndex];
+
+    assert(theAlpha <= theResult.m_e + e + 64);
+    assert(theGamma >= theResult.m_e + e + 64);
+
+    return theResult;
+}
+
+
+
+// Returns the number of decimal digits in n, and sets thePower to
+// 10^(digits - 1).
+inline int
+findLargestPowerOf10(
+            XMLUInt32   n,
+            XMLUInt32&  thePower)
+{
+    int         theDigits = 10;
+    XMLUInt32   theCurrent = 1000000000u;
+
+    while (theDigits > 1 && n < theCurrent)
+    {
+        --theDigits;
+        theCurrent /= 10;
+    }
+
+    thePower = theCurrent;
+
+    return theDigits;
+}
+
+
+
+// Moves the last digit toward w while the shortened representation stays
+// inside the unsafe interval.  Returns false if the result cannot be
+// proven to be both inside the rounding interval and the closest such
+// representation to the value, so the caller must fall back to an exact
+// method.
+static bool
+roundWeed(
+            char*       theDigits,
+            int         theLength,
+            XMLUInt64   theDistanceTooHighW,
+            XMLUInt64   theUnsafeInterval,
+            XMLUInt64   theRest,
+            XMLUInt64   theTenKappa,
+            XMLUInt64   theUnit)
+{
+    assert(theLength >= 1);
+
+    const XMLUInt64     theSmallDistance = theDistanceTooHighW - theUnit;
+    const XMLUInt64     theBigDistance = theDistanceTooHighW + theUnit;
+
+    assert(theRest <= theUnsafeInterval);
+
+    while (theRest < theSmallDistance &&
+           theUnsafeInterval - theRest >= theTenKappa &&
+           (theRest + theTenKappa < theSmallDistance ||
+            theSmallDistance - theRest >= theRest + theTenKappa - theSmallDistance))
+    {
+        --theDigits[theLength - 1];
+
+        theRest += theTenKappa;
+    }
+
+    // If a further step would also be closer to the far end of the
+    // uncertainty, we can't tell which representation is right.
+    if (theRest < theBigDistance &&
+        theUnsafeInterval - theRest >= theTenKappa &&
+        (theRest + theTenKappa < theBigDistance ||
+         theBigDistance - theRest > theRest + theTenKappa - theBigDistance))
+    {
+        return false;
+    }
+
+    // The representation must be safely inside the rounding interval.
+    return 2 * theUnit <= theRest && theRest <= theUnsafeInterval - 4 * theUnit;
+}
+
+
+
+// Generates the shortest digits inside the scaled boundaries that are
+// closest to w.  On success, the value is theDigits * 10^theKappa, with
+// theKappa relative to the scaling.
+static bool
+generateDigits(
+            char*           theDigits,
+            int&            theLength,
+            int&            theKappa,
+            const DiyFp&    theLower,
+            const DiyFp&    w,
+            const DiyFp&    theUpper)
+{
+    assert(theLower.m_e == w.m_e && w.m_e == theUpper.m_e);
+    assert(theUpper.m_e >= theAlpha);
+    assert(theUpper.m_e <= theGamma);
+
+    // The scaled values may be off by one unit in either direction, so
+    // widen the interval to include every value that might be inside.
+    XMLUInt64   theUnit = 1;
+
+    const DiyFp     theTooLow(theLower.m_f - theUnit, theLower.m_e);
+    const DiyFp     theTooHigh(theUpper.m_f + theUnit, theUpper.m_e);
+
+    XMLUInt64   theUnsafeInterval = subtract(theTooHigh, theTooLow).m_f;
+
+    const int           theShift = -w.m_e;
+    const XMLUInt64     theOne = XMLUInt64(1) << theShift;
+
+    // Split the upper bound into its integral and fractional parts.
+    XMLUInt32   theIntegrals = XMLUInt32(theTooHigh.m_f >> theShift);
+    XMLUInt64   theFractionals = theTooHigh.m_f & (theOne - 1);
+
+    XMLUInt32   theDivisor = 0;
+
+    theKappa = findLargestPowerOf10(theIntegrals, theDivisor);
+    theLength = 0;
+
+    while (theKappa > 0)
+    {
+        const XMLUInt32     theDigit = theIntegrals / theDivisor;
+
+        assert(theDigit <= 9);
+
+        theDigits[theLength++] = char('0' + theDigit);
+
+        theIntegrals %= theDivisor;
+
+        --theKappa;
+
+        const XMLUInt64     theRest =
+            (XMLUInt64(theIntegrals) << theShift) + theFractionals;
+
+        if (theRest < theUnsafeInterval)
+        {
+            return roundWeed(
+                        theDigits,
+                        theLength,
+                        subtract(theTooHigh, w).m_f,
+                        theUnsafeInterval,
+                        theRest,
+                        XMLUInt64(theDivisor) << theShift,
+                        theUnit);
+        }
+
+        theDivisor /= 10;
+    }
+
+    // The integral part was not enough, so continue with the fractional
+    // digits until the remainder falls inside the interval.
+    for (;;)
+    {
+        theFractionals *= 10;
+        theUnit *= 10;
+        theUnsafeInterval *= 10;
+
+        const XMLUInt64     theDigit = theFractionals >> theShift;
+
+        assert(theDigit <= 9);
+
+        theDigits[theLength++] = char('0' + theDigit);
+
+        theFractionals &= theOne - 1;
+
+        --theKappa;
+
+        if (theFractionals < theUnsafeInterval)
+        {
+            return roundWeed(
+                        theDigits,
+                        theLength,
+                        subtract(theTooHigh, w).m_f * theUnit,
+                        theUnsafeInterval,
+                        theFractionals,
+                        theOne,
+                        theUnit);
+        }
+    }
+}
+
+
+
+// Shortens digits that are known to convert back to the value, using the
+// C library to check whether one fewer digit would also do.  This is only
+// needed for the rare values where generateDigits() cannot decide.  On
+// return, the value is theDigits * 10^theDecimalExponent.
+static void
+shortenDigits(
+            double  theValue,
+            char*   theDigits,
+            int&    theLength,
+            int&    theDecimalExponent)
+{
+    char    theBuffer[40];
+
+    while (theLength > 1)
+    {
+        std::snprintf(theBuffer, sizeof(theBuffer), "%.*e", theLength - 2, theValue);
+
+        if (std::strtod(theBuffer, 0) != theValue)
+        {
+            break;
+        }
+
+        // The result looks like "d.ddde+xx", but the decimal point depends
+        // on the locale, so just collect the digits before the exponent.
+        const char*     theCurrent = theBuffer;
+
+        theLength = 0;
+
+        for (; *theCurrent != 'e'; ++theCurrent)
+        {
+            if (*theCurrent >= '0' && *theCurrent <= '9')
+            {
+                theDigits[theLength++] = *theCurrent;
+            }
+        }
+
+        theDecimalExponent = std::atoi(theCurrent + 1) - (theLength - 1);
+    }
+}
+
+
+
+// Writes the exact decimal digits of an integral value of at least 2^53.
+// Every digit is significant, as it is for smaller integers, rather than
+// the shortest digits followed by zeros.
+static XalanDOMChar*
+formatInteger(
+            double          theValue,
+            XalanDOMChar*   theOutput)
+{
+    XMLUInt64   theBits;
+
+    std::memcpy(&theBits, &theValue, sizeof(theBits));
+
+    const XMLUInt64     theHiddenBit = XMLUInt64(1) << 52;
+
+    int     theExponent = int((theBits >> 52) & 0x7FF) - (1023 + 52);
+    assert(theExponent > 0);
+
+    // The value in base 10^9, least significant limb first.
+    const XMLUInt64     theBase = 1000000000;
+
+    XMLUInt64   theLimbs[36];
+
+    const XMLUInt64     theSignificand = (theBits & (theHiddenBit - 1)) + theHiddenBit;
+
+    theLimbs[0] = theSignificand % theBase;
+    theLimbs[1] = theSignificand / theBase % theBase;
+    theLimbs[2] = theSignificand / theBase / theBase;
+
+    int     theLimbCount = theLimbs[2] != 0 ? 3 : 2;
+
+    while (theExponent > 0)
+    {
+        const int   theShift = theExponent < 32 ? theExponent : 32;
+
+        XMLUInt64   theCarry = 0;
+
+        for (int i = 0; i < theLimbCount; ++i)
+        {
+            const XMLUInt64     theProduct = (theLimbs[i] << theShift) + theCarry;
+
+            theLimbs[i] = theProduct % theBase;
+            theCarry = theProduct / theBase;
+        }
+
+        while (theCarry != 0)
+        {
+            assert(theLimbCount < int(sizeof(theLimbs) / sizeof(theLimbs[0])));
+
+            theLimbs[theLimbCount++] = theCarry % theBase;
+            theCarry /= theBase;
+        }
+
+        theExponent -= theShift;
+    }
+
+    char    theDigits[10];
+
+    for (int i = theLimbCount - 1; i >= 0; --i)
+    {
+        const int   theLength =
+            std::snprintf(
+                theDigits,
+                sizeof(theDigits),
+                i == theLimbCount - 1 ? "%u" : "%09u",
+                static_cast<unsigned int>(theLimbs[i]));
+
+        for (int j = 0; j < theLength; ++j)
+        {
+            *theOutput++ = XalanDOMChar(theDigits[j] - '0' + XalanUnicode::charDigit_0);
+        }
+    }
+
+    return theOutput;
+}
+
+
+
+XalanDoubleFormatter::size_type
+XalanDoubleFormatter::format(
+            double          theValue,
+            XalanDOMChar*   theBuffer)
+{
+    assert(theValue == theValue);
+    assert(theValue != 0);
+    assert(theValue - theValue == 0);
+
+    XalanDOMChar*   theOutput = theBuffer;
+
+    if (theValue < 0)
+    {
+        *theOutput++ = XalanUnicode::charHyphenMinus;
+
+        theValue = -theValue;
+    }
+
+    if (theValue >= 9007199254740992.0)
+    {
+        theOutput = formatInteger(theValue, theOutput);
+
+        assert(theOutput - theBuffer <= eMaxCharacters);
+
+        return size_type(theOutput - theBuffer);
+    }
+
+    DiyFp   v(0, 0);
+    DiyFp   theLower(0, 0);
+    DiyFp   theUpper(0, 0);
+
+    computeBoundaries(theValue, v, theLower, theUpper);
+
+    const CachedPower&  theCachedPower = getCachedPower(theUpper.m_e);
+
+    const DiyFp     c(theCachedPower.m_f, theCachedPower.m_e);
+
+    const DiyFp     w = multiply(v, c);
+    const DiyFp     theScaledLower = multiply(theLower, c);
+    const DiyFp     theScaledUpper = multiply(theUpper, c);
+
+    char    theDigits[20];
+    int     theLength = 0;
+    int     theKappa = 0;
+    int     theDecimalExponent = 0;
+
+    if (generateDigits(
+            theDigits,
+            theLength,
+            theKappa,
+            theScaledLower,
+            w,
+            theScaledUpper) == true)
+    {
+        theDecimalExponent = theKappa - theCachedPower.m_k;
+    }
+    else
+    {
+        // Generate again, keeping two units inside the boundaries, so the
+        // digits are certain to convert back to the value, even if they
+        // might not be the shortest.
+        generateDigits(
+            theDigits,
+            theLength,
+            theKappa,
+            DiyFp(theScaledLower.m_f + 2, theScaledLower.m_e),
+            w,
+            DiyFp(theScaledUpper.m_f - 2, theScaledUpper.m_e));
+
+        theDecimalExponent = theKappa - theCachedPower.m_k;
+
+        shortenDigits(
+            theValue,
+            theDigits,
+            theLength,
+            theDecimalExponent);
+    }
+
+    assert(theLength > 0 && theLength <= 17);
+
+    // XPath never shows trailing zeros after the decimal point.
+    while (theLength > 1 && theDigits[theLength - 1] == '0')
+    {
+        --theLength;
+        ++theDecimalExponent;
+    }
+
+    // The number of digits before the decimal point.
+    const int   thePoint = theLength + theDecimalExponent;
+
+    if (thePoint <= 0)
+    {
+        *theOutput++ = XalanUnicode::charDigit_0;
+        *theOutput++ = XalanUnicode::charFullStop;
+
+        for (int i = thePoint; i < 0; ++i)
+        {
+            *theOutput++ = XalanUnicode::charDigit_0;
+        }
+
+        for (int i = 0; i < theLength; ++i)
+        {
+            *theOutput++ = XalanDOMChar(theDigits[i] - '0' + XalanUnicode::charDigit_0);
+        }
+    }
+    else if (thePoint >= theLength)
+    {
+        for (int i = 0; i < theLength; ++i)
+        {
+            *theOutput++ = XalanDOMChar(theDigits[i] - '0' + XalanUnicode::charDigit_0);
+        }
+
+        for (int i = theLength; i < thePoint; ++i)
+        {
+            *theOutput++ = XalanUnicode::charDigit_0;
+        }
+    }
+    else
+    {
+        for (int i = 0; i < theLength; ++i)
+        {
+            if (i == thePoint)
+            {
+                *theOutput++ = XalanUnicode::charFullStop;
+            }
+
+            *theOutput++ = XalanDOMChar(theDigits[i] - '0' + XalanUnicode::charDigit_0);
+        }
+    }
+
+    assert(theOutput - theBuffer <= eMaxCharacters);
+
+    return size_type(theOutput - theBuffer);
+}
+
+
+
+}
@@ -0,0 +1,79 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANDOUBLEFORMATTER_HEADER_GUARD_1357924680)
+#define XALANDOUBLEFORMATTER_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/PlatformSupport/PlatformSupportDefinitions.hpp>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * Formats doubles as the shortest decimal string that converts back to
+ * the same value, using the Grisu3 algorithm.  The output is in the
+ * fixed notation required by the XPath string() function, so it never
+ * contains an exponent.  Values of 2^53 and above are integers, and
+ * are written with all of their exact digits instead.
+ */
+class XALAN_PLATFORMSUPPORT_EXPORT XalanDoubleFormatter
+{
+public:
+
+    typedef XalanDOMString::size_type   size_type;
+
+    enum
+    {
+        /**
+         * The largest number of characters format() will write: a sign,
+         * "0.", 323 leading zeros and 17 significant digits, which also
+         * covers the 309 digits of the largest finite value.
+         */
+        eMaxCharacters = 350
+    };
+
+    /**
+     * Format a finite, non-zero value.  The result is not
+     * null-terminated.
+     *
+     * @param theValue The value to format.
+     * @param theBuffer A buffer of at least eMaxCharacters characters.
+     * @return The number of characters written.
+     */
+    static size_type
+    format(
+            double          theValue,
+            XalanDOMChar*   theBuffer);
+};
+
+
+
+}
+
+
+
+#endif  // XALANDOUBLEFORMATTER_HEADER_GUARD_1357924680
@@ -0,0 +1,201 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Class header file...
+#include "XalanMemoryMappedFile.hpp"
+
+
+
+#if defined(XALAN_WINDOWS)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanMemoryMappedFile::XalanMemoryMappedFile(MemoryManager&     theManager) :
+    m_memoryManager(theManager),
+    m_data(0),
+    m_size(0)
+{
+}
+
+
+
+XalanMemoryMappedFile::~XalanMemoryMappedFile()
+{
+    close();
+}
+
+
+
+#if defined(XALAN_WINDOWS)
+
+bool
+XalanMemoryMappedFile::open(const XalanDOMString&   theFileName)
+{
+    close();
+
+    const HANDLE    theFileHandle = CreateFileW(
+            reinterpret_cast<const wchar_t *>(theFileName.c_str()),
+            GENERIC_READ,
+            FILE_SHARE_READ,
+            0,
+            OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL,
+            0);
+
+    if (theFileHandle == INVALID_HANDLE_VALUE || theFileHandle == 0)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER   theFileSize;
+
+    if (GetFileSizeEx(theFileHandle, &theFileSize) == 0 ||
+        theFileSize.QuadPart == 0 ||
+        static_cast<ULONGLONG>(theFileSize.QuadPart) > static_cast<size_type>(-1))
+    {
+        CloseHandle(theFileHandle);
+
+        return false;
+    }
+
+    const HANDLE    theMappingHandle = CreateFileMapping(
+            theFileHandle,
+            0,
+            PAGE_READONLY,
+            0,
+            0,
+            0);
+
+    // The view keeps the file and the mapping open, so
+    // neither handle is needed once the view exists.
+    CloseHandle(theFileHandle);
+
+    if (theMappingHandle == 0)
+    {
+        return false;
+    }
+
+    m_data = MapViewOfFile(theMappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+    CloseHandle(theMappingHandle);
+
+    if (m_data == 0)
+    {
+        return false;
+    }
+
+    m_size = static_cast<size_type>(theFileSize.QuadPart);
+
+    return true;
+}
+
+
+
+void
+XalanMemoryMappedFile::close()
+{
+    if (m_data != 0)
+    {
+        UnmapViewOfFile(m_data);
+
+        m_data = 0;
+        m_size = 0;
+    }
+}
+
+#else
+
+bool
+XalanMemoryMappedFile::open(const XalanDOMString&   theFileName)
+{
+    close();
+
+    CharVectorType  theResult(m_memoryManager);
+    TranscodeToLocalCodePage(theFileName, theResult, true);
+
+    if (theResult.empty() == true)
+    {
+        return false;
+    }
+
+    const int   theFileDescriptor = ::open(&theResult[0], O_RDONLY);
+
+    if (theFileDescriptor == -1)
+    {
+        return false;
+    }
+
+    struct stat     theStatus;
+
+    if (fstat(theFileDescriptor, &theStatus) != 0 ||
+        theStatus.st_size <= 0)
+    {
+        ::close(theFileDescriptor);
+
+        return false;
+    }
+
+    const size_type     theSize = static_cast<size_type>(theStatus.st_size);
+
+    void* const     theData =
+        mmap(0, theSize, PROT_READ, MAP_SHARED, theFileDescriptor, 0);
+
+    // The mapping keeps the file open, so the descriptor
+    // is not needed once the mapping exists.
+    ::close(theFileDescriptor);
+
+    if (theData == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_data = theData;
+    m_size = theSize;
+
+    return true;
+}
+
+
+
+void
+XalanMemoryMappedFile::close()
+{
+    if (m_data != 0)
+    {
+        munmap(m_data, m_size);
+
+        m_data = 0;
+        m_size = 0;
+    }
+}
+
+#endif
+
+
+
+}
@@ -0,0 +1,116 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANMEMORYMAPPEDFILE_HEADER_GUARD_1357924680)
+#define XALANMEMORYMAPPEDFILE_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/PlatformSupport/PlatformSupportDefinitions.hpp>
+
+
+
+#include <cstddef>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * A read-only view of the contents of a file, which is mapped into
+ * memory rather than read, so the pages are shared with other
+ * processes mapping the same file and are only loaded when they're
+ * touched.
+ */
+class XALAN_PLATFORMSUPPORT_EXPORT XalanMemoryMappedFile
+{
+public:
+
+    typedef std::size_t     size_type;
+
+    XalanMemoryMappedFile(MemoryManager&    theManager);
+
+    ~XalanMemoryMappedFile();
+
+    /**
+     * Map a file.  Any file that is already mapped is unmapped first.
+     *
+     * @param theFileName The name of the file
+     * @return true if the file was mapped, false if the file could not be opened, or is empty.
+     */
+    bool
+    open(const XalanDOMString&  theFileName);
+
+    /**
+     * Unmap the file, if one is mapped.  Any pointers into the
+     * contents of the file are no longer valid.
+     */
+    void
+    close();
+
+    bool
+    isOpen() const
+    {
+        return m_data != 0;
+    }
+
+    const void*
+    getData() const
+    {
+        return m_data;
+    }
+
+    size_type
+    getSize() const
+    {
+        return m_size;
+    }
+
+private:
+
+    // These are not implemented...
+    XalanMemoryMappedFile(const XalanMemoryMappedFile&);
+
+    XalanMemoryMappedFile&
+    operator=(const XalanMemoryMappedFile&);
+
+    bool
+    operator==(const XalanMemoryMappedFile&) const;
+
+
+    // Data members...
+    MemoryManager&  m_memoryManager;
+
+    void*           m_data;
+
+    size_type       m_size;
+};
+
+
+
+}
+
+
+
+#endif  // XALANMEMORYMAPPEDFILE_HEADER_GUARD_1357924680
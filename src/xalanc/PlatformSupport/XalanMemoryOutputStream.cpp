@@ -0,0 +1,145 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+// Class header file...
+#include "XalanMemoryOutputStream.hpp"
+
+
+
+#include <cstring>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanMemoryOutputStream::XalanMemoryOutputStream(
+            MemoryManager&  theManager,
+            size_type       theInitialCapacity) :
+    XalanBufferOutputStream(theManager),
+    m_initialCapacity(theInitialCapacity == 0 ? 1 : theInitialCapacity),
+    m_data(0),
+    m_size(0),
+    m_capacity(0)
+{
+}
+
+
+
+XalanMemoryOutputStream*
+XalanMemoryOutputStream::create(
+            MemoryManager&  theManager,
+            size_type       theInitialCapacity)
+{
+    typedef XalanMemoryOutputStream     ThisType;
+
+    XalanAllocationGuard    theGuard(theManager, theManager.allocate(sizeof(ThisType)));
+
+    ThisType* const     theResult =
+        new (theGuard.get()) ThisType(
+                        theManager,
+                        theInitialCapacity);
+
+    theGuard.release();
+
+    return theResult;
+}
+
+
+
+XalanMemoryOutputStream::~XalanMemoryOutputStream()
+{
+    if (m_data != 0)
+    {
+        getMemoryManager().deallocate(m_data);
+    }
+}
+
+
+
+char*
+XalanMemoryOutputStream::release(size_type&     theSize)
+{
+    char* const     theResult = m_data;
+
+    theSize = m_size;
+
+    m_data = 0;
+    m_size = 0;
+    m_capacity = 0;
+
+    return theResult;
+}
+
+
+
+char*
+XalanMemoryOutputStream::getDirectBuffer(
+            size_type   theMinimumSize,
+            size_type&  theSize)
+{
+    if (m_capacity - m_size < theMinimumSize)
+    {
+        grow(m_size + theMinimumSize);
+    }
+
+    theSize = m_capacity - m_size;
+
+    return m_data + m_size;
+}
+
+
+
+void
+XalanMemoryOutputStream::commitDirectBuffer(size_type   theCount)
+{
+    assert(theCount <= m_capacity - m_size);
+
+    m_size += theCount;
+}
+
+
+
+void
+XalanMemoryOutputStream::grow(size_type     theMinimumCapacity)
+{
+    size_type   theNewCapacity =
+        m_capacity == 0 ? m_initialCapacity : m_capacity * 2;
+
+    if (theNewCapacity < theMinimumCapacity)
+    {
+        theNewCapacity = theMinimumCapacity;
+    }
+
+    char* const     theNewData =
+        static_cast<char*>(getMemoryManager().allocate(theNewCapacity));
+
+    if (m_data != 0)
+    {
+        std::memcpy(theNewData, m_data, m_size);
+
+        getMemoryManager().deallocate(m_data);
+    }
+
+    m_data = theNewData;
+    m_capacity = theNewCapacity;
+}
+
+
+
+}
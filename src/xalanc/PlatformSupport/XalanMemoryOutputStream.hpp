@@ -0,0 +1,145 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANMEMORYOUTPUTSTREAM_HEADER_GUARD_1357924680)
+#define XALANMEMORYOUTPUTSTREAM_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/PlatformSupport/PlatformSupportDefinitions.hpp>
+
+
+
+// Base class header file.
+#include <xalanc/PlatformSupport/XalanBufferOutputStream.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * An output stream that collects the output in a single contiguous,
+ * growable block of memory.  The block is owned by the stream until
+ * release() is called.
+ */
+class XALAN_PLATFORMSUPPORT_EXPORT XalanMemoryOutputStream : public XalanBufferOutputStream
+{
+public:
+
+    enum { eDefaultInitialCapacity = 4096u };
+
+    /**
+     * Construct a XalanMemoryOutputStream instance.
+     *
+     * @param theManager The MemoryManager instance for the block
+     * @param theInitialCapacity The initial size of the block
+     */
+    explicit
+    XalanMemoryOutputStream(
+            MemoryManager&  theManager XALAN_DEFAULT_MEMMGR,
+            size_type       theInitialCapacity = eDefaultInitialCapacity);
+
+    static XalanMemoryOutputStream*
+    create(
+            MemoryManager&  theManager,
+            size_type       theInitialCapacity = eDefaultInitialCapacity);
+
+    virtual
+    ~XalanMemoryOutputStream();
+
+    /**
+     * Get the output written so far.  The pointer is invalidated
+     * by any further output.
+     *
+     * @return A pointer to the output, or 0 if nothing has been written.
+     */
+    const char*
+    getData() const
+    {
+        return m_data;
+    }
+
+    /**
+     * Get the number of bytes written so far.
+     *
+     * @return The size of the output.
+     */
+    size_type
+    getSize() const
+    {
+        return m_size;
+    }
+
+    /**
+     * Take ownership of the output.  The caller must free the memory
+     * using the MemoryManager instance supplied at construction, and
+     * the stream is left empty.
+     *
+     * @param theSize Set to the size of the output.
+     * @return A pointer to the output, or 0 if nothing has been written.
+     */
+    char*
+    release(size_type&  theSize);
+
+    /**
+     * Discard the output, but keep the memory for reuse.
+     */
+    void
+    clear()
+    {
+        m_size = 0;
+    }
+
+    virtual char*
+    getDirectBuffer(
+            size_type   theMinimumSize,
+            size_type&  theSize);
+
+    virtual void
+    commitDirectBuffer(size_type    theCount);
+
+private:
+
+    // These are not implemented...
+    XalanMemoryOutputStream(const XalanMemoryOutputStream&);
+
+    XalanMemoryOutputStream&
+    operator=(const XalanMemoryOutputStream&);
+
+    void
+    grow(size_type  theMinimumCapacity);
+
+    // Data members...
+    const size_type     m_initialCapacity;
+
+    char*               m_data;
+
+    size_type           m_size;
+
+    size_type           m_capacity;
+};
+
+
+
+}
+
+
+
+#endif  // XALANMEMORYOUTPUTSTREAM_HEADER_GUARD_1357924680
@@ -396,6 +396,28 @@ XalanOutputStream::setBufferSize(size_type  theBufferSize)
 
 
 
+char*
+XalanOutputStream::getDirectBuffer(
+            size_type   /* theMinimumSize */,
+            size_type&  theSize)
+{
+    theSize = 0;
+
+    return 0;
+}
+
+
+
+void
+XalanOutputStream::commitDirectBuffer(size_type     /* theCount */)
+{
+    // Since getDirectBuffer() never returns any memory,
+    // this should never be called.
+    assert(false);
+}
+
+
+
 void
 XalanOutputStream::newline()
 {
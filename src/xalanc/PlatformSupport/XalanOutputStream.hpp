@@ -284,6 +284,32 @@ public :
     void
     setBufferSize(size_type     theBufferSize);
 
+    /**
+     * Get memory that encoded bytes can be written into directly,
+     * instead of passing them to write().  The bytes become part of
+     * the output when commitDirectBuffer() is called, and the memory
+     * must not be used after that.  The caller is responsible for
+     * making sure the buffer is flushed before calling this member
+     * function.
+     *
+     * @param theMinimumSize The minimum number of bytes required.
+     * @param theSize Set to the number of bytes available.
+     * @return A pointer to the memory, or 0 if the stream does not support direct writes.
+     */
+    virtual char*
+    getDirectBuffer(
+            size_type   theMinimumSize,
+            size_type&  theSize);
+
+    /**
+     * Add bytes written into the memory returned by the last call
+     * to getDirectBuffer() to the output.
+     *
+     * @param theCount The number of bytes written, which may be 0.
+     */
+    virtual void
+    commitDirectBuffer(size_type    theCount);
+
 
     class XALAN_PLATFORMSUPPORT_EXPORT XalanOutputStreamException : public XSLException
     {
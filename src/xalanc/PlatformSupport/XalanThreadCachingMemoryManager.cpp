@@ -0,0 +1,616 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "XalanThreadCachingMemoryManager.hpp"
+
+
+
+#include <cassert>
+#include <mutex>
+#include <new>
+
+
+
+#include "xercesc/util/OutOfMemoryException.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+namespace
+{
+
+
+
+typedef XalanMemoryManager::size_type   size_type;
+
+
+
+// Every block starts with a header which records its size class,
+// so the returned pointer keeps the alignment of ::operator new.
+// This is the trade-off described in the class documentation: a
+// 16-byte block takes 32 bytes of its chunk.
+const size_type     theHeaderSize = 16;
+
+const size_type     theLargeClass = ~size_type(0);
+
+const size_type     theSizeClasses[] =
+{
+    16, 32, 48, 64, 80, 96, 112, 128,
+    144, 160, 176, 192, 208, 224, 240, 256,
+    320, 384, 448, 512,
+    640, 768, 896, 1024,
+    1280, 1536, 1792, 2048,
+    2560, 3072, 3584, 4096
+};
+
+const size_type     theSizeClassCount =
+    sizeof(theSizeClasses) / sizeof(theSizeClasses[0]);
+
+const size_type     theMaximumSmallSize = theSizeClasses[theSizeClassCount - 1];
+
+const size_type     theMinimumChunkSize = 64 * 1024;
+
+
+
+inline size_type
+getSizeClass(size_type  theSize)
+{
+    assert(theSize <= theMaximumSmallSize);
+
+    if (theSize <= 256)
+    {
+        return theSize == 0 ? 0 : (theSize + 15) / 16 - 1;
+    }
+    else
+    {
+        size_type   theClass = 16;
+
+        while (theSizeClasses[theClass] < theSize)
+        {
+            ++theClass;
+        }
+
+        return theClass;
+    }
+}
+
+
+
+// The number of blocks moved between a thread and the central
+// pool at a time.
+inline size_type
+getBatchSize(size_type  theClass)
+{
+    const size_type     theCount = 8192 / theSizeClasses[theClass];
+
+    return theCount < 4 ? 4 : theCount > 64 ? 64 : theCount;
+}
+
+
+
+inline size_type&
+getHeader(void*     thePointer)
+{
+    return *reinterpret_cast<size_type*>(static_cast<char*>(thePointer) - theHeaderSize);
+}
+
+
+
+// Free blocks are linked through their first word.
+struct FreeList
+{
+    FreeList() :
+        m_head(0),
+        m_count(0)
+    {
+    }
+
+    void
+    push(void*  theBlock)
+    {
+        *static_cast<void**>(theBlock) = m_head;
+
+        m_head = theBlock;
+
+        ++m_count;
+    }
+
+    void*
+    pop()
+    {
+        assert(m_head != 0 && m_count > 0);
+
+        void* const     theBlock = m_head;
+
+        m_head = *static_cast<void**>(theBlock);
+
+        --m_count;
+
+        return theBlock;
+    }
+
+    // Move theCount blocks from the front of this list to
+    // the front of theDestination.
+    void
+    transfer(
+            FreeList&   theDestination,
+            size_type   theCount)
+    {
+        assert(theCount > 0 && theCount <= m_count);
+
+        void*   theLast = m_head;
+
+        for (size_type i = 1; i < theCount; ++i)
+        {
+            theLast = *static_cast<void**>(theLast);
+        }
+
+        void* const     theRest = *static_cast<void**>(theLast);
+
+        *static_cast<void**>(theLast) = theDestination.m_head;
+
+        theDestination.m_head = m_head;
+        theDestination.m_count += theCount;
+
+        m_head = theRest;
+        m_count -= theCount;
+    }
+
+    void*       m_head;
+
+    size_type   m_count;
+};
+
+
+
+struct ThreadCache
+{
+    ThreadCache(XalanThreadCachingMemoryManager::CentralPool&   thePool) :
+        m_pool(thePool),
+        m_next(0)
+    {
+    }
+
+    XalanThreadCachingMemoryManager::CentralPool&   m_pool;
+
+    FreeList        m_lists[theSizeClassCount];
+
+    ThreadCache*    m_next;
+};
+
+
+
+}
+
+
+
+class XalanThreadCachingMemoryManager::CentralPool
+{
+public:
+
+    CentralPool(
+            MemoryManager&  theParent,
+            size_type       theChunkSize) :
+        m_mutex(),
+        m_parent(theParent),
+        m_chunkSize(theChunkSize < theMinimumChunkSize ? theMinimumChunkSize : theChunkSize),
+        m_chunks(0),
+        m_references(1),
+        m_alive(true)
+    {
+        m_statistics.m_chunks = 0;
+        m_statistics.m_chunkBytes = 0;
+        m_statistics.m_largeAllocations = 0;
+        m_statistics.m_largeDeallocations = 0;
+        m_statistics.m_batchFetches = 0;
+        m_statistics.m_batchReleases = 0;
+        m_statistics.m_threadCaches = 0;
+    }
+
+    ThreadCache*
+    createThreadCache()
+    {
+        // Thread caches can outlive the instance, and its parent, so
+        // they don't come from either.
+        ThreadCache* const  theCache = new (std::nothrow) ThreadCache(*this);
+
+        if (theCache == 0)
+        {
+            throw xercesc::OutOfMemoryException();
+        }
+
+        const std::lock_guard<std::mutex>   theLock(m_mutex);
+
+        ++m_references;
+        ++m_statistics.m_threadCaches;
+
+        return theCache;
+    }
+
+    // Called when the thread which owns a cache exits.
+    void
+    releaseThreadCache(ThreadCache*     theCache)
+    {
+        bool    fDelete = false;
+
+        {
+            const std::lock_guard<std::mutex>   theLock(m_mutex);
+
+            if (m_alive == true)
+            {
+                for (size_type i = 0; i < theSizeClassCount; ++i)
+                {
+                    FreeList&   theList = theCache->m_lists[i];
+
+                    if (theList.m_count > 0)
+                    {
+                        theList.transfer(m_lists[i], theList.m_count);
+                    }
+                }
+
+                --m_statistics.m_threadCaches;
+            }
+
+            fDelete = --m_references == 0;
+        }
+
+        delete theCache;
+
+        if (fDelete == true)
+        {
+            delete this;
+        }
+    }
+
+    // Called when the instance is destroyed.  The blocks in the
+    // thread caches belong to the chunks, so they must not be used
+    // after this.
+    void
+    shutdown()
+    {
+        bool    fDelete = false;
+
+        {
+            const std::lock_guard<std::mutex>   theLock(m_mutex);
+
+            m_alive = false;
+
+            while (m_chunks != 0)
+            {
+                void* const     theNext = *static_cast<void**>(m_chunks);
+
+                m_parent.deallocate(m_chunks);
+
+                m_chunks = theNext;
+            }
+
+            fDelete = --m_references == 0;
+        }
+
+        if (fDelete == true)
+        {
+            delete this;
+        }
+    }
+
+    void
+    fetchBatch(
+            size_type   theClass,
+            FreeList&   theList)
+    {
+        const size_type     theBatchSize = getBatchSize(theClass);
+
+        const std::lock_guard<std::mutex>   theLock(m_mutex);
+
+        FreeList&   theCentralList = m_lists[theClass];
+
+        while (theCentralList.m_count < theBatchSize)
+        {
+            carveChunk(theClass);
+        }
+
+        theCentralList.transfer(theList, theBatchSize);
+
+        ++m_statistics.m_batchFetches;
+    }
+
+    void
+    releaseBatch(
+            size_type   theClass,
+            FreeList&   theList)
+    {
+        const size_type     theBatchSize = getBatchSize(theClass);
+
+        FreeList    theBatch;
+
+        theList.transfer(theBatch, theBatchSize);
+
+        const std::lock_guard<std::mutex>   theLock(m_mutex);
+
+        theBatch.transfer(m_lists[theClass], theBatchSize);
+
+        ++m_statistics.m_batchReleases;
+    }
+
+    void*
+    allocateLarge(size_type     theSize)
+    {
+        char* const     theBlock =
+            static_cast<char*>(m_parent.allocate(theHeaderSize + theSize));
+
+        void* const     thePointer = theBlock + theHeaderSize;
+
+        getHeader(thePointer) = theLargeClass;
+
+        const std::lock_guard<std::mutex>   theLock(m_mutex);
+
+        ++m_statistics.m_largeAllocations;
+
+        return thePointer;
+    }
+
+    void
+    deallocateLarge(void*   thePointer)
+    {
+        m_parent.deallocate(static_cast<char*>(thePointer) - theHeaderSize);
+
+        const std::lock_guard<std::mutex>   theLock(m_mutex);
+
+        ++m_statistics.m_largeDeallocations;
+    }
+
+    void
+    getStatistics(Statistics&   theStatistics)
+    {
+        const std::lock_guard<std::mutex>   theLock(m_mutex);
+
+        theStatistics = m_statistics;
+    }
+
+private:
+
+    // Split a new chunk into blocks for the size class.  The
+    // chunks are linked through their first word.
+    void
+    carveChunk(size_type    theClass)
+    {
+        char* const     theChunk = static_cast<char*>(m_parent.allocate(m_chunkSize));
+
+        *reinterpret_cast<void**>(theChunk) = m_chunks;
+
+        m_chunks = theChunk;
+
+        const size_type     theBlockSize = theHeaderSize + theSizeClasses[theClass];
+
+        FreeList&   theCentralList = m_lists[theClass];
+
+        for (size_type theOffset = theHeaderSize;
+                theOffset + theBlockSize <= m_chunkSize;
+                    theOffset += theBlockSize)
+        {
+            void* const     thePointer = theChunk + theOffset + theHeaderSize;
+
+            getHeader(thePointer) = theClass;
+
+            theCentralList.push(thePointer);
+        }
+
+        ++m_statistics.m_chunks;
+        m_statistics.m_chunkBytes += m_chunkSize;
+    }
+
+    // Not implemented...
+    CentralPool(const CentralPool&);
+
+    CentralPool&
+    operator=(const CentralPool&);
+
+
+    // Data members...
+    std::mutex          m_mutex;
+
+    MemoryManager&      m_parent;
+
+    const size_type     m_chunkSize;
+
+    void*               m_chunks;
+
+    FreeList            m_lists[theSizeClassCount];
+
+    Statistics          m_statistics;
+
+    // One for the instance, and one for each thread cache.
+    size_type           m_references;
+
+    bool                m_alive;
+};
+
+
+
+namespace
+{
+
+
+
+// The caches of the current thread, one for each instance
+// the thread has used.  They're released when the thread exits.
+class ThreadCacheList
+{
+public:
+
+    ThreadCacheList() :
+        m_head(0)
+    {
+    }
+
+    ~ThreadCacheList()
+    {
+        while (m_head != 0)
+        {
+            ThreadCache* const  theNext = m_head->m_next;
+
+            m_head->m_pool.releaseThreadCache(m_head);
+
+            m_head = theNext;
+        }
+    }
+
+    ThreadCache&
+    find(XalanThreadCachingMemoryManager::CentralPool&  thePool)
+    {
+        if (m_head != 0 && &m_head->m_pool == &thePool)
+        {
+            return *m_head;
+        }
+
+        // Move the cache to the front, since it's likely
+        // to be used next.
+        ThreadCache*    thePrevious = m_head;
+
+        for (ThreadCache* theCache = thePrevious == 0 ? 0 : thePrevious->m_next;
+                theCache != 0;
+                    theCache = theCache->m_next)
+        {
+            if (&theCache->m_pool == &thePool)
+            {
+                thePrevious->m_next = theCache->m_next;
+
+                theCache->m_next = m_head;
+
+                m_head = theCache;
+
+                return *theCache;
+            }
+
+            thePrevious = theCache;
+        }
+
+        ThreadCache* const  theCache = thePool.createThreadCache();
+
+        theCache->m_next = m_head;
+
+        m_head = theCache;
+
+        return *theCache;
+    }
+
+private:
+
+    ThreadCache*    m_head;
+};
+
+
+
+thread_local ThreadCacheList    s_threadCaches;
+
+
+
+}
+
+
+
+XalanThreadCachingMemoryManager::XalanThreadCachingMemoryManager(
+            MemoryManager&  theParent,
+            size_type       theChunkSize) :
+    XalanMemoryManager(),
+    m_parent(theParent),
+    m_centralPool(new CentralPool(theParent, theChunkSize))
+{
+}
+
+
+
+XalanThreadCachingMemoryManager::~XalanThreadCachingMemoryManager()
+{
+    m_centralPool->shutdown();
+}
+
+
+
+void*
+XalanThreadCachingMemoryManager::allocate(size_type     size)
+{
+    if (size > theMaximumSmallSize)
+    {
+        return m_centralPool->allocateLarge(size);
+    }
+
+    const size_type     theClass = getSizeClass(size);
+
+    FreeList&   theList = s_threadCaches.find(*m_centralPool).m_lists[theClass];
+
+    if (theList.m_count == 0)
+    {
+        m_centralPool->fetchBatch(theClass, theList);
+    }
+
+    return theList.pop();
+}
+
+
+
+void
+XalanThreadCachingMemoryManager::deallocate(void*   pointer)
+{
+    if (pointer != 0)
+    {
+        const size_type     theClass = getHeader(pointer);
+
+        if (theClass == theLargeClass)
+        {
+            m_centralPool->deallocateLarge(pointer);
+        }
+        else
+        {
+            assert(theClass < theSizeClassCount);
+
+            FreeList&   theList = s_threadCaches.find(*m_centralPool).m_lists[theClass];
+
+            theList.push(pointer);
+
+            // Give some back, so a thread which frees what
+            // others allocate doesn't hoard them.
+            if (theList.m_count > 2 * getBatchSize(theClass))
+            {
+                m_centralPool->releaseBatch(theClass, theList);
+            }
+        }
+    }
+}
+
+
+
+MemoryManager*
+XalanThreadCachingMemoryManager::getExceptionMemoryManager()
+{
+    return m_parent.getExceptionMemoryManager();
+}
+
+
+
+void
+XalanThreadCachingMemoryManager::getStatistics(Statistics&  theStatistics) const
+{
+    m_centralPool->getStatistics(theStatistics);
+}
+
+
+
+}
@@ -0,0 +1,160 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANTHREADCACHINGMEMORYMANAGER_HEADER_GUARD_1357924680)
+#define XALANTHREADCACHINGMEMORYMANAGER_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/PlatformSupport/PlatformSupportDefinitions.hpp>
+
+
+
+#include "xalanc/Include/XalanMemoryManagement.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * A thread-safe memory manager which keeps a cache of free blocks for
+ * each thread that uses it, so most requests never take a lock.
+ *
+ * Small requests are rounded up to one of a set of size classes.  Each
+ * thread has a free list for every class, which is refilled from, and
+ * drained to, a central pool a batch at a time.  The central pool carves
+ * its blocks out of large chunks obtained from the parent memory manager.
+ * Large requests go straight to the parent.
+ *
+ * Every block carries a 16-byte header which records its size class,
+ * so deallocate() can find the class and the returned pointer keeps the
+ * alignment of ::operator new.  That doubles the space used by 16-byte
+ * requests, and the overhead falls as requests grow, to under 1% at
+ * 4096 bytes.  Finding the class from the chunk instead would need
+ * chunks aligned to their size, which the parent memory manager can't
+ * provide without wasting up to a chunk for each one.  Use this class
+ * where lock contention costs more than the extra memory.
+ *
+ * To use an instance with XalanTransformer, pass it to
+ * XMLPlatformUtils::Initialize(), to XalanTransformer::initialize(), and
+ * to the constructor of each XalanTransformer.  Passing it to Xalan
+ * alone doesn't work, because Xerces-C frees some of the memory with
+ * its own memory manager.  The chunks are only returned to the
+ * parent when the instance is destroyed.
+ */
+class XALAN_PLATFORMSUPPORT_EXPORT XalanThreadCachingMemoryManager : public XalanMemoryManager
+{
+public:
+
+    enum { eDefaultChunkSize = 256 * 1024 };
+
+    /**
+     * Counters which describe the use of an instance.
+     */
+    struct Statistics
+    {
+        // The number of chunks obtained from the parent.
+        size_type   m_chunks;
+
+        // The total size of those chunks.
+        size_type   m_chunkBytes;
+
+        // The number of requests sent straight to the parent.
+        size_type   m_largeAllocations;
+
+        // The number of those requests which have been freed.
+        size_type   m_largeDeallocations;
+
+        // The number of batches moved from the central pool to a thread.
+        size_type   m_batchFetches;
+
+        // The number of batches moved from a thread to the central pool.
+        size_type   m_batchReleases;
+
+        // The number of threads which currently have a cache.
+        size_type   m_threadCaches;
+    };
+
+    /**
+     * Construct an instance.
+     *
+     * @param theParent The memory manager for chunks and large requests.  It must be thread-safe.
+     * @param theChunkSize The size of the chunks carved into small blocks
+     */
+    explicit
+    XalanThreadCachingMemoryManager(
+            MemoryManager&  theParent,
+            size_type       theChunkSize = eDefaultChunkSize);
+
+    virtual
+    ~XalanThreadCachingMemoryManager();
+
+    virtual void*
+    allocate(size_type  size);
+
+    virtual void
+    deallocate(void*    pointer);
+
+    virtual MemoryManager*
+    getExceptionMemoryManager();
+
+    /**
+     * Get the current counters for the instance.
+     *
+     * @param theStatistics The structure to fill in
+     */
+    void
+    getStatistics(Statistics&   theStatistics) const;
+
+    /**
+     * Get the memory manager for chunks and large requests.
+     *
+     * @return The parent memory manager
+     */
+    MemoryManager&
+    getParent() const
+    {
+        return m_parent;
+    }
+
+    class CentralPool;
+
+private:
+
+    // These are not implemented.
+    XalanThreadCachingMemoryManager(const XalanThreadCachingMemoryManager&);
+
+    XalanThreadCachingMemoryManager&
+    operator=(const XalanThreadCachingMemoryManager&);
+
+
+    // Data members...
+    MemoryManager&      m_parent;
+
+    CentralPool*        m_centralPool;
+};
+
+
+
+}
+
+
+
+#endif  // XALANTHREADCACHINGMEMORYMANAGER_HEADER_GUARD_1357924680
@@ -0,0 +1,395 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "XalanThreadPool.hpp"
+
+
+
+#include <cassert>
+
+#if defined(XALAN_USE_THREAD_STD)
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#endif
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanThreadPool::Task::~Task()
+{
+}
+
+
+
+#if defined(XALAN_USE_THREAD_STD)
+
+class XalanThreadPool::Queue
+{
+public:
+
+    Queue(
+            MemoryManager&  theManager,
+            unsigned int    theThreadCount) :
+        m_mutex(),
+        m_workAvailable(),
+        m_batchDone(),
+        m_entries(theManager),
+        m_head(0),
+        m_threads(theManager),
+        m_threadCount(theThreadCount),
+        m_started(false),
+        m_stopping(false)
+    {
+    }
+
+    ~Queue()
+    {
+        {
+            const std::lock_guard<std::mutex>   theLock(m_mutex);
+
+            assert(m_head == m_entries.size());
+
+            m_stopping = true;
+        }
+
+        m_workAvailable.notify_all();
+
+        MemoryManager&  theManager = m_threads.getMemoryManager();
+
+        for (ThreadVectorType::size_type i = 0; i < m_threads.size(); ++i)
+        {
+            m_threads[i]->join();
+
+            XalanDestroy(theManager, m_threads[i]);
+        }
+    }
+
+    void
+    run(const TaskVectorType&   theTasks)
+    {
+        Batch   theBatch(theTasks.size());
+
+        {
+            const std::lock_guard<std::mutex>   theLock(m_mutex);
+
+            startThreads();
+
+            // Reserve the space first, so the batch is either queued
+            // completely, or not at all.
+            m_entries.reserve(m_entries.size() + theTasks.size());
+
+            for (TaskVectorType::size_type i = 0; i < theTasks.size(); ++i)
+            {
+                assert(theTasks[i] != 0);
+
+                m_entries.push_back(Entry(theTasks[i], &theBatch));
+            }
+        }
+
+        m_workAvailable.notify_all();
+
+        {
+            std::unique_lock<std::mutex>    theLock(m_mutex);
+
+            while (theBatch.m_remaining != 0)
+            {
+                if (m_head != m_entries.size())
+                {
+                    runNext(theLock);
+                }
+                else
+                {
+                    m_batchDone.wait(theLock);
+                }
+            }
+        }
+
+        if (theBatch.m_exception)
+        {
+            std::rethrow_exception(theBatch.m_exception);
+        }
+    }
+
+private:
+
+    struct Batch
+    {
+        Batch(TaskVectorType::size_type     theCount) :
+            m_remaining(theCount),
+            m_exception()
+        {
+        }
+
+        TaskVectorType::size_type   m_remaining;
+
+        std::exception_ptr          m_exception;
+    };
+
+    struct Entry
+    {
+        Entry(
+                Task*   theTask = 0,
+                Batch*  theBatch = 0) :
+            m_task(theTask),
+            m_batch(theBatch)
+        {
+        }
+
+        Task*   m_task;
+
+        Batch*  m_batch;
+    };
+
+    struct Worker
+    {
+        Worker(Queue&   theQueue) :
+            m_queue(&theQueue)
+        {
+        }
+
+        void
+        operator()() const
+        {
+            m_queue->work();
+        }
+
+        Queue*  m_queue;
+    };
+
+    typedef XalanVector<Entry>          EntryVectorType;
+
+    // std::thread can't be copied, so the vector holds pointers
+    // to threads allocated from the memory manager.
+    typedef XalanVector<std::thread*>   ThreadVectorType;
+
+    // Start the threads, if they haven't been started.  The mutex
+    // must be locked.
+    void
+    startThreads()
+    {
+        if (m_started == false)
+        {
+            m_started = true;
+
+            MemoryManager&  theManager = m_threads.getMemoryManager();
+
+            try
+            {
+                m_threads.reserve(m_threadCount);
+
+                for (unsigned int i = 0; i < m_threadCount; ++i)
+                {
+                    std::thread*    theThread = 0;
+
+                    XalanConstruct(theManager, theThread, Worker(*this));
+
+                    m_threads.push_back(theThread);
+                }
+            }
+            catch(...)
+            {
+                // If a thread can't be started, the pool just
+                // has fewer of them.
+            }
+        }
+    }
+
+    // Run the task at the head of the queue.  The mutex must be
+    // locked, and it's unlocked while the task runs.
+    void
+    runNext(std::unique_lock<std::mutex>&   theLock)
+    {
+        assert(m_head != m_entries.size());
+
+        const Entry     theEntry = m_entries[m_head];
+
+        ++m_head;
+
+        if (m_head == m_entries.size())
+        {
+            m_entries.clear();
+
+            m_head = 0;
+        }
+
+        std::exception_ptr  theException;
+
+        theLock.unlock();
+
+        try
+        {
+            theEntry.m_task->run();
+        }
+        catch(...)
+        {
+            theException = std::current_exception();
+        }
+
+        theLock.lock();
+
+        Batch&  theBatch = *theEntry.m_batch;
+
+        if (theException && !theBatch.m_exception)
+        {
+            theBatch.m_exception = theException;
+        }
+
+        assert(theBatch.m_remaining != 0);
+
+        --theBatch.m_remaining;
+
+        if (theBatch.m_remaining == 0)
+        {
+            m_batchDone.notify_all();
+        }
+    }
+
+    void
+    work()
+    {
+        std::unique_lock<std::mutex>    theLock(m_mutex);
+
+        for (;;)
+        {
+            if (m_head != m_entries.size())
+            {
+                runNext(theLock);
+            }
+            else if (m_stopping == true)
+            {
+                break;
+            }
+            else
+            {
+                m_workAvailable.wait(theLock);
+            }
+        }
+    }
+
+
+    // Data members...
+    std::mutex                  m_mutex;
+
+    std::condition_variable     m_workAvailable;
+
+    std::condition_variable     m_batchDone;
+
+    EntryVectorType             m_entries;
+
+    EntryVectorType::size_type  m_head;
+
+    ThreadVectorType            m_threads;
+
+    const unsigned int          m_threadCount;
+
+    bool                        m_started;
+
+    bool                        m_stopping;
+};
+
+
+
+XalanThreadPool::XalanThreadPool(
+            MemoryManager&  theManager,
+            unsigned int    theThreadCount) :
+    m_memoryManager(theManager),
+    m_threadCount(theThreadCount),
+    m_queue(0)
+{
+    XalanConstruct(theManager, m_queue, theManager, theThreadCount);
+}
+
+
+
+XalanThreadPool::~XalanThreadPool()
+{
+    XalanDestroy(m_memoryManager, m_queue);
+}
+
+
+
+void
+XalanThreadPool::run(const TaskVectorType&  theTasks)
+{
+    if (theTasks.size() == 1)
+    {
+        theTasks[0]->run();
+    }
+    else if (theTasks.empty() == false)
+    {
+        m_queue->run(theTasks);
+    }
+}
+
+
+
+unsigned int
+XalanThreadPool::getDefaultThreadCount()
+{
+    const unsigned int  theProcessorCount = std::thread::hardware_concurrency();
+
+    return theProcessorCount > 1 ? theProcessorCount - 1 : 0;
+}
+
+#else
+
+XalanThreadPool::XalanThreadPool(
+            MemoryManager&  theManager,
+            unsigned int    /* theThreadCount */) :
+    m_memoryManager(theManager),
+    m_threadCount(0),
+    m_queue(0)
+{
+}
+
+
+
+XalanThreadPool::~XalanThreadPool()
+{
+}
+
+
+
+void
+XalanThreadPool::run(const TaskVectorType&  theTasks)
+{
+    for (TaskVectorType::size_type i = 0; i < theTasks.size(); ++i)
+    {
+        assert(theTasks[i] != 0);
+
+        theTasks[i]->run();
+    }
+}
+
+
+
+unsigned int
+XalanThreadPool::getDefaultThreadCount()
+{
+    return 0;
+}
+
+#endif
+
+
+
+}
@@ -0,0 +1,144 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANTHREADPOOL_HEADER_GUARD_1357924680)
+#define XALANTHREADPOOL_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/PlatformSupport/PlatformSupportDefinitions.hpp>
+
+
+
+#include <xalanc/Include/XalanMemoryManagement.hpp>
+#include <xalanc/Include/XalanVector.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * A fixed set of worker threads which run batches of tasks for any
+ * number of callers.  The thread which runs a batch also runs queued
+ * tasks until its batch is done, so a batch always finishes, even when
+ * the pool has no threads, or all of them are busy.  The threads are
+ * started when the first batch is run.
+ *
+ * When the build doesn't use std::thread, the pool has no threads, and
+ * every task runs on the thread which runs its batch.
+ */
+class XALAN_PLATFORMSUPPORT_EXPORT XalanThreadPool
+{
+public:
+
+    /**
+     * A unit of work for the pool.
+     */
+    class XALAN_PLATFORMSUPPORT_EXPORT Task
+    {
+    public:
+
+        virtual
+        ~Task();
+
+        virtual void
+        run() = 0;
+    };
+
+    typedef XalanVector<Task*>  TaskVectorType;
+
+    /**
+     * Construct an instance.
+     *
+     * @param theManager The memory manager for the queue and the threads.  It must be thread-safe.
+     * @param theThreadCount The number of worker threads
+     */
+    XalanThreadPool(
+            MemoryManager&  theManager,
+            unsigned int    theThreadCount);
+
+    /**
+     * Stop the threads, and wait for them to exit.  No batch may be
+     * running.
+     */
+    ~XalanThreadPool();
+
+    /**
+     * Get the number of worker threads.
+     *
+     * @return the number of threads
+     */
+    unsigned int
+    getThreadCount() const
+    {
+        return m_threadCount;
+    }
+
+    MemoryManager&
+    getMemoryManager() const
+    {
+        return m_memoryManager;
+    }
+
+    /**
+     * Run a batch of tasks, and return when all of them are done.  If
+     * a task throws an exception, it's rethrown once the batch is done,
+     * and some of the other tasks may not have run.
+     *
+     * @param theTasks The tasks to run
+     */
+    void
+    run(const TaskVectorType&   theTasks);
+
+    /**
+     * Get the number of worker threads which, along with the thread
+     * which runs a batch, keep every processor busy.
+     *
+     * @return the number of threads
+     */
+    static unsigned int
+    getDefaultThreadCount();
+
+    class Queue;
+
+private:
+
+    // These are not implemented.
+    XalanThreadPool(const XalanThreadPool&);
+
+    XalanThreadPool&
+    operator=(const XalanThreadPool&);
+
+
+    // Data members...
+    MemoryManager&      m_memoryManager;
+
+    const unsigned int  m_threadCount;
+
+    Queue*              m_queue;
+};
+
+
+
+}
+
+
+
+#endif  // XALANTHREADPOOL_HEADER_GUARD_1357924680
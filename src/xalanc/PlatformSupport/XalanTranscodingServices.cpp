@@ -153,6 +153,25 @@ const XalanDOMChar  XalanTranscodingServices::s_windows1250String[] =
 
 
 
+const XalanDOMChar  XalanTranscodingServices::s_windows1252String[] =
+{
+    XalanUnicode::charLetter_W,
+    XalanUnicode::charLetter_I,
+    XalanUnicode::charLetter_N,
+    XalanUnicode::charLetter_D,
+    XalanUnicode::charLetter_O,
+    XalanUnicode::charLetter_W,
+    XalanUnicode::charLetter_S,
+    XalanUnicode::charHyphenMinus,
+    XalanUnicode::charDigit_1,
+    XalanUnicode::charDigit_2,
+    XalanUnicode::charDigit_5,
+    XalanUnicode::charDigit_2,
+    0
+};
+
+
+
 const XalanDOMChar  XalanTranscodingServices::s_iso88591String[] =
 {
     XalanUnicode::charLetter_I,
@@ -230,6 +230,8 @@ public:
 
     static const XalanDOMChar   s_windows1250String[];
 
+    static const XalanDOMChar   s_windows1252String[];
+
     static const XalanDOMChar   s_iso88591String[];
 
     static const XalanDOMChar   s_shiftJISString[];
@@ -33,6 +33,7 @@
 
 
 #include "xalanc/PlatformSupport/DoubleSupport.hpp"
+#include "xalanc/PlatformSupport/XalanCharScanner.hpp"
 #include "xalanc/PlatformSupport/XalanOutputStream.hpp"
 #include "xalanc/PlatformSupport/XalanUnicode.hpp"
 
@@ -245,6 +246,39 @@ public:
         m_writer.write(chars, length);
     }
 
+    virtual bool
+    preSerializedMarkup(
+            const XMLCh* const  chars,
+            const size_type     length)
+    {
+        if (m_nextIsRaw == true ||
+            m_spaceBeforeClose == true ||
+            m_indentHandler.isActive() == true)
+        {
+            return false;
+        }
+
+        writeParentTagEnd();
+
+        size_type   start = 0;
+
+        for (size_type i = 0; i < length; ++i)
+        {
+            if (chars[i] == XalanUnicode::charLF)
+            {
+                m_writer.write(chars + start, i - start);
+
+                outputNewline();
+
+                start = i + 1;
+            }
+        }
+
+        m_writer.write(chars + start, length - start);
+
+        return true;
+    }
+
 
     virtual void
     entityReference(const XMLCh* const  name)
@@ -425,6 +459,14 @@ protected:
 
         while(i < length) 
         {
+            // Skip over the run of characters which never need escaping.
+            i += XalanCharScanner::scanContent(chars + i, length - i);
+
+            if (i == length)
+            {
+                break;
+            }
+
             const XalanDOMChar  ch = chars[i];
 
             if(m_charPredicate.range(ch) == true)
@@ -801,6 +843,13 @@ protected:
 
         while(i < theStringLength)
         {
+            i += XalanCharScanner::scanAttribute(theString + i, theStringLength - i);
+
+            if (i == theStringLength)
+            {
+                break;
+            }
+
             const XalanDOMChar  ch = theString[i];
 
             if(m_charPredicate.range(ch) == true)
@@ -875,10 +924,7 @@ private:
                 const XalanDOMChar*     theChars,
                 size_type               theLength)
     {
-        for(size_type i = 0; i < theLength; ++i)
-        {
-            m_writer.write(value_type(theChars[i]));
-        }
+        m_writer.safeWriteContent(theChars, theLength);
     }
 
     void
@@ -56,6 +56,12 @@ public:
     {
         return 0;
     }
+
+    bool
+    isActive() const
+    {
+        return false;
+    }
     
     void
     indent()
@@ -73,6 +73,15 @@ public:
     {
         return m_indent;
     }
+
+    /**
+     * Determine if any whitespace might be written.
+     */
+    bool
+    isActive() const
+    {
+        return true;
+    }
     
     void
     indent()
@@ -245,6 +245,14 @@ public:
         }
     }
 
+    void
+    safeWriteContent(
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+    {
+        write(theChars, theLength);
+    }
+
     void
     write(
             const XalanDOMChar*     theChars,
@@ -0,0 +1,625 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANSINGLEBYTEWRITER_HEADER_GUARD_1357924680)
+#define XALANSINGLEBYTEWRITER_HEADER_GUARD_1357924680
+
+
+#include <xalanc/XMLSupport/XalanFormatterWriter.hpp>
+
+
+
+#include <xalanc/PlatformSupport/XalanCharScanner.hpp>
+
+
+
+#include <xalanc/XMLSupport/XalanXMLSerializerBase.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * Maps code points to US-ASCII.
+ */
+class XalanASCIICharMap
+{
+public:
+
+    static bool
+    map(
+            XalanUnicodeChar    theChar,
+            char&               theByte)
+    {
+        if (theChar <= 0x7Fu)
+        {
+            theByte = char(theChar);
+
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Get the code point of a byte above 0x7F, or 0 if none is assigned.
+     */
+    static XalanUnicodeChar
+    getChar(unsigned int    /* theByte */)
+    {
+        return 0;
+    }
+};
+
+
+
+/**
+ * Maps code points to ISO-8859-1, which is the first 256
+ * code points of Unicode.
+ */
+class XalanLatin1CharMap
+{
+public:
+
+    static bool
+    map(
+            XalanUnicodeChar    theChar,
+            char&               theByte)
+    {
+        if (theChar <= 0xFFu)
+        {
+            theByte = char(theChar);
+
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    /**
+     * Get the code point of a byte above 0x7F, or 0 if none is assigned.
+     */
+    static XalanUnicodeChar
+    getChar(unsigned int    theByte)
+    {
+        return theByte;
+    }
+};
+
+
+
+/**
+ * Maps code points to Windows-1252.  This is ISO-8859-1, except
+ * that 0x80 through 0x9F hold typographic characters instead of
+ * the C1 controls.  The five bytes in that range that are not
+ * assigned are never produced.
+ */
+class XalanWindows1252CharMap
+{
+public:
+
+    static bool
+    map(
+            XalanUnicodeChar    theChar,
+            char&               theByte)
+    {
+        if (theChar <= 0x7Fu ||
+            (theChar >= 0xA0u && theChar <= 0xFFu))
+        {
+            theByte = char(theChar);
+
+            return true;
+        }
+        else
+        {
+            const unsigned int  theValue = mapHigh(theChar);
+
+            theByte = char(theValue);
+
+            return theValue != 0;
+        }
+    }
+
+    /**
+     * Get the code point of a byte above 0x7F, or 0 if none is assigned.
+     */
+    static XalanUnicodeChar
+    getChar(unsigned int    theByte)
+    {
+        static const XalanUnicodeChar   theHighChars[] =
+        {
+            0x20ACu, 0u, 0x201Au, 0x0192u, 0x201Eu, 0x2026u, 0x2020u, 0x2021u,
+            0x02C6u, 0x2030u, 0x0160u, 0x2039u, 0x0152u, 0u, 0x017Du, 0u,
+            0u, 0x2018u, 0x2019u, 0x201Cu, 0x201Du, 0x2022u, 0x2013u, 0x2014u,
+            0x02DCu, 0x2122u, 0x0161u, 0x203Au, 0x0153u, 0u, 0x017Eu, 0x0178u
+        };
+
+        return theByte < 0xA0u ? theHighChars[theByte - 0x80u] : theByte;
+    }
+
+private:
+
+    static unsigned int
+    mapHigh(XalanUnicodeChar    theChar)
+    {
+        switch(theChar)
+        {
+        case 0x20ACu: return 0x80u;
+        case 0x201Au: return 0x82u;
+        case 0x0192u: return 0x83u;
+        case 0x201Eu: return 0x84u;
+        case 0x2026u: return 0x85u;
+        case 0x2020u: return 0x86u;
+        case 0x2021u: return 0x87u;
+        case 0x02C6u: return 0x88u;
+        case 0x2030u: return 0x89u;
+        case 0x0160u: return 0x8Au;
+        case 0x2039u: return 0x8Bu;
+        case 0x0152u: return 0x8Cu;
+        case 0x017Du: return 0x8Eu;
+        case 0x2018u: return 0x91u;
+        case 0x2019u: return 0x92u;
+        case 0x201Cu: return 0x93u;
+        case 0x201Du: return 0x94u;
+        case 0x2022u: return 0x95u;
+        case 0x2013u: return 0x96u;
+        case 0x2014u: return 0x97u;
+        case 0x02DCu: return 0x98u;
+        case 0x2122u: return 0x99u;
+        case 0x0161u: return 0x9Au;
+        case 0x203Au: return 0x9Bu;
+        case 0x0153u: return 0x9Cu;
+        case 0x017Eu: return 0x9Eu;
+        case 0x0178u: return 0x9Fu;
+        default: return 0;
+        }
+    }
+};
+
+
+
+/**
+ * A writer for single-byte encodings which are a superset of US-ASCII.
+ * Characters are mapped to bytes using CharMapType, and written
+ * to the stream untranscoded.  Characters that cannot be mapped are
+ * written as numeric character references.  So that the output is
+ * the same as the stream's transcoder would produce, a byte above
+ * 0x7F is only used if the transcoder accepts its character.
+ */
+template <class CharMapType>
+class XalanSingleByteWriter : public XalanFormatterWriter
+{
+public:
+
+    typedef char    value_type;
+
+
+    XalanSingleByteWriter(
+                Writer&         writer,
+                MemoryManager&  theMemoryManager) :
+        XalanFormatterWriter(
+            writer,
+            theMemoryManager),
+        m_buffer(),
+        m_bufferPosition(m_buffer),
+        m_bufferRemaining(kBufferSize)
+    {
+        const XalanOutputStream* const  theStream =
+            writer.getStream();
+
+        for (unsigned int i = 0; i < kHighByteCount; ++i)
+        {
+            const XalanUnicodeChar  theChar = CharMapType::getChar(i + 0x80u);
+
+            m_highBytes[i] =
+                theChar != 0 &&
+                (theStream == 0 || theStream->canTranscodeTo(theChar) == true);
+        }
+    }
+
+    virtual
+    ~XalanSingleByteWriter()
+    {
+    }
+
+    /**
+     * Output a line break.
+     */
+    void
+    outputNewline()
+    {
+        assert(m_newlineString != 0);
+        assert(length(m_newlineString) == m_newlineStringLength);
+
+        write(
+            m_newlineString,
+            m_newlineStringLength);
+    }
+
+    /**
+     * Writes CDATA chars.  If a character is not representable,
+     * the CDATA section is closed and a character reference is
+     * written instead.
+     */
+    size_type
+    writeCDATAChar(
+                const XalanDOMChar  chars[],
+                size_type           start,
+                size_type           length,
+                bool&               outsideCDATA)
+    {
+        assert(chars != 0 && length > 0 && start < length);
+
+        const XalanUnicodeChar  value = decode(chars, start, length);
+
+        char    theByte;
+
+        if (map(value, theByte) == true)
+        {
+            if (outsideCDATA == true)
+            {
+                // The previous character was not representable,
+                // so open the CDATA section again.
+                write(
+                    XalanXMLSerializerBase::UTF8::s_cdataOpenString,
+                    XalanXMLSerializerBase::UTF8::s_cdataOpenStringLength);
+
+                outsideCDATA = false;
+            }
+
+            write(theByte);
+        }
+        else
+        {
+            if (outsideCDATA == false)
+            {
+                write(
+                    XalanXMLSerializerBase::UTF8::s_cdataCloseString,
+                    XalanXMLSerializerBase::UTF8::s_cdataCloseStringLength);
+
+                outsideCDATA = true;
+            }
+
+            writeNumericCharacterReference(value);
+        }
+
+        return start;
+    }
+
+    /**
+     * Writes name characters.  If a character is not representable,
+     * an exception is thrown.
+     */
+    void
+    writeNameChar(
+            const XalanDOMChar*     data,
+            size_type               theLength)
+    {
+        for (size_type i = 0; i < theLength; ++i)
+        {
+            const XalanUnicodeChar  value = decode(data, i, theLength);
+
+            char    theByte;
+
+            if (map(value, theByte) == true)
+            {
+                write(theByte);
+            }
+            else
+            {
+                throwUnrepresentableCharacterException(
+                    value,
+                    getMemoryManager());
+            }
+        }
+    }
+
+    /**
+     * Writes PI characters.  If a character is not representable,
+     * an exception is thrown.
+     */
+    void
+    writePIChars(
+            const XalanDOMChar*     data,
+            size_type               theLength)
+    {
+        writeNameChar(data, theLength);
+    }
+
+    /**
+     * Writes comment characters.  If a character is not representable,
+     * an exception is thrown.
+     */
+    void
+    writeCommentChars(
+            const XalanDOMChar*     data,
+            size_type               theLength)
+    {
+        writeNameChar(data, theLength);
+    }
+
+    void
+    safeWriteContent(
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+    {
+        writeASCII(theChars, theLength);
+    }
+
+    void
+    write(
+            const value_type*   theChars,
+            size_type           theLength)
+    {
+        if (theLength > kBufferSize)
+        {
+            flushBuffer();
+
+            m_writer.write(theChars, 0, theLength);
+        }
+        else
+        {
+            if (m_bufferRemaining < theLength)
+            {
+                flushBuffer();
+            }
+
+            for(size_type i = 0; i < theLength; ++i)
+            {
+                *m_bufferPosition = theChars[i];
+
+                ++m_bufferPosition;
+            }
+
+            m_bufferRemaining -= theLength;
+        }
+    }
+
+    void
+    write(const XalanDOMChar*   theChars)
+    {
+        write(theChars, XalanDOMString::length(theChars));
+    }
+
+    void
+    write(const XalanDOMString&     theChars)
+    {
+        write(theChars.c_str(), theChars.length());
+    }
+
+    void
+    write(value_type    theChar)
+    {
+        if (m_bufferRemaining == 0)
+        {
+            flushBuffer();
+        }
+
+        *m_bufferPosition = theChar;
+
+        ++m_bufferPosition;
+        --m_bufferRemaining;
+    }
+
+    /**
+     * Writes characters, writing a character reference for
+     * any that are not representable.
+     */
+    void
+    write(
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+    {
+        for(size_type i = 0; i < theLength; ++i)
+        {
+            const size_type     theRunLength =
+                XalanCharScanner::scanASCII(theChars + i, theLength - i);
+
+            if (theRunLength != 0)
+            {
+                writeASCII(theChars + i, theRunLength);
+
+                i += theRunLength;
+
+                if (i == theLength)
+                {
+                    break;
+                }
+            }
+
+            i = write(theChars, i, theLength);
+        }
+    }
+
+    size_type
+    write(
+            const XalanDOMChar  chars[],
+            size_type           start,
+            size_type           length)
+    {
+        const XalanUnicodeChar  value = decode(chars, start, length);
+
+        char    theByte;
+
+        if (map(value, theByte) == true)
+        {
+            write(theByte);
+        }
+        else
+        {
+            writeNumericCharacterReference(value);
+        }
+
+        return start;
+    }
+
+    void
+    writeSafe(
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+    {
+        write(theChars, theLength);
+    }
+
+    void
+    write(const value_type*     theChars)
+    {
+        write(theChars, XalanDOMString::length(theChars));
+    }
+
+    void
+    flushWriter()
+    {
+        m_writer.flush();
+    }
+
+    void
+    flushBuffer()
+    {
+        m_writer.write(m_buffer, 0, m_bufferPosition - m_buffer);
+
+        m_bufferPosition = m_buffer;
+        m_bufferRemaining = kBufferSize;
+    }
+
+private:
+
+    bool
+    map(
+            XalanUnicodeChar    theChar,
+            char&               theByte) const
+    {
+        if (CharMapType::map(theChar, theByte) == false)
+        {
+            return false;
+        }
+        else
+        {
+            const unsigned int  theValue = static_cast<unsigned char>(theByte);
+
+            return theValue < 0x80u || m_highBytes[theValue - 0x80u] == true;
+        }
+    }
+
+    /**
+     * Decode the code point at start, combining a surrogate pair.
+     * On return, start is the index of the last code unit used.
+     */
+    XalanUnicodeChar
+    decode(
+            const XalanDOMChar  chars[],
+            size_type&          start,
+            size_type           length)
+    {
+        const XalanDOMChar  ch = chars[start];
+
+        if (isUTF16HighSurrogate(ch) == false)
+        {
+            return ch;
+        }
+        else if (start + 1 >= length)
+        {
+            throwInvalidUTF16SurrogateException(
+                ch,
+                0,
+                getMemoryManager());
+
+            return 0;
+        }
+        else
+        {
+            ++start;
+
+            return decodeUTF16SurrogatePair(
+                        ch,
+                        chars[start],
+                        getMemoryManager());
+        }
+    }
+
+    /**
+     * Write ASCII characters, copying as many as will fit into
+     * the buffer at a time.
+     */
+    void
+    writeASCII(
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+    {
+        while (theLength != 0)
+        {
+            if (m_bufferRemaining == 0)
+            {
+                flushBuffer();
+            }
+
+            const size_type     theCount =
+                theLength < m_bufferRemaining ? theLength : m_bufferRemaining;
+
+            XalanCharScanner::narrowASCII(theChars, theCount, m_bufferPosition);
+
+            m_bufferPosition += theCount;
+            m_bufferRemaining -= theCount;
+
+            theChars += theCount;
+            theLength -= theCount;
+        }
+    }
+
+    void
+    writeNumericCharacterReference(XalanUnicodeChar     theChar)
+    {
+        writeASCII(formatNumericCharacterReference(theChar));
+    }
+
+    void
+    writeASCII(const XalanDOMString&    theString)
+    {
+        writeASCII(theString.c_str(), theString.length());
+    }
+
+    enum
+    {
+        kBufferSize = 512,      // The size of the buffer
+        kHighByteCount = 128    // The number of bytes above 0x7F
+    };
+
+
+    // Data members...
+    value_type      m_buffer[kBufferSize];
+
+    value_type*     m_bufferPosition;
+
+    size_type       m_bufferRemaining;
+
+    // Whether each byte above 0x7F may be written.
+    bool            m_highBytes[kHighByteCount];
+};
+
+
+
+}
+
+
+
+#endif  // XALANSINGLEBYTEWRITER_HEADER_GUARD_1357924680
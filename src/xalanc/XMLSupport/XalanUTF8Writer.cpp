@@ -30,9 +30,19 @@ XalanUTF8Writer::XalanUTF8Writer(
         writer,
         theMemoryManager),
     m_buffer(),
+    m_directStream(getStream()),
+    m_bufferStart(m_buffer),
     m_bufferPosition(m_buffer),
     m_bufferRemaining(kBufferSize)
 {
+    if (m_directStream != 0)
+    {
+        // Don't take any memory from the stream until there's
+        // something to write, since it might not support it.
+        m_bufferStart = 0;
+        m_bufferPosition = 0;
+        m_bufferRemaining = 0;
+    }
 }
 
 
@@ -23,6 +23,15 @@
 
 
 
+#include <cstring>
+
+
+
+#include <xalanc/PlatformSupport/XalanCharScanner.hpp>
+#include <xalanc/PlatformSupport/XalanOutputStream.hpp>
+
+
+
 namespace XALAN_CPP_NAMESPACE {
 
 
@@ -190,10 +199,7 @@ public:
             const XalanDOMChar*     theChars,
             size_type               theLength)
     {
-        for(size_type i = 0; i < theLength; ++i)
-        { 
-            write(value_type(theChars[i]));
-        }
+        writeASCII(theChars, theLength);
     }
 
     void
@@ -202,17 +208,38 @@ public:
             size_type           theLength)
     {
     #if !defined(XALAN_DEBUG)
-        if (theLength > sizeof(m_buffer))
+        if (theLength > sizeof(m_buffer) && m_directStream == 0)
         {
             flushBuffer();
     
             m_writer.write(theChars, 0, theLength);
         }
+        else if (theLength > sizeof(m_buffer))
+        {
+            while (theLength != 0)
+            {
+                if (m_bufferRemaining == 0)
+                {
+                    nextBuffer(1);
+                }
+
+                const size_type     theCount =
+                    theLength < m_bufferRemaining ? theLength : m_bufferRemaining;
+
+                std::memcpy(m_bufferPosition, theChars, theCount);
+
+                m_bufferPosition += theCount;
+                m_bufferRemaining -= theCount;
+
+                theChars += theCount;
+                theLength -= theCount;
+            }
+        }
         else
         {
             if (m_bufferRemaining < theLength)
             {
-                flushBuffer();
+                nextBuffer(theLength);
             }
     
             for(size_type i = 0; i < theLength; ++i)
@@ -251,7 +278,7 @@ public:
     
         if (m_bufferRemaining == 0)
         {
-            flushBuffer();
+            nextBuffer(1);
         }
 
         *m_bufferPosition = theChar;
@@ -267,6 +294,21 @@ public:
     {
         for(size_type i = 0; i < theLength; ++i)
         {
+            const size_type     theRunLength =
+                XalanCharScanner::scanASCII(theChars + i, theLength - i);
+
+            if (theRunLength != 0)
+            {
+                writeASCII(theChars + i, theRunLength);
+
+                i += theRunLength;
+
+                if (i == theLength)
+                {
+                    break;
+                }
+            }
+
             if (isUTF16HighSurrogate(theChars[i]) == false)
             {
                 write(static_cast<XalanUnicodeChar>(theChars[i]));
@@ -329,6 +371,21 @@ public:
     {
         for(size_type i = 0; i < theLength; ++i)
         {
+            const size_type     theRunLength =
+                XalanCharScanner::scanASCII(theChars + i, theLength - i);
+
+            if (theRunLength != 0)
+            {
+                writeASCII(theChars + i, theRunLength);
+
+                i += theRunLength;
+
+                if (i == theLength)
+                {
+                    break;
+                }
+            }
+
             const XalanDOMChar  ch = theChars[i];
 
             if (isUTF16HighSurrogate(ch) == true)
@@ -374,14 +431,94 @@ public:
     void
     flushBuffer()
     {
-        m_writer.write(m_buffer, 0, m_bufferPosition - m_buffer);
-    
-        m_bufferPosition = m_buffer;
-        m_bufferRemaining = kBufferSize;
+        if (m_directStream == 0)
+        {
+            m_writer.write(m_buffer, 0, m_bufferPosition - m_buffer);
+
+            m_bufferPosition = m_buffer;
+            m_bufferRemaining = kBufferSize;
+        }
+        else if (m_bufferStart != 0)
+        {
+            m_directStream->commitDirectBuffer(size_type(m_bufferPosition - m_bufferStart));
+
+            m_bufferStart = 0;
+            m_bufferPosition = 0;
+            m_bufferRemaining = 0;
+        }
     }
 
 private:
 
+    /**
+     * Flush the buffer, and make room for at least theCount bytes.
+     * If the stream allows it, the room is in the stream's own memory,
+     * so the output is never copied.
+     */
+    void
+    nextBuffer(size_type    theCount)
+    {
+        assert(theCount <= kBufferSize);
+
+        flushBuffer();
+
+        if (m_directStream != 0)
+        {
+            size_type   theSize = 0;
+
+            value_type* const   theBuffer =
+                m_directStream->getDirectBuffer(theCount, theSize);
+
+            if (theBuffer != 0)
+            {
+                assert(theSize >= theCount);
+
+                m_bufferStart = theBuffer;
+                m_bufferPosition = theBuffer;
+                m_bufferRemaining = theSize;
+            }
+            else
+            {
+                // The stream doesn't support direct writes, so
+                // use our own buffer from now on.
+                m_directStream = 0;
+
+                m_bufferStart = m_buffer;
+                m_bufferPosition = m_buffer;
+                m_bufferRemaining = kBufferSize;
+            }
+        }
+    }
+
+    /**
+     * Write ASCII characters, copying as many as will fit into
+     * the buffer at a time.
+     */
+    void
+    writeASCII(
+            const XalanDOMChar*     theChars,
+            size_type               theLength)
+    {
+        while (theLength != 0)
+        {
+            if (m_bufferRemaining == 0)
+            {
+                nextBuffer(1);
+            }
+
+            const size_type     theCount =
+                theLength < m_bufferRemaining ? theLength : m_bufferRemaining;
+
+            XalanCharScanner::narrowASCII(theChars, theCount, m_bufferPosition);
+
+            m_bufferPosition += theCount;
+            m_bufferRemaining -= theCount;
+
+            theChars += theCount;
+            theLength -= theCount;
+        }
+    }
+
     void
     write(XalanUnicodeChar  theChar)
     {
@@ -393,7 +530,7 @@ private:
         {
             if (m_bufferRemaining < 2)
             {
-                flushBuffer();
+                nextBuffer(2);
             }
 
             *m_bufferPosition = leadingByteOf2(bits7to11(theChar));
@@ -411,7 +548,7 @@ private:
 
             if (m_bufferRemaining < 3)
             {
-                flushBuffer();
+                nextBuffer(3);
             }
 
             *m_bufferPosition = leadingByteOf3(bits13to16(theChar));
@@ -427,7 +564,7 @@ private:
         {
             if (m_bufferRemaining < 4)
             {
-                flushBuffer();
+                nextBuffer(4);
             }
 
             *m_bufferPosition = leadingByteOf4(bits19to21(theChar));
@@ -454,11 +591,16 @@ private:
 
 
     // Data members...
-    value_type      m_buffer[kBufferSize];
+    value_type          m_buffer[kBufferSize];
+
+    // The stream, if it accepts direct writes, or 0.
+    XalanOutputStream*  m_directStream;
+
+    value_type*         m_bufferStart;
 
-    value_type*     m_bufferPosition;
+    value_type*         m_bufferPosition;
 
-    size_type       m_bufferRemaining;
+    size_type           m_bufferRemaining;
 };
 
 
@@ -30,6 +30,7 @@
 #include "xalanc/XMLSupport/XalanIndentWriter.hpp"
 
 #include "xalanc/XMLSupport/XalanOtherEncodingWriter.hpp"
+#include "xalanc/XMLSupport/XalanSingleByteWriter.hpp"
 
 #include "xalanc/XMLSupport/XalanUTF8Writer.hpp"
 #include "xalanc/XMLSupport/XalanUTF16Writer.hpp"
@@ -39,6 +40,114 @@ namespace XALAN_CPP_NAMESPACE {
 
 
 
+template <class CharMapType>
+static FormatterListener*
+createSingleByteFormatter(
+            MemoryManager&          theManager,
+            Writer&                 theWriter,
+            bool                    isVersion1_1,
+            bool                    doIndent,
+            int                     theIndentAmount,
+            const XalanDOMString&   theEncoding,
+            const XalanDOMString&   theDoctypeSystem,
+            const XalanDOMString&   theDoctypePublic,
+            bool                    generateXMLDeclaration,
+            const XalanDOMString&   theStandaloneString)
+{
+    typedef XalanSingleByteWriter<CharMapType>  WriterType;
+
+    typedef XalanFormatterWriter::NewLineWriterFunctor<WriterType> NewLineWriter;
+    typedef XalanFormatterWriter::WhiteSpaceWriterFunctor<WriterType> WhiteSpaceWriter;
+
+    typedef XalanIndentWriter<WhiteSpaceWriter, NewLineWriter> IndentWriter;
+    typedef XalanDummyIndentWriter<WriterType> DummyIndentWriter;
+
+    if (isVersion1_1 == true)
+    {
+        if (doIndent == true)
+        {
+            typedef FormatterToXMLUnicode<
+                WriterType,
+                XalanXMLSerializerBase::UTF8,
+                XalanXMLSerializerBase::CharFunctor1_1,
+                IndentWriter,
+                FormatterListener::XML_VERSION_1_1>  Type;
+
+            return Type::create(
+                    theManager,
+                    theWriter,
+                    theEncoding,
+                    theDoctypeSystem,
+                    theDoctypePublic,
+                    generateXMLDeclaration,
+                    theStandaloneString,
+                    theIndentAmount);
+        }
+        else
+        {
+            typedef FormatterToXMLUnicode<
+                WriterType,
+                XalanXMLSerializerBase::UTF8,
+                XalanXMLSerializerBase::CharFunctor1_1,
+                DummyIndentWriter,
+                FormatterListener::XML_VERSION_1_1>  Type;
+
+            return Type::create(
+                    theManager,
+                    theWriter,
+                    theEncoding,
+                    theDoctypeSystem,
+                    theDoctypePublic,
+                    generateXMLDeclaration,
+                    theStandaloneString,
+                    theIndentAmount);
+        }
+    }
+    else // XML 1.0 section
+    {
+        if (doIndent == true)
+        {
+            typedef FormatterToXMLUnicode<
+                WriterType,
+                XalanXMLSerializerBase::UTF8,
+                XalanXMLSerializerBase::CharFunctor1_0,
+                IndentWriter,
+                FormatterListener::XML_VERSION_1_0>  Type;
+
+            return Type::create(
+                    theManager,
+                    theWriter,
+                    theEncoding,
+                    theDoctypeSystem,
+                    theDoctypePublic,
+                    generateXMLDeclaration,
+                    theStandaloneString,
+                    theIndentAmount);
+        }
+        else
+        {
+            typedef FormatterToXMLUnicode<
+                WriterType,
+                XalanXMLSerializerBase::UTF8,
+                XalanXMLSerializerBase::CharFunctor1_0,
+                DummyIndentWriter,
+                FormatterListener::XML_VERSION_1_0>  Type;
+
+            return Type::create(
+                    theManager,
+                    theWriter,
+                    theEncoding,
+                    theDoctypeSystem,
+                    theDoctypePublic,
+                    generateXMLDeclaration,
+                    theStandaloneString,
+                    theIndentAmount);
+        }
+    }
+}
+
+
+
 FormatterListener*
 XalanXMLSerializerFactory::create(
             MemoryManager&          theManager,
@@ -272,6 +381,54 @@ XalanXMLSerializerFactory::create(
             }
         }
     }
+    else if (compareIgnoreCaseASCII(fixedEncoding, XalanTranscodingServices::s_iso88591String) == 0)
+    {
+        // The common single-byte encodings are mapped directly,
+        // rather than going through the stream's transcoder.
+        theFormatter =
+            createSingleByteFormatter<XalanLatin1CharMap>(
+                theManager,
+                theWriter,
+                isVersion1_1,
+                doIndent,
+                theIndentAmount,
+                fixedEncoding,
+                theDoctypeSystem,
+                theDoctypePublic,
+                generateXMLDeclaration,
+                theStandaloneString);
+    }
+    else if (compareIgnoreCaseASCII(fixedEncoding, XalanTranscodingServices::s_usASCIIString) == 0 ||
+             compareIgnoreCaseASCII(fixedEncoding, XalanTranscodingServices::s_asciiString) == 0)
+    {
+        theFormatter =
+            createSingleByteFormatter<XalanASCIICharMap>(
+                theManager,
+                theWriter,
+                isVersion1_1,
+                doIndent,
+                theIndentAmount,
+                fixedEncoding,
+                theDoctypeSystem,
+                theDoctypePublic,
+                generateXMLDeclaration,
+                theStandaloneString);
+    }
+    else if (compareIgnoreCaseASCII(fixedEncoding, XalanTranscodingServices::s_windows1252String) == 0)
+    {
+        theFormatter =
+            createSingleByteFormatter<XalanWindows1252CharMap>(
+                theManager,
+                theWriter,
+                isVersion1_1,
+                doIndent,
+                theIndentAmount,
+                fixedEncoding,
+                theDoctypeSystem,
+                theDoctypePublic,
+                generateXMLDeclaration,
+                theStandaloneString);
+    }
     else // all other encodings
     {
         typedef XalanOtherEncodingWriter<   XalanFormatterWriter::CommonRepresentableCharFunctor,
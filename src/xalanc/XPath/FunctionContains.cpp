@@ -23,6 +23,11 @@
 
 
 
+#include <xalanc/DOMSupport/DOMServices.hpp>
+
+
+
+#include "NodeRefListBase.hpp"
 #include "XObjectFactory.hpp"
 
 
@@ -53,7 +58,6 @@ FunctionContains::execute(
 {
     assert(arg1.null() == false && arg2.null() == false);   
 
-    const XalanDOMString&   str1 = arg1->str(executionContext);
     const XalanDOMString&   str2 = arg2->str(executionContext);
 
     bool                    fResult = true;
@@ -61,18 +65,43 @@ FunctionContains::execute(
     // If str2 is empty, then don't bother to check anything.
     if (str2.empty() == false)
     {
-        // Is str1 empty?
-        if (str1.empty() == true)
+        if (arg1->getType() == XObject::eTypeNodeSet)
         {
-            fResult = false;
+            // Search the node's data without retrieving all of it.
+            const NodeRefListBase&  theNodeList = arg1->nodeset();
+
+            if (theNodeList.getLength() == 0)
+            {
+                fResult = false;
+            }
+            else
+            {
+                assert(theNodeList.item(0) != 0);
+
+                fResult =
+                    DOMServices::nodeDataContains(
+                        *theNodeList.item(0),
+                        executionContext,
+                        str2);
+            }
         }
         else
         {
-            // OK, both strings have some data, so look for
-            // the index...
-            const XalanDOMString::size_type     theIndex = indexOf(str1, str2);
-
-            fResult = theIndex < str1.length() ? true : false;
+            const XalanDOMString&   str1 = arg1->str(executionContext);
+
+            // Is str1 empty?
+            if (str1.empty() == true)
+            {
+                fResult = false;
+            }
+            else
+            {
+                // OK, both strings have some data, so look for
+                // the index...
+                const XalanDOMString::size_type     theIndex = indexOf(str1, str2);
+
+                fResult = theIndex < str1.length() ? true : false;
+            }
         }
     }
 
@@ -24,6 +24,8 @@
 
 
 
+#include <xalanc/PlatformSupport/FormatterListener.hpp>
+#include <xalanc/PlatformSupport/XalanCharScanner.hpp>
 #include <xalanc/PlatformSupport/XalanMessageLoader.hpp>
 
 
@@ -57,6 +59,182 @@ static const XalanDOMString     s_emptyString(XalanMemMgrs::getDummyMemMgr());
 
 
 
+/**
+ * Append the normalized form of a block of characters to a string.
+ * fPendingSpace carries whitespace seen at the end of one block
+ * to the next, so a string may be normalized a block at a time.
+ */
+static void
+appendNormalized(
+            const XalanDOMChar*         theChars,
+            XalanDOMString::size_type   theLength,
+            XalanDOMString&             theResult,
+            bool&                       fPendingSpace)
+{
+    XalanDOMString::size_type   i = 0;
+
+    // Copy each run of non-whitespace characters, with a single space
+    // between runs...
+    for (;;)
+    {
+        const XalanDOMString::size_type     theStart = i;
+
+        while (i < theLength && XalanCharScanner::isWhitespace(theChars[i]) == true)
+        {
+            ++i;
+        }
+
+        if (i != theStart && theResult.empty() == false)
+        {
+            fPendingSpace = true;
+        }
+
+        if (i == theLength)
+        {
+            break;
+        }
+        else if (fPendingSpace == true)
+        {
+            theResult.push_back(XalanDOMChar(XalanUnicode::charSpace));
+
+            fPendingSpace = false;
+        }
+
+        const XalanDOMString::size_type     theRunLength =
+            XalanCharScanner::scanNonWhitespace(theChars + i, theLength - i);
+
+        theResult.append(theChars + i, theRunLength);
+
+        i += theRunLength;
+    }
+}
+
+
+
+static XObjectPtr
+createResult(
+            XPathExecutionContext&                      executionContext,
+            XPathExecutionContext::GetCachedString&     theResult)
+{
+    if (theResult.get().empty() == true)
+    {
+        return executionContext.getXObjectFactory().createStringReference(s_emptyString);
+    }
+    else
+    {
+        return executionContext.getXObjectFactory().createString(theResult);
+    }
+}
+
+
+
+/**
+ * Normalizes the character data of a node as it is produced, so
+ * the string value of the node is never built.
+ */
+class NormalizingFormatterListener : public FormatterListener
+{
+public:
+
+    NormalizingFormatterListener(XalanDOMString&    theResult) :
+        FormatterListener(OUTPUT_METHOD_NONE),
+        m_result(theResult),
+        m_pendingSpace(false)
+    {
+    }
+
+    ~NormalizingFormatterListener()
+    {
+    }
+
+    void
+    setDocumentLocator(const Locator* const     /* locator */)
+    {
+    }
+
+    void
+    startDocument()
+    {
+    }
+
+    void
+    endDocument()
+    {
+    }
+
+    void
+    startElement(
+                const   XMLCh* const    /* name */,
+                AttributeListType&      /* attrs */)
+    {
+    }
+
+    void
+    endElement(const    XMLCh* const    /* name */)
+    {
+    }
+
+    void
+    characters(
+                const XMLCh* const  chars,
+                const size_type     length)
+    {
+        appendNormalized(chars, length, m_result, m_pendingSpace);
+    }
+
+    void
+    charactersRaw(
+            const XMLCh* const  chars,
+            const size_type     length)
+    {
+        appendNormalized(chars, length, m_result, m_pendingSpace);
+    }
+
+    void
+    entityReference(const XMLCh* const  /* name */)
+    {
+    }
+
+    void
+    ignorableWhitespace(
+                const XMLCh* const  /* chars */,
+                const size_type     /* length */)
+    {
+    }
+
+    void
+    processingInstruction(
+                const XMLCh* const  /* target */,
+                const XMLCh* const  /* data */)
+    {
+    }
+
+    void
+    resetDocument()
+    {
+    }
+
+    void
+    comment(const XMLCh* const  /* data */)
+    {
+    }
+
+    void
+    cdata(
+                const XMLCh* const  /* ch */,
+                const size_type     /* length */)
+    {
+    }
+
+private:
+
+    XalanDOMString&     m_result;
+
+    bool                m_pendingSpace;
+};
+
+
+
 XObjectPtr
 FunctionNormalizeSpace::execute(
             XPathExecutionContext&  executionContext,
@@ -86,16 +264,19 @@ FunctionNormalizeSpace::execute(
     {
         // The XPath standard says that if there are no arguments,
         // the default is to turn the context node into a string value.
-        // DOMServices::getNodeData() will give us the data.
-
-        // Get a cached string...
-        const GetCachedString    theData(executionContext);
+        // Rather than building that string, normalize the data as
+        // DOMServices::getNodeData() produces it.
+        GetCachedString     theResult(executionContext);
 
-        XalanDOMString&     theString = theData.get();
+        NormalizingFormatterListener    theListener(theResult.get());
 
-        DOMServices::getNodeData(*context, executionContext, theString);
+        DOMServices::getNodeData(
+            *context,
+            executionContext,
+            theListener,
+            &FormatterListener::characters);
 
-        return normalize(executionContext, theString);
+        return createResult(executionContext, theResult);
     }
 }
 
@@ -131,45 +312,15 @@ FunctionNormalizeSpace::normalize(
     // just reserve the space now.
     theNewString.reserve(theStringLength);
 
-    enum  eLastCharState { eNonSpace, eSpace, eSpaceAppended };
-
-    eLastCharState  theState = eSpace;
-
-    // OK, strip out any multiple spaces...
-    for (XalanDOMString::const_iterator i = theString.begin();
-            i != theString.end(); ++i)
-    {
-        const XalanDOMChar  theCurrentChar = *i;
-
-        if (isXMLWhitespace(theCurrentChar) == false)
-        {
-            theNewString.push_back(theCurrentChar);
-
-            theState = eNonSpace;
-        }
-        else if (theState == eNonSpace)
-        {
-            theNewString.push_back(XalanDOMChar(XalanUnicode::charSpace));
-
-            theState = eSpaceAppended;
-        }
-    }
+    bool    fPendingSpace = false;
 
-    if (theNewString.empty() == true)
-    {
-        return executionContext.getXObjectFactory().createStringReference(s_emptyString);
-    }
-    else
-    {
-        // We may have a space character at end, since we don't look ahead,
-        // so removed it now...
-        if (theState == eSpaceAppended)
-        {
-            theNewString.erase(theNewString.end() - 1);
-        }
+    appendNormalized(
+        theString.c_str(),
+        theStringLength,
+        theNewString,
+        fPendingSpace);
 
-        return executionContext.getXObjectFactory().createString(theResult);
-    }
+    return createResult(executionContext, theResult);
 }
 
 
@@ -225,37 +376,26 @@ FunctionNormalizeSpace::needsNormalization(const XalanDOMString&    theString) c
 {
     const XalanDOMString::size_type     theStringLength = theString.length();
 
-    bool    fNormalize = false;
+    const XalanDOMChar* const   theChars = theString.c_str();
 
-    bool    fPreviousIsSpace = false;
-
-    // OK, search for multiple spaces, or whitespace that is not the
-    // space character...
-    for (XalanDOMString::size_type i = 0; i < theStringLength && fNormalize == false; ++i)
+    // OK, search for leading or trailing whitespace, multiple spaces, or
+    // whitespace that is not the space character...
+    for (XalanDOMString::size_type i = 0;; ++i)
     {
-        const XalanDOMChar  theCurrentChar = theString[i];
+        i += XalanCharScanner::scanNonWhitespace(theChars + i, theStringLength - i);
 
-        if (isXMLWhitespace(theCurrentChar) == false)
+        if (i == theStringLength)
         {
-            fPreviousIsSpace = false;
+            return false;
         }
-        else
+        else if (i == 0 ||
+                 i == theStringLength - 1 ||
+                 theChars[i] != XalanDOMChar(XalanUnicode::charSpace) ||
+                 XalanCharScanner::isWhitespace(theChars[i + 1]) == true)
         {
-            if (i == 0 ||
-                i == theStringLength - 1 ||
-                theCurrentChar != XalanDOMChar(XalanUnicode::charSpace) ||
-                fPreviousIsSpace == true)
-            {
-                fNormalize = true;
-            }
-            else
-            {
-                fPreviousIsSpace = true;
-            }
+            return true;
         }
     }
-
-    return fNormalize;
 }
 
 
@@ -23,6 +23,11 @@
 
 
 
+#include <xalanc/DOMSupport/DOMServices.hpp>
+
+
+
+#include "NodeRefListBase.hpp"
 #include "XObjectFactory.hpp"
 
 
@@ -53,10 +58,35 @@ FunctionStartsWith::execute(
 {
     assert(arg1.null() == false && arg2.null() == false);   
 
-    const bool  fStartsWith =
-        startsWith(
-            arg1->str(executionContext), 
-            arg2->str(executionContext));
+    bool    fStartsWith = false;
+
+    if (arg1->getType() == XObject::eTypeNodeSet)
+    {
+        // Look at the node's data without retrieving all of it.
+        const NodeRefListBase&  theNodeList = arg1->nodeset();
+
+        if (theNodeList.getLength() == 0)
+        {
+            fStartsWith = arg2->str(executionContext).empty();
+        }
+        else
+        {
+            assert(theNodeList.item(0) != 0);
+
+            fStartsWith =
+                DOMServices::nodeDataStartsWith(
+                    *theNodeList.item(0),
+                    executionContext,
+                    arg2->str(executionContext));
+        }
+    }
+    else
+    {
+        fStartsWith =
+            startsWith(
+                arg1->str(executionContext), 
+                arg2->str(executionContext));
+    }
 
     return executionContext.getXObjectFactory().createBoolean(fStartsWith);
 }
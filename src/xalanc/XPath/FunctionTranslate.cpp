@@ -19,13 +19,11 @@
 
 
 
-#include <xalanc/Include/XalanVector.hpp>
-
-
 #include <xalanc/PlatformSupport/XalanMessageLoader.hpp>
 
 
 
+#include "XalanTranslationTable.hpp"
 #include "XObjectFactory.hpp"
 
 
@@ -65,13 +63,22 @@ FunctionTranslate::execute(
     const XalanDOMString::size_type     theSecondStringLength = theSecondString.length();
     const XalanDOMString::size_type     theThirdStringLength = theThirdString.length();
 
-    typedef XalanVector<XalanDOMChar>       VectorType;
-
     // A string to hold the result.
     GetCachedString     theResult(executionContext);
 
     XalanDOMString&     theString = theResult.get();
 
+    // Building the table only pays off if there's enough work
+    // to do.  Otherwise, just search for each character.
+    if (theFirstStringLength * theSecondStringLength > XalanTranslationTable::eTableSize)
+    {
+        const XalanTranslationTable   theTable(theSecondString, theThirdString);
+
+        theTable.translate(theFirstString, theString);
+
+        return executionContext.getXObjectFactory().createString(theResult);
+    }
+
     // The result string can only be as large as the first string, so
     // just reserve the space now.  Also reserve space for the
     // terminating 0.
@@ -33,7 +33,6 @@
 
 
 
-#include "FormatterStringLengthCounter.hpp"
 #include "XObjectTypeCallback.hpp"
 #include "XPathExecutionContext.hpp"
 
@@ -253,15 +252,8 @@ XNodeSetBase::stringLength(XPathExecutionContext&   executionContext) const
         const XalanNode* const  theNode = item(0);
         assert(theNode != 0);
 
-        FormatterStringLengthCounter    theCounter;
-
-        DOMServices::getNodeData(
-            *theNode,
-            executionContext,
-            theCounter,
-            &FormatterListener::characters);
-
-        return static_cast<double>(theCounter.getCount());
+        return static_cast<double>(
+            DOMServices::getNodeDataLength(*theNode, executionContext));
     }
 }
 
@@ -31,6 +31,7 @@
 
 
 #include <xalanc/DOMSupport/DOMServices.hpp>
+#include <xalanc/DOMSupport/XalanNodeDataIterator.hpp>
 
 
 
@@ -341,42 +342,47 @@ XObject::nodeset() const
 
 
 
-inline void
-getStringFromNode(
-            const XalanNode&        theNode,
-            XPathExecutionContext&  theContext,
-            XalanDOMString&         theString)
-{
-    DOMServices::getNodeData(theNode, theContext, theString);
-}
+typedef XObject::GetCachedString    GetCachedString;
 
 
 
-struct
-getStringFromNodeFunction
+inline double
+getNumberFromNode(
+            const XalanNode&        theNode,
+            XPathExecutionContext&  executionContext)
 {
-    getStringFromNodeFunction(XPathExecutionContext&    executionContext) :
-        m_executionContext(executionContext)
+    double  theNumber;
+
+    if (executionContext.getNodeNumber(theNode, theNumber) == true)
     {
+        return theNumber;
     }
 
-    void
-    operator()(
-            const XalanNode&    theNode,
-            XalanDOMString&     theString) const
+    XalanNodeDataIterator   theIterator(theNode, executionContext);
+
+    const XalanDOMString* const     theData = theIterator.next();
+
+    if (theData == 0)
+    {
+        return DoubleSupport::getNaN();
+    }
+    else if (theIterator.next() == 0)
     {
-        getStringFromNode(theNode, m_executionContext, theString);
+        // The data is in one piece, so there's no need to copy it.
+        return DoubleSupport::toDouble(*theData, executionContext.getMemoryManager());
     }
+    else
+    {
+        const GetCachedString   theString(executionContext);
 
-private:
+        DOMServices::getNodeData(theNode, executionContext, theString.get());
 
-    XPathExecutionContext&  m_executionContext;
-};
+        return DoubleSupport::toDouble(theString.get(), executionContext.getMemoryManager());
+    }
+}
 
 
 
-typedef XObject::GetCachedString    GetCachedString;
-
 struct
 getNumberFromNodeFunction
 {
@@ -388,42 +394,19 @@ getNumberFromNodeFunction
     double
     operator()(const XalanNode&     theNode) const
     {
-        return getNumberFromNode(theNode);
-    }
-
-    void
-    operator()(
-            const XalanNode&    theNode,
-            double&             theNumber) const
-    {
-        getNumberFromNode(theNode, theNumber);
+        return getNumberFromNode(theNode, m_executionContext);
     }
 
 private:
 
-    double
-    getNumberFromNode(const XalanNode&  theNode) const
-    {
-        const GetCachedString   theString(m_executionContext);
-
-        getStringFromNode(theNode, m_executionContext, theString.get());
-
-        return DoubleSupport::toDouble(theString.get(), m_executionContext.getMemoryManager());
-    }
-
-    void
-    getNumberFromNode(
-            const XalanNode&    theNode,
-            double&             theNumber) const
-    {
-        theNumber = getNumberFromNode(theNode);
-    }
-
     XPathExecutionContext&  m_executionContext;
 };
 
 
 
+// The string comparison functions compare the data of nodes without
+// retrieving it into strings, so a comparison can stop at the first
+// difference.
 struct
 equalsDOMString
 {
@@ -434,26 +417,18 @@ equalsDOMString
 
     bool
     operator()(
-            const XalanDOMString&   theLHS,
-            const XalanDOMString&   theRHS) const
-    {
-        return DOMStringEqualsFunction()(theLHS, theRHS);
-    }
-
-    bool
-    operator()(
-            const XObject&          theLHS,
-            const XalanDOMString&   theRHS) const
+            const XalanNode&    theLHS,
+            const XalanNode&    theRHS) const
     {
-        return DOMStringEqualsFunction()(theLHS.str(m_executionContext), theRHS);
+        return DOMServices::nodeDataEquals(theLHS, theRHS, m_executionContext);
     }
 
     bool
     operator()(
-            const XalanDOMString&   theLHS,
-            const XObject&          theRHS) const
+            const XalanNode&    theLHS,
+            const XObject&      theRHS) const
     {
-        return DOMStringEqualsFunction()(theLHS, theRHS.str(m_executionContext));
+        return DOMServices::nodeDataEquals(theLHS, m_executionContext, theRHS.str(m_executionContext));
     }
 
 private:
@@ -473,71 +448,18 @@ notEqualsDOMString
 
     bool
     operator()(
-            const XalanDOMString&   theLHS,
-            const XalanDOMString&   theRHS) const
-    {
-        return DOMStringNotEqualsFunction()(theLHS, theRHS);
-    }
-
-    bool
-    operator()(
-            const XObject&          theLHS,
-            const XalanDOMString&   theRHS) const
-    {
-        return DOMStringNotEqualsFunction()(theLHS.str(m_executionContext), theRHS);
-    }
-
-    bool
-    operator()(
-            const XalanDOMString&   theLHS,
-            const XObject&          theRHS) const
-    {
-        return DOMStringNotEqualsFunction()(theLHS, theRHS.str(m_executionContext));
-    }
-
-private:
-
-    XPathExecutionContext&  m_executionContext;
-};
-
-
-
-struct
-lessThanDOMString
-{
-    lessThanDOMString(XPathExecutionContext&    theExecutionContext) :
-        m_executionContext(theExecutionContext)
-    {
-    }
-
-    bool
-    operator()(
-            const XalanDOMString&   theLHS,
-            const XalanDOMString&   theRHS) const
+            const XalanNode&    theLHS,
+            const XalanNode&    theRHS) const
     {
-        return DoubleSupport::lessThan(
-                DOMStringToDouble(theLHS, m_executionContext.getMemoryManager()),
-                DOMStringToDouble(theRHS, m_executionContext.getMemoryManager()));
+        return !DOMServices::nodeDataEquals(theLHS, theRHS, m_executionContext);
     }
 
     bool
     operator()(
-            const XObject&          theLHS,
-            const XalanDOMString&   theRHS) const
+            const XalanNode&    theLHS,
+            const XObject&      theRHS) const
     {
-        return DoubleSupport::lessThan(
-                theLHS.num(m_executionContext),
-                DOMStringToDouble(theRHS, m_executionContext.getMemoryManager()));
-    }
-
-    bool
-    operator()(
-            const XalanDOMString&   theLHS,
-            const XObject&          theRHS) const
-    {
-        return DoubleSupport::lessThan(
-                DOMStringToDouble(theLHS, m_executionContext.getMemoryManager()),
-                theRHS.num(m_executionContext));
+        return !DOMServices::nodeDataEquals(theLHS, m_executionContext, theRHS.str(m_executionContext));
     }
 
 private:
@@ -547,87 +469,49 @@ private:
 
 
 
+template<class NumberCompareFunction>
 struct
-lessThanOrEqualDOMString
+numberCompareDOMString
 {
-    lessThanOrEqualDOMString(XPathExecutionContext&     theExecutionContext) :
+    numberCompareDOMString(XPathExecutionContext&   theExecutionContext) :
         m_executionContext(theExecutionContext)
     {
     }
 
     bool
     operator()(
-            const XalanDOMString&   theLHS,
-            const XalanDOMString&   theRHS) const
-    {
-        return DoubleSupport::lessThanOrEqual(
-                DOMStringToDouble(theLHS, m_executionContext.getMemoryManager()),
-                DOMStringToDouble(theRHS, m_executionContext.getMemoryManager()));
-    }
-
-    bool
-    operator()(
-            const XObject&          theLHS,
-            const XalanDOMString&   theRHS) const
+            const XalanNode&    theLHS,
+            const XalanNode&    theRHS) const
     {
-        return DoubleSupport::lessThanOrEqual(
-                theLHS.num(m_executionContext),
-                DOMStringToDouble(theRHS, m_executionContext.getMemoryManager()));
+        return NumberCompareFunction()(
+                getNumberFromNode(theLHS, m_executionContext),
+                getNumberFromNode(theRHS, m_executionContext));
     }
 
     bool
     operator()(
-            const XalanDOMString&   theLHS,
-            const XObject&          theRHS) const
+            const XalanNode&    theLHS,
+            const XObject&      theRHS) const
     {
-        return DoubleSupport::lessThanOrEqual(
-                DOMStringToDouble(theLHS, m_executionContext.getMemoryManager()),
+        return NumberCompareFunction()(
+                getNumberFromNode(theLHS, m_executionContext),
                 theRHS.num(m_executionContext));
     }
 
-private:
-
-    XPathExecutionContext&  m_executionContext;
-};
-
-
-
-struct
-greaterThanDOMString
-{
-    greaterThanDOMString(XPathExecutionContext&     theExecutionContext) :
-        m_executionContext(theExecutionContext)
-    {
-    }
-
     bool
     operator()(
-            const XalanDOMString&   theLHS,
-            const XalanDOMString&   theRHS) const
+            double              theLHS,
+            const XalanNode&    theRHS) const
     {
-        return DoubleSupport::greaterThan(
-                DOMStringToDouble(theLHS, m_executionContext.getMemoryManager()),
-                DOMStringToDouble(theRHS, m_executionContext.getMemoryManager()));
-    }
-
-    bool
-    operator()(
-            const XObject&          theLHS,
-            const XalanDOMString&   theRHS) const
-    {
-        return DoubleSupport::greaterThan(
-                theLHS.num(m_executionContext),
-                DOMStringToDouble(theRHS, m_executionContext.getMemoryManager()));
+        return NumberCompareFunction()(
+                theLHS,
+                getNumberFromNode(theRHS, m_executionContext));
     }
 
-    bool
-    operator()(
-            const XalanDOMString&   theLHS,
-            const XObject&          theRHS) const
+    double
+    getNumber(const XalanNode&  theNode) const
     {
-        return DoubleSupport::greaterThan(
-                DOMStringToDouble(theLHS, m_executionContext.getMemoryManager()),
-                theRHS.num(m_executionContext));
+        return getNumberFromNode(theNode, m_executionContext);
     }
 
 private:
@@ -637,59 +521,19 @@ private:
 
 
 
-struct
-greaterThanOrEqualDOMString
-{
-    greaterThanOrEqualDOMString(XPathExecutionContext&  theExecutionContext) :
-        m_executionContext(theExecutionContext)
-    {
-    }
-
-    bool
-    operator()(
-            const XalanDOMString&   theLHS,
-            const XalanDOMString&   theRHS) const
-    {
-        return DoubleSupport::greaterThanOrEqual(
-                DOMStringToDouble(theLHS, m_executionContext.getMemoryManager()),
-                DOMStringToDouble(theRHS, m_executionContext.getMemoryManager()));
-    }
-
-    bool
-    operator()(
-            const XObject&          theLHS,
-            const XalanDOMString&   theRHS) const
-    {
-        return DoubleSupport::greaterThanOrEqual(
-                theLHS.num(m_executionContext),
-                DOMStringToDouble(theRHS, m_executionContext.getMemoryManager()));
-    }
-
-    bool
-    operator()(
-            const XalanDOMString&   theLHS,
-            const XObject&          theRHS) const
-    {
-        return DoubleSupport::greaterThanOrEqual(
-                DOMStringToDouble(theLHS, m_executionContext.getMemoryManager()),
-                theRHS.num(m_executionContext));
-    }
-
-private:
-
-    XPathExecutionContext&  m_executionContext;
-};
+typedef numberCompareDOMString<DoubleSupport::lessThanFunction>             lessThanDOMString;
+typedef numberCompareDOMString<DoubleSupport::lessThanOrEqualFunction>      lessThanOrEqualDOMString;
+typedef numberCompareDOMString<DoubleSupport::greaterThanFunction>          greaterThanDOMString;
+typedef numberCompareDOMString<DoubleSupport::greaterThanOrEqualFunction>   greaterThanOrEqualDOMString;
 
 
 
-template<class CompareFunction, class TypeFunction>
+template<class CompareFunction>
 inline bool
 doCompareNodeSets(
             const NodeRefListBase&  theLHSNodeSet,
             const NodeRefListBase&  theRHSNodeSet,
-            const TypeFunction&     theTypeFunction,
-            const CompareFunction&  theCompareFunction,
-            XPathExecutionContext&  executionContext)
+            const CompareFunction&  theCompareFunction)
 {
     // Excerpt from: 
     //   XML Path Language (XPath) Version 1.0
@@ -713,40 +557,64 @@ doCompareNodeSets(
     bool    theResult = false;
 
     const NodeRefListBase::size_type    len1 = theLHSNodeSet.getLength();
+    const NodeRefListBase::size_type    len2 = theRHSNodeSet.getLength();
 
-    if (len1 > 0)
+    for(NodeRefListBase::size_type i = 0; i < len1 && theResult == false; i++)
     {
-        const NodeRefListBase::size_type    len2 = theRHSNodeSet.getLength();
+        const XalanNode* const  theLHSNode = theLHSNodeSet.item(i);
+        assert(theLHSNode != 0);
 
-        if (len2 > 0)
+        for(NodeRefListBase::size_type k = 0; k < len2 && theResult == false; k++)
         {
-            const GetCachedString   s1(executionContext);
+            const XalanNode* const  theRHSNode = theRHSNodeSet.item(k);
+            assert(theRHSNode != 0);
 
-            const GetCachedString   s2(executionContext);
-
-            for(NodeRefListBase::size_type i = 0; i < len1 && theResult == false; i++)
+            if(theCompareFunction(*theLHSNode, *theRHSNode) == true)
             {
-                const XalanNode* const  theLHSNode = theLHSNodeSet.item(i);
-                assert(theLHSNode != 0);
+                theResult = true;
+            }
+        }
+    }
 
-                theTypeFunction(*theLHSNode, s1.get());
+    return theResult;
+}
 
-                for(NodeRefListBase::size_type k = 0; k < len2 && theResult == false; k++)
-                {
-                    const XalanNode* const  theRHSNode = theRHSNodeSet.item(k);
-                    assert(theRHSNode != 0);
 
-                    theTypeFunction(*theRHSNode, s2.get());
 
-                    if(theCompareFunction(s1.get(), s2.get()) == true)
-                    {
-                        theResult = true;
-                    }
+// The relational operators compare numbers, so the number of each
+// node in the first node-set is converted once, rather than once for
+// each node in the second.  NaN is never less than, greater than or
+// equal to anything, so a node whose number is NaN is skipped.
+template<class NumberCompareFunction>
+inline bool
+doCompareNodeSets(
+            const NodeRefListBase&                                  theLHSNodeSet,
+            const NodeRefListBase&                                  theRHSNodeSet,
+            const numberCompareDOMString<NumberCompareFunction>&    theCompareFunction)
+{
+    bool    theResult = false;
 
-                    s2.get().clear();
-                }
+    const NodeRefListBase::size_type    len1 = theLHSNodeSet.getLength();
+    const NodeRefListBase::size_type    len2 = theRHSNodeSet.getLength();
+
+    for(NodeRefListBase::size_type i = 0; i < len1 && len2 != 0 && theResult == false; i++)
+    {
+        const XalanNode* const  theLHSNode = theLHSNodeSet.item(i);
+        assert(theLHSNode != 0);
 
-                s1.get().clear();
+        const double    theLHS = theCompareFunction.getNumber(*theLHSNode);
+
+        if (DoubleSupport::isNaN(theLHS) == false)
+        {
+            for(NodeRefListBase::size_type k = 0; k < len2 && theResult == false; k++)
+            {
+                const XalanNode* const  theRHSNode = theRHSNodeSet.item(k);
+                assert(theRHSNode != 0);
+
+                if(theCompareFunction(theLHS, *theRHSNode) == true)
+                {
+                    theResult = true;
+                }
             }
         }
     }
@@ -756,36 +624,26 @@ doCompareNodeSets(
 
 
 
-template<class CompareFunction, class StringFunction>
+template<class CompareFunction>
 inline bool
 doCompareString(
             const NodeRefListBase&  theLHSNodeSet,
-            const StringFunction&   theStringFunction,
             const XObject&          theRHS,
-            const CompareFunction&  theCompareFunction,
-            XPathExecutionContext&  executionContext)
+            const CompareFunction&  theCompareFunction)
 {
     bool                theResult = false;
 
     const NodeRefListBase::size_type    len1 = theLHSNodeSet.getLength();
 
-    XPathExecutionContext::GetCachedString  theGuard(executionContext);
-
-    XalanDOMString&     theLHS = theGuard.get();
-
     for(NodeRefListBase::size_type i = 0; i < len1 && theResult == false; i++)
     {
         const XalanNode* const  theLHSNode = theLHSNodeSet.item(i);
         assert(theLHSNode != 0);
 
-        theStringFunction(*theLHSNode, theLHS);
-
-        if (theCompareFunction(theLHS, theRHS) == true)
+        if (theCompareFunction(*theLHSNode, theRHS) == true)
         {
             theResult = true;
         }
-
-        theLHS.clear();
     }
 
     return theResult;
@@ -841,9 +699,7 @@ compareNodeSets(
         theResult = doCompareNodeSets(
                 theLHS.nodeset(),
                 theRHS.nodeset(),
-                getStringFromNodeFunction(executionContext),
-                theStringCompareFunction,
-                executionContext);
+                theStringCompareFunction);
 
     }
     else if(theRHSType == XObject::eTypeBoolean)
@@ -899,7 +755,7 @@ compareNodeSets(
             theResult = doCompareNumber(
                     theLHS.nodeset(),
                     getNumberFromNodeFunction(executionContext),
-                    theRHS.num(executionContext),
+                    theRHSNumber,
                     theNumberCompareFunction);
         }
         else
@@ -907,10 +763,8 @@ compareNodeSets(
             // Compare as string...
             theResult = doCompareString(
                     theLHS.nodeset(),
-                    getStringFromNodeFunction(executionContext),
                     theRHS,
-                    theStringCompareFunction,
-                    executionContext);
+                    theStringCompareFunction);
         }
     }
     else if(theRHSType == XObject::eTypeString)
@@ -930,10 +784,8 @@ compareNodeSets(
         // string is true. 
         theResult = doCompareString(
                 theLHS.nodeset(),
-                getStringFromNodeFunction(executionContext),
                 theRHS,
-                theStringCompareFunction,
-                executionContext);
+                theStringCompareFunction);
     }
     else if (theRHSType != XObject::eTypeUnknown)
     {
@@ -47,6 +47,7 @@
 #include "FormatterStringLengthCounter.hpp"
 #include "MutableNodeRefList.hpp"
 #include "XalanQNameByReference.hpp"
+#include "XalanTranslationTable.hpp"
 #include "XObject.hpp"
 #include "XObjectFactory.hpp"
 #include "XPathConstructionContext.hpp"
@@ -68,7 +69,11 @@ XPath::XPath(
             const Locator*  theLocator) :
     m_expression(theManager),
     m_locator(theLocator),
-    m_inStylesheet(false)
+    m_inStylesheet(false),
+    m_compiledSteps(theManager),
+    m_compiledPatterns(theManager),
+    m_compiledTesters(theManager),
+    m_compiledTesterIndexes(theManager)
 {
 }
 
@@ -498,6 +503,16 @@ XPath::executeMore(
         return executionContext.getXObjectFactory().createNumber(functionSum(context, opPos, executionContext));
         break;
 
+    case XPathExpression::eOP_FUNCTION_TRANSLATE:
+        {
+            GetCachedString     theResult(executionContext);
+
+            functionTranslate(context, opPos, executionContext, theResult.get());
+
+            return executionContext.getXObjectFactory().createString(theResult);
+        }
+        break;
+
     default:
         unknownOpCodeError(context, executionContext, opPos);
         break;
@@ -681,6 +696,16 @@ XPath::executeMore(
         result = XObject::boolean(functionSum(context, opPos, executionContext));
         break;
 
+    case XPathExpression::eOP_FUNCTION_TRANSLATE:
+        {
+            const GetCachedString   theResult(executionContext);
+
+            functionTranslate(context, opPos, executionContext, theResult.get());
+
+            result = XObject::boolean(theResult.get());
+        }
+        break;
+
     default:
         unknownOpCodeError(context, executionContext, opPos);
         break;
@@ -862,6 +887,16 @@ XPath::executeMore(
         result = functionSum(context, opPos, executionContext);
         break;
 
+    case XPathExpression::eOP_FUNCTION_TRANSLATE:
+        {
+            const GetCachedString   theResult(executionContext);
+
+            functionTranslate(context, opPos, executionContext, theResult.get());
+
+            result = XObject::number(theResult.get(), executionContext.getMemoryManager());
+        }
+        break;
+
     default:
         unknownOpCodeError(context, executionContext, opPos);
         break;
@@ -1043,6 +1078,10 @@ XPath::executeMore(
         XObject::string(functionSum(context, opPos, executionContext), result);
         break;
 
+    case XPathExpression::eOP_FUNCTION_TRANSLATE:
+        functionTranslate(context, opPos, executionContext, result);
+        break;
+
     default:
         unknownOpCodeError(context, executionContext, opPos);
         break;
@@ -1269,6 +1308,16 @@ XPath::executeMore(
         XObject::string(functionSum(context, opPos, executionContext), formatterListener, function);
         break;
 
+    case XPathExpression::eOP_FUNCTION_TRANSLATE:
+        {
+            const GetCachedString   theResult(executionContext);
+
+            functionTranslate(context, opPos, executionContext, theResult.get());
+
+            stringToCharacters(theResult.get(), formatterListener, function);
+        }
+        break;
+
     default:
         unknownOpCodeError(context, executionContext, opPos);
         break;
@@ -1331,6 +1380,7 @@ XPath::executeMore(
     case XPathExpression::eOP_FUNCTION_NAMESPACEURI_0:
     case XPathExpression::eOP_FUNCTION_NAMESPACEURI_1:
     case XPathExpression::eOP_FUNCTION_SUM:
+    case XPathExpression::eOP_FUNCTION_TRANSLATE:
         notNodeSetError(context, executionContext);
         break;
 
@@ -1381,6 +1431,29 @@ XPath::doGetMatchScore(
 {
     assert(context != 0);
 
+    if (m_compiledPatterns.empty() == false)
+    {
+        const CompiledLocationPathPatternVectorType::const_iterator     theEnd =
+            m_compiledPatterns.end();
+
+        for (CompiledLocationPathPatternVectorType::const_iterator i =
+                m_compiledPatterns.begin();
+                    i != theEnd && score == eMatchScoreNone;
+                        ++i)
+        {
+            if ((*i).getStepCount() == 0)
+            {
+                score = locationPathPattern(executionContext, *context, (*i).getOpPos());
+            }
+            else
+            {
+                score = compiledLocationPathPattern(executionContext, *context, *i);
+            }
+        }
+
+        return;
+    }
+
     OpCodeMapPositionType   opPos =
         m_expression.getInitialOpCodePosition() + 2;
 
@@ -2312,7 +2385,33 @@ XPath::variable(
         m_expression.getToken(m_expression.getOpCodeMapValue(opPos + 3));
     assert(varName != 0);
 
-    return executionContext.getVariable(XalanQNameByReference(ns->str(), varName->str()), m_locator);
+    assert(m_expression.isValidOpCodePosition(opPos + 5));
+
+    const OpCodeMapValueType    theGlobalSlot = m_expression.getOpCodeMapValue(opPos + 4);
+    const OpCodeMapValueType    theLocalSlot = m_expression.getOpCodeMapValue(opPos + 5);
+
+    if (theLocalSlot != XPathExpression::eUnresolvedVariableSlot)
+    {
+        assert(theLocalSlot >= 0 && theGlobalSlot == XPathExpression::eUnresolvedVariableSlot);
+
+        return executionContext.getLocalVariable(
+                    XalanQNameByReference(ns->str(), varName->str()),
+                    theLocalSlot,
+                    m_locator);
+    }
+    else if (theGlobalSlot != XPathExpression::eUnresolvedVariableSlot)
+    {
+        assert(theGlobalSlot >= 0);
+
+        return executionContext.getGlobalVariable(
+                    XalanQNameByReference(ns->str(), varName->str()),
+                    theGlobalSlot,
+                    m_locator);
+    }
+    else
+    {
+        return executionContext.getVariable(XalanQNameByReference(ns->str(), varName->str()), m_locator);
+    }
 }
 
 
@@ -2767,11 +2866,8 @@ XPath::functionStringLength(
 {
     assert(context != 0);
 
-    FormatterStringLengthCounter    theCounter;
-
-    DOMServices::getNodeData(*context, executionContext, theCounter, &FormatterListener::characters);
-
-    const FormatterListener::size_type  theResult = theCounter.getCount();
+    const XalanDOMString::size_type     theResult =
+        DOMServices::getNodeDataLength(*context, executionContext);
     assert(static_cast<double>(theResult) == theResult);
 
     return static_cast<double>(theResult);
@@ -2799,6 +2895,29 @@ XPath::functionStringLength(
 
 
 
+void
+XPath::functionTranslate(
+            XalanNode*              context,
+            OpCodeMapPositionType   opPos,
+            XPathExecutionContext&  executionContext,
+            XalanDOMString&         theResult) const
+{
+    assert(context != 0);
+    assert(m_expression.getOpCodeMapValue(opPos + 3) == 3);
+
+    const GetCachedString   theString(executionContext);
+
+    // Skip the table index and the argument count to get to the
+    // first argument.  The other arguments are in the table.
+    executeMore(context, opPos + 4, executionContext, theString.get());
+
+    m_expression.getTranslationTable(m_expression.getOpCodeMapValue(opPos + 2)).translate(
+        theString.get(),
+        theResult);
+}
+
+
+
 double
 XPath::functionSum(
             XalanNode*              context,
@@ -2860,172 +2979,739 @@ XPath::locationPathPattern(
 
 
 void
-XPath::step(
-            XPathExecutionContext&  executionContext,
-            XalanNode*              context,
-            OpCodeMapPositionType   opPos,
-            MutableNodeRefList&     queryResults) const
+XPath::compileMatchPattern()
 {
-    const XPathExpression&  currentExpression = getExpression();
-
-    const OpCodeMapValueType   stepType =
-        currentExpression.getOpCodeMapValue(opPos);
-
-    typedef XPathExecutionContext::BorrowReturnMutableNodeRefList   BorrowReturnMutableNodeRefList;
-
-    BorrowReturnMutableNodeRefList  subQueryResults(executionContext);
+    m_compiledSteps.clear();
+    m_compiledPatterns.clear();
 
-    bool    continueStepRecursion = true;
-
-    switch(stepType)
+    if (m_expression.getOpCodeMapValue(0) == XPathExpression::eOP_MATCHPATTERN)
     {
-    case XPathExpression::eOP_VARIABLE:
-    case XPathExpression::eOP_EXTFUNCTION:
-    case XPathExpression::eOP_FUNCTION:
-    case XPathExpression::eOP_GROUP:
-        opPos = findNodeSet(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
-
-    case XPathExpression::eFROM_ROOT:
-        opPos = findRoot(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
+        OpCodeMapPositionType   opPos =
+            m_expression.getInitialOpCodePosition() + 2;
 
-    case XPathExpression::eFROM_PARENT:
-        opPos = findParent(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
+        while(m_expression.getOpCodeMapValue(opPos) == XPathExpression::eOP_LOCATIONPATHPATTERN)
+        {
+            const CompiledStepPatternVectorType::size_type  theFirstStep =
+                m_compiledSteps.size();
 
-    case XPathExpression::eFROM_SELF:
-        opPos = findSelf(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
+            if (compileLocationPathPattern(opPos) == false)
+            {
+                m_compiledSteps.erase(
+                    m_compiledSteps.begin() + theFirstStep,
+                    m_compiledSteps.end());
+            }
 
-    case XPathExpression::eFROM_ANCESTORS:
-        opPos = findAncestors(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
+            m_compiledPatterns.push_back(
+                CompiledLocationPathPattern(
+                    opPos,
+                    theFirstStep,
+                    m_compiledSteps.size() - theFirstStep));
 
-    case XPathExpression::eFROM_ANCESTORS_OR_SELF:
-        opPos = findAncestorsOrSelf(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
+            opPos = m_expression.getNextOpCodePosition(opPos);
+        }
+    }
+}
 
-    case XPathExpression::eMATCH_ATTRIBUTE:
-        continueStepRecursion = false;
-        // fall-through on purpose.
 
-    case XPathExpression::eFROM_ATTRIBUTES:
-        opPos = findAttributes(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
 
-    case XPathExpression::eMATCH_ANY_ANCESTOR:
-    case XPathExpression::eMATCH_IMMEDIATE_ANCESTOR:
-    case XPathExpression::eMATCH_ANY_ANCESTOR_WITH_PREDICATE:
-        continueStepRecursion = false;
-        // fall-through on purpose.
+void
+XPath::compileSelectExpression()
+{
+    m_compiledTesters.clear();
+    m_compiledTesterIndexes.clear();
 
-    case XPathExpression::eFROM_CHILDREN:
-        opPos = findChildren(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
+    if (m_expression.getOpCodeMapValue(0) == XPathExpression::eOP_XPATH)
+    {
+        compileExpression(m_expression.getInitialOpCodePosition());
+    }
+}
 
-    case XPathExpression::eFROM_DESCENDANTS:
-    case XPathExpression::eFROM_DESCENDANTS_OR_SELF:
-        opPos = findDescendants(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
 
-    case XPathExpression::eFROM_FOLLOWING:
-        opPos = findFollowing(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
 
-    case XPathExpression::eFROM_FOLLOWING_SIBLINGS:
-        opPos = findFollowingSiblings(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
+void
+XPath::compileExpression(OpCodeMapPositionType  opPos)
+{
+    switch(m_expression.getOpCodeMapValue(opPos))
+    {
+    case XPathExpression::eOP_XPATH:
+    case XPathExpression::eOP_OR:
+    case XPathExpression::eOP_AND:
+    case XPathExpression::eOP_NOTEQUALS:
+    case XPathExpression::eOP_EQUALS:
+    case XPathExpression::eOP_LTE:
+    case XPathExpression::eOP_LT:
+    case XPathExpression::eOP_GTE:
+    case XPathExpression::eOP_GT:
+    case XPathExpression::eOP_PLUS:
+    case XPathExpression::eOP_MINUS:
+    case XPathExpression::eOP_MULT:
+    case XPathExpression::eOP_DIV:
+    case XPathExpression::eOP_MOD:
+    case XPathExpression::eOP_NEG:
+    case XPathExpression::eOP_BOOL:
+    case XPathExpression::eOP_UNION:
+    case XPathExpression::eOP_GROUP:
+    case XPathExpression::eOP_ARGUMENT:
+    case XPathExpression::eOP_FUNCTION_COUNT:
+    case XPathExpression::eOP_FUNCTION_NOT:
+    case XPathExpression::eOP_FUNCTION_BOOLEAN:
+    case XPathExpression::eOP_FUNCTION_NAME_1:
+    case XPathExpression::eOP_FUNCTION_LOCALNAME_1:
+    case XPathExpression::eOP_FUNCTION_FLOOR:
+    case XPathExpression::eOP_FUNCTION_CEILING:
+    case XPathExpression::eOP_FUNCTION_ROUND:
+    case XPathExpression::eOP_FUNCTION_NUMBER_1:
+    case XPathExpression::eOP_FUNCTION_STRING_1:
+    case XPathExpression::eOP_FUNCTION_STRINGLENGTH_1:
+    case XPathExpression::eOP_FUNCTION_NAMESPACEURI_1:
+    case XPathExpression::eOP_FUNCTION_SUM:
+    case XPathExpression::eOP_FUNCTION_CONCAT:
+    case XPathExpression::eOP_FUNCTION_TRANSLATE:
+    case XPathExpression::eOP_FUNCTION:
+    case XPathExpression::eOP_EXTFUNCTION:
+        {
+            const OpCodeMapValueType    theOpCode = m_expression.getOpCodeMapValue(opPos);
 
-    case XPathExpression::eFROM_PRECEDING:
-        opPos = findPreceeding(executionContext, context, opPos, stepType, *subQueryResults);
-        break;
+            const OpCodeMapPositionType     theEnd =
+                m_expression.getNextOpCodePosition(opPos);
 
-    case XPathExpression::eFROM_PRECEDING_SIBLINGS:
-        opPos = findPreceedingSiblings(executionContext, context, opPos, stepType, *subQueryResults);
+            // The arguments of a function call follow its function
+            // ID, or namespace and name, and its argument count.
+            const OpCodeMapPositionType     theStart =
+                theOpCode == XPathExpression::eOP_FUNCTION_TRANSLATE ||
+                theOpCode == XPathExpression::eOP_FUNCTION ||
+                theOpCode == XPathExpression::eOP_EXTFUNCTION ?
+                    opPos + 4 : opPos + 2;
+
+            for (OpCodeMapPositionType i = theStart;
+                    i < theEnd && m_expression.getOpCodeMapValue(i) != XPathExpression::eENDOP;
+                        i = m_expression.getNextOpCodePosition(i))
+            {
+                compileExpression(i);
+            }
+        }
         break;
 
-    case XPathExpression::eFROM_NAMESPACE:
-        opPos = findNamespace(executionContext, context, opPos,  stepType, *subQueryResults);
+    case XPathExpression::eOP_LOCATIONPATH:
+        compileLocationPath(opPos);
         break;
 
     default:
-        opPos = findNodesOnUnknownAxis(executionContext, context, opPos, stepType, *subQueryResults);
+        // Literals, variables, and anything without location
+        // paths inside of it.
         break;
     }
+}
 
-    OpCodeMapValueType  nextStepType = currentExpression.getOpCodeMapValue(opPos);
-
-    // Push and pop the context node list...
-    XPathExecutionContext::ContextNodeListPushAndPop    thePushAndPop(
-                                        executionContext,
-                                        *subQueryResults);
 
-    if(XPathExpression::eOP_PREDICATE == nextStepType ||
-       XPathExpression::eOP_PREDICATE_WITH_POSITION == nextStepType)
-    {
-        opPos =
-            predicates(
-                executionContext,
-                opPos, 
-                *subQueryResults);
 
-        nextStepType = currentExpression.getOpCodeMapValue(opPos);
-    }
+void
+XPath::compileLocationPath(OpCodeMapPositionType    opPos)
+{
+    OpCodeMapPositionType   theStepPos = opPos + 2;
 
-    if(XPathExpression::eENDOP != nextStepType && continueStepRecursion == true)
+    for (;;)
     {
-        const NodeRefListBase::size_type    nContexts = subQueryResults->getLength();
+        const OpCodeMapValueType    theStepType = m_expression.getOpCodeMapValue(theStepPos);
 
-        if (nContexts > 0)
+        switch(theStepType)
         {
-            for(NodeRefListBase::size_type i = 0; i < nContexts; i++)
+        case XPathExpression::eENDOP:
+            return;
+
+        case XPathExpression::eOP_VARIABLE:
+        case XPathExpression::eOP_FUNCTION:
+        case XPathExpression::eOP_EXTFUNCTION:
+        case XPathExpression::eOP_GROUP:
+            // A filter expression.
+            compileExpression(theStepPos);
+
+            theStepPos = compilePredicates(m_expression.getNextOpCodePosition(theStepPos));
+            continue;
+
+        case XPathExpression::eFROM_PARENT:
+        case XPathExpression::eFROM_SELF:
+        case XPathExpression::eFROM_ANCESTORS:
+        case XPathExpression::eFROM_ANCESTORS_OR_SELF:
+        case XPathExpression::eFROM_ATTRIBUTES:
+        case XPathExpression::eFROM_CHILDREN:
+        case XPathExpression::eFROM_DESCENDANTS:
+        case XPathExpression::eFROM_DESCENDANTS_OR_SELF:
+        case XPathExpression::eFROM_FOLLOWING:
+        case XPathExpression::eFROM_FOLLOWING_SIBLINGS:
+        case XPathExpression::eFROM_PRECEDING:
+        case XPathExpression::eFROM_PRECEDING_SIBLINGS:
+        case XPathExpression::eFROM_NAMESPACE:
             {
-                XalanNode* const    node = subQueryResults->item(i);
-                assert(node != 0);
-
-                BorrowReturnMutableNodeRefList  mnl(executionContext);
-
-                step(executionContext, node, opPos, *mnl);
+                const NodeTester    theTester(
+                                *this,
+                                theStepPos + 3,
+                                m_expression.getOpCodeArgumentLength(theStepPos),
+                                theStepType);
 
-                if (mnl->empty() == false)
+                if (theTester.isValid() == true)
                 {
-                    if(queryResults.empty() == false)
+                    if (m_compiledTesterIndexes.empty() == true)
                     {
-                        queryResults.addNodesInDocOrder(*mnl, executionContext);
-
-                        queryResults.setDocumentOrder();
+                        m_compiledTesterIndexes.resize(m_expression.opCodeMapSize(), 0);
                     }
-                    else
-                    {
-                        assert(mnl->getDocumentOrder() == true);
 
-                        queryResults.swap(*mnl);
-                    }
+                    const OpCodeMapSizeType     theIndex = getOpCodeMapIndex(theStepPos + 3);
+                    assert(theIndex < OpCodeMapSizeType(m_compiledTesterIndexes.size()));
+
+                    m_compiledTesters.push_back(theTester);
+                    m_compiledTesterIndexes[theIndex] = m_compiledTesters.size();
                 }
             }
+            break;
 
-            if (queryResults.empty() == true)
-            {
-                queryResults.setDocumentOrder();
-            }
+        default:
+            // The root, or an unknown axis.
+            break;
         }
+
+        compilePredicates(theStepPos + m_expression.getOpCodeMapValue(theStepPos + 2));
+
+        theStepPos += m_expression.getOpCodeMapValue(theStepPos + 1);
     }
-    else
-    {
-        if (subQueryResults->empty() == true)
-        {
-            queryResults.clear();
+}
 
-            queryResults.setDocumentOrder();
-        }
-        else if (subQueryResults->getReverseDocumentOrder() == true)
-        {
-            queryResults.swap(*subQueryResults);
 
-            queryResults.reverse();
-        }
-        else
+
+XPath::OpCodeMapPositionType
+XPath::compilePredicates(OpCodeMapPositionType  opPos)
+{
+    while(m_expression.getOpCodeMapValue(opPos) == XPathExpression::eOP_PREDICATE ||
+          m_expression.getOpCodeMapValue(opPos) == XPathExpression::eOP_PREDICATE_WITH_POSITION)
+    {
+        compileExpression(opPos + 2);
+
+        opPos = m_expression.getNextOpCodePosition(opPos);
+    }
+
+    return opPos;
+}
+
+
+
+XPath::NodeTester
+XPath::getStepTester(
+            XPathExecutionContext&  executionContext,
+            OpCodeMapPositionType   opPos,
+            OpCodeMapValueType      argLen,
+            OpCodeMapValueType      stepType) const
+{
+    const NodeTesterVectorType::size_type   theTesterIndex =
+        m_compiledTesterIndexes.empty() == true ?
+            0 :
+            m_compiledTesterIndexes[getOpCodeMapIndex(opPos)];
+
+    if (theTesterIndex != 0)
+    {
+        return NodeTester(
+                    m_compiledTesters[theTesterIndex - 1],
+                    executionContext);
+    }
+    else
+    {
+        return NodeTester(
+                    *this,
+                    executionContext,
+                    opPos,
+                    argLen,
+                    stepType);
+    }
+}
+
+
+
+const XalanDOMString*
+XPath::getNameTestNamespace() const
+{
+    if (m_compiledPatterns.size() == 1 &&
+        m_compiledPatterns[0].getStepCount() == 1)
+    {
+        const CompiledStepPattern&  theStep =
+            m_compiledSteps[m_compiledPatterns[0].getFirstStep()];
+
+        if (theStep.getHasPredicates() == false &&
+            (theStep.getStepType() == XPathExpression::eMATCH_IMMEDIATE_ANCESTOR ||
+             theStep.getStepType() == XPathExpression::eMATCH_ATTRIBUTE))
+        {
+            return theStep.getTester().getNameTestNamespace();
+        }
+    }
+
+    return 0;
+}
+
+
+
+bool
+XPath::getAttributeNameTest(
+            const XalanDOMString*&  theNamespace,
+            const XalanDOMString*&  theLocalName) const
+{
+    const OpCodeMapPositionType     opPos = m_expression.getInitialOpCodePosition();
+
+    if (m_compiledTesterIndexes.empty() == true ||
+        m_expression.getOpCodeMapValue(opPos) != XPathExpression::eOP_XPATH ||
+        m_expression.getOpCodeMapValue(opPos + 2) != XPathExpression::eOP_LOCATIONPATH)
+    {
+        return false;
+    }
+
+    const OpCodeMapPositionType     theStepPos = opPos + 4;
+
+    // With no predicates, the end of the path follows the node test.
+    if (m_expression.getOpCodeMapValue(theStepPos) != XPathExpression::eFROM_ATTRIBUTES ||
+        m_expression.getOpCodeMapValue(theStepPos + m_expression.getOpCodeMapValue(theStepPos + 2)) != XPathExpression::eENDOP)
+    {
+        return false;
+    }
+
+    const NodeTesterVectorType::size_type   theTesterIndex =
+        m_compiledTesterIndexes[getOpCodeMapIndex(theStepPos + 3)];
+
+    if (theTesterIndex == 0)
+    {
+        return false;
+    }
+
+    const NodeTester&   theTester = m_compiledTesters[theTesterIndex - 1];
+
+    const XalanDOMString* const     theTesterNamespace = theTester.getNameTestNamespace();
+
+    if (theTesterNamespace == 0)
+    {
+        return false;
+    }
+
+    assert(theTester.getTargetLocalName() != 0);
+
+    theNamespace = theTesterNamespace;
+    theLocalName = theTester.getTargetLocalName();
+
+    return true;
+}
+
+
+
+bool
+XPath::compileLocationPathPattern(OpCodeMapPositionType     opPos)
+{
+    OpCodeMapPositionType   stepOpPos = opPos + 2;
+
+    OpCodeMapValueType      stepType = m_expression.getOpCodeMapValue(stepOpPos);
+
+    while(stepType != XPathExpression::eENDOP)
+    {
+        const OpCodeMapPositionType     nextStepOpPos =
+            m_expression.getNextOpCodePosition(stepOpPos);
+
+        const OpCodeMapValueType        nextStepType =
+            m_expression.getOpCodeMapValue(nextStepOpPos);
+
+        OpCodeMapValueType  testStepType = stepType;
+
+        switch(stepType)
+        {
+        case XPathExpression::eMATCH_ATTRIBUTE:
+            testStepType = XPathExpression::eFROM_ATTRIBUTES;
+            break;
+
+        case XPathExpression::eFROM_ROOT:
+        case XPathExpression::eMATCH_ANY_ANCESTOR:
+        case XPathExpression::eMATCH_ANY_ANCESTOR_WITH_PREDICATE:
+        case XPathExpression::eMATCH_IMMEDIATE_ANCESTOR:
+            break;
+
+        default:
+            // Function calls, and anything else, are left
+            // to the interpreter.
+            return false;
+        }
+
+        const OpCodeMapValueType    argLen =
+            m_expression.getOpCodeArgumentLength(stepOpPos);
+
+        const NodeTester    theTester(
+                                *this,
+                                stepOpPos + 3,
+                                argLen,
+                                testStepType);
+
+        if (theTester.isValid() == false)
+        {
+            return false;
+        }
+
+        const OpCodeMapPositionType     thePredicateOpPos = stepOpPos + 3 + argLen;
+
+        const OpCodeMapValueType        thePredicateType =
+            m_expression.getOpCodeMapValue(thePredicateOpPos);
+
+        m_compiledSteps.push_back(
+            CompiledStepPattern(
+                stepType,
+                stepOpPos,
+                thePredicateOpPos,
+                thePredicateType == XPathExpression::eOP_PREDICATE ||
+                    thePredicateType == XPathExpression::eOP_PREDICATE_WITH_POSITION,
+                stepType == XPathExpression::eFROM_ROOT &&
+                    (nextStepType == XPathExpression::eMATCH_ANY_ANCESTOR ||
+                     nextStepType == XPathExpression::eMATCH_ANY_ANCESTOR_WITH_PREDICATE),
+                theTester));
+
+        stepOpPos = nextStepOpPos;
+        stepType = nextStepType;
+    }
+
+    return true;
+}
+
+
+
+XPath::eMatchScore
+XPath::compiledLocationPathPattern(
+            XPathExecutionContext&                  executionContext,
+            XalanNode&                              context,
+            const CompiledLocationPathPattern&      thePattern) const
+{
+    assert(thePattern.getStepCount() > 0);
+
+    // This is the same as stepPattern(), without the recursion:
+    // The last step is matched against the node, and each preceding
+    // step is matched against the parent of the node matched by the
+    // step that follows it.
+    const CompiledStepPatternVectorType::size_type  theFirstStep =
+        thePattern.getFirstStep();
+
+    CompiledStepPatternVectorType::size_type    theStep =
+        theFirstStep + thePattern.getStepCount() - 1;
+
+    XalanNode*  theContext = &context;
+
+    for(;;)
+    {
+        const eMatchScore   score =
+            compiledStepPattern(
+                executionContext,
+                theContext,
+                m_compiledSteps[theStep]);
+
+        if (score == eMatchScoreNone)
+        {
+            return eMatchScoreNone;
+        }
+        else if (theStep == theFirstStep)
+        {
+            return thePattern.getStepCount() == 1 ? score : eMatchScoreOther;
+        }
+
+        assert(theContext != 0);
+
+        theContext = DOMServices::getParentOfNode(*theContext);
+
+        if (theContext == 0)
+        {
+            return eMatchScoreNone;
+        }
+
+        --theStep;
+    }
+}
+
+
+
+XPath::eMatchScore
+XPath::compiledStepPattern(
+            XPathExecutionContext&      executionContext,
+            XalanNode*&                 context,
+            const CompiledStepPattern&  theStep) const
+{
+    assert(context != 0);
+
+    const NodeTester    theTester(theStep.getTester(), executionContext);
+
+    eMatchScore     score = eMatchScoreNone;
+
+    bool    fDoPredicates = true;
+
+    switch(theStep.getStepType())
+    {
+    case XPathExpression::eFROM_ROOT:
+        {
+            const XalanNode::NodeType   nodeType = context->getNodeType();
+
+            if (nodeType == XalanNode::DOCUMENT_NODE ||
+                nodeType == XalanNode::DOCUMENT_FRAGMENT_NODE)
+            {
+                score = eMatchScoreOther;
+            }
+            else if (theStep.getMatchAncestors() == true)
+            {
+                while(0 != context)
+                {
+                    score = theTester(*context, context->getNodeType());
+
+                    if(eMatchScoreNone != score)
+                        break;
+
+                    context = DOMServices::getParentOfNode(*context);
+                }
+            }
+        }
+        break;
+
+    case XPathExpression::eMATCH_ATTRIBUTE:
+        score = theTester(*context, context->getNodeType());
+        break;
+
+    case XPathExpression::eMATCH_ANY_ANCESTOR:
+    case XPathExpression::eMATCH_ANY_ANCESTOR_WITH_PREDICATE:
+        {
+            fDoPredicates = false;
+
+            XalanNode::NodeType     nodeType = context->getNodeType();
+
+            if(nodeType != XalanNode::ATTRIBUTE_NODE)
+            {
+                for(;;)
+                {
+                    score = theTester(*context, nodeType);
+
+                    if (eMatchScoreNone != score)
+                    {
+                        if (theStep.getHasPredicates() == true)
+                        {
+                            score = 
+                                doStepPredicate(
+                                    executionContext,
+                                    context, 
+                                    theStep.getPredicateOpPos(),
+                                    theStep.getStartOpPos(),
+                                    score);
+                        }
+
+                        if (eMatchScoreNone != score)
+                        {
+                            break;
+                        }
+                    }
+
+                    context = DOMServices::getParentOfNode(*context);
+
+                    if (context == 0)
+                        break;
+
+                    nodeType = context->getNodeType();
+                }
+            }
+        }
+        break;
+
+    case XPathExpression::eMATCH_IMMEDIATE_ANCESTOR:
+        {
+            const XalanNode::NodeType   nodeType = context->getNodeType();
+
+            if(nodeType != XalanNode::ATTRIBUTE_NODE)
+            {
+                score = theTester(*context, nodeType);
+            }
+        }
+        break;
+
+    default:
+        assert(false);
+        break;
+    }
+
+    if (fDoPredicates == true &&
+        score != eMatchScoreNone &&
+        theStep.getHasPredicates() == true)
+    {
+        score =
+            doStepPredicate(
+                executionContext,
+                context, 
+                theStep.getPredicateOpPos(),
+                theStep.getStartOpPos(),
+                score);
+    }
+
+    return score;
+}
+
+
+
+void
+XPath::step(
+            XPathExecutionContext&  executionContext,
+            XalanNode*              context,
+            OpCodeMapPositionType   opPos,
+            MutableNodeRefList&     queryResults) const
+{
+    const XPathExpression&  currentExpression = getExpression();
+
+    const OpCodeMapValueType   stepType =
+        currentExpression.getOpCodeMapValue(opPos);
+
+    typedef XPathExecutionContext::BorrowReturnMutableNodeRefList   BorrowReturnMutableNodeRefList;
+
+    BorrowReturnMutableNodeRefList  subQueryResults(executionContext);
+
+    bool    continueStepRecursion = true;
+
+    switch(stepType)
+    {
+    case XPathExpression::eOP_VARIABLE:
+    case XPathExpression::eOP_EXTFUNCTION:
+    case XPathExpression::eOP_FUNCTION:
+    case XPathExpression::eOP_GROUP:
+        opPos = findNodeSet(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eFROM_ROOT:
+        opPos = findRoot(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eFROM_PARENT:
+        opPos = findParent(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eFROM_SELF:
+        opPos = findSelf(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eFROM_ANCESTORS:
+        opPos = findAncestors(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eFROM_ANCESTORS_OR_SELF:
+        opPos = findAncestorsOrSelf(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eMATCH_ATTRIBUTE:
+        continueStepRecursion = false;
+        // fall-through on purpose.
+
+    case XPathExpression::eFROM_ATTRIBUTES:
+        opPos = findAttributes(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eMATCH_ANY_ANCESTOR:
+    case XPathExpression::eMATCH_IMMEDIATE_ANCESTOR:
+    case XPathExpression::eMATCH_ANY_ANCESTOR_WITH_PREDICATE:
+        continueStepRecursion = false;
+        // fall-through on purpose.
+
+    case XPathExpression::eFROM_CHILDREN:
+        opPos = findChildren(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eFROM_DESCENDANTS:
+    case XPathExpression::eFROM_DESCENDANTS_OR_SELF:
+        opPos = findDescendants(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eFROM_FOLLOWING:
+        opPos = findFollowing(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eFROM_FOLLOWING_SIBLINGS:
+        opPos = findFollowingSiblings(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eFROM_PRECEDING:
+        opPos = findPreceeding(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eFROM_PRECEDING_SIBLINGS:
+        opPos = findPreceedingSiblings(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+
+    case XPathExpression::eFROM_NAMESPACE:
+        opPos = findNamespace(executionContext, context, opPos,  stepType, *subQueryResults);
+        break;
+
+    default:
+        opPos = findNodesOnUnknownAxis(executionContext, context, opPos, stepType, *subQueryResults);
+        break;
+    }
+
+    OpCodeMapValueType  nextStepType = currentExpression.getOpCodeMapValue(opPos);
+
+    // Push and pop the context node list...
+    XPathExecutionContext::ContextNodeListPushAndPop    thePushAndPop(
+                                        executionContext,
+                                        *subQueryResults);
+
+    if(XPathExpression::eOP_PREDICATE == nextStepType ||
+       XPathExpression::eOP_PREDICATE_WITH_POSITION == nextStepType)
+    {
+        opPos =
+            predicates(
+                executionContext,
+                opPos, 
+                *subQueryResults);
+
+        nextStepType = currentExpression.getOpCodeMapValue(opPos);
+    }
+
+    if(XPathExpression::eENDOP != nextStepType && continueStepRecursion == true)
+    {
+        const NodeRefListBase::size_type    nContexts = subQueryResults->getLength();
+
+        if (nContexts > 0)
+        {
+            for(NodeRefListBase::size_type i = 0; i < nContexts; i++)
+            {
+                XalanNode* const    node = subQueryResults->item(i);
+                assert(node != 0);
+
+                BorrowReturnMutableNodeRefList  mnl(executionContext);
+
+                step(executionContext, node, opPos, *mnl);
+
+                if (mnl->empty() == false)
+                {
+                    if(queryResults.empty() == false)
+                    {
+                        queryResults.addNodesInDocOrder(*mnl, executionContext);
+
+                        queryResults.setDocumentOrder();
+                    }
+                    else
+                    {
+                        assert(mnl->getDocumentOrder() == true);
+
+                        queryResults.swap(*mnl);
+                    }
+                }
+            }
+
+            if (queryResults.empty() == true)
+            {
+                queryResults.setDocumentOrder();
+            }
+        }
+    }
+    else
+    {
+        if (subQueryResults->empty() == true)
+        {
+            queryResults.clear();
+
+            queryResults.setDocumentOrder();
+        }
+        else if (subQueryResults->getReverseDocumentOrder() == true)
+        {
+            queryResults.swap(*subQueryResults);
+
+            queryResults.reverse();
+        }
+        else
         {
             assert(subQueryResults->getDocumentOrder() == true);
 
@@ -3583,11 +4269,11 @@ XPath::findParent(
         if(argLen > 0)
         {
             const NodeTester    theTester(
-                            *this,
-                            executionContext,
-                            opPos,
-                            argLen,
-                            stepType);
+                            getStepTester(
+                                executionContext,
+                                opPos,
+                                argLen,
+                                stepType));
 
             const eMatchScore   score = theTester(*theParent, theParent->getNodeType());
 
@@ -3634,11 +4320,11 @@ XPath::findSelf(
     else
     {
         const NodeTester    theTester(
-                        *this,
-                        executionContext,
-                        opPos,
-                        argLen,
-                        stepType);
+                        getStepTester(
+                            executionContext,
+                            opPos,
+                            argLen,
+                            stepType));
 
         const eMatchScore   score =
             theTester(*context, context->getNodeType());
@@ -3679,11 +4365,11 @@ XPath::findAncestors(
     if (context != 0)
     {
         const NodeTester    theTester(
-                        *this,
-                        executionContext,
-                        opPos,
-                        argLen,
-                        stepType);
+                        getStepTester(
+                            executionContext,
+                            opPos,
+                            argLen,
+                            stepType));
 
         do
         {
@@ -3725,11 +4411,11 @@ XPath::findAncestorsOrSelf(
     opPos += 3;
 
     const NodeTester    theTester(
-                    *this,
-                    executionContext,
-                    opPos,
-                    argLen,
-                    stepType);
+                    getStepTester(
+                        executionContext,
+                        opPos,
+                        argLen,
+                        stepType));
 
     do
     {
@@ -3780,11 +4466,11 @@ XPath::findAttributes(
             if (nAttrs != 0)
             {
                 const NodeTester    theTester(
-                                *this,
-                                executionContext,
-                                opPos,
-                                argLen,
-                                stepType);
+                                getStepTester(
+                                    executionContext,
+                                    opPos,
+                                    argLen,
+                                    stepType));
 
                 for (XalanSize_t j = 0; j < nAttrs; j++)
                 {
@@ -3833,11 +4519,11 @@ XPath::findChildren(
     if (child != 0)
     {
         const NodeTester    theTester(
-                        *this,
-                        executionContext,
-                        opPos,
-                        argLen,
-                        stepType);
+                        getStepTester(
+                            executionContext,
+                            opPos,
+                            argLen,
+                            stepType));
 
         do
         {
@@ -3882,11 +4568,11 @@ XPath::findDescendants(
     opPos += 3;
 
     const NodeTester    theTester(
-                        *this,
-                        executionContext,
-                        opPos,
-                        argLen,
-                        stepType);
+                        getStepTester(
+                            executionContext,
+                            opPos,
+                            argLen,
+                            stepType));
 
     do
     {                   
@@ -3957,11 +4643,11 @@ XPath::findFollowing(
     XalanNode*              pos = context;
 
     const NodeTester    theTester(
-                    *this,
-                    executionContext,
-                    opPos,
-                    argLen,
-                    stepType);
+                    getStepTester(
+                        executionContext,
+                        opPos,
+                        argLen,
+                        stepType));
 
     while(0 != pos)
     {
@@ -4050,11 +4736,11 @@ XPath::findFollowingSiblings(
     if (pos != 0)
     {
         const NodeTester    theTester(
-                        *this,
-                        executionContext,
-                        opPos,
-                        argLen,
-                        stepType);
+                        getStepTester(
+                            executionContext,
+                            opPos,
+                            argLen,
+                            stepType));
 
         do
         {
@@ -4158,11 +4844,11 @@ XPath::findPreceeding(
         contextIsAttribute == true ? DOMServices::getParentOfNode(*context) : 0;
 
     const NodeTester    theTester(
-                        *this,
-                        executionContext,
-                        opPos,
-                        argLen,
-                        stepType);
+                        getStepTester(
+                            executionContext,
+                            opPos,
+                            argLen,
+                            stepType));
 
     while(0 != pos)
     {
@@ -4268,11 +4954,11 @@ XPath::findPreceedingSiblings(
     if (pos != 0)
     {
         const NodeTester    theTester(
-                        *this,
-                        executionContext,
-                        opPos,
-                        argLen,
-                        stepType);
+                        getStepTester(
+                            executionContext,
+                            opPos,
+                            argLen,
+                            stepType));
 
         do
         {
@@ -4299,11 +4985,11 @@ XPath::findPreceedingSiblings(
         if (pos != context)
         {
             const NodeTester    theTester(
-                            *this,
-                            executionContext,
-                            opPos,
-                            argLen,
-                            stepType);
+                            getStepTester(
+                                executionContext,
+                                opPos,
+                                argLen,
+                                stepType));
 
             do
             {
@@ -4361,11 +5047,11 @@ XPath::findNamespace(
         const XalanNode*        theCurrentNode = context;
 
         const NodeTester    theTester(
-                        *this,
-                        executionContext,
-                        opPos,
-                        argLen,
-                        stepType);
+                        getStepTester(
+                            executionContext,
+                            opPos,
+                            argLen,
+                            stepType));
 
         NodeRefListBase::size_type  nNSFound = 0;
         bool                        defaultNSFound = false;
@@ -4618,8 +5304,83 @@ XPath::NodeTester::NodeTester(
     m_testFunction(0),
     m_testFunction2(&NodeTester::testDefault2)
 {
-    const XPathExpression&  theExpression = xpath.getExpression();
+    if (initialize(xpath.getExpression(), opPos, argLen, stepType) == false)
+    {
+        GetCachedString     theGuard(executionContext);
+
+        executionContext.problem(
+            XPathExecutionContext::eXPath,
+            XPathExecutionContext::eError,
+            XalanMessageLoader::getMessage(
+                theGuard.get(),
+                XalanMessages::ArgLengthNodeTestIsIncorrect_1Param,
+                "processing-instruction()"),
+            xpath.getLocator(),
+            executionContext.getCurrentNode());
+    }
+
+    assert(m_testFunction != 0);
+}
+
+
+
+XPath::NodeTester::NodeTester(
+            const XPath&            xpath,
+            OpCodeMapPositionType   opPos,
+            OpCodeMapValueType      argLen,
+            OpCodeMapValueType      stepType) :
+    m_executionContext(0),
+    m_targetNamespace(0),
+    m_targetLocalName(0),
+    m_testFunction(0),
+    m_testFunction2(&NodeTester::testDefault2)
+{
+    initialize(xpath.getExpression(), opPos, argLen, stepType);
+}
+
+
+
+XPath::NodeTester::NodeTester(
+            const NodeTester&       theSource,
+            XPathExecutionContext&  executionContext) :
+    m_executionContext(&executionContext),
+    m_targetNamespace(theSource.m_targetNamespace),
+    m_targetLocalName(theSource.m_targetLocalName),
+    m_testFunction(theSource.m_testFunction),
+    m_testFunction2(theSource.m_testFunction2)
+{
+}
+
+
+
+const XalanDOMString*
+XPath::NodeTester::getNameTestNamespace() const
+{
+    if (m_testFunction == &NodeTester::testElementNCName ||
+        m_testFunction == &NodeTester::testAttributeNCName)
+    {
+        return &s_emptyString;
+    }
+    else if (m_testFunction == &NodeTester::testElementQName ||
+             m_testFunction == &NodeTester::testAttributeQName)
+    {
+        return m_targetNamespace;
+    }
+    else
+    {
+        return 0;
+    }
+}
+
 
+
+bool
+XPath::NodeTester::initialize(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            OpCodeMapValueType      argLen,
+            OpCodeMapValueType      stepType)
+{
     switch(theExpression.getOpCodeMapValue(opPos))
     {
     case XPathExpression::eNODETYPE_COMMENT:
@@ -4645,17 +5406,7 @@ XPath::NodeTester::NodeTester(
         }
         else
         {
-            GetCachedString     theGuard(executionContext);
-
-            executionContext.problem(
-                XPathExecutionContext::eXPath,
-                XPathExecutionContext::eError,
-                XalanMessageLoader::getMessage(
-                    theGuard.get(),
-                    XalanMessages::ArgLengthNodeTestIsIncorrect_1Param,
-                    "processing-instruction()"),
-                xpath.getLocator(),
-                executionContext.getCurrentNode());
+            return false;
         }
         break;
 
@@ -4756,6 +5507,8 @@ XPath::NodeTester::NodeTester(
     }
 
     assert(m_testFunction != 0);
+
+    return true;
 }
 
 
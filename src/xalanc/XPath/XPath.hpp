@@ -72,6 +72,7 @@ public:
 
     typedef XPathExpression::OpCodeMapPositionType              OpCodeMapPositionType;
     typedef XPathExpression::OpCodeMapValueType                 OpCodeMapValueType;
+    typedef XPathExpression::OpCodeMapSizeType                  OpCodeMapSizeType;
     typedef XPathExpression::TokenQueuePositionType             TokenQueuePositionType;
     typedef XPathExecutionContext::GetCachedString              GetCachedString;
     typedef XPathExecutionContext::PrefixResolverSetAndRestore  PrefixResolverSetAndRestore;
@@ -191,6 +192,56 @@ public:
         m_expression.shrink();
     }
 
+    /**
+     * Compile a match pattern into a pre-linked list of step
+     * matchers, with the node tests already bound.  getMatchScore()
+     * will then use the compiled steps instead of decoding the op map
+     * on every call.  Location path patterns which cannot be compiled
+     * are still evaluated by the interpreter.  The XPath processor
+     * calls this once the pattern has been parsed.
+     */
+    void
+    compileMatchPattern();
+
+    /**
+     * Compile an expression by binding the node test of each step of
+     * its location paths, including those in predicates and function
+     * arguments.  The axis functions will then copy the bound node test
+     * instead of decoding it from the op map each time the step is
+     * evaluated.  The XPath processor calls this once the expression
+     * has been parsed.
+     */
+    void
+    compileSelectExpression();
+
+    /**
+     * If the compiled match pattern is a single element or attribute
+     * name test with no predicates, such as "foo" or "@x:bar", get the
+     * namespace URI of the name.  Any node of the right type with the
+     * same expanded name matches such a pattern, so the pattern does
+     * not need to be evaluated.
+     *
+     * @return the namespace URI, or 0 if the pattern is not a simple name test
+     */
+    const XalanDOMString*
+    getNameTestNamespace() const;
+
+    /**
+     * If the compiled select expression is a single attribute name
+     * test with no predicates, such as "@foo" or "@x:bar", get the
+     * expanded name of the attribute.  The value of such an expression
+     * is the value of the context node's attribute with that name, so
+     * it can be read without evaluating the expression.
+     *
+     * @param theNamespace set to the namespace URI of the name
+     * @param theLocalName set to the local name
+     * @return true if the expression is a single attribute name test
+     */
+    bool
+    getAttributeNameTest(
+            const XalanDOMString*&  theNamespace,
+            const XalanDOMString*&  theLocalName) const;
+
     /**
      * Execute the XPath from the provided context.
      *
@@ -1044,6 +1095,23 @@ public:
             OpCodeMapValueType      argLen,
             OpCodeMapValueType      stepType);
 
+        /**
+         * Construct a NodeTester for a step of a compiled match
+         * pattern.  The instance is not bound to an execution
+         * context, so it must be bound using the copy constructor
+         * below before it's used.  If the node test is malformed,
+         * isValid() will return false.
+         */
+        NodeTester(
+            const XPath&            xpath,
+            OpCodeMapPositionType   opPos,
+            OpCodeMapValueType      argLen,
+            OpCodeMapValueType      stepType);
+
+        NodeTester(
+            const NodeTester&       theSource,
+            XPathExecutionContext&  executionContext);
+
         NodeTester(
             XPathConstructionContext&   theContext,
             const XalanDOMString&       theNameTest,
@@ -1072,6 +1140,43 @@ public:
             return (this->*m_testFunction2)(context);
         }
 
+        bool
+        isValid() const
+        {
+            return m_testFunction != 0;
+        }
+
+        /**
+         * If the tester tests for an element or attribute with a
+         * particular expanded name, get the namespace URI of the name.
+         *
+         * @return the namespace URI, or 0 if the tester is not a name test
+         */
+        const XalanDOMString*
+        getNameTestNamespace() const;
+
+        /**
+         * Get the namespace URI the tester was initialized with.
+         *
+         * @return the namespace URI, or 0 if there is none
+         */
+        const XalanDOMString*
+        getTargetNamespace() const
+        {
+            return m_targetNamespace;
+        }
+
+        /**
+         * Get the local name the tester was initialized with.
+         *
+         * @return the local name, or 0 if there is none
+         */
+        const XalanDOMString*
+        getTargetLocalName() const
+        {
+            return m_targetLocalName;
+        }
+
         NodeTester&
         operator=(const NodeTester&     theRHS)
         {
@@ -1098,6 +1203,13 @@ public:
             const XalanDOMString&   theNamespaceURI,
             const XalanDOMString&   theLocalName);
 
+        bool
+        initialize(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            OpCodeMapValueType      argLen,
+            OpCodeMapValueType      stepType);
+
     private:
 
 
@@ -2388,6 +2500,22 @@ protected:
             OpCodeMapPositionType   opPos,
             XPathExecutionContext&  executionContext) const;
 
+    /**
+     * Handle the built-in function "translate", when it has been compiled
+     * with a translation table.
+     *
+     * @param context The current source tree context node.
+     * @param opPos The current position in the Op Map.
+     * @param executionContext current execution context
+     * @param theResult The string to which the result is appended.
+     */
+    void
+    functionTranslate(
+            XalanNode*              context,
+            OpCodeMapPositionType   opPos,
+            XPathExecutionContext&  executionContext,
+            XalanDOMString&         theResult) const;
+
     /**
      * Get a numeric operand for an expression.
      * @param context The current source tree context node.
@@ -2418,6 +2546,186 @@ private:
         eDefaultTargetDataSize = 5
     };
 
+    /**
+     * A step of a compiled match pattern.  The node test is
+     * bound when the pattern is compiled, and the positions of
+     * the step and its predicates in the op map are recorded, so
+     * matching does not need to decode the op map.
+     */
+    class CompiledStepPattern
+    {
+    public:
+
+        CompiledStepPattern(
+                OpCodeMapValueType      theStepType,
+                OpCodeMapPositionType   theStartOpPos,
+                OpCodeMapPositionType   thePredicateOpPos,
+                bool                    fHasPredicates,
+                bool                    fMatchAncestors,
+                const NodeTester&       theTester) :
+            m_stepType(theStepType),
+            m_startOpPos(theStartOpPos),
+            m_predicateOpPos(thePredicateOpPos),
+            m_hasPredicates(fHasPredicates),
+            m_matchAncestors(fMatchAncestors),
+            m_tester(theTester)
+        {
+        }
+
+        OpCodeMapValueType
+        getStepType() const
+        {
+            return m_stepType;
+        }
+
+        OpCodeMapPositionType
+        getStartOpPos() const
+        {
+            return m_startOpPos;
+        }
+
+        OpCodeMapPositionType
+        getPredicateOpPos() const
+        {
+            return m_predicateOpPos;
+        }
+
+        bool
+        getHasPredicates() const
+        {
+            return m_hasPredicates;
+        }
+
+        /**
+         * For a root step, whether the step is followed by an
+         * ancestor step, so the ancestors of the context node
+         * must be searched for a match.
+         */
+        bool
+        getMatchAncestors() const
+        {
+            return m_matchAncestors;
+        }
+
+        const NodeTester&
+        getTester() const
+        {
+            return m_tester;
+        }
+
+    private:
+
+        OpCodeMapValueType      m_stepType;
+
+        OpCodeMapPositionType   m_startOpPos;
+
+        OpCodeMapPositionType   m_predicateOpPos;
+
+        bool                    m_hasPredicates;
+
+        bool                    m_matchAncestors;
+
+        NodeTester              m_tester;
+    };
+
+    typedef XalanVector<CompiledStepPattern>    CompiledStepPatternVectorType;
+
+    /**
+     * A location path pattern of a compiled match pattern.  The
+     * steps are stored left to right in the vector of compiled
+     * steps.  If the step count is 0, the location path pattern
+     * could not be compiled, and must be interpreted.
+     */
+    class CompiledLocationPathPattern
+    {
+    public:
+
+        typedef CompiledStepPatternVectorType::size_type    size_type;
+
+        CompiledLocationPathPattern(
+                OpCodeMapPositionType   theOpPos,
+                size_type               theFirstStep,
+                size_type               theStepCount) :
+            m_opPos(theOpPos),
+            m_firstStep(theFirstStep),
+            m_stepCount(theStepCount)
+        {
+        }
+
+        OpCodeMapPositionType
+        getOpPos() const
+        {
+            return m_opPos;
+        }
+
+        size_type
+        getFirstStep() const
+        {
+            return m_firstStep;
+        }
+
+        size_type
+        getStepCount() const
+        {
+            return m_stepCount;
+        }
+
+    private:
+
+        OpCodeMapPositionType   m_opPos;
+
+        size_type               m_firstStep;
+
+        size_type               m_stepCount;
+    };
+
+    typedef XalanVector<CompiledLocationPathPattern>    CompiledLocationPathPatternVectorType;
+
+    bool
+    compileLocationPathPattern(OpCodeMapPositionType    opPos);
+
+    eMatchScore
+    compiledLocationPathPattern(
+            XPathExecutionContext&                  executionContext,
+            XalanNode&                              context,
+            const CompiledLocationPathPattern&      thePattern) const;
+
+    eMatchScore
+    compiledStepPattern(
+            XPathExecutionContext&      executionContext,
+            XalanNode*&                 context,
+            const CompiledStepPattern&  theStep) const;
+
+    typedef XalanVector<NodeTester>             NodeTesterVectorType;
+
+    typedef XalanVector<NodeTesterVectorType::size_type>    NodeTesterIndexVectorType;
+
+    void
+    compileExpression(OpCodeMapPositionType     opPos);
+
+    void
+    compileLocationPath(OpCodeMapPositionType   opPos);
+
+    OpCodeMapPositionType
+    compilePredicates(OpCodeMapPositionType     opPos);
+
+    OpCodeMapSizeType
+    getOpCodeMapIndex(OpCodeMapPositionType     opPos) const
+    {
+        return OpCodeMapSizeType(opPos - m_expression.getInitialOpCodePosition());
+    }
+
+    /**
+     * Get the node tester for a step, using the compiled node test
+     * if there is one.
+     */
+    NodeTester
+    getStepTester(
+            XPathExecutionContext&  executionContext,
+            OpCodeMapPositionType   opPos,
+            OpCodeMapValueType      argLen,
+            OpCodeMapValueType      stepType) const;
+
     OpCodeMapPositionType
     getInitialOpCodePosition() const
     {
@@ -2660,6 +2968,30 @@ private:
      */
     bool                m_inStylesheet;
 
+    /**
+     * The compiled steps of a match pattern, if the
+     * pattern has been compiled.
+     */
+    CompiledStepPatternVectorType           m_compiledSteps;
+
+    /**
+     * The compiled location path patterns of a match pattern.
+     * If empty, the pattern has not been compiled.
+     */
+    CompiledLocationPathPatternVectorType   m_compiledPatterns;
+
+    /**
+     * The bound node tests of the steps of a select expression.
+     */
+    NodeTesterVectorType                    m_compiledTesters;
+
+    /**
+     * For each op map index, one more than the index of the bound node
+     * test which starts there, or 0 if there is none.  If empty, no
+     * node test was bound.
+     */
+    NodeTesterIndexVectorType               m_compiledTesterIndexes;
+
     /**
      *
      * This is the table of installed functions.
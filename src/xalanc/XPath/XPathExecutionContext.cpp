@@ -20,6 +20,10 @@
 
 
 
+#include "XObject.hpp"
+
+
+
 namespace XALAN_CPP_NAMESPACE {
 
 
@@ -40,4 +44,36 @@ XPathExecutionContext::~XPathExecutionContext()
 
 
 
+bool
+XPathExecutionContext::getNodeNumber(
+            const XalanNode&    /* theNode */,
+            double&             /* theNumber */) const
+{
+    return false;
+}
+
+
+
+const XObjectPtr
+XPathExecutionContext::getGlobalVariable(
+            const XalanQName&   name,
+            int                 /* theSlot */,
+            const Locator*      locator)
+{
+    return getVariable(name, locator);
+}
+
+
+
+const XObjectPtr
+XPathExecutionContext::getLocalVariable(
+            const XalanQName&   name,
+            int                 /* theSlot */,
+            const Locator*      locator)
+{
+    return getVariable(name, locator);
+}
+
+
+
 }
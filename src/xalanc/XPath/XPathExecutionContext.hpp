@@ -171,6 +171,20 @@ public:
             const XalanNode&    node1,
             const XalanNode&    node2) const = 0;
 
+    /**
+     * Get the number value of a node from the source tree's cache,
+     * if the tree provides one.  The default implementation returns
+     * false, so the caller converts the node itself.
+     *
+     * @param theNode The node
+     * @param theNumber The number value of the node, if available
+     * @return true if theNumber was set, or false if it was not.
+     */
+    virtual bool
+    getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const;
+
     /**
      * Push the node list for current context.
      * 
@@ -564,6 +578,39 @@ public:
             const XalanQName&   name,
             const Locator*      locator = 0) = 0;
 
+    /**
+     * Locate a global variable using the slot it was assigned when the
+     * stylesheet was compiled, and return a pointer to the object.  The
+     * default implementation ignores the slot and calls getVariable().
+     *
+     * @param theName name of variable
+     * @param theSlot slot of the variable
+     * @return An XObjectPtr instance.  If the variable is not found, an exception
+     *         is thrown, or the routine returns an instance of XUnknown.
+     */
+    virtual const XObjectPtr
+    getGlobalVariable(
+            const XalanQName&   name,
+            int                 theSlot,
+            const Locator*      locator = 0);
+
+    /**
+     * Locate a local variable or param using the slot it was assigned
+     * in its template when the stylesheet was compiled, and return a
+     * pointer to the object.  The default implementation ignores the
+     * slot and calls getVariable().
+     *
+     * @param theName name of variable
+     * @param theSlot slot of the variable
+     * @return An XObjectPtr instance.  If the variable is not found, an exception
+     *         is thrown, or the routine returns an instance of XUnknown.
+     */
+    virtual const XObjectPtr
+    getLocalVariable(
+            const XalanQName&   name,
+            int                 theSlot,
+            const Locator*      locator = 0);
+
     /**
      * Retrieve the resolver for namespaces.
      * 
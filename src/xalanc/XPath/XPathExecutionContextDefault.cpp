@@ -245,6 +245,16 @@ XPathExecutionContextDefault::isNodeAfter(
 
 
 
+bool
+XPathExecutionContextDefault::getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const
+{
+    return m_domSupport->getNodeNumber(theNode, theNumber);
+}
+
+
+
 void    
 XPathExecutionContextDefault::pushContextNodeList(const NodeRefListBase&    theList)
 {
@@ -477,6 +487,28 @@ XPathExecutionContextDefault::getVariable(
 
 
 
+const XObjectPtr
+XPathExecutionContextDefault::getGlobalVariable(
+            const XalanQName&       name,
+            int                     /* theSlot */,
+            const Locator* const    locator)
+{
+    return getVariable(name, locator);
+}
+
+
+
+const XObjectPtr
+XPathExecutionContextDefault::getLocalVariable(
+            const XalanQName&       name,
+            int                     /* theSlot */,
+            const Locator* const    locator)
+{
+    return getVariable(name, locator);
+}
+
+
+
 const PrefixResolver*
 XPathExecutionContextDefault::getPrefixResolver() const
 {
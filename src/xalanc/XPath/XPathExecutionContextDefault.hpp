@@ -195,6 +195,11 @@ public:
             const XalanNode&    node1,
             const XalanNode&    node2) const;
 
+    virtual bool
+    getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const;
+
     virtual void
     pushContextNodeList(const NodeRefListBase&  theList);
 
@@ -277,6 +282,18 @@ public:
             const XalanQName&   name,
             const Locator*      locator = 0);
 
+    virtual const XObjectPtr
+    getGlobalVariable(
+            const XalanQName&   name,
+            int                 theSlot,
+            const Locator*      locator = 0);
+
+    virtual const XObjectPtr
+    getLocalVariable(
+            const XalanQName&   name,
+            int                 theSlot,
+            const Locator*      locator = 0);
+
     virtual const PrefixResolver*
     getPrefixResolver() const;
 
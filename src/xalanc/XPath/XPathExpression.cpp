@@ -35,6 +35,7 @@
 
 
 #include "XObjectTypeCallback.hpp"
+#include "XalanTranslationTable.hpp"
 
 
 
@@ -153,7 +154,8 @@ static const int    theOpCodeLengthArray[] =
     XPathExpression::s_opCodeMapLengthIndex + 1,
     XPathExpression::s_opCodeMapLengthIndex + 1,
     XPathExpression::s_opCodeMapLengthIndex + 1,
-    XPathExpression::s_opCodeMapLengthIndex + 1
+    XPathExpression::s_opCodeMapLengthIndex + 1,
+    XPathExpression::s_opCodeMapLengthIndex + 3
 };
 
 static const int    theOpCodeLengthArraySize =
@@ -334,7 +336,9 @@ XPathExpression::XPathExpression(MemoryManager& theManager) :
     m_tokenQueue(theManager),
     m_currentPosition(0),
     m_currentPattern(&s_emptyString),
-    m_numberLiteralValues(theManager)
+    m_numberLiteralValues(theManager),
+    m_translationTables(theManager),
+    m_variableReferences(theManager)
 {
     m_opMap.reserve(eDefaultOpMapSize);
     m_tokenQueue.reserve(eDefaultTokenQueueSize);
@@ -354,6 +358,17 @@ XPathExpression::reset()
 {
     m_opMap.clear();
     m_tokenQueue.clear();
+
+    MemoryManager&  theManager = m_translationTables.getMemoryManager();
+
+    for (TranslationTableVectorType::size_type i = 0; i < m_translationTables.size(); ++i)
+    {
+        XalanDestroy(theManager, m_translationTables[i]);
+    }
+
+    m_translationTables.clear();
+
+    m_variableReferences.clear();
 }
 
 
@@ -617,6 +632,16 @@ XPathExpression::insertOpCode(
         // Assign the opcode.
         m_opMap[theIndex] = theOpCode;
 
+        // Any variable references at or after the insertion
+        // point have moved.
+        for (OpCodeMapValueVectorType::size_type i = 0; i < m_variableReferences.size(); ++i)
+        {
+            if (m_variableReferences[i] >= theIndex)
+            {
+                m_variableReferences[i] += theOpCodeLength;
+            }
+        }
+
         // Update the entire expression length.
         m_opMap[s_opCodeMapLengthIndex] += theOpCodeLength;
     }
@@ -967,6 +992,30 @@ XPathExpression::pushNumberLiteralOnOpCodeMap(double    theNumber)
 
 
 
+XPathExpression::OpCodeMapValueType
+XPathExpression::addTranslationTable(
+            const XalanDOMString&   theFromString,
+            const XalanDOMString&   theToString)
+{
+    MemoryManager&  theManager = m_translationTables.getMemoryManager();
+
+    m_translationTables.reserve(m_translationTables.size() + 1);
+
+    XalanTranslationTable*  theTable;
+
+    XalanConstruct(
+        theManager,
+        theTable,
+        theFromString,
+        theToString);
+
+    m_translationTables.push_back(theTable);
+
+    return OpCodeMapValueType(m_translationTables.size() - 1);
+}
+
+
+
 void
 XPathExpression::pushCurrentTokenOnOpCodeMap()
 {
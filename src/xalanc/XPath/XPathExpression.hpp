@@ -55,6 +55,10 @@ using xercesc::MemoryManager;
 
 
 
+class XalanTranslationTable;
+
+
+
 class XALAN_XPATH_EXPORT XPathExpression
 {
 public:
@@ -71,6 +75,8 @@ public:
 
     typedef XalanVector<double>                 NumberLiteralValueVectorType;
 
+    typedef XalanVector<XalanTranslationTable*> TranslationTableVectorType;
+
 #define XALAN_XPATH_EXPRESSION_USE_ITERATORS
 
 #if defined(XALAN_XPATH_EXPRESSION_USE_ITERATORS)
@@ -322,11 +328,14 @@ public:
 
         /**
          * [OP_VARIABLE]
-         * [3]
-         * [index to token]
+         * [6]
+         * [index to namespace token]
+         * [index to local name token]
+         * [global variable slot, or eUnresolvedVariableSlot]
+         * [local variable slot, or eUnresolvedVariableSlot]
          * 
          * returns: 
-         *  XString
+         *  XObject
          */
         eOP_VARIABLE = 19,
 
@@ -587,6 +596,21 @@ public:
         eOP_FUNCTION_SUM = 78,
         eOP_FUNCTION_CONCAT = 79,
 
+        /**
+         * [OP_FUNCTION_TRANSLATE]
+         * [length]
+         * [translation table index]
+         * [3]
+         *  {expression}
+         *  {literal}
+         *  {literal}
+         * [ENDOP]
+         *
+         * returns:
+         *  XString
+         */
+        eOP_FUNCTION_TRANSLATE = 80,
+
         // Always add _before_ this one and update
         // s_opCodeLengthArray.
         eOpCodeNextAvailable
@@ -714,6 +738,16 @@ public:
         s_opCodeMapLengthIndex = 1
     };
 
+    /**
+     * The value of the slot of a variable reference that has not been
+     * resolved to a global or a local variable.  Such a reference is
+     * looked up by name when it is evaluated.
+     */
+    enum eVariableSlot
+    {
+        eUnresolvedVariableSlot = -1
+    };
+
     explicit
     XPathExpression(MemoryManager& theManager);
 
@@ -1412,6 +1446,56 @@ public:
         return m_numberLiteralValues[NumberLiteralValueVectorType::size_type(theIndex)];
     }
 
+    /**
+     * Add a table for a call to translate() with literal arguments.  The
+     * strings must exist as long as the expression.
+     *
+     * @param theFromString The second argument to translate()
+     * @param theToString The third argument to translate()
+     * @return the index of the new table
+     */
+    OpCodeMapValueType
+    addTranslationTable(
+            const XalanDOMString&   theFromString,
+            const XalanDOMString&   theToString);
+
+    /**
+     * Get a table added by addTranslationTable().
+     *
+     * @param theIndex The index of the desired table.
+     */
+    const XalanTranslationTable&
+    getTranslationTable(int     theIndex) const
+    {
+        assert(theIndex >= 0 &&
+               TranslationTableVectorType::size_type(theIndex) < m_translationTables.size());
+
+        return *m_translationTables[TranslationTableVectorType::size_type(theIndex)];
+    }
+
+    /**
+     * Record the position of a variable reference in the op map.  The
+     * position is kept up to date as op codes are inserted.
+     *
+     * @param theIndex The position of the eOP_VARIABLE op code
+     */
+    void
+    addVariableReference(OpCodeMapSizeType  theIndex)
+    {
+        m_variableReferences.push_back(theIndex);
+    }
+
+    /**
+     * Get the positions of the variable references in the op map.
+     *
+     * @return A vector of positions of eOP_VARIABLE op codes
+     */
+    const OpCodeMapValueVectorType&
+    getVariableReferences() const
+    {
+        return m_variableReferences;
+    }
+
     /**
      * Push the current position in the token queue onto the operations code
      * map.
@@ -1514,6 +1598,10 @@ private:
     };
 
     NumberLiteralValueVectorType    m_numberLiteralValues;
+
+    TranslationTableVectorType      m_translationTables;
+
+    OpCodeMapValueVectorType        m_variableReferences;
 };
 
 
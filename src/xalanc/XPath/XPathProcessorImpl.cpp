@@ -136,6 +136,8 @@ XPathProcessorImpl::initXPath(
         error(XalanMessages::ExtraIllegalTokens);
     }
 
+    m_xpath->compileSelectExpression();
+
     m_xpath = 0;
     m_constructionContext = 0;
     m_expression = 0;
@@ -193,6 +195,8 @@ XPathProcessorImpl::initMatchPattern(
 
     m_expression->shrink();
 
+    m_xpath->compileMatchPattern();
+
     m_xpath = 0;
     m_constructionContext = 0;
     m_expression = 0;
@@ -1487,8 +1491,15 @@ XPathProcessorImpl::PrimaryExpr()
         {
             m_expression->appendOpCode(XPathExpression::eOP_VARIABLE);
 
+            m_expression->addVariableReference(opPos);
+
             QName();
 
+            // The stylesheet may resolve the reference to a global
+            // or a local variable once all of the variables are known.
+            m_expression->pushValueOnOpCodeMap(XPathExpression::eUnresolvedVariableSlot);
+            m_expression->pushValueOnOpCodeMap(XPathExpression::eUnresolvedVariableSlot);
+
             m_expression->updateOpCodeLength(
                 XPathExpression::eOP_VARIABLE,
                 opPos);
@@ -1731,6 +1742,9 @@ XPathProcessorImpl::FunctionCall()
                 theArgs[0] = theFunctionID;
                 theArgs[1] = 0;
 
+                const bool  isTranslate =
+                    equals(m_token, XPathFunctionTable::s_translate);
+
                 m_expression->appendOpCode(
                         XPathExpression::eOP_FUNCTION,
                         theArgs);
@@ -1744,6 +1758,12 @@ XPathProcessorImpl::FunctionCall()
 
                 // update the arg count in the op map...
                 m_expression->setOpCodeMapValue(opPos + 3, argCount);
+
+                if (isTranslate == true &&
+                    argCount == 3)
+                {
+                    TranslateWithLiterals(opPos);
+                }
             }
         }
     }
@@ -1756,6 +1776,43 @@ XPathProcessorImpl::FunctionCall()
 
 
 
+void
+XPathProcessorImpl::TranslateWithLiterals(int  opPos)
+{
+    assert(m_expression->getOpCodeMapValue(opPos) == XPathExpression::eOP_FUNCTION);
+    assert(m_expression->getOpCodeMapValue(opPos + 3) == 3);
+
+    // Skip the function ID, the argument count, and the first argument...
+    const int   theFromPos =
+        m_expression->getNextOpCodePosition(opPos + 4);
+
+    const int   theToPos =
+        m_expression->getNextOpCodePosition(theFromPos);
+
+    if (m_expression->getOpCodeMapValue(theFromPos) == XPathExpression::eOP_LITERAL &&
+        m_expression->getOpCodeMapValue(theToPos) == XPathExpression::eOP_LITERAL)
+    {
+        const XalanDOMString&   theFromString =
+            m_expression->getToken(m_expression->getOpCodeMapValue(theFromPos + 2))->str();
+
+        const XalanDOMString&   theToString =
+            m_expression->getToken(m_expression->getOpCodeMapValue(theToPos + 2))->str();
+
+        // The table replaces the function ID, so the op code has
+        // the same length as the generic function call.
+        m_expression->setOpCodeMapValue(
+            opPos + 2,
+            m_expression->addTranslationTable(theFromString, theToString));
+
+        m_expression->replaceOpCode(
+            opPos,
+            XPathExpression::eOP_FUNCTION,
+            XPathExpression::eOP_FUNCTION_TRANSLATE);
+    }
+}
+
+
+
 void
 XPathProcessorImpl::FunctionPosition()
 {
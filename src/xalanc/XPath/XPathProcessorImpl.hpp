@@ -490,6 +490,13 @@ private:
     void
     FunctionCall();
 
+    /**
+     * If the second and third arguments of the translate() call at
+     * opPos are literals, compile the call into a translation table.
+     */
+    void
+    TranslateWithLiterals(int  opPos);
+
     void
     FunctionPosition();
 
@@ -0,0 +1,125 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "XalanTranslationTable.hpp"
+
+
+
+#include <xalanc/PlatformSupport/DOMStringHelper.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanTranslationTable::XalanTranslationTable(
+            const XalanDOMString&   theFromString,
+            const XalanDOMString&   theToString) :
+    m_fromString(theFromString),
+    m_toString(theToString),
+    m_searchWideChars(false)
+{
+    for (XalanDOMChar i = 0; i < eTableSize; ++i)
+    {
+        m_table[i] = i;
+    }
+
+    const XalanDOMString::size_type     theFromLength = theFromString.length();
+    const XalanDOMString::size_type     theToLength = theToString.length();
+
+    // Go backwards, since the first occurrence of a
+    // character determines its translation.
+    for (XalanDOMString::size_type i = theFromLength; i > 0; --i)
+    {
+        const XalanDOMChar  theChar = theFromString[i - 1];
+
+        if (theChar >= eTableSize)
+        {
+            m_searchWideChars = true;
+        }
+        else if (i - 1 < theToLength)
+        {
+            m_table[theChar] = theToString[i - 1];
+        }
+        else
+        {
+            m_table[theChar] = XalanDOMChar(eRemove);
+        }
+    }
+}
+
+
+
+inline XalanDOMChar
+XalanTranslationTable::translate(XalanDOMChar     theChar) const
+{
+    if (theChar < eTableSize)
+    {
+        return m_table[theChar];
+    }
+    else if (m_searchWideChars == false)
+    {
+        return theChar;
+    }
+    else
+    {
+        const XalanDOMString::size_type     theIndex =
+            indexOf(m_fromString, theChar);
+
+        if (theIndex >= m_fromString.length())
+        {
+            return theChar;
+        }
+        else if (theIndex < m_toString.length())
+        {
+            return m_toString[theIndex];
+        }
+        else
+        {
+            return XalanDOMChar(eRemove);
+        }
+    }
+}
+
+
+
+void
+XalanTranslationTable::translate(
+            const XalanDOMString&   theString,
+            XalanDOMString&         theResult) const
+{
+    const XalanDOMString::size_type     theLength = theString.length();
+
+    // The result string can only be as large as the first string, so
+    // just reserve the space now.
+    theResult.reserve(theResult.length() + theLength);
+
+    for (XalanDOMString::size_type i = 0; i < theLength; ++i)
+    {
+        const XalanDOMChar  theChar = translate(theString[i]);
+
+        if (theChar != XalanDOMChar(eRemove))
+        {
+            theResult.push_back(theChar);
+        }
+    }
+}
+
+
+
+}
@@ -0,0 +1,99 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANTRANSLATIONTABLE_HEADER_GUARD_1357924680)
+#define XALANTRANSLATIONTABLE_HEADER_GUARD_1357924680
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/XPath/XPathDefinitions.hpp>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * A table for translating the characters of one string to those of
+ * another, as the translate() function does.  Characters below
+ * eTableSize are translated by a single lookup, and other characters
+ * are searched for.
+ */
+class XALAN_XPATH_EXPORT XalanTranslationTable
+{
+public:
+
+    enum { eTableSize = 256 };
+
+    /**
+     * Construct a table.  The strings must exist as long as the table.
+     *
+     * @param theFromString The characters to translate
+     * @param theToString The replacement characters
+     */
+    XalanTranslationTable(
+            const XalanDOMString&   theFromString,
+            const XalanDOMString&   theToString);
+
+    /**
+     * Translate a string.
+     *
+     * @param theString The string to translate
+     * @param theResult The string to which the result is appended
+     */
+    void
+    translate(
+            const XalanDOMString&   theString,
+            XalanDOMString&         theResult) const;
+
+private:
+
+    // Not implemented...
+    XalanTranslationTable(const XalanTranslationTable&);
+
+    XalanTranslationTable&
+    operator=(const XalanTranslationTable&);
+
+    // The value for characters that are removed.  This is
+    // not an XML character, so it can't be a replacement.
+    enum { eRemove = 0xFFFF };
+
+    XalanDOMChar
+    translate(XalanDOMChar  theChar) const;
+
+    const XalanDOMString&   m_fromString;
+
+    const XalanDOMString&   m_toString;
+
+    bool                    m_searchWideChars;
+
+    XalanDOMChar            m_table[eTableSize];
+};
+
+
+
+}
+
+
+
+#endif  // XALANTRANSLATIONTABLE_HEADER_GUARD_1357924680
@@ -348,6 +348,42 @@ AVT::doEvaluate(
 
 
 
+const XPath*
+AVT::findXPath(
+            const AVT* const*   theAVTs,
+            size_type           theCount,
+            size_type           index)
+{
+    for(size_type i = 0; i < theCount; i++)
+    {
+        const AVT* const    theAVT = theAVTs[i];
+
+        if (theAVT != 0)
+        {
+            for(size_type j = 0; j < theAVT->m_partsSize; j++)
+            {
+                assert(theAVT->m_parts[j] != 0);
+
+                const XPath* const  theXPath = theAVT->m_parts[j]->getXPath();
+
+                if (theXPath != 0)
+                {
+                    if (index == 0)
+                    {
+                        return theXPath;
+                    }
+
+                    --index;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+
+
 void
 AVT::nextToken(
             StylesheetConstructionContext&  constructionContext,
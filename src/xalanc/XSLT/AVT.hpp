@@ -45,6 +45,7 @@ using xercesc::Locator;
 
 class AVTPart;
 class PrefixResolver;
+class XPath;
 class XPathExecutionContext;
 class XalanNode;
 class StringTokenizer;
@@ -93,6 +94,28 @@ public:
         return m_name;
     }
 
+    /**
+     * Get the value of the AVT, if it contains no expressions.
+     *
+     * @return the value, or 0 if the AVT must be evaluated
+     */
+    const XalanDOMChar*
+    getSimpleString() const
+    {
+        return m_simpleString;
+    }
+
+    /**
+     * Get the length of the value returned by getSimpleString().
+     *
+     * @return the length
+     */
+    XalanDOMString::size_type
+    getSimpleStringLength() const
+    {
+        return m_simpleStringLength;
+    }
+
     /**
      * Append the value to the buffer.
      *
@@ -141,6 +164,20 @@ public:
         }
     }
 
+    /**
+     * Get one of the XPath expressions embedded in a set of AVTs.
+     *
+     * @param theAVTs The AVTs.  Any of them may be null.
+     * @param theCount The number of AVTs
+     * @param index The index of the expression, counting across all of the AVTs
+     * @return the XPath, or 0 if there are no more expressions
+     */
+    static const XPath*
+    findXPath(
+            const AVT* const*   theAVTs,
+            size_type           theCount,
+            size_type           index);
+
 private:
 
     void
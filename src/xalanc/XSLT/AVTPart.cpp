@@ -35,4 +35,12 @@ AVTPart::~AVTPart()
 
 
 
+const XPath*
+AVTPart::getXPath() const
+{
+    return 0;
+}
+
+
+
 }
@@ -32,6 +32,7 @@ namespace XALAN_CPP_NAMESPACE {
 class XalanDOMString;
 class XalanNode;
 class PrefixResolver;
+class XPath;
 class XPathExecutionContext;
 
 
@@ -76,6 +77,14 @@ public:
             XalanDOMString&         buf,
             const PrefixResolver&   prefixResolver,
             XPathExecutionContext&  executionContext) const = 0;
+
+    /**
+     * Get the XPath expression of the part.
+     *
+     * @return the XPath, or 0 if the part is a simple string
+     */
+    virtual const XPath*
+    getXPath() const;
 };
 
 
@@ -66,4 +66,12 @@ AVTPartXPath::evaluate(
 
 
 
+const XPath*
+AVTPartXPath::getXPath() const
+{
+    return m_pXPath;
+}
+
+
+
 }
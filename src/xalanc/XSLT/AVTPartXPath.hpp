@@ -75,6 +75,9 @@ public:
             const PrefixResolver&   prefixResolver,
             XPathExecutionContext&  executionContext) const;
 
+    virtual const XPath*
+    getXPath() const;
+
 private:
 
     /**
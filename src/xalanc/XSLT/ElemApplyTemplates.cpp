@@ -37,6 +37,7 @@
 #include "StylesheetConstructionContext.hpp"
 #include "StylesheetExecutionContext.hpp"
 #include "TracerEvent.hpp"
+#include "XalanStreamingSource.hpp"
 
 
 
@@ -154,10 +155,16 @@ ElemApplyTemplates::startElement(StylesheetExecutionContext&        executionCon
 void
 ElemApplyTemplates::endElement(StylesheetExecutionContext&      executionContext) const
 {
+    // A streamed list is selected by its source.
+    const bool  fStreamed = executionContext.getNodesToTransformSource() != 0;
+
     executionContext.popContextNodeList();
     executionContext.popNodesToTransformList();
 
-    releaseSelectedAndSortedNodeList(executionContext);
+    if (fStreamed == false)
+    {
+        releaseSelectedAndSortedNodeList(executionContext);
+    }
 
     if (isDefaultTemplate() == false)
     {
@@ -190,12 +197,7 @@ ElemApplyTemplates::getNextChildElemToExecute(
 
         if (nextElement == 0)
         {
-            const NodeRefListBase* nodesToTransform = createSelectedAndSortedNodeList(
-                                                executionContext);
-
-            executionContext.createAndPushNodesToTransformList(nodesToTransform);
-    
-            executionContext.pushContextNodeList(*nodesToTransform);
+            pushNodesToTransform(executionContext);
 
             executionContext.pushContextMarker();
 
@@ -225,13 +227,8 @@ ElemApplyTemplates::getFirstChildElemToExecute(
     }
     else
     {
-        const NodeRefListBase* nodesToTransform = createSelectedAndSortedNodeList(
-                                                executionContext);
+        pushNodesToTransform(executionContext);
 
-        executionContext.createAndPushNodesToTransformList(nodesToTransform);
-    
-        executionContext.pushContextNodeList(*nodesToTransform);
-        
         executionContext.pushContextMarker();
 
         return findNextTemplateToExecute(executionContext);
@@ -264,11 +261,58 @@ ElemApplyTemplates::findNextTemplateToExecute(
         {
             executionContext.popCurrentNode();
         }
+        else
+        {
+            XalanStreamingSource* const     theSource =
+                executionContext.getNodesToTransformSource();
+
+            if (theSource != 0)
+            {
+                theSource->beginChild(nextNode, selectedTemplate->isStreamable());
+            }
+        }
 
     } while (0 == selectedTemplate);
 
     return selectedTemplate;
 }
+
+
+
+void
+ElemApplyTemplates::pushNodesToTransform(StylesheetExecutionContext&  executionContext) const
+{
+    assert(m_selectPattern != 0);
+
+    XalanStreamingSource* const     theSource = executionContext.getStreamingSource();
+
+    if (theSource != 0 &&
+        isStreamable() == true &&
+        theSource->isOpen(*executionContext.getCurrentNode()) == true)
+    {
+        // The children haven't been parsed, so the source selects
+        // them as they arrive.
+        const NodeRefListBase&  theStreamedNodes =
+            theSource->beginChildren(
+                executionContext,
+                *this,
+                *m_selectPattern);
+
+        executionContext.createAndPushNodesToTransformList(&theStreamedNodes, theSource);
+
+        executionContext.pushContextNodeList(theStreamedNodes);
+    }
+    else
+    {
+        const NodeRefListBase*  nodesToTransform = createSelectedAndSortedNodeList(
+                                                    executionContext);
+        assert(nodesToTransform != 0);
+
+        executionContext.createAndPushNodesToTransformList(nodesToTransform);
+
+        executionContext.pushContextNodeList(*nodesToTransform);
+    }
+}
 #endif
 
 
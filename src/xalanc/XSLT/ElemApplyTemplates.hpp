@@ -86,6 +86,18 @@ public:
     execute(StylesheetExecutionContext&     executionContext) const;
 #endif
 
+    /**
+     * Retrieve the mode of the instruction
+     * 
+     * @return QName for mode
+     */
+    const XalanQName&
+    getMode() const
+    {
+        assert(m_mode != 0);
+
+        return *m_mode;
+    }
 
 
 protected:
@@ -96,6 +108,17 @@ protected:
 #if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
     const ElemTemplateElement*
     findNextTemplateToExecute(StylesheetExecutionContext& executionContext) const;
+
+    /**
+     * Select the nodes to transform and push them as the nodes to
+     * transform and the context node list.  If the instruction is
+     * streamable and the children of the current node have yet to be
+     * parsed, the nodes are delivered by the streaming source.
+     *
+     * @param executionContext The current execution context
+     */
+    void
+    pushNodesToTransform(StylesheetExecutionContext&  executionContext) const;
 #else
     virtual void
     transformChild(
@@ -736,4 +736,14 @@ ElemAttribute::childTypeAllowed(int     xslToken) const
 
 
 
+const XPath*
+ElemAttribute::getXPath(XalanSize_t     index) const
+{
+    const AVT* const    theAVTs[] = { m_nameAVT, m_namespaceAVT };
+
+    return AVT::findXPath(theAVTs, sizeof(theAVTs) / sizeof(theAVTs[0]), index);
+}
+
+
+
 }
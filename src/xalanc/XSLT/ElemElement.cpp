@@ -602,4 +602,14 @@ ElemElement::getParentDefaultNamespace() const
 
 
 
+const XPath*
+ElemElement::getXPath(XalanSize_t   index) const
+{
+    const AVT* const    theAVTs[] = { m_nameAVT, m_namespaceAVT };
+
+    return AVT::findXPath(theAVTs, sizeof(theAVTs) / sizeof(theAVTs[0]), index);
+}
+
+
+
 }
@@ -66,6 +66,9 @@ public:
     virtual const XalanDOMString&
     getElementName() const;
 
+    virtual const XPath*
+    getXPath(XalanSize_t    index) const;
+
 #if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
     virtual const ElemTemplateElement*
     startElement(StylesheetExecutionContext&    executionContext) const;
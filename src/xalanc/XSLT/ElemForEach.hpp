@@ -116,6 +116,18 @@ public:
     virtual const XPath*
     getXPath(XalanSize_t    index) const;
 
+    /**
+     * Get the xsl:sort elements of the instruction, which are
+     * not among its children.
+     *
+     * @return The sort elements
+     */
+    const SortElemsVectorType&
+    getSortElems() const
+    {
+        return m_sortElems;
+    }
+
 protected:
 
     /**
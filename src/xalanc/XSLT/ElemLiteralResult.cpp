@@ -24,6 +24,7 @@
 
 
 #include <xalanc/PlatformSupport/DoubleSupport.hpp>
+#include <xalanc/PlatformSupport/XalanCharScanner.hpp>
 #include <xalanc/PlatformSupport/XalanMessageLoader.hpp>
 
 
@@ -32,8 +33,13 @@
 
 
 
+#include <xalanc/XMLSupport/XalanXMLSerializerBase.hpp>
+
+
+
 #include "AVT.hpp"
 #include "Constants.hpp"
+#include "ElemTextLiteral.hpp"
 #include "Stylesheet.hpp"
 #include "StylesheetConstructionContext.hpp"
 #include "StylesheetExecutionContext.hpp"
@@ -59,7 +65,9 @@ ElemLiteralResult::ElemLiteralResult(
         StylesheetConstructionContext::ELEMNAME_LITERAL_RESULT),
     m_elementName(constructionContext.getPooledString(name)),
     m_avts(0),
-    m_avtsCount(0)
+    m_avtsCount(0),
+    m_staticContent(0),
+    m_staticContentLength(0)
 {
     init(constructionContext, stylesheetTree, name, atts);
 }
@@ -81,7 +89,9 @@ ElemLiteralResult::ElemLiteralResult(
             xslToken),
     m_elementName(constructionContext.getPooledString(name)),
     m_avts(0),
-    m_avtsCount(0)
+    m_avtsCount(0),
+    m_staticContent(0),
+    m_staticContentLength(0)
 {
     init(constructionContext, stylesheetTree, name, atts);
 }
@@ -296,6 +306,334 @@ ElemLiteralResult::postConstruction(
             }
         }
     }
+
+    if (getXSLToken() == StylesheetConstructionContext::ELEMNAME_LITERAL_RESULT &&
+        hasChildren() == true &&
+        hasAttributeSets() == false &&
+        hasNamespaceAVT() == false)
+    {
+        compileStaticContent(constructionContext);
+    }
+}
+
+
+
+typedef XalanXMLSerializerBase::UTF16   SerializerConstants;
+
+
+
+static void
+appendNumericCharacterReference(
+            XalanDOMChar        theChar,
+            XalanDOMString&     theMarkup)
+{
+    theMarkup.push_back(XalanUnicode::charAmpersand);
+    theMarkup.push_back(XalanUnicode::charNumberSign);
+
+    NumberToDOMString(XMLUInt64(theChar), theMarkup);
+
+    theMarkup.push_back(XalanUnicode::charSemicolon);
+}
+
+
+
+/**
+ * Determine if a character is written the same way in every
+ * XML version, ignoring the default entities, line feeds and
+ * characters that the encoding cannot represent.
+ */
+inline bool
+isPlainCharacter(XalanDOMChar   theChar)
+{
+    return (theChar >= 0x20u && theChar < 0x7Fu) ||
+           (theChar > 0x9Fu &&
+            theChar != XalanUnicode::charLSEP &&
+            (theChar < 0xD800u || theChar > 0xDFFFu) &&
+            theChar < 0xFFFEu);
+}
+
+
+
+static bool
+appendStaticText(
+            const XalanDOMChar*         theText,
+            XalanDOMString::size_type   theLength,
+            bool                        fDisableOutputEscaping,
+            XalanDOMString&             theMarkup)
+{
+    if (theLength == 0)
+    {
+        return false;
+    }
+
+    for (XalanDOMString::size_type i = 0; i < theLength; ++i)
+    {
+        const XalanDOMChar  theChar = theText[i];
+
+        if (theChar == XalanUnicode::charLF)
+        {
+            // The serializer writes the markup's line feeds as its
+            // line separator, which raw text never gets.
+            if (fDisableOutputEscaping == true)
+            {
+                return false;
+            }
+
+            theMarkup.push_back(theChar);
+        }
+        else if (isPlainCharacter(theChar) == false)
+        {
+            return false;
+        }
+        else if (fDisableOutputEscaping == true)
+        {
+            theMarkup.push_back(theChar);
+        }
+        else if (theChar == XalanUnicode::charLessThanSign)
+        {
+            theMarkup.append(
+                SerializerConstants::s_lessThanEntityString,
+                SerializerConstants::s_lessThanEntityStringLength);
+        }
+        else if (theChar == XalanUnicode::charGreaterThanSign)
+        {
+            theMarkup.append(
+                SerializerConstants::s_greaterThanEntityString,
+                SerializerConstants::s_greaterThanEntityStringLength);
+        }
+        else if (theChar == XalanUnicode::charAmpersand)
+        {
+            theMarkup.append(
+                SerializerConstants::s_ampersandEntityString,
+                SerializerConstants::s_ampersandEntityStringLength);
+        }
+        else
+        {
+            theMarkup.push_back(theChar);
+        }
+    }
+
+    return true;
+}
+
+
+
+static bool
+appendStaticAttribute(
+            const XalanDOMString&       theName,
+            const XalanDOMChar*         theValue,
+            XalanDOMString::size_type   theLength,
+            XalanDOMString&             theMarkup)
+{
+    theMarkup.push_back(XalanUnicode::charSpace);
+    theMarkup.append(theName);
+    theMarkup.push_back(XalanUnicode::charEqualsSign);
+    theMarkup.push_back(XalanUnicode::charQuoteMark);
+
+    for (XalanDOMString::size_type i = 0; i < theLength; ++i)
+    {
+        const XalanDOMChar  theChar = theValue[i];
+
+        if (theChar == XalanUnicode::charHTab ||
+            theChar == XalanUnicode::charLF ||
+            theChar == XalanUnicode::charCR)
+        {
+            appendNumericCharacterReference(theChar, theMarkup);
+        }
+        else if (isPlainCharacter(theChar) == false)
+        {
+            return false;
+        }
+        else if (theChar == XalanUnicode::charLessThanSign)
+        {
+            theMarkup.append(
+                SerializerConstants::s_lessThanEntityString,
+                SerializerConstants::s_lessThanEntityStringLength);
+        }
+        else if (theChar == XalanUnicode::charGreaterThanSign)
+        {
+            theMarkup.append(
+                SerializerConstants::s_greaterThanEntityString,
+                SerializerConstants::s_greaterThanEntityStringLength);
+        }
+        else if (theChar == XalanUnicode::charAmpersand)
+        {
+            theMarkup.append(
+                SerializerConstants::s_ampersandEntityString,
+                SerializerConstants::s_ampersandEntityStringLength);
+        }
+        else if (theChar == XalanUnicode::charQuoteMark)
+        {
+            theMarkup.append(
+                SerializerConstants::s_quoteEntityString,
+                SerializerConstants::s_quoteEntityStringLength);
+        }
+        else
+        {
+            theMarkup.push_back(theChar);
+        }
+    }
+
+    theMarkup.push_back(XalanUnicode::charQuoteMark);
+
+    return true;
+}
+
+
+
+inline bool
+isASCIIName(const XalanDOMString&   theName)
+{
+    return XalanCharScanner::scanASCII(theName.c_str(), theName.length()) == theName.length();
+}
+
+
+
+void
+ElemLiteralResult::compileStaticContent(StylesheetConstructionContext&  constructionContext)
+{
+    const StylesheetConstructionContext::GetCachedString    theGuard(constructionContext);
+
+    XalanDOMString&     theMarkup = theGuard.get();
+
+    for (const ElemTemplateElement* node = getFirstChildElem(); node != 0; node = node->getNextSiblingElem())
+    {
+        const int   theToken = node->getXSLToken();
+
+        if (theToken == StylesheetConstructionContext::ELEMNAME_TEXT_LITERAL_RESULT)
+        {
+            const ElemTextLiteral* const    theText =
+                static_cast<const ElemTextLiteral*>(node);
+
+            if (appendStaticText(
+                    theText->getText(),
+                    theText->getLength(),
+                    theText->isDisableOutputEscaping(),
+                    theMarkup) == false)
+            {
+                return;
+            }
+        }
+        else if (theToken != StylesheetConstructionContext::ELEMNAME_LITERAL_RESULT ||
+                 static_cast<const ElemLiteralResult*>(node)->appendStaticMarkup(*this, theMarkup) == false)
+        {
+            return;
+        }
+    }
+
+    assert(theMarkup.empty() == false);
+
+    m_staticContentLength = theMarkup.length();
+
+    m_staticContent =
+        constructionContext.allocateXalanDOMCharVector(
+            theMarkup.c_str(),
+            m_staticContentLength,
+            false);
+}
+
+
+
+bool
+ElemLiteralResult::appendStaticMarkup(
+            const ElemLiteralResult&    theParent,
+            XalanDOMString&             theMarkup) const
+{
+    assert(getXSLToken() == StylesheetConstructionContext::ELEMNAME_LITERAL_RESULT);
+
+    if (hasAttributeSets() == true ||
+        (hasChildren() == true && m_staticContent == 0) ||
+        isASCIIName(m_elementName) == false)
+    {
+        return false;
+    }
+
+    // The parent's start tag puts all of its namespace declarations in
+    // scope, so if we make no others, we'll never output any.
+    const NamespacesHandler&    theHandler = getNamespacesHandler();
+    const NamespacesHandler&    theParentHandler = theParent.getNamespacesHandler();
+
+    if (theHandler.declarationsAreSubsetOf(theParentHandler) == false)
+    {
+        return false;
+    }
+    else if (hasPrefix() == false)
+    {
+        // The default namespace in the result is only known if the
+        // parent is also unprefixed, and then it's the same as ours
+        // if we have the same default namespace.
+        const XalanDOMString* const     theDefault =
+            theHandler.getNamespace(s_emptyString);
+
+        const XalanDOMString* const     theParentDefault =
+            theParentHandler.getNamespace(s_emptyString);
+
+        if (theParent.hasPrefix() == true ||
+            (theDefault == 0) != (theParentDefault == 0) ||
+            (theDefault != 0 && equals(*theDefault, *theParentDefault) == false))
+        {
+            return false;
+        }
+    }
+
+    const XalanDOMString::size_type     theStart = theMarkup.length();
+
+    theMarkup.push_back(XalanUnicode::charLessThanSign);
+    theMarkup.append(m_elementName);
+
+    for (XalanSize_t i = 0; i < m_avtsCount; ++i)
+    {
+        const AVT* const    avt = m_avts[i];
+
+        const XalanDOMString&   theName = avt->getName();
+
+        if (avt->getSimpleString() == 0 ||
+            equals(theName, DOMServices::s_XMLNamespace) == true ||
+            isASCIIName(theName) == false ||
+            appendStaticAttribute(
+                theName,
+                avt->getSimpleString(),
+                avt->getSimpleStringLength(),
+                theMarkup) == false)
+        {
+            theMarkup.erase(theStart);
+
+            return false;
+        }
+    }
+
+    if (m_staticContent == 0)
+    {
+        theMarkup.push_back(XalanUnicode::charSolidus);
+        theMarkup.push_back(XalanUnicode::charGreaterThanSign);
+    }
+    else
+    {
+        theMarkup.push_back(XalanUnicode::charGreaterThanSign);
+        theMarkup.append(m_staticContent, m_staticContentLength);
+        theMarkup.push_back(XalanUnicode::charLessThanSign);
+        theMarkup.push_back(XalanUnicode::charSolidus);
+        theMarkup.append(m_elementName);
+        theMarkup.push_back(XalanUnicode::charGreaterThanSign);
+    }
+
+    return true;
+}
+
+
+
+bool
+ElemLiteralResult::hasNamespaceAVT() const
+{
+    for (XalanSize_t i = 0; i < m_avtsCount; ++i)
+    {
+        if (equals(m_avts[i]->getName(), DOMServices::s_XMLNamespace) == true)
+        {
+            return true;
+        }
+    }
+
+    return false;
 }
 
 
@@ -355,8 +693,26 @@ ElemLiteralResult::startElement(StylesheetExecutionContext&     executionContext
         }
     }
 
-    return beginExecuteChildren(executionContext);
+    if (m_staticContent != 0)
+    {
+        assert(hasAttributeSets() == false);
+        assert(hasParams() == false && hasVariables() == false);
+
+        evaluateAVTs(executionContext);
+
+        if (executionContext.preSerializedMarkup(
+                m_staticContent,
+                m_staticContentLength) == true)
+        {
+            return 0;
+        }
+        else
+        {
+            return ElemTemplateElement::getFirstChildElemToExecute(executionContext);
+        }
+    }
 
+    return beginExecuteChildren(executionContext);
 }
 
 
@@ -457,7 +813,13 @@ ElemLiteralResult::execute(StylesheetExecutionContext&  executionContext) const
         }
     }
 
-    executeChildren(executionContext);
+    if (m_staticContent == 0 ||
+        executionContext.preSerializedMarkup(
+            m_staticContent,
+            m_staticContentLength) == false)
+    {
+        executeChildren(executionContext);
+    }
 
     executionContext.endElement(theElementName.c_str());
 }
@@ -507,4 +869,12 @@ ElemLiteralResult::isAttrOK(
 
 
 
+const XPath*
+ElemLiteralResult::getXPath(XalanSize_t     index) const
+{
+    return AVT::findXPath(m_avts, m_avtsCount, index);
+}
+
+
+
 }
@@ -68,6 +68,9 @@ public:
     virtual const XalanDOMString&
     getElementName() const;
 
+    virtual const XPath*
+    getXPath(XalanSize_t    index) const;
+
     virtual void
     postConstruction(
             StylesheetConstructionContext&  constructionContext,
@@ -145,6 +148,36 @@ private:
     ElemLiteralResult&
     operator=(const ElemLiteralResult&);
 
+    /**
+     * Serialize the content of the element once, if it consists only of
+     * literal result elements with constant attributes, and text.  The
+     * markup is then written directly, when the result tree allows it.
+     *
+     * @param constructionContext The current construction context.
+     */
+    void
+    compileStaticContent(StylesheetConstructionContext&     constructionContext);
+
+    /**
+     * Append the serialized form of the element to a string, if it is
+     * constant and needs no namespace declarations as a child of the
+     * given parent.
+     *
+     * @param theParent The parent element.
+     * @param theMarkup The string for the markup.
+     * @return true if the markup was appended, false if not.
+     */
+    bool
+    appendStaticMarkup(
+            const ElemLiteralResult&    theParent,
+            XalanDOMString&             theMarkup) const;
+
+    /**
+     * Determine if any of the attributes is a default namespace declaration.
+     */
+    bool
+    hasNamespaceAVT() const;
+
 
     /**
      * The name of the literal result element.
@@ -160,6 +193,13 @@ private:
      * The size of m_avts, once the stylesheet is compiled...
      */
     XalanSize_t             m_avtsCount;
+
+    /**
+     * The pre-serialized content of the element, if it's constant.
+     */
+    const XalanDOMChar*     m_staticContent;
+
+    XalanDOMString::size_type   m_staticContentLength;
 };
 
 
@@ -2171,27 +2171,28 @@ ElemNumber::terminate()
 const XPath*
 ElemNumber::getXPath(XalanSize_t    index) const
 {
-    const XPath*    result = 0;
-
-    switch(index)
+    const XPath* const  theXPaths[] =
     {
-    case 0:
-        result = m_valueExpr;
-        break;
-
-    case 1:
-        result = m_countMatchPattern;
-        break;
+        m_valueExpr,
+        m_countMatchPattern,
+        m_fromMatchPattern
+    };
 
-    case 2:
-        result = m_fromMatchPattern;
-        break;
+    // The missing expressions are skipped, so the index is dense.
+    for (size_t i = 0; i < sizeof(theXPaths) / sizeof(theXPaths[0]); ++i)
+    {
+        if (theXPaths[i] != 0)
+        {
+            if (index == 0)
+            {
+                return theXPaths[i];
+            }
 
-    default:
-        break;
+            --index;
+        }
     }
 
-    return result;
+    return 0;
 }
 
 
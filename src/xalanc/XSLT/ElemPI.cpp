@@ -264,4 +264,12 @@ ElemPI::childTypeAllowed(int    xslToken) const
 
 
 
+const XPath*
+ElemPI::getXPath(XalanSize_t    index) const
+{
+    return AVT::findXPath(&m_nameAVT, 1, index);
+}
+
+
+
 }
@@ -61,13 +61,30 @@ ElemParam::getElementName() const
 
 
 
+const XObjectPtr
+ElemParam::getParamValue(StylesheetExecutionContext&    executionContext) const
+{
+    assert(m_qname != 0);
+
+    if (m_localSlot == -1)
+    {
+        return executionContext.getParamVariable(*m_qname);
+    }
+    else
+    {
+        return executionContext.getLocalParamVariable(*m_qname, m_localSlot);
+    }
+}
+
+
+
 #if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
 const ElemTemplateElement*
 ElemParam::startElement(StylesheetExecutionContext&     executionContext) const
 {
     assert(m_qname != 0);
 
-    const XObjectPtr    obj = executionContext.getParamVariable(*m_qname);
+    const XObjectPtr    obj = getParamValue(executionContext);
 
     // If not found, evaluate as variable for default value
     if (obj.null() == true)
@@ -94,7 +111,7 @@ ElemParam::endElement(StylesheetExecutionContext&       executionContext) const
 {
     assert(m_qname != 0);
 
-    const XObjectPtr    obj = executionContext.getParamVariable(*m_qname);
+    const XObjectPtr    obj = getParamValue(executionContext);
 
     // If not found, evaluate as variable for default value
     if (obj.null() == true)
@@ -112,7 +129,7 @@ ElemParam::execute(StylesheetExecutionContext&      executionContext) const
 {
     assert(m_qname != 0);
 
-    const XObjectPtr    obj = executionContext.getParamVariable(*m_qname);
+    const XObjectPtr    obj = getParamValue(executionContext);
 
     if (obj.null() == true)
     {
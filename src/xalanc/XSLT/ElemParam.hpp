@@ -69,6 +69,17 @@ public:
     virtual void
     execute(StylesheetExecutionContext&     executionContext) const;
 #endif
+
+private:
+
+    /**
+     * Get the value passed for the param, using its slot if it has one.
+     * 
+     * @param executionContext context for executing this stylesheet
+     * @return the value, or a null XObjectPtr if none was passed
+     */
+    const XObjectPtr
+    getParamValue(StylesheetExecutionContext&   executionContext) const;
 };
 
 
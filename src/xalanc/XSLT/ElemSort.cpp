@@ -167,7 +167,27 @@ ElemSort::getElementName() const
 const XPath*
 ElemSort::getXPath(XalanSize_t  index) const
 {
-    return index == 0 ? m_selectPattern : 0;
+    // A select of "." is not compiled, so the AVT XPaths start at
+    // index 0 when there is no select pattern.
+    if (m_selectPattern != 0)
+    {
+        if (index == 0)
+        {
+            return m_selectPattern;
+        }
+
+        --index;
+    }
+
+    const AVT* const    theAVTs[] =
+    {
+        m_langAVT,
+        m_dataTypeAVT,
+        m_orderAVT,
+        m_caseOrderAVT
+    };
+
+    return AVT::findXPath(theAVTs, sizeof(theAVTs) / sizeof(theAVTs[0]), index);
 }
 
 
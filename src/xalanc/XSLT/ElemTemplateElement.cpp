@@ -1371,12 +1371,19 @@ ElemTemplateElement::postConstruction(
             theParentHandler,
             m_namespacesHandler);
 
+    m_flags |= eHasTextOnlyContent;
+
     if (hasChildren() == true)
     {
         for (ElemTemplateElement* node = m_firstChild; node != 0; node = node->m_nextSibling) 
         {
             node->postConstruction(constructionContext, m_namespacesHandler);
 
+            if (producesTextOnly(*node) == false)
+            {
+                m_flags &= ~eHasTextOnlyContent;
+            }
+
             const int   theToken = node->getXSLToken();
 
             if (hasVariables() == false &&
@@ -1430,6 +1437,35 @@ ElemTemplateElement::postConstruction(
 
 
 
+bool
+ElemTemplateElement::producesTextOnly(const ElemTemplateElement&   theElement)
+{
+    switch(theElement.getXSLToken())
+    {
+    case StylesheetConstructionContext::ELEMNAME_TEXT_LITERAL_RESULT:
+    case StylesheetConstructionContext::ELEMNAME_VALUE_OF:
+        // Text with output escaping disabled must be kept in a
+        // result tree fragment, so it's output raw when it's copied.
+        return theElement.disableOutputEscaping() == false;
+
+    case StylesheetConstructionContext::ELEMNAME_NUMBER:
+    case StylesheetConstructionContext::ELEMNAME_VARIABLE:
+        return true;
+
+    case StylesheetConstructionContext::ELEMNAME_CHOOSE:
+    case StylesheetConstructionContext::ELEMNAME_FOR_EACH:
+    case StylesheetConstructionContext::ELEMNAME_IF:
+    case StylesheetConstructionContext::ELEMNAME_OTHERWISE:
+    case StylesheetConstructionContext::ELEMNAME_WHEN:
+        return theElement.hasTextOnlyContent();
+
+    default:
+        return false;
+    }
+}
+
+
+
 void
 ElemTemplateElement::namespacesPostConstruction(
             StylesheetConstructionContext&  constructionContext,
@@ -404,6 +404,34 @@ public:
         return m_stylesheet;
     }
 
+    /**
+     * Set the flag indicating the element can be executed before the
+     * children of the current source node have been parsed.  For a
+     * template, this means the template uses nothing but the name and
+     * the attributes of the node, apart from a single xsl:apply-templates
+     * that processes the children.  For an xsl:apply-templates, it means
+     * the element is that instruction.
+     *
+     * @param fValue  The value to set
+     */
+    void
+    setStreamable(bool  fValue)
+    {
+        setFlag(eStreamable, fValue);
+    }
+
+    /**
+     * Get the flag indicating the element can be executed before the
+     * children of the current source node have been parsed.
+     *
+     * @return true if the element is streamable
+     */
+    bool
+    isStreamable() const
+    {
+        return getFlag(eStreamable);
+    }
+
     /** 
      * Set the flag indicating construction of the element is completed.
      *
@@ -617,6 +645,10 @@ public:
      *              then one attribute with pattern/expression,the order of 
      *              the returned expressions are undefined
      *
+     * Attributes which are missing, or which have no compiled XPath,
+     * are skipped, so the expressions can be walked until the first
+     * null pointer.
+     *
      * @return pointer or null 
      */
     virtual const XPath*
@@ -719,6 +751,19 @@ public:
         return m_firstChild != 0 ? true : false;
     }
 
+    /**
+     * Determine if executing the children of this element can only
+     * produce text, so the result can be built as a string.  This is
+     * only valid after postConstruction() has been called.
+     *
+     * @return true if the children only produce text
+     */
+    bool
+    hasTextOnlyContent() const
+    {
+        return getFlag(eHasTextOnlyContent);
+    }
+
     bool
     hasDirectTemplate() const
     {
@@ -1133,9 +1178,14 @@ private:
         eSpacePreserve = 64,
         eFinishedConstruction = 128,
         eHasPrefix = 256,
-        eDisableOutputEscaping = 512
+        eDisableOutputEscaping = 512,
+        eStreamable = 1024,
+        eHasTextOnlyContent = 2048
     };
 
+    static bool
+    producesTextOnly(const ElemTemplateElement&     theElement);
+
     bool
     getFlag(eFlags  theFlag) const
     {
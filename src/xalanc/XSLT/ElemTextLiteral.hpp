@@ -79,6 +79,17 @@ public:
         return preserveSpace();
     }
 
+    /**
+     * Determine if the text is output without escaping
+     * 
+     * @return true if output escaping is disabled
+     */
+    bool
+    isDisableOutputEscaping() const
+    {
+        return disableOutputEscaping();
+    }
+
     const XalanDOMChar*
     getText() const
     {
@@ -110,6 +110,17 @@ public:
 
 protected:
 
+    /**
+     * Determine if the element uses any attribute sets.
+     *
+     * @return true if there is a use-attribute-sets attribute.
+     */
+    bool
+    hasAttributeSets() const
+    {
+        return m_attributeSetsNamesCount > 0;
+    }
+
 #if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
     /**
      * Get the next attribute set to execute.
@@ -37,6 +37,7 @@
 #include "Stylesheet.hpp"
 #include "StylesheetConstructionContext.hpp"
 #include "StylesheetExecutionContext.hpp"
+#include "StylesheetRoot.hpp"
 
 
 
@@ -57,10 +58,12 @@ ElemVariable::ElemVariable(
         columnNumber,
         StylesheetConstructionContext::ELEMNAME_VARIABLE),
     m_qname(0),
+    m_localSlot(-1),
     m_selectPattern(0),
     m_isTopLevel(false),
     m_value(0),
-    m_varContext(0)
+    m_varContext(0),
+    m_globalValueIndex(-1)
 {
     init(constructionContext, stylesheetTree, atts);
 }
@@ -81,10 +84,12 @@ ElemVariable::ElemVariable(
         columnNumber,
         xslToken),
     m_qname(0),
+    m_localSlot(-1),
     m_selectPattern(0),
     m_isTopLevel(false),
     m_value(0),
-    m_varContext(0)
+    m_varContext(0),
+    m_globalValueIndex(-1)
 {
     init(constructionContext, stylesheetTree, atts);
 }
@@ -238,6 +243,12 @@ ElemVariable::startElement(StylesheetExecutionContext& executionContext) const
         {
             theValue = executionContext.getXObjectFactory().createStringReference(s_emptyString);
         }
+        else if (hasTextOnlyContent() == true)
+        {
+            XalanDOMString&     theResult = executionContext.getAndPushCachedString();
+
+            return beginChildrenToString(executionContext, theResult);
+        }
         else
         {
             executionContext.beginCreateXResultTreeFrag(executionContext.getCurrentNode());
@@ -262,20 +273,7 @@ ElemVariable::startElement(StylesheetExecutionContext& executionContext) const
 
     }
 
-    if (theValue.null() == false)
-    {
-        executionContext.pushVariable(
-                *m_qname,
-                theValue,
-                getParentNodeElem());
-    }
-    else
-    {
-        executionContext.pushVariable(
-                *m_qname,
-                this,
-                getParentNodeElem());
-    }
+    pushValue(executionContext, theValue);
 
     return 0;
 }
@@ -286,12 +284,24 @@ ElemVariable::endElement(StylesheetExecutionContext& executionContext) const
 {
     if (0 == m_selectPattern && 0 != getFirstChildElem())
     {
-        endExecuteChildren(executionContext);
+        if (hasTextOnlyContent() == true)
+        {
+            endChildrenToString(executionContext);
+
+            XalanDOMString&     theResult = executionContext.getAndPopCachedString();
 
-        executionContext.pushVariable(
-                *m_qname,
-                executionContext.endCreateXResultTreeFrag(),
-                getParentNodeElem());
+            pushValue(
+                    executionContext,
+                    executionContext.createXResultTreeFrag(theResult));
+        }
+        else
+        {
+            endExecuteChildren(executionContext);
+
+            pushValue(
+                    executionContext,
+                    executionContext.endCreateXResultTreeFrag());
+        }
     }
 }
 
@@ -307,20 +317,7 @@ ElemVariable::execute(StylesheetExecutionContext&   executionContext) const
 
     const XObjectPtr    theValue(getValue(executionContext, executionContext.getCurrentNode()));
 
-    if (theValue.null() == false)
-    {
-        executionContext.pushVariable(
-                *m_qname,
-                theValue,
-                getParentNodeElem());
-    }
-    else
-    {
-        executionContext.pushVariable(
-                *m_qname,
-                this,
-                getParentNodeElem());
-    }
+    pushValue(executionContext, theValue);
 }
 #endif
 
@@ -334,6 +331,53 @@ ElemVariable::getXPath(XalanSize_t  index) const
 
 
 
+void
+ElemVariable::pushValue(
+            StylesheetExecutionContext&     executionContext,
+            const XObjectPtr&               theValue) const
+{
+    assert(m_qname != 0);
+
+    if (m_localSlot == -1)
+    {
+        if (theValue.null() == false)
+        {
+            executionContext.pushVariable(
+                    *m_qname,
+                    theValue,
+                    getParentNodeElem());
+        }
+        else
+        {
+            executionContext.pushVariable(
+                    *m_qname,
+                    this,
+                    getParentNodeElem());
+        }
+    }
+    else
+    {
+        if (theValue.null() == false)
+        {
+            executionContext.pushLocalVariable(
+                    *m_qname,
+                    m_localSlot,
+                    theValue,
+                    getParentNodeElem());
+        }
+        else
+        {
+            executionContext.pushLocalVariable(
+                    *m_qname,
+                    m_localSlot,
+                    this,
+                    getParentNodeElem());
+        }
+    }
+}
+
+
+
 const XObjectPtr
 ElemVariable::getValue(
             StylesheetExecutionContext&     executionContext,
@@ -345,6 +389,25 @@ ElemVariable::getValue(
         {
             return executionContext.getXObjectFactory().createStringReference(s_emptyString);
         }
+        else if (hasTextOnlyContent() == true)
+        {
+            const StylesheetExecutionContext::GetCachedString   theResult(executionContext);
+
+            const XPathExecutionContext::CurrentNodePushAndPop  theCurrentNodePushAndPop(executionContext, sourceNode);
+
+#if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
+            executionContext.beginFormatToText(theResult.get());
+
+            executeChildren(executionContext);
+
+            executionContext.endFormatToText();
+
+            return executionContext.createXResultTreeFrag(theResult.get());
+#else
+            return executionContext.createXResultTreeFrag(
+                        childrenToString(executionContext, theResult.get()));
+#endif
+        }
         else
         {
             
@@ -359,6 +422,11 @@ ElemVariable::getValue(
 #endif
         }
     }
+    else if (m_globalValueIndex != -1 &&
+             0 == executionContext.getTraceListeners())
+    {
+        return getGlobalValue(executionContext);
+    }
     else
     {
         XObjectPtr  theValue;
@@ -394,4 +462,29 @@ ElemVariable::getValue(
 
 
 
+const XObjectPtr
+ElemVariable::getGlobalValue(StylesheetExecutionContext&   executionContext) const
+{
+    assert(m_isTopLevel == true && m_selectPattern != 0);
+
+    const XalanGlobalValueCache&    theCache =
+        getStylesheet().getStylesheetRoot().getGlobalValueCache();
+
+    XObjectPtr  theValue =
+        theCache.get(m_globalValueIndex, executionContext.getXObjectFactory());
+
+    if (theValue.null() == true)
+    {
+        // The expression doesn't depend on the context node, so there's
+        // no need to set it.
+        theValue = m_selectPattern->execute(*this, executionContext);
+
+        theCache.set(m_globalValueIndex, *theValue, executionContext);
+    }
+
+    return theValue;
+}
+
+
+
 }
@@ -148,10 +148,43 @@ protected:
             const AttributeListType&        atts);
 
 
+    /**
+     * Push the variable onto the variables stack, bound to its slot if
+     * it is a local variable or param which has one.
+     * 
+     * @param executionContext context for executing this stylesheet
+     * @param theValue the value of the variable, or a null XObjectPtr
+     *                 if it is evaluated when it is first referenced
+     */
+    void
+    pushValue(
+            StylesheetExecutionContext&     executionContext,
+            const XObjectPtr&               theValue) const;
+
+
     const XalanQName*   m_qname;
 
+    /**
+     * The slot of a local variable or param in its template, or -1 if
+     * references to it are found by name.
+     */
+    int                 m_localSlot;
+
 private:
 
+    friend class XalanVariableResolver;
+
+    /**
+     * Get the value of a global variable which depends only on the
+     * stylesheet from the stylesheet's cache, evaluating and caching
+     * it if this is the first reference.
+     * 
+     * @param executionContext context for executing this stylesheet
+     * @return the value of the variable
+     */
+    const XObjectPtr
+    getGlobalValue(StylesheetExecutionContext&  executionContext) const;
+
     // not implemented
     ElemVariable(const ElemVariable &);
 
@@ -165,6 +198,12 @@ private:
     XObjectPtr      m_value;
 
     XalanNode*      m_varContext;
+
+    /**
+     * The index of the variable's value in the stylesheet's cache of
+     * global values, or -1 if the value isn't cached.
+     */
+    int             m_globalValueIndex;
 };
 
 
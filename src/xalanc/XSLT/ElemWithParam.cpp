@@ -149,6 +149,12 @@ ElemWithParam::startElement(StylesheetExecutionContext& executionContext) const
         {
             theValue = executionContext.getXObjectFactory().createStringReference(s_emptyString);
         }
+        else if (hasTextOnlyContent() == true)
+        {
+            XalanDOMString&     theResult = executionContext.getAndPushCachedString();
+
+            return beginChildrenToString(executionContext, theResult);
+        }
         else
         {
             executionContext.beginCreateXResultTreeFrag(executionContext.getCurrentNode());
@@ -195,11 +201,24 @@ ElemWithParam::endElement(StylesheetExecutionContext& executionContext) const
 {
     if (0 == m_selectPattern && 0 != getFirstChildElem())
     {
-        endExecuteChildren(executionContext);
+        if (hasTextOnlyContent() == true)
+        {
+            endChildrenToString(executionContext);
+
+            XalanDOMString&     theResult = executionContext.getAndPopCachedString();
 
-        executionContext.pushParam(
-                    *m_qname,
-                    executionContext.endCreateXResultTreeFrag());
+            executionContext.pushParam(
+                        *m_qname,
+                        executionContext.createXResultTreeFrag(theResult));
+        }
+        else
+        {
+            endExecuteChildren(executionContext);
+
+            executionContext.pushParam(
+                        *m_qname,
+                        executionContext.endCreateXResultTreeFrag());
+        }
     }
 }
 #endif
@@ -50,6 +50,8 @@ public:
      * @param qname name of element
      * @param matchPattern XPath for "match" attribute
      * @param use XPath for "use" attribute
+     * @param signature signature for the index built by the declaration
+     * @param usesDecimalFormats true if the expressions call format-number()
      */
     KeyDeclaration(
             const XalanQName&           qname,
@@ -57,13 +59,17 @@ public:
             const XPath&                use,
             const XalanDOMString&       uri,
             XalanFileLoc                lineNumber,
-            XalanFileLoc                columnNumber) :
+            XalanFileLoc                columnNumber,
+            const XalanDOMString*       signature = 0,
+            bool                        usesDecimalFormats = false) :
         m_qname(&qname),
         m_match(&matchPattern),
         m_use(&use),
         m_uri(&uri),
         m_lineNumber(lineNumber),
-        m_columnNumber(columnNumber)
+        m_columnNumber(columnNumber),
+        m_signature(signature),
+        m_usesDecimalFormats(usesDecimalFormats)
     {
     }
 
@@ -74,14 +80,21 @@ public:
         m_use(0),
         m_uri(0),
         m_lineNumber(0),
-        m_columnNumber(0)
+        m_columnNumber(0),
+        m_signature(0),
+        m_usesDecimalFormats(false)
     {
     }
 
     KeyDeclaration(const KeyDeclaration&    theSource) :
         m_qname(theSource.m_qname),
         m_match(theSource.m_match),
-        m_use(theSource.m_use)
+        m_use(theSource.m_use),
+        m_uri(theSource.m_uri),
+        m_lineNumber(theSource.m_lineNumber),
+        m_columnNumber(theSource.m_columnNumber),
+        m_signature(theSource.m_signature),
+        m_usesDecimalFormats(theSource.m_usesDecimalFormats)
     {
     }
 
@@ -155,6 +168,45 @@ public:
         return m_columnNumber;
     }
 
+    /**
+     * Retrieves the signature of the index built by the declaration.
+     * Two declarations with the same signature index the same nodes
+     * by the same values for any source document, even if they're in
+     * different stylesheets.  The signature isn't complete until the
+     * stylesheet root adds the settings which affect every key in the
+     * stylesheet.
+     *
+     * @return A pointer to the signature, or 0 if the index can't be shared.
+     */
+    const XalanDOMString*
+    getSignature() const
+    {
+        return m_signature;
+    }
+
+    /**
+     * Set the signature of the index built by the declaration.
+     *
+     * @param signature The new signature
+     */
+    void
+    setSignature(const XalanDOMString*  signature)
+    {
+        m_signature = signature;
+    }
+
+    /**
+     * Determine if the match or use expression calls format-number(),
+     * so the index depends on the stylesheet's decimal formats.
+     *
+     * @return true if the index depends on the decimal formats
+     */
+    bool
+    getUsesDecimalFormats() const
+    {
+        return m_usesDecimalFormats;
+    }
+
 private:
 
     const XalanQName*           m_qname;
@@ -168,6 +220,10 @@ private:
     XalanFileLoc                m_lineNumber;
 
     XalanFileLoc                m_columnNumber;
+
+    const XalanDOMString*       m_signature;
+
+    bool                        m_usesDecimalFormats;
 };
 
 
@@ -45,6 +45,7 @@
 
 #include "KeyDeclaration.hpp"
 #include "StylesheetExecutionContext.hpp"
+#include "XalanKeyIndexCache.hpp"
 #include "XSLTProcessorException.hpp"
 
 
@@ -55,20 +56,233 @@ namespace XALAN_CPP_NAMESPACE {
 
 const MutableNodeRefList    KeyTable::s_dummyList(XalanMemMgrs::getDummyMemMgr());
 
+const KeyTable::NodeListMapType     KeyTable::s_dummyMap(XalanMemMgrs::getDummyMemMgr());
+
 
 
 KeyTable::KeyTable(
+            MemoryManager&                      theManager,
             XalanNode*                          startNode,
-            const PrefixResolver&               resolver,
             const KeyDeclarationVectorType&     keyDeclarations,
-            StylesheetExecutionContext&         executionContext) :
-    m_keys(executionContext.getMemoryManager())
+            XalanKeyIndexCache*                 keyIndexCache) :
+    m_docKey(0),
+    m_startNode(startNode),
+    m_keys(theManager),
+    m_keyDeclarations(keyDeclarations),
+    m_keyIndexCache(keyIndexCache),
+    m_nodeListMaps(theManager)
 {
-    XalanNode*  pos = startNode;
+}
+
+
 
-	m_allKeys=keyDeclarations;
+KeyTable*
+KeyTable::create(
+            MemoryManager&                      theManager,
+            XalanNode*                          startNode,
+            const KeyDeclarationVectorType&     keyDeclarations,
+            XalanKeyIndexCache*                 keyIndexCache)
+{
+    typedef KeyTable    ThisType;
+
+    XalanAllocationGuard    theGuard(theManager, theManager.allocate(sizeof(ThisType)));
+
+    ThisType* const     theResult =
+        new (theGuard.get()) ThisType(
+                                theManager,
+                                startNode,
+                                keyDeclarations,
+                                keyIndexCache);
+    theGuard.release();
+
+    return theResult;
+}
+
+
+
+KeyTable::~KeyTable()
+{
+    MemoryManager&  theManager = m_nodeListMaps.getMemoryManager();
+
+    for (NodeListMapPtrVectorType::size_type i = 0; i < m_nodeListMaps.size(); ++i)
+    {
+        XalanDestroy(theManager, m_nodeListMaps[i]);
+    }
+}
+
+
+
+const MutableNodeRefList*
+KeyTable::getNodeSetByKey(
+                      const XalanQName&             qname, 
+                      const XalanDOMString&         ref,
+                      const PrefixResolver&         resolver,
+                      StylesheetExecutionContext&   executionContext)
+{
+    const KeysMapType::const_iterator   i = m_keys.find(qname);
+
+    const NodeListMapType* const    theMap =
+        i != m_keys.end() ?
+            (*i).second :
+            buildKey(qname, resolver, executionContext);
+
+    if (theMap == 0)
+    {
+        return 0;
+    }
+    else
+    {
+        const NodeListMapType::const_iterator   j = theMap->find(ref);
+
+        if (j != theMap->end())
+        {
+            return &(*j).second;
+        }
+        else
+        {
+            return &s_dummyList;
+        }
+    }
+}
+
+
+
+const KeyTable::NodeListMapType*
+KeyTable::buildKey(
+            const XalanQName&               qname,
+            const PrefixResolver&           resolver,
+            StylesheetExecutionContext&     executionContext)
+{
+    // Several xsl:key declarations may share the same name,
+    // so gather all of them.
+    KeyDeclarationPtrVectorType     theDeclarations(executionContext.getMemoryManager());
+
+    const XalanQName*   theKeyName = 0;
 
     const KeyDeclarationVectorType::size_type   nDeclarations =
+            m_keyDeclarations.size();
+
+    for (KeyDeclarationVectorType::size_type i = 0; i < nDeclarations; ++i)
+    {
+        const KeyDeclaration&   kd = m_keyDeclarations[i];
+        assert(kd.getQName() != 0);
+
+        if (*kd.getQName() == qname)
+        {
+            theKeyName = kd.getQName();
+
+            theDeclarations.push_back(&kd);
+        }
+    }
+
+    if (theDeclarations.empty() == true)
+    {
+        return 0;
+    }
+    else
+    {
+        assert(theKeyName != 0);
+
+        // Add an empty entry first, so a reference to this key from
+        // one of its own use expressions doesn't start another build.
+        m_keys[*theKeyName] = &s_dummyMap;
+
+        const NodeListMapType*  theResult = 0;
+
+        if (m_keyIndexCache != 0)
+        {
+            theResult = buildSharedKey(theDeclarations, resolver, executionContext);
+        }
+
+        if (theResult == 0)
+        {
+            MemoryManager&  theManager = m_nodeListMaps.getMemoryManager();
+
+            m_nodeListMaps.reserve(m_nodeListMaps.size() + 1);
+
+            NodeListMapType*    theKeyMap = 0;
+
+            XalanConstruct(theManager, theKeyMap, theManager);
+
+            m_nodeListMaps.push_back(theKeyMap);
+
+            buildNodeListMap(
+                *theKeyMap,
+                theDeclarations,
+                resolver,
+                executionContext);
+
+            theResult = theKeyMap;
+        }
+
+        m_keys[*theKeyName] = theResult;
+
+        return theResult;
+    }
+}
+
+
+
+const KeyTable::NodeListMapType*
+KeyTable::buildSharedKey(
+            const KeyDeclarationPtrVectorType&  keyDeclarations,
+            const PrefixResolver&               resolver,
+            StylesheetExecutionContext&         executionContext)
+{
+    assert(m_keyIndexCache != 0);
+
+    const StylesheetExecutionContext::GetCachedString   theGuard(executionContext);
+
+    XalanDOMString&     theSignature = theGuard.get();
+
+    for (KeyDeclarationPtrVectorType::size_type i = 0; i < keyDeclarations.size(); ++i)
+    {
+        const XalanDOMString* const     theDeclarationSignature =
+            keyDeclarations[i]->getSignature();
+
+        if (theDeclarationSignature == 0)
+        {
+            return 0;
+        }
+
+        theSignature.append(*theDeclarationSignature);
+    }
+
+    const NodeListMapType* const    theCachedMap =
+        m_keyIndexCache->find(theSignature);
+
+    if (theCachedMap != 0)
+    {
+        return theCachedMap;
+    }
+    else
+    {
+        NodeListMapType     theKeyMap(m_keyIndexCache->getMemoryManager());
+
+        buildNodeListMap(
+            theKeyMap,
+            keyDeclarations,
+            resolver,
+            executionContext);
+
+        return m_keyIndexCache->insert(theSignature, theKeyMap);
+    }
+}
+
+
+
+void
+KeyTable::buildNodeListMap(
+            NodeListMapType&                    theKeyMap,
+            const KeyDeclarationPtrVectorType&  keyDeclarations,
+            const PrefixResolver&               resolver,
+            StylesheetExecutionContext&         executionContext) const
+{
+    XalanNode* const    startNode = m_startNode;
+
+    XalanNode*  pos = startNode;
+
+    const KeyDeclarationPtrVectorType::size_type    nDeclarations =
             keyDeclarations.size();
 
     // Do a non-recursive pre-walk over the tree.
@@ -106,9 +320,9 @@ KeyTable::KeyTable(
         for (XalanSize_t i = 0; i < nNodes; ++i)
         {
             // Walk through each of the declarations made with xsl:key
-            for (KeyDeclarationVectorType::size_type i = 0; i < nDeclarations; ++i)
+            for (KeyDeclarationPtrVectorType::size_type i = 0; i < nDeclarations; ++i)
             {
-                const KeyDeclaration&   kd = keyDeclarations[i];
+                const KeyDeclaration&   kd = *keyDeclarations[i];
 
                 // See if our node matches the given key declaration according to 
                 // the match attribute on xsl:key.
@@ -123,7 +337,7 @@ KeyTable::KeyTable(
                 if (score != XPath::eMatchScoreNone)
                 {
                     processKeyDeclaration(
-                        m_keys,
+                        theKeyMap,
                         kd,
                         testNode,
                         resolver,
@@ -169,105 +383,20 @@ KeyTable::KeyTable(
         pos = nextNode;
     } // while(0 != pos)
 
-    if (m_keys.empty() == false)
+    if (theKeyMap.empty() == false)
     {
-        const KeysMapType::iterator     theEnd = m_keys.end();
-        KeysMapType::iterator           theCurrent = m_keys.begin();
+        const NodeListMapType::iterator     theEnd = theKeyMap.end();
+        NodeListMapType::iterator           theCurrent = theKeyMap.begin();
         assert(theCurrent != theEnd);
 
         do
         {
-            NodeListMapType&    theCurrentNodeListMap = (*theCurrent).second;
-
-            if (theCurrentNodeListMap.empty() == false)
-            {
-                const NodeListMapType::iterator     theEnd = theCurrentNodeListMap.end();
-                NodeListMapType::iterator           theCurrent = theCurrentNodeListMap.begin();
-                assert(theCurrent != theEnd);
-
-                do
-                {
-                    (*theCurrent).second.setDocumentOrder();
-
-                    ++theCurrent;
-                }
-                while(theCurrent != theEnd);
-            }
+            (*theCurrent).second.setDocumentOrder();
 
             ++theCurrent;
         }
         while(theCurrent != theEnd);
-    }   
-} // end constructor
-
-
-
-KeyTable*
-KeyTable::create(
-            MemoryManager&                      theManager,
-            XalanNode*                          startNode,
-            const PrefixResolver&               resolver,
-            const KeyDeclarationVectorType&     keyDeclarations,
-            StylesheetExecutionContext&         executionContext)
-{
-    typedef KeyTable    ThisType;
-
-    XalanAllocationGuard    theGuard(theManager, theManager.allocate(sizeof(ThisType)));
-
-    ThisType* const     theResult =
-        new (theGuard.get()) ThisType(
-                                startNode,
-                                resolver,
-                                keyDeclarations,
-                                executionContext);
-    theGuard.release();
-
-    return theResult;
-}
-
-
-
-KeyTable::~KeyTable()
-{
-}
-
-
-
-const MutableNodeRefList*
-KeyTable::getNodeSetByKey(
-                      const XalanQName&         qname, 
-                      const XalanDOMString&     ref) const
-{
-    const KeysMapType::const_iterator   i = m_keys.find(qname);
-
-    if (i != m_keys.end())
-    {
-        const NodeListMapType&  theMap = (*i).second;
-
-        const NodeListMapType::const_iterator   j = theMap.find(ref);
-
-        if (j != theMap.end())
-        {
-            return &(*j).second;
-        }
-        else
-        {
-            return &s_dummyList;
-        }
-    }
-    else
-    {
-        size_type nDeclarations=m_allKeys.size();
-        for (KeyDeclarationVectorType::size_type i = 0; i < nDeclarations; ++i)
-        {
-            if (*m_allKeys[i].getQName()==qname)
-            {
-                return &s_dummyList;
-            }
-        }
     }
-
-    return 0;
 }
 
 
@@ -286,7 +415,7 @@ static const NodeRefList    theEmptyList(XalanMemMgrs::getDummyMemMgr());
 
 void
 KeyTable::processKeyDeclaration(
-            KeysMapType&                    theKeys,
+            NodeListMapType&                theKeyMap,
             const KeyDeclaration&           kd,
             XalanNode*                      testNode,
             const PrefixResolver&           resolver,
@@ -300,11 +429,9 @@ KeyTable::processKeyDeclaration(
 
     if(xuse->getType() != XObject::eTypeNodeSet)
     {
-        assert(kd.getQName() != 0);
-
         addIfNotFound(
             executionContext,
-            theKeys[*kd.getQName()][xuse->str(executionContext)],
+            theKeyMap[xuse->str(executionContext)],
             testNode);
     }
     else
@@ -329,11 +456,9 @@ KeyTable::processKeyDeclaration(
 
             DOMServices::getNodeData(*nl.item(i), executionContext, nodeData);
 
-            assert(kd.getQName() != 0);
-
             addIfNotFound(
                 executionContext,
-                theKeys[*kd.getQName()][nodeData],
+                theKeyMap[nodeData],
                 testNode);
 
             nodeData.clear();
@@ -53,6 +53,7 @@ class PrefixResolver;
 class StylesheetExecutionContext;
 class XalanElement;
 class XalanDocument;
+class XalanKeyIndexCache;
 class XalanNode;
 
 
@@ -77,29 +78,32 @@ public:
 
     typedef NodeListMapTypeDefinitions NodeListMapType;
 
-    typedef XalanMap<XalanQNameByReference, NodeListMapType>    KeysMapType;
+    typedef XalanMap<XalanQNameByReference, const NodeListMapType*>     KeysMapType;
 
     /**
-     * Build a keys table.
+     * Create a keys table.  The index for each key name is not built
+     * until the first time that key is requested.
      *
+     * @param theManager       memory manager for the table
      * @param startNode        node to start iterating from to build the keys
      *                         index
-     * @param nscontext        stylesheet's namespace context
-     * @param keyDeclarations  stylesheet's xsl:key declarations
-     * @param executionContext current execution context
+     * @param keyDeclarations  stylesheet's xsl:key declarations, which must
+     *                         outlive the table
+     * @param keyIndexCache    a shared cache of indexes for the document
+     *                         that contains startNode, if any
      */
     KeyTable(
+            MemoryManager&                      theManager,
             XalanNode*                          startNode,
-            const PrefixResolver&               resolver,
             const KeyDeclarationVectorType&     keyDeclarations,
-            StylesheetExecutionContext&         executionContext);
+            XalanKeyIndexCache*                 keyIndexCache = 0);
 
     static KeyTable*
-    create(MemoryManager& theManager,
+    create(
+            MemoryManager&                      theManager,
             XalanNode*                          startNode,
-            const PrefixResolver&               resolver,
             const KeyDeclarationVectorType&     keyDeclarations,
-            StylesheetExecutionContext&         executionContext);
+            XalanKeyIndexCache*                 keyIndexCache = 0);
 
     virtual
     ~KeyTable();
@@ -108,24 +112,52 @@ public:
      * Given a valid element key, return the corresponding node list. If the
      * name was not declared with xsl:key, this will return null, the
      * identifier is not found, it will return an empty node set, otherwise it
-     * will return a nodeset of nodes.
+     * will return a nodeset of nodes.  The index for the key name is built
+     * the first time it is requested.
      *
      * @param name name of the key, which must match the 'name' attribute on
      *             xsl:key
      * @param ref  value that must match the value found by the 'match'
      *             attribute on xsl:key
+     * @param resolver         resolver for namespace resolution
+     * @param executionContext current execution context
      * @return      pointer to nodeset for key 
      */
     const MutableNodeRefList*
     getNodeSetByKey(
-                  const XalanQName&         qname,
-                  const XalanDOMString&     ref) const;
+                  const XalanQName&             qname,
+                  const XalanDOMString&         ref,
+                  const PrefixResolver&         resolver,
+                  StylesheetExecutionContext&   executionContext);
 
 private:
 
+    typedef XalanVector<const KeyDeclaration*>  KeyDeclarationPtrVectorType;
+
+    typedef XalanVector<NodeListMapType*>       NodeListMapPtrVectorType;
+
+    const NodeListMapType*
+    buildKey(
+            const XalanQName&               qname,
+            const PrefixResolver&           resolver,
+            StylesheetExecutionContext&     executionContext);
+
+    const NodeListMapType*
+    buildSharedKey(
+            const KeyDeclarationPtrVectorType&  keyDeclarations,
+            const PrefixResolver&               resolver,
+            StylesheetExecutionContext&         executionContext);
+
+    void
+    buildNodeListMap(
+            NodeListMapType&                    theKeyMap,
+            const KeyDeclarationPtrVectorType&  keyDeclarations,
+            const PrefixResolver&               resolver,
+            StylesheetExecutionContext&         executionContext) const;
+
     static void
     processKeyDeclaration(
-            KeysMapType&                    theKeys,
+            NodeListMapType&                theKeyMap,
             const KeyDeclaration&           kd,
             XalanNode*                      testNode,
             const PrefixResolver&           resolver,
@@ -138,9 +170,13 @@ private:
     const XalanDocument*    m_docKey;
 
     /**
-     * Table of element keys.  The table will be built on demand, 
-     * when a key is requested, or set by the XMLParserLiaison or 
-     * the caller.  The table is:
+     * The node to start iterating from to build the keys index.
+     */
+    XalanNode* const                    m_startNode;
+
+    /**
+     * Table of element keys.  The entry for each key name will be built
+     * on demand, when the key is first requested.  The table is:
      * a) keyed by name,
      * b) each with a value of a hashtable, keyed by the value returned by 
      *    the use attribute,
@@ -151,9 +187,22 @@ private:
 
     KeysMapType                         m_keys;
 
+    const KeyDeclarationVectorType&     m_keyDeclarations;
+
+    /**
+     * The shared cache of indexes, if any.  Indexes found in the cache,
+     * or built and added to it, are owned by the cache.
+     */
+    XalanKeyIndexCache* const           m_keyIndexCache;
+
+    /**
+     * The indexes owned by this table.
+     */
+    NodeListMapPtrVectorType            m_nodeListMaps;
+
     static const MutableNodeRefList     s_dummyList;
 
-    KeyDeclarationVectorType m_allKeys;
+    static const NodeListMapType        s_dummyMap;
 };
 
 
@@ -632,6 +632,30 @@ NamespacesHandler::outputResultNamespaces(
 
 
 
+bool
+NamespacesHandler::declarationsAreSubsetOf(const NamespacesHandler&     theOther) const
+{
+    const NamespaceExtendedVectorType::const_iterator   theEnd =
+            m_namespaceDeclarations.end();
+
+    for(NamespaceExtendedVectorType::const_iterator i = m_namespaceDeclarations.begin();
+            i != theEnd;
+                ++i)
+    {
+        const XalanDOMString* const     theOtherURI =
+            findNamespace(theOther.m_namespaceDeclarations, (*i).getPrefix());
+
+        if (theOtherURI == 0 || !equals(*theOtherURI, (*i).getURI()))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
 bool
 NamespacesHandler::isExcludedNamespaceURI(const XalanDOMString&     theNamespaceURI) const
 {
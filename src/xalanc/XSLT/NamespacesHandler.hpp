@@ -344,6 +344,18 @@ public:
             StylesheetExecutionContext&     theExecutionContext,
             bool                            supressDefault = false) const;
 
+    /**
+     * Determine if every result namespace declaration of this handler
+     * is also made, with the same URI, by another handler.  If so, an
+     * element using this handler never needs to declare any namespaces
+     * when it is a child of an element using the other handler.
+     *
+     * @param theOther The other handler.
+     * @return true if all of the declarations are made by theOther.
+     */
+    bool
+    declarationsAreSubsetOf(const NamespacesHandler&    theOther) const;
+
     /**
      * Clear out the handler.
      */
@@ -21,8 +21,19 @@
 
 
 
+#include <algorithm>
+
+
+
+#include <xalanc/XalanDOM/XalanAttr.hpp>
+#include <xalanc/XalanDOM/XalanDocument.hpp>
+#include <xalanc/XalanDOM/XalanNamedNodeMap.hpp>
+
+
+
 #include <xalanc/PlatformSupport/DOMStringHelper.hpp>
 #include <xalanc/PlatformSupport/DoubleSupport.hpp>
+#include <xalanc/PlatformSupport/XalanThreadPool.hpp>
 
 
 
@@ -39,11 +50,17 @@ namespace XALAN_CPP_NAMESPACE {
 
 
 
+XalanThreadPool*    NodeSorter::s_threadPool = 0;
+
+
+
 NodeSorter::NodeSorter(MemoryManager& theManager) :
     m_numberResultsCache(theManager),
     m_stringResultsCache(theManager),
     m_keys(theManager),
-    m_scratchVector(theManager)
+    m_scratchVector(theManager),
+    m_parallelSortThreshold(eDefaultParallelSortThreshold),
+    m_parallelSortThreadCount(0)
 {
 }
 
@@ -55,6 +72,64 @@ NodeSorter::~NodeSorter()
 
 
 
+void
+NodeSorter::initialize(MemoryManager&   theManager)
+{
+    assert(s_threadPool == 0);
+
+    XalanConstruct(
+        theManager,
+        s_threadPool,
+        theManager,
+        XalanThreadPool::getDefaultThreadCount());
+}
+
+
+
+void
+NodeSorter::terminate()
+{
+    if (s_threadPool != 0)
+    {
+        XalanDestroy(s_threadPool->getMemoryManager(), s_threadPool);
+
+        s_threadPool = 0;
+    }
+}
+
+
+
+unsigned int
+NodeSorter::getTaskCount() const
+{
+    if (s_threadPool == 0 ||
+        m_parallelSortThreshold == 0 ||
+        m_scratchVector.size() < m_parallelSortThreshold)
+    {
+        return 1;
+    }
+    else
+    {
+        unsigned int    theTaskCount =
+            m_parallelSortThreadCount != 0 ?
+                m_parallelSortThreadCount :
+                s_threadPool->getThreadCount() + 1;
+
+        // Don't bother with tasks that are too small to be worth a thread.
+        const NodeVectorType::size_type     theMaximumCount =
+            m_scratchVector.size() / eMinimumTaskLength;
+
+        if (theTaskCount > theMaximumCount)
+        {
+            theTaskCount = theMaximumCount == 0 ? 1 : (unsigned int)theMaximumCount;
+        }
+
+        return theTaskCount;
+    }
+}
+
+
+
 void
 NodeSorter::sort(StylesheetExecutionContext&    executionContext)
 {
@@ -64,20 +139,203 @@ NodeSorter::sort(StylesheetExecutionContext&    executionContext)
     const CollectionClearGuard<NumberResultsCacheType>  guard1(m_numberResultsCache);
     const CollectionClearGuard<StringResultsCacheType>  guard2(m_stringResultsCache);
 
-    NodeSortKeyCompare  theComparer(
-                    executionContext,
-                    *this,
-                    m_scratchVector,
-                    m_keys);
-
-    using std::stable_sort;
-
-    // Use the stl sort algorithm, which will use our compare functor,
-    // which returns true if first less than second
-    stable_sort(
-            m_scratchVector.begin(),
-            m_scratchVector.end(),
-            theComparer);
+    const unsigned int  theTaskCount = getTaskCount();
+
+    computeKeys(executionContext, theTaskCount);
+
+    if (m_keys.size() == 1 &&
+        m_keys[0].getTreatAsNumbers() == true &&
+        m_scratchVector.size() > NodeVectorType::size_type(eRadixSortThreshold))
+    {
+        radixSort(m_numberResultsCache[0], m_keys[0].getDescending());
+    }
+    else
+    {
+        NodeSortKeyCompare  theComparer(
+                        executionContext,
+                        *this,
+                        m_scratchVector,
+                        m_keys);
+
+        if (theTaskCount > 1 &&
+            theComparer.isThreadSafe() == true)
+        {
+            parallelSort(theComparer, theTaskCount);
+        }
+        else
+        {
+            using std::stable_sort;
+
+            // Use the stl sort algorithm, which will use our compare functor,
+            // which returns true if first less than second
+            stable_sort(
+                    m_scratchVector.begin(),
+                    m_scratchVector.end(),
+                    theComparer);
+        }
+    }
+}
+
+
+
+namespace {
+
+
+
+typedef NodeSorter::NodeVectorType::iterator    NodeVectorIteratorType;
+
+
+
+struct SortRunTask : public XalanThreadPool::Task
+{
+    virtual void
+    run()
+    {
+        std::stable_sort(m_first, m_last, *m_comparer);
+    }
+
+    NodeVectorIteratorType                      m_first;
+    NodeVectorIteratorType                      m_last;
+    const NodeSorter::NodeSortKeyCompare*       m_comparer;
+};
+
+
+
+struct MergeRunsTask : public XalanThreadPool::Task
+{
+    virtual void
+    run()
+    {
+        // std::merge() takes equal elements from the first run
+        // first, so the merge is stable.
+        std::merge(m_first, m_middle, m_middle, m_last, m_target, *m_comparer);
+    }
+
+    NodeVectorIteratorType                      m_first;
+    NodeVectorIteratorType                      m_middle;
+    NodeVectorIteratorType                      m_last;
+    NodeVectorIteratorType                      m_target;
+    const NodeSorter::NodeSortKeyCompare*       m_comparer;
+};
+
+
+
+template<class TaskType>
+void
+runTasks(
+            XalanVector<TaskType>&  theTasks,
+            XalanThreadPool&        thePool)
+{
+    typedef typename XalanVector<TaskType>::size_type   size_type;
+
+    XalanThreadPool::TaskVectorType     theTaskPointers(theTasks.getMemoryManager());
+
+    theTaskPointers.reserve(theTasks.size());
+
+    for (size_type i = 0; i < theTasks.size(); ++i)
+    {
+        theTaskPointers.push_back(&theTasks[i]);
+    }
+
+    thePool.run(theTaskPointers);
+}
+
+
+
+}
+
+
+
+void
+NodeSorter::parallelSort(
+            const NodeSortKeyCompare&   theComparer,
+            unsigned int                theTaskCount)
+{
+    typedef NodeVectorType::size_type   size_type;
+
+    assert(s_threadPool != 0);
+    assert(theTaskCount > 1);
+
+    const size_type     theNodeCount = m_scratchVector.size();
+
+    const size_type     theRunCount = theTaskCount;
+
+    MemoryManager&  theManager = m_scratchVector.getMemoryManager();
+
+    // The boundaries of the runs...
+    XalanVector<size_type>  theBounds(theManager);
+
+    theBounds.reserve(theRunCount + 1);
+
+    for (size_type i = 0; i <= theRunCount; ++i)
+    {
+        theBounds.push_back(theNodeCount * i / theRunCount);
+    }
+
+    {
+        XalanVector<SortRunTask>    theTasks(theManager);
+
+        theTasks.resize(theRunCount);
+
+        for (size_type i = 0; i < theRunCount; ++i)
+        {
+            theTasks[i].m_first = m_scratchVector.begin() + theBounds[i];
+            theTasks[i].m_last = m_scratchVector.begin() + theBounds[i + 1];
+            theTasks[i].m_comparer = &theComparer;
+        }
+
+        runTasks(theTasks, *s_threadPool);
+    }
+
+    NodeVectorType  theTemp(theManager);
+
+    theTemp.resize(theNodeCount);
+
+    NodeVectorType*     theSource = &m_scratchVector;
+    NodeVectorType*     theTarget = &theTemp;
+
+    XalanVector<MergeRunsTask>  theTasks(theManager);
+
+    XalanVector<size_type>      theNewBounds(theManager);
+
+    // Merge adjacent pairs of runs until there's only one left.
+    while (theBounds.size() > 2)
+    {
+        theTasks.clear();
+        theNewBounds.clear();
+
+        const size_type     theCount = theBounds.size() - 1;
+
+        for (size_type i = 0; i < theCount; i += 2)
+        {
+            MergeRunsTask   theTask;
+
+            theTask.m_first = theSource->begin() + theBounds[i];
+            theTask.m_middle = theSource->begin() + theBounds[i + 1];
+            theTask.m_last = i + 2 <= theCount ? theSource->begin() + theBounds[i + 2] : theTask.m_middle;
+            theTask.m_target = theTarget->begin() + theBounds[i];
+            theTask.m_comparer = &theComparer;
+
+            theTasks.push_back(theTask);
+
+            theNewBounds.push_back(theBounds[i]);
+        }
+
+        theNewBounds.push_back(theNodeCount);
+
+        runTasks(theTasks, *s_threadPool);
+
+        theBounds.swap(theNewBounds);
+
+        using std::swap;
+
+        swap(theSource, theTarget);
+    }
+
+    if (theSource != &m_scratchVector)
+    {
+        m_scratchVector.swap(theTemp);
+    }
 }
 
 
@@ -151,83 +409,6 @@ doCollationCompare(
 
 
 
-int
-NodeSorter::NodeSortKeyCompare::compare(
-                const NodeVectorType::value_type&    theLHS,
-                const NodeVectorType::value_type&    theRHS,
-                XalanSize_t                          theKeyIndex) const
-{
-    assert(theLHS.m_node != 0 && theRHS.m_node != 0);
-    assert(theKeyIndex < m_nodeSortKeys.size());
-
-    int                 theResult = 0;
-
-    const NodeSortKey&  theKey = m_nodeSortKeys[theKeyIndex];
-
-    // Compare as numbers
-    if(theKey.getTreatAsNumbers() == false)
-    {
-        // Compare as strings...
-        const XalanDOMString&   theLHSString =
-            getStringResult(theKey, theKeyIndex, theLHS);
-
-        const XalanDOMString&   theRHSString =
-            getStringResult(theKey, theKeyIndex, theRHS);
-
-        theResult = doCollationCompare(
-                m_executionContext,
-                theLHSString,
-                theRHSString,
-                theKey.getLanguageString(),
-                theKey.getCaseOrder());
-    }
-    else
-    {
-        const double    n1Num = getNumberResult(theKey, theKeyIndex, theLHS);
-        const double    n2Num = getNumberResult(theKey, theKeyIndex, theRHS);
-
-        // Always order NaN before anything else...
-        if (DoubleSupport::isNaN(n1Num) == true)
-        {
-            if (DoubleSupport::isNaN(n2Num) == false)
-            {
-                theResult = -1;
-            }
-        }
-        else if (DoubleSupport::isNaN(n2Num) == true)
-        {
-            theResult = 1;
-        }
-        else if (DoubleSupport::lessThan(n1Num, n2Num) == true)
-        {
-            theResult = -1;
-        }
-        else if (DoubleSupport::greaterThan(n1Num, n2Num) == true)
-        {
-            theResult = 1;
-        }
-    }
-
-    // If they're not equal, the flip things if the
-    // order is descending...
-    if (theResult != 0)
-    {
-        if (theKey.getDescending() == true)
-        {
-            theResult = -theResult;
-        }
-    }
-    else if(theKeyIndex + 1 < m_nodeSortKeys.size())
-    {
-        // They're equal, so process the next key, if any...
-        theResult = compare(theLHS, theRHS, theKeyIndex + 1);
-    }
-
-    return theResult;
-}
-
-
-
 inline double
 getResult(
             const XPath*            theXPath,
@@ -263,70 +444,6 @@ getResult(
 
 
 
-double
-NodeSorter::NodeSortKeyCompare::getNumberResult(
-                const NodeSortKey&                   theKey,
-                XalanSize_t                          theKeyIndex,
-                const NodeVectorType::value_type&    theEntry) const
-{
-    assert(theKey.getPrefixResolver() != 0);
-
-    const XPath* const  xpath = theKey.getSelectPattern();
-
-    typedef NodeSorter::NumberResultsCacheType  NumberResultsCacheType;
-
-    NumberResultsCacheType&     theCache =
-            m_sorter.m_numberResultsCache;
-
-    if (theCache.empty() == true)
-    {
-        theCache.resize(m_nodeSortKeys.size());
-    }
-
-    // We need a dummy value to indicate that a slot has
-    // never been evaluated.  0 is probably a bad idea,
-    // as is NaN, since that would be fairly common with
-    // values that are not convertible to a number.  This
-    // is just a not-so-random number...
-    const double    theDummyValue = 135792468.0L;
-
-    if (theCache[theKeyIndex].empty() == false)
-    {
-        if (DoubleSupport::equal(theCache[theKeyIndex][theEntry.m_position], theDummyValue) == true)
-        {
-            theCache[theKeyIndex][theEntry.m_position] =
-                getResult(
-                    xpath,
-                    theEntry.m_node,
-                    *theKey.getPrefixResolver(),
-                    m_executionContext);
-        }
-    }
-    else
-    {
-        theCache[theKeyIndex].resize(m_nodes.size(), 0);
-
-        using std::fill;
-
-        // Fill with the dummy value...
-        fill(
-            theCache[theKeyIndex].begin(),
-            theCache[theKeyIndex].end(),
-            theDummyValue);
-
-        theCache[theKeyIndex][theEntry.m_position] =
-            getResult(
-                xpath,
-                theEntry.m_node,
-                *theKey.getPrefixResolver(),
-                m_executionContext);
-    }
-
-    return theCache[theKeyIndex][theEntry.m_position];
-}
-
-
-
 #if defined(XALAN_NODESORTER_CACHE_XOBJECTS)
 
 inline void
@@ -352,18 +469,6 @@ getResult(
     }
 }
 
-inline bool
-notCached(const XObjectPtr&     theEntry)
-{
-    return theEntry.null();
-}
-
-inline bool
-isCached(const XObjectPtr&  theEntry)
-{
-    return !theEntry.null();
-}
-
 inline const XalanDOMString&
 cacheValue(const XObjectPtr&    theEntry)
 {
@@ -399,76 +504,567 @@ getResult(
     }
 }
 
-inline bool
-notCached(const XalanDOMString&     theEntry)
+inline const XalanDOMString&
+cacheValue(const XalanDOMString&    theEntry)
 {
-    return theEntry.empty();
+    return theEntry;
 }
 
-inline bool
-isCached(const XalanDOMString&  /* theEntry */)
+#endif
+
+
+
+inline XMLUInt64
+makeNumberKey(double    theValue)
 {
+    // NaN is always ordered before anything else...
+    if (DoubleSupport::isNaN(theValue) == true)
+    {
+        return 0;
+    }
+    else
+    {
+        // Make sure -0 and 0 have the same key.
+        if (theValue == 0.0)
+        {
+            theValue = 0.0;
+        }
+
+        union
+        {
+            double      d;
+            XMLUInt64   i;
+        } theUnion;
+
+        theUnion.d = theValue;
+
+        const XMLUInt64     theBits = theUnion.i;
+
+        // Flip all of the bits of negative numbers, and the sign
+        // bit of positive numbers, so the keys are in the same
+        // order as the numbers, and all keys are greater than 0.
+        const XMLUInt64     theSignBit = XMLUInt64(1) << 63;
+
+        return (theBits & theSignBit) != 0 ? ~theBits : theBits | theSignBit;
+    }
+}
+
+
+
+namespace {
+
+
+
+// If a key is "." or a single attribute name test, get its value
+// straight from the node, which doesn't need the execution context.
+// The namespace URI and local name are 0 for ".".
+bool
+isDirectKey(
+            const NodeSortKey&          theKey,
+            const ExecutionContext&     theExecutionContext,
+            const XalanDOMString*&      theNamespace,
+            const XalanDOMString*&      theLocalName)
+{
+#if defined(XALAN_NODESORTER_CACHE_XOBJECTS)
+    // The cached values of text keys are created by the
+    // XObject factory.
+    if (theKey.getTreatAsNumbers() == false)
+    {
+        return false;
+    }
+#endif
+
+    const XPath* const  theXPath = theKey.getSelectPattern();
+
+    if (theXPath == 0)
+    {
+        theNamespace = 0;
+        theLocalName = 0;
+
+        // Stripping whitespace text nodes needs the execution context.
+        return theExecutionContext.hasPreserveOrStripSpaceConditions() == false;
+    }
+    else
+    {
+        return theXPath->getAttributeNameTest(theNamespace, theLocalName);
+    }
+}
+
+
+
+// Determine if the nodes can be read from several threads at once.
+// That's true of a document which is fully built and indexed, such
+// as a source tree, because it's never modified while it's read.
+bool
+isIndexed(const NodeSorter::NodeVectorType&     theNodes)
+{
+    const XalanNode*    theLastDocument = 0;
+
+    for (NodeSorter::NodeVectorType::size_type i = 0; i < theNodes.size(); ++i)
+    {
+        const XalanNode* const  theNode = theNodes[i].m_node;
+        assert(theNode != 0);
+
+        const XalanNode* const  theDocument =
+            theNode->getNodeType() == XalanNode::DOCUMENT_NODE ?
+                theNode :
+                theNode->getOwnerDocument();
+
+        if (theDocument != theLastDocument)
+        {
+            if (theDocument == 0 || theDocument->isIndexed() == false)
+            {
+                return false;
+            }
+
+            theLastDocument = theDocument;
+        }
+    }
+
     return true;
 }
 
-inline const XalanDOMString&
-cacheValue(const XalanDOMString&    theEntry)
+
+
+void
+getDirectResult(
+            const XalanNode&        theNode,
+            const XalanDOMString*   theNamespace,
+            const XalanDOMString*   theLocalName,
+            XalanDOMString&         theResult)
 {
-    return theEntry;
+    if (theLocalName == 0)
+    {
+        DOMServices::getNodeData(theNode, theResult);
+    }
+    else
+    {
+        assert(theNamespace != 0);
+
+        // This is the same test as the node tester of the attribute
+        // axis, which skips namespace declarations.
+        const XalanNamedNodeMap* const  theAttributes = theNode.getAttributes();
+
+        if (theAttributes != 0)
+        {
+            const XalanSize_t   theLength = theAttributes->getLength();
+
+            for (XalanSize_t i = 0; i < theLength; ++i)
+            {
+                const XalanNode* const  theAttribute = theAttributes->item(i);
+                assert(theAttribute != 0);
+
+                if (DOMServices::isNamespaceDeclaration(static_cast<const XalanAttr&>(*theAttribute)) == false &&
+                    theAttribute->getNamespaceURI() == *theNamespace &&
+                    DOMServices::getLocalNameOfNode(*theAttribute) == *theLocalName)
+                {
+                    theResult.append(theAttribute->getNodeValue());
+
+                    break;
+                }
+            }
+        }
+    }
 }
 
+
+
+// Extract the values of a key for a range of the nodes.  The values
+// are stored by position, so each task writes its own entries.
+struct ExtractKeysTask : public XalanThreadPool::Task
+{
+    virtual void
+    run()
+    {
+        typedef NodeSorter::NodeVectorType::size_type   size_type;
+
+        if (m_numbers != 0)
+        {
+            MemoryManager&  theManager = m_nodes->getMemoryManager();
+
+            XalanDOMString  theString(theManager);
+
+            for (size_type i = m_first; i < m_last; ++i)
+            {
+                const NodeSorter::VectorEntry&  theEntry = (*m_nodes)[i];
+
+                getDirectResult(*theEntry.m_node, m_namespace, m_localName, theString);
+
+                (*m_numbers)[theEntry.m_position] =
+                    makeNumberKey(DoubleSupport::toDouble(theString, theManager));
+
+                theString.clear();
+            }
+        }
+#if !defined(XALAN_NODESORTER_CACHE_XOBJECTS)
+        else
+        {
+            assert(m_strings != 0);
+
+            for (size_type i = m_first; i < m_last; ++i)
+            {
+                const NodeSorter::VectorEntry&  theEntry = (*m_nodes)[i];
+
+                getDirectResult(
+                    *theEntry.m_node,
+                    m_namespace,
+                    m_localName,
+                    (*m_strings)[theEntry.m_position]);
+            }
+        }
 #endif
+    }
+
+    const NodeSorter::NodeVectorType*               m_nodes;
+    NodeSorter::NodeVectorType::size_type           m_first;
+    NodeSorter::NodeVectorType::size_type           m_last;
+    const XalanDOMString*                           m_namespace;
+    const XalanDOMString*                           m_localName;
+    NodeSorter::NumberKeyVectorType*                m_numbers;
+    NodeSorter::StringResultsCacheType::value_type* m_strings;
+};
+
 
 
+}
+
 
-const XalanDOMString&
-NodeSorter::NodeSortKeyCompare::getStringResult(
-                const NodeSortKey&                   theKey,
-                XalanSize_t                          theKeyIndex,
-                const NodeVectorType::value_type&    theEntry) const
+
+void
+NodeSorter::computeKeys(
+            StylesheetExecutionContext&     executionContext,
+            unsigned int                    theTaskCount)
 {
-    assert(theKey.getPrefixResolver() != 0);
+    const NodeVectorType::size_type     theNodeCount = m_scratchVector.size();
+
+    const NodeSortKeyVectorType::size_type  theKeyCount = m_keys.size();
 
-    const XPath* const  xpath = theKey.getSelectPattern();
+    m_numberResultsCache.resize(theKeyCount);
+    m_stringResultsCache.resize(theKeyCount);
 
-    typedef NodeSorter::StringResultsCacheType  StringResultsCacheType;
+    const bool  fSplit = theTaskCount > 1 && isIndexed(m_scratchVector) == true;
 
-    StringResultsCacheType&     theCache =
-            m_sorter.m_stringResultsCache;
+    XalanVector<ExtractKeysTask>    theTasks(m_scratchVector.getMemoryManager());
 
-    if (theCache.empty() == true)
+    for (NodeSortKeyVectorType::size_type i = 0; i < theKeyCount; ++i)
     {
-        theCache.resize(m_nodeSortKeys.size());
+        const NodeSortKey&  theKey = m_keys[i];
+        assert(theKey.getPrefixResolver() != 0);
+
+        const XPath* const  xpath = theKey.getSelectPattern();
+
+        const PrefixResolver&   theResolver = *theKey.getPrefixResolver();
+
+        const XalanDOMString*   theNamespace = 0;
+        const XalanDOMString*   theLocalName = 0;
+
+        if (fSplit == true &&
+            isDirectKey(theKey, executionContext, theNamespace, theLocalName) == true)
+        {
+            assert(s_threadPool != 0);
+
+            NumberKeyVectorType*    theNumbers = 0;
+
+            StringResultsCacheType::value_type*     theStrings = 0;
+
+            if (theKey.getTreatAsNumbers() == true)
+            {
+                theNumbers = &m_numberResultsCache[i];
+
+                theNumbers->resize(theNodeCount, 0);
+            }
+            else
+            {
+                theStrings = &m_stringResultsCache[i];
+
+                theStrings->resize(theNodeCount);
+            }
+
+            theTasks.clear();
+            theTasks.resize(theTaskCount);
+
+            for (unsigned int j = 0; j < theTaskCount; ++j)
+            {
+                ExtractKeysTask&    theTask = theTasks[j];
+
+                theTask.m_nodes = &m_scratchVector;
+                theTask.m_first = theNodeCount * j / theTaskCount;
+                theTask.m_last = theNodeCount * (j + 1) / theTaskCount;
+                theTask.m_namespace = theNamespace;
+                theTask.m_localName = theLocalName;
+                theTask.m_numbers = theNumbers;
+                theTask.m_strings = theStrings;
+            }
+
+            runTasks(theTasks, *s_threadPool);
+        }
+        else if (theKey.getTreatAsNumbers() == true)
+        {
+            NumberKeyVectorType&    theCache = m_numberResultsCache[i];
+
+            theCache.resize(theNodeCount);
+
+            for (NodeVectorType::size_type j = 0; j < theNodeCount; ++j)
+            {
+                const VectorEntry&  theEntry = m_scratchVector[j];
+                assert(theEntry.m_position < theNodeCount);
+
+                theCache[theEntry.m_position] =
+                    makeNumberKey(
+                        getResult(
+                            xpath,
+                            theEntry.m_node,
+                            theResolver,
+                            executionContext));
+            }
+        }
+        else
+        {
+            StringResultsCacheType::value_type&     theCache = m_stringResultsCache[i];
+
+            theCache.resize(theNodeCount);
+
+            for (NodeVectorType::size_type j = 0; j < theNodeCount; ++j)
+            {
+                const VectorEntry&  theEntry = m_scratchVector[j];
+                assert(theEntry.m_position < theNodeCount);
+
+                getResult(
+                    xpath,
+                    theEntry.m_node,
+                    theResolver,
+                    executionContext,
+                    theCache[theEntry.m_position]);
+            }
+        }
     }
+}
+
+
+
+void
+NodeSorter::radixSort(
+            const NumberKeyVectorType&  theKeys,
+            bool                        fDescending)
+{
+    typedef NodeVectorType::size_type   size_type;
+
+    enum { eDigitBits = 8, eDigitCount = 64 / eDigitBits, eBucketCount = 1 << eDigitBits };
+
+    const size_type     theNodeCount = m_scratchVector.size();
+    assert(theKeys.size() == theNodeCount);
 
-    if (theCache[theKeyIndex].empty() == false)
+    // Flipping the keys reverses the order, but leaves equal keys
+    // equal, so the sort is still stable.
+    const XMLUInt64     theMask = fDescending == true ? ~XMLUInt64(0) : XMLUInt64(0);
+
+    // Count the occurrences of each value of each digit in one pass.
+    size_type   theCounts[eDigitCount][eBucketCount] = { { 0 } };
+
+    for (size_type i = 0; i < theNodeCount; ++i)
     {
-        if (notCached(theCache[theKeyIndex][theEntry.m_position]) == true)
+        const XMLUInt64     theKey = theKeys[i] ^ theMask;
+
+        for (size_type theDigit = 0; theDigit < eDigitCount; ++theDigit)
         {
-            getResult(
-                xpath,
-                theEntry.m_node,
-                *theKey.getPrefixResolver(),
-                m_executionContext,
-                theCache[theKeyIndex][theEntry.m_position]);
+            ++theCounts[theDigit][(theKey >> (theDigit * eDigitBits)) & (eBucketCount - 1)];
         }
     }
-    else
+
+    NodeVectorType  theTemp(m_scratchVector.getMemoryManager());
+
+    theTemp.resize(theNodeCount);
+
+    NodeVectorType*     theSource = &m_scratchVector;
+    NodeVectorType*     theTarget = &theTemp;
+
+    for (size_type theDigit = 0; theDigit < eDigitCount; ++theDigit)
+    {
+        size_type* const    theDigitCounts = theCounts[theDigit];
+
+        const unsigned int  theShift = (unsigned int)(theDigit * eDigitBits);
+
+        // If every key has the same value for this digit,
+        // this pass wouldn't change anything.
+        const XMLUInt64     theFirstKey = theKeys[(*theSource)[0].m_position] ^ theMask;
+
+        if (theDigitCounts[(theFirstKey >> theShift) & (eBucketCount - 1)] == theNodeCount)
+        {
+            continue;
+        }
+
+        // Turn the counts into offsets...
+        size_type   theOffset = 0;
+
+        for (size_type i = 0; i < eBucketCount; ++i)
+        {
+            const size_type     theCount = theDigitCounts[i];
+
+            theDigitCounts[i] = theOffset;
+
+            theOffset += theCount;
+        }
+
+        for (size_type i = 0; i < theNodeCount; ++i)
+        {
+            const VectorEntry&  theEntry = (*theSource)[i];
+
+            const XMLUInt64     theKey = theKeys[theEntry.m_position] ^ theMask;
+
+            (*theTarget)[theDigitCounts[(theKey >> theShift) & (eBucketCount - 1)]++] = theEntry;
+        }
+
+        using std::swap;
+
+        swap(theSource, theTarget);
+    }
+
+    if (theSource != &m_scratchVector)
     {
+        m_scratchVector.swap(theTemp);
+    }
+}
 
-        theCache[theKeyIndex].resize(m_nodes.size());
 
-        getResult(
-            xpath,
-            theEntry.m_node,
-            *theKey.getPrefixResolver(),
-            m_executionContext,
-            theCache[theKeyIndex][theEntry.m_position]);
+
+inline int
+doBinaryCompare(
+            const XalanDOMString&   theLHS,
+            const XalanDOMString&   theRHS)
+{
+    // This is the same ordering as the default collation, which
+    // compares the null-terminated strings code unit by code unit.
+    const XalanDOMChar*     theLHSString = theLHS.c_str();
+    const XalanDOMChar*     theRHSString = theRHS.c_str();
+
+    while (*theLHSString != 0 && *theLHSString == *theRHSString)
+    {
+        ++theLHSString;
+        ++theRHSString;
     }
 
-    assert(isCached(theCache[theKeyIndex][theEntry.m_position]) == true);
+    return int(*theLHSString) - int(*theRHSString);
+}
+
+
+
+NodeSorter::NodeSortKeyCompare::NodeSortKeyCompare(
+            StylesheetExecutionContext&     executionContext,
+            NodeSorter&                     theSorter,
+            const NodeVectorType&           theNodes,
+            const NodeSortKeyVectorType&    theNodeSortKeys) :
+    m_executionContext(executionContext),
+    m_sorter(theSorter),
+    m_nodes(theNodes),
+    m_nodeSortKeys(theNodeSortKeys),
+    m_binaryCollation(executionContext.isDefaultCollation())
+{
+}
+
+
+
+bool
+NodeSorter::NodeSortKeyCompare::isThreadSafe() const
+{
+    for (NodeSortKeyVectorType::size_type i = 0; i < m_nodeSortKeys.size(); ++i)
+    {
+        if (m_nodeSortKeys[i].getTreatAsNumbers() == false)
+        {
+#if defined(XALAN_NODESORTER_CACHE_XOBJECTS)
+            // Getting the string value of an XObject may
+            // modify it.
+            return false;
+#else
+            if (m_binaryCollation == false)
+            {
+                return false;
+            }
+#endif
+        }
+    }
+
+    return true;
+}
+
+
+
+int
+NodeSorter::NodeSortKeyCompare::compare(
+                const NodeVectorType::value_type&    theLHS,
+                const NodeVectorType::value_type&    theRHS,
+                XalanSize_t                          theKeyIndex) const
+{
+    assert(theLHS.m_node != 0 && theRHS.m_node != 0);
+    assert(theKeyIndex < m_nodeSortKeys.size());
+
+    const XalanSize_t   theKeyCount = m_nodeSortKeys.size();
+
+    for (; theKeyIndex < theKeyCount; ++theKeyIndex)
+    {
+        int                 theResult = 0;
+
+        const NodeSortKey&  theKey = m_nodeSortKeys[theKeyIndex];
+
+        if(theKey.getTreatAsNumbers() == false)
+        {
+            // Compare as strings...
+            assert(theKeyIndex < m_sorter.m_stringResultsCache.size());
+
+            const StringResultsCacheType::value_type&   theCache =
+                m_sorter.m_stringResultsCache[theKeyIndex];
+
+            const XalanDOMString&   theLHSString =
+                cacheValue(theCache[theLHS.m_position]);
+
+            const XalanDOMString&   theRHSString =
+                cacheValue(theCache[theRHS.m_position]);
+
+            if (m_binaryCollation == true)
+            {
+                theResult = doBinaryCompare(theLHSString, theRHSString);
+            }
+            else
+            {
+                theResult = doCollationCompare(
+                        m_executionContext,
+                        theLHSString,
+                        theRHSString,
+                        theKey.getLanguageString(),
+                        theKey.getCaseOrder());
+            }
+        }
+        else
+        {
+            // Compare as numbers, using the ordered keys...
+            assert(theKeyIndex < m_sorter.m_numberResultsCache.size());
+
+            const NumberKeyVectorType&  theCache =
+                m_sorter.m_numberResultsCache[theKeyIndex];
+
+            const XMLUInt64     n1Key = theCache[theLHS.m_position];
+            const XMLUInt64     n2Key = theCache[theRHS.m_position];
+
+            if (n1Key < n2Key)
+            {
+                theResult = -1;
+            }
+            else if (n1Key > n2Key)
+            {
+                theResult = 1;
+            }
+        }
+
+        // If they're not equal, the flip things if the
+        // order is descending...
+        if (theResult != 0)
+        {
+            return theKey.getDescending() == true ? -theResult : theResult;
+        }
+
+        // They're equal, so process the next key, if any...
+    }
 
-    return cacheValue(theCache[theKeyIndex][theEntry.m_position]);
+    return 0;
 }
 
 
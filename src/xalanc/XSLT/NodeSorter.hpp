@@ -46,12 +46,16 @@ namespace XALAN_CPP_NAMESPACE {
 class MutableNodeRefList;
 class StylesheetExecutionContext;
 class XalanNode;
+class XalanThreadPool;
 class XPath;
 
 
 typedef XalanVector<double>         NumberVectorTypeDecl;
 XALAN_USES_MEMORY_MANAGER(NumberVectorTypeDecl)
 
+typedef XalanVector<XMLUInt64>      NumberKeyVectorTypeDecl;
+XALAN_USES_MEMORY_MANAGER(NumberKeyVectorTypeDecl)
+
 typedef XalanVector<XalanDOMString> StringVectorTypeDecl;
 XALAN_USES_MEMORY_MANAGER(StringVectorTypeDecl)
 
@@ -93,6 +97,73 @@ public:
         return m_keys;
     }
 
+    enum { eDefaultParallelSortThreshold = 65536 };
+
+    /**
+     * Get the minimum number of nodes for which the work of a sort
+     * is split between several threads.
+     *
+     * @return the threshold, or 0 if sorts are never split
+     */
+    XalanSize_t
+    getParallelSortThreshold() const
+    {
+        return m_parallelSortThreshold;
+    }
+
+    /**
+     * Set the minimum number of nodes for which the work of a sort
+     * is split between several threads.  The keys are extracted, and
+     * the nodes are sorted, by the threads of a pool shared by every
+     * sorter, along with the calling thread.
+     *
+     * @param theThreshold the threshold, or 0 to never split sorts
+     */
+    void
+    setParallelSortThreshold(XalanSize_t    theThreshold)
+    {
+        m_parallelSortThreshold = theThreshold;
+    }
+
+    /**
+     * Get the maximum number of threads used for a sort, including
+     * the calling thread.
+     *
+     * @return the number of threads, or 0 to use every thread of the pool
+     */
+    unsigned int
+    getParallelSortThreadCount() const
+    {
+        return m_parallelSortThreadCount;
+    }
+
+    /**
+     * Set the maximum number of threads used for a sort, including
+     * the calling thread.
+     *
+     * @param theCount the number of threads, or 0 to use every thread of the pool
+     */
+    void
+    setParallelSortThreadCount(unsigned int     theCount)
+    {
+        m_parallelSortThreadCount = theCount;
+    }
+
+    /**
+     * Create the thread pool shared by every sorter.  XSLTInit calls
+     * this when it initializes.
+     *
+     * @param theManager the memory manager for the pool, which must be thread-safe
+     */
+    static void
+    initialize(MemoryManager&   theManager);
+
+    /**
+     * Stop the threads of the shared pool, and destroy it.
+     */
+    static void
+    terminate();
+
     /**
      * Given a list of nodes, sort each node according to the criteria in the
      * keys.  The list is assumed to be in document order.
@@ -106,7 +177,9 @@ public:
             MutableNodeRefList&             theList);
 
     /**
-     * Return the results of a compare of two nodes.
+     * Return the results of a compare of two nodes.  The values of
+     * all of the keys for all of the nodes must have been computed
+     * before the comparison.
      */
     struct XALAN_XSLT_EXPORT NodeSortKeyCompare
     {
@@ -123,13 +196,7 @@ public:
                 StylesheetExecutionContext&     executionContext,
                 NodeSorter&                     theSorter,
                 const NodeVectorType&           theNodes,
-                const NodeSortKeyVectorType&    theNodeSortKeys) :
-            m_executionContext(executionContext),
-            m_sorter(theSorter),
-            m_nodes(theNodes),
-            m_nodeSortKeys(theNodeSortKeys)
-        {
-        }
+                const NodeSortKeyVectorType&    theNodeSortKeys);
 
         /**
          * Compare two nodes, returning a value to indicate the
@@ -163,19 +230,15 @@ public:
             return compare(theLHS, theRHS, theKeyIndex) < 0 ? true : false;
         }
 
-    protected:
-
-        double
-        getNumberResult(
-                const NodeSortKey&                   theKey,
-                XalanSize_t                          theKeyIndex,
-                const NodeVectorType::value_type&    theEntry) const;
-
-        const XalanDOMString&
-        getStringResult(
-                const NodeSortKey&                   theKey,
-                XalanSize_t                          theKeyIndex,
-                const NodeVectorType::value_type&    theEntry) const;
+        /**
+         * Determine if comparisons can be made from several threads
+         * at once.  This is true if no comparison needs to call into
+         * the execution context.
+         *
+         * @return true if the comparisons are thread-safe
+         */
+        bool
+        isThreadSafe() const;
 
     private:
 
@@ -183,6 +246,10 @@ public:
         NodeSorter&                     m_sorter;
         const NodeVectorType&           m_nodes;
         const NodeSortKeyVectorType&    m_nodeSortKeys;
+
+        // If true, strings are compared by their UTF-16 code
+        // units, instead of calling the collation functor.
+        const bool                      m_binaryCollation;
     };
 
     friend struct NodeSortKeyCompare;
@@ -195,7 +262,10 @@ public:
     typedef XalanVector<XObjectVectorType>  XObjectCacheType;
     typedef XalanVector<StringVectorType>   StringCacheType;
 
-    typedef NumberCacheType     NumberResultsCacheType;
+    typedef NumberKeyVectorTypeDecl             NumberKeyVectorType;
+    typedef XalanVector<NumberKeyVectorType>    NumberKeyCacheType;
+
+    typedef NumberKeyCacheType  NumberResultsCacheType;
 
 #if defined(XALAN_NODESORTER_CACHE_XOBJECTS)
     typedef XObjectCacheType    StringResultsCacheType;
@@ -214,6 +284,59 @@ private:
     void
     sort(StylesheetExecutionContext&    executionContext);
 
+    /**
+     * Get the number of tasks the work of sorting the scratch vector
+     * can be split into.
+     *
+     * @return the number of tasks, or 1 if the work isn't split
+     */
+    unsigned int
+    getTaskCount() const;
+
+    /**
+     * Evaluate every key for every node in the scratch vector, and
+     * store the results in the caches.  Keys which don't need the
+     * execution context are extracted by several tasks.
+     *
+     * @param executionContext current execution context
+     * @param theTaskCount the number of tasks to use
+     */
+    void
+    computeKeys(
+            StylesheetExecutionContext&     executionContext,
+            unsigned int                    theTaskCount);
+
+    /**
+     * Sort the scratch vector using a stable LSD radix sort on
+     * the values of a single number key.
+     *
+     * @param theKeys the values of the key, indexed by position
+     * @param fDescending true if the sort order is descending
+     */
+    void
+    radixSort(
+            const NumberKeyVectorType&  theKeys,
+            bool                        fDescending);
+
+    /**
+     * Sort the scratch vector by splitting it into runs which are
+     * sorted by separate tasks, then merging the runs.
+     *
+     * @param theComparer the comparison to use, which must be thread-safe
+     * @param theTaskCount the number of tasks to use
+     */
+    void
+    parallelSort(
+            const NodeSortKeyCompare&   theComparer,
+            unsigned int                theTaskCount);
+
+    enum { eRadixSortThreshold = 256 };
+
+    // A task never gets fewer nodes than this.
+    enum { eMinimumTaskLength = 4096 };
+
+    static XalanThreadPool*     s_threadPool;
+
     // Data members...
     NumberResultsCacheType  m_numberResultsCache;
 
@@ -222,6 +345,10 @@ private:
     NodeSortKeyVectorType   m_keys;
 
     NodeVectorType          m_scratchVector;
+
+    XalanSize_t             m_parallelSortThreshold;
+
+    unsigned int            m_parallelSortThreadCount;
 };
 
 
@@ -38,6 +38,7 @@
 
 
 #include <xalanc/PlatformSupport/XalanMessageLoader.hpp>
+#include <xalanc/PlatformSupport/XalanUnicode.hpp>
 
 
 
@@ -51,6 +52,7 @@
 
 #include <xalanc/XPath/XObject.hpp>
 #include <xalanc/XPath/XPath.hpp>
+#include <xalanc/XPath/XPathFunctionTable.hpp>
 #include <xalanc/XPath/XalanQNameByReference.hpp>
 
 
@@ -65,7 +67,9 @@
 #include "KeyTable.hpp"
 #include "StylesheetConstructionContext.hpp"
 #include "StylesheetExecutionContext.hpp"
+#include "StylesheetRoot.hpp"
 #include "XalanMatchPatternData.hpp"
+#include "XalanTemplateIndex.hpp"
 
 
 
@@ -115,7 +119,8 @@ Stylesheet::Stylesheet(
     m_nodePatternList(constructionContext.getMemoryManager()),
     m_patternCount(0),
     m_elemDecimalFormats(constructionContext.getMemoryManager()),
-    m_namespacesHandler(constructionContext.getMemoryManager())
+    m_namespacesHandler(constructionContext.getMemoryManager()),
+    m_templateIndex(0)
 {
     if (m_baseIdent.empty() == true)
     {
@@ -192,6 +197,10 @@ Stylesheet::~Stylesheet()
         m_extensionNamespaces.end(),
         makeMapValueDeleteFunctor(m_extensionNamespaces));
 
+    if (m_templateIndex != 0)
+    {
+        XalanDestroy(getMemoryManager(), *m_templateIndex);
+    }
 }
 
 
@@ -262,6 +271,392 @@ Stylesheet::initWrapperless(
 
 
 
+/**
+ * Walks the op map of an xsl:key match or use expression, to determine
+ * if its value depends only on the source document.  An expression which
+ * calls an extension function, calls key(), or refers to a variable, can
+ * have a value which depends on the stylesheet or the transformation.
+ * So can a call to function-available(), element-available() or
+ * system-property(), since they resolve a QName in a string with the
+ * namespaces of the stylesheet.
+ */
+class KeyExpressionWalker
+{
+public:
+
+    typedef XPathExpression::OpCodeMapPositionType  OpCodeMapPositionType;
+
+    KeyExpressionWalker(
+            const XPathExpression&  theExpression,
+            MemoryManager&          theManager) :
+        m_expression(theExpression),
+        m_keyID(getFunctionID(XPathFunctionTable::s_key, theManager)),
+        m_documentID(getFunctionID(XPathFunctionTable::s_document, theManager)),
+        m_formatNumberID(getFunctionID(XPathFunctionTable::s_formatNumber, theManager)),
+        m_functionAvailableID(getFunctionID(XPathFunctionTable::s_functionAvailable, theManager)),
+        m_elementAvailableID(getFunctionID(XPathFunctionTable::s_elementAvailable, theManager)),
+        m_systemPropertyID(getFunctionID(XPathFunctionTable::s_systemProperty, theManager)),
+        m_usesDocument(false),
+        m_usesFormatNumber(false)
+    {
+    }
+
+    /**
+     * Walk the expression.
+     *
+     * @return true if the value depends only on the source document, false if not.
+     */
+    bool
+    walk()
+    {
+        const OpCodeMapPositionType     opPos = m_expression.getInitialOpCodePosition();
+
+        if (m_expression.getOpCodeMapValue(opPos) == XPathExpression::eOP_MATCHPATTERN)
+        {
+            return walkPatterns(opPos + 2);
+        }
+        else
+        {
+            return walkExpression(opPos);
+        }
+    }
+
+    bool
+    getUsesDocument() const
+    {
+        return m_usesDocument;
+    }
+
+    bool
+    getUsesFormatNumber() const
+    {
+        return m_usesFormatNumber;
+    }
+
+private:
+
+    static int
+    getFunctionID(
+            const XalanDOMChar*     theName,
+            MemoryManager&          theManager)
+    {
+        return XPath::getFunctionTable().nameToID(XalanDOMString(theName, theManager));
+    }
+
+    bool
+    walkExpression(OpCodeMapPositionType    opPos)
+    {
+        switch(m_expression.getOpCodeMapValue(opPos))
+        {
+        case XPathExpression::eOP_XPATH:
+        case XPathExpression::eOP_OR:
+        case XPathExpression::eOP_AND:
+        case XPathExpression::eOP_NOTEQUALS:
+        case XPathExpression::eOP_EQUALS:
+        case XPathExpression::eOP_LTE:
+        case XPathExpression::eOP_LT:
+        case XPathExpression::eOP_GTE:
+        case XPathExpression::eOP_GT:
+        case XPathExpression::eOP_PLUS:
+        case XPathExpression::eOP_MINUS:
+        case XPathExpression::eOP_MULT:
+        case XPathExpression::eOP_DIV:
+        case XPathExpression::eOP_MOD:
+        case XPathExpression::eOP_NEG:
+        case XPathExpression::eOP_BOOL:
+        case XPathExpression::eOP_UNION:
+        case XPathExpression::eOP_GROUP:
+        case XPathExpression::eOP_ARGUMENT:
+        case XPathExpression::eOP_FUNCTION_COUNT:
+        case XPathExpression::eOP_FUNCTION_NOT:
+        case XPathExpression::eOP_FUNCTION_BOOLEAN:
+        case XPathExpression::eOP_FUNCTION_NAME_1:
+        case XPathExpression::eOP_FUNCTION_LOCALNAME_1:
+        case XPathExpression::eOP_FUNCTION_FLOOR:
+        case XPathExpression::eOP_FUNCTION_CEILING:
+        case XPathExpression::eOP_FUNCTION_ROUND:
+        case XPathExpression::eOP_FUNCTION_NUMBER_1:
+        case XPathExpression::eOP_FUNCTION_STRING_1:
+        case XPathExpression::eOP_FUNCTION_STRINGLENGTH_1:
+        case XPathExpression::eOP_FUNCTION_NAMESPACEURI_1:
+        case XPathExpression::eOP_FUNCTION_SUM:
+        case XPathExpression::eOP_FUNCTION_CONCAT:
+            return walkArguments(opPos + 2, m_expression.getNextOpCodePosition(opPos));
+
+        case XPathExpression::eOP_FUNCTION_TRANSLATE:
+            // The table index and the argument count precede the arguments.
+            return walkArguments(opPos + 4, m_expression.getNextOpCodePosition(opPos));
+
+        case XPathExpression::eOP_FUNCTION:
+            return walkFunction(opPos);
+
+        case XPathExpression::eOP_LOCATIONPATH:
+            return walkSteps(opPos + 2);
+
+        case XPathExpression::eOP_LITERAL:
+        case XPathExpression::eOP_NUMBERLIT:
+        case XPathExpression::eOP_FUNCTION_POSITION:
+        case XPathExpression::eOP_FUNCTION_LAST:
+        case XPathExpression::eOP_FUNCTION_TRUE:
+        case XPathExpression::eOP_FUNCTION_FALSE:
+        case XPathExpression::eOP_FUNCTION_NAME_0:
+        case XPathExpression::eOP_FUNCTION_LOCALNAME_0:
+        case XPathExpression::eOP_FUNCTION_NUMBER_0:
+        case XPathExpression::eOP_FUNCTION_STRING_0:
+        case XPathExpression::eOP_FUNCTION_STRINGLENGTH_0:
+        case XPathExpression::eOP_FUNCTION_NAMESPACEURI_0:
+            return true;
+
+        default:
+            // Variables, extension functions, and anything else
+            // we don't know about.
+            return false;
+        }
+    }
+
+    bool
+    walkArguments(
+            OpCodeMapPositionType   theFirstPos,
+            OpCodeMapPositionType   theEndPos)
+    {
+        for (OpCodeMapPositionType i = theFirstPos;
+                i < theEndPos && m_expression.getOpCodeMapValue(i) != XPathExpression::eENDOP;
+                    i = m_expression.getNextOpCodePosition(i))
+        {
+            if (walkExpression(i) == false)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    bool
+    walkFunction(OpCodeMapPositionType  opPos)
+    {
+        const int   theFunctionID = m_expression.getOpCodeMapValue(opPos + 2);
+
+        if (theFunctionID == m_keyID ||
+            theFunctionID == m_functionAvailableID ||
+            theFunctionID == m_elementAvailableID ||
+            theFunctionID == m_systemPropertyID)
+        {
+            return false;
+        }
+        else if (theFunctionID == m_documentID)
+        {
+            m_usesDocument = true;
+        }
+        else if (theFunctionID == m_formatNumberID)
+        {
+            m_usesFormatNumber = true;
+        }
+
+        // The arguments follow the function ID and the argument count.
+        return walkArguments(opPos + 4, m_expression.getNextOpCodePosition(opPos));
+    }
+
+    bool
+    walkPredicates(OpCodeMapPositionType&   opPos)
+    {
+        while(m_expression.getOpCodeMapValue(opPos) == XPathExpression::eOP_PREDICATE ||
+              m_expression.getOpCodeMapValue(opPos) == XPathExpression::eOP_PREDICATE_WITH_POSITION)
+        {
+            if (walkExpression(opPos + 2) == false)
+            {
+                return false;
+            }
+
+            opPos = m_expression.getNextOpCodePosition(opPos);
+        }
+
+        return true;
+    }
+
+    // The steps of a location path, or of a location path pattern.
+    bool
+    walkSteps(OpCodeMapPositionType     theStepPos)
+    {
+        while(m_expression.getOpCodeMapValue(theStepPos) != XPathExpression::eENDOP)
+        {
+            switch(m_expression.getOpCodeMapValue(theStepPos))
+            {
+            case XPathExpression::eOP_VARIABLE:
+            case XPathExpression::eOP_FUNCTION:
+            case XPathExpression::eOP_EXTFUNCTION:
+            case XPathExpression::eOP_GROUP:
+                // A filter expression, followed by its predicates.
+                if (walkExpression(theStepPos) == false)
+                {
+                    return false;
+                }
+
+                theStepPos = m_expression.getNextOpCodePosition(theStepPos);
+
+                if (walkPredicates(theStepPos) == false)
+                {
+                    return false;
+                }
+                break;
+
+            case XPathExpression::eMATCH_ANY_ANCESTOR_WITH_FUNCTION_CALL:
+                // This has no node test, and no predicates.
+                theStepPos = m_expression.getNextOpCodePosition(theStepPos);
+                break;
+
+            default:
+                {
+                    OpCodeMapPositionType   thePredicatePos =
+                        theStepPos + m_expression.getOpCodeMapValue(theStepPos + 2);
+
+                    if (walkPredicates(thePredicatePos) == false)
+                    {
+                        return false;
+                    }
+
+                    theStepPos = m_expression.getNextOpCodePosition(theStepPos);
+                }
+                break;
+            }
+        }
+
+        return true;
+    }
+
+    bool
+    walkPatterns(OpCodeMapPositionType  opPos)
+    {
+        while(m_expression.getOpCodeMapValue(opPos) == XPathExpression::eOP_LOCATIONPATHPATTERN)
+        {
+            if (walkSteps(opPos + 2) == false)
+            {
+                return false;
+            }
+
+            opPos = m_expression.getNextOpCodePosition(opPos);
+        }
+
+        return true;
+    }
+
+
+    // Data members...
+    const XPathExpression&  m_expression;
+
+    const int               m_keyID;
+
+    const int               m_documentID;
+
+    const int               m_formatNumberID;
+
+    const int               m_functionAvailableID;
+
+    const int               m_elementAvailableID;
+
+    const int               m_systemPropertyID;
+
+    bool                    m_usesDocument;
+
+    bool                    m_usesFormatNumber;
+};
+
+
+
+/**
+ * Append the signature of an xsl:key match or use expression.  The
+ * signature is the op map of the compiled expression, plus its tokens.
+ * The compiler replaces each prefix in the tokens with its namespace
+ * URI, and drops whitespace, so expressions which differ only in those
+ * have the same signature, and expressions with the same text have
+ * different signatures if their prefixes are bound to different
+ * namespaces.  An expression whose value might not depend only on the
+ * source document has no signature.
+ *
+ * @param theXPath The compiled expression
+ * @param theSignature The signature to append to
+ * @param fUsesDocument Set to true if the expression calls document()
+ * @param fUsesFormatNumber Set to true if the expression calls format-number()
+ * @return true if the expression has a signature, false if not.
+ */
+static bool
+appendKeySignature(
+            const XPath&        theXPath,
+            XalanDOMString&     theSignature,
+            bool&               fUsesDocument,
+            bool&               fUsesFormatNumber)
+{
+    const XPathExpression&  theExpression = theXPath.getExpression();
+
+    KeyExpressionWalker     theWalker(theExpression, theSignature.getMemoryManager());
+
+    if (theWalker.walk() == false)
+    {
+        return false;
+    }
+
+    if (theWalker.getUsesDocument() == true)
+    {
+        fUsesDocument = true;
+    }
+
+    if (theWalker.getUsesFormatNumber() == true)
+    {
+        fUsesFormatNumber = true;
+    }
+
+    const XPathExpression::OpCodeMapSizeType    theOpCodeMapLength =
+        theExpression.opCodeMapLength();
+
+    NumberToDOMString(XMLInt64(theOpCodeMapLength), theSignature);
+
+    theSignature.append(1, XalanUnicode::charColon);
+
+    for (XPathExpression::OpCodeMapSizeType i = 0; i < theOpCodeMapLength; ++i)
+    {
+        NumberToDOMString(XMLInt64(theExpression.getOpCodeMapValue(i)), theSignature);
+
+        theSignature.append(1, XalanUnicode::charComma);
+    }
+
+    const XPathExpression::TokenQueueSizeType   theTokenCount =
+        theExpression.tokenQueueSize();
+
+    for (XPathExpression::TokenQueueSizeType i = 0; i < theTokenCount; ++i)
+    {
+        const XalanDOMString&   theToken = theExpression.getToken(i)->str();
+
+        const XalanDOMString::size_type     theLength = theToken.length();
+
+        NumberToDOMString(XMLUInt64(theLength), theSignature);
+
+        theSignature.append(1, XalanUnicode::charColon);
+
+        // A literal keeps its quotes in the token queue, and its value
+        // is pushed again without them, so only the quotes are made
+        // the same.
+        if (theLength >= 2 &&
+            (theToken[0] == XalanUnicode::charApostrophe ||
+             theToken[0] == XalanUnicode::charQuoteMark) &&
+            theToken[theLength - 1] == theToken[0])
+        {
+            theSignature.append(1, XalanUnicode::charApostrophe);
+            theSignature.append(theToken, 1, theLength - 2);
+            theSignature.append(1, XalanUnicode::charApostrophe);
+        }
+        else
+        {
+            theSignature.append(theToken);
+        }
+    }
+
+    theSignature.append(1, XalanUnicode::charSemicolon);
+
+    return true;
+}
+
+
+
 void
 Stylesheet::processKeyElement(
             const PrefixResolver&           nsContext,
@@ -272,6 +667,14 @@ Stylesheet::processKeyElement(
     const XalanQName*       theQName = 0;
     XPath*                  matchAttr = 0;
     XPath*                  useAttr = 0;
+
+    const GetCachedString   theSignatureGuard(constructionContext);
+
+    XalanDOMString&     theSignature = theSignatureGuard.get();
+
+    bool    fShareable = true;
+    bool    fUsesDocument = false;
+    bool    fUsesFormatNumber = false;
  
     const XalanSize_t   nAttrs = atts.getLength();
 
@@ -311,16 +714,44 @@ Stylesheet::processKeyElement(
                         nsContext,
                         false,
                         false);
+
+            theSignature.append(1, XalanUnicode::charLetter_M);
+
+            if (appendKeySignature(
+                    *matchAttr,
+                    theSignature,
+                    fUsesDocument,
+                    fUsesFormatNumber) == false)
+            {
+                fShareable = false;
+            }
         }
         else if(equals(aname, Constants::ATTRNAME_USE))
         {
+            const GetCachedString   theGuard(constructionContext);
+
+            XalanDOMString&     theBuffer = theGuard.get();
+
+            theBuffer.assign(atts.getValue(i));
+
             useAttr =
                     constructionContext.createXPath(
                         0,
-                        atts.getValue(i),
+                        theBuffer,
                         nsContext,
                         false,
                         false);
+
+            theSignature.append(1, XalanUnicode::charLetter_U);
+
+            if (appendKeySignature(
+                    *useAttr,
+                    theSignature,
+                    fUsesDocument,
+                    fUsesFormatNumber) == false)
+            {
+                fShareable = false;
+            }
         }
         else if (isAttrOK(aname, atts, i, constructionContext) == false)
         {
@@ -363,6 +794,20 @@ Stylesheet::processKeyElement(
             Constants::ATTRNAME_USE.c_str());
     }
 
+    if (fShareable == true && fUsesDocument == true)
+    {
+        // A relative URI passed to document() is resolved against
+        // the base URI of the stylesheet.
+        const XalanDOMString&   theBaseURI = getCurrentIncludeBaseIdentifier();
+
+        theSignature.append(1, XalanUnicode::charLetter_B);
+
+        NumberToDOMString(XMLUInt64(theBaseURI.length()), theSignature);
+
+        theSignature.append(1, XalanUnicode::charColon);
+        theSignature.append(theBaseURI);
+    }
+
     m_keyDeclarations.push_back(
         KeyDeclaration(
             *theQName,
@@ -370,7 +815,9 @@ Stylesheet::processKeyElement(
             *useAttr,
             m_baseIdent,
             XalanLocator::getLineNumber(locator),
-            XalanLocator::getColumnNumber(locator)));
+            XalanLocator::getColumnNumber(locator),
+            fShareable == true ? &constructionContext.getPooledString(theSignature) : 0,
+            fUsesFormatNumber));
 }
 
 
@@ -624,6 +1071,26 @@ Stylesheet::postConstruction(StylesheetConstructionContext&     constructionCont
 
 
 
+void
+Stylesheet::buildTemplateIndex(MemoryManager&   theManager)
+{
+    assert(&theManager == &getMemoryManager());
+
+    if (m_templateIndex == 0)
+    {
+        XalanConstruct(theManager, m_templateIndex, theManager);
+    }
+
+    if (m_templateIndex->build(*this) == false)
+    {
+        XalanDestroy(theManager, *m_templateIndex);
+
+        m_templateIndex = 0;
+    }
+}
+
+
+
 bool
 Stylesheet::isAttrOK(
             const XalanDOMChar*             attrName,
@@ -1165,8 +1632,33 @@ Stylesheet::findTemplate(
     {
         return findTemplateInImports(executionContext, targetNode, targetNodeType, mode);
     }
+    else if (m_templateIndex != 0 &&
+             executionContext.getQuietConflictWarnings() == true)
+    {
+        return m_templateIndex->findTemplate(executionContext, targetNode, targetNodeType, mode);
+    }
     else
     {
+        if (m_templateIndex != 0)
+        {
+            // Search the stylesheet only if the index finds a conflict,
+            // so the conflict is reported.
+            bool    fConflict = false;
+
+            const ElemTemplate* const   theTemplate =
+                m_templateIndex->findTemplate(
+                    executionContext,
+                    targetNode,
+                    targetNodeType,
+                    mode,
+                    fConflict);
+
+            if (fConflict == false)
+            {
+                return theTemplate;
+            }
+        }
+
         const ElemTemplate*     bestMatchedRule = 0;
 
         if (executionContext.getQuietConflictWarnings() == true)
@@ -1665,6 +2157,68 @@ Stylesheet::getDecimalFormatSymbols(const XalanQName&   theQName) const
 
 
 
+static void
+appendSignatureString(
+            const XalanDOMString&   theString,
+            XalanDOMString&         theSignature)
+{
+    NumberToDOMString(XMLUInt64(theString.length()), theSignature);
+
+    theSignature.append(1, XalanUnicode::charColon);
+    theSignature.append(theString);
+}
+
+
+
+void
+Stylesheet::appendDecimalFormatSignature(XalanDOMString&    theSignature) const
+{
+    for (ElemDecimalFormatVectorType::size_type i = m_elemDecimalFormats.size(); i > 0; --i)
+    {
+        const ElemDecimalFormat* const  theCurrent =
+            m_elemDecimalFormats[i - 1];
+        assert(theCurrent != 0);
+
+        const XalanQName&   theQName = theCurrent->getQName();
+
+        const XalanDecimalFormatSymbols&    theSymbols =
+            theCurrent->getDecimalFormatSymbols();
+
+        theSignature.append(1, XalanUnicode::charLetter_D);
+
+        appendSignatureString(theQName.getNamespace(), theSignature);
+        appendSignatureString(theQName.getLocalPart(), theSignature);
+        appendSignatureString(theSymbols.getCurrencySymbol(), theSignature);
+        appendSignatureString(theSymbols.getInfinity(), theSignature);
+        appendSignatureString(theSymbols.getInternationalCurrencySymbol(), theSignature);
+        appendSignatureString(theSymbols.getNaN(), theSignature);
+
+        const XalanDOMChar  theChars[] =
+        {
+            theSymbols.getDecimalSeparator(),
+            theSymbols.getDigit(),
+            theSymbols.getGroupingSeparator(),
+            theSymbols.getMinusSign(),
+            theSymbols.getMonetaryDecimalSeparator(),
+            theSymbols.getPatternSeparator(),
+            theSymbols.getPercent(),
+            theSymbols.getPerMill(),
+            theSymbols.getZeroDigit()
+        };
+
+        theSignature.append(theChars, sizeof(theChars) / sizeof(theChars[0]));
+    }
+
+    for (StylesheetVectorType::size_type i = 0; i < m_importsSize; ++i)
+    {
+        m_imports[i]->appendDecimalFormatSignature(theSignature);
+    }
+
+    theSignature.append(1, XalanUnicode::charSemicolon);
+}
+
+
+
 const XalanDOMString*
 Stylesheet::getNamespaceForPrefix(const XalanDOMString&     prefix) const
 {
@@ -71,6 +71,7 @@ class StylesheetConstructionContext;
 class StylesheetRoot;
 class XalanMatchPatternData;
 class XalanQName;
+class XalanTemplateIndex;
 class XObject;
 class StylesheetExecutionContext;
 
@@ -471,6 +472,17 @@ public:
     const XalanDecimalFormatSymbols*
     getDecimalFormatSymbols(const XalanQName&   theQName) const;
 
+    /**
+     * Append a signature of the decimal formats declared by this
+     * stylesheet and its imports, in the order they're searched by
+     * getDecimalFormatSymbols().  Two stylesheets with the same
+     * signature format every number the same way.
+     *
+     * @param theSignature The string to append the signature to
+     */
+    void
+    appendDecimalFormatSignature(XalanDOMString&    theSignature) const;
+
     /**
      * Add an imported stylesheet.
      *
@@ -733,8 +745,23 @@ protected:
 
     static const XalanQNameByReference  s_emptyQName;
 
+    /**
+     * Build an index of the templates in this stylesheet and its
+     * imports, to use in findTemplate().  This must be called after
+     * postConstruction() has been called.
+     *
+     * @param theManager The MemoryManager instance for the index
+     */
+    void
+    buildTemplateIndex(MemoryManager&   theManager);
+
 private:    
 
+    friend class XalanVariableResolver;
+    friend class XalanProjectionAnalyzer;
+    friend class XalanStreamabilityAnalyzer;
+    friend class XalanTemplateIndex;
+
     // Not defined...
     Stylesheet(const Stylesheet&);
 
@@ -877,6 +904,12 @@ private:
 
     NamespacesHandler                       m_namespacesHandler;
 
+    /**
+     * An index of the templates in this stylesheet and its imports,
+     * if one has been built.
+     */
+    XalanTemplateIndex*                     m_templateIndex;
+
     static const XalanDOMString             s_emptyString;
 
     static const PatternTableVectorType     s_emptyTemplateList;
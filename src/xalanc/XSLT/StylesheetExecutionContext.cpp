@@ -44,6 +44,114 @@ StylesheetExecutionContext::~StylesheetExecutionContext()
 }
 
 
+
+bool
+StylesheetExecutionContext::preSerializedMarkup(
+            const XalanDOMChar*     /* markup */,
+            fl_size_type            /* length */)
+{
+    return false;
+}
+
+
+
+#if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
+const XObjectPtr
+StylesheetExecutionContext::createXResultTreeFrag(const XalanDOMString&     theText)
+{
+    beginCreateXResultTreeFrag(getCurrentNode());
+
+    if (theText.empty() == false)
+    {
+        characters(theText.c_str(), 0, theText.length());
+    }
+
+    return endCreateXResultTreeFrag();
+}
+#endif
+
+
+
+XalanDocumentFragment*
+StylesheetExecutionContext::createTextDocumentFragment(const XalanDOMString&    /* theText */)
+{
+    return 0;
+}
+
+
+
+bool
+StylesheetExecutionContext::isDefaultCollation() const
+{
+    return false;
+}
+
+
+
+void
+StylesheetExecutionContext::pushLocalVariable(
+            const XalanQName&           name,
+            int                         /* theSlot */,
+            const XObjectPtr            val,
+            const ElemTemplateElement*  element)
+{
+    pushVariable(name, val, element);
+}
+
+
+
+void
+StylesheetExecutionContext::pushLocalVariable(
+            const XalanQName&           name,
+            int                         /* theSlot */,
+            const ElemVariable*         var,
+            const ElemTemplateElement*  element)
+{
+    pushVariable(name, var, element);
+}
+
+
+
+const XObjectPtr
+StylesheetExecutionContext::getLocalParamVariable(
+            const XalanQName&   theName,
+            int                 /* theSlot */)
+{
+    return getParamVariable(theName);
+}
+
+
+
+#if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
+void
+StylesheetExecutionContext::createAndPushNodesToTransformList(
+            const NodeRefListBase*  nodeList,
+            XalanStreamingSource*   theSource)
+{
+    assert(theSource == 0);
+    (void) theSource; // unused if assert is disabled
+
+    createAndPushNodesToTransformList(nodeList);
+}
+
+
+
+XalanStreamingSource*
+StylesheetExecutionContext::getNodesToTransformSource() const
+{
+    return 0;
+}
+
+
+
+XalanStreamingSource*
+StylesheetExecutionContext::getStreamingSource() const
+{
+    return 0;
+}
+#endif
+
+
 #if defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
 void
 StylesheetExecutionContext::ParamsPushPop::doPush(
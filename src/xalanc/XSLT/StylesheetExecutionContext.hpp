@@ -82,6 +82,7 @@ class NodeRefListBase;
 class NodeSorter;
 class PrintWriter;
 class XalanQName;
+class XalanStreamingSource;
 class SelectionEvent;
 class Stylesheet;
 class StylesheetRoot;
@@ -699,6 +700,44 @@ public:
             const ElemVariable*         var,
             const ElemTemplateElement*  element) = 0;
 
+    /**
+     * Push a named local variable or param onto the variables stack,
+     * and bind it to the slot it was assigned in its template when the
+     * stylesheet was compiled.  The variable has already been evaluated.
+     * The default implementation ignores the slot and calls
+     * pushVariable().
+     *
+     * @param name    name of variable
+     * @param theSlot slot of the variable
+     * @param val     pointer to XObject value
+     * @param element element marker for variable
+     */
+    virtual void
+    pushLocalVariable(
+            const XalanQName&           name,
+            int                         theSlot,
+            const XObjectPtr            val,
+            const ElemTemplateElement*  element);
+
+    /**
+     * Push a named local variable or param onto the variables stack,
+     * and bind it to the slot it was assigned in its template when the
+     * stylesheet was compiled.  The variable will be evaluated when first
+     * referenced.  The default implementation ignores the slot and calls
+     * pushVariable().
+     *
+     * @param name    name of variable
+     * @param theSlot slot of the variable
+     * @param var     pointer to ElemVariable instance
+     * @param element element marker for variable
+     */
+    virtual void
+    pushLocalVariable(
+            const XalanQName&           name,
+            int                         theSlot,
+            const ElemVariable*         var,
+            const ElemTemplateElement*  element);
+
     /**
      * Push a context marker onto the stack to let us know when to stop
      * searching for a var.
@@ -829,6 +868,23 @@ public:
     virtual const XObjectPtr
     getParamVariable(const XalanQName&  theName) = 0;
 
+    /**
+     * Given the name of a template's param, and the slot the param was
+     * assigned in the template when the stylesheet was compiled, return
+     * the value passed for the param, and bind the param to the slot.
+     * The default implementation ignores the slot and calls
+     * getParamVariable().
+     *
+     * @param theName name of the param
+     * @param theSlot slot of the param
+     * @return An XObjectPtr instance.  Call XObjectPtr::null() on the instance
+     *         to determine if the param was found.
+     */
+    virtual const XObjectPtr
+    getLocalParamVariable(
+            const XalanQName&   theName,
+            int                 theSlot);
+
     /**
      * Push a frame marker for an element.
      *
@@ -1046,6 +1102,21 @@ public:
             fl_size_type            start,
             fl_size_type            length) = 0;
 
+    /**
+     * Send a run of pre-serialized markup to the result tree, if it
+     * can be written directly.  If not, nothing is sent, and the
+     * caller must generate the equivalent events.  The default
+     * implementation sends nothing.
+     *
+     * @param markup pointer to the markup
+     * @param length number of characters in the markup
+     * @return true if the markup was sent, false if not.
+     */
+    virtual bool
+    preSerializedMarkup(
+            const XalanDOMChar*     markup,
+            fl_size_type            length);
+
     /**
      * Called when a Comment is to be constructed.
      *
@@ -1144,6 +1215,44 @@ public:
             XalanNode*                  sourceNode) = 0;
 #endif
 
+#if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
+    /**
+     * Create a result tree fragment which holds only the specified text.
+     * The nodes of the fragment are not built unless they're needed.
+     * The default implementation builds the fragment and its text node
+     * right away.
+     *
+     * @param theText the text of the result tree fragment
+     * @return a pointer to the result tree fragment
+     */
+    virtual const XObjectPtr
+    createXResultTreeFrag(const XalanDOMString&     theText);
+#else
+    /**
+     * Create a result tree fragment which holds only the specified text.
+     * The nodes of the fragment are not built unless they're needed.
+     *
+     * @param theText the text of the result tree fragment
+     * @return a pointer to the result tree fragment
+     */
+    virtual const XObjectPtr
+    createXResultTreeFrag(const XalanDOMString&     theText) = 0;
+#endif
+
+    /**
+     * Create a document fragment which holds a single text node.  This
+     * builds the nodes of a result tree fragment which was created from
+     * its text, once they're needed.  The document fragment is destroyed
+     * with the result tree fragment.  The default implementation returns
+     * 0, since the default createXResultTreeFrag() builds the nodes
+     * itself.  A context which overrides one must override the other.
+     *
+     * @param theText the text of the node, which must not be empty
+     * @return a pointer to the document fragment
+     */
+    virtual XalanDocumentFragment*
+    createTextDocumentFragment(const XalanDOMString&    theText);
+
     /**
      * Output an object to the result tree by doing the right conversions.
      * This is public for access by extensions.
@@ -1695,6 +1804,17 @@ public:
             const XalanDOMChar*                 theLocale,
             XalanCollationServices::eCaseOrder  theCaseOrder = XalanCollationServices::eDefault) = 0;
 
+    /**
+     * Determine if collationCompare() uses the default collation,
+     * which orders strings by their UTF-16 code units, and ignores
+     * the locale and case order.  The default implementation returns
+     * false, so sorts always call collationCompare().
+     *
+     * @return true if the default collation is used
+     */
+    virtual bool
+    isDefaultCollation() const;
+
     /**
      * Create a PrintWriter for the provided stream.
      * 
@@ -1900,12 +2020,45 @@ public:
     virtual void 
     createAndPushNodesToTransformList(const NodeRefListBase* nodeList) = 0;
 
+    /**
+     * Push a list of nodes to transform, which may be delivered by a
+     * streaming source.  The default implementation pushes the list
+     * without a source.  A context which returns a streaming source
+     * from getStreamingSource() must override this.
+     *
+     * @param nodeList The list of nodes
+     * @param theSource The streaming source which delivers the nodes, if the list was returned by XalanStreamingSource::beginChildren()
+     */
+    virtual void 
+    createAndPushNodesToTransformList(
+            const NodeRefListBase*  nodeList,
+            XalanStreamingSource*   theSource);
+
     virtual XalanNode* 
     getNextNodeToTransform() = 0;
 
     virtual void 
     popNodesToTransformList() = 0;
 
+    /**
+     * Get the streaming source of the current list of nodes to
+     * transform.  The default implementation returns 0.
+     *
+     * @return the source, or 0 if the list is not streamed
+     */
+    virtual XalanStreamingSource*
+    getNodesToTransformSource() const;
+
+    /**
+     * Get the streaming source for the transformation, if the source
+     * document is being streamed.  The default implementation returns
+     * 0, so the source document is never streamed.
+     *
+     * @return the source, or 0 if the source document is not streamed
+     */
+    virtual XalanStreamingSource*
+    getStreamingSource() const;
+
     /**
      * Get a string that is cached on a stack
      * @returns a cached string
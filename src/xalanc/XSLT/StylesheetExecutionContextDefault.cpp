@@ -68,6 +68,7 @@
 #include "KeyTable.hpp"
 #include "StylesheetConstructionContextDefault.hpp"
 #include "StylesheetRoot.hpp"
+#include "XalanStreamingSource.hpp"
 #include "XSLTEngineImpl.hpp"
 #include "XSLTProcessorException.hpp"
 
@@ -122,6 +123,8 @@ StylesheetExecutionContextDefault::StylesheetExecutionContextDefault(
     m_paramsVector(theManager),
     m_matchPatternCache(theManager),
     m_keyTables(theManager),
+    m_keyIndexCacheDocument(0),
+    m_keyIndexCache(0),
     m_countersTable(theManager),
     m_sourceTreeResultTreeFactory(),
     m_mode(0),
@@ -147,6 +150,7 @@ StylesheetExecutionContextDefault::StylesheetExecutionContextDefault(
     m_elementInvokerStack(theManager),
     m_useAttributeSetIndexesStack(theManager),
     m_nodeSorter(theManager),
+    m_streamingSource(0),
 #else
     m_formatterToTextCache(theManager),
     m_formatterToSourceTreeCache(theManager),
@@ -154,7 +158,9 @@ StylesheetExecutionContextDefault::StylesheetExecutionContextDefault(
 #endif
     m_usePerInstanceDocumentFactory(false),
     m_escapeURLs(eEscapeURLsDefault),
-    m_omitMETATag(eOmitMETATagDefault)
+    m_omitMETATag(eOmitMETATagDefault),
+    m_parallelSortThreshold(NodeSorter::eDefaultParallelSortThreshold),
+    m_parallelSortThreadCount(0)
 {
     m_currentTemplateStack.push_back(0);
 }
@@ -184,6 +190,8 @@ StylesheetExecutionContextDefault::StylesheetExecutionContextDefault(
     m_paramsVector(theManager),
     m_matchPatternCache(theManager),
     m_keyTables(theManager),
+    m_keyIndexCacheDocument(0),
+    m_keyIndexCache(0),
     m_countersTable(theManager),
     m_sourceTreeResultTreeFactory(),
     m_mode(0),
@@ -209,6 +217,7 @@ StylesheetExecutionContextDefault::StylesheetExecutionContextDefault(
     m_elementInvokerStack(theManager),
     m_useAttributeSetIndexesStack(theManager),
     m_nodeSorter(theManager),
+    m_streamingSource(0),
 #else
     m_formatterToTextCache(theManager),
     m_formatterToSourceTreeCache(theManager),
@@ -216,7 +225,9 @@ StylesheetExecutionContextDefault::StylesheetExecutionContextDefault(
 #endif
     m_usePerInstanceDocumentFactory(false),
     m_escapeURLs(eEscapeURLsDefault),
-    m_omitMETATag(eOmitMETATagDefault)
+    m_omitMETATag(eOmitMETATagDefault),
+    m_parallelSortThreshold(NodeSorter::eDefaultParallelSortThreshold),
+    m_parallelSortThreadCount(0)
 {
     m_currentTemplateStack.push_back(0);
 }
@@ -725,6 +736,30 @@ StylesheetExecutionContextDefault::pushVariable(
 
 
 
+void
+StylesheetExecutionContextDefault::pushLocalVariable(
+            const XalanQName&           name,
+            int                         theSlot,
+            const XObjectPtr            val,
+            const ElemTemplateElement*  element)
+{
+    m_variablesStack.pushLocalVariable(name, theSlot, val, element);
+}
+
+
+
+void
+StylesheetExecutionContextDefault::pushLocalVariable(
+            const XalanQName&           name,
+            int                         theSlot,
+            const ElemVariable*         var,
+            const ElemTemplateElement*  element)
+{
+    m_variablesStack.pushLocalVariable(name, theSlot, var, element);
+}
+
+
+
 void
 StylesheetExecutionContextDefault::pushVariable(
             const XalanQName&           name,
@@ -876,6 +911,18 @@ StylesheetExecutionContextDefault::getParamVariable(const XalanQName&   theName)
 
 
 
+const XObjectPtr
+StylesheetExecutionContextDefault::getLocalParamVariable(
+            const XalanQName&   theName,
+            int                 theSlot)
+{
+    bool    fFound;
+
+    return m_variablesStack.getLocalParamVariable(theName, theSlot, *this, fFound);
+}
+
+
+
 void
 StylesheetExecutionContextDefault::pushElementFrame(const ElemTemplateElement*  elem)
 {
@@ -981,6 +1028,18 @@ StylesheetExecutionContextDefault::charactersRaw(
 
 
 
+bool
+StylesheetExecutionContextDefault::preSerializedMarkup(
+            const XalanDOMChar*     markup,
+            fl_size_type            length)
+{
+    assert(m_xsltProcessor != 0);
+
+    return m_xsltProcessor->preSerializedMarkup(markup, length);
+}
+
+
+
 void
 StylesheetExecutionContextDefault::comment(const XalanDOMChar*  data)
 {
@@ -1069,22 +1128,12 @@ StylesheetExecutionContextDefault::beginCreateXResultTreeFrag(XalanNode*    sour
 {
     assert(m_xsltProcessor != 0);
 
-    XalanSourceTreeDocument* const  theDocument = m_usePerInstanceDocumentFactory == true ?
-        m_documentAllocator.create(
-            eDefaultAttributeAllocatorBlockSize,
-            eDefaultAttributeNSAllocatorBlockSize,
-            eDefaultCommentAllocatorBlockSize,
-            eDefaultElementAllocatorBlockSize,
-            eDefaultElementNSAllocatorBlockSize,
-            eDefaultPIAllocatorBlockSize,
-            eDefaultTextAllocatorBlockSize,
-            eDefaultTextIWSAllocatorBlockSize) :
-        getSourceTreeFactory(getMemoryManager());
-    assert(theDocument != 0);
-
     XalanSourceTreeDocumentFragment* const  theDocumentFragment =
-        m_documentFragmentAllocator.create(*theDocument);
-    assert(theDocumentFragment != 0);
+        createDocumentFragment();
+
+    XalanSourceTreeDocument* const  theDocument =
+        static_cast<XalanSourceTreeDocument*>(theDocumentFragment->getOwnerDocument());
+    assert(theDocument != 0);
 
     FormatterToSourceTree* const    theFormatter = m_formatterToSourceTreeStack.get();
     assert(theFormatter != 0);
@@ -1143,22 +1192,12 @@ StylesheetExecutionContextDefault::createXResultTreeFrag(
 {
     assert(m_xsltProcessor != 0);
 
-    XalanSourceTreeDocument* const  theDocument = m_usePerInstanceDocumentFactory == true ?
-        m_documentAllocator.create(
-            eDefaultAttributeAllocatorBlockSize,
-            eDefaultAttributeNSAllocatorBlockSize,
-            eDefaultCommentAllocatorBlockSize,
-            eDefaultElementAllocatorBlockSize,
-            eDefaultElementNSAllocatorBlockSize,
-            eDefaultPIAllocatorBlockSize,
-            eDefaultTextAllocatorBlockSize,
-            eDefaultTextIWSAllocatorBlockSize) :
-        getSourceTreeFactory(getMemoryManager());
-    assert(theDocument != 0);
-
     XalanSourceTreeDocumentFragment* const  theDocumentFragment =
-        m_documentFragmentAllocator.create(*theDocument);
-    assert(theDocumentFragment != 0);
+        createDocumentFragment();
+
+    XalanSourceTreeDocument* const  theDocument =
+        static_cast<XalanSourceTreeDocument*>(theDocumentFragment->getOwnerDocument());
+    assert(theDocument != 0);
 
     GuardCachedObject<FormatterToSourceTreeCacheType>   theGuard(m_formatterToSourceTreeCache);
 
@@ -1192,6 +1231,75 @@ StylesheetExecutionContextDefault::createXResultTreeFrag(
 
 
 
+const XObjectPtr
+StylesheetExecutionContextDefault::createXResultTreeFrag(const XalanDOMString&  theText)
+{
+    XResultTreeFrag*    theXResultTreeFrag = 0;
+
+    if (theText.empty() == true)
+    {
+        // An empty fragment has no text node, so it can't be represented
+        // by the text alone.
+        theXResultTreeFrag =
+            m_xresultTreeFragAllocator.create(*createDocumentFragment());
+    }
+    else
+    {
+        theXResultTreeFrag = m_xresultTreeFragAllocator.create(theText);
+    }
+
+    theXResultTreeFrag->setExecutionContext(this);
+
+    return XObjectPtr(theXResultTreeFrag);
+}
+
+
+
+XalanDocumentFragment*
+StylesheetExecutionContextDefault::createTextDocumentFragment(const XalanDOMString&    theText)
+{
+    assert(theText.empty() == false);
+
+    XalanSourceTreeDocumentFragment* const  theDocumentFragment =
+        createDocumentFragment();
+
+    XalanSourceTreeDocument* const  theDocument =
+        static_cast<XalanSourceTreeDocument*>(theDocumentFragment->getOwnerDocument());
+    assert(theDocument != 0);
+
+    theDocumentFragment->appendChildNode(
+        theDocument->createTextNode(theText.c_str(), theText.length()));
+
+    return theDocumentFragment;
+}
+
+
+
+XalanSourceTreeDocumentFragment*
+StylesheetExecutionContextDefault::createDocumentFragment()
+{
+    XalanSourceTreeDocument* const  theDocument = m_usePerInstanceDocumentFactory == true ?
+        m_documentAllocator.create(
+            eDefaultAttributeAllocatorBlockSize,
+            eDefaultAttributeNSAllocatorBlockSize,
+            eDefaultCommentAllocatorBlockSize,
+            eDefaultElementAllocatorBlockSize,
+            eDefaultElementNSAllocatorBlockSize,
+            eDefaultPIAllocatorBlockSize,
+            eDefaultTextAllocatorBlockSize,
+            eDefaultTextIWSAllocatorBlockSize) :
+        getSourceTreeFactory(getMemoryManager());
+    assert(theDocument != 0);
+
+    XalanSourceTreeDocumentFragment* const  theDocumentFragment =
+        m_documentFragmentAllocator.create(*theDocument);
+    assert(theDocumentFragment != 0);
+
+    return theDocumentFragment;
+}
+
+
+
 void
 StylesheetExecutionContextDefault::outputToResultTree(
             const XObject&      xobj,
@@ -1330,6 +1438,14 @@ StylesheetExecutionContextDefault::returnXResultTreeFrag(XResultTreeFrag*   theX
         XalanDocumentFragment* const    theDocumentFragment =
             theXResultTreeFrag->release();
 
+        // An instance which holds only text has no document fragment.
+        if (theDocumentFragment == 0)
+        {
+            m_xresultTreeFragAllocator.destroy(theXResultTreeFrag);
+
+            return true;
+        }
+
         const KeyTablesTableType::iterator  i =
             m_keyTables.find(theDocumentFragment);
 
@@ -1502,6 +1618,9 @@ StylesheetExecutionContextDefault::returnFormatterToText(FormatterToText*   theF
 NodeSorter*
 StylesheetExecutionContextDefault::getNodeSorter()
 {
+    m_nodeSorter.setParallelSortThreshold(m_parallelSortThreshold);
+    m_nodeSorter.setParallelSortThreadCount(m_parallelSortThreadCount);
+
     return &m_nodeSorter;
 }
 #endif
@@ -1511,7 +1630,13 @@ StylesheetExecutionContextDefault::getNodeSorter()
 NodeSorter*
 StylesheetExecutionContextDefault::borrowNodeSorter()
 {
-    return m_nodeSorterCache.get();
+    NodeSorter* const   theSorter = m_nodeSorterCache.get();
+    assert(theSorter != 0);
+
+    theSorter->setParallelSortThreshold(m_parallelSortThreshold);
+    theSorter->setParallelSortThreadCount(m_parallelSortThreadCount);
+
+    return theSorter;
 }
 
 
@@ -1651,6 +1776,18 @@ StylesheetExecutionContextDefault::collationCompare(
 
 
 
+bool
+StylesheetExecutionContextDefault::isDefaultCollation() const
+{
+#if defined(XALAN_USE_WINDOWS_COLLATION)
+    return false;
+#else
+    return m_collationCompareFunctor == 0;
+#endif
+}
+
+
+
 StylesheetExecutionContextDefault::DefaultCollationCompareFunctor::DefaultCollationCompareFunctor()
 {
 }
@@ -1860,6 +1997,9 @@ StylesheetExecutionContextDefault::reset()
     m_stylesheetRoot = 0;
     m_mode = 0;
 
+    m_keyIndexCacheDocument = 0;
+    m_keyIndexCache = 0;
+
     m_currentTemplateStack.clear();
     m_currentTemplateStack.push_back(0);
 
@@ -1893,6 +2033,7 @@ StylesheetExecutionContextDefault::reset()
 
 #if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
     m_nodesToTransformStack.clear();
+    m_streamingSource = 0;
     m_processCurrentAttributeStack.clear();
     m_skipElementAttributesStack.clear();
     m_executeIfStack.clear();
@@ -1941,6 +2082,16 @@ StylesheetExecutionContextDefault::isNodeAfter(
 
 
 
+bool
+StylesheetExecutionContextDefault::getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const
+{
+    return m_xpathExecutionContextDefault.getNodeNumber(theNode, theNumber);
+}
+
+
+
 void
 StylesheetExecutionContextDefault::pushContextNodeList(const NodeRefListBase&   theContextNodeList)
 {
@@ -2141,7 +2292,9 @@ StylesheetExecutionContextDefault::getNodeSetByKey(
         nodelist,
         *this,
         locator,
-        m_keyTables);
+        m_keyTables,
+        m_keyIndexCacheDocument,
+        m_keyIndexCache);
 }
 
 
@@ -2173,7 +2326,9 @@ StylesheetExecutionContextDefault::getNodeSetByKey(
         nodelist,
         *this,
         locator,
-        m_keyTables);
+        m_keyTables,
+        m_keyIndexCacheDocument,
+        m_keyIndexCache);
 }
 
 
@@ -2213,6 +2368,56 @@ StylesheetExecutionContextDefault::getVariable(
 
 
 
+const XObjectPtr
+StylesheetExecutionContextDefault::getGlobalVariable(
+            const XalanQName&   name,
+            int                 theSlot,
+            const Locator*      locator)
+{
+    bool                fFound;
+
+    const XObjectPtr    theValue(m_variablesStack.getGlobalVariable(name, theSlot, *this, fFound));
+
+    if(fFound == true)
+    {
+        assert(theValue.null() == false);
+
+        return theValue;
+    }
+    else
+    {
+        // Fall back to a search by name, which reports the problem...
+        return getVariable(name, locator);
+    }
+}
+
+
+
+const XObjectPtr
+StylesheetExecutionContextDefault::getLocalVariable(
+            const XalanQName&   name,
+            int                 theSlot,
+            const Locator*      locator)
+{
+    bool                fFound;
+
+    const XObjectPtr    theValue(m_variablesStack.getLocalVariable(name, theSlot, *this, fFound));
+
+    if(fFound == true)
+    {
+        assert(theValue.null() == false);
+
+        return theValue;
+    }
+    else
+    {
+        // Fall back to a search by name, which reports the problem...
+        return getVariable(name, locator);
+    }
+}
+
+
+
 const PrefixResolver*
 StylesheetExecutionContextDefault::getPrefixResolver() const
 {
@@ -2922,11 +3127,21 @@ StylesheetExecutionContextDefault::releaseAndPopMutableNodeRefList()
 
 
 void
-StylesheetExecutionContextDefault::createAndPushNodesToTransformList(const NodeRefListBase* nodeList)
+StylesheetExecutionContextDefault::createAndPushNodesToTransformList(const NodeRefListBase*  nodeList)
+{
+    createAndPushNodesToTransformList(nodeList, 0);
+}
+
+
+
+void
+StylesheetExecutionContextDefault::createAndPushNodesToTransformList(
+            const NodeRefListBase*  nodeList,
+            XalanStreamingSource*   theSource)
 {
     assert(nodeList != 0);
 
-    NodesToTransform nodesToTransform(nodeList);
+    NodesToTransform nodesToTransform(nodeList, theSource);
     m_nodesToTransformStack.push_back(nodesToTransform);
 }
 
@@ -2937,7 +3152,18 @@ StylesheetExecutionContextDefault::getNextNodeToTransform()
 {
     assert(m_nodesToTransformStack.size() > 0);
 
-    return m_nodesToTransformStack.back().next();
+    NodesToTransform&   theNodesToTransform = m_nodesToTransformStack.back();
+
+    XalanStreamingSource* const     theSource = theNodesToTransform.source();
+
+    if (theSource != 0)
+    {
+        return theSource->nextNode(*theNodesToTransform());
+    }
+    else
+    {
+        return theNodesToTransform.next();
+    }
 }
 
 
@@ -2951,6 +3177,24 @@ StylesheetExecutionContextDefault::popNodesToTransformList()
 }
 
 
+
+XalanStreamingSource*
+StylesheetExecutionContextDefault::getNodesToTransformSource() const
+{
+    assert(m_nodesToTransformStack.size() > 0);
+
+    return m_nodesToTransformStack.back().source();
+}
+
+
+
+XalanStreamingSource*
+StylesheetExecutionContextDefault::getStreamingSource() const
+{
+    return m_streamingSource;
+}
+
+
 XalanDOMString  StylesheetExecutionContextDefault::FormatterToTextDOMString::s_dummyString(XalanMemMgrs::getDummyMemMgr());
 
 
@@ -2967,7 +3211,7 @@ StylesheetExecutionContextDefault::FormatterToTextDOMString::FormatterToTextDOMS
 
 StylesheetExecutionContextDefault::FormatterToTextDOMString::~FormatterToTextDOMString()
 {
-    assert(s_dummyString.capacity() == 0);
+    assert(s_dummyString.empty() == true);
 }
 #endif
 
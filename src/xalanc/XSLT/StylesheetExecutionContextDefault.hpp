@@ -76,7 +76,9 @@ namespace XALAN_CPP_NAMESPACE {
 
 
 
+class XalanKeyIndexCache;
 class XalanSourceTreeDocument;
+class XalanStreamingSource;
 class XPathProcessor;
 class XSLTEngineImpl;
 
@@ -210,6 +212,73 @@ public:
         m_usePerInstanceDocumentFactory = fValue;
     }
 
+    /**
+     * Get the minimum number of nodes for which the work of a sort
+     * is split between several threads.
+     *
+     * @return the threshold, or 0 if sorts are never split
+     */
+    XalanSize_t
+    getParallelSortThreshold() const
+    {
+        return m_parallelSortThreshold;
+    }
+
+    /**
+     * Set the minimum number of nodes for which the work of a sort
+     * is split between several threads.  See
+     * NodeSorter::setParallelSortThreshold().
+     *
+     * @param theThreshold the threshold, or 0 to never split sorts
+     */
+    void
+    setParallelSortThreshold(XalanSize_t    theThreshold)
+    {
+        m_parallelSortThreshold = theThreshold;
+    }
+
+    /**
+     * Get the maximum number of threads used for a sort, including
+     * the calling thread.
+     *
+     * @return the number of threads, or 0 to use every thread of the shared pool
+     */
+    unsigned int
+    getParallelSortThreadCount() const
+    {
+        return m_parallelSortThreadCount;
+    }
+
+    /**
+     * Set the maximum number of threads used for a sort, including
+     * the calling thread.
+     *
+     * @param theCount the number of threads, or 0 to use every thread of the shared pool
+     */
+    void
+    setParallelSortThreadCount(unsigned int     theCount)
+    {
+        m_parallelSortThreadCount = theCount;
+    }
+
+    /**
+     * Set a shared cache of xsl:key indexes for a source document.
+     * The cache will be used for keys looked up in that document
+     * instead of building an index for each transform.  The cache
+     * is cleared by reset().
+     *
+     * @param theDocument the document that the cache indexes
+     * @param theCache the cache to use, or 0 for none
+     */
+    void
+    setKeyIndexCache(
+            const XalanNode*        theDocument,
+            XalanKeyIndexCache*     theCache)
+    {
+        m_keyIndexCacheDocument = theDocument;
+        m_keyIndexCache = theCache;
+    }
+
 
     // These interfaces are inherited from StylesheetExecutionContext...
 
@@ -372,6 +441,20 @@ public:
             const ElemVariable*         var,
             const ElemTemplateElement*  element);
 
+    virtual void
+    pushLocalVariable(
+            const XalanQName&           name,
+            int                         theSlot,
+            const XObjectPtr            val,
+            const ElemTemplateElement*  element);
+
+    virtual void
+    pushLocalVariable(
+            const XalanQName&           name,
+            int                         theSlot,
+            const ElemVariable*         var,
+            const ElemTemplateElement*  element);
+
     virtual void
     pushVariable(
             const XalanQName&           name,
@@ -416,6 +499,11 @@ public:
     virtual const XObjectPtr
     getParamVariable(const XalanQName&  theName);
 
+    virtual const XObjectPtr
+    getLocalParamVariable(
+            const XalanQName&   theName,
+            int                 theSlot);
+
     virtual void
     pushElementFrame(const ElemTemplateElement*     elem);
 
@@ -458,6 +546,11 @@ public:
             fl_size_type            start,
             fl_size_type            length);
 
+    virtual bool
+    preSerializedMarkup(
+            const XalanDOMChar*     markup,
+            fl_size_type            length);
+
     virtual void
     comment(const XalanDOMChar*     data);
 
@@ -504,6 +597,12 @@ public:
             XalanNode*                  sourceNode);
 #endif
 
+    virtual const XObjectPtr
+    createXResultTreeFrag(const XalanDOMString&     theText);
+
+    virtual XalanDocumentFragment*
+    createTextDocumentFragment(const XalanDOMString&    theText);
+
     virtual void
     outputToResultTree(
             const XObject&      xobj,
@@ -667,6 +766,9 @@ public:
             const XalanDOMChar*                 theLocale,
             XalanCollationServices::eCaseOrder  theCaseOrder = XalanCollationServices::eDefault);
 
+    virtual bool
+    isDefaultCollation() const;
+
     typedef XalanCollationServices::CollationCompareFunctor     CollationCompareFunctor;
 
     class XALAN_XSLT_EXPORT DefaultCollationCompareFunctor : public CollationCompareFunctor
@@ -793,6 +895,11 @@ public:
             const XalanNode&    node1,
             const XalanNode&    node2) const;
 
+    virtual bool
+    getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const;
+
     virtual void
     pushContextNodeList(const NodeRefListBase&  theList);
 
@@ -880,7 +987,12 @@ public:
     popXObjectPtr();
 
     virtual void
-    createAndPushNodesToTransformList(const NodeRefListBase* nodeList);
+    createAndPushNodesToTransformList(const NodeRefListBase*    nodeList);
+
+    virtual void
+    createAndPushNodesToTransformList(
+            const NodeRefListBase*  nodeList,
+            XalanStreamingSource*   theSource);
 
     virtual XalanNode* 
     getNextNodeToTransform();
@@ -888,6 +1000,24 @@ public:
     virtual void 
     popNodesToTransformList();
 
+    virtual XalanStreamingSource*
+    getNodesToTransformSource() const;
+
+    virtual XalanStreamingSource*
+    getStreamingSource() const;
+
+    /**
+     * Set the streaming source for the transformation.  The source
+     * must be for the document being transformed.
+     *
+     * @param theSource The source, or 0 if the source document is not streamed
+     */
+    void
+    setStreamingSource(XalanStreamingSource*    theSource)
+    {
+        m_streamingSource = theSource;
+    }
+
     virtual XalanDOMString&
     getAndPushCachedString();
 
@@ -926,6 +1056,18 @@ public:
             const XalanQName&   name,
             const Locator*      locator = 0);
 
+    virtual const XObjectPtr
+    getGlobalVariable(
+            const XalanQName&   name,
+            int                 theSlot,
+            const Locator*      locator = 0);
+
+    virtual const XObjectPtr
+    getLocalVariable(
+            const XalanQName&   name,
+            int                 theSlot,
+            const Locator*      locator = 0);
+
     virtual const PrefixResolver*
     getPrefixResolver() const;
 
@@ -1009,6 +1151,14 @@ private:
     const XalanDecimalFormatSymbols*
     getDecimalFormatSymbols(const XalanQName&   qname);
 
+    /**
+     * Create an empty document fragment for a result tree fragment.
+     *
+     * @return the new document fragment
+     */
+    XalanSourceTreeDocumentFragment*
+    createDocumentFragment();
+
 #if defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
     /**
      * Given a context, create the params for a template
@@ -1102,6 +1252,10 @@ private:
 
     KeyTablesTableType                  m_keyTables;
 
+    const XalanNode*                    m_keyIndexCacheDocument;
+
+    XalanKeyIndexCache*                 m_keyIndexCache;
+
     CountersTable                       m_countersTable;
 
     /**
@@ -1196,8 +1350,10 @@ private:
     class NodesToTransform
     {
     public:
-        NodesToTransform(const NodeRefListBase* nodeList) : 
-            m_nodeList(nodeList), m_index(0)
+        NodesToTransform(
+                    const NodeRefListBase*  nodeList,
+                    XalanStreamingSource*   theSource = 0) : 
+            m_nodeList(nodeList), m_index(0), m_source(theSource)
         {
             assert(m_nodeList != 0);
         }
@@ -1221,9 +1377,15 @@ private:
             return 0;
         }
 
+        XalanStreamingSource* source() const
+        {
+            return m_source;
+        }
+
     private:
         const NodeRefListBase*  m_nodeList;
         NodeRefListBase::size_type  m_index;
+        XalanStreamingSource*   m_source;
     };
 
     typedef XalanVector<NodesToTransform>           NodesToTransformStackType;
@@ -1242,6 +1404,10 @@ private:
     UseAttributeSetIndexesStackType     m_useAttributeSetIndexesStack;
 
     NodeSorter                          m_nodeSorter;
+
+    // The source of the document being transformed, if it
+    // is being streamed.
+    XalanStreamingSource*               m_streamingSource;
 #endif
 
     // If true, we will use a separate document factory for
@@ -1254,6 +1420,11 @@ private:
     // Determines whether or not to override the property in the stylesheet.
     eOmitMETATag                        m_omitMETATag;
 
+    // The settings for the node sorters.
+    XalanSize_t                         m_parallelSortThreshold;
+
+    unsigned int                        m_parallelSortThreadCount;
+
     static XalanNumberFormatFactory     s_defaultXalanNumberFormatFactory;
 
     static XalanNumberFormatFactory*    s_xalanNumberFormatFactory;
@@ -31,9 +31,11 @@
 
 
 #include <xalanc/PlatformSupport/AttributeListImpl.hpp>
+#include <xalanc/PlatformSupport/DOMStringHelper.hpp>
 #include <xalanc/PlatformSupport/PrintWriter.hpp>
 #include <xalanc/PlatformSupport/StringTokenizer.hpp>
 #include <xalanc/PlatformSupport/XalanMessageLoader.hpp>
+#include <xalanc/PlatformSupport/XalanUnicode.hpp>
 
 
 
@@ -63,6 +65,9 @@
 #include "StylesheetExecutionContext.hpp"
 #include "TraceListener.hpp"
 #include "XSLTResultTarget.hpp"
+#include "XalanVariableResolver.hpp"
+#include "XalanProjectionAnalyzer.hpp"
+#include "XalanStreamabilityAnalyzer.hpp"
 
 
 
@@ -105,7 +110,11 @@ StylesheetRoot::StylesheetRoot(
     m_omitMETATag(false),
     m_elemNumberNextID(0),
     m_attributeSetsMap(constructionContext.getMemoryManager()),
-    m_hasStripOrPreserveSpace(false)
+    m_hasStripOrPreserveSpace(false),
+    m_isStreamable(false),
+    m_sourceProjection(constructionContext.getMemoryManager()),
+    m_isProjectable(false),
+    m_globalValueCache(constructionContext.getMemoryManager())
 {
     // Our base class has already resolved the URI and pushed it on
     // the back of the include stack, so get it from there...
@@ -199,6 +208,22 @@ StylesheetRoot::postConstruction(StylesheetConstructionContext&     construction
     }
 
     m_hasStripOrPreserveSpace = m_whitespaceElements.empty() == false;
+
+    completeKeySignatures(constructionContext);
+
+    buildTemplateIndex(constructionContext.getMemoryManager());
+
+    XalanVariableResolver   theVariableResolver(constructionContext.getMemoryManager());
+
+    theVariableResolver.resolve(*this);
+
+    XalanStreamabilityAnalyzer  theAnalyzer(constructionContext.getMemoryManager());
+
+    m_isStreamable = theAnalyzer.analyze(*this);
+
+    XalanProjectionAnalyzer     theProjectionAnalyzer(constructionContext.getMemoryManager());
+
+    m_isProjectable = theProjectionAnalyzer.analyze(*this, m_sourceProjection);
 }
 
 
@@ -317,6 +342,7 @@ StylesheetRoot::setupFormatterListener(
     else if (0 != outputTarget.getCharacterStream() ||
              0 != outputTarget.getByteStream() ||
              0 != outputTarget.getStream() ||
+             0 != outputTarget.getOutputStream() ||
              !outputTarget.getFileName().empty())
     {
         /*
@@ -338,6 +364,10 @@ StylesheetRoot::setupFormatterListener(
             {
                 pw = executionContext.createPrintWriter(outputTarget.getStream());
             }
+            else if (0 != outputTarget.getOutputStream())
+            {
+                pw = executionContext.createPrintWriter(outputTarget.getOutputStream());
+            }
             else if (!outputTarget.getFileName().empty())
             {
                 const GetCachedString   theGuard(executionContext);
@@ -509,7 +539,7 @@ StylesheetRoot::processOutputSpec(
             }
             else
             {
-                const StylesheetConstructionContext::GetCachedString    theGuard(constructionContext);
+                const GetCachedString   theGuard(constructionContext);
 
                 constructionContext.problem(
                     StylesheetConstructionContext::eXSLTProcessor,
@@ -569,7 +599,7 @@ StylesheetRoot::processOutputSpec(
 
                 m_cdataSectionElems.reserve(m_cdataSectionElems.size() + theTokenCount);
 
-                const StylesheetConstructionContext::GetCachedString    theGuard(constructionContext);
+                const GetCachedString   theGuard(constructionContext);
 
                 XalanDOMString& theToken = theGuard.get();
 
@@ -611,7 +641,7 @@ StylesheetRoot::processOutputSpec(
                 }
                 else
                 {
-                    const StylesheetConstructionContext::GetCachedString    theGuard(constructionContext);
+                    const GetCachedString   theGuard(constructionContext);
 
                     constructionContext.problem(
                         StylesheetConstructionContext::eXSLTProcessor,
@@ -626,7 +656,7 @@ StylesheetRoot::processOutputSpec(
             }
             else if (isAttrOK(aname, atts, i, constructionContext) == false)
             {
-                const StylesheetConstructionContext::GetCachedString    theGuard(constructionContext);
+                const GetCachedString   theGuard(constructionContext);
 
                 constructionContext.problem(
                     StylesheetConstructionContext::eXSLTProcessor,
@@ -823,7 +853,9 @@ StylesheetRoot::getNodeSetByKey(
             MutableNodeRefList&             nodelist,
             StylesheetExecutionContext&     executionContext,
             const Locator*                  locator,
-            KeyTablesTableType&             theKeysTable) const
+            KeyTablesTableType&             theKeysTable,
+            const XalanNode*                theCachedDocument,
+            XalanKeyIndexCache*             theKeyIndexCache) const
 {
     assert(
         nodelist.empty() == true ||
@@ -842,7 +874,7 @@ StylesheetRoot::getNodeSetByKey(
 
         if (i != theKeysTable.end())
         {
-            nl = i->second->getNodeSetByKey(qname, ref);
+            nl = i->second->getNodeSetByKey(qname, ref, resolver, executionContext);
         }
         else
         {
@@ -851,15 +883,14 @@ StylesheetRoot::getNodeSetByKey(
                         KeyTable::create(
                             executionContext.getMemoryManager(),
                              theKeyNode,
-                             resolver,
                              m_keyDeclarations,
-                             executionContext));
+                             theKeyNode == theCachedDocument ? theKeyIndexCache : 0));
 
             theKeysTable[theKeyNode] = kt.get();
 
-            const KeyTable* const   theNewTable = kt.releasePtr();
+            KeyTable* const     theNewTable = kt.releasePtr();
 
-            nl = theNewTable->getNodeSetByKey(qname, ref);
+            nl = theNewTable->getNodeSetByKey(qname, ref, resolver, executionContext);
         }
     }
 
@@ -892,6 +923,89 @@ StylesheetRoot::getNodeSetByKey(
 
 
 
+static void
+appendSignatureString(
+            const XalanDOMString*   theString,
+            XalanDOMString&         theSignature)
+{
+    if (theString == 0)
+    {
+        theSignature.append(1, XalanUnicode::charHyphenMinus);
+    }
+    else
+    {
+        NumberToDOMString(XMLUInt64(theString->length()), theSignature);
+
+        theSignature.append(1, XalanUnicode::charColon);
+        theSignature.append(*theString);
+    }
+}
+
+
+
+void
+StylesheetRoot::completeKeySignatures(StylesheetConstructionContext&    constructionContext)
+{
+    const StylesheetConstructionContext::GetCachedString    theContextGuard(constructionContext);
+
+    // The whitespace rules decide which text nodes the match and use
+    // expressions see.  They're kept in the order they're tested.
+    XalanDOMString&     theContextSignature = theContextGuard.get();
+
+    for (WhitespaceElementsVectorType::size_type i = 0; i < m_whitespaceElements.size(); ++i)
+    {
+        const XalanSpaceNodeTester&     theTester = m_whitespaceElements[i];
+
+        theContextSignature.append(
+            1,
+            theTester.getType() == XalanSpaceNodeTester::eStrip ?
+                XalanUnicode::charLetter_S :
+                XalanUnicode::charLetter_P);
+
+        appendSignatureString(theTester.getTargetNamespace(), theContextSignature);
+        appendSignatureString(theTester.getTargetLocalName(), theContextSignature);
+    }
+
+    theContextSignature.append(1, XalanUnicode::charSemicolon);
+
+    const StylesheetConstructionContext::GetCachedString    theDecimalFormatsGuard(constructionContext);
+
+    XalanDOMString&     theDecimalFormatsSignature = theDecimalFormatsGuard.get();
+
+    const StylesheetConstructionContext::GetCachedString    theSignatureGuard(constructionContext);
+
+    XalanDOMString&     theSignature = theSignatureGuard.get();
+
+    for (KeyDeclarationVectorType::size_type i = 0; i < m_keyDeclarations.size(); ++i)
+    {
+        KeyDeclaration&     theDeclaration = m_keyDeclarations[i];
+
+        const XalanDOMString* const     theDeclarationSignature =
+            theDeclaration.getSignature();
+
+        if (theDeclarationSignature != 0)
+        {
+            theSignature = theContextSignature;
+
+            if (theDeclaration.getUsesDecimalFormats() == true)
+            {
+                if (theDecimalFormatsSignature.empty() == true)
+                {
+                    appendDecimalFormatSignature(theDecimalFormatsSignature);
+                }
+
+                theSignature.append(theDecimalFormatsSignature);
+            }
+
+            theSignature.append(*theDeclarationSignature);
+
+            theDeclaration.setSignature(&constructionContext.getPooledString(theSignature));
+        }
+    }
+}
+
+
+
 bool
 StylesheetRoot::internalShouldStripSourceNode(const XalanText&  textNode) const
 {
@@ -26,6 +26,7 @@
 
 
 #include "Stylesheet.hpp"
+#include "XalanGlobalValueCache.hpp"
 
 
 
@@ -42,12 +43,17 @@
 
 
 
+#include <xalanc/XalanSourceTree/XalanSourceTreeProjection.hpp>
+
+
+
 namespace XALAN_CPP_NAMESPACE {
 
 
 
 class ElemAttributeSet;
 class StylesheetConstructionContext;
+class XalanKeyIndexCache;
 class XalanText;
 class XSLTResultTarget;
 
@@ -393,6 +399,8 @@ public:
      * @param nodelist         A node list to contain the nodes found
      * @param executionContext The current execution context
      * @param theKeysTable     The table of keys to search.
+     * @param theCachedDocument The document indexed by theKeyIndexCache
+     * @param theKeyIndexCache A shared cache of indexes for theCachedDocument, if any
      */
     void
     getNodeSetByKey(
@@ -403,7 +411,9 @@ public:
             MutableNodeRefList&             nodelist,
             StylesheetExecutionContext&     executionContext,
             const Locator*                  locator,
-            KeyTablesTableType&             theKeysTable) const;
+            KeyTablesTableType&             theKeysTable,
+            const XalanNode*                theCachedDocument = 0,
+            XalanKeyIndexCache*             theKeyIndexCache = 0) const;
 
     unsigned long
     getNextElemNumberID()
@@ -443,6 +453,44 @@ public:
 
     void
     addAttributeSet(ElemAttributeSet&   theAttributeSet);
+
+    /**
+     * Determine if the stylesheet can transform a source document
+     * while the document is being parsed.  This is only valid after
+     * postConstruction() has been called.
+     *
+     * @return true if the stylesheet is streamable
+     */
+    bool
+    isStreamable() const
+    {
+        return m_isStreamable;
+    }
+
+    /**
+     * Get the projection of source documents for the stylesheet,
+     * which holds the elements that the stylesheet can reach.  This
+     * is only valid after postConstruction() has been called.
+     *
+     * @return The projection, or 0 if the stylesheet might reach any node
+     */
+    const XalanSourceTreeProjection*
+    getSourceProjection() const
+    {
+        return m_isProjectable == true ? &m_sourceProjection : 0;
+    }
+
+    /**
+     * Get the cache of global variable values which depend only on the
+     * stylesheet, and are shared by every transformation.
+     *
+     * @return The cache
+     */
+    const XalanGlobalValueCache&
+    getGlobalValueCache() const
+    {
+        return m_globalValueCache;
+    }
     
 #if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
     /**
@@ -471,6 +519,10 @@ public:
 
 private:
 
+    friend class XalanVariableResolver;
+    friend class XalanProjectionAnalyzer;
+    friend class XalanStreamabilityAnalyzer;
+
     /**
      * Choose the encoding to use.
      *
@@ -489,6 +541,16 @@ private:
     void 
     initDefaultRule(StylesheetConstructionContext&  constructionContext);
 
+    /**
+     * Add the whitespace rules, and the decimal formats if they're used,
+     * to the signatures of the key declarations, so that an index is only
+     * shared by stylesheets which build it the same way.
+     *
+     * @param constructionContext context for construction of object
+     */
+    void
+    completeKeySignatures(StylesheetConstructionContext&    constructionContext);
+
     /**
      * Check to see if a whitespace text node should be stripped from
      * the source tree.
@@ -631,6 +693,28 @@ private:
      */
     bool                        m_hasStripOrPreserveSpace;
 
+    /**
+     * true if the stylesheet can process a source document while
+     * it's being parsed.
+     */
+    bool                        m_isStreamable;
+
+    /**
+     * The elements of a source document that the stylesheet can reach.
+     */
+    XalanSourceTreeProjection   m_sourceProjection;
+
+    /**
+     * true if m_sourceProjection holds everything the stylesheet can
+     * reach.
+     */
+    bool                        m_isProjectable;
+
+    /**
+     * The values of the global variables which depend only on the
+     * stylesheet.
+     */
+    XalanGlobalValueCache       m_globalValueCache;
 
     // Not implemented...
     StylesheetRoot(const StylesheetRoot&);
@@ -46,6 +46,9 @@ VariablesStack::VariablesStack(MemoryManager& theManager) :
     m_globalStackFrameMarked(false),
     m_currentStackFrameIndex(0),
     m_guardStack(theManager),
+    m_globalSlots(theManager),
+    m_localSlots(theManager),
+    m_localSlotBases(theManager),
     m_elementFrameStack(theManager)
 {
     m_stack.reserve(eDefaultStackSize);
@@ -69,6 +72,9 @@ VariablesStack::reset()
 
     m_stack.clear();
     m_guardStack.clear();
+    m_globalSlots.clear();
+    m_localSlots.clear();
+    m_localSlotBases.clear();
     m_elementFrameStack.clear();
 
     m_globalStackFrameMarked = false;
@@ -160,6 +166,11 @@ VariablesStack::push(const StackEntry&  theEntry)
 
     m_stack.push_back(theEntry);
 
+    if (theEntry.getType() == StackEntry::eContextMarker)
+    {
+        m_localSlotBases.push_back(m_localSlots.size());
+    }
+
     // Increment the global stack frame index as long as we're pushing variables, and
     // it already hasn't been marked.  This is a temporary work-around for problems
     // with evaluating top-level variables as they're pushed, rather than as they're
@@ -182,6 +193,19 @@ VariablesStack::pop()
         --m_currentStackFrameIndex;
     }
 
+    if (m_stack.back().getType() == StackEntry::eContextMarker)
+    {
+        assert(m_localSlotBases.empty() == false);
+
+        m_localSlots.resize(m_localSlotBases.back(), 0);
+
+        m_localSlotBases.pop_back();
+    }
+    else if (m_stack.back().getSlot() != -1)
+    {
+        unbindLocalSlot(m_stack.size() - 1);
+    }
+
     m_stack.pop_back();
 }
 
@@ -279,6 +303,34 @@ VariablesStack::pushVariable(
 
 
 
+void
+VariablesStack::pushLocalVariable(
+            const XalanQName&           name,
+            int                         theSlot,
+            const ElemVariable*         var,
+            const ElemTemplateElement*  e)
+{
+    pushVariable(name, var, e);
+
+    bindLocalSlot(theSlot, size_type(m_stack.size() - 1));
+}
+
+
+
+void
+VariablesStack::pushLocalVariable(
+            const XalanQName&           name,
+            int                         theSlot,
+            const XObjectPtr&           val,
+            const ElemTemplateElement*  e)
+{
+    pushVariable(name, val, e);
+
+    bindLocalSlot(theSlot, size_type(m_stack.size() - 1));
+}
+
+
+
 void
 VariablesStack::start()
 {
@@ -332,6 +384,8 @@ VariablesStack::unmarkGlobalStackFrame()
     m_globalStackFrameIndex = ~0u;
 
     m_globalStackFrameMarked = false;
+
+    m_globalSlots.clear();
 }
 
 
@@ -344,8 +398,6 @@ VariablesStack::findXObject(
             bool                            fSearchGlobalSpace,
             bool&                           fNameFound)
 {
-    typedef VariableStackStackType::size_type   size_type;
-
     // findEntry() returns an index into the stack.  We should
     // _never_ take the address of anything in the stack, since
     // the address could change at unexpected times.
@@ -360,76 +412,188 @@ VariablesStack::findXObject(
     }
     else
     {
-        assert(theEntryIndex < m_stack.size());
-
         fNameFound = true;
 
-        assert(m_stack[theEntryIndex].getType() == StackEntry::eVariable ||
-               m_stack[theEntryIndex].getType() == StackEntry::eParam ||
-               m_stack[theEntryIndex].getType() == StackEntry::eActiveParam);
+        return getEntryValue(theEntryIndex, executionContext);
+    }
+}
+
 
-        const XObjectPtr&   theValue = m_stack[theEntryIndex].getValue();
 
-        if (theValue.null() == false)
+const XObjectPtr
+VariablesStack::getGlobalVariable(
+            const XalanQName&               qname,
+            int                             theSlot,
+            StylesheetExecutionContext&     executionContext,
+            bool&                           fNameFound)
+{
+    assert(theSlot >= 0);
+
+    if (m_globalStackFrameMarked == false)
+    {
+        // The global variables are still being pushed, so a
+        // stack index found now might be shadowed later.
+        return findXObject(qname, executionContext, false, true, fNameFound);
+    }
+
+    if (GlobalSlotVectorType::size_type(theSlot) >= m_globalSlots.size())
+    {
+        m_globalSlots.resize(theSlot + 1, 0);
+    }
+
+    // The context marker at the bottom of the stack is never a
+    // variable, so 0 means the slot has not been looked up yet.
+    size_type   theEntryIndex = m_globalSlots[theSlot];
+
+    if (theEntryIndex == 0)
+    {
+        theEntryIndex = findGlobalEntry(qname);
+
+        if (theEntryIndex == m_stack.size())
         {
-            return theValue;
+            fNameFound = false;
+
+            return XObjectPtr();
         }
-        else
+
+        m_globalSlots[theSlot] = theEntryIndex;
+    }
+
+    assert(theEntryIndex < m_globalStackFrameIndex);
+    assert(m_stack[theEntryIndex].getName()->equals(qname));
+
+    fNameFound = true;
+
+    return getEntryValue(theEntryIndex, executionContext);
+}
+
+
+
+const XObjectPtr
+VariablesStack::getLocalVariable(
+            const XalanQName&               qname,
+            int                             theSlot,
+            StylesheetExecutionContext&     executionContext,
+            bool&                           fNameFound)
+{
+    const size_type     theEntryIndex = findLocalEntry(qname, theSlot);
+
+    if (theEntryIndex == m_stack.size())
+    {
+        return findXObject(qname, executionContext, false, true, fNameFound);
+    }
+    else
+    {
+        fNameFound = true;
+
+        return getEntryValue(theEntryIndex, executionContext);
+    }
+}
+
+
+
+const XObjectPtr
+VariablesStack::getLocalParamVariable(
+            const XalanQName&               qname,
+            int                             theSlot,
+            StylesheetExecutionContext&     executionContext,
+            bool&                           fNameFound)
+{
+    size_type   theEntryIndex = findLocalEntry(qname, theSlot);
+
+    if (theEntryIndex == m_stack.size())
+    {
+        theEntryIndex = findEntry(qname, true, false);
+
+        if (theEntryIndex == m_stack.size())
         {
-            const ElemVariable* const   var = m_stack[theEntryIndex].getVariable();
+            fNameFound = false;
+
+            return XObjectPtr();
+        }
 
-            XObjectPtr                  theNewValue;
+        bindLocalSlot(theSlot, theEntryIndex);
+    }
 
-            if (var != 0)
-            {
-                XalanNode* const    doc = executionContext.getRootDocument();
-                assert(doc != 0);
+    fNameFound = true;
 
-                using std::find;
+    return getEntryValue(theEntryIndex, executionContext);
+}
 
-                // See if the ElemVariable instance is already being evaluated...
-                if (find(m_guardStack.begin(), m_guardStack.end(), var) != m_guardStack.end())
-                {
-                    const StylesheetExecutionContext::GetCachedString   theGuard(executionContext);
-
-                    executionContext.problem(
-                        StylesheetExecutionContext::eXSLTProcessor,
-                        StylesheetExecutionContext::eError,
-                        XalanMessageLoader::getMessage(
-                            theGuard.get(),
-                            XalanMessages::CircularVariableDefWasDetected),
-                        var->getLocator(),
-                        doc);
-                }
 
-                m_guardStack.push_back(var);
+
+const XObjectPtr
+VariablesStack::getEntryValue(
+            size_type                       theEntryIndex,
+            StylesheetExecutionContext&     executionContext)
+{
+    assert(theEntryIndex < m_stack.size());
+
+    assert(m_stack[theEntryIndex].getType() == StackEntry::eVariable ||
+           m_stack[theEntryIndex].getType() == StackEntry::eParam ||
+           m_stack[theEntryIndex].getType() == StackEntry::eActiveParam);
+
+    const XObjectPtr&   theValue = m_stack[theEntryIndex].getValue();
+
+    if (theValue.null() == false)
+    {
+        return theValue;
+    }
+    else
+    {
+        const ElemVariable* const   var = m_stack[theEntryIndex].getVariable();
+
+        XObjectPtr                  theNewValue;
+
+        if (var != 0)
+        {
+            XalanNode* const    doc = executionContext.getRootDocument();
+            assert(doc != 0);
+
+            using std::find;
+
+            // See if the ElemVariable instance is already being evaluated...
+            if (find(m_guardStack.begin(), m_guardStack.end(), var) != m_guardStack.end())
+            {
+                const StylesheetExecutionContext::GetCachedString   theGuard(executionContext);
+
+                executionContext.problem(
+                    StylesheetExecutionContext::eXSLTProcessor,
+                    StylesheetExecutionContext::eError,
+                    XalanMessageLoader::getMessage(
+                        theGuard.get(),
+                        XalanMessages::CircularVariableDefWasDetected),
+                    var->getLocator(),
+                    doc);
+            }
+
+            m_guardStack.push_back(var);
 
 #if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
-                executionContext.pushContextMarker();
+            executionContext.pushContextMarker();
 #else
-                // We need to set up a stack frame for the variable's execution...
-                typedef StylesheetExecutionContext::PushAndPopContextMarker PushAndPopContextMarker;
+            // We need to set up a stack frame for the variable's execution...
+            typedef StylesheetExecutionContext::PushAndPopContextMarker PushAndPopContextMarker;
 
-                const PushAndPopContextMarker   theContextMarkerPushPop(executionContext);
+            const PushAndPopContextMarker   theContextMarkerPushPop(executionContext);
 #endif
 
-                theNewValue = var->getValue(executionContext, doc);
-                assert(theNewValue.null() == false);
+            theNewValue = var->getValue(executionContext, doc);
+            assert(theNewValue.null() == false);
 
 #if !defined(XALAN_RECURSIVE_STYLESHEET_EXECUTION)
-                executionContext.popContextMarker();
+            executionContext.popContextMarker();
 #endif
 
-                assert(m_guardStack.empty() == false);
-
-                m_guardStack.pop_back();
+            assert(m_guardStack.empty() == false);
 
-                m_stack[theEntryIndex].setValue(theNewValue);
-                m_stack[theEntryIndex].activate();
-            }
+            m_guardStack.pop_back();
 
-            return theNewValue;
+            m_stack[theEntryIndex].setValue(theNewValue);
+            m_stack[theEntryIndex].activate();
         }
+
+        return theNewValue;
     }
 }
 
@@ -486,12 +650,25 @@ VariablesStack::findEntry(
         }
     }
 
-    if(theEntryIndex == m_stack.size() && fIsParam == false && true == fSearchGlobalSpace && m_globalStackFrameIndex > 1)
+    if(theEntryIndex == m_stack.size() && fIsParam == false && true == fSearchGlobalSpace)
+    {
+        theEntryIndex = findGlobalEntry(qname);
+    }
+
+    return theEntryIndex;
+}
+
+
+
+VariablesStack::size_type
+VariablesStack::findGlobalEntry(const XalanQName&   qname) const
+{
+    if (m_globalStackFrameIndex > 1)
     {
         // Look in the global space
         for(size_type i = m_globalStackFrameIndex - 1; i > 0; i--)
         {
-            StackEntry&     theEntry = m_stack[i];
+            const StackEntry&   theEntry = m_stack[i];
 
             const StackEntry::eType     theType = theEntry.getType();
 
@@ -501,9 +678,7 @@ VariablesStack::findEntry(
 
                 if(theEntry.getName()->equals(qname))
                 {
-                    theEntryIndex = i;
-
-                    break;
+                    return i;
                 }
             }
             else if(theType == StackEntry::eContextMarker)
@@ -513,7 +688,94 @@ VariablesStack::findEntry(
         }
     }
 
-    return theEntryIndex;
+    return size_type(m_stack.size());
+}
+
+
+
+VariablesStack::size_type
+VariablesStack::findLocalEntry(
+            const XalanQName&   qname,
+            int                 theSlot) const
+{
+    assert(theSlot >= 0);
+
+    // The slots are only bound in the top frame, so a search from
+    // anywhere else must be by name.
+    if (m_currentStackFrameIndex == m_stack.size() &&
+        m_localSlotBases.empty() == false)
+    {
+        const LocalSlotVectorType::size_type    theIndex =
+            m_localSlotBases.back() + theSlot;
+
+        if (theIndex < m_localSlots.size() && m_localSlots[theIndex] != 0)
+        {
+            const size_type     theEntryIndex = m_localSlots[theIndex];
+            assert(theEntryIndex < m_stack.size());
+
+            const StackEntry&   theEntry = m_stack[theEntryIndex];
+
+            const StackEntry::eType     theType = theEntry.getType();
+
+            // Templates applied in the same frame may bind the same
+            // slot to different variables, so the name must match.
+            if ((theType == StackEntry::eVariable ||
+                 theType == StackEntry::eActiveParam) &&
+                theEntry.getName()->equals(qname) == true)
+            {
+                return theEntryIndex;
+            }
+        }
+    }
+
+    return size_type(m_stack.size());
+}
+
+
+
+void
+VariablesStack::bindLocalSlot(
+            int         theSlot,
+            size_type   theEntryIndex)
+{
+    assert(theSlot >= 0);
+    assert(theEntryIndex < m_stack.size());
+
+    if (m_currentStackFrameIndex == m_stack.size() &&
+        m_localSlotBases.empty() == false)
+    {
+        const LocalSlotVectorType::size_type    theIndex =
+            m_localSlotBases.back() + theSlot;
+
+        if (theIndex >= m_localSlots.size())
+        {
+            m_localSlots.resize(theIndex + 1, 0);
+        }
+
+        m_localSlots[theIndex] = theEntryIndex;
+
+        m_stack[theEntryIndex].setSlot(theSlot);
+    }
+}
+
+
+
+void
+VariablesStack::unbindLocalSlot(size_type   theEntryIndex)
+{
+    assert(theEntryIndex < m_stack.size());
+    assert(m_localSlotBases.empty() == false);
+
+    const int   theSlot = m_stack[theEntryIndex].getSlot();
+    assert(theSlot >= 0);
+
+    const LocalSlotVectorType::size_type    theIndex =
+        m_localSlotBases.back() + theSlot;
+
+    if (theIndex < m_localSlots.size() && m_localSlots[theIndex] == theEntryIndex)
+    {
+        m_localSlots[theIndex] = 0;
+    }
 }
 
 
@@ -611,7 +873,8 @@ VariablesStack::StackEntry::StackEntry() :
     m_qname(0),
     m_value(),
     m_variable(0),
-    m_element(0)
+    m_element(0),
+    m_slot(-1)
 {
 }
 
@@ -625,7 +888,8 @@ VariablesStack::StackEntry::StackEntry(
     m_qname(name),
     m_value(val),
     m_variable(0),
-    m_element(0)
+    m_element(0),
+    m_slot(-1)
 {
 }
 
@@ -639,7 +903,8 @@ VariablesStack::StackEntry::StackEntry(
     m_qname(name),
     m_value(),
     m_variable(var),
-    m_element(0)
+    m_element(0),
+    m_slot(-1)
 {
 }
 
@@ -650,7 +915,8 @@ VariablesStack::StackEntry::StackEntry(const ElemTemplateElement*   elem) :
     m_qname(0),
     m_value(),
     m_variable(0),
-    m_element(elem)
+    m_element(elem),
+    m_slot(-1)
 {
 }
 
@@ -661,7 +927,8 @@ VariablesStack::StackEntry::StackEntry(const StackEntry&    theSource) :
     m_qname(theSource.m_qname),
     m_value(theSource.m_value),
     m_variable(theSource.m_variable),
-    m_element(theSource.m_element)
+    m_element(theSource.m_element),
+    m_slot(theSource.m_slot)
 {
 }
 
@@ -687,6 +954,8 @@ VariablesStack::StackEntry::operator=(const StackEntry&     theRHS)
         m_variable = theRHS.m_variable;
 
         m_element = theRHS.m_element;
+
+        m_slot = theRHS.m_slot;
     }
 
     return *this;
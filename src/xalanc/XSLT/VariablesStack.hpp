@@ -147,6 +147,9 @@ public:
     typedef XalanVector<const ElemVariable*>            RecursionGuardStackType;
     typedef XalanVector<const ElemTemplateElement*> ElemTemplateElementStackType;
 
+    typedef XalanVector<size_type>                  GlobalSlotVectorType;
+    typedef XalanVector<size_type>                  LocalSlotVectorType;
+
     /**
      * Push the provided objects as parameters.  You must call
      * popContextMarker() when you are done with the arguments.
@@ -175,6 +178,25 @@ public:
         return findXObject(qname, executionContext, true, false, fNameFound);
     }
 
+    /**
+     * Given the name of a template's param and the slot it was assigned
+     * in the template, return the value passed for the param, but don't
+     * look in the global space.  A param that is found is bound to the
+     * slot in the current frame.
+     *
+     * @param qname name of the param
+     * @param theSlot slot of the param
+     * @param exeuctionContext the current execution context
+     * @param fNameFound set to true if the name was found, false if not.
+     * @return pointer to XObject for the param
+     */
+    const XObjectPtr
+    getLocalParamVariable(
+            const XalanQName&               qname,
+            int                             theSlot,
+            StylesheetExecutionContext&     executionContext,
+            bool&                           fNameFound);
+
     /**
      * Given a name, find the corresponding XObject.  If the variable
      * exists, but has not yet been evaluated, the variable will be
@@ -195,6 +217,46 @@ public:
         return findXObject(qname, executionContext, false, true, fNameFound);
     }
 
+    /**
+     * Given the name of a global variable and the slot the stylesheet
+     * assigned to it, find the corresponding XObject.  The first lookup
+     * of a slot searches the global stack frame by name, and later
+     * lookups use the stack index that search found.  This may return
+     * a null XObjectPtr, if the variable was not found.
+     *
+     * @param qname name of variable
+     * @param theSlot slot of the variable
+     * @param exeuctionContext the current execution context
+     * @param fNameFound set to true if the name was found, false if not.
+     * @return pointer to the corresponding XObject
+     */
+    const XObjectPtr
+    getGlobalVariable(
+            const XalanQName&               qname,
+            int                             theSlot,
+            StylesheetExecutionContext&     executionContext,
+            bool&                           fNameFound);
+
+    /**
+     * Given the name of a local variable or param and the slot it was
+     * assigned in its template, find the corresponding XObject.  If the
+     * slot is not bound in the current frame, the variable is searched
+     * for by name.  This may return a null XObjectPtr, if the variable
+     * was not found.
+     *
+     * @param qname name of variable
+     * @param theSlot slot of the variable
+     * @param exeuctionContext the current execution context
+     * @param fNameFound set to true if the name was found, false if not.
+     * @return pointer to the corresponding XObject
+     */
+    const XObjectPtr
+    getLocalVariable(
+            const XalanQName&               qname,
+            int                             theSlot,
+            StylesheetExecutionContext&     executionContext,
+            bool&                           fNameFound);
+
     /**
      * Push a named variable onto the processor variable stack. Don't forget
      * to call startContext before pushing a series of arguments for a given
@@ -225,6 +287,38 @@ public:
             const XObjectPtr&           val,
             const ElemTemplateElement*  e);
 
+    /**
+     * Push a named local variable onto the processor variable stack, and
+     * bind it to the slot it was assigned in its template.
+     *
+     * @param name    name of variable
+     * @param theSlot slot of the variable
+     * @param var     pointer to ElemVariable
+     * @param e       element marker for variable
+     */
+    void
+    pushLocalVariable(
+            const XalanQName&           name,
+            int                         theSlot,
+            const ElemVariable*         var,
+            const ElemTemplateElement*  e);
+
+    /**
+     * Push a named local variable onto the processor variable stack, and
+     * bind it to the slot it was assigned in its template.
+     *
+     * @param name    name of variable
+     * @param theSlot slot of the variable
+     * @param val     pointer to XObject value
+     * @param e       element marker for variable
+     */
+    void
+    pushLocalVariable(
+            const XalanQName&           name,
+            int                         theSlot,
+            const XObjectPtr&           val,
+            const ElemTemplateElement*  e);
+
     /**
      * Mark the top of the stack.
      */
@@ -441,6 +535,30 @@ public:
             return m_variable;
         }
 
+        /**
+         * Retrieve the local slot the variable is bound to, or -1 if it
+         * is not bound.  Valid only for variables
+         *
+         * @return the slot
+         */
+        int
+        getSlot() const
+        {
+            return m_slot;
+        }
+
+        /**
+         * Set the local slot the variable is bound to.  Valid only for
+         * variables
+         *
+         * @param theSlot the slot
+         */
+        void
+        setSlot(int     theSlot)
+        {
+            m_slot = theSlot;
+        }
+
         void
         activate();
 
@@ -476,6 +594,8 @@ public:
         const ElemVariable*         m_variable;
 
         const ElemTemplateElement*  m_element;
+
+        int                         m_slot;
     };
 
     typedef XalanVector<StackEntry>         VariableStackStackType;
@@ -569,6 +689,27 @@ private:
             bool                fIsParam,
             bool                fSearchGlobalSpace);
 
+    size_type
+    findGlobalEntry(const XalanQName&   name) const;
+
+    size_type
+    findLocalEntry(
+            const XalanQName&   name,
+            int                 theSlot) const;
+
+    void
+    bindLocalSlot(
+            int         theSlot,
+            size_type   theEntryIndex);
+
+    void
+    unbindLocalSlot(size_type   theEntryIndex);
+
+    const XObjectPtr
+    getEntryValue(
+            size_type                       theEntryIndex,
+            StylesheetExecutionContext&     executionContext);
+
 
     VariableStackStackType      m_stack;
 
@@ -590,6 +731,23 @@ private:
      */
     RecursionGuardStackType         m_guardStack;
 
+    /**
+     * The stack index of each global variable slot, or 0 if the slot
+     * has not been looked up since the global stack frame was marked.
+     */
+    GlobalSlotVectorType            m_globalSlots;
+
+    /**
+     * The stack index of the variable bound to each local slot of each
+     * context frame, or 0 if the slot is not bound.  The slots of a
+     * frame start at the offset recorded for its context marker in
+     * m_localSlotBases, and a frame's slots are only bound while it is
+     * the top frame.
+     */
+    LocalSlotVectorType             m_localSlots;
+
+    LocalSlotVectorType             m_localSlotBases;
+
     /**
      * This will be a stack for tracking element frames.
      * This is only used in debug builds.
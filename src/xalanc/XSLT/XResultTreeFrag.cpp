@@ -81,8 +81,22 @@ XResultTreeFrag::XResultTreeFrag(
     m_executionContext(0),
     m_cachedStringValue(theManager),
     m_cachedNumberValue(theBogusNumberValue)
+{
+}
+
+
 
+XResultTreeFrag::XResultTreeFrag(
+            const XalanDOMString&   theText,
+            MemoryManager&          theManager) :
+    XObject(eTypeResultTreeFrag, theManager),
+    m_value(0),
+    m_singleTextChildValue(&m_cachedStringValue),
+    m_executionContext(0),
+    m_cachedStringValue(theText, theManager),
+    m_cachedNumberValue(theBogusNumberValue)
 {
+    assert(theText.empty() == false);
 }
 
 
@@ -92,12 +106,14 @@ XResultTreeFrag::XResultTreeFrag(
             MemoryManager&          theManager) :
     XObject(source, theManager),
     m_value(source.m_value),
-    m_singleTextChildValue(source.m_singleTextChildValue),
-    m_executionContext(0),
+    m_singleTextChildValue(
+        source.m_value == 0 ? &m_cachedStringValue : source.m_singleTextChildValue),
+    // An instance which holds only text needs the context to build its nodes.
+    m_executionContext(source.m_value == 0 ? source.m_executionContext : 0),
     m_cachedStringValue(source.m_cachedStringValue, theManager),
     m_cachedNumberValue(source.m_cachedNumberValue)
 {
-    assert(m_value != 0);
+    assert(m_value != 0 || m_cachedStringValue.empty() == false);
 }
 
 
@@ -170,8 +186,9 @@ XResultTreeFrag::str() const
 {
     if (m_singleTextChildValue != 0)
     {
-        assert(m_value->getFirstChild() != 0 &&
-                m_value->getFirstChild()->getNodeType() == XalanNode::TEXT_NODE);
+        assert(m_value == 0 ||
+               (m_value->getFirstChild() != 0 &&
+                m_value->getFirstChild()->getNodeType() == XalanNode::TEXT_NODE));
 
         return *m_singleTextChildValue;
     }
@@ -205,8 +222,9 @@ XResultTreeFrag::str(
 {
     if (m_singleTextChildValue != 0)
     {
-        assert(m_value->getFirstChild() != 0 &&
-               m_value->getFirstChild()->getNodeType() == XalanNode::TEXT_NODE);
+        assert(m_value == 0 ||
+               (m_value->getFirstChild() != 0 &&
+                m_value->getFirstChild()->getNodeType() == XalanNode::TEXT_NODE));
 
         XObject::string(*m_singleTextChildValue, formatterListener, function);
     }
@@ -286,9 +304,23 @@ XResultTreeFrag::stringLength(XPathExecutionContext&    executionContext) const
 const XalanDocumentFragment&
 XResultTreeFrag::rtree() const
 {
-    assert(m_value != 0);
+    if (m_value != 0)
+    {
+        return *m_value;
+    }
+    else
+    {
+        // The instance holds only text, so build its nodes, which must
+        // have a parent and an owner document to be navigated.  The
+        // text is still used for the string value.
+        assert(m_singleTextChildValue == &m_cachedStringValue);
+        assert(m_executionContext != 0);
 
-    return *m_value;
+        m_value = m_executionContext->createTextDocumentFragment(m_cachedStringValue);
+        assert(m_value != 0);
+
+        return *m_value;
+    }
 }
 
 
@@ -64,6 +64,19 @@ public:
             XalanDocumentFragment&  value,
             MemoryManager&          theManager);
 
+    /**
+     * Construct an XResultTreeFrag object which holds a single text
+     * node with the specified value.  The text is kept as a string, and
+     * the fragment's nodes are only built by the execution context when
+     * rtree() is first called.
+     * 
+     * @param theText The text of the result tree fragment, which must not be empty.
+     * @param theManager The MemoryManager for this instance.
+     */
+    XResultTreeFrag(
+            const XalanDOMString&   theText,
+            MemoryManager&          theManager);
+
     /**
      * Construct an XResultTreeFrag object from another
      * 
@@ -141,7 +154,20 @@ public:
     ProcessXObjectTypeCallback(XObjectTypeCallback&     theCallbackObject) const;
 
     /**
-     * Release the ResultTreeFrag held by the instance.
+     * Get the text of an instance which holds only text, if its nodes
+     * have not been built.
+     *
+     * @return a pointer to the text, or 0 if the instance has nodes
+     */
+    const XalanDOMString*
+    getTextValue() const
+    {
+        return m_value == 0 ? &m_cachedStringValue : 0;
+    }
+
+    /**
+     * Release the ResultTreeFrag held by the instance.  This is 0 if the
+     * instance holds only text, and its nodes were never built.
      */
     XalanDocumentFragment*
     release();
@@ -165,9 +191,9 @@ private:
     XResultTreeFrag(const XResultTreeFrag&);
 
     // Data members...
-    XalanDocumentFragment*          m_value;    
+    mutable XalanDocumentFragment*  m_value;    
 
-    const XalanDOMString*           m_singleTextChildValue;
+    mutable const XalanDOMString*   m_singleTextChildValue;
 
     StylesheetExecutionContext*     m_executionContext;
 
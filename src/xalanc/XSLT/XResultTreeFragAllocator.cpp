@@ -54,6 +54,21 @@ XResultTreeFragAllocator::create(XalanDocumentFragment&     theValue)
 
 
 
+XResultTreeFragAllocator::data_type*
+XResultTreeFragAllocator::create(const XalanDOMString&  theText)
+{
+    data_type* const    theBlock = m_allocator.allocateBlock();
+    assert(theBlock != 0);
+
+    data_type* const    theResult = new(theBlock) data_type(theText, m_allocator.getMemoryManager());
+
+    m_allocator.commitAllocation(theBlock);
+
+    return theResult;
+}
+
+
+
 XResultTreeFragAllocator::data_type*
 XResultTreeFragAllocator::create(const data_type&   theSource)
 {
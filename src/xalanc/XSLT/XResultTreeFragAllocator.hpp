@@ -66,6 +66,16 @@ public:
     data_type*
     create(XalanDocumentFragment&   theValue);
 
+    /**
+     * Create an XResultTreeFrag object which holds only text.
+     * 
+     * @param theText  the text of the fragment
+     *
+     * @return pointer to a node
+     */
+    data_type*
+    create(const XalanDOMString&    theText);
+
     /**
      * Create an XResultTreeFrag object.
      * 
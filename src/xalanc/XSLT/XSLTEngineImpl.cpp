@@ -104,6 +104,7 @@
 #include "XSLTInputSource.hpp"
 #include "XSLTProcessorException.hpp"
 #include "XSLTResultTarget.hpp"
+#include "XResultTreeFrag.hpp"
 
 
 
@@ -1748,6 +1749,31 @@ XSLTEngineImpl::charactersRaw(
 
 
 
+bool
+XSLTEngineImpl::preSerializedMarkup(
+            const XalanDOMChar*     markup,
+            size_type               length)
+{
+    assert(getFormatterListenerImpl() != 0);
+    assert(markup != 0);
+    assert(length != 0);
+
+    // Trace listeners need the individual events, and the markup
+    // can't know which text should be written as CDATA.
+    if (getTraceListeners() > 0 || m_hasCDATASectionElements == true)
+    {
+        return false;
+    }
+    else
+    {
+        doFlushPending();
+
+        return getFormatterListenerImpl()->preSerializedMarkup(markup, length);
+    }
+}
+
+
+
 void
 XSLTEngineImpl::charactersRaw(const XalanNode&  node)
 {
@@ -2388,6 +2414,34 @@ XSLTEngineImpl::outputToResultTree(
 
 
 
+void
+XSLTEngineImpl::outputResultTreeFragment(
+            const XObject&      theTree,
+            bool                outputTextNodesOnly,
+            const Locator*      locator)
+{
+    assert(theTree.getType() == XObject::eTypeResultTreeFrag);
+
+    // A fragment which holds only text is output as characters, so
+    // copying it doesn't build its nodes.
+    const XalanDOMString* const     theText =
+        static_cast<const XResultTreeFrag&>(theTree).getTextValue();
+
+    if (theText != 0)
+    {
+        characters(theText->c_str(), 0, theText->length());
+    }
+    else
+    {
+        outputResultTreeFragment(
+            theTree.rtree(),
+            outputTextNodesOnly,
+            locator);
+    }
+}
+
+
+
 void
 XSLTEngineImpl::outputResultTreeFragment(
             const XalanDocumentFragment&    theTree,
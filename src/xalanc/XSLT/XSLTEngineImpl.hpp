@@ -693,6 +693,19 @@ public:
             size_type               start,
             size_type               length);
 
+    /**
+     * Send a run of pre-serialized markup to the result tree, if the
+     * current FormatterListener will write it directly.
+     *
+     * @param markup pointer to the markup
+     * @param length number of characters in the markup
+     * @return true if the markup was written, false if not.
+     */
+    bool
+    preSerializedMarkup(
+            const XalanDOMChar*     markup,
+            size_type               length);
+
     /**
      * Send raw character data from the node to the result tree.
      *
@@ -796,13 +809,7 @@ public:
     outputResultTreeFragment(
             const XObject&      theTree,
             bool                outputTextNodesOnly,
-            const Locator*      locator)
-    {
-        outputResultTreeFragment(
-            theTree.rtree(),
-            outputTextNodesOnly,
-            locator);
-    }
+            const Locator*      locator);
 
     /**
      * Given a result tree fragment, walk the tree and output it to the result
@@ -22,6 +22,7 @@
 
 #include "Constants.hpp"
 #include "ElemNumber.hpp"
+#include "NodeSorter.hpp"
 #include "StylesheetHandler.hpp"
 #include "XSLTEngineImpl.hpp"
 
@@ -102,6 +103,8 @@ XSLTInit::initialize(MemoryManager&  theManager)
 
     StylesheetHandler::initialize(theManager);
 
+    NodeSorter::initialize(theManager);
+
     s_staticMemoryManager = &theManager;
 
 }
@@ -111,6 +114,8 @@ XSLTInit::initialize(MemoryManager&  theManager)
 void
 XSLTInit::terminate()
 {
+    NodeSorter::terminate();
+
     StylesheetHandler::terminate();
 
     XSLTEngineImpl::terminate();
@@ -37,7 +37,8 @@ XSLTResultTarget::XSLTResultTarget(MemoryManager& theManager) :
     m_encoding(theManager),
     m_characterStream(0),
     m_formatterListener(0),
-    m_stream(0)
+    m_stream(0),
+    m_outputStream(0)
 {
 }
 
@@ -50,7 +51,8 @@ XSLTResultTarget::XSLTResultTarget(const XalanDOMString&    fileName,
     m_encoding(theManager),
     m_characterStream(0),
     m_formatterListener(0),
-    m_stream(0)
+    m_stream(0),
+    m_outputStream(0)
 {
 }
 
@@ -63,7 +65,8 @@ XSLTResultTarget::XSLTResultTarget(const XalanDOMChar*  fileName,
     m_encoding(theManager),
     m_characterStream(0),
     m_formatterListener(0),
-    m_stream(0)
+    m_stream(0),
+    m_outputStream(0)
 {
 }
 
@@ -76,7 +79,8 @@ XSLTResultTarget::XSLTResultTarget(const char*  fileName,
     m_encoding(theManager),
     m_characterStream(0),
     m_formatterListener(0),
-    m_stream(0)
+    m_stream(0),
+    m_outputStream(0)
 {
 }
 
@@ -87,7 +91,8 @@ XSLTResultTarget::XSLTResultTarget(const XSLTResultTarget& other,
     m_encoding(other.m_encoding, theManager),
     m_characterStream(other.m_characterStream),
     m_formatterListener(other.m_formatterListener),
-    m_stream(other.m_stream)
+    m_stream(other.m_stream),
+    m_outputStream(other.m_outputStream)
 {
 }
 
@@ -99,7 +104,8 @@ XSLTResultTarget::XSLTResultTarget(StreamType*  theStream,
     m_encoding(theManager),
     m_characterStream(0),
     m_formatterListener(0),
-    m_stream(0)
+    m_stream(0),
+    m_outputStream(0)
 {
     assert(theStream != 0);
 }
@@ -113,7 +119,8 @@ XSLTResultTarget::XSLTResultTarget(StreamType&  theStream,
     m_encoding(theManager),
     m_characterStream(0),
     m_formatterListener(0),
-    m_stream(0)
+    m_stream(0),
+    m_outputStream(0)
 {
 }
 
@@ -126,7 +133,8 @@ XSLTResultTarget::XSLTResultTarget(Writer*  characterStream,
     m_encoding(theManager),
     m_characterStream(characterStream),
     m_formatterListener(0),
-    m_stream(0)
+    m_stream(0),
+    m_outputStream(0)
 {
     assert(characterStream != 0);
 }
@@ -140,13 +148,28 @@ XSLTResultTarget::XSLTResultTarget(FILE*    stream,
     m_encoding(theManager),
     m_characterStream(0),
     m_formatterListener(0),
-    m_stream(stream)
+    m_stream(stream),
+    m_outputStream(0)
 {
     assert(stream != 0);
 }
 
 
 
+XSLTResultTarget::XSLTResultTarget(XalanOutputStream&   theStream,
+                                   MemoryManager& theManager) :
+    m_fileName(theManager),
+    m_byteStream(0),
+    m_encoding(theManager),
+    m_characterStream(0),
+    m_formatterListener(0),
+    m_stream(0),
+    m_outputStream(&theStream)
+{
+}
+
+
+
 XSLTResultTarget::XSLTResultTarget(FormatterListener&   flistener,
                                    MemoryManager& theManager) :
     m_fileName(theManager),
@@ -154,7 +177,8 @@ XSLTResultTarget::XSLTResultTarget(FormatterListener&   flistener,
     m_encoding(theManager),
     m_characterStream(0),
     m_formatterListener(&flistener),
-    m_stream(0)
+    m_stream(0),
+    m_outputStream(0)
 {
 }
 
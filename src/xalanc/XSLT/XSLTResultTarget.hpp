@@ -39,6 +39,7 @@ namespace XALAN_CPP_NAMESPACE {
 
 class FormatterListener;
 class Writer;
+class XalanOutputStream;
 
 
 
@@ -112,6 +113,16 @@ public:
     XSLTResultTarget(FILE*  characterStream,
                     MemoryManager& theManager XALAN_DEFAULT_CONSTRUCTOR_MEMMGR);
 
+    /**
+     * Create a new output target with an output stream.  If the
+     * stream supports direct writes, serializers that produce
+     * encoded bytes themselves write straight into its memory.
+     *
+     * @param theStream a reference to the output stream
+     */
+    XSLTResultTarget(XalanOutputStream&     theStream,
+                    MemoryManager& theManager XALAN_DEFAULT_CONSTRUCTOR_MEMMGR);
+
     /**
      * Create a new output target with a FormatterListener.
      *
@@ -272,6 +283,28 @@ public:
         m_stream = theStream;
     }
 
+    /**
+     * Set the output stream for this output target.
+     *
+     * @param theStream pointer to the output stream
+     */
+    void
+    setOutputStream(XalanOutputStream*  theStream)
+    {
+        m_outputStream = theStream;
+    }
+
+    /**
+     * Get the output stream for this output target.
+     *
+     * @return pointer to the output stream, or null if none was supplied.
+     */
+    XalanOutputStream*
+    getOutputStream() const
+    {
+        return m_outputStream;
+    }
+
     /**
      * Set a FormatterListener to process the result tree events.
      *
@@ -312,6 +345,8 @@ private:
     FormatterListener*      m_formatterListener;
 
     FILE*                   m_stream;
+
+    XalanOutputStream*      m_outputStream;
 };
 
 
@@ -0,0 +1,127 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "XalanGlobalValueCache.hpp"
+
+
+
+#include <xalanc/XPath/XObjectFactory.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanGlobalValueCache::XalanGlobalValueCache(MemoryManager&    theManager) :
+    m_types(theManager),
+    m_numbers(theManager),
+    m_strings(theManager),
+    m_mutex(&theManager)
+{
+}
+
+
+
+XalanGlobalValueCache::~XalanGlobalValueCache()
+{
+}
+
+
+
+XalanGlobalValueCache::size_type
+XalanGlobalValueCache::addEntry()
+{
+    const size_type     theIndex = m_types.size();
+
+    m_types.push_back(XObject::eTypeNull);
+    m_numbers.push_back(0.0);
+    m_strings.push_back(XalanDOMString(m_strings.getMemoryManager()));
+
+    return theIndex;
+}
+
+
+
+const XObjectPtr
+XalanGlobalValueCache::get(
+            size_type           theIndex,
+            XObjectFactory&     theFactory) const
+{
+    assert(theIndex < m_types.size());
+
+    XMLMutexLockType    theLock(&m_mutex);
+
+    switch(m_types[theIndex])
+    {
+    case XObject::eTypeBoolean:
+        return theFactory.createBoolean(m_numbers[theIndex] != 0.0);
+
+    case XObject::eTypeNumber:
+        return theFactory.createNumber(m_numbers[theIndex]);
+
+    case XObject::eTypeString:
+        // The string is never changed once it's set, and it lives
+        // as long as the stylesheet, so it can be referenced.
+        return theFactory.createStringReference(m_strings[theIndex]);
+
+    default:
+        return XObjectPtr();
+    }
+}
+
+
+
+void
+XalanGlobalValueCache::set(
+            size_type               theIndex,
+            const XObject&          theValue,
+            XPathExecutionContext&  executionContext) const
+{
+    assert(theIndex < m_types.size());
+
+    const XObject::eObjectType  theType = theValue.getType();
+
+    if (theType == XObject::eTypeBoolean ||
+        theType == XObject::eTypeNumber ||
+        theType == XObject::eTypeString)
+    {
+        XMLMutexLockType    theLock(&m_mutex);
+
+        if (m_types[theIndex] == XObject::eTypeNull)
+        {
+            if (theType == XObject::eTypeString)
+            {
+                m_strings[theIndex] = theValue.str(executionContext);
+            }
+            else if (theType == XObject::eTypeBoolean)
+            {
+                m_numbers[theIndex] = theValue.boolean(executionContext) == true ? 1.0 : 0.0;
+            }
+            else
+            {
+                m_numbers[theIndex] = theValue.num(executionContext);
+            }
+
+            m_types[theIndex] = theType;
+        }
+    }
+}
+
+
+
+}
@@ -0,0 +1,145 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALAN_GLOBALVALUECACHE_HEADER_GUARD)
+#define XALAN_GLOBALVALUECACHE_HEADER_GUARD
+
+
+
+// Base include file.  Must be first.
+#include "XSLTDefinitions.hpp"
+
+
+
+#include <xalanc/Include/XalanVector.hpp>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+#include <xalanc/XPath/XObject.hpp>
+
+
+
+#include <xercesc/util/Mutexes.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+class XObjectFactory;
+class XPathExecutionContext;
+
+
+
+/**
+ * This class caches the values of global variables which depend only on
+ * the stylesheet, so they can be shared by every transformation that
+ * uses a compiled stylesheet.  Only strings, numbers and booleans are
+ * cached, since they can be copied out of any execution context.  Access
+ * to the entries is synchronized, since a compiled stylesheet may be
+ * used by several threads at once.
+ */
+class XALAN_XSLT_EXPORT XalanGlobalValueCache
+{
+public:
+
+    typedef xercesc::XMLMutex       XMLMutexType;
+    typedef xercesc::XMLMutexLock   XMLMutexLockType;
+
+    typedef XalanVector<XObject::eObjectType>   TypeVectorType;
+    typedef XalanVector<double>                 NumberVectorType;
+    typedef XalanVector<XalanDOMString>         StringVectorType;
+
+    typedef TypeVectorType::size_type   size_type;
+
+    explicit
+    XalanGlobalValueCache(MemoryManager&    theManager);
+
+    ~XalanGlobalValueCache();
+
+    /**
+     * Add an empty entry to the cache.  This must only be called while
+     * the stylesheet is being constructed.
+     *
+     * @return the index of the new entry
+     */
+    size_type
+    addEntry();
+
+    /**
+     * Get the cached value of an entry.
+     *
+     * @param theIndex The index of the entry
+     * @param theFactory The factory to use to create the value
+     * @return the value, or a null instance if it hasn't been cached yet
+     */
+    const XObjectPtr
+    get(
+            size_type           theIndex,
+            XObjectFactory&     theFactory) const;
+
+    /**
+     * Cache the value of an entry.  Values which are not strings, numbers
+     * or booleans are ignored.  An entry is only set once.
+     *
+     * @param theIndex The index of the entry
+     * @param theValue The value to cache
+     * @param executionContext The current execution context
+     */
+    void
+    set(
+            size_type               theIndex,
+            const XObject&          theValue,
+            XPathExecutionContext&  executionContext) const;
+
+    size_type
+    size() const
+    {
+        return m_types.size();
+    }
+
+private:
+
+    // Not implemented...
+    XalanGlobalValueCache(const XalanGlobalValueCache&);
+
+    XalanGlobalValueCache&
+    operator=(const XalanGlobalValueCache&);
+
+
+    // Data members...
+    mutable TypeVectorType      m_types;
+
+    mutable NumberVectorType    m_numbers;
+
+    mutable StringVectorType    m_strings;
+
+    mutable XMLMutexType        m_mutex;
+};
+
+
+
+}
+
+
+
+#endif  // XALAN_GLOBALVALUECACHE_HEADER_GUARD
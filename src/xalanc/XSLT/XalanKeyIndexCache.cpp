@@ -0,0 +1,160 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "XalanKeyIndexCache.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanKeyIndexCache::XalanKeyIndexCache(MemoryManager&   theManager) :
+    m_memoryManager(theManager),
+    m_entries(0)
+{
+}
+
+
+
+XalanKeyIndexCache*
+XalanKeyIndexCache::create(MemoryManager&   theManager)
+{
+    typedef XalanKeyIndexCache  ThisType;
+
+    XalanAllocationGuard    theGuard(theManager, theManager.allocate(sizeof(ThisType)));
+
+    ThisType* const     theResult =
+        new (theGuard.get()) ThisType(theManager);
+
+    theGuard.release();
+
+    return theResult;
+}
+
+
+
+XalanKeyIndexCache::~XalanKeyIndexCache()
+{
+    Entry*  theEntry = m_entries.load(std::memory_order_acquire);
+
+    while (theEntry != 0)
+    {
+        Entry* const    theNext = theEntry->m_next;
+
+        XalanDestroy(m_memoryManager, theEntry);
+
+        theEntry = theNext;
+    }
+}
+
+
+
+const XalanKeyIndexCache::NodeListMapType*
+XalanKeyIndexCache::find(const XalanDOMString&  theSignature) const
+{
+    const Entry* const  theEntry =
+        find(m_entries.load(std::memory_order_acquire), theSignature);
+
+    return theEntry == 0 ? 0 : &theEntry->m_index;
+}
+
+
+
+const XalanKeyIndexCache::NodeListMapType*
+XalanKeyIndexCache::insert(
+            const XalanDOMString&   theSignature,
+            NodeListMapType&        theIndex)
+{
+    Entry*  theNewEntry = 0;
+
+    XalanConstruct(
+        m_memoryManager,
+        theNewEntry,
+        m_memoryManager,
+        theSignature);
+
+    theNewEntry->m_index.swap(theIndex);
+
+    Entry*  theHead = m_entries.load(std::memory_order_acquire);
+
+    // The list is only ever added to at the head, so if the exchange
+    // fails, only the entries that were added since the last search
+    // need to be searched again.
+    const Entry*    theSearchEnd = 0;
+
+    for(;;)
+    {
+        for (const Entry* theEntry = theHead; theEntry != theSearchEnd; theEntry = theEntry->m_next)
+        {
+            if (theEntry->m_signature == theSignature)
+            {
+                XalanDestroy(m_memoryManager, theNewEntry);
+
+                return &theEntry->m_index;
+            }
+        }
+
+        theNewEntry->m_next = theHead;
+        theSearchEnd = theHead;
+
+        if (m_entries.compare_exchange_weak(
+                theHead,
+                theNewEntry,
+                std::memory_order_release,
+                std::memory_order_acquire) == true)
+        {
+            return &theNewEntry->m_index;
+        }
+    }
+}
+
+
+
+const XalanKeyIndexCache::Entry*
+XalanKeyIndexCache::find(
+            const Entry*            theEntry,
+            const XalanDOMString&   theSignature)
+{
+    while (theEntry != 0)
+    {
+        if (theEntry->m_signature == theSignature)
+        {
+            break;
+        }
+
+        theEntry = theEntry->m_next;
+    }
+
+    return theEntry;
+}
+
+
+
+XalanKeyIndexCache::Entry::Entry(
+            MemoryManager&          theManager,
+            const XalanDOMString&   theSignature) :
+    m_signature(theSignature, theManager),
+    m_index(theManager),
+    m_next(0)
+{
+}
+
+
+
+}
@@ -0,0 +1,142 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALAN_KEYINDEXCACHE_HEADER_GUARD)
+#define XALAN_KEYINDEXCACHE_HEADER_GUARD
+
+
+
+// Base include file.  Must be first.
+#include "XSLTDefinitions.hpp"
+
+
+
+#include <atomic>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+#include "KeyTable.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * A cache of xsl:key indexes for a single source document, which can
+ * be shared by transforms on different threads.  Each index is keyed
+ * by the signature of the xsl:key declarations that built it.  This
+ * is made from the text of their match and use expressions, the
+ * namespaces those expressions refer to, and the stylesheet settings
+ * which change the index: the whitespace rules, and the base URI and
+ * decimal formats if the expressions call document() or format-number().
+ * So an index can be shared by transformations which use different
+ * compiled stylesheets.
+ *
+ * Once an index is added, it's never modified or removed until the
+ * cache is destroyed, so finding an index doesn't require a lock.
+ */
+class XALAN_XSLT_EXPORT XalanKeyIndexCache
+{
+public:
+
+    typedef KeyTable::NodeListMapType   NodeListMapType;
+
+    XalanKeyIndexCache(MemoryManager&   theManager);
+
+    static XalanKeyIndexCache*
+    create(MemoryManager&   theManager);
+
+    ~XalanKeyIndexCache();
+
+    /**
+     * Find the index for a signature.
+     *
+     * @param theSignature The signature of the key declarations
+     * @return a pointer to the index, or 0 if there is no index for the signature.
+     */
+    const NodeListMapType*
+    find(const XalanDOMString&  theSignature) const;
+
+    /**
+     * Add an index to the cache.  The contents of theIndex are
+     * transferred to the cache.  If another thread has already added
+     * an index for the same signature, that index is returned instead,
+     * and theIndex is discarded.  Any node lists in theIndex must use
+     * the cache's memory manager.
+     *
+     * @param theSignature The signature of the key declarations
+     * @param theIndex The index to add
+     * @return a pointer to the index in the cache.
+     */
+    const NodeListMapType*
+    insert(
+            const XalanDOMString&   theSignature,
+            NodeListMapType&        theIndex);
+
+    MemoryManager&
+    getMemoryManager() const
+    {
+        return m_memoryManager;
+    }
+
+private:
+
+    class Entry
+    {
+    public:
+
+        Entry(
+                MemoryManager&          theManager,
+                const XalanDOMString&   theSignature);
+
+        const XalanDOMString    m_signature;
+
+        NodeListMapType         m_index;
+
+        Entry*                  m_next;
+    };
+
+    static const Entry*
+    find(
+            const Entry*            theEntry,
+            const XalanDOMString&   theSignature);
+
+    // Not implemented...
+    XalanKeyIndexCache(const XalanKeyIndexCache&);
+
+    XalanKeyIndexCache&
+    operator=(const XalanKeyIndexCache&);
+
+    // Data members...
+    MemoryManager&          m_memoryManager;
+
+    std::atomic<Entry*>     m_entries;
+};
+
+
+
+}
+
+
+
+#endif  // XALAN_KEYINDEXCACHE_HEADER_GUARD
@@ -82,7 +82,8 @@ public:
         m_targetString(theTargetString, theManager),
         m_matchPattern(&theMatchPattern),
         m_pattern(&thePatternString),
-        m_priority(thePriority)
+        m_priority(thePriority),
+        m_nameTestNamespace(theMatchPattern.getNameTestNamespace())
     {
     }
 
@@ -151,6 +152,20 @@ public:
         return m_priority;
     }
 
+    /**
+     * If the pattern is a simple element or attribute name test,
+     * retrieve the namespace URI of the name.  A node with the
+     * target string as its local name, and this namespace URI,
+     * matches the pattern without evaluating it.
+     *
+     * @return the namespace URI, or 0 if the pattern must be evaluated
+     */
+    const XalanDOMString*
+    getNameTestNamespace() const
+    {
+        return m_nameTestNamespace;
+    }
+
     double
     getPriorityOrDefault() const;
 
@@ -170,6 +185,8 @@ private:
     const XalanDOMString*   m_pattern;
 
     eMatchScore             m_priority;
+
+    const XalanDOMString*   m_nameTestNamespace;
 };
 
 
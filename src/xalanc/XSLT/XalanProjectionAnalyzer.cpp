@@ -0,0 +1,1551 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "XalanProjectionAnalyzer.hpp"
+
+
+
+#include <algorithm>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+#include <xalanc/XPath/XalanQNameByValue.hpp>
+#include <xalanc/XPath/XPathExpression.hpp>
+
+
+
+#include "ElemApplyTemplates.hpp"
+#include "ElemAttributeSet.hpp"
+#include "ElemCallTemplate.hpp"
+#include "ElemForEach.hpp"
+#include "ElemSort.hpp"
+#include "ElemTemplate.hpp"
+#include "ElemVariable.hpp"
+#include "KeyDeclaration.hpp"
+#include "StylesheetConstructionContext.hpp"
+#include "StylesheetRoot.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+// The name index which stands for the document element, whatever
+// its name is.
+static const XalanSourceTreeProjection::size_type   s_documentElement =
+        ~XalanSourceTreeProjection::size_type(0);
+
+
+
+static int
+getFunctionID(
+            const char*         theName,
+            XalanDOMString&     theBuffer)
+{
+    theBuffer = theName;
+
+    return XPath::getFunctionTable().nameToID(theBuffer);
+}
+
+
+
+static bool
+containsName(
+            const XalanVector<XalanSourceTreeProjection::size_type>&    theNames,
+            XalanSourceTreeProjection::size_type                        theName)
+{
+    return std::find(theNames.begin(), theNames.end(), theName) != theNames.end();
+}
+
+
+
+XalanProjectionAnalyzer::NodeSetType::NodeSetType(
+            MemoryManager&  theManager,
+            int             theFlags) :
+    m_flags(theFlags),
+    m_names(theManager)
+{
+}
+
+
+
+XalanProjectionAnalyzer::NodeSetType::NodeSetType(
+            const NodeSetType&  theSource,
+            MemoryManager&      theManager) :
+    m_flags(theSource.m_flags),
+    m_names(theSource.m_names, theManager)
+{
+}
+
+
+
+XalanProjectionAnalyzer::NodeSetType&
+XalanProjectionAnalyzer::NodeSetType::operator=(const NodeSetType&  theRHS)
+{
+    if (this != &theRHS)
+    {
+        m_flags = theRHS.m_flags;
+        m_names = theRHS.m_names;
+    }
+
+    return *this;
+}
+
+
+
+void
+XalanProjectionAnalyzer::NodeSetType::add(const NodeSetType&    theOther)
+{
+    m_flags |= theOther.m_flags;
+
+    const NameIndexVectorType::const_iterator   theEnd = theOther.m_names.end();
+
+    for (NameIndexVectorType::const_iterator i = theOther.m_names.begin(); i != theEnd; ++i)
+    {
+        addName(*i);
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::NodeSetType::addName(NameIndexType     theName)
+{
+    if (containsName(m_names, theName) == false)
+    {
+        m_names.push_back(theName);
+    }
+}
+
+
+
+bool
+XalanProjectionAnalyzer::NodeSetType::contains(const NodeSetType&   theOther) const
+{
+    if ((theOther.m_flags & ~m_flags) != 0)
+    {
+        return false;
+    }
+
+    const NameIndexVectorType::const_iterator   theEnd = theOther.m_names.end();
+
+    for (NameIndexVectorType::const_iterator i = theOther.m_names.begin(); i != theEnd; ++i)
+    {
+        if (containsName(m_names, *i) == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+XalanProjectionAnalyzer::XalanProjectionAnalyzer(MemoryManager&    theManager) :
+    m_memoryManager(theManager),
+    m_projection(0),
+    m_isProjectable(true),
+    m_templates(theManager),
+    m_variableNodes(theManager),
+    m_nextVariableNodes(theManager),
+    m_keyNodes(theManager),
+    m_documentElementNames(theManager),
+    m_restrictDocumentElement(false),
+    m_calledTemplates(theManager),
+    m_currentID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_documentID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_generateIDID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_idID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_keyID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_normalizeSpaceID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_numberID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_stringID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_stringLengthID(XPathFunctionTable::InvalidFunctionNumberID)
+{
+    XalanDOMString  theBuffer(theManager);
+
+    m_currentID = getFunctionID("current", theBuffer);
+    m_documentID = getFunctionID("document", theBuffer);
+    m_generateIDID = getFunctionID("generate-id", theBuffer);
+    m_idID = getFunctionID("id", theBuffer);
+    m_keyID = getFunctionID("key", theBuffer);
+    m_normalizeSpaceID = getFunctionID("normalize-space", theBuffer);
+    m_numberID = getFunctionID("number", theBuffer);
+    m_stringID = getFunctionID("string", theBuffer);
+    m_stringLengthID = getFunctionID("string-length", theBuffer);
+}
+
+
+
+XalanProjectionAnalyzer::~XalanProjectionAnalyzer()
+{
+    clearCalledTemplates();
+}
+
+
+
+bool
+XalanProjectionAnalyzer::analyze(
+            const StylesheetRoot&           theStylesheet,
+            XalanSourceTreeProjection&      theProjection)
+{
+    m_projection = &theProjection;
+    m_isProjectable = true;
+
+    theProjection.clear();
+
+    m_templates.clear();
+    m_keyNodes.clear();
+
+    collectStylesheet(theStylesheet);
+
+    const XalanQNameByValue     theDefaultMode(m_memoryManager);
+
+    const NodeSetType   theRoot(m_memoryManager, NodeSetType::eRoot);
+
+    const NodeSetType   theAttributeSetContext(
+                            m_memoryManager,
+                            NodeSetType::eRoot | NodeSetType::eAncestor | NodeSetType::eComplete);
+
+    m_variableNodes.clear();
+
+    // A variable can hold the nodes of any other variable, so the
+    // analysis is repeated until the nodes of the variables stop
+    // growing.
+    for (;;)
+    {
+        m_nextVariableNodes.clear();
+        m_documentElementNames.clear();
+        m_restrictDocumentElement = false;
+
+        clearCalledTemplates();
+
+        analyzeStylesheet(theStylesheet);
+
+        // Attribute sets are executed with whatever the current node
+        // is, so the context could be any built node.
+        {
+            typedef StylesheetRoot::AttributeSetMapType::const_iterator     const_iterator;
+            typedef StylesheetRoot::AttributeSetVectorType::const_iterator  vector_iterator;
+
+            const const_iterator    theEnd = theStylesheet.m_attributeSetsMap.end();
+
+            for (const_iterator i = theStylesheet.m_attributeSetsMap.begin();
+                    i != theEnd && m_isProjectable == true;
+                        ++i)
+            {
+                const vector_iterator   theVectorEnd = (*i).second.end();
+
+                for (vector_iterator j = (*i).second.begin(); j != theVectorEnd; ++j)
+                {
+                    assert(*j != 0);
+
+                    analyzeElement(**j, theAttributeSetContext);
+                }
+            }
+        }
+
+        if (m_isProjectable == true)
+        {
+            applyTemplates(theRoot, theDefaultMode);
+        }
+
+        if (m_isProjectable == false ||
+            m_variableNodes.contains(m_nextVariableNodes) == true)
+        {
+            break;
+        }
+
+        m_variableNodes.add(m_nextVariableNodes);
+    }
+
+    if (m_isProjectable == true && m_restrictDocumentElement == true)
+    {
+        if (m_documentElementNames.empty() == true)
+        {
+            m_isProjectable = false;
+        }
+        else
+        {
+            theProjection.restrictDocumentElement(m_documentElementNames);
+        }
+    }
+
+    if (m_isProjectable == false)
+    {
+        theProjection.clear();
+    }
+
+    clearCalledTemplates();
+
+    m_templates.clear();
+    m_variableNodes.clear();
+    m_nextVariableNodes.clear();
+    m_keyNodes.clear();
+    m_documentElementNames.clear();
+
+    m_projection = 0;
+
+    return m_isProjectable;
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzeExpression(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            const NodeSetType&      theContext,
+            const NodeSetType&      theCurrent,
+            NodeSetType&            theResult)
+{
+    if (m_isProjectable == false)
+    {
+        return;
+    }
+
+    const OpCodeMapValueType    theOpCode = theExpression.getOpCodeMapValue(opPos);
+
+    const OpCodeMapPositionType     theEnd =
+        theExpression.getNextOpCodePosition(opPos);
+
+    switch(theOpCode)
+    {
+    case XPathExpression::eOP_XPATH:
+    case XPathExpression::eOP_UNION:
+    case XPathExpression::eOP_GROUP:
+    case XPathExpression::eOP_ARGUMENT:
+        // These yield the nodes of their operands.
+        for (OpCodeMapPositionType i = opPos + 2;
+                i < theEnd && theExpression.getOpCodeMapValue(i) != XPathExpression::eENDOP;
+                    i = theExpression.getNextOpCodePosition(i))
+        {
+            analyzeExpression(theExpression, i, theContext, theCurrent, theResult);
+        }
+        break;
+
+    case XPathExpression::eOP_OR:
+    case XPathExpression::eOP_AND:
+    case XPathExpression::eOP_BOOL:
+    case XPathExpression::eOP_FUNCTION_COUNT:
+    case XPathExpression::eOP_FUNCTION_NOT:
+    case XPathExpression::eOP_FUNCTION_BOOLEAN:
+    case XPathExpression::eOP_FUNCTION_NAME_1:
+    case XPathExpression::eOP_FUNCTION_LOCALNAME_1:
+    case XPathExpression::eOP_FUNCTION_NAMESPACEURI_1:
+        // These only look at the nodes themselves.
+        analyzeArguments(theExpression, opPos + 2, theEnd, theContext, theCurrent, false);
+        break;
+
+    case XPathExpression::eOP_NOTEQUALS:
+    case XPathExpression::eOP_EQUALS:
+    case XPathExpression::eOP_LTE:
+    case XPathExpression::eOP_LT:
+    case XPathExpression::eOP_GTE:
+    case XPathExpression::eOP_GT:
+    case XPathExpression::eOP_PLUS:
+    case XPathExpression::eOP_MINUS:
+    case XPathExpression::eOP_MULT:
+    case XPathExpression::eOP_DIV:
+    case XPathExpression::eOP_MOD:
+    case XPathExpression::eOP_NEG:
+    case XPathExpression::eOP_FUNCTION_FLOOR:
+    case XPathExpression::eOP_FUNCTION_CEILING:
+    case XPathExpression::eOP_FUNCTION_ROUND:
+    case XPathExpression::eOP_FUNCTION_NUMBER_1:
+    case XPathExpression::eOP_FUNCTION_STRING_1:
+    case XPathExpression::eOP_FUNCTION_STRINGLENGTH_1:
+    case XPathExpression::eOP_FUNCTION_SUM:
+    case XPathExpression::eOP_FUNCTION_CONCAT:
+        // These use the string values of the nodes.
+        analyzeArguments(theExpression, opPos + 2, theEnd, theContext, theCurrent, true);
+        break;
+
+    case XPathExpression::eOP_FUNCTION_TRANSLATE:
+        // The table index and the argument count precede the arguments.
+        analyzeArguments(theExpression, opPos + 4, theEnd, theContext, theCurrent, true);
+        break;
+
+    case XPathExpression::eOP_LITERAL:
+    case XPathExpression::eOP_NUMBERLIT:
+    case XPathExpression::eOP_FUNCTION_TRUE:
+    case XPathExpression::eOP_FUNCTION_FALSE:
+    case XPathExpression::eOP_FUNCTION_POSITION:
+    case XPathExpression::eOP_FUNCTION_LAST:
+    case XPathExpression::eOP_FUNCTION_NAME_0:
+    case XPathExpression::eOP_FUNCTION_LOCALNAME_0:
+    case XPathExpression::eOP_FUNCTION_NAMESPACEURI_0:
+        break;
+
+    case XPathExpression::eOP_FUNCTION_NUMBER_0:
+    case XPathExpression::eOP_FUNCTION_STRING_0:
+    case XPathExpression::eOP_FUNCTION_STRINGLENGTH_0:
+        useValue(theContext);
+        break;
+
+    case XPathExpression::eOP_VARIABLE:
+        theResult.add(m_variableNodes);
+        break;
+
+    case XPathExpression::eOP_FUNCTION:
+        analyzeFunction(theExpression, opPos, theContext, theCurrent, theResult);
+        break;
+
+    case XPathExpression::eOP_LOCATIONPATH:
+        analyzeLocationPath(theExpression, opPos, theContext, theCurrent, theResult);
+        break;
+
+    default:
+        // Extension functions, and anything else we don't know about.
+        m_isProjectable = false;
+        break;
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzeArguments(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   theFirstPos,
+            OpCodeMapPositionType   theEndPos,
+            const NodeSetType&      theContext,
+            const NodeSetType&      theCurrent,
+            bool                    fUsesValues)
+{
+    NodeSetType     theArgument(m_memoryManager);
+
+    for (OpCodeMapPositionType i = theFirstPos;
+            i < theEndPos && theExpression.getOpCodeMapValue(i) != XPathExpression::eENDOP;
+                i = theExpression.getNextOpCodePosition(i))
+    {
+        theArgument.clear();
+
+        analyzeExpression(theExpression, i, theContext, theCurrent, theArgument);
+
+        if (fUsesValues == true)
+        {
+            useValue(theArgument);
+        }
+        else
+        {
+            useNodes(theArgument);
+        }
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzeLocationPath(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            const NodeSetType&      theContext,
+            const NodeSetType&      theCurrent,
+            NodeSetType&            theResult)
+{
+    NodeSetType     theNodes(theContext, m_memoryManager);
+    NodeSetType     theStepNodes(m_memoryManager);
+
+    OpCodeMapPositionType   theStepPos = opPos + 2;
+
+    while (m_isProjectable == true &&
+           theExpression.getOpCodeMapValue(theStepPos) != XPathExpression::eENDOP)
+    {
+        theStepNodes.clear();
+
+        OpCodeMapPositionType   thePredicatePos = 0;
+        OpCodeMapPositionType   theNextPos = 0;
+
+        switch(theExpression.getOpCodeMapValue(theStepPos))
+        {
+        case XPathExpression::eOP_VARIABLE:
+        case XPathExpression::eOP_FUNCTION:
+        case XPathExpression::eOP_EXTFUNCTION:
+        case XPathExpression::eOP_GROUP:
+            // A filter expression.
+            analyzeExpression(theExpression, theStepPos, theNodes, theCurrent, theStepNodes);
+
+            thePredicatePos = theExpression.getNextOpCodePosition(theStepPos);
+            break;
+
+        case XPathExpression::eFROM_ROOT:
+            theStepNodes.m_flags = NodeSetType::eRoot;
+
+            thePredicatePos = theStepPos + theExpression.getOpCodeMapValue(theStepPos + 2);
+            theNextPos = theStepPos + theExpression.getOpCodeMapValue(theStepPos + 1);
+            break;
+
+        default:
+            analyzeStep(theExpression, theStepPos, theNodes, theStepNodes);
+
+            thePredicatePos = theStepPos + theExpression.getOpCodeMapValue(theStepPos + 2);
+            theNextPos = theStepPos + theExpression.getOpCodeMapValue(theStepPos + 1);
+            break;
+        }
+
+        analyzePredicates(theExpression, thePredicatePos, theStepNodes, theCurrent);
+
+        theStepPos = theNextPos != 0 ? theNextPos : thePredicatePos;
+
+        theNodes = theStepNodes;
+    }
+
+    theResult.add(theNodes);
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzeStep(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            const NodeSetType&      theContext,
+            NodeSetType&            theResult)
+{
+    const OpCodeMapValueType    theAxis = theExpression.getOpCodeMapValue(opPos);
+
+    const int   theFlags = theContext.m_flags;
+
+    const bool  fHasNames = theContext.m_names.empty() == false;
+
+    // The nodes whose attributes and ancestors are built.
+    const bool  fHasBuiltNodes = fHasNames == true ||
+        (theFlags & (NodeSetType::eComplete | NodeSetType::eAncestor)) != 0;
+
+    if (theAxis == XPathExpression::eFROM_ATTRIBUTES ||
+        theAxis == XPathExpression::eFROM_NAMESPACE)
+    {
+        if (fHasBuiltNodes == true)
+        {
+            theResult.m_flags |= NodeSetType::eComplete;
+        }
+
+        if ((theFlags & NodeSetType::eIncomplete) != 0)
+        {
+            theResult.m_flags |= NodeSetType::eIncomplete;
+        }
+
+        return;
+    }
+
+    NameIndexType   theName = 0;
+
+    if (getElementName(theExpression, opPos + 3, theName) == true)
+    {
+        // Every element with the name is built, wherever it is.
+        if (theContext.isEmpty() == false)
+        {
+            theResult.addName(theName);
+        }
+
+        if ((theFlags & NodeSetType::eIncomplete) != 0 &&
+            theAxis != XPathExpression::eFROM_CHILDREN &&
+            theAxis != XPathExpression::eFROM_DESCENDANTS &&
+            theAxis != XPathExpression::eFROM_DESCENDANTS_OR_SELF &&
+            theAxis != XPathExpression::eFROM_SELF)
+        {
+            theResult.m_flags |= NodeSetType::eIncomplete;
+        }
+
+        return;
+    }
+
+    switch(theAxis)
+    {
+    case XPathExpression::eFROM_CHILDREN:
+    case XPathExpression::eFROM_DESCENDANTS:
+    case XPathExpression::eFROM_DESCENDANTS_OR_SELF:
+        {
+            const NameIndexVectorType::const_iterator   theEnd = theContext.m_names.end();
+
+            for (NameIndexVectorType::const_iterator i = theContext.m_names.begin(); i != theEnd; ++i)
+            {
+                requireSubtree(*i);
+            }
+
+            if (fHasNames == true || (theFlags & NodeSetType::eComplete) != 0)
+            {
+                theResult.m_flags |= NodeSetType::eComplete;
+            }
+
+            if ((theFlags & NodeSetType::eRoot) != 0)
+            {
+                if (theAxis == XPathExpression::eFROM_CHILDREN)
+                {
+                    // The document element, and the comments and processing
+                    // instructions outside of it, which are always built.
+                    theResult.addName(s_documentElement);
+
+                    theResult.m_flags |= NodeSetType::eComplete;
+                }
+                else
+                {
+                    theResult.m_flags |= NodeSetType::eIncomplete;
+                }
+            }
+
+            if ((theFlags & (NodeSetType::eAncestor | NodeSetType::eIncomplete)) != 0)
+            {
+                theResult.m_flags |= NodeSetType::eIncomplete;
+            }
+        }
+        break;
+
+    case XPathExpression::eFROM_SELF:
+        theResult.add(theContext);
+        break;
+
+    case XPathExpression::eFROM_ANCESTORS_OR_SELF:
+        theResult.add(theContext);
+
+        // Fall through...
+
+    case XPathExpression::eFROM_PARENT:
+    case XPathExpression::eFROM_ANCESTORS:
+        if (fHasBuiltNodes == true)
+        {
+            theResult.m_flags |= NodeSetType::eAncestor;
+        }
+
+        if ((theFlags & NodeSetType::eIncomplete) != 0)
+        {
+            theResult.m_flags |= NodeSetType::eIncomplete;
+        }
+        break;
+
+    case XPathExpression::eFROM_FOLLOWING:
+    case XPathExpression::eFROM_FOLLOWING_SIBLINGS:
+    case XPathExpression::eFROM_PRECEDING:
+    case XPathExpression::eFROM_PRECEDING_SIBLINGS:
+        // The root has no siblings, but anything else may have
+        // siblings which are not built.
+        if (fHasBuiltNodes == true || (theFlags & NodeSetType::eIncomplete) != 0)
+        {
+            theResult.m_flags |= NodeSetType::eIncomplete;
+        }
+        break;
+
+    default:
+        m_isProjectable = false;
+        break;
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzeFunction(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            const NodeSetType&      theContext,
+            const NodeSetType&      theCurrent,
+            NodeSetType&            theResult)
+{
+    const int   theFunctionID = theExpression.getOpCodeMapValue(opPos + 2);
+    const int   theArgCount = theExpression.getOpCodeMapValue(opPos + 3);
+
+    const OpCodeMapPositionType     theEnd =
+        theExpression.getNextOpCodePosition(opPos);
+
+    if (theFunctionID == m_idID)
+    {
+        // The elements with IDs can be anywhere.
+        m_isProjectable = false;
+    }
+    else if (theFunctionID == m_currentID)
+    {
+        theResult.add(theCurrent);
+    }
+    else if (theFunctionID == m_keyID)
+    {
+        analyzeArguments(theExpression, opPos + 4, theEnd, theContext, theCurrent, true);
+
+        theResult.add(m_keyNodes);
+    }
+    else if (theFunctionID == m_documentID)
+    {
+        // Other documents are always built completely.
+        analyzeArguments(theExpression, opPos + 4, theEnd, theContext, theCurrent, true);
+
+        theResult.m_flags |= NodeSetType::eComplete;
+    }
+    else if (theFunctionID == m_generateIDID)
+    {
+        analyzeArguments(theExpression, opPos + 4, theEnd, theContext, theCurrent, false);
+    }
+    else
+    {
+        if (theArgCount == 0 &&
+            (theFunctionID == m_stringID ||
+             theFunctionID == m_numberID ||
+             theFunctionID == m_stringLengthID ||
+             theFunctionID == m_normalizeSpaceID))
+        {
+            useValue(theContext);
+        }
+
+        analyzeArguments(theExpression, opPos + 4, theEnd, theContext, theCurrent, true);
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzePredicates(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType&  opPos,
+            const NodeSetType&      theContext,
+            const NodeSetType&      theCurrent)
+{
+    NodeSetType     theResult(m_memoryManager);
+
+    for (;;)
+    {
+        const OpCodeMapValueType    theOpCode = theExpression.getOpCodeMapValue(opPos);
+
+        if (theOpCode != XPathExpression::eOP_PREDICATE &&
+            theOpCode != XPathExpression::eOP_PREDICATE_WITH_POSITION)
+        {
+            break;
+        }
+
+        // The position and the size of the context would be
+        // wrong if some of the nodes are not built.
+        if ((theContext.m_flags & NodeSetType::eIncomplete) != 0)
+        {
+            m_isProjectable = false;
+
+            return;
+        }
+
+        theResult.clear();
+
+        analyzeExpression(theExpression, opPos + 2, theContext, theCurrent, theResult);
+
+        useNodes(theResult);
+
+        opPos = theExpression.getNextOpCodePosition(opPos);
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzePattern(
+            const XPathExpression&  theExpression,
+            bool                    fAnalyzePredicates,
+            NodeSetType&            theMatchedNodes,
+            bool&                   fMatchesAnyElement,
+            NameIndexVectorType&    theExactNames)
+{
+    NodeSetType     theStepNodes(m_memoryManager);
+
+    OpCodeMapPositionType   thePathPos = theExpression.getInitialOpCodePosition() + 2;
+
+    while (m_isProjectable == true &&
+           theExpression.getOpCodeMapValue(thePathPos) == XPathExpression::eOP_LOCATIONPATHPATTERN)
+    {
+        OpCodeMapPositionType   theStepPos = thePathPos + 2;
+
+        bool    fRootOnly = true;
+        bool    fHasPredicates = false;
+        bool    fLastIsWildcard = false;
+        bool    fLastIsNamed = false;
+        size_t  theStepCount = 0;
+
+        NameIndexType   theName = 0;
+
+        while (m_isProjectable == true &&
+               theExpression.getOpCodeMapValue(theStepPos) != XPathExpression::eENDOP)
+        {
+            const OpCodeMapValueType    theStepType = theExpression.getOpCodeMapValue(theStepPos);
+
+            theStepNodes.clear();
+
+            fLastIsWildcard = false;
+            fLastIsNamed = false;
+
+            switch(theStepType)
+            {
+            case XPathExpression::eFROM_ROOT:
+                theStepNodes.m_flags = NodeSetType::eRoot;
+                break;
+
+            case XPathExpression::eMATCH_ATTRIBUTE:
+                fRootOnly = false;
+                ++theStepCount;
+
+                theStepNodes.m_flags = NodeSetType::eComplete;
+                break;
+
+            case XPathExpression::eMATCH_ANY_ANCESTOR:
+            case XPathExpression::eMATCH_IMMEDIATE_ANCESTOR:
+            case XPathExpression::eMATCH_ANY_ANCESTOR_WITH_PREDICATE:
+                fRootOnly = false;
+                ++theStepCount;
+
+                if (getElementName(theExpression, theStepPos + 3, theName) == true)
+                {
+                    fLastIsNamed = true;
+
+                    theStepNodes.addName(theName);
+                }
+                else
+                {
+                    switch(theExpression.getOpCodeMapValue(theStepPos + 3))
+                    {
+                    case XPathExpression::eNODETYPE_NODE:
+                    case XPathExpression::eNODETYPE_ANYELEMENT:
+                    case XPathExpression::eNODENAME:
+                        fLastIsWildcard = true;
+                        break;
+
+                    default:
+                        break;
+                    }
+
+                    // Text, comments and processing instructions are
+                    // only built in subtrees which are built completely.
+                    theStepNodes.m_flags = NodeSetType::eComplete;
+                }
+                break;
+
+            default:
+                // id() and key() patterns.
+                m_isProjectable = false;
+                return;
+            }
+
+            OpCodeMapPositionType   thePredicatePos =
+                theStepPos + theExpression.getOpCodeMapValue(theStepPos + 2);
+
+            const OpCodeMapValueType    thePredicateOpCode =
+                theExpression.getOpCodeMapValue(thePredicatePos);
+
+            if (thePredicateOpCode == XPathExpression::eOP_PREDICATE ||
+                thePredicateOpCode == XPathExpression::eOP_PREDICATE_WITH_POSITION)
+            {
+                fHasPredicates = true;
+
+                if (fAnalyzePredicates == true)
+                {
+                    // A wildcard element might have siblings which are
+                    // not built.
+                    if (fLastIsWildcard == true)
+                    {
+                        m_isProjectable = false;
+
+                        return;
+                    }
+
+                    analyzePredicates(theExpression, thePredicatePos, theStepNodes, theStepNodes);
+                }
+            }
+
+            theStepPos += theExpression.getOpCodeMapValue(theStepPos + 1);
+        }
+
+        if (fRootOnly == true)
+        {
+            theMatchedNodes.m_flags |= NodeSetType::eRoot;
+        }
+        else
+        {
+            // The last step is the node which is matched.
+            theMatchedNodes.add(theStepNodes);
+
+            if (fLastIsWildcard == true)
+            {
+                fMatchesAnyElement = true;
+            }
+            else if (fLastIsNamed == true &&
+                     theStepCount == 1 &&
+                     fHasPredicates == false &&
+                     containsName(theExactNames, theName) == false)
+            {
+                theExactNames.push_back(theName);
+            }
+        }
+
+        thePathPos = theExpression.getNextOpCodePosition(thePathPos);
+    }
+}
+
+
+
+bool
+XalanProjectionAnalyzer::getElementName(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   theNodeTestPos,
+            NameIndexType&          theName)
+{
+    if (theExpression.getOpCodeMapValue(theNodeTestPos) != XPathExpression::eNODENAME)
+    {
+        return false;
+    }
+
+    const OpCodeMapValueType    theLocalNamePos =
+        theExpression.getOpCodeMapValue(theNodeTestPos + 2);
+
+    if (theLocalNamePos == XPathExpression::eELEMWILDCARD ||
+        theLocalNamePos == XPathExpression::eEMPTY)
+    {
+        return false;
+    }
+
+    const XalanDOMString&   theLocalName = theExpression.getToken(theLocalNamePos)->str();
+
+    if (theLocalName == XPath::PSEUDONAME_ANY)
+    {
+        return false;
+    }
+
+    const OpCodeMapValueType    theNamespacePos =
+        theExpression.getOpCodeMapValue(theNodeTestPos + 1);
+
+    if (theNamespacePos == XPathExpression::eEMPTY ||
+        theNamespacePos == XPathExpression::eELEMWILDCARD)
+    {
+        const XalanDOMString    theEmptyNamespace(m_memoryManager);
+
+        theName = m_projection->addElementName(theEmptyNamespace, theLocalName);
+    }
+    else
+    {
+        theName = m_projection->addElementName(
+                    theExpression.getToken(theNamespacePos)->str(),
+                    theLocalName);
+    }
+
+    return true;
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzeXPath(
+            const XPath&        theXPath,
+            const NodeSetType&  theContext,
+            NodeSetType&        theResult)
+{
+    const XPathExpression&  theExpression = theXPath.getExpression();
+
+    const OpCodeMapPositionType     opPos = theExpression.getInitialOpCodePosition();
+
+    if (theExpression.getOpCodeMapValue(opPos) == XPathExpression::eOP_MATCHPATTERN)
+    {
+        // Patterns in instructions are only in xsl:number.
+        m_isProjectable = false;
+    }
+    else
+    {
+        analyzeExpression(theExpression, opPos, theContext, theContext, theResult);
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::useValue(const NodeSetType&    theNodes)
+{
+    if ((theNodes.m_flags & (NodeSetType::eRoot | NodeSetType::eAncestor | NodeSetType::eIncomplete)) != 0)
+    {
+        m_isProjectable = false;
+    }
+    else
+    {
+        const NameIndexVectorType::const_iterator   theEnd = theNodes.m_names.end();
+
+        for (NameIndexVectorType::const_iterator i = theNodes.m_names.begin(); i != theEnd; ++i)
+        {
+            requireSubtree(*i);
+        }
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::useNodes(const NodeSetType&    theNodes)
+{
+    if ((theNodes.m_flags & NodeSetType::eIncomplete) != 0)
+    {
+        m_isProjectable = false;
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::requireSubtree(NameIndexType   theName)
+{
+    if (theName == s_documentElement)
+    {
+        m_isProjectable = false;
+    }
+    else
+    {
+        m_projection->setBuildSubtree(theName);
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::applyTemplates(
+            const NodeSetType&  theNodes,
+            const XalanQName&   theMode)
+{
+    if ((theNodes.m_flags & (NodeSetType::eAncestor | NodeSetType::eIncomplete)) != 0)
+    {
+        m_isProjectable = false;
+
+        return;
+    }
+
+    bool    fMatchesRoot = false;
+    bool    fMatchesAnyElement = false;
+
+    NameIndexVectorType     theExactNames(m_memoryManager);
+
+    getModeTemplates(theMode, fMatchesRoot, fMatchesAnyElement, theExactNames);
+
+    if ((theNodes.m_flags & NodeSetType::eRoot) != 0 && fMatchesRoot == false)
+    {
+        // The built-in rule processes the children of the root.
+        NodeSetType     theChildren(m_memoryManager, NodeSetType::eComplete);
+
+        theChildren.addName(s_documentElement);
+
+        applyTemplates(theChildren, theMode);
+    }
+
+    const NameIndexVectorType::const_iterator   theEnd = theNodes.m_names.end();
+
+    for (NameIndexVectorType::const_iterator i = theNodes.m_names.begin();
+            i != theEnd && m_isProjectable == true;
+                ++i)
+    {
+        if (*i == s_documentElement)
+        {
+            // The document element can only be processed by a template
+            // for its name, so the name is checked before it's built.
+            if (fMatchesAnyElement == true || theExactNames.empty() == true)
+            {
+                m_isProjectable = false;
+            }
+            else if (m_restrictDocumentElement == false)
+            {
+                m_restrictDocumentElement = true;
+
+                m_documentElementNames = theExactNames;
+            }
+            else
+            {
+                NameIndexVectorType     theNames(m_memoryManager);
+
+                const NameIndexVectorType::const_iterator   theNamesEnd = m_documentElementNames.end();
+
+                for (NameIndexVectorType::const_iterator j = m_documentElementNames.begin(); j != theNamesEnd; ++j)
+                {
+                    if (containsName(theExactNames, *j) == true)
+                    {
+                        theNames.push_back(*j);
+                    }
+                }
+
+                m_documentElementNames.swap(theNames);
+            }
+        }
+        else if (fMatchesAnyElement == true ||
+                 containsName(theExactNames, *i) == false)
+        {
+            // Some elements with the name might be processed by the
+            // built-in rule, which outputs their text.
+            requireSubtree(*i);
+        }
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::getModeTemplates(
+            const XalanQName&       theMode,
+            bool&                   fMatchesRoot,
+            bool&                   fMatchesAnyElement,
+            NameIndexVectorType&    theExactNames)
+{
+    NodeSetType     theMatchedNodes(m_memoryManager);
+
+    const TemplateVectorType::const_iterator    theEnd = m_templates.end();
+
+    for (TemplateVectorType::const_iterator i = m_templates.begin(); i != theEnd; ++i)
+    {
+        assert(*i != 0);
+
+        const XPath* const  theMatchPattern = (*i)->getXPath(0);
+
+        if (theMatchPattern != 0 && (*i)->getMode() == theMode)
+        {
+            theMatchedNodes.clear();
+
+            analyzePattern(
+                theMatchPattern->getExpression(),
+                false,
+                theMatchedNodes,
+                fMatchesAnyElement,
+                theExactNames);
+
+            if ((theMatchedNodes.m_flags & NodeSetType::eRoot) != 0)
+            {
+                fMatchesRoot = true;
+            }
+        }
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::collectStylesheet(const Stylesheet&    theStylesheet)
+{
+    for (const ElemTemplate* theTemplate = theStylesheet.m_firstTemplate;
+            theTemplate != 0;
+                theTemplate = static_cast<const ElemTemplate*>(theTemplate->getNextSiblingElem()))
+    {
+        m_templates.push_back(theTemplate);
+    }
+
+    // The nodes that a key can yield are the elements named by the
+    // last steps of its patterns.
+    {
+        typedef Stylesheet::KeyDeclarationVectorType::const_iterator    const_iterator;
+
+        NameIndexVectorType     theExactNames(m_memoryManager);
+
+        const const_iterator    theEnd = theStylesheet.m_keyDeclarations.end();
+
+        for (const_iterator i = theStylesheet.m_keyDeclarations.begin(); i != theEnd; ++i)
+        {
+            const XPath* const  theMatchPattern = (*i).getMatchPattern();
+            assert(theMatchPattern != 0);
+
+            NodeSetType     theMatchedNodes(m_memoryManager);
+
+            bool    fMatchesAnyElement = false;
+
+            analyzePattern(
+                theMatchPattern->getExpression(),
+                false,
+                theMatchedNodes,
+                fMatchesAnyElement,
+                theExactNames);
+
+            if (theMatchedNodes.m_flags != 0 || fMatchesAnyElement == true)
+            {
+                m_isProjectable = false;
+            }
+
+            m_keyNodes.add(theMatchedNodes);
+        }
+    }
+
+    typedef Stylesheet::StylesheetVectorType::const_iterator    const_iterator;
+
+    const const_iterator    theEnd = theStylesheet.m_imports.end();
+
+    for (const_iterator i = theStylesheet.m_imports.begin(); i != theEnd; ++i)
+    {
+        assert(*i != 0);
+
+        collectStylesheet(**i);
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzeStylesheet(const Stylesheet&    theStylesheet)
+{
+    const NodeSetType   theRoot(m_memoryManager, NodeSetType::eRoot);
+
+    NodeSetType     theResult(m_memoryManager);
+
+    {
+        typedef Stylesheet::KeyDeclarationVectorType::const_iterator    const_iterator;
+
+        NameIndexVectorType     theExactNames(m_memoryManager);
+
+        const const_iterator    theEnd = theStylesheet.m_keyDeclarations.end();
+
+        for (const_iterator i = theStylesheet.m_keyDeclarations.begin();
+                i != theEnd && m_isProjectable == true;
+                    ++i)
+        {
+            const XPath* const  theMatchPattern = (*i).getMatchPattern();
+            assert(theMatchPattern != 0);
+
+            NodeSetType     theMatchedNodes(m_memoryManager);
+
+            bool    fMatchesAnyElement = false;
+
+            analyzePattern(
+                theMatchPattern->getExpression(),
+                true,
+                theMatchedNodes,
+                fMatchesAnyElement,
+                theExactNames);
+
+            const XPath* const  theUse = (*i).getUse();
+            assert(theUse != 0);
+
+            theResult.clear();
+
+            analyzeXPath(*theUse, theMatchedNodes, theResult);
+
+            useValue(theResult);
+        }
+    }
+
+    {
+        typedef Stylesheet::ElemVariableVectorType::const_iterator  const_iterator;
+
+        const const_iterator    theEnd = theStylesheet.m_topLevelVariables.end();
+
+        for (const_iterator i = theStylesheet.m_topLevelVariables.begin();
+                i != theEnd && m_isProjectable == true;
+                    ++i)
+        {
+            assert(*i != 0);
+
+            analyzeElement(**i, theRoot);
+        }
+    }
+
+    for (const ElemTemplate* theTemplate = theStylesheet.m_firstTemplate;
+            theTemplate != 0 && m_isProjectable == true;
+                theTemplate = static_cast<const ElemTemplate*>(theTemplate->getNextSiblingElem()))
+    {
+        const XPath* const  theMatchPattern = theTemplate->getXPath(0);
+
+        if (theMatchPattern != 0)
+        {
+            // The body is executed for the nodes that the pattern
+            // matches.  Named templates are analyzed where they are
+            // called.
+            NodeSetType     theMatchedNodes(m_memoryManager);
+
+            NameIndexVectorType     theExactNames(m_memoryManager);
+
+            bool    fMatchesAnyElement = false;
+
+            analyzePattern(
+                theMatchPattern->getExpression(),
+                true,
+                theMatchedNodes,
+                fMatchesAnyElement,
+                theExactNames);
+
+            analyzeChildren(*theTemplate, theMatchedNodes);
+        }
+    }
+
+    typedef Stylesheet::StylesheetVectorType::const_iterator    const_iterator;
+
+    const const_iterator    theEnd = theStylesheet.m_imports.end();
+
+    for (const_iterator i = theStylesheet.m_imports.begin();
+            i != theEnd && m_isProjectable == true;
+                ++i)
+    {
+        assert(*i != 0);
+
+        analyzeStylesheet(**i);
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzeElement(
+            const ElemTemplateElement&  theElement,
+            const NodeSetType&          theContext)
+{
+    if (m_isProjectable == false)
+    {
+        return;
+    }
+
+    NodeSetType     theResult(m_memoryManager);
+
+    switch(theElement.getXSLToken())
+    {
+    case StylesheetConstructionContext::ELEMNAME_NUMBER:
+    case StylesheetConstructionContext::ELEMNAME_EXTENSION:
+    case StylesheetConstructionContext::ELEMNAME_EXTENSION_CALL:
+    case StylesheetConstructionContext::ELEMNAME_EXTENSION_HANDLER:
+    case StylesheetConstructionContext::ELEMNAME_FORWARD_COMPATIBLE:
+    case StylesheetConstructionContext::ELEMNAME_UNDEFINED:
+        // xsl:number counts preceding nodes, and extensions can
+        // do anything.
+        m_isProjectable = false;
+        return;
+
+    case StylesheetConstructionContext::ELEMNAME_APPLY_TEMPLATES:
+        {
+            const XPath* const  theSelect = theElement.getXPath(0);
+            assert(theSelect != 0);
+
+            analyzeXPath(*theSelect, theContext, theResult);
+
+            analyzeSortElements(theElement, theContext, theResult);
+
+            applyTemplates(
+                theResult,
+                static_cast<const ElemApplyTemplates&>(theElement).getMode());
+
+            analyzeChildren(theElement, theContext);
+        }
+        return;
+
+    case StylesheetConstructionContext::ELEMNAME_FOR_EACH:
+        {
+            const XPath* const  theSelect = theElement.getXPath(0);
+            assert(theSelect != 0);
+
+            analyzeXPath(*theSelect, theContext, theResult);
+
+            useNodes(theResult);
+
+            analyzeSortElements(theElement, theContext, theResult);
+
+            analyzeChildren(theElement, theResult);
+        }
+        return;
+
+    case StylesheetConstructionContext::ELEMNAME_CALL_TEMPLATE:
+        {
+            const ElemTemplate* const   theTemplate =
+                static_cast<const ElemCallTemplate&>(theElement).getTemplate();
+
+            if (theTemplate != 0)
+            {
+                analyzeCalledTemplate(*theTemplate, theContext);
+            }
+
+            analyzeChildren(theElement, theContext);
+        }
+        return;
+
+    case StylesheetConstructionContext::ELEMNAME_APPLY_IMPORTS:
+        // The imported templates, or the built-in rules, can be
+        // executed for the current node.
+        useValue(theContext);
+        return;
+
+    case StylesheetConstructionContext::ELEMNAME_VALUE_OF:
+    case StylesheetConstructionContext::ELEMNAME_COPY_OF:
+        // A select of "." is not compiled, so there is no XPath.
+        if (theElement.getXPath(0) == 0)
+        {
+            useValue(theContext);
+        }
+        break;
+
+    case StylesheetConstructionContext::ELEMNAME_VARIABLE:
+    case StylesheetConstructionContext::ELEMNAME_PARAM:
+    case StylesheetConstructionContext::ELEMNAME_WITH_PARAM:
+        {
+            const XPath* const  theSelect = theElement.getXPath(0);
+
+            if (theSelect != 0)
+            {
+                analyzeXPath(*theSelect, theContext, theResult);
+
+                m_nextVariableNodes.add(theResult);
+            }
+            else if (theElement.getFirstChildElem() != 0)
+            {
+                // A result tree fragment.
+                m_nextVariableNodes.m_flags |= NodeSetType::eComplete;
+            }
+
+            analyzeChildren(theElement, theContext);
+        }
+        return;
+
+    case StylesheetConstructionContext::ELEMNAME_IF:
+    case StylesheetConstructionContext::ELEMNAME_WHEN:
+        {
+            const XPath* const  theTest = theElement.getXPath(0);
+            assert(theTest != 0);
+
+            analyzeXPath(*theTest, theContext, theResult);
+
+            useNodes(theResult);
+
+            analyzeChildren(theElement, theContext);
+        }
+        return;
+
+    default:
+        break;
+    }
+
+    const XPath*    theXPath = 0;
+
+    for (XalanSize_t i = 0;
+            m_isProjectable == true && (theXPath = theElement.getXPath(i)) != 0;
+                ++i)
+    {
+        theResult.clear();
+
+        analyzeXPath(*theXPath, theContext, theResult);
+
+        useValue(theResult);
+    }
+
+    analyzeChildren(theElement, theContext);
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzeChildren(
+            const ElemTemplateElement&  theElement,
+            const NodeSetType&          theContext)
+{
+    for (const ElemTemplateElement* theChild = theElement.getFirstChildElem();
+            theChild != 0 && m_isProjectable == true;
+                theChild = theChild->getNextSiblingElem())
+    {
+        analyzeElement(*theChild, theContext);
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzeSortElements(
+            const ElemTemplateElement&  theElement,
+            const NodeSetType&          theContext,
+            const NodeSetType&          theSelected)
+{
+    typedef ElemForEach::SortElemsVectorType    SortElemsVectorType;
+
+    const SortElemsVectorType&  theSortElems =
+        static_cast<const ElemForEach&>(theElement).getSortElems();
+
+    NodeSetType     theResult(m_memoryManager);
+
+    const SortElemsVectorType::const_iterator   theEnd = theSortElems.end();
+
+    for (SortElemsVectorType::const_iterator i = theSortElems.begin();
+            i != theEnd && m_isProjectable == true;
+                ++i)
+    {
+        assert(*i != 0);
+
+        const ElemSort&     theSort = **i;
+
+        const XPath* const  theSelect = theSort.getSelectPattern();
+
+        if (theSelect == 0)
+        {
+            // A select of "." is not compiled, so there is no XPath.
+            useValue(theSelected);
+        }
+        else
+        {
+            theResult.clear();
+
+            analyzeXPath(*theSelect, theSelected, theResult);
+
+            useValue(theResult);
+        }
+
+        // The AVTs are evaluated once, for the instruction's current
+        // node, and their XPaths follow the select in the index.
+        const XPath*    theXPath = 0;
+
+        for (XalanSize_t j = theSelect == 0 ? 0 : 1;
+                m_isProjectable == true && (theXPath = theSort.getXPath(j)) != 0;
+                    ++j)
+        {
+            theResult.clear();
+
+            analyzeXPath(*theXPath, theContext, theResult);
+
+            useValue(theResult);
+        }
+    }
+}
+
+
+
+void
+XalanProjectionAnalyzer::analyzeCalledTemplate(
+            const ElemTemplateElement&  theTemplate,
+            const NodeSetType&          theContext)
+{
+    NodeSetType*&   theCalledContext = m_calledTemplates[&theTemplate];
+
+    if (theCalledContext == 0)
+    {
+        XalanConstruct(m_memoryManager, theCalledContext, m_memoryManager, 0);
+    }
+    else if (theCalledContext->contains(theContext) == true)
+    {
+        // Already analyzed, or being analyzed, for these nodes.
+        return;
+    }
+
+    theCalledContext->add(theContext);
+
+    // The entry can grow while the body is analyzed, if the
+    // template calls itself.
+    const NodeSetType   theBodyContext(*theCalledContext, m_memoryManager);
+
+    analyzeChildren(theTemplate, theBodyContext);
+}
+
+
+
+void
+XalanProjectionAnalyzer::clearCalledTemplates()
+{
+    const CalledTemplateMapType::iterator   theEnd = m_calledTemplates.end();
+
+    for (CalledTemplateMapType::iterator i = m_calledTemplates.begin(); i != theEnd; ++i)
+    {
+        XalanDestroy(m_memoryManager, (*i).second);
+    }
+
+    m_calledTemplates.clear();
+}
+
+
+
+}
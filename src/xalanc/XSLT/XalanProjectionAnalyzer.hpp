@@ -0,0 +1,341 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALAN_PROJECTIONANALYZER_HEADER_GUARD)
+#define XALAN_PROJECTIONANALYZER_HEADER_GUARD
+
+
+
+// Base include file.  Must be first.
+#include "XSLTDefinitions.hpp"
+
+
+
+#include <xalanc/Include/XalanMap.hpp>
+#include <xalanc/Include/XalanVector.hpp>
+
+
+
+#include <xalanc/XPath/XPath.hpp>
+
+
+
+#include <xalanc/XalanSourceTree/XalanSourceTreeProjection.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+class ElemTemplate;
+class ElemTemplateElement;
+class Stylesheet;
+class StylesheetRoot;
+class XalanQName;
+
+
+
+/**
+ * This class finds the elements of a source document that a stylesheet
+ * can reach, so that the rest of the document need not be built.
+ *
+ * Every element that a location path or a pattern names is built, along
+ * with its attributes and its ancestors, but its content is only built
+ * when the stylesheet uses its string value, copies it, or steps into it
+ * with a wildcard or a node type test.  The analysis gives up when the
+ * stylesheet might reach skipped nodes, for example through a wildcard
+ * step from an ancestor or the string value of the root, or when it uses
+ * extension functions and elements, id() or xsl:number.
+ */
+class XALAN_XSLT_EXPORT XalanProjectionAnalyzer
+{
+public:
+
+    XalanProjectionAnalyzer(MemoryManager&  theManager);
+
+    ~XalanProjectionAnalyzer();
+
+    /**
+     * Analyze a stylesheet and its imports, and find the elements
+     * of a source document it can reach.
+     *
+     * @param theStylesheet The stylesheet to analyze
+     * @param theProjection The projection for the elements
+     * @return true if the projection holds everything the stylesheet can reach, false if not.
+     */
+    bool
+    analyze(
+            const StylesheetRoot&           theStylesheet,
+            XalanSourceTreeProjection&      theProjection);
+
+private:
+
+    typedef XPath::OpCodeMapPositionType        OpCodeMapPositionType;
+    typedef XPath::OpCodeMapValueType           OpCodeMapValueType;
+    typedef XalanSourceTreeProjection::size_type    NameIndexType;
+    typedef XalanVector<NameIndexType>          NameIndexVectorType;
+
+    /**
+     * The kinds of nodes that a node-set can hold.  A node-set which
+     * holds nothing is a value of another type.
+     */
+    class NodeSetType
+    {
+    public:
+
+        enum eFlags
+        {
+            // Nodes whose content is always built.
+            eComplete = 1,
+
+            // The root.
+            eRoot = 2,
+
+            // Nodes which are built, but whose content may not be.
+            eAncestor = 4,
+
+            // Nodes which may not be built at all.
+            eIncomplete = 8
+        };
+
+        explicit
+        NodeSetType(
+                MemoryManager&  theManager,
+                int             theFlags = 0);
+
+        NodeSetType(
+                const NodeSetType&  theSource,
+                MemoryManager&      theManager);
+
+        NodeSetType&
+        operator=(const NodeSetType&    theRHS);
+
+        void
+        add(const NodeSetType&  theOther);
+
+        void
+        addName(NameIndexType   theName);
+
+        bool
+        contains(const NodeSetType&     theOther) const;
+
+        bool
+        isEmpty() const
+        {
+            return m_flags == 0 && m_names.empty() == true;
+        }
+
+        void
+        clear()
+        {
+            m_flags = 0;
+
+            m_names.clear();
+        }
+
+        // Any of eFlags.
+        int                 m_flags;
+
+        // The names of the elements, which are built along with the
+        // content that the stylesheet needs.
+        NameIndexVectorType     m_names;
+
+    private:
+
+        // Not implemented...
+        NodeSetType(const NodeSetType&);
+    };
+
+    typedef XalanVector<const ElemTemplate*>                TemplateVectorType;
+    typedef XalanMap<const ElemTemplateElement*, NodeSetType*>  CalledTemplateMapType;
+
+    void
+    analyzeExpression(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            const NodeSetType&      theContext,
+            const NodeSetType&      theCurrent,
+            NodeSetType&            theResult);
+
+    void
+    analyzeArguments(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   theFirstPos,
+            OpCodeMapPositionType   theEndPos,
+            const NodeSetType&      theContext,
+            const NodeSetType&      theCurrent,
+            bool                    fUsesValues);
+
+    void
+    analyzeLocationPath(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            const NodeSetType&      theContext,
+            const NodeSetType&      theCurrent,
+            NodeSetType&            theResult);
+
+    void
+    analyzeStep(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            const NodeSetType&      theContext,
+            NodeSetType&            theResult);
+
+    void
+    analyzeFunction(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            const NodeSetType&      theContext,
+            const NodeSetType&      theCurrent,
+            NodeSetType&            theResult);
+
+    void
+    analyzePredicates(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType&  opPos,
+            const NodeSetType&      theContext,
+            const NodeSetType&      theCurrent);
+
+    void
+    analyzePattern(
+            const XPathExpression&  theExpression,
+            bool                    fAnalyzePredicates,
+            NodeSetType&            theMatchedNodes,
+            bool&                   fMatchesAnyElement,
+            NameIndexVectorType&    theExactNames);
+
+    bool
+    getElementName(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   theNodeTestPos,
+            NameIndexType&          theName);
+
+    void
+    analyzeXPath(
+            const XPath&        theXPath,
+            const NodeSetType&  theContext,
+            NodeSetType&        theResult);
+
+    void
+    useValue(const NodeSetType&     theNodes);
+
+    void
+    useNodes(const NodeSetType&     theNodes);
+
+    void
+    requireSubtree(NameIndexType    theName);
+
+    void
+    applyTemplates(
+            const NodeSetType&  theNodes,
+            const XalanQName&   theMode);
+
+    void
+    getModeTemplates(
+            const XalanQName&       theMode,
+            bool&                   fMatchesRoot,
+            bool&                   fMatchesAnyElement,
+            NameIndexVectorType&    theExactNames);
+
+    void
+    collectStylesheet(const Stylesheet&     theStylesheet);
+
+    void
+    analyzeStylesheet(const Stylesheet&     theStylesheet);
+
+    void
+    analyzeElement(
+            const ElemTemplateElement&  theElement,
+            const NodeSetType&          theContext);
+
+    void
+    analyzeChildren(
+            const ElemTemplateElement&  theElement,
+            const NodeSetType&          theContext);
+
+    void
+    analyzeSortElements(
+            const ElemTemplateElement&  theElement,
+            const NodeSetType&          theContext,
+            const NodeSetType&          theSelected);
+
+    void
+    analyzeCalledTemplate(
+            const ElemTemplateElement&  theTemplate,
+            const NodeSetType&          theContext);
+
+    void
+    clearCalledTemplates();
+
+
+    // Data members...
+    MemoryManager&      m_memoryManager;
+
+    XalanSourceTreeProjection*  m_projection;
+
+    bool                m_isProjectable;
+
+    // All of the templates in the stylesheet and its imports.
+    TemplateVectorType  m_templates;
+
+    // The nodes that a variable reference can yield, which are
+    // the nodes of all variables and parameters.
+    NodeSetType         m_variableNodes;
+
+    NodeSetType         m_nextVariableNodes;
+
+    // The nodes that the key() function can yield.
+    NodeSetType         m_keyNodes;
+
+    // The names that the document element may have, when it's
+    // processed by templates.
+    NameIndexVectorType     m_documentElementNames;
+
+    bool                m_restrictDocumentElement;
+
+    // The contexts in which each called template has been analyzed.
+    CalledTemplateMapType   m_calledTemplates;
+
+    // The IDs of the functions in the function table which need
+    // special treatment.
+    int                 m_currentID;
+
+    int                 m_documentID;
+
+    int                 m_generateIDID;
+
+    int                 m_idID;
+
+    int                 m_keyID;
+
+    int                 m_normalizeSpaceID;
+
+    int                 m_numberID;
+
+    int                 m_stringID;
+
+    int                 m_stringLengthID;
+};
+
+
+
+}
+
+
+
+#endif  // XALAN_PROJECTIONANALYZER_HEADER_GUARD
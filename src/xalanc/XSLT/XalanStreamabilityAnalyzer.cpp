@@ -0,0 +1,1089 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "XalanStreamabilityAnalyzer.hpp"
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+#include <xalanc/XPath/XPathExpression.hpp>
+
+
+
+#include "Constants.hpp"
+#include "ElemAttributeSet.hpp"
+#include "ElemCallTemplate.hpp"
+#include "ElemForEach.hpp"
+#include "ElemSort.hpp"
+#include "ElemTemplate.hpp"
+#include "ElemVariable.hpp"
+#include "StylesheetConstructionContext.hpp"
+#include "StylesheetRoot.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+static int
+getFunctionID(
+            const char*         theName,
+            XalanDOMString&     theBuffer)
+{
+    theBuffer = theName;
+
+    return XPath::getFunctionTable().nameToID(theBuffer);
+}
+
+
+
+XalanStreamabilityAnalyzer::XalanStreamabilityAnalyzer(MemoryManager&  theManager) :
+    m_memoryManager(theManager),
+    m_isStreamable(true),
+    m_attributeSetsContentFree(true),
+    m_contentFreeTemplates(theManager),
+    m_rootTemplates(theManager),
+    m_numericFunctionIDs(theManager),
+    m_currentID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_generateIDID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_idID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_keyID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_lastID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_normalizeSpaceID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_numberID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_positionID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_stringID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_stringLengthID(XPathFunctionTable::InvalidFunctionNumberID),
+    m_unparsedEntityURIID(XPathFunctionTable::InvalidFunctionNumberID)
+{
+    XalanDOMString  theBuffer(theManager);
+
+    m_currentID = getFunctionID("current", theBuffer);
+    m_generateIDID = getFunctionID("generate-id", theBuffer);
+    m_idID = getFunctionID("id", theBuffer);
+    m_keyID = getFunctionID("key", theBuffer);
+    m_lastID = getFunctionID("last", theBuffer);
+    m_normalizeSpaceID = getFunctionID("normalize-space", theBuffer);
+    m_numberID = getFunctionID("number", theBuffer);
+    m_positionID = getFunctionID("position", theBuffer);
+    m_stringID = getFunctionID("string", theBuffer);
+    m_stringLengthID = getFunctionID("string-length", theBuffer);
+    m_unparsedEntityURIID = getFunctionID("unparsed-entity-uri", theBuffer);
+
+    static const char* const    theNumericFunctions[] =
+    {
+        "ceiling",
+        "count",
+        "floor",
+        "last",
+        "number",
+        "position",
+        "round",
+        "string-length",
+        "sum"
+    };
+
+    const size_t    theCount = sizeof(theNumericFunctions) / sizeof(theNumericFunctions[0]);
+
+    for (size_t i = 0; i < theCount; ++i)
+    {
+        m_numericFunctionIDs.push_back(getFunctionID(theNumericFunctions[i], theBuffer));
+    }
+}
+
+
+
+XalanStreamabilityAnalyzer::~XalanStreamabilityAnalyzer()
+{
+}
+
+
+
+bool
+XalanStreamabilityAnalyzer::analyze(StylesheetRoot&     theStylesheet)
+{
+    m_isStreamable = true;
+    m_attributeSetsContentFree = true;
+    m_contentFreeTemplates.clear();
+    m_rootTemplates.clear();
+
+    // Attribute sets are executed with the current node as the
+    // context, so they must not use its content.
+    {
+        typedef StylesheetRoot::AttributeSetMapType::const_iterator     const_iterator;
+        typedef StylesheetRoot::AttributeSetVectorType::const_iterator  vector_iterator;
+
+        const const_iterator    theEnd = theStylesheet.m_attributeSetsMap.end();
+
+        for (const_iterator i = theStylesheet.m_attributeSetsMap.begin(); i != theEnd; ++i)
+        {
+            const vector_iterator   theVectorEnd = (*i).second.end();
+
+            for (vector_iterator j = (*i).second.begin(); j != theVectorEnd; ++j)
+            {
+                assert(*j != 0);
+
+                analyzeElement(**j);
+
+                if (isContentFree(**j) == false)
+                {
+                    m_attributeSetsContentFree = false;
+                }
+            }
+        }
+    }
+
+    analyzeStylesheet(theStylesheet);
+
+    if (m_isStreamable == true)
+    {
+        ElemTemplateElement* const  theDefaultRules[] =
+        {
+            theStylesheet.m_defaultRule,
+            theStylesheet.m_defaultTextRule,
+            theStylesheet.m_defaultRootRule
+        };
+
+        const size_t    theCount = sizeof(theDefaultRules) / sizeof(theDefaultRules[0]);
+
+        for (size_t i = 0; i < theCount; ++i)
+        {
+            if (theDefaultRules[i] != 0)
+            {
+                analyzeTemplate(*theDefaultRules[i]);
+            }
+        }
+
+        // The root of the document is never available as a complete
+        // tree, so everything which processes it must be streamable.
+        if (theStylesheet.m_defaultRootRule == 0 ||
+            theStylesheet.m_defaultRootRule->isStreamable() == false)
+        {
+            m_isStreamable = false;
+        }
+        else
+        {
+            const TemplateVectorType::const_iterator    theEnd = m_rootTemplates.end();
+
+            for (TemplateVectorType::const_iterator i = m_rootTemplates.begin(); i != theEnd; ++i)
+            {
+                assert(*i != 0);
+
+                if ((*i)->isStreamable() == false)
+                {
+                    m_isStreamable = false;
+
+                    break;
+                }
+            }
+        }
+    }
+
+    m_contentFreeTemplates.clear();
+    m_rootTemplates.clear();
+
+    return m_isStreamable;
+}
+
+
+
+int
+XalanStreamabilityAnalyzer::analyzeExpression(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            eContext                theContext) const
+{
+    const OpCodeMapValueType    theOpCode = theExpression.getOpCodeMapValue(opPos);
+
+    switch(theOpCode)
+    {
+    case XPathExpression::eOP_XPATH:
+    case XPathExpression::eOP_OR:
+    case XPathExpression::eOP_AND:
+    case XPathExpression::eOP_NOTEQUALS:
+    case XPathExpression::eOP_EQUALS:
+    case XPathExpression::eOP_LTE:
+    case XPathExpression::eOP_LT:
+    case XPathExpression::eOP_GTE:
+    case XPathExpression::eOP_GT:
+    case XPathExpression::eOP_PLUS:
+    case XPathExpression::eOP_MINUS:
+    case XPathExpression::eOP_MULT:
+    case XPathExpression::eOP_DIV:
+    case XPathExpression::eOP_MOD:
+    case XPathExpression::eOP_NEG:
+    case XPathExpression::eOP_BOOL:
+    case XPathExpression::eOP_UNION:
+    case XPathExpression::eOP_GROUP:
+    case XPathExpression::eOP_ARGUMENT:
+    case XPathExpression::eOP_FUNCTION_COUNT:
+    case XPathExpression::eOP_FUNCTION_NOT:
+    case XPathExpression::eOP_FUNCTION_BOOLEAN:
+    case XPathExpression::eOP_FUNCTION_NAME_1:
+    case XPathExpression::eOP_FUNCTION_LOCALNAME_1:
+    case XPathExpression::eOP_FUNCTION_FLOOR:
+    case XPathExpression::eOP_FUNCTION_CEILING:
+    case XPathExpression::eOP_FUNCTION_ROUND:
+    case XPathExpression::eOP_FUNCTION_NUMBER_1:
+    case XPathExpression::eOP_FUNCTION_STRING_1:
+    case XPathExpression::eOP_FUNCTION_STRINGLENGTH_1:
+    case XPathExpression::eOP_FUNCTION_NAMESPACEURI_1:
+    case XPathExpression::eOP_FUNCTION_SUM:
+    case XPathExpression::eOP_FUNCTION_CONCAT:
+    case XPathExpression::eOP_FUNCTION_TRANSLATE:
+        {
+            int     theFlags = 0;
+
+            const OpCodeMapPositionType     theEnd =
+                theExpression.getNextOpCodePosition(opPos);
+
+            // The table index and the argument count precede the
+            // arguments of a compiled translate() call.
+            const OpCodeMapPositionType     theStart =
+                theExpression.getOpCodeMapValue(opPos) == XPathExpression::eOP_FUNCTION_TRANSLATE ?
+                    opPos + 4 : opPos + 2;
+
+            for (OpCodeMapPositionType i = theStart;
+                    i < theEnd && theExpression.getOpCodeMapValue(i) != XPathExpression::eENDOP;
+                        i = theExpression.getNextOpCodePosition(i))
+            {
+                theFlags |= analyzeExpression(theExpression, i, theContext);
+            }
+
+            return theFlags;
+        }
+
+    case XPathExpression::eOP_LITERAL:
+    case XPathExpression::eOP_NUMBERLIT:
+    case XPathExpression::eOP_FUNCTION_TRUE:
+    case XPathExpression::eOP_FUNCTION_FALSE:
+    case XPathExpression::eOP_FUNCTION_NAME_0:
+    case XPathExpression::eOP_FUNCTION_LOCALNAME_0:
+    case XPathExpression::eOP_FUNCTION_NAMESPACEURI_0:
+        return 0;
+
+    case XPathExpression::eOP_VARIABLE:
+        return eUsesVariables;
+
+    case XPathExpression::eOP_FUNCTION_POSITION:
+        return eUsesPosition;
+
+    case XPathExpression::eOP_FUNCTION_LAST:
+        return eUsesPosition | eNotStreamable;
+
+    case XPathExpression::eOP_FUNCTION_NUMBER_0:
+    case XPathExpression::eOP_FUNCTION_STRING_0:
+    case XPathExpression::eOP_FUNCTION_STRINGLENGTH_0:
+        return theContext == eElementContext ? eUsesContent : 0;
+
+    case XPathExpression::eOP_FUNCTION:
+        return analyzeFunction(theExpression, opPos, theContext);
+
+    case XPathExpression::eOP_LOCATIONPATH:
+        return analyzeLocationPath(theExpression, opPos, theContext);
+
+    default:
+        // Extension functions, and anything else we don't know about.
+        return eNotStreamable;
+    }
+}
+
+
+
+int
+XalanStreamabilityAnalyzer::analyzeLocationPath(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            eContext                theContext) const
+{
+    int     theFlags = 0;
+
+    OpCodeMapPositionType   theStepPos = opPos + 2;
+
+    while (theExpression.getOpCodeMapValue(theStepPos) != XPathExpression::eENDOP)
+    {
+        const OpCodeMapValueType    theStepType = theExpression.getOpCodeMapValue(theStepPos);
+
+        switch(theStepType)
+        {
+        case XPathExpression::eOP_VARIABLE:
+        case XPathExpression::eOP_FUNCTION:
+        case XPathExpression::eOP_EXTFUNCTION:
+        case XPathExpression::eOP_GROUP:
+            {
+                // A filter expression.  The nodes it yields are
+                // complete, since they don't come from the current
+                // node, so the steps which follow don't use any content.
+                theFlags |= analyzeExpression(theExpression, theStepPos, theContext);
+
+                theContext = eOtherContext;
+
+                OpCodeMapPositionType   thePredicatePos =
+                    theExpression.getNextOpCodePosition(theStepPos);
+
+                theFlags |= analyzePredicates(theExpression, thePredicatePos, theContext);
+
+                theStepPos = thePredicatePos;
+            }
+            continue;
+
+        case XPathExpression::eFROM_ATTRIBUTES:
+        case XPathExpression::eFROM_NAMESPACE:
+            if (theContext == eElementContext)
+            {
+                theContext = eAttributeContext;
+            }
+            break;
+
+        case XPathExpression::eFROM_CHILDREN:
+        case XPathExpression::eFROM_DESCENDANTS:
+        case XPathExpression::eFROM_DESCENDANTS_OR_SELF:
+        case XPathExpression::eFROM_SELF:
+            if (theContext == eElementContext)
+            {
+                theFlags |= eUsesContent;
+            }
+            break;
+
+        default:
+            // The root, and any axis which goes up or sideways.
+            return theFlags | eNotStreamable;
+        }
+
+        OpCodeMapPositionType   thePredicatePos =
+            theStepPos + theExpression.getOpCodeMapValue(theStepPos + 2);
+
+        theFlags |= analyzePredicates(theExpression, thePredicatePos, theContext);
+
+        theStepPos += theExpression.getOpCodeMapValue(theStepPos + 1);
+    }
+
+    return theFlags;
+}
+
+
+
+int
+XalanStreamabilityAnalyzer::analyzeFunction(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            eContext                theContext) const
+{
+    const int   theFunctionID = theExpression.getOpCodeMapValue(opPos + 2);
+    const int   theArgCount = theExpression.getOpCodeMapValue(opPos + 3);
+
+    int     theFlags = 0;
+
+    if (theFunctionID == m_idID ||
+        theFunctionID == m_keyID ||
+        theFunctionID == m_lastID ||
+        theFunctionID == m_generateIDID ||
+        theFunctionID == m_unparsedEntityURIID)
+    {
+        theFlags |= eNotStreamable;
+    }
+    else if (theFunctionID == m_currentID)
+    {
+        theFlags |= eUsesContent;
+    }
+    else if (theFunctionID == m_positionID)
+    {
+        theFlags |= eUsesPosition;
+    }
+    else if (theArgCount == 0 &&
+             theContext == eElementContext &&
+             (theFunctionID == m_stringID ||
+              theFunctionID == m_numberID ||
+              theFunctionID == m_stringLengthID ||
+              theFunctionID == m_normalizeSpaceID))
+    {
+        theFlags |= eUsesContent;
+    }
+
+    const OpCodeMapPositionType     theEnd =
+        theExpression.getNextOpCodePosition(opPos);
+
+    for (OpCodeMapPositionType i = opPos + 4;
+            i < theEnd && theExpression.getOpCodeMapValue(i) != XPathExpression::eENDOP;
+                i = theExpression.getNextOpCodePosition(i))
+    {
+        theFlags |= analyzeExpression(theExpression, i, theContext);
+    }
+
+    return theFlags;
+}
+
+
+
+int
+XalanStreamabilityAnalyzer::analyzePredicates(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType&  opPos,
+            eContext                theContext) const
+{
+    int     theFlags = 0;
+
+    for (;;)
+    {
+        const OpCodeMapValueType    theOpCode = theExpression.getOpCodeMapValue(opPos);
+
+        if (theOpCode != XPathExpression::eOP_PREDICATE &&
+            theOpCode != XPathExpression::eOP_PREDICATE_WITH_POSITION)
+        {
+            break;
+        }
+
+        theFlags |= analyzeExpression(theExpression, opPos + 2, theContext);
+
+        opPos = theExpression.getNextOpCodePosition(opPos);
+    }
+
+    return theFlags;
+}
+
+
+
+int
+XalanStreamabilityAnalyzer::analyzePattern(
+            const XPathExpression&  theExpression,
+            bool&                   fMatchesRoot) const
+{
+    fMatchesRoot = false;
+
+    int     theFlags = 0;
+
+    OpCodeMapPositionType   thePathPos = theExpression.getInitialOpCodePosition() + 2;
+
+    while (theExpression.getOpCodeMapValue(thePathPos) == XPathExpression::eOP_LOCATIONPATHPATTERN)
+    {
+        OpCodeMapPositionType   theStepPos = thePathPos + 2;
+
+        bool    fRootOnly = true;
+
+        while (theExpression.getOpCodeMapValue(theStepPos) != XPathExpression::eENDOP)
+        {
+            const OpCodeMapValueType    theStepType = theExpression.getOpCodeMapValue(theStepPos);
+
+            switch(theStepType)
+            {
+            case XPathExpression::eFROM_ROOT:
+                break;
+
+            case XPathExpression::eMATCH_ATTRIBUTE:
+            case XPathExpression::eMATCH_ANY_ANCESTOR:
+            case XPathExpression::eMATCH_IMMEDIATE_ANCESTOR:
+            case XPathExpression::eMATCH_ANY_ANCESTOR_WITH_PREDICATE:
+                fRootOnly = false;
+                break;
+
+            default:
+                // id() and key() patterns.
+                return theFlags | eNotStreamable;
+            }
+
+            const eContext  theContext = theStepType == XPathExpression::eMATCH_ATTRIBUTE ?
+                                            eAttributeContext : eElementContext;
+
+            // A predicate in a pattern is evaluated before the node is
+            // complete, and without its siblings, so it can only test
+            // the name and the attributes of the node.
+            OpCodeMapPositionType   thePredicatePos =
+                theStepPos + theExpression.getOpCodeMapValue(theStepPos + 2);
+
+            for (;;)
+            {
+                const OpCodeMapValueType    theOpCode = theExpression.getOpCodeMapValue(thePredicatePos);
+
+                if (theOpCode != XPathExpression::eOP_PREDICATE &&
+                    theOpCode != XPathExpression::eOP_PREDICATE_WITH_POSITION)
+                {
+                    break;
+                }
+
+                const int   thePredicateFlags =
+                    analyzeExpression(theExpression, thePredicatePos + 2, theContext);
+
+                if ((thePredicateFlags & (eUsesContent | eNotStreamable)) != 0 ||
+                    isPositionalPredicate(theExpression, thePredicatePos) == true)
+                {
+                    theFlags |= eNotStreamable;
+                }
+
+                thePredicatePos = theExpression.getNextOpCodePosition(thePredicatePos);
+            }
+
+            theStepPos += theExpression.getOpCodeMapValue(theStepPos + 1);
+        }
+
+        if (fRootOnly == true)
+        {
+            fMatchesRoot = true;
+        }
+
+        thePathPos = theExpression.getNextOpCodePosition(thePathPos);
+    }
+
+    return theFlags;
+}
+
+
+
+int
+XalanStreamabilityAnalyzer::analyzeXPath(const XPath&  theXPath) const
+{
+    const XPathExpression&  theExpression = theXPath.getExpression();
+
+    const OpCodeMapPositionType     opPos = theExpression.getInitialOpCodePosition();
+
+    if (theExpression.getOpCodeMapValue(opPos) == XPathExpression::eOP_MATCHPATTERN)
+    {
+        bool    fMatchesRoot = false;
+
+        return analyzePattern(theExpression, fMatchesRoot);
+    }
+    else
+    {
+        return analyzeExpression(theExpression, opPos, eElementContext);
+    }
+}
+
+
+
+bool
+XalanStreamabilityAnalyzer::isPositionalPredicate(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos) const
+{
+    if (theExpression.getOpCodeMapValue(opPos) == XPathExpression::eOP_PREDICATE_WITH_POSITION)
+    {
+        return true;
+    }
+
+    OpCodeMapPositionType   theExpressionPos = opPos + 2;
+
+    if ((analyzeExpression(theExpression, theExpressionPos, eElementContext) & eUsesPosition) != 0)
+    {
+        return true;
+    }
+
+    // A predicate which yields a number is a test of the position.
+    while (theExpression.getOpCodeMapValue(theExpressionPos) == XPathExpression::eOP_GROUP)
+    {
+        theExpressionPos += 2;
+    }
+
+    switch(theExpression.getOpCodeMapValue(theExpressionPos))
+    {
+    case XPathExpression::eOP_NUMBERLIT:
+    case XPathExpression::eOP_PLUS:
+    case XPathExpression::eOP_MINUS:
+    case XPathExpression::eOP_MULT:
+    case XPathExpression::eOP_DIV:
+    case XPathExpression::eOP_MOD:
+    case XPathExpression::eOP_NEG:
+    case XPathExpression::eOP_VARIABLE:
+    case XPathExpression::eOP_EXTFUNCTION:
+    case XPathExpression::eOP_FUNCTION_COUNT:
+    case XPathExpression::eOP_FUNCTION_FLOOR:
+    case XPathExpression::eOP_FUNCTION_CEILING:
+    case XPathExpression::eOP_FUNCTION_ROUND:
+    case XPathExpression::eOP_FUNCTION_NUMBER_0:
+    case XPathExpression::eOP_FUNCTION_NUMBER_1:
+    case XPathExpression::eOP_FUNCTION_STRINGLENGTH_0:
+    case XPathExpression::eOP_FUNCTION_STRINGLENGTH_1:
+    case XPathExpression::eOP_FUNCTION_SUM:
+        return true;
+
+    case XPathExpression::eOP_FUNCTION:
+        return isNumericFunction(theExpression.getOpCodeMapValue(theExpressionPos + 2));
+
+    default:
+        return false;
+    }
+}
+
+
+
+bool
+XalanStreamabilityAnalyzer::isNumericFunction(int  theFunctionID) const
+{
+    const FunctionIDVectorType::const_iterator  theEnd = m_numericFunctionIDs.end();
+
+    for (FunctionIDVectorType::const_iterator i = m_numericFunctionIDs.begin(); i != theEnd; ++i)
+    {
+        if (*i == theFunctionID)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+bool
+XalanStreamabilityAnalyzer::isConsumingSelect(const XPath&     theXPath) const
+{
+    const XPathExpression&  theExpression = theXPath.getExpression();
+
+    const OpCodeMapPositionType     opPos = theExpression.getInitialOpCodePosition();
+
+    if (theExpression.getOpCodeMapValue(opPos) != XPathExpression::eOP_XPATH)
+    {
+        return false;
+    }
+
+    bool    fHasChildStep = false;
+
+    return isConsumingBranch(theExpression, opPos + 2, fHasChildStep) == true &&
+           fHasChildStep == true;
+}
+
+
+
+bool
+XalanStreamabilityAnalyzer::isConsumingBranch(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            bool&                   fHasChildStep) const
+{
+    const OpCodeMapValueType    theOpCode = theExpression.getOpCodeMapValue(opPos);
+
+    if (theOpCode == XPathExpression::eOP_UNION)
+    {
+        const OpCodeMapPositionType     theEnd =
+            theExpression.getNextOpCodePosition(opPos);
+
+        for (OpCodeMapPositionType i = opPos + 2;
+                i < theEnd && theExpression.getOpCodeMapValue(i) != XPathExpression::eENDOP;
+                    i = theExpression.getNextOpCodePosition(i))
+        {
+            if (isConsumingBranch(theExpression, i, fHasChildStep) == false)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+    else if (theOpCode != XPathExpression::eOP_LOCATIONPATH)
+    {
+        return false;
+    }
+
+    // Only a single child or attribute step, so the nodes are
+    // selected in document order as they arrive.
+    const OpCodeMapPositionType     theStepPos = opPos + 2;
+
+    const OpCodeMapValueType    theStepType = theExpression.getOpCodeMapValue(theStepPos);
+
+    if (theStepType != XPathExpression::eFROM_CHILDREN &&
+        theStepType != XPathExpression::eFROM_ATTRIBUTES)
+    {
+        return false;
+    }
+
+    const eContext  theContext = theStepType == XPathExpression::eFROM_ATTRIBUTES ?
+                                    eAttributeContext : eElementContext;
+
+    OpCodeMapPositionType   thePredicatePos =
+        theStepPos + theExpression.getOpCodeMapValue(theStepPos + 2);
+
+    for (;;)
+    {
+        const OpCodeMapValueType    thePredicateOpCode = theExpression.getOpCodeMapValue(thePredicatePos);
+
+        if (thePredicateOpCode != XPathExpression::eOP_PREDICATE &&
+            thePredicateOpCode != XPathExpression::eOP_PREDICATE_WITH_POSITION)
+        {
+            break;
+        }
+
+        const int   theFlags =
+            analyzeExpression(theExpression, thePredicatePos + 2, theContext);
+
+        if (theFlags != 0 ||
+            isPositionalPredicate(theExpression, thePredicatePos) == true)
+        {
+            return false;
+        }
+
+        thePredicatePos = theExpression.getNextOpCodePosition(thePredicatePos);
+    }
+
+    if (theExpression.getOpCodeMapValue(theStepPos + theExpression.getOpCodeMapValue(theStepPos + 1)) !=
+            XPathExpression::eENDOP)
+    {
+        return false;
+    }
+
+    if (theStepType == XPathExpression::eFROM_CHILDREN)
+    {
+        fHasChildStep = true;
+    }
+
+    return true;
+}
+
+
+
+void
+XalanStreamabilityAnalyzer::analyzeStylesheet(const Stylesheet&    theStylesheet)
+{
+    if (theStylesheet.m_keyDeclarations.empty() == false)
+    {
+        m_isStreamable = false;
+    }
+
+    {
+        typedef Stylesheet::ElemVariableVectorType::const_iterator  const_iterator;
+
+        const const_iterator    theEnd = theStylesheet.m_topLevelVariables.end();
+
+        for (const_iterator i = theStylesheet.m_topLevelVariables.begin(); i != theEnd; ++i)
+        {
+            assert(*i != 0);
+
+            analyzeElement(**i);
+
+            // Global variables are evaluated with the root as the
+            // context, and the root is never complete.
+            if (isContentFree(**i) == false)
+            {
+                m_isStreamable = false;
+            }
+        }
+    }
+
+    for (ElemTemplateElement* theTemplate = theStylesheet.m_firstTemplate;
+            theTemplate != 0;
+                theTemplate = theTemplate->getNextSiblingElem())
+    {
+        analyzeElement(*theTemplate);
+
+        const XPath* const  theMatchPattern = theTemplate->getXPath(0);
+
+        if (theMatchPattern != 0)
+        {
+            bool    fMatchesRoot = false;
+
+            analyzePattern(theMatchPattern->getExpression(), fMatchesRoot);
+
+            if (fMatchesRoot == true)
+            {
+                m_rootTemplates.push_back(theTemplate);
+            }
+        }
+
+        if (m_isStreamable == true)
+        {
+            analyzeTemplate(*theTemplate);
+        }
+    }
+
+    typedef Stylesheet::StylesheetVectorType::const_iterator    const_iterator;
+
+    const const_iterator    theEnd = theStylesheet.m_imports.end();
+
+    for (const_iterator i = theStylesheet.m_imports.begin(); i != theEnd; ++i)
+    {
+        assert(*i != 0);
+
+        analyzeStylesheet(**i);
+    }
+}
+
+
+
+void
+XalanStreamabilityAnalyzer::analyzeElement(const ElemTemplateElement&  theElement)
+{
+    switch(theElement.getXSLToken())
+    {
+    case StylesheetConstructionContext::ELEMNAME_NUMBER:
+    case StylesheetConstructionContext::ELEMNAME_EXTENSION:
+    case StylesheetConstructionContext::ELEMNAME_EXTENSION_CALL:
+    case StylesheetConstructionContext::ELEMNAME_EXTENSION_HANDLER:
+    case StylesheetConstructionContext::ELEMNAME_FORWARD_COMPATIBLE:
+    case StylesheetConstructionContext::ELEMNAME_UNDEFINED:
+        m_isStreamable = false;
+        return;
+
+    default:
+        break;
+    }
+
+    const XPath*    theXPath = 0;
+
+    for (XalanSize_t i = 0; (theXPath = theElement.getXPath(i)) != 0; ++i)
+    {
+        if ((analyzeXPath(*theXPath) & eNotStreamable) != 0)
+        {
+            m_isStreamable = false;
+
+            return;
+        }
+    }
+
+    for (const ElemTemplateElement* theChild = theElement.getFirstChildElem();
+            theChild != 0 && m_isStreamable == true;
+                theChild = theChild->getNextSiblingElem())
+    {
+        analyzeElement(*theChild);
+    }
+}
+
+
+
+void
+XalanStreamabilityAnalyzer::analyzeTemplate(ElemTemplateElement&   theTemplate)
+{
+    ElemTemplateElement*    theConsumer = 0;
+
+    if (m_attributeSetsContentFree == true &&
+        analyzeBody(theTemplate, true, theConsumer) == true)
+    {
+        theTemplate.setStreamable(true);
+
+        if (theConsumer != 0)
+        {
+            theConsumer->setStreamable(true);
+        }
+    }
+}
+
+
+
+bool
+XalanStreamabilityAnalyzer::analyzeBody(
+            const ElemTemplateElement&      theParent,
+            bool                            fConsumerAllowed,
+            ElemTemplateElement*&           theConsumer)
+{
+    for (ElemTemplateElement* theChild = theParent.getFirstChildElem();
+            theChild != 0;
+                theChild = theChild->getNextSiblingElem())
+    {
+        switch(theChild->getXSLToken())
+        {
+        case StylesheetConstructionContext::ELEMNAME_APPLY_TEMPLATES:
+            {
+                const XPath* const  theSelect = theChild->getXPath(0);
+                assert(theSelect != 0);
+
+                if ((analyzeXPath(*theSelect) & eUsesContent) == 0)
+                {
+                    if (isContentFree(*theChild) == false)
+                    {
+                        return false;
+                    }
+                }
+                else if (fConsumerAllowed == false ||
+                         theConsumer != 0 ||
+                         static_cast<const ElemForEach*>(theChild)->getSortElems().empty() == false ||
+                         isConsumingSelect(*theSelect) == false)
+                {
+                    return false;
+                }
+                else
+                {
+                    for (const ElemTemplateElement* theParam = theChild->getFirstChildElem();
+                            theParam != 0;
+                                theParam = theParam->getNextSiblingElem())
+                    {
+                        if (isContentFree(*theParam) == false)
+                        {
+                            return false;
+                        }
+                    }
+
+                    theConsumer = theChild;
+                }
+            }
+            break;
+
+        case StylesheetConstructionContext::ELEMNAME_LITERAL_RESULT:
+        case StylesheetConstructionContext::ELEMNAME_ELEMENT:
+        case StylesheetConstructionContext::ELEMNAME_COPY:
+        case StylesheetConstructionContext::ELEMNAME_IF:
+        case StylesheetConstructionContext::ELEMNAME_CHOOSE:
+        case StylesheetConstructionContext::ELEMNAME_WHEN:
+        case StylesheetConstructionContext::ELEMNAME_OTHERWISE:
+            {
+                // These are executed at most once, and their output
+                // goes straight to the result, so the children may be
+                // processed inside of them.
+                const XPath*    theXPath = 0;
+
+                for (XalanSize_t i = 0; (theXPath = theChild->getXPath(i)) != 0; ++i)
+                {
+                    if ((analyzeXPath(*theXPath) & (eUsesContent | eNotStreamable)) != 0)
+                    {
+                        return false;
+                    }
+                }
+
+                if (analyzeBody(*theChild, fConsumerAllowed, theConsumer) == false)
+                {
+                    return false;
+                }
+            }
+            break;
+
+        default:
+            if (isContentFree(*theChild) == false)
+            {
+                return false;
+            }
+            break;
+        }
+    }
+
+    return true;
+}
+
+
+
+bool
+XalanStreamabilityAnalyzer::isContentFree(const ElemTemplateElement&   theElement)
+{
+    switch(theElement.getXSLToken())
+    {
+    case StylesheetConstructionContext::ELEMNAME_APPLY_IMPORTS:
+        return false;
+
+    case StylesheetConstructionContext::ELEMNAME_VALUE_OF:
+    case StylesheetConstructionContext::ELEMNAME_COPY_OF:
+        // A select of "." is not compiled, so there is no XPath.
+        if (theElement.getXPath(0) == 0)
+        {
+            return false;
+        }
+        break;
+
+    case StylesheetConstructionContext::ELEMNAME_CALL_TEMPLATE:
+        {
+            const ElemTemplate* const   theTemplate =
+                static_cast<const ElemCallTemplate&>(theElement).getTemplate();
+
+            if (theTemplate == 0 || isContentFreeTemplate(*theTemplate) == false)
+            {
+                return false;
+            }
+        }
+        break;
+
+    case StylesheetConstructionContext::ELEMNAME_APPLY_TEMPLATES:
+    case StylesheetConstructionContext::ELEMNAME_FOR_EACH:
+        {
+            // The sort keys are evaluated for the selected nodes,
+            // which are complete if the select is content-free.
+            typedef ElemForEach::SortElemsVectorType    SortElemsVectorType;
+
+            const SortElemsVectorType&  theSortElems =
+                static_cast<const ElemForEach&>(theElement).getSortElems();
+
+            const SortElemsVectorType::const_iterator   theEnd = theSortElems.end();
+
+            for (SortElemsVectorType::const_iterator i = theSortElems.begin(); i != theEnd; ++i)
+            {
+                assert(*i != 0);
+
+                const XPath*    theXPath = 0;
+
+                for (XalanSize_t j = 0; (theXPath = (*i)->getXPath(j)) != 0; ++j)
+                {
+                    if ((analyzeXPath(*theXPath) & eNotStreamable) != 0)
+                    {
+                        return false;
+                    }
+                }
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    const XPath*    theXPath = 0;
+
+    for (XalanSize_t i = 0; (theXPath = theElement.getXPath(i)) != 0; ++i)
+    {
+        if ((analyzeXPath(*theXPath) & (eUsesContent | eNotStreamable)) != 0)
+        {
+            return false;
+        }
+    }
+
+    for (const ElemTemplateElement* theChild = theElement.getFirstChildElem();
+            theChild != 0;
+                theChild = theChild->getNextSiblingElem())
+    {
+        if (isContentFree(*theChild) == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+bool
+XalanStreamabilityAnalyzer::isContentFreeTemplate(const ElemTemplateElement&   theTemplate)
+{
+    const TemplateMapType::const_iterator   i = m_contentFreeTemplates.find(&theTemplate);
+
+    if (i != m_contentFreeTemplates.end())
+    {
+        return (*i).second;
+    }
+
+    // Assume a recursive call is content-free until the body has been
+    // seen, since the recursion itself doesn't use anything.
+    m_contentFreeTemplates[&theTemplate] = true;
+
+    bool    fResult = true;
+
+    for (const ElemTemplateElement* theChild = theTemplate.getFirstChildElem();
+            theChild != 0;
+                theChild = theChild->getNextSiblingElem())
+    {
+        if (isContentFree(*theChild) == false)
+        {
+            fResult = false;
+
+            break;
+        }
+    }
+
+    m_contentFreeTemplates[&theTemplate] = fResult;
+
+    return fResult;
+}
+
+
+
+}
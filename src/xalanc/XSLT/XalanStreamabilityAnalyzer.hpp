@@ -0,0 +1,217 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALAN_STREAMABILITYANALYZER_HEADER_GUARD)
+#define XALAN_STREAMABILITYANALYZER_HEADER_GUARD
+
+
+
+// Base include file.  Must be first.
+#include "XSLTDefinitions.hpp"
+
+
+
+#include <xalanc/Include/XalanMap.hpp>
+#include <xalanc/Include/XalanVector.hpp>
+
+
+
+#include <xalanc/XPath/XPath.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+class ElemTemplateElement;
+class Stylesheet;
+class StylesheetRoot;
+
+
+
+/**
+ * This class determines whether a stylesheet can transform a source
+ * document while the document is being parsed, so that each subtree
+ * of the source can be discarded once it has been processed.
+ *
+ * A template is marked streamable when it uses nothing but the name
+ * and the attributes of the current node, except for one
+ * xsl:apply-templates which processes the children, and which is also
+ * marked.  The stylesheet is streamable when nothing in it looks at
+ * siblings, ancestors, the root, keys or IDs of a node, the patterns
+ * only test the names and attributes of nodes, and the templates which
+ * match the root are streamable.
+ */
+class XALAN_XSLT_EXPORT XalanStreamabilityAnalyzer
+{
+public:
+
+    XalanStreamabilityAnalyzer(MemoryManager&   theManager);
+
+    ~XalanStreamabilityAnalyzer();
+
+    /**
+     * Analyze a stylesheet and its imports, and mark the streamable
+     * templates and instructions.
+     *
+     * @param theStylesheet The stylesheet to analyze
+     * @return true if the stylesheet is streamable, false if not.
+     */
+    bool
+    analyze(StylesheetRoot&     theStylesheet);
+
+private:
+
+    typedef XPath::OpCodeMapPositionType    OpCodeMapPositionType;
+    typedef XPath::OpCodeMapValueType       OpCodeMapValueType;
+
+    typedef XalanMap<const ElemTemplateElement*, bool>  TemplateMapType;
+    typedef XalanVector<ElemTemplateElement*>           TemplateVectorType;
+    typedef XalanVector<int>                            FunctionIDVectorType;
+
+    enum eFlags
+    {
+        eUsesContent = 1,
+        eNotStreamable = 2,
+        eUsesPosition = 4,
+        eUsesVariables = 8
+    };
+
+    enum eContext
+    {
+        eElementContext,
+        eAttributeContext,
+        eOtherContext
+    };
+
+    int
+    analyzeExpression(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            eContext                theContext) const;
+
+    int
+    analyzeLocationPath(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            eContext                theContext) const;
+
+    int
+    analyzeFunction(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            eContext                theContext) const;
+
+    int
+    analyzePredicates(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType&  opPos,
+            eContext                theContext) const;
+
+    int
+    analyzePattern(
+            const XPathExpression&  theExpression,
+            bool&                   fMatchesRoot) const;
+
+    int
+    analyzeXPath(const XPath&   theXPath) const;
+
+    bool
+    isPositionalPredicate(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos) const;
+
+    bool
+    isConsumingSelect(const XPath&  theXPath) const;
+
+    bool
+    isConsumingBranch(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos,
+            bool&                   fHasChildStep) const;
+
+    bool
+    isNumericFunction(int   theFunctionID) const;
+
+    void
+    analyzeStylesheet(const Stylesheet&     theStylesheet);
+
+    void
+    analyzeElement(const ElemTemplateElement&   theElement);
+
+    void
+    analyzeTemplate(ElemTemplateElement&    theTemplate);
+
+    bool
+    analyzeBody(
+            const ElemTemplateElement&      theParent,
+            bool                            fConsumerAllowed,
+            ElemTemplateElement*&           theConsumer);
+
+    bool
+    isContentFree(const ElemTemplateElement&    theElement);
+
+    bool
+    isContentFreeTemplate(const ElemTemplateElement&    theTemplate);
+
+
+    // Data members...
+    MemoryManager&      m_memoryManager;
+
+    bool                m_isStreamable;
+
+    bool                m_attributeSetsContentFree;
+
+    TemplateMapType     m_contentFreeTemplates;
+
+    TemplateVectorType  m_rootTemplates;
+
+    FunctionIDVectorType    m_numericFunctionIDs;
+
+    // The IDs of the functions in the function table which need
+    // special treatment.
+    int                 m_currentID;
+
+    int                 m_generateIDID;
+
+    int                 m_idID;
+
+    int                 m_keyID;
+
+    int                 m_lastID;
+
+    int                 m_normalizeSpaceID;
+
+    int                 m_numberID;
+
+    int                 m_positionID;
+
+    int                 m_stringID;
+
+    int                 m_stringLengthID;
+
+    int                 m_unparsedEntityURIID;
+};
+
+
+
+}
+
+
+
+#endif  // XALAN_STREAMABILITYANALYZER_HEADER_GUARD
@@ -0,0 +1,1123 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "XalanStreamingSource.hpp"
+
+
+
+#include <xalanc/XalanDOM/XalanNamedNodeMap.hpp>
+
+
+
+#include <xalanc/DOMSupport/DOMServices.hpp>
+
+
+
+#include <xalanc/XPath/XObject.hpp>
+#include <xalanc/XPath/XPath.hpp>
+
+
+
+#include <xalanc/XalanSourceTree/XalanSourceTreeComment.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeDocument.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeElement.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeHelper.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeParserLiaison.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeProcessingInstruction.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeText.hpp>
+
+
+
+#include "Constants.hpp"
+#include "ElemTemplateElement.hpp"
+#include "StylesheetExecutionContext.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanStreamingSource::Level::Level(MemoryManager&  theManager) :
+    NodeRefListBase(),
+    m_node(0),
+    m_document(0),
+    m_container(0),
+    m_containerElement(0),
+    m_elementStack(theManager),
+    m_lastChildStack(theManager),
+    m_lastChild(0),
+    m_lastDelivered(0),
+    m_deliveredCount(0),
+    m_skipDepth(0),
+    m_skipping(false),
+    m_begun(false),
+    m_ended(false),
+    m_select(0),
+    m_childSteps(theManager),
+    m_selectedNodes(theManager),
+    m_selectedIndex(0),
+    m_position(0),
+    m_current(0),
+    m_executionContext(0),
+    m_uri(theManager),
+    m_localName(theManager),
+    m_qname(theManager),
+    m_attributes(theManager)
+{
+}
+
+
+
+XalanStreamingSource::Level::~Level()
+{
+}
+
+
+
+XalanNode*
+XalanStreamingSource::Level::item(size_type     index) const
+{
+    // Only the node being processed is available.
+    assert(index + 1 == m_position);
+    (void) index; // unused if assert is disabled
+
+    return m_current;
+}
+
+
+
+XalanStreamingSource::size_type
+XalanStreamingSource::Level::getLength() const
+{
+    return m_position;
+}
+
+
+
+XalanStreamingSource::size_type
+XalanStreamingSource::Level::indexOf(const XalanNode*  theNode) const
+{
+    return theNode != 0 && theNode == m_current ? m_position - 1 : npos;
+}
+
+
+
+bool
+XalanStreamingSource::Level::isOpenChild(const XalanNode*  theNode) const
+{
+    return m_elementStack.empty() == false && m_elementStack.front() == theNode;
+}
+
+
+
+void
+XalanStreamingSource::Level::popElement()
+{
+    assert(m_elementStack.empty() == false);
+    assert(m_lastChildStack.empty() == false);
+
+    m_elementStack.pop_back();
+
+    m_lastChild = m_lastChildStack.back();
+
+    m_lastChildStack.pop_back();
+}
+
+
+
+XalanStreamingSource::XalanStreamingSource(
+            XalanSourceTreeParserLiaison&   theParserLiaison,
+            const InputSource&              theInputSource,
+            MemoryManager&                  theManager) :
+    ContentHandlerType(),
+    LexicalHandlerType(),
+    m_memoryManager(theManager),
+    m_parserLiaison(theParserLiaison),
+    m_inputSource(theInputSource),
+    m_scanToken(),
+    m_document(theParserLiaison.createXalanSourceTreeDocument()),
+    m_levels(theManager),
+    m_textBuffer(theManager),
+    m_started(false),
+    m_finished(false),
+    m_draining(false),
+    m_inDTD(false)
+{
+    assert(m_document != 0);
+
+    Level*  theLevel = 0;
+
+    XalanConstruct(m_memoryManager, theLevel, m_memoryManager);
+
+    theLevel->m_node = m_document;
+    theLevel->m_document = m_document;
+    theLevel->m_container = m_document;
+
+    m_levels.push_back(theLevel);
+}
+
+
+
+XalanStreamingSource::~XalanStreamingSource()
+{
+    while (m_levels.empty() == false)
+    {
+        Level* const    theLevel = m_levels.back();
+
+        m_levels.pop_back();
+
+        destroyDocument(*theLevel);
+
+        XalanDestroy(m_memoryManager, *theLevel);
+    }
+
+    if (m_started == true)
+    {
+        m_parserLiaison.parseReset(m_scanToken);
+    }
+}
+
+
+
+bool
+XalanStreamingSource::isOpen(const XalanNode&  theNode) const
+{
+    assert(m_levels.empty() == false);
+
+    const Level&    theLevel = *m_levels.back();
+
+    return theLevel.m_node == &theNode &&
+           theLevel.m_begun == false &&
+           theLevel.m_ended == false;
+}
+
+
+
+const NodeRefListBase&
+XalanStreamingSource::beginChildren(
+            StylesheetExecutionContext&     theExecutionContext,
+            const ElemTemplateElement&      theInstruction,
+            const XPath&                    theSelect)
+{
+    assert(m_levels.empty() == false);
+
+    Level&  theLevel = *m_levels.back();
+    assert(theLevel.m_begun == false && theLevel.m_node != 0);
+
+    theLevel.m_begun = true;
+    theLevel.m_select = &theSelect;
+    theLevel.m_executionContext = &theExecutionContext;
+
+    const XPathExpression&  theExpression = theSelect.getExpression();
+
+    const OpCodeMapPositionType     opPos = theExpression.getInitialOpCodePosition();
+    assert(theExpression.getOpCodeMapValue(opPos) == XPathExpression::eOP_XPATH);
+
+    addChildSteps(theLevel, theExecutionContext, opPos + 2);
+
+    // Only the attributes of the node exist before its children are
+    // parsed, so the select only needs to be evaluated up front when
+    // there are some.
+    const XalanNamedNodeMap* const  theAttributes =
+        theLevel.m_node->getAttributes();
+
+    if (theAttributes != 0 && theAttributes->getLength() != 0)
+    {
+        typedef StylesheetExecutionContext::BorrowReturnMutableNodeRefList  BorrowReturnMutableNodeRefList;
+
+        BorrowReturnMutableNodeRefList  theResultList(theExecutionContext);
+
+        const XObjectPtr    theResult =
+            theSelect.execute(
+                theLevel.m_node,
+                theInstruction,
+                theExecutionContext,
+                *theResultList);
+
+        theLevel.m_selectedNodes.addNodes(
+            theResult.null() == true ? *theResultList : theResult->nodeset());
+    }
+
+    return theLevel;
+}
+
+
+
+XalanNode*
+XalanStreamingSource::nextNode(const NodeRefListBase&  theList)
+{
+    Level&  theLevel = const_cast<Level&>(static_cast<const Level&>(theList));
+
+    // Any levels above this one belong to children which have
+    // been processed.
+    while (m_levels.back() != &theLevel)
+    {
+        popLevel();
+    }
+
+    // The nodes selected before the children were parsed come first,
+    // since they can only be attributes.
+    if (theLevel.m_selectedIndex < theLevel.m_selectedNodes.getLength())
+    {
+        return deliver(
+                theLevel,
+                theLevel.m_selectedNodes.item(theLevel.m_selectedIndex++));
+    }
+
+    // If the last child is still open, no template processed its
+    // children, so they are not needed.
+    if (theLevel.m_lastDelivered != 0 &&
+        theLevel.isOpenChild(theLevel.m_lastDelivered) == true)
+    {
+        skipOpenChild(theLevel);
+    }
+
+    for (;;)
+    {
+        XalanNode* const    theNext = theLevel.m_lastDelivered == 0 ?
+                                        theLevel.m_container->getFirstChild() :
+                                        theLevel.m_lastDelivered->getNextSibling();
+
+        if (theNext != 0)
+        {
+            theLevel.m_lastDelivered = theNext;
+
+            ++theLevel.m_deliveredCount;
+
+            if (isSelected(theLevel, theNext) == true)
+            {
+                return deliver(theLevel, theNext);
+            }
+            else if (theLevel.isOpenChild(theNext) == true)
+            {
+                skipOpenChild(theLevel);
+            }
+        }
+        else if (theLevel.m_ended == true)
+        {
+            return 0;
+        }
+        else
+        {
+            // Every child has been processed, so if there are enough
+            // of them, start again with an empty document.
+            if (theLevel.m_deliveredCount >= eResetThreshold &&
+                theLevel.m_document != m_document &&
+                theLevel.m_elementStack.empty() == true &&
+                theLevel.m_skipping == false &&
+                m_textBuffer.empty() == true)
+            {
+                destroyDocument(theLevel);
+
+                buildContainer(theLevel);
+            }
+
+            if (parseNext() == false && theLevel.m_ended == false)
+            {
+                // The parse ended early, so there's nothing more.
+                theLevel.m_ended = true;
+            }
+        }
+    }
+}
+
+
+
+void
+XalanStreamingSource::beginChild(
+            XalanNode*  theNode,
+            bool        fStreamable)
+{
+    assert(theNode != 0);
+    assert(m_levels.empty() == false);
+
+    Level&  theLevel = *m_levels.back();
+
+    if (theLevel.isOpenChild(theNode) == true)
+    {
+        if (fStreamable == true &&
+            theLevel.m_elementStack.size() == 1 &&
+            theNode->getFirstChild() == 0)
+        {
+            promote(theLevel, theLevel.m_elementStack.back());
+        }
+        else
+        {
+            // The template needs the whole element.
+            while (theLevel.isOpenChild(theNode) == true &&
+                   parseNext() == true)
+            {
+            }
+        }
+    }
+}
+
+
+
+void
+XalanStreamingSource::finish()
+{
+    m_draining = true;
+
+    while (parseNext() == true)
+    {
+    }
+}
+
+
+
+XalanStreamingSource::Level&
+XalanStreamingSource::getEventLevel() const
+{
+    assert(m_levels.empty() == false);
+
+    LevelStackType::size_type   i = m_levels.size() - 1;
+
+    while (i > 0 && m_levels[i]->m_ended == true)
+    {
+        --i;
+    }
+
+    return *m_levels[i];
+}
+
+
+
+bool
+XalanStreamingSource::parseNext()
+{
+    if (m_finished == true)
+    {
+        return false;
+    }
+
+    bool    fMore = false;
+
+    if (m_started == false)
+    {
+        m_started = true;
+
+        fMore = m_parserLiaison.parseFirst(
+                    m_inputSource,
+                    m_scanToken,
+                    *this,
+                    0,
+                    this);
+    }
+    else
+    {
+        fMore = m_parserLiaison.parseNext(m_scanToken);
+    }
+
+    if (fMore == false)
+    {
+        m_finished = true;
+    }
+
+    return fMore;
+}
+
+
+
+void
+XalanStreamingSource::popLevel()
+{
+    assert(m_levels.size() > 1);
+
+    Level* const    theLevel = m_levels.back();
+
+    if (theLevel->m_ended == false)
+    {
+        // Skip the rest of the element.
+        while (theLevel->m_elementStack.empty() == false)
+        {
+            theLevel->popElement();
+
+            ++theLevel->m_skipDepth;
+        }
+
+        theLevel->m_skipping = true;
+
+        m_textBuffer.clear();
+
+        while (theLevel->m_ended == false &&
+               parseNext() == true)
+        {
+        }
+    }
+
+    m_levels.pop_back();
+
+    destroyDocument(*theLevel);
+
+    XalanDestroy(m_memoryManager, *theLevel);
+}
+
+
+
+void
+XalanStreamingSource::promote(
+            Level&                      theParent,
+            XalanSourceTreeElement*     theElement)
+{
+    assert(theElement != 0);
+
+    Level*  theLevel = 0;
+
+    XalanConstruct(m_memoryManager, theLevel, m_memoryManager);
+
+    m_levels.push_back(theLevel);
+
+    theLevel->m_node = theElement;
+
+    theLevel->m_uri = theElement->getNamespaceURI();
+    theLevel->m_localName = theElement->getLocalName();
+    theLevel->m_qname = theElement->getNodeName();
+
+    const XalanNamedNodeMap* const  theAttributes = theElement->getAttributes();
+    assert(theAttributes != 0);
+
+    const XalanSize_t   theLength = theAttributes->getLength();
+
+    for (XalanSize_t i = 0; i < theLength; ++i)
+    {
+        const XalanNode* const  theAttribute = theAttributes->item(i);
+        assert(theAttribute != 0);
+
+        // The xml namespace attribute on the document element is
+        // added again when the copy is created.
+        if (theAttribute->getNodeName() != DOMServices::s_XMLNamespacePrefix)
+        {
+            theLevel->m_attributes.addAttribute(
+                theAttribute->getNamespaceURI().c_str(),
+                theAttribute->getLocalName().c_str(),
+                theAttribute->getNodeName().c_str(),
+                Constants::ATTRTYPE_CDATA.c_str(),
+                theAttribute->getNodeValue().c_str());
+        }
+    }
+
+    buildContainer(*theLevel);
+
+    assert(theParent.isOpenChild(theElement) == true);
+}
+
+
+
+void
+XalanStreamingSource::buildContainer(Level&    theLevel)
+{
+    assert(m_levels.size() > 1);
+
+    theLevel.m_document =
+        XalanSourceTreeDocument::create(
+            m_memoryManager,
+            m_parserLiaison.getPoolAllText());
+
+    // Copy the open elements from the document element down, so the
+    // in-scope namespaces and xml:space attributes are available.
+    XalanSourceTreeElement*     theParent = 0;
+
+    const LevelStackType::const_iterator    theEnd = m_levels.end();
+
+    for (LevelStackType::const_iterator i = m_levels.begin() + 1; i != theEnd; ++i)
+    {
+        const Level&    theOwner = **i;
+
+        XalanSourceTreeElement* const   theElement = theOwner.m_uri.empty() == false ?
+            theLevel.m_document->createElementNode(
+                theOwner.m_uri.c_str(),
+                theOwner.m_localName.c_str(),
+                theOwner.m_qname.c_str(),
+                theOwner.m_attributes,
+                theParent,
+                0,
+                0,
+                theParent == 0) :
+            theLevel.m_document->createElementNode(
+                theOwner.m_qname.c_str(),
+                theOwner.m_attributes,
+                theParent,
+                0,
+                0,
+                theParent == 0);
+
+        if (theParent == 0)
+        {
+            theLevel.m_document->appendChildNode(theElement);
+        }
+        else
+        {
+            theParent->appendChildNode(theElement);
+        }
+
+        theParent = theElement;
+
+        if (&theOwner == &theLevel)
+        {
+            break;
+        }
+    }
+
+    theLevel.m_container = theParent;
+    theLevel.m_containerElement = theParent;
+    theLevel.m_elementStack.clear();
+    theLevel.m_lastChildStack.clear();
+    theLevel.m_lastChild = 0;
+    theLevel.m_lastDelivered = 0;
+    theLevel.m_deliveredCount = 0;
+}
+
+
+
+void
+XalanStreamingSource::destroyDocument(Level&   theLevel)
+{
+    if (theLevel.m_document != m_document &&
+        theLevel.m_document != 0)
+    {
+        XalanDestroy(m_memoryManager, *theLevel.m_document);
+
+        theLevel.m_document = 0;
+        theLevel.m_container = 0;
+        theLevel.m_containerElement = 0;
+    }
+}
+
+
+
+void
+XalanStreamingSource::skipOpenChild(Level&     theLevel)
+{
+    assert(theLevel.m_elementStack.empty() == false);
+
+    while (theLevel.m_elementStack.size() > 1)
+    {
+        theLevel.popElement();
+
+        ++theLevel.m_skipDepth;
+    }
+
+    theLevel.m_skipping = true;
+
+    m_textBuffer.clear();
+
+    const XalanNode* const  theChild = theLevel.m_elementStack.back();
+
+    while (theLevel.isOpenChild(theChild) == true &&
+           parseNext() == true)
+    {
+    }
+}
+
+
+
+void
+XalanStreamingSource::addChildSteps(
+            Level&                          theLevel,
+            StylesheetExecutionContext&     theExecutionContext,
+            OpCodeMapPositionType           opPos)
+{
+    assert(theLevel.m_select != 0);
+
+    const XPath&    theSelect = *theLevel.m_select;
+
+    const XPathExpression&  theExpression = theSelect.getExpression();
+
+    // The analyzer only streams a union of location paths, each of
+    // which is a single child or attribute step.
+    if (theExpression.getOpCodeMapValue(opPos) == XPathExpression::eOP_UNION)
+    {
+        const OpCodeMapPositionType     theEnd =
+            theExpression.getNextOpCodePosition(opPos);
+
+        for (OpCodeMapPositionType i = opPos + 2;
+                i < theEnd && theExpression.getOpCodeMapValue(i) != XPathExpression::eENDOP;
+                    i = theExpression.getNextOpCodePosition(i))
+        {
+            addChildSteps(theLevel, theExecutionContext, i);
+        }
+    }
+    else
+    {
+        assert(theExpression.getOpCodeMapValue(opPos) == XPathExpression::eOP_LOCATIONPATH);
+
+        const OpCodeMapPositionType     theStepPos = opPos + 2;
+
+        const XPath::OpCodeMapValueType     theStepType =
+            theExpression.getOpCodeMapValue(theStepPos);
+
+        // The attributes are selected before the children are parsed.
+        if (theStepType == XPathExpression::eFROM_CHILDREN)
+        {
+            theLevel.m_childSteps.push_back(
+                ChildStep(
+                    XPath::NodeTester(
+                        theSelect,
+                        theExecutionContext,
+                        theStepPos + 3,
+                        theExpression.getOpCodeArgumentLength(theStepPos),
+                        theStepType),
+                    theStepPos + theExpression.getOpCodeMapValue(theStepPos + 2)));
+        }
+        else
+        {
+            assert(theStepType == XPathExpression::eFROM_ATTRIBUTES);
+        }
+    }
+}
+
+
+
+bool
+XalanStreamingSource::isSelected(
+            Level&      theLevel,
+            XalanNode*  theNode) const
+{
+    assert(theNode != 0);
+    assert(theLevel.m_executionContext != 0);
+    assert(theLevel.m_select != 0);
+
+    StylesheetExecutionContext&     theExecutionContext = *theLevel.m_executionContext;
+
+    const XPath&    theSelect = *theLevel.m_select;
+
+    const XPathExpression&  theExpression = theSelect.getExpression();
+
+    const XalanNode::NodeType   theNodeType = theNode->getNodeType();
+
+    const ChildStepVectorType::const_iterator   theEnd = theLevel.m_childSteps.end();
+
+    for (ChildStepVectorType::const_iterator i = theLevel.m_childSteps.begin(); i != theEnd; ++i)
+    {
+        if (i->m_tester(*theNode, theNodeType) == XPath::eMatchScoreNone)
+        {
+            continue;
+        }
+
+        // The predicates don't depend on the position or the content
+        // of the child, so they can be evaluated for it alone.
+        bool    fMatches = true;
+
+        for (OpCodeMapPositionType thePredicatePos = i->m_predicatePos;
+                fMatches == true &&
+                (theExpression.getOpCodeMapValue(thePredicatePos) == XPathExpression::eOP_PREDICATE ||
+                 theExpression.getOpCodeMapValue(thePredicatePos) == XPathExpression::eOP_PREDICATE_WITH_POSITION);
+                    thePredicatePos = theExpression.getNextOpCodePosition(thePredicatePos))
+        {
+            const XObjectPtr    theResult =
+                theSelect.predicate(theNode, thePredicatePos, theExecutionContext);
+            assert(theResult.null() == false && theResult->getType() != XObject::eTypeNumber);
+
+            fMatches = theResult->boolean(theExecutionContext);
+        }
+
+        if (fMatches == true)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+
+
+XalanNode*
+XalanStreamingSource::deliver(
+            Level&      theLevel,
+            XalanNode*  theNode)
+{
+    assert(theLevel.m_executionContext != 0);
+
+    ++theLevel.m_position;
+
+    theLevel.m_current = theNode;
+
+    // Pushing the list again clears any position cached for a node
+    // which was at the same address in a discarded document.
+    theLevel.m_executionContext->popContextNodeList();
+    theLevel.m_executionContext->pushContextNodeList(theLevel);
+
+    return theNode;
+}
+
+
+
+void
+XalanStreamingSource::processAccumulatedText()
+{
+    if (m_textBuffer.empty() == false)
+    {
+        Level&  theLevel = getEventLevel();
+
+        XalanSourceTreeElement* const   theCurrentElement = theLevel.getCurrentElement();
+        assert(theCurrentElement != 0);
+
+        XalanSourceTreeText* const  theNewTextNode =
+            theLevel.m_document->createTextNode(
+                m_textBuffer.c_str(),
+                m_textBuffer.length(),
+                theCurrentElement);
+
+        appendChild(theLevel, *theCurrentElement, theNewTextNode);
+
+        m_textBuffer.clear();
+    }
+}
+
+
+
+template <class ChildNodeType>
+void
+XalanStreamingSource::appendChild(
+            Level&          theLevel,
+            ChildNodeType   theNewChild)
+{
+    assert(theNewChild != 0);
+
+    XalanSourceTreeElement* const   theCurrentElement = theLevel.getCurrentElement();
+
+    if (theCurrentElement == 0)
+    {
+        theLevel.m_document->appendChildNode(theNewChild);
+
+        theLevel.m_lastChild = theNewChild;
+    }
+    else
+    {
+        appendChild(theLevel, *theCurrentElement, theNewChild);
+    }
+}
+
+
+
+template <class ChildNodeType>
+void
+XalanStreamingSource::appendChild(
+            Level&                      theLevel,
+            XalanSourceTreeElement&     theParent,
+            ChildNodeType               theNewChild)
+{
+    assert(theNewChild != 0);
+
+    if (theLevel.m_lastChild == 0)
+    {
+        theParent.appendChildNode(theNewChild);
+    }
+    else
+    {
+        XalanSourceTreeHelper::appendSibling(theLevel.m_lastChild, theNewChild);
+    }
+
+    theLevel.m_lastChild = theNewChild;
+}
+
+
+
+void
+XalanStreamingSource::characters(
+            const XMLCh* const  chars,
+            const XMLSize_t     length)
+{
+    if (m_draining == false)
+    {
+        const Level&    theLevel = getEventLevel();
+
+        if (theLevel.m_skipping == false &&
+            theLevel.getCurrentElement() != 0)
+        {
+            m_textBuffer.append(chars, length);
+        }
+    }
+}
+
+
+
+void
+XalanStreamingSource::endDocument()
+{
+    m_finished = true;
+
+    m_levels.front()->m_ended = true;
+}
+
+
+
+void
+XalanStreamingSource::endElement(
+            const XMLCh* const  /* uri */,
+            const XMLCh* const  /* localname */,
+            const XMLCh* const  /* qname */)
+{
+    if (m_draining == true)
+    {
+        return;
+    }
+
+    LevelStackType::size_type   theIndex = m_levels.size() - 1;
+
+    while (theIndex > 0 && m_levels[theIndex]->m_ended == true)
+    {
+        --theIndex;
+    }
+
+    Level&  theLevel = *m_levels[theIndex];
+
+    if (theLevel.m_skipping == true)
+    {
+        if (theLevel.m_skipDepth > 0)
+        {
+            --theLevel.m_skipDepth;
+
+            return;
+        }
+
+        theLevel.m_skipping = false;
+    }
+    else
+    {
+        processAccumulatedText();
+    }
+
+    if (theLevel.m_elementStack.empty() == false)
+    {
+        theLevel.popElement();
+    }
+    else
+    {
+        // This is the end of the element whose children the level
+        // holds, so the element is now closed in the level below.
+        assert(theIndex > 0);
+
+        theLevel.m_ended = true;
+
+        m_levels[theIndex - 1]->popElement();
+    }
+}
+
+
+
+void
+XalanStreamingSource::ignorableWhitespace(
+            const XMLCh* const  chars,
+            const XMLSize_t     length)
+{
+    if (m_draining == false)
+    {
+        Level&  theLevel = getEventLevel();
+
+        XalanSourceTreeElement* const   theCurrentElement = theLevel.getCurrentElement();
+
+        if (theLevel.m_skipping == false && theCurrentElement != 0)
+        {
+            processAccumulatedText();
+
+            XalanSourceTreeText* const  theNewTextNode =
+                theLevel.m_document->createTextIWSNode(chars, length, theCurrentElement);
+
+            appendChild(theLevel, *theCurrentElement, theNewTextNode);
+        }
+    }
+}
+
+
+
+void
+XalanStreamingSource::processingInstruction(
+            const XMLCh* const  target,
+            const XMLCh* const  data)
+{
+    if (m_draining == false)
+    {
+        Level&  theLevel = getEventLevel();
+
+        if (theLevel.m_skipping == false)
+        {
+            processAccumulatedText();
+
+            XalanSourceTreeProcessingInstruction* const     theNewPI =
+                theLevel.m_document->createProcessingInstructionNode(
+                    target,
+                    data,
+                    theLevel.getCurrentElement());
+
+            appendChild(theLevel, theNewPI);
+        }
+    }
+}
+
+
+
+void
+XalanStreamingSource::setDocumentLocator(const Locator* const  /* locator */)
+{
+}
+
+
+
+void
+XalanStreamingSource::startDocument()
+{
+}
+
+
+
+void
+XalanStreamingSource::startElement(
+            const XMLCh* const      uri,
+            const XMLCh* const      localname,
+            const XMLCh* const      qname,
+            const AttributesType&   attrs)
+{
+    m_inDTD = false;
+
+    if (m_draining == true)
+    {
+        return;
+    }
+
+    Level&  theLevel = getEventLevel();
+
+    if (theLevel.m_skipping == true)
+    {
+        ++theLevel.m_skipDepth;
+
+        return;
+    }
+
+    processAccumulatedText();
+
+    XalanSourceTreeElement* const   theCurrentElement = theLevel.getCurrentElement();
+
+    // If we're creating the document element, add the special xml namespace attribute...
+    const bool  fAddXMLNamespaceAttribute = theCurrentElement == 0 ? true : false;
+
+    XalanSourceTreeElement* const   theNewElement = length(uri) != 0 ?
+        theLevel.m_document->createElementNode(uri, localname, qname, attrs, theCurrentElement, 0, 0, fAddXMLNamespaceAttribute) :
+        theLevel.m_document->createElementNode(qname, attrs, theCurrentElement, 0, 0, fAddXMLNamespaceAttribute);
+
+    appendChild(theLevel, theNewElement);
+
+    theLevel.m_elementStack.push_back(theNewElement);
+
+    theLevel.m_lastChildStack.push_back(theLevel.m_lastChild);
+
+    theLevel.m_lastChild = 0;
+}
+
+
+
+void
+XalanStreamingSource::startPrefixMapping(
+            const XMLCh* const  /* prefix */,
+            const XMLCh* const  /* uri */)
+{
+}
+
+
+
+void
+XalanStreamingSource::endPrefixMapping(const XMLCh* const  /* prefix */)
+{
+}
+
+
+
+void
+XalanStreamingSource::skippedEntity(const XMLCh* const     /* name */)
+{
+}
+
+
+
+void
+XalanStreamingSource::comment(
+            const XMLCh* const  chars,
+            const XMLSize_t     length)
+{
+    if (m_draining == false && m_inDTD == false)
+    {
+        Level&  theLevel = getEventLevel();
+
+        if (theLevel.m_skipping == false)
+        {
+            processAccumulatedText();
+
+            XalanSourceTreeComment* const   theNewComment =
+                theLevel.m_document->createCommentNode(
+                    chars,
+                    length,
+                    theLevel.getCurrentElement());
+
+            appendChild(theLevel, theNewComment);
+        }
+    }
+}
+
+
+
+void
+XalanStreamingSource::endCDATA()
+{
+}
+
+
+
+void
+XalanStreamingSource::endDTD()
+{
+    m_inDTD = false;
+}
+
+
+
+void
+XalanStreamingSource::endEntity(const XMLCh* const     /* name */)
+{
+}
+
+
+
+void
+XalanStreamingSource::startCDATA()
+{
+}
+
+
+
+void
+XalanStreamingSource::startDTD(
+            const XMLCh* const  /* name */,
+            const XMLCh* const  /* publicId */,
+            const XMLCh* const  /* systemId */)
+{
+    m_inDTD = true;
+}
+
+
+
+void
+XalanStreamingSource::startEntity(const XMLCh* const   /* name */)
+{
+}
+
+
+
+}
@@ -0,0 +1,499 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALAN_STREAMINGSOURCE_HEADER_GUARD)
+#define XALAN_STREAMINGSOURCE_HEADER_GUARD
+
+
+
+// Base include file.  Must be first.
+#include "XSLTDefinitions.hpp"
+
+
+
+#include <xercesc/framework/XMLPScanToken.hpp>
+#include <xercesc/sax/InputSource.hpp>
+#include <xercesc/sax2/ContentHandler.hpp>
+#include <xercesc/sax2/LexicalHandler.hpp>
+
+
+
+#include <xalanc/Include/XalanVector.hpp>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+#include <xalanc/PlatformSupport/AttributesImpl.hpp>
+
+
+
+#include <xalanc/XPath/MutableNodeRefList.hpp>
+#include <xalanc/XPath/NodeRefListBase.hpp>
+#include <xalanc/XPath/XPath.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+using xercesc::InputSource;
+using xercesc::Locator;
+
+
+
+typedef xercesc::Attributes     AttributesType;
+typedef xercesc::ContentHandler ContentHandlerType;
+typedef xercesc::LexicalHandler LexicalHandlerType;
+typedef xercesc::XMLPScanToken  XMLPScanTokenType;
+
+
+
+class ElemTemplateElement;
+class StylesheetExecutionContext;
+class XalanNode;
+class XalanSourceTreeDocument;
+class XalanSourceTreeElement;
+class XalanSourceTreeParserLiaison;
+
+
+
+/**
+ * This class builds a source tree while a stylesheet is being executed,
+ * for stylesheets which the XalanStreamabilityAnalyzer has found to be
+ * streamable.
+ *
+ * The document is parsed progressively.  When a streamable template is
+ * executed for an element whose start tag has just been parsed, the
+ * children of the element are built in a separate document, and the
+ * streamable xsl:apply-templates in the template processes them one by
+ * one as they are parsed.  Once the processed children are no longer
+ * needed, that document is discarded, so the memory used depends on
+ * the depth of the source document, rather than its size.
+ */
+class XALAN_XSLT_EXPORT XalanStreamingSource : public ContentHandlerType, public LexicalHandlerType
+{
+public:
+
+    typedef NodeRefListBase::size_type  size_type;
+
+    /**
+     * Construct an instance.  The document is not parsed until
+     * the first node is requested.
+     *
+     * @param theParserLiaison The liaison for parsing the document, which owns the document
+     * @param theInputSource The input source for the document
+     * @param theManager The MemoryManager instance to use
+     */
+    XalanStreamingSource(
+            XalanSourceTreeParserLiaison&   theParserLiaison,
+            const InputSource&              theInputSource,
+            MemoryManager&                  theManager);
+
+    virtual
+    ~XalanStreamingSource();
+
+    /**
+     * Get the document node of the source, which is empty until
+     * its children are processed.
+     *
+     * @return the document
+     */
+    XalanSourceTreeDocument*
+    getDocument() const
+    {
+        return m_document;
+    }
+
+    /**
+     * Determine if the children of a node have yet to be parsed, so
+     * they can be processed by a streamable xsl:apply-templates.
+     *
+     * @param theNode The node to check
+     * @return true if the node is open
+     */
+    bool
+    isOpen(const XalanNode&     theNode) const;
+
+    /**
+     * Begin the processing of the children of the open node.
+     *
+     * @param theExecutionContext The current execution context
+     * @param theInstruction The streamable xsl:apply-templates
+     * @param theSelect The select expression of the instruction
+     * @return The list which delivers the nodes to process
+     */
+    const NodeRefListBase&
+    beginChildren(
+            StylesheetExecutionContext&     theExecutionContext,
+            const ElemTemplateElement&      theInstruction,
+            const XPath&                    theSelect);
+
+    /**
+     * Get the next node to process from a list returned by
+     * beginChildren().  This may parse more of the document.
+     *
+     * @param theList The list
+     * @return The next node, or 0 if there are no more nodes.
+     */
+    XalanNode*
+    nextNode(const NodeRefListBase&     theList);
+
+    /**
+     * Prepare a node returned by nextNode() for the execution of
+     * its template.  If the template is streamable, and the node
+     * is an open element, its children are delivered by the next
+     * call to beginChildren().  Otherwise, the element is parsed
+     * completely.
+     *
+     * @param theNode The node
+     * @param fStreamable true if the template is streamable
+     */
+    void
+    beginChild(
+            XalanNode*  theNode,
+            bool        fStreamable);
+
+    /**
+     * Parse the rest of the document, ignoring its content, so
+     * any errors are reported.
+     */
+    void
+    finish();
+
+    // These methods are inherited from ContentHandler...
+
+    virtual void
+    characters(
+            const XMLCh* const  chars,
+            const XMLSize_t     length);
+
+    virtual void
+    endDocument();
+
+    virtual void
+    endElement(
+            const XMLCh* const  uri,
+            const XMLCh* const  localname,
+            const XMLCh* const  qname);
+
+    virtual void
+    ignorableWhitespace(
+            const XMLCh* const  chars,
+            const XMLSize_t     length);
+
+    virtual void
+    processingInstruction(
+            const XMLCh* const  target,
+            const XMLCh* const  data);
+
+    virtual void
+    setDocumentLocator(const Locator* const     locator);
+
+    virtual void
+    startDocument();
+
+    virtual void
+    startElement(
+            const XMLCh* const      uri,
+            const XMLCh* const      localname,
+            const XMLCh* const      qname,
+            const AttributesType&   attrs);
+
+    virtual void
+    startPrefixMapping(
+            const XMLCh* const  prefix,
+            const XMLCh* const  uri);
+
+    virtual void
+    endPrefixMapping(const XMLCh* const     prefix);
+
+    virtual void
+    skippedEntity(const XMLCh* const    name);
+
+    // These methods are inherited from LexicalHandler...
+
+    virtual void
+    comment(
+            const XMLCh* const  chars,
+            const XMLSize_t     length);
+
+    virtual void
+    endCDATA();
+
+    virtual void
+    endDTD();
+
+    virtual void
+    endEntity(const XMLCh* const    name);
+
+    virtual void
+    startCDATA();
+
+    virtual void
+    startDTD(
+            const XMLCh* const  name,
+            const XMLCh* const  publicId,
+            const XMLCh* const  systemId);
+
+    virtual void
+    startEntity(const XMLCh* const  name);
+
+private:
+
+    typedef XalanVector<XalanSourceTreeElement*>    ElementStackType;
+    typedef XalanVector<XalanNode*>                 LastChildStackType;
+
+    typedef XPath::OpCodeMapPositionType            OpCodeMapPositionType;
+
+    /**
+     * A child step of the select.  Each child is tested against the
+     * steps as it arrives, rather than by evaluating the select again.
+     */
+    class ChildStep
+    {
+    public:
+
+        ChildStep() :
+            m_tester(),
+            m_predicatePos()
+        {
+        }
+
+        ChildStep(
+                const XPath::NodeTester&    theTester,
+                OpCodeMapPositionType       thePredicatePos) :
+            m_tester(theTester),
+            m_predicatePos(thePredicatePos)
+        {
+        }
+
+        XPath::NodeTester       m_tester;
+
+        // The position of the first predicate in the op map, or of
+        // the end of the step, if it has none.
+        OpCodeMapPositionType   m_predicatePos;
+    };
+
+    typedef XalanVector<ChildStep>                  ChildStepVectorType;
+
+    /**
+     * The children of one open node.  The node list interface
+     * gives the context position of the node being processed.
+     * The earlier children may have been discarded, and the later
+     * ones haven't been parsed, so only the node being processed
+     * can be retrieved.  The XalanStreamabilityAnalyzer rejects
+     * last(), and anything else which would need the others.
+     */
+    class Level : public NodeRefListBase
+    {
+    public:
+
+        Level(MemoryManager&    theManager);
+
+        virtual
+        ~Level();
+
+        virtual XalanNode*
+        item(size_type  index) const;
+
+        virtual size_type
+        getLength() const;
+
+        virtual size_type
+        indexOf(const XalanNode*    theNode) const;
+
+        XalanSourceTreeElement*
+        getCurrentElement() const
+        {
+            return m_elementStack.empty() == false ? m_elementStack.back() : m_containerElement;
+        }
+
+        bool
+        isOpenChild(const XalanNode*    theNode) const;
+
+        void
+        popElement();
+
+        // The node whose children are delivered.
+        XalanNode*                  m_node;
+
+        // The document which holds the children, if it's owned by
+        // this level.
+        XalanSourceTreeDocument*    m_document;
+
+        // The copy of m_node which holds the children, or the
+        // document, for the root.
+        XalanNode*                  m_container;
+
+        XalanSourceTreeElement*     m_containerElement;
+
+        ElementStackType            m_elementStack;
+
+        LastChildStackType          m_lastChildStack;
+
+        XalanNode*                  m_lastChild;
+
+        XalanNode*                  m_lastDelivered;
+
+        // The number of children delivered since the document was
+        // last discarded.
+        size_type                   m_deliveredCount;
+
+        // The number of end tags to ignore when skipping.
+        size_type                   m_skipDepth;
+
+        bool                        m_skipping;
+
+        bool                        m_begun;
+
+        bool                        m_ended;
+
+        const XPath*                m_select;
+
+        ChildStepVectorType         m_childSteps;
+
+        // The attributes selected before the children are parsed.
+        MutableNodeRefList          m_selectedNodes;
+
+        size_type                   m_selectedIndex;
+
+        size_type                   m_position;
+
+        XalanNode*                  m_current;
+
+        StylesheetExecutionContext*     m_executionContext;
+
+        // The name and attributes of the element, for copying
+        // it into the documents of the levels below.
+        XalanDOMString              m_uri;
+
+        XalanDOMString              m_localName;
+
+        XalanDOMString              m_qname;
+
+        AttributesImpl              m_attributes;
+
+    private:
+
+        // Not implemented...
+        Level(const Level&);
+
+        Level&
+        operator=(const Level&);
+    };
+
+    typedef XalanVector<Level*>     LevelStackType;
+
+    enum { eResetThreshold = 32 };
+
+    Level&
+    getEventLevel() const;
+
+    bool
+    parseNext();
+
+    void
+    popLevel();
+
+    void
+    promote(
+            Level&                      theParent,
+            XalanSourceTreeElement*     theElement);
+
+    void
+    buildContainer(Level&   theLevel);
+
+    void
+    destroyDocument(Level&  theLevel);
+
+    void
+    skipOpenChild(Level&    theLevel);
+
+    void
+    addChildSteps(
+            Level&                          theLevel,
+            StylesheetExecutionContext&     theExecutionContext,
+            OpCodeMapPositionType           opPos);
+
+    bool
+    isSelected(
+            Level&      theLevel,
+            XalanNode*  theNode) const;
+
+    XalanNode*
+    deliver(
+            Level&      theLevel,
+            XalanNode*  theNode);
+
+    void
+    processAccumulatedText();
+
+    template <class ChildNodeType>
+    void
+    appendChild(
+            Level&          theLevel,
+            ChildNodeType   theNewChild);
+
+    template <class ChildNodeType>
+    void
+    appendChild(
+            Level&                      theLevel,
+            XalanSourceTreeElement&     theParent,
+            ChildNodeType               theNewChild);
+
+    // Not implemented...
+    XalanStreamingSource(const XalanStreamingSource&);
+
+    XalanStreamingSource&
+    operator=(const XalanStreamingSource&);
+
+
+    // Data members...
+    MemoryManager&                  m_memoryManager;
+
+    XalanSourceTreeParserLiaison&   m_parserLiaison;
+
+    const InputSource&              m_inputSource;
+
+    XMLPScanTokenType               m_scanToken;
+
+    XalanSourceTreeDocument*        m_document;
+
+    LevelStackType                  m_levels;
+
+    XalanDOMString                  m_textBuffer;
+
+    bool                            m_started;
+
+    bool                            m_finished;
+
+    bool                            m_draining;
+
+    bool                            m_inDTD;
+};
+
+
+
+}
+
+
+
+#endif  // XALAN_STREAMINGSOURCE_HEADER_GUARD
@@ -0,0 +1,576 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "XalanTemplateIndex.hpp"
+
+
+
+#include <algorithm>
+
+
+
+#include <xalanc/Include/STLHelper.hpp>
+
+
+
+#include <xalanc/XalanDOM/XalanAttr.hpp>
+
+
+
+#include <xalanc/DOMSupport/DOMServices.hpp>
+
+
+
+#include "ElemTemplate.hpp"
+#include "StylesheetExecutionContext.hpp"
+#include "XalanMatchPatternData.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+const XalanTemplateIndex::PatternTableVectorType    XalanTemplateIndex::s_emptyTemplateList(XalanMemMgrs::getDummyMemMgr());
+
+
+
+XalanTemplateIndex::XalanTemplateIndex(MemoryManager&   theManager) :
+    m_modeTables(theManager)
+{
+}
+
+
+
+XalanTemplateIndex::~XalanTemplateIndex()
+{
+    clear();
+}
+
+
+
+bool
+XalanTemplateIndex::build(const Stylesheet&     theStylesheet)
+{
+    clear();
+
+    if (addStylesheet(theStylesheet) == false)
+    {
+        clear();
+
+        return false;
+    }
+
+    return true;
+}
+
+
+
+void
+XalanTemplateIndex::clear()
+{
+    using std::for_each;
+
+    for_each(
+        m_modeTables.begin(),
+        m_modeTables.end(),
+        makeMapValueDeleteFunctor(m_modeTables));
+
+    m_modeTables.clear();
+}
+
+
+
+const ElemTemplate*
+XalanTemplateIndex::findTemplate(
+            StylesheetExecutionContext&     executionContext,
+            XalanNode*                      targetNode,
+            XalanNode::NodeType             targetNodeType,
+            const XalanQName&               mode) const
+{
+    assert(targetNode != 0);
+    assert(targetNode->getNodeType() == targetNodeType);
+
+    const PatternTableVectorType* const     matchPatternList =
+        locateMatchPatternDataList(*targetNode, targetNodeType, mode);
+
+    if (matchPatternList == 0)
+    {
+        return 0;
+    }
+
+    const PatternTableVectorType::const_iterator    theTableEnd =
+            matchPatternList->end();
+
+    const PatternTableVectorType::const_iterator    theMatch =
+        findMatch(
+            executionContext,
+            targetNode,
+            matchPatternList->begin(),
+            theTableEnd);
+
+    return theMatch == theTableEnd ? 0 : (*theMatch)->getTemplate();
+}
+
+
+
+const ElemTemplate*
+XalanTemplateIndex::findTemplate(
+            StylesheetExecutionContext&     executionContext,
+            XalanNode*                      targetNode,
+            XalanNode::NodeType             targetNodeType,
+            const XalanQName&               mode,
+            bool&                           fConflict) const
+{
+    assert(targetNode != 0);
+    assert(targetNode->getNodeType() == targetNodeType);
+
+    fConflict = false;
+
+    const PatternTableVectorType* const     matchPatternList =
+        locateMatchPatternDataList(*targetNode, targetNodeType, mode);
+
+    if (matchPatternList == 0)
+    {
+        return 0;
+    }
+
+    const PatternTableVectorType::const_iterator    theTableEnd =
+            matchPatternList->end();
+
+    const PatternTableVectorType::const_iterator    theMatch =
+        findMatch(
+            executionContext,
+            targetNode,
+            matchPatternList->begin(),
+            theTableEnd);
+
+    if (theMatch == theTableEnd)
+    {
+        return 0;
+    }
+
+    const ElemTemplate* const   rule = (*theMatch)->getTemplate();
+    assert(rule != 0);
+
+    // Each stylesheet's patterns are ordered by priority, so only
+    // the patterns which follow the match with the same priority
+    // can conflict with it.  A run of patterns with the same priority
+    // may cross into an imported stylesheet, so this can report a
+    // conflict where there is none, but never misses one.
+    const double    thePriority = (*theMatch)->getPriorityOrDefault();
+
+    for (PatternTableVectorType::const_iterator theCurrentEntry = theMatch + 1;
+            theCurrentEntry != theTableEnd &&
+            (*theCurrentEntry)->getPriorityOrDefault() == thePriority;
+                ++theCurrentEntry)
+    {
+        const XalanMatchPatternData* const  matchPat = *theCurrentEntry;
+        assert(matchPat != 0);
+
+        // The alternatives of a union pattern are separate
+        // patterns for the same template.
+        if (matchPat->getTemplate() != rule &&
+            matches(executionContext, targetNode, *matchPat) == true)
+        {
+            fConflict = true;
+
+            break;
+        }
+    }
+
+    return rule;
+}
+
+
+
+const XalanTemplateIndex::PatternTableVectorType*
+XalanTemplateIndex::locateMatchPatternDataList(
+            const XalanNode&        theNode,
+            XalanNode::NodeType     targetNodeType,
+            const XalanQName&       mode) const
+{
+    const ModeTableMapType::const_iterator  theModeTable =
+        m_modeTables.find(XalanQNameByReference(mode));
+
+    if (theModeTable == m_modeTables.end())
+    {
+        return 0;
+    }
+    else
+    {
+        const PatternTableVectorType* const     matchPatternList =
+            (*theModeTable).second->locateMatchPatternDataList(theNode, targetNodeType);
+        assert(matchPatternList != 0);
+
+        return matchPatternList;
+    }
+}
+
+
+
+XalanTemplateIndex::PatternTableVectorType::const_iterator
+XalanTemplateIndex::findMatch(
+            StylesheetExecutionContext&                 executionContext,
+            XalanNode*                                  targetNode,
+            PatternTableVectorType::const_iterator      theCurrentEntry,
+            PatternTableVectorType::const_iterator      theTableEnd)
+{
+    while (theCurrentEntry != theTableEnd)
+    {
+        assert(*theCurrentEntry != 0);
+
+        if (matches(executionContext, targetNode, **theCurrentEntry) == true)
+        {
+            break;
+        }
+
+        ++theCurrentEntry;
+    }
+
+    return theCurrentEntry;
+}
+
+
+
+bool
+XalanTemplateIndex::matches(
+            StylesheetExecutionContext&     executionContext,
+            XalanNode*                      targetNode,
+            const XalanMatchPatternData&    matchPat)
+{
+    const ElemTemplate* const   rule = matchPat.getTemplate();
+    assert(rule != 0);
+
+    const XalanDOMString* const     theNamespaceURI =
+        matchPat.getNameTestNamespace();
+
+    if (theNamespaceURI != 0)
+    {
+        // The local name is the key for the list, so only the
+        // namespace URI needs to be checked.
+        return targetNode->getNamespaceURI() == *theNamespaceURI;
+    }
+    else
+    {
+        const XPath* const  xpath = matchPat.getExpression();
+
+        const XPath::eMatchScore    score =
+            xpath->getMatchScore(targetNode, rule->getStylesheet(), executionContext);
+
+        return XPath::eMatchScoreNone != score;
+    }
+}
+
+
+
+bool
+XalanTemplateIndex::addStylesheet(const Stylesheet&     theStylesheet)
+{
+    if (theStylesheet.m_isWrapperless == true)
+    {
+        return false;
+    }
+
+    // Make sure there's a table for every mode in the stylesheet
+    // first, so every table gets patterns from every list.
+    {
+        typedef PatternTableMapType::const_iterator     const_iterator;
+
+        const const_iterator    theEnd = theStylesheet.m_elementPatternTable.end();
+
+        for (const_iterator i = theStylesheet.m_elementPatternTable.begin(); i != theEnd; ++i)
+        {
+            addModeTables((*i).second);
+        }
+    }
+
+    {
+        typedef PatternTableMapType::const_iterator     const_iterator;
+
+        const const_iterator    theEnd = theStylesheet.m_attributePatternTable.end();
+
+        for (const_iterator i = theStylesheet.m_attributePatternTable.begin(); i != theEnd; ++i)
+        {
+            addModeTables((*i).second);
+        }
+    }
+
+    addModeTables(theStylesheet.m_elementAnyPatternList);
+    addModeTables(theStylesheet.m_attributeAnyPatternList);
+    addModeTables(theStylesheet.m_textPatternList);
+    addModeTables(theStylesheet.m_commentPatternList);
+    addModeTables(theStylesheet.m_rootPatternList);
+    addModeTables(theStylesheet.m_piPatternList);
+    addModeTables(theStylesheet.m_nodePatternList);
+
+    {
+        const ModeTableMapType::iterator    theEnd = m_modeTables.end();
+
+        for (ModeTableMapType::iterator i = m_modeTables.begin(); i != theEnd; ++i)
+        {
+            (*i).second->addPatterns(theStylesheet);
+        }
+    }
+
+    // Imports are searched in the same order as
+    // Stylesheet::findTemplateInImports() does.
+    const Stylesheet::StylesheetVectorType&     theImports =
+        theStylesheet.m_imports;
+
+    for (Stylesheet::StylesheetVectorType::size_type i = 0; i < theImports.size(); ++i)
+    {
+        assert(theImports[i] != 0);
+
+        if (addStylesheet(*theImports[i]) == false)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+
+void
+XalanTemplateIndex::addModeTables(const PatternTableVectorType&     theList)
+{
+    const PatternTableVectorType::const_iterator    theEnd = theList.end();
+
+    for (PatternTableVectorType::const_iterator i = theList.begin(); i != theEnd; ++i)
+    {
+        assert(*i != 0 && (*i)->getTemplate() != 0);
+
+        const XalanQName&   theMode = (*i)->getTemplate()->getMode();
+
+        const XalanQNameByReference     theKey(theMode);
+
+        if (m_modeTables.find(theKey) == m_modeTables.end())
+        {
+            XalanMemMgrAutoPtr<ModeTable>   theGuard(
+                                                m_modeTables.getMemoryManager(),
+                                                ModeTable::create(
+                                                    m_modeTables.getMemoryManager(),
+                                                    theMode));
+
+            m_modeTables.insert(theKey, theGuard.get());
+
+            theGuard.release();
+        }
+    }
+}
+
+
+
+XalanTemplateIndex::ModeTable::ModeTable(
+            MemoryManager&      theManager,
+            const XalanQName&   theMode) :
+    m_mode(theMode),
+    m_elementPatternTable(theManager),
+    m_elementAnyPatternList(theManager),
+    m_attributePatternTable(theManager),
+    m_attributeAnyPatternList(theManager),
+    m_textPatternList(theManager),
+    m_commentPatternList(theManager),
+    m_rootPatternList(theManager),
+    m_piPatternList(theManager),
+    m_nodePatternList(theManager)
+{
+}
+
+
+
+XalanTemplateIndex::ModeTable*
+XalanTemplateIndex::ModeTable::create(
+            MemoryManager&      theManager,
+            const XalanQName&   theMode)
+{
+    typedef ModeTable   ThisType;
+
+    XalanAllocationGuard    theGuard(theManager, theManager.allocate(sizeof(ThisType)));
+
+    ThisType* const     theResult =
+        new (theGuard.get()) ThisType(
+                                theManager,
+                                theMode);
+
+    theGuard.release();
+
+    return theResult;
+}
+
+
+
+void
+XalanTemplateIndex::ModeTable::addPatterns(const Stylesheet&    theStylesheet)
+{
+    addPatterns(
+        theStylesheet.m_elementPatternTable,
+        theStylesheet.m_elementAnyPatternList,
+        m_elementPatternTable,
+        m_elementAnyPatternList);
+
+    addPatterns(
+        theStylesheet.m_attributePatternTable,
+        theStylesheet.m_attributeAnyPatternList,
+        m_attributePatternTable,
+        m_attributeAnyPatternList);
+
+    addPatterns(theStylesheet.m_textPatternList, m_textPatternList);
+    addPatterns(theStylesheet.m_commentPatternList, m_commentPatternList);
+    addPatterns(theStylesheet.m_rootPatternList, m_rootPatternList);
+    addPatterns(theStylesheet.m_piPatternList, m_piPatternList);
+    addPatterns(theStylesheet.m_nodePatternList, m_nodePatternList);
+}
+
+
+
+void
+XalanTemplateIndex::ModeTable::addPatterns(
+            const PatternTableMapType&      theSourceTable,
+            const PatternTableVectorType&   theSourceAnyList,
+            PatternTableMapType&            theTable,
+            PatternTableVectorType&         theAnyList) const
+{
+    typedef PatternTableMapType::iterator           iterator;
+    typedef PatternTableMapType::const_iterator     const_iterator;
+
+    // For names which are already in the table, the stylesheet
+    // contributes its own list for the name, if it has one, or
+    // its list of wildcard patterns, which is what
+    // Stylesheet::locateMatchPatternDataList() would find.
+    {
+        const iterator  theEnd = theTable.end();
+
+        for (iterator i = theTable.begin(); i != theEnd; ++i)
+        {
+            const const_iterator    theSourceList =
+                theSourceTable.find((*i).first);
+
+            addPatterns(
+                theSourceList == theSourceTable.end() ?
+                    theSourceAnyList :
+                    (*theSourceList).second,
+                (*i).second);
+        }
+    }
+
+    // Names which are new start with the wildcard patterns from
+    // the stylesheets that have already been added.
+    {
+        const const_iterator    theEnd = theSourceTable.end();
+
+        for (const_iterator i = theSourceTable.begin(); i != theEnd; ++i)
+        {
+            if (theTable.find((*i).first) == theTable.end())
+            {
+                PatternTableVectorType&     theList = theTable[(*i).first];
+
+                theList = theAnyList;
+
+                addPatterns((*i).second, theList);
+            }
+        }
+    }
+
+    addPatterns(theSourceAnyList, theAnyList);
+}
+
+
+
+void
+XalanTemplateIndex::ModeTable::addPatterns(
+            const PatternTableVectorType&   theSource,
+            PatternTableVectorType&         theList) const
+{
+    const PatternTableVectorType::const_iterator    theEnd = theSource.end();
+
+    for (PatternTableVectorType::const_iterator i = theSource.begin(); i != theEnd; ++i)
+    {
+        assert(*i != 0 && (*i)->getTemplate() != 0);
+
+        if ((*i)->getTemplate()->getMode() == m_mode)
+        {
+            theList.push_back(*i);
+        }
+    }
+}
+
+
+
+const XalanTemplateIndex::PatternTableVectorType*
+XalanTemplateIndex::ModeTable::locateMatchPatternDataList(
+            const XalanNode&        theNode,
+            XalanNode::NodeType     targetNodeType) const
+{
+    assert(theNode.getNodeType() == targetNodeType);
+
+    switch(targetNodeType)
+    {
+    case XalanNode::ELEMENT_NODE:
+        {
+            const PatternTableMapType::const_iterator   i =
+                m_elementPatternTable.find(DOMServices::getLocalNameOfNode(theNode));
+
+            return i != m_elementPatternTable.end() ? &(*i).second : &m_elementAnyPatternList;
+        }
+        break;
+
+    case XalanNode::PROCESSING_INSTRUCTION_NODE:
+        return &m_piPatternList;
+        break;
+
+    case XalanNode::ATTRIBUTE_NODE:
+        if ((DOMServices::isNamespaceDeclaration(static_cast<const XalanAttr&>(theNode)) == true))
+        {
+            return &s_emptyTemplateList;
+        }
+        else
+        {
+            const PatternTableMapType::const_iterator   i =
+                m_attributePatternTable.find(DOMServices::getLocalNameOfNode(theNode));
+
+            return i != m_attributePatternTable.end() ? &(*i).second : &m_attributeAnyPatternList;
+        }
+        break;
+
+    case XalanNode::CDATA_SECTION_NODE:
+    case XalanNode::TEXT_NODE:
+        return &m_textPatternList;
+        break;
+
+    case XalanNode::COMMENT_NODE:
+        return &m_commentPatternList;
+        break;
+
+    case XalanNode::DOCUMENT_NODE:
+    case XalanNode::DOCUMENT_FRAGMENT_NODE:
+        return &m_rootPatternList;
+        break;
+
+    default:
+        break;
+    }
+
+    return &m_nodePatternList;
+}
+
+
+
+}
@@ -0,0 +1,244 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALAN_TEMPLATEINDEX_HEADER_GUARD)
+#define XALAN_TEMPLATEINDEX_HEADER_GUARD
+
+
+
+// Base include file.  Must be first.
+#include "XSLTDefinitions.hpp"
+
+
+
+#include <xalanc/Include/XalanMap.hpp>
+
+
+
+#include <xalanc/XPath/XalanQNameByReference.hpp>
+
+
+
+#include "Stylesheet.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+class ElemTemplate;
+class StylesheetExecutionContext;
+class XalanNode;
+
+
+
+/**
+ * This class holds the match patterns of all of the templates in
+ * a stylesheet and the stylesheets it imports, in one table for
+ * each mode.  The stylesheets are flattened in order of import
+ * precedence, so the first pattern in a list which matches a node
+ * selects the template for the node, without searching each imported
+ * stylesheet in turn.
+ */
+class XALAN_XSLT_EXPORT XalanTemplateIndex
+{
+public:
+
+    typedef Stylesheet::PatternTableVectorType  PatternTableVectorType;
+    typedef Stylesheet::PatternTableMapType     PatternTableMapType;
+
+    XalanTemplateIndex(MemoryManager&   theManager);
+
+    ~XalanTemplateIndex();
+
+    /**
+     * Build the index for a stylesheet and its imports.  If any
+     * stylesheet in the import tree cannot be indexed, the index
+     * is left empty.
+     *
+     * @param theStylesheet The stylesheet to index
+     * @return true if the index was built, false if not.
+     */
+    bool
+    build(const Stylesheet&     theStylesheet);
+
+    /**
+     * Clear the index.
+     */
+    void
+    clear();
+
+    /**
+     * Determine if the index is empty.
+     *
+     * @return true if the index has no entries
+     */
+    bool
+    empty() const
+    {
+        return m_modeTables.empty();
+    }
+
+    /**
+     * Find the template with the highest import precedence and
+     * priority that matches a node.  Conflicts are resolved quietly,
+     * by choosing the template that occurs last in the stylesheet.
+     *
+     * @param executionContext The current execution context
+     * @param targetNode The node that needs a template
+     * @param targetNodeType The type of targetNode
+     * @param mode The current mode
+     * @return a pointer to the template, or 0 if no template matches
+     */
+    const ElemTemplate*
+    findTemplate(
+            StylesheetExecutionContext&     executionContext,
+            XalanNode*                      targetNode,
+            XalanNode::NodeType             targetNodeType,
+            const XalanQName&               mode) const;
+
+    /**
+     * Find the template with the highest import precedence and
+     * priority that matches a node, and determine if another template
+     * with the same priority also matches it.  When there's a conflict,
+     * the caller can search the stylesheet, to report it.
+     *
+     * @param executionContext The current execution context
+     * @param targetNode The node that needs a template
+     * @param targetNodeType The type of targetNode
+     * @param mode The current mode
+     * @param fConflict Set to true if there may be a conflict, false if not
+     * @return a pointer to the template, or 0 if no template matches
+     */
+    const ElemTemplate*
+    findTemplate(
+            StylesheetExecutionContext&     executionContext,
+            XalanNode*                      targetNode,
+            XalanNode::NodeType             targetNodeType,
+            const XalanQName&               mode,
+            bool&                           fConflict) const;
+
+private:
+
+    /**
+     * The pattern lists for a single mode.  These are the same as the
+     * lists in Stylesheet, except that they contain the patterns from
+     * the whole import tree.
+     */
+    class ModeTable
+    {
+    public:
+
+        ModeTable(
+                MemoryManager&      theManager,
+                const XalanQName&   theMode);
+
+        static ModeTable*
+        create(
+                MemoryManager&      theManager,
+                const XalanQName&   theMode);
+
+        void
+        addPatterns(const Stylesheet&   theStylesheet);
+
+        const PatternTableVectorType*
+        locateMatchPatternDataList(
+                const XalanNode&        theNode,
+                XalanNode::NodeType     targetNodeType) const;
+
+    private:
+
+        void
+        addPatterns(
+                const PatternTableMapType&      theSourceTable,
+                const PatternTableVectorType&   theSourceAnyList,
+                PatternTableMapType&            theTable,
+                PatternTableVectorType&         theAnyList) const;
+
+        void
+        addPatterns(
+                const PatternTableVectorType&   theSource,
+                PatternTableVectorType&         theList) const;
+
+        const XalanQNameByReference     m_mode;
+
+        PatternTableMapType             m_elementPatternTable;
+
+        PatternTableVectorType          m_elementAnyPatternList;
+
+        PatternTableMapType             m_attributePatternTable;
+
+        PatternTableVectorType          m_attributeAnyPatternList;
+
+        PatternTableVectorType          m_textPatternList;
+
+        PatternTableVectorType          m_commentPatternList;
+
+        PatternTableVectorType          m_rootPatternList;
+
+        PatternTableVectorType          m_piPatternList;
+
+        PatternTableVectorType          m_nodePatternList;
+    };
+
+    typedef XalanMap<XalanQNameByReference, ModeTable*>     ModeTableMapType;
+
+    // Not implemented...
+    XalanTemplateIndex(const XalanTemplateIndex&);
+
+    XalanTemplateIndex&
+    operator=(const XalanTemplateIndex&);
+
+    const PatternTableVectorType*
+    locateMatchPatternDataList(
+            const XalanNode&        theNode,
+            XalanNode::NodeType     targetNodeType,
+            const XalanQName&       mode) const;
+
+    static PatternTableVectorType::const_iterator
+    findMatch(
+            StylesheetExecutionContext&                 executionContext,
+            XalanNode*                                  targetNode,
+            PatternTableVectorType::const_iterator      theCurrentEntry,
+            PatternTableVectorType::const_iterator      theTableEnd);
+
+    static bool
+    matches(
+            StylesheetExecutionContext&     executionContext,
+            XalanNode*                      targetNode,
+            const XalanMatchPatternData&    matchPat);
+
+    bool
+    addStylesheet(const Stylesheet&     theStylesheet);
+
+    void
+    addModeTables(const PatternTableVectorType&     theList);
+
+    // Data members...
+    ModeTableMapType    m_modeTables;
+
+    static const PatternTableVectorType     s_emptyTemplateList;
+};
+
+
+
+}
+
+
+
+#endif  // XALAN_TEMPLATEINDEX_HEADER_GUARD
@@ -0,0 +1,589 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "XalanVariableResolver.hpp"
+
+
+
+#include <algorithm>
+
+
+
+#include <xalanc/XPath/XPath.hpp>
+#include <xalanc/XPath/XPathExpression.hpp>
+#include <xalanc/XPath/XToken.hpp>
+
+
+
+#include "ElemAttributeSet.hpp"
+#include "ElemForEach.hpp"
+#include "ElemSort.hpp"
+#include "ElemTemplate.hpp"
+#include "ElemVariable.hpp"
+#include "KeyDeclaration.hpp"
+#include "StylesheetConstructionContext.hpp"
+#include "StylesheetRoot.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+static int
+getFunctionID(
+            const char*         theName,
+            XalanDOMString&     theBuffer)
+{
+    theBuffer = theName;
+
+    return XPath::getFunctionTable().nameToID(theBuffer);
+}
+
+
+
+XalanVariableResolver::XalanVariableResolver(MemoryManager&    theManager) :
+    m_slots(theManager),
+    m_locals(theManager),
+    m_nextLocalSlot(-1),
+    m_globals(theManager),
+    m_states(theManager),
+    m_pureFunctionIDs(theManager),
+    m_contextFunctionIDs(theManager)
+{
+    static const char* const    thePureFunctions[] =
+    {
+        "boolean",
+        "ceiling",
+        "concat",
+        "contains",
+        "false",
+        "floor",
+        "normalize-space",
+        "not",
+        "number",
+        "round",
+        "starts-with",
+        "string",
+        "string-length",
+        "substring",
+        "substring-after",
+        "substring-before",
+        "translate",
+        "true"
+    };
+
+    static const char* const    theContextFunctions[] =
+    {
+        "normalize-space",
+        "number",
+        "string",
+        "string-length"
+    };
+
+    XalanDOMString  theBuffer(theManager);
+
+    const size_t    thePureCount = sizeof(thePureFunctions) / sizeof(thePureFunctions[0]);
+
+    for (size_t i = 0; i < thePureCount; ++i)
+    {
+        m_pureFunctionIDs.push_back(getFunctionID(thePureFunctions[i], theBuffer));
+    }
+
+    const size_t    theContextCount = sizeof(theContextFunctions) / sizeof(theContextFunctions[0]);
+
+    for (size_t i = 0; i < theContextCount; ++i)
+    {
+        m_contextFunctionIDs.push_back(getFunctionID(theContextFunctions[i], theBuffer));
+    }
+}
+
+
+
+XalanVariableResolver::~XalanVariableResolver()
+{
+}
+
+
+
+void
+XalanVariableResolver::resolve(StylesheetRoot&    theStylesheet)
+{
+    m_slots.clear();
+    m_locals.clear();
+    m_globals.clear();
+
+    collectGlobals(theStylesheet);
+
+    resolveStylesheet(theStylesheet);
+
+    typedef StylesheetRoot::AttributeSetMapType::const_iterator     const_iterator;
+    typedef StylesheetRoot::AttributeSetVectorType::const_iterator  vector_iterator;
+
+    const const_iterator    theEnd = theStylesheet.m_attributeSetsMap.end();
+
+    for (const_iterator i = theStylesheet.m_attributeSetsMap.begin(); i != theEnd; ++i)
+    {
+        const vector_iterator   theVectorEnd = (*i).second.end();
+
+        for (vector_iterator j = (*i).second.begin(); j != theVectorEnd; ++j)
+        {
+            assert(*j != 0);
+
+            resolveRoot(**j, false);
+        }
+    }
+
+    // Now that every reference has its slot, find the variables
+    // whose values can be cached.
+    m_states.clear();
+    m_states.resize(m_globals.size(), eUnknown);
+
+    for (IntVectorType::size_type i = 0; i < m_globals.size(); ++i)
+    {
+        isConstantVariable(int(i));
+
+        if (m_states[i] == eConstant)
+        {
+            ElemVariable* const     theVariable = m_globals[i];
+            assert(theVariable != 0);
+
+            theVariable->m_globalValueIndex =
+                int(theStylesheet.m_globalValueCache.addEntry());
+        }
+    }
+
+    m_slots.clear();
+    m_globals.clear();
+}
+
+
+
+void
+XalanVariableResolver::collectGlobals(const Stylesheet&  theStylesheet)
+{
+    // A name declared in more than one stylesheet gets a single slot,
+    // since the declaration with the highest import precedence is the
+    // one found on the stack.
+    typedef Stylesheet::ElemVariableVectorType::const_iterator  const_iterator;
+
+    const const_iterator    theEnd = theStylesheet.m_topLevelVariables.end();
+
+    for (const_iterator i = theStylesheet.m_topLevelVariables.begin(); i != theEnd; ++i)
+    {
+        assert(*i != 0);
+
+        const XalanQNameByReference     theName((*i)->getNameAttribute());
+
+        if (m_slots.find(theName) == m_slots.end())
+        {
+            const int   theSlot = int(m_slots.size());
+
+            m_slots[theName] = theSlot;
+
+            m_globals.push_back(*i);
+        }
+    }
+
+    typedef Stylesheet::StylesheetVectorType::const_iterator    stylesheet_iterator;
+
+    const stylesheet_iterator   theImportsEnd = theStylesheet.m_imports.end();
+
+    for (stylesheet_iterator i = theStylesheet.m_imports.begin(); i != theImportsEnd; ++i)
+    {
+        assert(*i != 0);
+
+        collectGlobals(**i);
+    }
+}
+
+
+
+void
+XalanVariableResolver::resolveStylesheet(const Stylesheet&   theStylesheet)
+{
+    {
+        typedef Stylesheet::KeyDeclarationVectorType::const_iterator    const_iterator;
+
+        const const_iterator    theEnd = theStylesheet.m_keyDeclarations.end();
+
+        for (const_iterator i = theStylesheet.m_keyDeclarations.begin(); i != theEnd; ++i)
+        {
+            assert((*i).getMatchPattern() != 0 && (*i).getUse() != 0);
+
+            resolveXPath(*(*i).getMatchPattern());
+            resolveXPath(*(*i).getUse());
+        }
+    }
+
+    {
+        typedef Stylesheet::ElemVariableVectorType::const_iterator  const_iterator;
+
+        const const_iterator    theEnd = theStylesheet.m_topLevelVariables.end();
+
+        for (const_iterator i = theStylesheet.m_topLevelVariables.begin(); i != theEnd; ++i)
+        {
+            assert(*i != 0);
+
+            resolveRoot(**i, true);
+        }
+    }
+
+    for (const ElemTemplateElement* theTemplate = theStylesheet.m_firstTemplate;
+            theTemplate != 0;
+                theTemplate = theTemplate->getNextSiblingElem())
+    {
+        resolveRoot(*theTemplate, true);
+    }
+
+    typedef Stylesheet::StylesheetVectorType::const_iterator    const_iterator;
+
+    const const_iterator    theEnd = theStylesheet.m_imports.end();
+
+    for (const_iterator i = theStylesheet.m_imports.begin(); i != theEnd; ++i)
+    {
+        assert(*i != 0);
+
+        resolveStylesheet(**i);
+    }
+}
+
+
+
+void
+XalanVariableResolver::resolveRoot(
+            const ElemTemplateElement&  theElement,
+            bool                        fAssignLocalSlots)
+{
+    assert(m_locals.empty() == true);
+
+    m_nextLocalSlot = fAssignLocalSlots == true ? 0 : -1;
+
+    resolveElement(theElement);
+
+    m_nextLocalSlot = -1;
+}
+
+
+
+void
+XalanVariableResolver::resolveElement(const ElemTemplateElement&     theElement)
+{
+    const XPath*    theXPath = 0;
+
+    for (XalanSize_t i = 0; (theXPath = theElement.getXPath(i)) != 0; ++i)
+    {
+        resolveXPath(*theXPath);
+    }
+
+    const int   theToken = theElement.getXSLToken();
+
+    if (theToken == StylesheetConstructionContext::ELEMNAME_FOR_EACH ||
+        theToken == StylesheetConstructionContext::ELEMNAME_APPLY_TEMPLATES)
+    {
+        // The sort keys are not children of the element.
+        typedef ElemForEach::SortElemsVectorType    SortElemsVectorType;
+
+        const SortElemsVectorType&  theSortElems =
+            static_cast<const ElemForEach&>(theElement).getSortElems();
+
+        const SortElemsVectorType::const_iterator   theEnd = theSortElems.end();
+
+        for (SortElemsVectorType::const_iterator i = theSortElems.begin(); i != theEnd; ++i)
+        {
+            assert(*i != 0);
+
+            resolveElement(**i);
+        }
+    }
+
+    // A variable is in scope for its following siblings and their
+    // descendants, but not for its own content.
+    const ElemVariableVectorType::size_type     theLocalsSize = m_locals.size();
+
+    for (const ElemTemplateElement* theChild = theElement.getFirstChildElem();
+            theChild != 0;
+                theChild = theChild->getNextSiblingElem())
+    {
+        resolveElement(*theChild);
+
+        const int   theChildToken = theChild->getXSLToken();
+
+        if (theChildToken == StylesheetConstructionContext::ELEMNAME_VARIABLE ||
+            theChildToken == StylesheetConstructionContext::ELEMNAME_PARAM)
+        {
+            // The element belongs to the stylesheet being constructed,
+            // so it's safe to modify it.
+            ElemVariable* const     theVariable =
+                const_cast<ElemVariable*>(static_cast<const ElemVariable*>(theChild));
+
+            if (m_nextLocalSlot != -1)
+            {
+                theVariable->m_localSlot = m_nextLocalSlot++;
+            }
+
+            m_locals.push_back(theVariable);
+        }
+    }
+
+    m_locals.resize(theLocalsSize);
+}
+
+
+
+void
+XalanVariableResolver::resolveXPath(const XPath&     theXPath)
+{
+    // The expression belongs to the stylesheet being constructed, so
+    // it's safe to modify it.
+    XPathExpression&    theExpression =
+        const_cast<XPath&>(theXPath).getExpression();
+
+    typedef XPathExpression::OpCodeMapValueVectorType   OpCodeMapValueVectorType;
+    typedef XPathExpression::OpCodeMapSizeType          OpCodeMapSizeType;
+
+    const OpCodeMapValueVectorType&     theReferences =
+        theExpression.getVariableReferences();
+
+    for (OpCodeMapValueVectorType::size_type i = 0; i < theReferences.size(); ++i)
+    {
+        const OpCodeMapSizeType     opPos = theReferences[i];
+
+        assert(theExpression.getOpCodeMapValue(opPos) == XPathExpression::eOP_VARIABLE);
+
+        const XToken* const     theNamespace =
+            theExpression.getToken(theExpression.getOpCodeMapValue(opPos + 2));
+        assert(theNamespace != 0);
+
+        const XToken* const     theLocalName =
+            theExpression.getToken(theExpression.getOpCodeMapValue(opPos + 3));
+        assert(theLocalName != 0);
+
+        const XalanQNameByReference     theName(theNamespace->str(), theLocalName->str());
+
+        const ElemVariable* const   theLocal = findLocal(theName);
+
+        if (theLocal == 0)
+        {
+            const SlotMapType::const_iterator   theSlot = m_slots.find(theName);
+
+            if (theSlot != m_slots.end())
+            {
+                theExpression.setOpCodeMapValue(opPos + 4, (*theSlot).second);
+            }
+        }
+        else if (theLocal->m_localSlot != -1)
+        {
+            theExpression.setOpCodeMapValue(opPos + 5, theLocal->m_localSlot);
+        }
+    }
+}
+
+
+
+const ElemVariable*
+XalanVariableResolver::findLocal(const XalanQName&    theName) const
+{
+    // The innermost declaration is the one in scope.
+    for (ElemVariableVectorType::size_type i = m_locals.size(); i > 0; --i)
+    {
+        const ElemVariable* const   theLocal = m_locals[i - 1];
+        assert(theLocal != 0);
+
+        if (theLocal->getNameAttribute().equals(theName) == true)
+        {
+            return theLocal;
+        }
+    }
+
+    return 0;
+}
+
+
+
+bool
+XalanVariableResolver::isConstantVariable(int     theSlot)
+{
+    assert(theSlot >= 0 && IntVectorType::size_type(theSlot) < m_states.size());
+
+    if (m_states[theSlot] == eUnknown)
+    {
+        // A circular definition is an error, which is reported when
+        // the variable is evaluated.
+        m_states[theSlot] = eInProgress;
+
+        const ElemVariable* const   theVariable = m_globals[theSlot];
+        assert(theVariable != 0);
+
+        const XPath* const  theSelect = theVariable->m_selectPattern;
+
+        const bool  fConstant =
+            theSelect != 0 &&
+            isConstantExpression(
+                theSelect->getExpression(),
+                theSelect->getExpression().getInitialOpCodePosition());
+
+        m_states[theSlot] = fConstant == true ? eConstant : eNotConstant;
+    }
+
+    if (m_states[theSlot] != eConstant)
+    {
+        return false;
+    }
+    else
+    {
+        // The value of a parameter may be set for each transformation,
+        // so references to it are not constant, even though its default
+        // value can be cached.
+        return m_globals[theSlot]->getXSLToken() != StylesheetConstructionContext::ELEMNAME_PARAM;
+    }
+}
+
+
+
+bool
+XalanVariableResolver::isConstantExpression(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos)
+{
+    switch(theExpression.getOpCodeMapValue(opPos))
+    {
+    case XPathExpression::eOP_XPATH:
+    case XPathExpression::eOP_OR:
+    case XPathExpression::eOP_AND:
+    case XPathExpression::eOP_NOTEQUALS:
+    case XPathExpression::eOP_EQUALS:
+    case XPathExpression::eOP_LTE:
+    case XPathExpression::eOP_LT:
+    case XPathExpression::eOP_GTE:
+    case XPathExpression::eOP_GT:
+    case XPathExpression::eOP_PLUS:
+    case XPathExpression::eOP_MINUS:
+    case XPathExpression::eOP_MULT:
+    case XPathExpression::eOP_DIV:
+    case XPathExpression::eOP_MOD:
+    case XPathExpression::eOP_NEG:
+    case XPathExpression::eOP_BOOL:
+    case XPathExpression::eOP_GROUP:
+    case XPathExpression::eOP_ARGUMENT:
+    case XPathExpression::eOP_FUNCTION_NOT:
+    case XPathExpression::eOP_FUNCTION_BOOLEAN:
+    case XPathExpression::eOP_FUNCTION_FLOOR:
+    case XPathExpression::eOP_FUNCTION_CEILING:
+    case XPathExpression::eOP_FUNCTION_ROUND:
+    case XPathExpression::eOP_FUNCTION_NUMBER_1:
+    case XPathExpression::eOP_FUNCTION_STRING_1:
+    case XPathExpression::eOP_FUNCTION_STRINGLENGTH_1:
+    case XPathExpression::eOP_FUNCTION_CONCAT:
+    case XPathExpression::eOP_FUNCTION_TRANSLATE:
+        {
+            const OpCodeMapPositionType     theEnd =
+                theExpression.getNextOpCodePosition(opPos);
+
+            // The table index and the argument count precede the
+            // arguments of a compiled translate() call.
+            const OpCodeMapPositionType     theStart =
+                theExpression.getOpCodeMapValue(opPos) == XPathExpression::eOP_FUNCTION_TRANSLATE ?
+                    opPos + 4 : opPos + 2;
+
+            for (OpCodeMapPositionType i = theStart;
+                    i < theEnd && theExpression.getOpCodeMapValue(i) != XPathExpression::eENDOP;
+                        i = theExpression.getNextOpCodePosition(i))
+            {
+                if (isConstantExpression(theExpression, i) == false)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+    case XPathExpression::eOP_LITERAL:
+    case XPathExpression::eOP_NUMBERLIT:
+    case XPathExpression::eOP_FUNCTION_TRUE:
+    case XPathExpression::eOP_FUNCTION_FALSE:
+        return true;
+
+    case XPathExpression::eOP_VARIABLE:
+        {
+            const int   theSlot = theExpression.getOpCodeMapValue(opPos + 4);
+
+            return theSlot != XPathExpression::eUnresolvedVariableSlot &&
+                   isConstantVariable(theSlot);
+        }
+
+    case XPathExpression::eOP_FUNCTION:
+        return isConstantFunction(theExpression, opPos);
+
+    default:
+        // Location paths, extension functions, and anything else which
+        // might depend on the source document or the transformation.
+        return false;
+    }
+}
+
+
+
+bool
+XalanVariableResolver::isConstantFunction(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos)
+{
+    const int   theFunctionID = theExpression.getOpCodeMapValue(opPos + 2);
+    const int   theArgCount = theExpression.getOpCodeMapValue(opPos + 3);
+
+    using std::find;
+
+    if (find(
+            m_pureFunctionIDs.begin(),
+            m_pureFunctionIDs.end(),
+            theFunctionID) == m_pureFunctionIDs.end())
+    {
+        return false;
+    }
+    else if (theArgCount == 0 &&
+             find(
+                m_contextFunctionIDs.begin(),
+                m_contextFunctionIDs.end(),
+                theFunctionID) != m_contextFunctionIDs.end())
+    {
+        return false;
+    }
+    else
+    {
+        const OpCodeMapPositionType     theEnd =
+            theExpression.getNextOpCodePosition(opPos);
+
+        for (OpCodeMapPositionType i = opPos + 4;
+                i < theEnd && theExpression.getOpCodeMapValue(i) != XPathExpression::eENDOP;
+                    i = theExpression.getNextOpCodePosition(i))
+        {
+            if (isConstantExpression(theExpression, i) == false)
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+}
+
+
+
+}
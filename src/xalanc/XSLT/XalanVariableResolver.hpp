@@ -0,0 +1,161 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALAN_VARIABLERESOLVER_HEADER_GUARD)
+#define XALAN_VARIABLERESOLVER_HEADER_GUARD
+
+
+
+// Base include file.  Must be first.
+#include "XSLTDefinitions.hpp"
+
+
+
+#include <xalanc/Include/XalanMap.hpp>
+#include <xalanc/Include/XalanVector.hpp>
+
+
+
+#include <xalanc/XPath/XPath.hpp>
+#include <xalanc/XPath/XalanQNameByReference.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+class ElemTemplateElement;
+class ElemVariable;
+class Stylesheet;
+class StylesheetRoot;
+
+
+
+/**
+ * This class resolves the variable references in the expressions of a
+ * stylesheet to slots, so they can be found without searching the
+ * variables stack by name.  Each distinct global variable name is
+ * assigned a global slot.  Each local variable and param is assigned a
+ * local slot, numbered from 0 in its template or in the content of its
+ * top-level variable, and is bound to that slot in its stack frame when
+ * it is pushed.  Each reference records the slot of the variable in
+ * scope in its op code.  Locals in attribute sets are not assigned
+ * slots, since attribute sets are executed in their caller's frame.
+ *
+ * Global variables whose select expression depends only on literals,
+ * pure functions and other such variables are also assigned an entry in
+ * the stylesheet's cache of global values, so they are only evaluated
+ * once for all transformations.
+ */
+class XALAN_XSLT_EXPORT XalanVariableResolver
+{
+public:
+
+    XalanVariableResolver(MemoryManager&  theManager);
+
+    ~XalanVariableResolver();
+
+    /**
+     * Resolve the variable references in a stylesheet and its imports,
+     * and find the global variables whose values can be cached.
+     *
+     * @param theStylesheet The stylesheet to resolve
+     */
+    void
+    resolve(StylesheetRoot&     theStylesheet);
+
+private:
+
+    typedef XPath::OpCodeMapPositionType    OpCodeMapPositionType;
+
+    typedef XalanMap<XalanQNameByReference, int>    SlotMapType;
+    typedef XalanVector<ElemVariable*>              ElemVariableVectorType;
+    typedef XalanVector<int>                        IntVectorType;
+
+    enum eConstantState
+    {
+        eUnknown,
+        eInProgress,
+        eConstant,
+        eNotConstant
+    };
+
+    void
+    collectGlobals(const Stylesheet&    theStylesheet);
+
+    void
+    resolveStylesheet(const Stylesheet&     theStylesheet);
+
+    void
+    resolveRoot(
+            const ElemTemplateElement&  theElement,
+            bool                        fAssignLocalSlots);
+
+    void
+    resolveElement(const ElemTemplateElement&   theElement);
+
+    void
+    resolveXPath(const XPath&   theXPath);
+
+    const ElemVariable*
+    findLocal(const XalanQName&     theName) const;
+
+    bool
+    isConstantVariable(int  theSlot);
+
+    bool
+    isConstantExpression(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos);
+
+    bool
+    isConstantFunction(
+            const XPathExpression&  theExpression,
+            OpCodeMapPositionType   opPos);
+
+
+    // Data members...
+    SlotMapType             m_slots;
+
+    // The local variables and params in scope.
+    ElemVariableVectorType  m_locals;
+
+    // The next local slot in the current template, or -1 if locals
+    // are not assigned slots.
+    int                     m_nextLocalSlot;
+
+    // The declaration found for each slot.
+    ElemVariableVectorType  m_globals;
+
+    // The eConstantState of each slot.
+    IntVectorType           m_states;
+
+    // Functions whose result depends only on their arguments.
+    IntVectorType           m_pureFunctionIDs;
+
+    // Functions which use the context node when they have no arguments.
+    IntVectorType           m_contextFunctionIDs;
+};
+
+
+
+}
+
+
+
+#endif  // XALAN_VARIABLERESOLVER_HEADER_GUARD
@@ -121,7 +121,7 @@ XalanDOMString::XalanDOMString(
 {
     if (theCount != 0)
     {
-        XalanDOMCharVectorType(theCount + 1, theChar, theManager).swap(m_data);
+        m_data.resize(theCount + 1, theChar);
 
         // Null-terminate it...
         m_data.back() = 0;
@@ -307,7 +307,7 @@ XalanDOMString::append(
         {
             m_data.insert(getBackInsertIterator(), theString, theString + theLength);
 
-            m_size += theCount;
+            m_size += theLength;
         }
     }
 
@@ -366,21 +366,14 @@ XalanDOMString::append(
 
     if (theLength != 0)
     {
-        if (empty() == true)
-        {
-            doTranscode(theString, theLength, theCount == size_type(npos), m_data, true);
-        }
-        else
-        {
-            XalanDOMCharVectorType  theTempVector(getMemoryManager());
+        XalanDOMCharVectorType  theTempVector(getMemoryManager());
 
-            doTranscode(theString, theLength, theCount == size_type(npos), theTempVector, false);
+        doTranscode(theString, theLength, theCount == size_type(npos), theTempVector, false);
 
+        if (theTempVector.empty() == false)
+        {
             append(&*theTempVector.begin(), size_type(theTempVector.size()));
         }
-
-        m_size = size_type(m_data.size()) - 1;
-        assert(m_data.size() - 1 == m_size);
     }
 
     invariants();
@@ -29,9 +29,7 @@ namespace XALAN_CPP_NAMESPACE {
 
 XalanSourceTreeAttrNS::XalanSourceTreeAttrNS(
             const XalanDOMString&       theName,
-            const XalanDOMString&       theLocalName,
-            const XalanDOMString&       theNamespaceURI,
-            const XalanDOMString&       thePrefix,
+            const XalanSourceTreeQName& theQName,
             const XalanDOMString&       theValue,
             XalanSourceTreeElement*     theOwnerElement,
             IndexType                   theIndex) :
@@ -40,9 +38,7 @@ XalanSourceTreeAttrNS::XalanSourceTreeAttrNS(
         theValue,
         theOwnerElement,
         theIndex),
-    m_localName(theLocalName),
-    m_prefix(thePrefix),
-    m_namespaceURI(theNamespaceURI)
+    m_qName(theQName)
 {
 }
 
@@ -56,7 +52,7 @@ XalanSourceTreeAttrNS::~XalanSourceTreeAttrNS()
 const XalanDOMString&
 XalanSourceTreeAttrNS::getNamespaceURI() const
 {
-    return m_namespaceURI;
+    return m_qName.getNamespaceURI();
 }
 
 
@@ -64,7 +60,7 @@ XalanSourceTreeAttrNS::getNamespaceURI() const
 const XalanDOMString&
 XalanSourceTreeAttrNS::getPrefix() const
 {
-    return m_prefix;
+    return m_qName.getPrefix();
 }
 
 
@@ -72,7 +68,7 @@ XalanSourceTreeAttrNS::getPrefix() const
 const XalanDOMString&
 XalanSourceTreeAttrNS::getLocalName() const
 {
-    return m_localName;
+    return m_qName.getLocalName();
 }
 
 
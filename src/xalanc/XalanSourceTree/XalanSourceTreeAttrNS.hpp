@@ -25,6 +25,7 @@
 
 
 #include <xalanc/XalanSourceTree/XalanSourceTreeAttr.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeQName.hpp>
 
 
 
@@ -48,18 +49,14 @@ public:
      * Constructor.
      *
      * @param theName The name of the attribute
-     * @param theLocalName The local name of the attribute
-     * @param theNamespaceURI The namespace URI of the attribute
-     * @param thePrefix The namespace prefix of the attribute
+     * @param theQName The local name, namespace URI and prefix of the attribute
      * @param theValue The value of the attribute
      * @param theOwnerElement The element that owns the instance
      * @param theIndex The document-order index of the node.
      */
     XalanSourceTreeAttrNS(
             const XalanDOMString&       theName,
-            const XalanDOMString&       theLocalName,
-            const XalanDOMString&       theNamespaceURI,
-            const XalanDOMString&       thePrefix,
+            const XalanSourceTreeQName& theQName,
             const XalanDOMString&       theValue,
             XalanSourceTreeElement*     theOwnerElement = 0,
             IndexType                   theIndex = 0);
@@ -89,11 +86,7 @@ private:
     operator==(const XalanSourceTreeAttrNS&     theRHS) const;
 
     // Data members...
-    const XalanDOMString&   m_localName;
-
-    const XalanDOMString&   m_prefix;
-
-    const XalanDOMString&   m_namespaceURI;
+    const XalanSourceTreeQName&     m_qName;
 };
 
 
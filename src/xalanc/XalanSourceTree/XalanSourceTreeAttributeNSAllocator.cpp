@@ -41,9 +41,7 @@ XalanSourceTreeAttributeNSAllocator::~XalanSourceTreeAttributeNSAllocator()
 XalanSourceTreeAttributeNSAllocator::ObjectType*
 XalanSourceTreeAttributeNSAllocator::create(
             const XalanDOMString&       theName,
-            const XalanDOMString&       theLocalName,
-            const XalanDOMString&       theNamespaceURI,
-            const XalanDOMString&       thePrefix,
+            const XalanSourceTreeQName& theQName,
             const XalanDOMString&       theValue,
             XalanSourceTreeElement*     theOwnerElement,
             IndexType                   theIndex)
@@ -53,9 +51,7 @@ XalanSourceTreeAttributeNSAllocator::create(
 
     new(theBlock) ObjectType(
                         theName,
-                        theLocalName,
-                        theNamespaceURI,
-                        thePrefix,
+                        theQName,
                         theValue,
                         theOwnerElement,
                         theIndex);
@@ -69,9 +69,7 @@ public:
      * Create an instance.
      * 
      * @param theName The name of the attribute
-     * @param theLocalName The local name of the attribute
-     * @param theNamespaceURI The namespace URI of the attribute
-     * @param thePrefix The namespace prefix of the attribute
+     * @param theQName The local name, namespace URI and prefix of the attribute
      * @param theValue The value of the attribute
      * @param theOwnerElement The element that owns the instance
      * @param theIndex The document-order index of the node.
@@ -81,9 +79,7 @@ public:
     ObjectType*
     create(
             const XalanDOMString&       theName,
-            const XalanDOMString&       theLocalName,
-            const XalanDOMString&       theNamespaceURI,
-            const XalanDOMString&       thePrefix,
+            const XalanSourceTreeQName& theQName,
             const XalanDOMString&       theValue,
             XalanSourceTreeElement*     theOwnerElement = 0,
             IndexType                   theIndex = 0);
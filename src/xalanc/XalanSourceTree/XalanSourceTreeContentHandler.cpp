@@ -31,6 +31,7 @@
 #include "XalanSourceTreeDocument.hpp"
 #include "XalanSourceTreeElement.hpp"
 #include "XalanSourceTreeHelper.hpp"
+#include "XalanSourceTreeProjection.hpp"
 
 
 
@@ -52,7 +53,12 @@ XalanSourceTreeContentHandler::XalanSourceTreeContentHandler(
     m_lastChildStack(theManager),
     m_accumulateText(fAccumulateText),
     m_textBuffer(theManager),
-    m_inDTD(false)
+    m_inDTD(false),
+    m_projection(0),
+    m_pruning(false),
+    m_keptDepth(0),
+    m_pendingElements(theManager),
+    m_pendingCount(0)
 {
 }
 
@@ -60,6 +66,14 @@ XalanSourceTreeContentHandler::XalanSourceTreeContentHandler(
 
 XalanSourceTreeContentHandler::~XalanSourceTreeContentHandler()
 {
+    MemoryManager&  theManager = m_pendingElements.getMemoryManager();
+
+    const PendingElementVectorType::iterator    theEnd = m_pendingElements.end();
+
+    for (PendingElementVectorType::iterator i = m_pendingElements.begin(); i != theEnd; ++i)
+    {
+        XalanDestroy(theManager, *i);
+    }
 }
 
 
@@ -78,6 +92,10 @@ XalanSourceTreeContentHandler::characters(
             throw XalanDOMException(XalanDOMException::HIERARCHY_REQUEST_ERR);
         }
     }
+    else if (isPruning() == true)
+    {
+        // Text is only built inside of elements in the projection.
+    }
     else if (m_accumulateText == true)
     {
         m_textBuffer.append(chars, length);
@@ -117,6 +135,25 @@ XalanSourceTreeContentHandler::endElement(
 {
     assert(m_inDTD == false);
 
+    if (m_pruning == true)
+    {
+        if (m_keptDepth == 0)
+        {
+            if (m_pendingCount != 0)
+            {
+                // The element was never built, since nothing in it
+                // is in the projection.
+                --m_pendingCount;
+
+                return;
+            }
+        }
+        else
+        {
+            --m_keptDepth;
+        }
+    }
+
     // Process any text that we may have accumulated...
     processAccumulatedText();
 
@@ -201,7 +238,7 @@ XalanSourceTreeContentHandler::ignorableWhitespace(
     assert(m_inDTD == false);
 
     // Ignore any whitespace reported before the document element has been parsed.
-    if (m_elementStack.empty() == false)
+    if (m_elementStack.empty() == false && isPruning() == false)
     {
         assert(m_currentElement != 0);
 
@@ -223,6 +260,11 @@ XalanSourceTreeContentHandler::processingInstruction(
 {
     assert(m_inDTD == false);
 
+    if (isPruning() == true)
+    {
+        return;
+    }
+
     processAccumulatedText();
 
     XalanSourceTreeProcessingInstruction* const     theNewPI =
@@ -261,6 +303,12 @@ XalanSourceTreeContentHandler::startDocument()
 
     m_lastChildStack.reserve(eDefaultStackSize);
 
+    m_pruning = m_projection != 0;
+
+    m_keptDepth = 0;
+
+    m_pendingCount = 0;
+
     if (m_accumulateText == true)
     {
         m_textBuffer.clear();
@@ -291,6 +339,63 @@ XalanSourceTreeContentHandler::startElement(
     }
 #endif
 
+    if (m_pruning == true)
+    {
+        const XMLCh* const  theLocalName =
+            localname == 0 || *localname == 0 ? qname : localname;
+
+        if (m_currentElement == 0)
+        {
+            // The document element is always built, but the projection
+            // is only used if the stylesheet allows for its name.
+            assert(m_projection != 0);
+
+            if (m_projection->isAllowedDocumentElement(uri, theLocalName) == false)
+            {
+                m_pruning = false;
+            }
+            else if (m_projection->getElementType(uri, theLocalName) == XalanSourceTreeProjection::eBuildSubtree)
+            {
+                m_keptDepth = 1;
+            }
+        }
+        else if (m_keptDepth != 0)
+        {
+            ++m_keptDepth;
+        }
+        else
+        {
+            switch(m_projection->getElementType(uri, theLocalName))
+            {
+            case XalanSourceTreeProjection::eSkipElement:
+                pushPendingElement(uri, localname, qname, attrs);
+                return;
+
+            case XalanSourceTreeProjection::eBuildSubtree:
+                m_keptDepth = 1;
+
+                // Fall through...
+
+            case XalanSourceTreeProjection::eBuildElement:
+            default:
+                appendPendingElements();
+                break;
+            }
+        }
+    }
+
+    appendElement(uri, localname, qname, attrs);
+}
+
+
+
+void
+XalanSourceTreeContentHandler::appendElement(
+            const XMLCh* const      uri,
+            const XMLCh* const      localname,
+            const XMLCh* const      qname,
+            const AttributesType&   attrs)
+{
     processAccumulatedText();
 
     XalanSourceTreeElement* const   theNewElement =
@@ -313,6 +418,75 @@ XalanSourceTreeContentHandler::startElement(
 
 
 
+void
+XalanSourceTreeContentHandler::pushPendingElement(
+            const XMLCh* const      uri,
+            const XMLCh* const      localname,
+            const XMLCh* const      qname,
+            const AttributesType&   attrs)
+{
+    if (m_pendingCount == m_pendingElements.size())
+    {
+        MemoryManager&  theManager = m_pendingElements.getMemoryManager();
+
+        m_pendingElements.reserve(m_pendingCount + 1);
+
+        PendingElement*     theNewElement = 0;
+
+        m_pendingElements.push_back(
+            XalanConstruct(
+                theManager,
+                theNewElement,
+                theManager));
+    }
+
+    PendingElement&     theElement = *m_pendingElements[m_pendingCount];
+
+    if (uri == 0)
+    {
+        theElement.m_uri.clear();
+    }
+    else
+    {
+        theElement.m_uri = uri;
+    }
+
+    if (localname == 0)
+    {
+        theElement.m_localName.clear();
+    }
+    else
+    {
+        theElement.m_localName = localname;
+    }
+
+    theElement.m_qname = qname;
+    theElement.m_attributes = attrs;
+
+    ++m_pendingCount;
+}
+
+
+
+void
+XalanSourceTreeContentHandler::appendPendingElements()
+{
+    for (PendingElementVectorType::size_type i = 0; i < m_pendingCount; ++i)
+    {
+        const PendingElement&   theElement = *m_pendingElements[i];
+
+        appendElement(
+            theElement.m_uri.c_str(),
+            theElement.m_localName.c_str(),
+            theElement.m_qname.c_str(),
+            theElement.m_attributes);
+    }
+
+    m_pendingCount = 0;
+}
+
+
+
 void
 XalanSourceTreeContentHandler::startPrefixMapping(
         const XMLCh* const  /* prefix */,
@@ -376,7 +550,7 @@ XalanSourceTreeContentHandler::comment(
 {
     assert(m_document != 0);
 
-    if (m_inDTD == false)
+    if (m_inDTD == false && isPruning() == false)
     {
         processAccumulatedText();
 
@@ -40,6 +40,10 @@
 
 
 
+#include <xalanc/PlatformSupport/AttributesImpl.hpp>
+
+
+
 namespace XERCES_CPP_NAMESPACE
 {
     class Attributes;
@@ -72,6 +76,7 @@ typedef xercesc::Locator          LocatorType;
 class XalanNode;
 class XalanSourceTreeDocument;
 class XalanSourceTreeElement;
+class XalanSourceTreeProjection;
 
 
 
@@ -210,8 +215,51 @@ public:
     void
     setDocument(XalanSourceTreeDocument*    theDocument);
 
+    const XalanSourceTreeProjection*
+    getProjection() const
+    {
+        return m_projection;
+    }
+
+    /**
+     * Set the projection to use for the next document.  Elements which
+     * are not in the projection, and are not ancestors of elements in
+     * the projection, are not built, and neither is the text of
+     * elements whose subtree is not needed.
+     *
+     * @param theProjection The projection, or 0 to build every node
+     */
+    void
+    setProjection(const XalanSourceTreeProjection*  theProjection)
+    {
+        m_projection = theProjection;
+    }
+
 private:
 
+    // An element whose start tag has been seen, but which is not
+    // built unless an element in the projection is found inside it.
+    struct PendingElement
+    {
+        PendingElement(MemoryManager&   theManager) :
+            m_uri(theManager),
+            m_localName(theManager),
+            m_qname(theManager),
+            m_attributes(theManager)
+        {
+        }
+
+        XalanDOMString  m_uri;
+
+        XalanDOMString  m_localName;
+
+        XalanDOMString  m_qname;
+
+        AttributesImpl  m_attributes;
+    };
+
+    typedef XalanVector<PendingElement*>    PendingElementVectorType;
+
     // Not implemented...
     XalanSourceTreeContentHandler(const XalanSourceTreeContentHandler&);
 
@@ -230,6 +278,29 @@ private:
             const AttributesType&       attrs,
             XalanSourceTreeElement*     theOwnerElement);
 
+    void
+    appendElement(
+            const XMLCh* const          uri,
+            const XMLCh* const          localname,
+            const XMLCh* const          qname,
+            const AttributesType&       attrs);
+
+    void
+    pushPendingElement(
+            const XMLCh* const          uri,
+            const XMLCh* const          localname,
+            const XMLCh* const          qname,
+            const AttributesType&       attrs);
+
+    void
+    appendPendingElements();
+
+    bool
+    isPruning() const
+    {
+        return m_pruning == true && m_keptDepth == 0 && m_currentElement != 0;
+    }
+
     void
     processAccumulatedText();
 
@@ -269,6 +340,22 @@ private:
 
     // A flag to determine if the DTD is being processed.
     bool                        m_inDTD;
+
+    const XalanSourceTreeProjection*    m_projection;
+
+    // true if the projection is used for the current document.
+    bool                        m_pruning;
+
+    // The depth of the current element inside of the outermost
+    // element whose subtree is built, or 0 outside of such elements.
+    size_type                   m_keptDepth;
+
+    // The elements which are not built yet.  The entries are reused
+    // from one element to the next, so m_pendingCount is the number
+    // in use.
+    PendingElementVectorType    m_pendingElements;
+
+    PendingElementVectorType::size_type     m_pendingCount;
 };
 
 
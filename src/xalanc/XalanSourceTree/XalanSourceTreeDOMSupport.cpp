@@ -110,4 +110,30 @@ XalanSourceTreeDOMSupport::isNodeAfter(
 
 
 
+bool
+XalanSourceTreeDOMSupport::getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const
+{
+    if (m_parserLiaison != 0 &&
+        m_parserLiaison->getCacheNodeNumbers() == true)
+    {
+        // Only documents built by the parser liaison are mapped, so
+        // result tree fragments, whose nodes are recycled, are excluded.
+        // A mapped document without a cache, such as one built before
+        // the flag was set, returns false.
+        const XalanSourceTreeDocument* const    theXSTDocument =
+            m_parserLiaison->mapDocument(theNode.getOwnerDocument());
+
+        if (theXSTDocument != 0)
+        {
+            return theXSTDocument->getNodeNumber(theNode, theNumber);
+        }
+    }
+
+    return false;
+}
+
+
+
 }
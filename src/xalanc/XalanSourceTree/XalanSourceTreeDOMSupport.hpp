@@ -63,6 +63,11 @@ public:
             const XalanNode&    node1,
             const XalanNode&    node2) const;
 
+    virtual bool
+    getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const;
+
     const XalanSourceTreeParserLiaison*
     getParserLiaison() const
     {
@@ -19,15 +19,22 @@
 
 
 
+#include <cstring>
+
+
+
 #include <xercesc/sax/AttributeList.hpp>
 #include <xercesc/sax2/Attributes.hpp>
 
 
 
+#include <xalanc/XalanDOM/XalanAttr.hpp>
 #include <xalanc/XalanDOM/XalanDOMException.hpp>
+#include <xalanc/XalanDOM/XalanText.hpp>
 
 
 
+#include <xalanc/PlatformSupport/DoubleSupport.hpp>
 #include <xalanc/PlatformSupport/PrefixResolver.hpp>
 #include <xalanc/PlatformSupport/XalanUnicode.hpp>
 
@@ -77,13 +84,17 @@ XalanSourceTreeDocument::XalanSourceTreeDocument(
     m_textIWSAllocator(theManager, eDefaultTextIWSAllocatorBlockSize),
     m_namesStringPool(theManager, theNamesStringPoolBlockSize, theNamesStringPoolBucketCount, theNamesStringPoolBucketSize),
     m_valuesStringPool(theManager, theValuesStringPoolBlockSize, theValuesStringPoolBucketCount, theValuesStringPoolBucketSize),
+    m_qNames(theManager),
+    m_qNamesByLocalName(theManager),
     m_attributesVector(theManager),
     m_nextIndexValue(2),
     m_poolAllText(fPoolAllText),
     m_elementsByID(theManager),
     m_unparsedEntityURIs(theManager),
     m_nonPooledStrings(theManager, theValuesStringPoolBlockSize),
-    m_stringBuffer(theManager)
+    m_stringBuffer(theManager),
+    m_nodeNumbers(0),
+    m_nodeNumberCount(0)
 {
 }
 
@@ -148,13 +159,17 @@ XalanSourceTreeDocument::XalanSourceTreeDocument(
     m_textIWSAllocator(theManager, theTextIWSBlockSize),
     m_namesStringPool(theManager, eDefaultNamesStringPoolBlockSize, eDefaultNamesStringPoolBucketCount, eDefaultNamesStringPoolBucketSize),
     m_valuesStringPool(theManager, eDefaultValuesStringPoolBlockSize, eDefaultValuesStringPoolBucketCount, eDefaultValuesStringPoolBucketSize),
+    m_qNames(theManager),
+    m_qNamesByLocalName(theManager),
     m_attributesVector(theManager),
     m_nextIndexValue(2),
     m_poolAllText(fPoolAllText),
     m_elementsByID(theManager),
     m_unparsedEntityURIs(theManager),
     m_nonPooledStrings(theManager, eDefaultValuesStringPoolBlockSize),
-    m_stringBuffer(theManager)
+    m_stringBuffer(theManager),
+    m_nodeNumbers(0),
+    m_nodeNumberCount(0)
 {
 }
 
@@ -162,6 +177,11 @@ XalanSourceTreeDocument::XalanSourceTreeDocument(
 
 XalanSourceTreeDocument::~XalanSourceTreeDocument()
 {
+    if (m_nodeNumbers != 0)
+    {
+        // std::atomic has a trivial destructor.
+        getMemoryManager().deallocate(m_nodeNumbers);
+    }
 }
 
 
@@ -439,10 +459,11 @@ XalanSourceTreeDocument::createAttributes(
                     theAttributeVector[theStartIndex] =
                         m_attributeNSAllocator.create(
                                 m_namesStringPool.get(theName),
-                                m_namesStringPool.get(theLocalName),
-                                m_namesStringPool.get(*theNamespace),
-                                // This is the prefix...
-                                m_namesStringPool.get(m_stringBuffer),
+                                getQName(
+                                    m_namesStringPool.get(theLocalName),
+                                    m_namesStringPool.get(*theNamespace),
+                                    // This is the prefix...
+                                    m_namesStringPool.get(m_stringBuffer)),
                                 m_valuesStringPool.get(theValue),
                                 theOwnerElement,
                                 m_nextIndexValue++);
@@ -517,9 +538,7 @@ XalanSourceTreeDocument::createElementNode(
         // The constructor parameters for AttrNS are:
         //
         // name
-        // local name
-        // namespace URI
-        // prefix
+        // local name, namespace URI and prefix
         // value
         // owner element
         // index
@@ -527,9 +546,10 @@ XalanSourceTreeDocument::createElementNode(
         theAttributeVector[theIndex] =
                 m_attributeNSAllocator.create(
                         m_namesStringPool.get(DOMServices::s_XMLNamespacePrefix),
-                        m_namesStringPool.get(DOMServices::s_XMLString),
-                        m_namesStringPool.get(DOMServices::s_XMLNamespacePrefixURI),
-                        m_namesStringPool.get(DOMServices::s_XMLNamespace),
+                        getQName(
+                            m_namesStringPool.get(DOMServices::s_XMLString),
+                            m_namesStringPool.get(DOMServices::s_XMLNamespacePrefixURI),
+                            m_namesStringPool.get(DOMServices::s_XMLNamespace)),
                         m_valuesStringPool.get(DOMServices::s_XMLNamespaceURI),
                         theNewElement,
                         m_nextIndexValue++);
@@ -606,9 +626,7 @@ XalanSourceTreeDocument::createElementNode(
         // The constructor parameters for AttrNS are:
         //
         // name
-        // local name
-        // namespace URI
-        // prefix
+        // local name, namespace URI and prefix
         // value
         // owner element
         // index
@@ -616,9 +634,10 @@ XalanSourceTreeDocument::createElementNode(
         theAttributeVector[theIndex] =
                 m_attributeNSAllocator.create(
                         m_namesStringPool.get(DOMServices::s_XMLNamespacePrefix),
-                        m_namesStringPool.get(DOMServices::s_XMLString),
-                        m_namesStringPool.get(DOMServices::s_XMLNamespacePrefixURI),
-                        m_namesStringPool.get(DOMServices::s_XMLNamespace),
+                        getQName(
+                            m_namesStringPool.get(DOMServices::s_XMLString),
+                            m_namesStringPool.get(DOMServices::s_XMLNamespacePrefixURI),
+                            m_namesStringPool.get(DOMServices::s_XMLNamespace)),
                         m_valuesStringPool.get(DOMServices::s_XMLNamespaceURI),
                         theNewElement,
                         m_nextIndexValue++);
@@ -707,10 +726,11 @@ XalanSourceTreeDocument::createElementNode(
 
         theNewElement = m_elementNANSAllocator.create(
                 m_namesStringPool.get(qname),
-                m_namesStringPool.get(localname),
-                m_namesStringPool.get(uri),
-                // This is the prefix...
-                getElementNodePrefix( getMemoryManager() , qname, &m_namesStringPool, theLength, theColonIndex),
+                getQName(
+                    m_namesStringPool.get(localname),
+                    m_namesStringPool.get(uri),
+                    // This is the prefix...
+                    getElementNodePrefix( getMemoryManager() , qname, &m_namesStringPool, theLength, theColonIndex)),
                 this,
                 theParentNode,
                 thePreviousSibling,
@@ -723,10 +743,11 @@ XalanSourceTreeDocument::createElementNode(
 
         theNewElement = m_elementANSAllocator.create(
                 m_namesStringPool.get(qname),
-                m_namesStringPool.get(localname),
-                m_namesStringPool.get(uri),
-                // This is the prefix...
-                getElementNodePrefix( getMemoryManager() ,qname, &m_namesStringPool, theLength, theColonIndex),
+                getQName(
+                    m_namesStringPool.get(localname),
+                    m_namesStringPool.get(uri),
+                    // This is the prefix...
+                    getElementNodePrefix( getMemoryManager() ,qname, &m_namesStringPool, theLength, theColonIndex)),
                 this,
                 theAttributeVector,
                 theAttributeCount,
@@ -845,7 +866,43 @@ XalanSourceTreeDocument::createProcessingInstructionNode(
 
 
 
-inline const XalanDOMString&
+inline const XalanSourceTreeQName&
+XalanSourceTreeDocument::getQName(
+            const XalanDOMString&   theLocalName,
+            const XalanDOMString&   theNamespaceURI,
+            const XalanDOMString&   thePrefix)
+{
+    // The strings all come from the names pool, so the address of
+    // the local name is enough to find the names that share it...
+    const XalanSourceTreeQName*&    theFirstQName =
+        m_qNamesByLocalName[&theLocalName];
+
+    for (const XalanSourceTreeQName* theQName = theFirstQName;
+            theQName != 0;
+            theQName = theQName->getNext())
+    {
+        if (theQName->getNamespaceURI() == theNamespaceURI &&
+            theQName->getPrefix() == thePrefix)
+        {
+            return *theQName;
+        }
+    }
+
+    m_qNames.push_back(
+        XalanSourceTreeQName(
+            theLocalName,
+            theNamespaceURI,
+            thePrefix,
+            theFirstQName));
+
+    theFirstQName = &m_qNames.back();
+
+    return m_qNames.back();
+}
+
+
+
+const XalanDOMString&
 XalanSourceTreeDocument::getTextNodeString(
             const XalanDOMChar*         chars,
             XalanDOMString::size_type   length)
@@ -996,6 +1053,119 @@ XalanSourceTreeDocument::getUnparsedEntityURI(const XalanDOMString&     theName)
 
 
 
+// Marks an entry in the node number cache that has not been computed.
+// It's a signaling NaN, which DoubleSupport::toDouble() never returns,
+// since every NaN it produces is the quiet NaN.
+static const XMLUInt64  s_uncachedNodeNumber = 0x7FF4000000000001ull;
+
+
+
+void
+XalanSourceTreeDocument::createNodeNumberCache()
+{
+    assert(m_nodeNumbers == 0);
+
+    const IndexType     theCount = m_nextIndexValue;
+
+    XalanAllocationGuard    theGuard(
+                                getMemoryManager(),
+                                getMemoryManager().allocate(sizeof(NodeNumberType) * theCount));
+
+    NodeNumberType* const   theNumbers = static_cast<NodeNumberType*>(theGuard.get());
+
+    for (IndexType i = 0; i < theCount; ++i)
+    {
+        new (&theNumbers[i]) NodeNumberType(s_uncachedNodeNumber);
+    }
+
+    theGuard.release();
+
+    m_nodeNumbers = theNumbers;
+    m_nodeNumberCount = theCount;
+}
+
+
+
+bool
+XalanSourceTreeDocument::getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const
+{
+    assert(theNode.isIndexed() == true);
+
+    const IndexType     theIndex = theNode.getIndex();
+
+    if (theIndex >= m_nodeNumberCount)
+    {
+        return false;
+    }
+
+    NodeNumberType&     theEntry = m_nodeNumbers[theIndex];
+
+    XMLUInt64   theBits = theEntry.load(std::memory_order_relaxed);
+
+    if (theBits != s_uncachedNodeNumber)
+    {
+        std::memcpy(&theNumber, &theBits, sizeof(theNumber));
+
+        return true;
+    }
+
+    const XalanDOMString*   theData = 0;
+
+    switch(theNode.getNodeType())
+    {
+    case XalanNode::ATTRIBUTE_NODE:
+        theData = &static_cast<const XalanAttr&>(theNode).getValue();
+        break;
+
+    case XalanNode::TEXT_NODE:
+    case XalanNode::CDATA_SECTION_NODE:
+        theData = &static_cast<const XalanText&>(theNode).getData();
+        break;
+
+    case XalanNode::ELEMENT_NODE:
+        {
+            // Only elements whose string-value is the data of their single
+            // child are cached.  Whether or not that child is stripped as
+            // whitespace, the number value is NaN, so the cached value does
+            // not depend on the stylesheet.
+            const XalanNode* const  theChild = theNode.getFirstChild();
+
+            if (theChild != 0 &&
+                theChild->getNextSibling() == 0 &&
+                (theChild->getNodeType() == XalanNode::TEXT_NODE ||
+                 theChild->getNodeType() == XalanNode::CDATA_SECTION_NODE))
+            {
+                theData = &static_cast<const XalanText*>(theChild)->getData();
+            }
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    if (theData == 0)
+    {
+        return false;
+    }
+
+    // Threads which convert the same node at once store the same bits,
+    // so a plain store is enough.
+    theNumber = DoubleSupport::toDouble(*theData, getMemoryManager());
+
+    std::memcpy(&theBits, &theNumber, sizeof(theBits));
+
+    assert(theBits != s_uncachedNodeNumber);
+
+    theEntry.store(theBits, std::memory_order_relaxed);
+
+    return true;
+}
+
+
+
 XalanSourceTreeAttr*
 XalanSourceTreeDocument::createAttribute(
             const XalanDOMChar*         theName,
@@ -1031,19 +1201,18 @@ XalanSourceTreeDocument::createAttribute(
         // The constructor parameters for AttrNS are:
         //
         // name
-        // local name
-        // namespace URI
-        // prefix
+        // local name, namespace URI and prefix
         // value
         // owner element
         // index
         //
         return m_attributeNSAllocator.create(
                 m_namesStringPool.get(theName),
-                m_namesStringPool.get(theName + m_stringBuffer.length() + 1),
-                m_namesStringPool.get(*theNamespace),
-                // This is the prefix...
-                m_namesStringPool.get(m_stringBuffer),
+                getQName(
+                    m_namesStringPool.get(theName + m_stringBuffer.length() + 1),
+                    m_namesStringPool.get(*theNamespace),
+                    // This is the prefix...
+                    m_namesStringPool.get(m_stringBuffer)),
                 m_valuesStringPool.get(theValue),
                 theOwnerElement,
                 m_nextIndexValue++);
@@ -1126,9 +1295,10 @@ XalanSourceTreeDocument::createElementNode(
         {
             return m_elementNANSAllocator.create(
                     m_namesStringPool.get(theTagName),
-                    m_namesStringPool.get(theLocalName),
-                    m_namesStringPool.get(*theNamespace),
-                    m_namesStringPool.get(m_stringBuffer),
+                    getQName(
+                        m_namesStringPool.get(theLocalName),
+                        m_namesStringPool.get(*theNamespace),
+                        m_namesStringPool.get(m_stringBuffer)),
                     this,
                     theParentNode,
                     thePreviousSibling,
@@ -1139,9 +1309,10 @@ XalanSourceTreeDocument::createElementNode(
         {
             return m_elementANSAllocator.create(
                     m_namesStringPool.get(theTagName),
-                    m_namesStringPool.get(theLocalName),
-                    m_namesStringPool.get(*theNamespace),
-                    m_namesStringPool.get(m_stringBuffer),
+                    getQName(
+                        m_namesStringPool.get(theLocalName),
+                        m_namesStringPool.get(*theNamespace),
+                        m_namesStringPool.get(m_stringBuffer)),
                     this,
                     theAttributeVector,
                     theAttributeCount,
@@ -1208,9 +1379,7 @@ XalanSourceTreeDocument::createAttributes(
                 // The constructor parameters for AttrNS are:
                 //
                 // name
-                // local name
-                // namespace URI
-                // prefix
+                // local name, namespace URI and prefix
                 // value
                 // owner element
                 // index
@@ -1218,10 +1387,11 @@ XalanSourceTreeDocument::createAttributes(
                 theAttributeVector[theStartIndex] =
                     m_attributeNSAllocator.create(
                             m_namesStringPool.get(theQName),
-                            m_namesStringPool.get(theLocalName),
-                            m_namesStringPool.get(theURI),
-                            // This is the prefix...
-                            m_namesStringPool.get(theQName, theColonIndex),
+                            getQName(
+                                m_namesStringPool.get(theLocalName),
+                                m_namesStringPool.get(theURI),
+                                // This is the prefix...
+                                m_namesStringPool.get(theQName, theColonIndex)),
                             m_valuesStringPool.get(theValue),
                             theOwnerElement,
                             m_nextIndexValue++);
@@ -1270,9 +1440,7 @@ XalanSourceTreeDocument::createAttributes(
         // The constructor parameters for AttrNS are:
         //
         // name
-        // local name
-        // namespace URI
-        // prefix
+        // local name, namespace URI and prefix
         // value
         // owner element
         // index
@@ -1280,9 +1448,10 @@ XalanSourceTreeDocument::createAttributes(
         theAttributeVector[theIndex] =
                 m_attributeNSAllocator.create(
                         m_namesStringPool.get(DOMServices::s_XMLNamespacePrefix),
-                        m_namesStringPool.get(DOMServices::s_XMLString),
-                        m_namesStringPool.get(DOMServices::s_XMLNamespacePrefixURI),
-                        m_namesStringPool.get(DOMServices::s_XMLNamespace),
+                        getQName(
+                            m_namesStringPool.get(DOMServices::s_XMLString),
+                            m_namesStringPool.get(DOMServices::s_XMLNamespacePrefixURI),
+                            m_namesStringPool.get(DOMServices::s_XMLNamespace)),
                         m_valuesStringPool.get(DOMServices::s_XMLNamespaceURI),
                         theOwnerElement,
                         m_nextIndexValue++);
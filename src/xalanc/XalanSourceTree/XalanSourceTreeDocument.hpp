@@ -24,13 +24,19 @@
 
 
 
+#include <atomic>
+
+
+
 #include <xalanc/XalanDOM/XalanDocument.hpp>
 #include <xalanc/XalanDOM/XalanDOMString.hpp> 
 
 
 
 #include <xalanc/Include/STLHelper.hpp>
+#include <xalanc/Include/XalanDeque.hpp>
 #include <xalanc/Include/XalanMap.hpp>
+#include <xalanc/Include/XalanVector.hpp>
 
 
 
@@ -48,6 +54,7 @@
 #include <xalanc/XalanSourceTree/XalanSourceTreeElementNAAllocator.hpp>
 #include <xalanc/XalanSourceTree/XalanSourceTreeElementNANSAllocator.hpp>
 #include <xalanc/XalanSourceTree/XalanSourceTreeProcessingInstructionAllocator.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeQName.hpp>
 #include <xalanc/XalanSourceTree/XalanSourceTreeTextAllocator.hpp>
 #include <xalanc/XalanSourceTree/XalanSourceTreeTextIWSAllocator.hpp>
 
@@ -89,6 +96,14 @@ public:
                 XalanDOMString,
                 XalanDOMString>                             UnparsedEntityURIMapType;
 
+    typedef XalanDeque<XalanSourceTreeQName>                QNameDequeType;
+
+    typedef std::atomic<XMLUInt64>                          NodeNumberType;
+
+    typedef XalanMap<
+                const XalanDOMString*,
+                const XalanSourceTreeQName*>                QNameMapType;
+
 
     /**
      * Perform static initialization.  See class XalanSourceTreeInit.
@@ -258,6 +273,32 @@ public:
         s_poolAllTextNodes = fPool;
     }
 
+    /**
+     * Create the table which caches the number values of the nodes
+     * created so far.  Each value is converted on first use.  Entries
+     * are read and written atomically, so the document may be shared
+     * between threads, but the table must be created once the document
+     * is complete, and before it is shared.  Nodes created afterwards
+     * are never cached.
+     */
+    void
+    createNodeNumberCache();
+
+    /**
+     * Get the number value of an attribute, a text node, or an
+     * element whose only child is a text node, from the table made
+     * by createNodeNumberCache().
+     *
+     * @param theNode The node, which must belong to this document
+     * @param theNumber The number value of the node, if available
+     * @return true if theNumber was set, or false if there is no table,
+     * or if the node isn't cached.
+     */
+    bool
+    getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const;
+
 
     XalanSourceTreeElement*
     createElementNode(
@@ -340,6 +381,12 @@ public:
     const XalanDOMString&
     getUnparsedEntityURI(const XalanDOMString&  theName) const;
 
+    const UnparsedEntityURIMapType&
+    getUnparsedEntityURIs() const
+    {
+        return m_unparsedEntityURIs;
+    }
+
     // Child node setters...
     void
     appendChildNode(XalanSourceTreeComment*     theChild);
@@ -350,14 +397,14 @@ public:
     void
     appendChildNode(XalanSourceTreeProcessingInstruction*   theChild);
 
-private:
-
     MemoryManager&
     getMemoryManager()
     {
         return m_stringBuffer.getMemoryManager();
     }
 
+private:
+
     // Helper functions...
     XalanSourceTreeAttr*
     createAttribute(
@@ -406,6 +453,12 @@ private:
             XalanSourceTreeElement*     theOwnerElement,
             bool                        fAddXMLNamespaceAttribute);
 
+    const XalanSourceTreeQName&
+    getQName(
+            const XalanDOMString&   theLocalName,
+            const XalanDOMString&   theNamespaceURI,
+            const XalanDOMString&   thePrefix);
+
     const XalanDOMString&
     getTextNodeString(
             const XalanDOMChar*         chars,
@@ -458,6 +511,10 @@ private:
 
     XalanDOMStringPool                              m_valuesStringPool;
 
+    QNameDequeType                                  m_qNames;
+
+    QNameMapType                                    m_qNamesByLocalName;
+
     AttributesArrayAllocatorType                    m_attributesVector;
 
     IndexType                                       m_nextIndexValue;
@@ -472,6 +529,10 @@ private:
 
     XalanDOMString                                  m_stringBuffer;
 
+    NodeNumberType*                                 m_nodeNumbers;
+
+    IndexType                                       m_nodeNumberCount;
+
     static const XalanDOMString&                    s_nameString;
 
     static bool                                     s_poolAllTextNodes;
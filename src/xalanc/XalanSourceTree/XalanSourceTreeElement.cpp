@@ -46,7 +46,6 @@ const XalanDOMString        XalanSourceTreeElement::s_emptyString(XalanMemMgrs::
 
 
 XalanSourceTreeElement::XalanSourceTreeElement(
-            MemoryManager&              theManager,
             const XalanDOMString&       theTagName,
             XalanSourceTreeDocument*    theOwnerDocument,
             XalanNode*                  theParentNode,
@@ -55,7 +54,27 @@ XalanSourceTreeElement::XalanSourceTreeElement(
             IndexType                   theIndex) :
     XalanElement(),
     m_tagName(theTagName),
-    m_memoryManager(theManager),
+    m_ownerDocument(theOwnerDocument),
+    m_parentNode(theParentNode),
+    m_previousSibling(thePreviousSibling),
+    m_nextSibling(theNextSibling),
+    m_firstChild(0),
+    m_index(theIndex)
+{
+}
+
+
+
+XalanSourceTreeElement::XalanSourceTreeElement(
+            MemoryManager&              /* theManager */,
+            const XalanDOMString&       theTagName,
+            XalanSourceTreeDocument*    theOwnerDocument,
+            XalanNode*                  theParentNode,
+            XalanNode*                  thePreviousSibling,
+            XalanNode*                  theNextSibling,
+            IndexType                   theIndex) :
+    XalanElement(),
+    m_tagName(theTagName),
     m_ownerDocument(theOwnerDocument),
     m_parentNode(theParentNode),
     m_previousSibling(thePreviousSibling),
@@ -72,6 +91,16 @@ XalanSourceTreeElement::~XalanSourceTreeElement()
 }
 
 
+
+MemoryManager&
+XalanSourceTreeElement::getMemoryManager() const
+{
+    assert(m_ownerDocument != 0);
+
+    return m_ownerDocument->getMemoryManager();
+}
+
+
 /*
 XalanSourceTreeElement::XalanSourceTreeElement(
             MemoryManager&              theManager,
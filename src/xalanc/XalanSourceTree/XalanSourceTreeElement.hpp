@@ -59,6 +59,27 @@ public:
      * @param theNextSibling The next sibling, if any.
      * @param theIndex The document-order index of the node.
      */
+    XalanSourceTreeElement(
+            const XalanDOMString&       theTagName,
+            XalanSourceTreeDocument*    theOwnerDocument,
+            XalanNode*                  theParentNode = 0,
+            XalanNode*                  thePreviousSibling = 0,
+            XalanNode*                  theNextSibling = 0,
+            IndexType                   theIndex = 0);
+
+    /**
+     * Constructor.  An element uses the memory manager of its owner
+     * document, so theManager is not used.  This constructor is kept
+     * for source compatibility.
+     *
+     * @param theManager The MemoryManager for the instance
+     * @param theTagName The tag name of the element
+     * @param theOwnerDocument The document that owns the instance
+     * @param theParentNode The parent node, if any.
+     * @param thePreviousSibling The previous sibling, if any.
+     * @param theNextSibling The next sibling, if any.
+     * @param theIndex The document-order index of the node.
+     */
     XalanSourceTreeElement(
             MemoryManager&              theManager,
             const XalanDOMString&       theTagName,
@@ -71,11 +92,8 @@ public:
     virtual
     ~XalanSourceTreeElement();
 
-    MemoryManager& 
-    getMemoryManager()
-    {
-        return m_memoryManager;
-    }
+    MemoryManager&
+    getMemoryManager() const;
 
     // These interfaces are inherited from XalanElement...
 
@@ -226,8 +244,6 @@ private:
 
 
     // Data members...
-    MemoryManager&          m_memoryManager;
-
     XalanSourceTreeDocument*    m_ownerDocument;
 
     XalanNode*                  m_parentNode;
@@ -38,7 +38,6 @@ static const XalanDOMString     s_emptyString(XalanMemMgrs::getDummyMemMgr());
 
 
 XalanSourceTreeElementA::XalanSourceTreeElementA(
-            MemoryManager&          theManager,
             const XalanDOMString&       theTagName,
             XalanSourceTreeDocument*    theOwnerDocument,
             XalanSourceTreeAttr**       theAttributes,
@@ -48,7 +47,30 @@ XalanSourceTreeElementA::XalanSourceTreeElementA(
             XalanNode*                  theNextSibling,
             IndexType                   theIndex) :
     XalanSourceTreeElement(
-        theManager,
+        theTagName,
+        theOwnerDocument,
+        theParentNode,
+        thePreviousSibling,
+        theNextSibling,
+        theIndex),
+    m_attributes(theAttributes),
+    m_attributeCount(theAttributeCount)
+{
+}
+
+
+
+XalanSourceTreeElementA::XalanSourceTreeElementA(
+            MemoryManager&              /* theManager */,
+            const XalanDOMString&       theTagName,
+            XalanSourceTreeDocument*    theOwnerDocument,
+            XalanSourceTreeAttr**       theAttributes,
+            XalanSize_t                 theAttributeCount,
+            XalanNode*                  theParentNode,
+            XalanNode*                  thePreviousSibling,
+            XalanNode*                  theNextSibling,
+            IndexType                   theIndex) :
+    XalanSourceTreeElement(
         theTagName,
         theOwnerDocument,
         theParentNode,
@@ -53,7 +53,32 @@ public:
      * @param theIndex The document-order index of the node.
      */
     XalanSourceTreeElementA(
-            MemoryManager&          theManager,
+            const XalanDOMString&       theTagName,
+            XalanSourceTreeDocument*    theOwnerDocument,
+            XalanSourceTreeAttr**       theAttributes,
+            XalanSize_t                 theAttributeCount,
+            XalanNode*                  theParentNode = 0,
+            XalanNode*                  thePreviousSibling = 0,
+            XalanNode*                  theNextSibling = 0,
+            IndexType                   theIndex = 0);
+
+    /**
+     * Constructor.  An element uses the memory manager of its owner
+     * document, so theManager is not used.  This constructor is kept
+     * for source compatibility.
+     *
+     * @param theManager The MemoryManager for the instance
+     * @param theTagName The tag name of the element
+     * @param theOwnerDocument The document that owns the instance
+     * @param theAttributes An array of pointers to the attribute instances for the element
+     * @param theAttributeCount The number of attributes.
+     * @param theParentNode The parent node, if any.
+     * @param thePreviousSibling The previous sibling, if any.
+     * @param theNextSibling The next sibling, if any.
+     * @param theIndex The document-order index of the node.
+     */
+    XalanSourceTreeElementA(
+            MemoryManager&              theManager,
             const XalanDOMString&       theTagName,
             XalanSourceTreeDocument*    theOwnerDocument,
             XalanSourceTreeAttr**       theAttributes,
@@ -55,7 +55,6 @@ XalanSourceTreeElementAAllocator::create(
     assert(theBlock != 0);
 
     new(theBlock) ObjectType(
-                        m_allocator.getMemoryManager(),
                         theTagName,
                         theOwnerDocument,
                         theAttributes,
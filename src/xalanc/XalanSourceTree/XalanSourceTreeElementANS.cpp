@@ -24,11 +24,8 @@ namespace XALAN_CPP_NAMESPACE {
 
 
 XalanSourceTreeElementANS::XalanSourceTreeElementANS(
-            MemoryManager&              theManager,
             const XalanDOMString&       theTagName,
-            const XalanDOMString&       theLocalName,
-            const XalanDOMString&       theNamespaceURI,
-            const XalanDOMString&       thePrefix,
+            const XalanSourceTreeQName& theQName,
             XalanSourceTreeDocument*    theOwnerDocument,
             XalanSourceTreeAttr**       theAttributes,
             XalanSize_t                 theAttributeCount,
@@ -37,7 +34,6 @@ XalanSourceTreeElementANS::XalanSourceTreeElementANS(
             XalanNode*                  theNextSibling,
             IndexType                   theIndex) :
     XalanSourceTreeElementA(
-        theManager,
         theTagName,
         theOwnerDocument,
         theAttributes,
@@ -46,9 +42,7 @@ XalanSourceTreeElementANS::XalanSourceTreeElementANS(
         thePreviousSibling,
         theNextSibling,
         theIndex),
-    m_localName(theLocalName),
-    m_prefix(thePrefix),
-    m_namespaceURI(theNamespaceURI)
+    m_qName(theQName)
 {
 }
 
@@ -62,7 +56,7 @@ XalanSourceTreeElementANS::~XalanSourceTreeElementANS()
 const XalanDOMString&
 XalanSourceTreeElementANS::getNamespaceURI() const
 {
-    return m_namespaceURI;
+    return m_qName.getNamespaceURI();
 }
 
 
@@ -70,7 +64,7 @@ XalanSourceTreeElementANS::getNamespaceURI() const
 const XalanDOMString&
 XalanSourceTreeElementANS::getPrefix() const
 {
-    return m_prefix;
+    return m_qName.getPrefix();
 }
 
 
@@ -78,7 +72,7 @@ XalanSourceTreeElementANS::getPrefix() const
 const XalanDOMString&
 XalanSourceTreeElementANS::getLocalName() const
 {
-    return m_localName;
+    return m_qName.getLocalName();
 }
 
 
@@ -25,6 +25,7 @@
 
 
 #include <xalanc/XalanSourceTree/XalanSourceTreeElementA.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeQName.hpp>
 
 
 
@@ -40,9 +41,7 @@ public:
      * Constructor.
      *
      * @param theTagName The tag name of the element
-     * @param theLocalName The local name of the attribute
-     * @param theNamespaceURI The namespace URI of the attribute
-     * @param thePrefix The namespace prefix of the attribute
+     * @param theQName The local name, namespace URI and prefix of the element
      * @param theOwnerDocument The document that owns the instance
      * @param theAttributes An array of pointers to the attribute instances for the element
      * @param theAttributeCount The number of attributes.
@@ -52,11 +51,8 @@ public:
      * @param theIndex The document-order index of the node.
      */
     XalanSourceTreeElementANS(
-            MemoryManager&              theManager,
             const XalanDOMString&       theTagName,
-            const XalanDOMString&       theLocalName,
-            const XalanDOMString&       theNamespaceURI,
-            const XalanDOMString&       thePrefix,
+            const XalanSourceTreeQName& theQName,
             XalanSourceTreeDocument*    theOwnerDocument,
             XalanSourceTreeAttr**       theAttributes,
             XalanSize_t                 theAttributeCount,
@@ -91,11 +87,7 @@ private:
 
 
     // Data members...
-    const XalanDOMString&   m_localName;
-
-    const XalanDOMString&   m_prefix;
-
-    const XalanDOMString&   m_namespaceURI;
+    const XalanSourceTreeQName&     m_qName;
 };
 
 
@@ -43,9 +43,7 @@ XalanSourceTreeElementANSAllocator::~XalanSourceTreeElementANSAllocator()
 XalanSourceTreeElementANSAllocator::ObjectType*
 XalanSourceTreeElementANSAllocator::create(
             const XalanDOMString&       theTagName,
-            const XalanDOMString&       theLocalName,
-            const XalanDOMString&       theNamespaceURI,
-            const XalanDOMString&       thePrefix,
+            const XalanSourceTreeQName& theQName,
             XalanSourceTreeDocument*    theOwnerDocument,
             XalanSourceTreeAttr**       theAttributes,
             XalanSize_t                 theAttributeCount,
@@ -58,11 +56,8 @@ XalanSourceTreeElementANSAllocator::create(
     assert(theBlock != 0);
 
     new(theBlock) ObjectType(
-                        m_allocator.getMemoryManager(),
                         theTagName,
-                        theLocalName,
-                        theNamespaceURI,
-                        thePrefix,
+                        theQName,
                         theOwnerDocument,
                         theAttributes,
                         theAttributeCount,
@@ -71,9 +71,7 @@ public:
      * Create an instance.
      * 
      * @param theTagName The tag name of the element
-     * @param theLocalName The local name of the attribute
-     * @param theNamespaceURI The namespace URI of the attribute
-     * @param thePrefix The namespace prefix of the attribute
+     * @param theQName The local name, namespace URI and prefix of the element
      * @param theOwnerDocument The document that owns the instance
      * @param theAttributes An array of pointers to the attribute instances for the element
      * @param theAttributeCount The number of attributes.
@@ -87,9 +85,7 @@ public:
     ObjectType*
     create(
             const XalanDOMString&       theTagName,
-            const XalanDOMString&       theLocalName,
-            const XalanDOMString&       theNamespaceURI,
-            const XalanDOMString&       thePrefix,
+            const XalanSourceTreeQName& theQName,
             XalanSourceTreeDocument*    theOwnerDocument,
             XalanSourceTreeAttr**       theAttributes,
             XalanSize_t                 theAttributeCount,
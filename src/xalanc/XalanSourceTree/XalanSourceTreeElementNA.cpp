@@ -34,7 +34,6 @@ const XalanEmptyNamedNodeMap    XalanSourceTreeElementNA::s_emptyAttributes;
 
 
 XalanSourceTreeElementNA::XalanSourceTreeElementNA(
-            MemoryManager&          theManager,
             const XalanDOMString&       theTagName,
             XalanSourceTreeDocument*    theOwnerDocument,
             XalanNode*                  theParentNode,
@@ -42,7 +41,26 @@ XalanSourceTreeElementNA::XalanSourceTreeElementNA(
             XalanNode*                  theNextSibling,
             IndexType                   theIndex) :
     XalanSourceTreeElement(
-        theManager,
+        theTagName,
+        theOwnerDocument,
+        theParentNode,
+        thePreviousSibling,
+        theNextSibling,
+        theIndex)
+{
+}
+
+
+
+XalanSourceTreeElementNA::XalanSourceTreeElementNA(
+            MemoryManager&              /* theManager */,
+            const XalanDOMString&       theTagName,
+            XalanSourceTreeDocument*    theOwnerDocument,
+            XalanNode*                  theParentNode,
+            XalanNode*                  thePreviousSibling,
+            XalanNode*                  theNextSibling,
+            IndexType                   theIndex) :
+    XalanSourceTreeElement(
         theTagName,
         theOwnerDocument,
         theParentNode,
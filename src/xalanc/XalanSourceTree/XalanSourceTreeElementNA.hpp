@@ -51,7 +51,28 @@ public:
      * @param theIndex The document-order index of the node.
      */
     XalanSourceTreeElementNA(
-            MemoryManager&          theManager,
+            const XalanDOMString&       theTagName,
+            XalanSourceTreeDocument*    theOwnerDocument,
+            XalanNode*                  theParentNode = 0,
+            XalanNode*                  thePreviousSibling = 0,
+            XalanNode*                  theNextSibling = 0,
+            IndexType                   theIndex = 0);
+
+    /**
+     * Constructor.  An element uses the memory manager of its owner
+     * document, so theManager is not used.  This constructor is kept
+     * for source compatibility.
+     *
+     * @param theManager The MemoryManager for the instance
+     * @param theTagName The tag name of the element
+     * @param theOwnerDocument The document that owns the instance
+     * @param theParentNode The parent node, if any.
+     * @param thePreviousSibling The previous sibling, if any.
+     * @param theNextSibling The next sibling, if any.
+     * @param theIndex The document-order index of the node.
+     */
+    XalanSourceTreeElementNA(
+            MemoryManager&              theManager,
             const XalanDOMString&       theTagName,
             XalanSourceTreeDocument*    theOwnerDocument,
             XalanNode*                  theParentNode = 0,
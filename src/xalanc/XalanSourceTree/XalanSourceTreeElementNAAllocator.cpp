@@ -53,7 +53,6 @@ XalanSourceTreeElementNAAllocator::create(
     assert(theBlock != 0);
 
     new(theBlock) ObjectType(
-                        m_allocator.getMemoryManager(),
                         theTagName,
                         theOwnerDocument,
                         theParentNode,
@@ -26,27 +26,21 @@ namespace XALAN_CPP_NAMESPACE {
 
 
 XalanSourceTreeElementNANS::XalanSourceTreeElementNANS(
-            MemoryManager&              theManager,
             const XalanDOMString&       theTagName,
-            const XalanDOMString&       theLocalName,
-            const XalanDOMString&       theNamespaceURI,
-            const XalanDOMString&       thePrefix,
+            const XalanSourceTreeQName& theQName,
             XalanSourceTreeDocument*    theOwnerDocument,
             XalanNode*                  theParentNode,
             XalanNode*                  thePreviousSibling,
             XalanNode*                  theNextSibling,
             IndexType                   theIndex) :
     XalanSourceTreeElementNA(
-        theManager,
         theTagName,
         theOwnerDocument,
         theParentNode,
         thePreviousSibling,
         theNextSibling,
         theIndex),
-    m_localName(theLocalName),
-    m_prefix(thePrefix),
-    m_namespaceURI(theNamespaceURI)
+    m_qName(theQName)
 {
 }
 
@@ -61,7 +55,7 @@ XalanSourceTreeElementNANS::~XalanSourceTreeElementNANS()
 const XalanDOMString&
 XalanSourceTreeElementNANS::getNamespaceURI() const
 {
-    return m_namespaceURI;
+    return m_qName.getNamespaceURI();
 }
 
 
@@ -69,7 +63,7 @@ XalanSourceTreeElementNANS::getNamespaceURI() const
 const XalanDOMString&
 XalanSourceTreeElementNANS::getPrefix() const
 {
-    return m_prefix;
+    return m_qName.getPrefix();
 }
 
 
@@ -77,7 +71,7 @@ XalanSourceTreeElementNANS::getPrefix() const
 const XalanDOMString&
 XalanSourceTreeElementNANS::getLocalName() const
 {
-    return m_localName;
+    return m_qName.getLocalName();
 }
 
 
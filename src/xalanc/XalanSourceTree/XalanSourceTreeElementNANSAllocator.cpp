@@ -43,9 +43,7 @@ XalanSourceTreeElementNANSAllocator::~XalanSourceTreeElementNANSAllocator()
 XalanSourceTreeElementNANSAllocator::ObjectType*
 XalanSourceTreeElementNANSAllocator::create(
             const XalanDOMString&       theTagName,
-            const XalanDOMString&       theLocalName,
-            const XalanDOMString&       theNamespaceURI,
-            const XalanDOMString&       thePrefix,
+            const XalanSourceTreeQName& theQName,
             XalanSourceTreeDocument*    theOwnerDocument,
             XalanNode*                  theParentNode,
             XalanNode*                  thePreviousSibling,
@@ -56,11 +54,8 @@ XalanSourceTreeElementNANSAllocator::create(
     assert(theBlock != 0);
 
     new(theBlock) ObjectType(
-                        m_allocator.getMemoryManager(),
                         theTagName,
-                        theLocalName,
-                        theNamespaceURI,
-                        thePrefix,
+                        theQName,
                         theOwnerDocument,
                         theParentNode,
                         thePreviousSibling,
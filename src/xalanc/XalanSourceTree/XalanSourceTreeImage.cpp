@@ -0,0 +1,750 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "XalanSourceTreeImage.hpp"
+
+
+
+#include <cassert>
+#include <ostream>
+
+
+
+#include <xercesc/sax/DTDHandler.hpp>
+#include <xercesc/sax2/ContentHandler.hpp>
+#include <xercesc/sax2/LexicalHandler.hpp>
+
+
+
+#include <xalanc/Include/XalanMap.hpp>
+#include <xalanc/Include/XalanVector.hpp>
+
+
+
+#include <xalanc/XalanDOM/XalanElement.hpp>
+#include <xalanc/XalanDOM/XalanNamedNodeMap.hpp>
+
+
+
+#include <xalanc/PlatformSupport/AttributesImpl.hpp>
+#include <xalanc/PlatformSupport/DOMStringHelper.hpp>
+#include <xalanc/PlatformSupport/XalanUnicode.hpp>
+
+
+
+#include "XalanSourceTreeDocument.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+// The layout of an image is a header, then the offsets of the strings,
+// then the records, then the characters of the strings.  Each string
+// is null-terminated, so it can be passed directly to a SAX handler, and
+// string 0 is always the empty string.
+enum
+{
+    eMagic = 0x49545358,    // "XSTI" in little-endian order
+    eVersion = 1,
+    eByteOrderMark = 0x01020304
+};
+
+enum
+{
+    eHeaderMagic,
+    eHeaderVersion,
+    eHeaderByteOrder,
+    eHeaderCharSize,
+    eHeaderURI,
+    eHeaderStringCount,
+    eHeaderRecordCount,
+    eHeaderCharCount,
+    eHeaderSize
+};
+
+
+
+static const XalanDOMChar   s_cdataString[] =
+{
+    XalanUnicode::charLetter_C,
+    XalanUnicode::charLetter_D,
+    XalanUnicode::charLetter_A,
+    XalanUnicode::charLetter_T,
+    XalanUnicode::charLetter_A,
+    0
+};
+
+static const XalanDOMChar   s_idString[] =
+{
+    XalanUnicode::charLetter_I,
+    XalanUnicode::charLetter_D,
+    0
+};
+
+
+
+class XalanSourceTreeImageWriter
+{
+public:
+
+    XalanSourceTreeImageWriter(MemoryManager&   theManager) :
+        m_stringIndexes(theManager),
+        m_offsets(theManager),
+        m_chars(theManager),
+        m_records(theManager)
+    {
+        // String 0 is the empty string...
+        m_chars.push_back(0);
+        m_offsets.push_back(0);
+        m_offsets.push_back(1);
+    }
+
+    XMLUInt32
+    appendString(
+            const XalanDOMChar*         theString,
+            XalanDOMString::size_type   theLength)
+    {
+        const XMLUInt32     theIndex = XMLUInt32(m_offsets.size() - 1);
+
+        m_chars.insert(m_chars.end(), theString, theString + theLength);
+        m_chars.push_back(0);
+
+        m_offsets.push_back(XMLUInt32(m_chars.size()));
+
+        return theIndex;
+    }
+
+    // The strings in a source tree document are pooled, so
+    // equal names and values are usually the same instance,
+    // and the address is enough to find most duplicates.
+    XMLUInt32
+    getString(const XalanDOMString&     theString)
+    {
+        if (theString.empty() == true)
+        {
+            return 0;
+        }
+        else
+        {
+            const StringIndexMapType::const_iterator    i =
+                m_stringIndexes.find(&theString);
+
+            if (i != m_stringIndexes.end())
+            {
+                return (*i).second;
+            }
+            else
+            {
+                const XMLUInt32     theIndex =
+                    appendString(theString.c_str(), theString.length());
+
+                m_stringIndexes[&theString] = theIndex;
+
+                return theIndex;
+            }
+        }
+    }
+
+    void
+    appendUnparsedEntities(const XalanSourceTreeDocument&   theDocument)
+    {
+        typedef XalanSourceTreeDocument::UnparsedEntityURIMapType   MapType;
+
+        const MapType&  theEntities = theDocument.getUnparsedEntityURIs();
+
+        for (MapType::const_iterator i = theEntities.begin(); i != theEntities.end(); ++i)
+        {
+            m_records.push_back(XalanSourceTreeImage::eUnparsedEntity);
+            m_records.push_back(getString((*i).first));
+            m_records.push_back(getString((*i).second));
+        }
+    }
+
+    void
+    appendElement(
+            const XalanDocument&    theDocument,
+            const XalanNode&        theElement)
+    {
+        m_records.push_back(XalanSourceTreeImage::eElement);
+        m_records.push_back(getString(theElement.getNodeName()));
+        m_records.push_back(getString(theElement.getNamespaceURI()));
+        m_records.push_back(getString(theElement.getLocalName()));
+
+        const XalanNamedNodeMap* const  theAttributes =
+            theElement.getAttributes();
+        assert(theAttributes != 0);
+
+        const XalanSize_t   theLength = theAttributes->getLength();
+
+        m_records.push_back(theLength);
+
+        for (XalanSize_t i = 0; i < theLength; ++i)
+        {
+            const XalanNode* const  theAttribute = theAttributes->item(i);
+            assert(theAttribute != 0);
+
+            const XalanDOMString&   theValue = theAttribute->getNodeValue();
+
+            // The document only keeps the first element with a given
+            // ID, so that's the only one whose attribute needs to be
+            // an ID when the document is rebuilt.
+            const XalanNode* const  theElementWithID =
+                theDocument.getElementById(theValue);
+
+            m_records.push_back(getString(theAttribute->getNodeName()));
+            m_records.push_back(getString(theAttribute->getNamespaceURI()));
+            m_records.push_back(getString(theAttribute->getLocalName()));
+            m_records.push_back(getString(theValue));
+            m_records.push_back(theElementWithID == &theElement ? XalanSourceTreeImage::eAttributeIsID : 0);
+        }
+    }
+
+    void
+    appendNode(
+            const XalanDocument&    theDocument,
+            const XalanNode&        theNode)
+    {
+        switch(theNode.getNodeType())
+        {
+        case XalanNode::ELEMENT_NODE:
+            appendElement(theDocument, theNode);
+            break;
+
+        case XalanNode::TEXT_NODE:
+        case XalanNode::CDATA_SECTION_NODE:
+            m_records.push_back(XalanSourceTreeImage::eText);
+            m_records.push_back(getString(theNode.getNodeValue()));
+            break;
+
+        case XalanNode::COMMENT_NODE:
+            m_records.push_back(XalanSourceTreeImage::eComment);
+            m_records.push_back(getString(theNode.getNodeValue()));
+            break;
+
+        case XalanNode::PROCESSING_INSTRUCTION_NODE:
+            m_records.push_back(XalanSourceTreeImage::eProcessingInstruction);
+            m_records.push_back(getString(theNode.getNodeName()));
+            m_records.push_back(getString(theNode.getNodeValue()));
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    void
+    appendEndElement()
+    {
+        m_records.push_back(XalanSourceTreeImage::eEndElement);
+    }
+
+    void
+    write(
+            XMLUInt32       theURI,
+            std::ostream&   theStream) const
+    {
+        const XMLUInt32     theHeader[eHeaderSize] =
+        {
+            eMagic,
+            eVersion,
+            eByteOrderMark,
+            XMLUInt32(sizeof(XalanDOMChar)),
+            theURI,
+            XMLUInt32(m_offsets.size() - 1),
+            XMLUInt32(m_records.size()),
+            XMLUInt32(m_chars.size())
+        };
+
+        theStream.write(
+            reinterpret_cast<const char*>(theHeader),
+            sizeof(theHeader));
+
+        theStream.write(
+            reinterpret_cast<const char*>(&m_offsets[0]),
+            m_offsets.size() * sizeof(XMLUInt32));
+
+        theStream.write(
+            reinterpret_cast<const char*>(&m_records[0]),
+            m_records.size() * sizeof(XMLUInt32));
+
+        theStream.write(
+            reinterpret_cast<const char*>(&m_chars[0]),
+            m_chars.size() * sizeof(XalanDOMChar));
+    }
+
+private:
+
+    typedef XalanMap<const XalanDOMString*, XMLUInt32>  StringIndexMapType;
+
+    StringIndexMapType          m_stringIndexes;
+
+    XalanVector<XMLUInt32>      m_offsets;
+
+    XalanVector<XalanDOMChar>   m_chars;
+
+    XalanVector<XMLUInt32>      m_records;
+};
+
+
+
+void
+XalanSourceTreeImage::write(
+            const XalanSourceTreeDocument&  theDocument,
+            const XalanDOMString&           theURI,
+            std::ostream&                   theStream,
+            MemoryManager&                  theManager)
+{
+    XalanSourceTreeImageWriter  theWriter(theManager);
+
+    const XMLUInt32     theURIIndex =
+        theURI.empty() == true ? 0 : theWriter.appendString(theURI.c_str(), theURI.length());
+
+    theWriter.appendUnparsedEntities(theDocument);
+
+    // Walk the tree in document order, without recursing...
+    const XalanNode*    theNode = theDocument.getFirstChild();
+
+    while (theNode != 0)
+    {
+        theWriter.appendNode(theDocument, *theNode);
+
+        const XalanNode*    theNextNode = theNode->getFirstChild();
+
+        if (theNextNode == 0 &&
+            theNode->getNodeType() == XalanNode::ELEMENT_NODE)
+        {
+            theWriter.appendEndElement();
+        }
+
+        while (theNextNode == 0 && theNode != 0)
+        {
+            theNextNode = theNode->getNextSibling();
+
+            if (theNextNode == 0)
+            {
+                theNode = theNode->getParentNode();
+
+                if (theNode == &theDocument)
+                {
+                    theNode = 0;
+                }
+                else if (theNode != 0)
+                {
+                    theWriter.appendEndElement();
+                }
+            }
+        }
+
+        theNode = theNextNode;
+    }
+
+    theWriter.write(theURIIndex, theStream);
+}
+
+
+
+static bool
+isValidString(
+            XMLUInt32   theIndex,
+            XMLUInt32   theStringCount)
+{
+    return theIndex < theStringCount;
+}
+
+
+
+/**
+ * Check the counts in an image's header against the size of the image,
+ * before they're used to find its sections.  Each count is checked on
+ * its own first, so a damaged header can't make the sum wrap around.
+ */
+static bool
+hasValidCounts(
+            const XMLUInt32*                    theHeader,
+            XalanSourceTreeImage::size_type     theSize)
+{
+    const XMLUInt64     theWordCount = theSize / sizeof(XMLUInt32);
+
+    const XMLUInt32     theStringCount = theHeader[eHeaderStringCount];
+    const XMLUInt32     theRecordCount = theHeader[eHeaderRecordCount];
+    const XMLUInt32     theCharCount = theHeader[eHeaderCharCount];
+
+    if (theStringCount == 0 ||
+        theStringCount >= theWordCount ||
+        theRecordCount >= theWordCount ||
+        theCharCount > theSize / sizeof(XalanDOMChar))
+    {
+        return false;
+    }
+
+    const XMLUInt64     theExpectedSize =
+        (XMLUInt64(eHeaderSize) + theStringCount + 1 + theRecordCount) * sizeof(XMLUInt32) +
+        XMLUInt64(theCharCount) * sizeof(XalanDOMChar);
+
+    return theExpectedSize == theSize;
+}
+
+
+
+static bool
+validateRecords(
+            const XMLUInt32*    theRecords,
+            XMLUInt32           theRecordCount,
+            XMLUInt32           theStringCount)
+{
+    XMLUInt32   theDepth = 0;
+    XMLUInt32   theDocumentElementCount = 0;
+
+    const XMLUInt32* const  theEnd = theRecords + theRecordCount;
+
+    while (theRecords != theEnd)
+    {
+        const XMLUInt32     theAvailable = XMLUInt32(theEnd - theRecords);
+
+        switch(*theRecords)
+        {
+        case XalanSourceTreeImage::eElement:
+            {
+                if (theAvailable < 5 ||
+                    isValidString(theRecords[1], theStringCount) == false ||
+                    isValidString(theRecords[2], theStringCount) == false ||
+                    isValidString(theRecords[3], theStringCount) == false ||
+                    theRecords[4] > (theAvailable - 5) / 5)
+                {
+                    return false;
+                }
+
+                const XMLUInt32     theAttributeCount = theRecords[4];
+
+                theRecords += 5;
+
+                for (XMLUInt32 i = 0; i < theAttributeCount; ++i, theRecords += 5)
+                {
+                    if (isValidString(theRecords[0], theStringCount) == false ||
+                        isValidString(theRecords[1], theStringCount) == false ||
+                        isValidString(theRecords[2], theStringCount) == false ||
+                        isValidString(theRecords[3], theStringCount) == false)
+                    {
+                        return false;
+                    }
+                }
+
+                if (theDepth == 0)
+                {
+                    ++theDocumentElementCount;
+                }
+
+                ++theDepth;
+            }
+            break;
+
+        case XalanSourceTreeImage::eEndElement:
+            if (theDepth == 0)
+            {
+                return false;
+            }
+
+            --theDepth;
+            theRecords += 1;
+            break;
+
+        case XalanSourceTreeImage::eText:
+            // Only elements have text children...
+            if (theAvailable < 2 ||
+                theDepth == 0 ||
+                isValidString(theRecords[1], theStringCount) == false)
+            {
+                return false;
+            }
+
+            theRecords += 2;
+            break;
+
+        case XalanSourceTreeImage::eComment:
+            if (theAvailable < 2 ||
+                isValidString(theRecords[1], theStringCount) == false)
+            {
+                return false;
+            }
+
+            theRecords += 2;
+            break;
+
+        case XalanSourceTreeImage::eProcessingInstruction:
+            if (theAvailable < 3 ||
+                isValidString(theRecords[1], theStringCount) == false ||
+                isValidString(theRecords[2], theStringCount) == false)
+            {
+                return false;
+            }
+
+            theRecords += 3;
+            break;
+
+        case XalanSourceTreeImage::eUnparsedEntity:
+            // Entities are declared before the document element...
+            if (theAvailable < 3 ||
+                theDocumentElementCount != 0 ||
+                isValidString(theRecords[1], theStringCount) == false ||
+                isValidString(theRecords[2], theStringCount) == false)
+            {
+                return false;
+            }
+
+            theRecords += 3;
+            break;
+
+        default:
+            return false;
+        }
+    }
+
+    return theDepth == 0 && theDocumentElementCount == 1;
+}
+
+
+
+bool
+XalanSourceTreeImage::validate(
+            const void*         theImage,
+            size_type           theSize,
+            XalanDOMString&     theURI)
+{
+    if (theImage == 0 ||
+        reinterpret_cast<size_t>(theImage) % sizeof(XMLUInt32) != 0 ||
+        theSize < eHeaderSize * sizeof(XMLUInt32))
+    {
+        return false;
+    }
+
+    const XMLUInt32* const  theHeader =
+        static_cast<const XMLUInt32*>(theImage);
+
+    if (theHeader[eHeaderMagic] != eMagic ||
+        theHeader[eHeaderVersion] != eVersion ||
+        theHeader[eHeaderByteOrder] != eByteOrderMark ||
+        theHeader[eHeaderCharSize] != sizeof(XalanDOMChar))
+    {
+        return false;
+    }
+
+    if (hasValidCounts(theHeader, theSize) == false)
+    {
+        return false;
+    }
+
+    const XMLUInt32     theStringCount = theHeader[eHeaderStringCount];
+    const XMLUInt32     theRecordCount = theHeader[eHeaderRecordCount];
+    const XMLUInt32     theCharCount = theHeader[eHeaderCharCount];
+
+    if (isValidString(theHeader[eHeaderURI], theStringCount) == false)
+    {
+        return false;
+    }
+
+    const XMLUInt32* const      theOffsets = theHeader + eHeaderSize;
+    const XMLUInt32* const      theRecords = theOffsets + theStringCount + 1;
+    const XalanDOMChar* const   theChars =
+        reinterpret_cast<const XalanDOMChar*>(theRecords + theRecordCount);
+
+    // Every string must be null-terminated, and must not overlap
+    // the next string.
+    if (theOffsets[0] != 0 || theOffsets[theStringCount] != theCharCount)
+    {
+        return false;
+    }
+
+    for (XMLUInt32 i = 0; i < theStringCount; ++i)
+    {
+        if (theOffsets[i] >= theOffsets[i + 1] ||
+            theChars[theOffsets[i + 1] - 1] != 0)
+        {
+            return false;
+        }
+    }
+
+    if (validateRecords(theRecords, theRecordCount, theStringCount) == false)
+    {
+        return false;
+    }
+
+    const XMLUInt32     theURIIndex = theHeader[eHeaderURI];
+
+    theURI.assign(
+        theChars + theOffsets[theURIIndex],
+        theOffsets[theURIIndex + 1] - theOffsets[theURIIndex] - 1);
+
+    return true;
+}
+
+
+
+bool
+XalanSourceTreeImage::read(
+            const void*         theImage,
+            size_type           theSize,
+            ContentHandlerType& theContentHandler,
+            DTDHandlerType*     theDTDHandler,
+            LexicalHandlerType* theLexicalHandler,
+            MemoryManager&      theManager)
+{
+    const XMLUInt32* const  theHeader =
+        static_cast<const XMLUInt32*>(theImage);
+
+    if (theHeader == 0 ||
+        theSize < eHeaderSize * sizeof(XMLUInt32) ||
+        hasValidCounts(theHeader, theSize) == false)
+    {
+        return false;
+    }
+
+    const XMLUInt32* const      theOffsets = theHeader + eHeaderSize;
+    const XMLUInt32*            theRecords = theOffsets + theHeader[eHeaderStringCount] + 1;
+    const XMLUInt32* const      theEnd = theRecords + theHeader[eHeaderRecordCount];
+    const XalanDOMChar* const   theChars =
+        reinterpret_cast<const XalanDOMChar*>(theEnd);
+
+    AttributesImpl  theAttributes(theManager);
+
+    // The start of each open element's record, for the
+    // names passed to endElement()...
+    XalanVector<const XMLUInt32*>   theElementStack(theManager);
+
+    theContentHandler.startDocument();
+
+    while (theRecords != theEnd)
+    {
+        switch(*theRecords)
+        {
+        case eElement:
+            {
+                const XalanDOMChar* const   theQName = theChars + theOffsets[theRecords[1]];
+                const XalanDOMChar* const   theURI = theChars + theOffsets[theRecords[2]];
+                const XalanDOMChar* const   theLocalName = theChars + theOffsets[theRecords[3]];
+                const XMLUInt32             theAttributeCount = theRecords[4];
+
+                theElementStack.push_back(theRecords);
+
+                theRecords += 5;
+
+                theAttributes.clear();
+
+                for (XMLUInt32 i = 0; i < theAttributeCount; ++i, theRecords += 5)
+                {
+                    const XalanDOMChar* const   theAttributeName = theChars + theOffsets[theRecords[0]];
+
+                    // A parser reports an attribute without a prefix in
+                    // no namespace, with its name as its local name.  That
+                    // includes a default namespace declaration, which a DOM
+                    // puts in the XMLNS namespace.
+                    const bool  fHasPrefix =
+                        indexOf(theAttributeName, XalanUnicode::charColon) != length(theAttributeName);
+
+                    theAttributes.addAttribute(
+                        fHasPrefix == true ? theChars + theOffsets[theRecords[1]] : theChars + theOffsets[0],
+                        fHasPrefix == true ? theChars + theOffsets[theRecords[2]] : theAttributeName,
+                        theAttributeName,
+                        theRecords[4] == eAttributeIsID ? s_idString : s_cdataString,
+                        theChars + theOffsets[theRecords[3]]);
+                }
+
+                theContentHandler.startElement(
+                    theURI,
+                    theLocalName,
+                    theQName,
+                    theAttributes);
+            }
+            break;
+
+        case eEndElement:
+            {
+                assert(theElementStack.empty() == false);
+
+                const XMLUInt32* const  theElement = theElementStack.back();
+
+                theElementStack.pop_back();
+
+                theContentHandler.endElement(
+                    theChars + theOffsets[theElement[2]],
+                    theChars + theOffsets[theElement[3]],
+                    theChars + theOffsets[theElement[1]]);
+
+                theRecords += 1;
+            }
+            break;
+
+        case eText:
+            theContentHandler.characters(
+                theChars + theOffsets[theRecords[1]],
+                theOffsets[theRecords[1] + 1] - theOffsets[theRecords[1]] - 1);
+
+            theRecords += 2;
+            break;
+
+        case eComment:
+            if (theLexicalHandler != 0)
+            {
+                theLexicalHandler->comment(
+                    theChars + theOffsets[theRecords[1]],
+                    theOffsets[theRecords[1] + 1] - theOffsets[theRecords[1]] - 1);
+            }
+
+            theRecords += 2;
+            break;
+
+        case eProcessingInstruction:
+            theContentHandler.processingInstruction(
+                theChars + theOffsets[theRecords[1]],
+                theChars + theOffsets[theRecords[2]]);
+
+            theRecords += 3;
+            break;
+
+        case eUnparsedEntity:
+            if (theDTDHandler != 0)
+            {
+                theDTDHandler->unparsedEntityDecl(
+                    theChars + theOffsets[theRecords[1]],
+                    theChars,
+                    theChars + theOffsets[theRecords[2]],
+                    theChars);
+            }
+
+            theRecords += 3;
+            break;
+
+        default:
+            assert(false);
+
+            theRecords = theEnd;
+            break;
+        }
+    }
+
+    assert(theElementStack.empty() == true);
+
+    theContentHandler.endDocument();
+
+    return true;
+}
+
+
+
+}
@@ -0,0 +1,156 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANSOURCETREEIMAGE_HEADER_GUARD_1357924680)
+#define XALANSOURCETREEIMAGE_HEADER_GUARD_1357924680
+
+
+
+#include <xalanc/XalanSourceTree/XalanSourceTreeDefinitions.hpp>
+
+
+
+#include <cstddef>
+#include <iosfwd>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+namespace XERCES_CPP_NAMESPACE
+{
+    class ContentHandler;
+    class DTDHandler;
+    class LexicalHandler;
+}
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+typedef xercesc::ContentHandler   ContentHandlerType;
+typedef xercesc::DTDHandler       DTDHandlerType;
+typedef xercesc::LexicalHandler   LexicalHandlerType;
+
+
+
+class XalanSourceTreeDocument;
+
+
+
+/**
+ * Reads and writes a binary image of a source tree document, so a
+ * document can be parsed once and later rebuilt without running the
+ * XML parser again.
+ *
+ * An image holds every distinct string in the document once, followed
+ * by the nodes in document order as records which refer to the strings
+ * by their index.  Nothing in an image depends on where it is loaded,
+ * so an image can be mapped straight from a file with
+ * XalanMemoryMappedFile and read in place.  Reading an image replays
+ * the document as SAX2 events, so building the tree with a
+ * XalanSourceTreeContentHandler gives a document whose nodes are in the
+ * same order as the original document, with the same IDs and unparsed
+ * entities.
+ *
+ * An image uses the byte order and character size of the platform that
+ * wrote it, and is rejected on a platform where they differ.
+ */
+class XALAN_XALANSOURCETREE_EXPORT XalanSourceTreeImage
+{
+public:
+
+    typedef std::size_t     size_type;
+
+    /**
+     * Write an image of a document.
+     *
+     * @param theDocument The document
+     * @param theURI The URI of the document, which is stored in the image
+     * @param theStream The stream for the image, which should be opened in binary mode
+     * @param theManager The memory manager to use for temporary storage
+     */
+    static void
+    write(
+            const XalanSourceTreeDocument&  theDocument,
+            const XalanDOMString&           theURI,
+            std::ostream&                   theStream,
+            MemoryManager&                  theManager);
+
+    /**
+     * Check that an image is well-formed, and get the URI of the
+     * document it was made from.  The image must be aligned on a
+     * 4-byte boundary.
+     *
+     * @param theImage The image
+     * @param theSize The size of the image, in bytes
+     * @param theURI The URI of the document
+     * @return true if the image is well-formed, false if not.
+     */
+    static bool
+    validate(
+            const void*         theImage,
+            size_type           theSize,
+            XalanDOMString&     theURI);
+
+    /**
+     * Replay the document in an image as SAX2 events.  The image must
+     * have been checked with validate().  The counts in the image's
+     * header are checked against its size again, and no events are
+     * sent if they don't match.
+     *
+     * @param theImage The image
+     * @param theSize The size of the image, in bytes
+     * @param theContentHandler The handler for the document's content
+     * @param theDTDHandler The handler for unparsed entities, or 0
+     * @param theLexicalHandler The handler for comments, or 0
+     * @param theManager The memory manager to use for temporary storage
+     * @return true if the image was read, false if its counts don't match its size.
+     */
+    static bool
+    read(
+            const void*         theImage,
+            size_type           theSize,
+            ContentHandlerType& theContentHandler,
+            DTDHandlerType*     theDTDHandler,
+            LexicalHandlerType* theLexicalHandler,
+            MemoryManager&      theManager);
+
+    enum eRecordType
+    {
+        eElement = 1,
+        eEndElement = 2,
+        eText = 3,
+        eComment = 4,
+        eProcessingInstruction = 5,
+        eUnparsedEntity = 6
+    };
+
+    enum { eAttributeIsID = 1 };
+};
+
+
+
+}
+
+
+
+#endif  // XALANSOURCETREEIMAGE_HEADER_GUARD_1357924680
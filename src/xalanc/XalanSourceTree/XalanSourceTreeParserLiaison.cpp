@@ -54,7 +54,9 @@ XalanSourceTreeParserLiaison::XalanSourceTreeParserLiaison(
     m_xercesParserLiaison(theManager),
     m_documentMap(theManager),
     m_poolAllText(true),
-    m_xmlReader(0)
+    m_cacheNodeNumbers(false),
+    m_xmlReader(0),
+    m_projection(0)
 {
 }
 
@@ -64,7 +66,9 @@ XalanSourceTreeParserLiaison::XalanSourceTreeParserLiaison(MemoryManager&   theM
     m_xercesParserLiaison(theManager),
     m_documentMap(theManager),
     m_poolAllText(true),
-    m_xmlReader(0)
+    m_cacheNodeNumbers(false),
+    m_xmlReader(0),
+    m_projection(0)
 {
 }
 
@@ -239,6 +243,8 @@ XalanSourceTreeParserLiaison::parseXMLStream(
                                         getMemoryManager(),
                                         theDocument);
 
+    theContentHandler.setProjection(m_projection);
+
     parseXMLStream(
         inputSource,
         theContentHandler,
@@ -246,6 +252,11 @@ XalanSourceTreeParserLiaison::parseXMLStream(
         &theContentHandler,
         &theContentHandler);
 
+    if (m_cacheNodeNumbers == true)
+    {
+        theDocument->createNodeNumberCache();
+    }
+
     return theGuard.release();
 }
 
@@ -337,6 +348,50 @@ XalanSourceTreeParserLiaison::parseXMLStream(
 
 
 
+bool
+XalanSourceTreeParserLiaison::parseFirst(
+            const InputSource&      theInputSource,
+            XMLPScanToken&          theToken,
+            ContentHandler&         theContentHandler,
+            DTDHandler*             theDTDHandler,
+            LexicalHandler*         theLexicalHandler)
+{
+    ensureReader();
+
+    assert(m_xmlReader != 0);
+
+    m_xmlReader->setContentHandler(&theContentHandler);
+
+    m_xmlReader->setDTDHandler(theDTDHandler);
+
+    m_xmlReader->setLexicalHandler(theLexicalHandler);
+
+    return m_xmlReader->parseFirst(theInputSource, theToken);
+}
+
+
+
+bool
+XalanSourceTreeParserLiaison::parseNext(XMLPScanToken&  theToken)
+{
+    assert(m_xmlReader != 0);
+
+    return m_xmlReader->parseNext(theToken);
+}
+
+
+
+void
+XalanSourceTreeParserLiaison::parseReset(XMLPScanToken&     theToken)
+{
+    if (m_xmlReader != 0)
+    {
+        m_xmlReader->parseReset(theToken);
+    }
+}
+
+
+
 DOMDocument_Type*
 XalanSourceTreeParserLiaison::createDOMFactory()
 {
@@ -39,6 +39,7 @@ namespace XERCES_CPP_NAMESPACE
     class DTDHandler;
     class LexicalHandler;
     class SAX2XMLReaderImpl;
+    class XMLPScanToken;
 }
 
 
@@ -49,6 +50,7 @@ namespace XALAN_CPP_NAMESPACE {
 
 class XalanSourceTreeDOMSupport;
 class XalanSourceTreeDocument;
+class XalanSourceTreeProjection;
 
 
 
@@ -63,6 +65,7 @@ using xercesc::ContentHandler;
 using xercesc::DTDHandler;
 using xercesc::LexicalHandler;
 using xercesc::SAX2XMLReaderImpl;
+using xercesc::XMLPScanToken;
 
 
 class XALAN_XALANSOURCETREE_EXPORT  XalanSourceTreeParserLiaison : public XMLParserLiaison
@@ -119,6 +122,56 @@ public:
         m_poolAllText = fValue;
     }
 
+    /**
+     * Get the value of the flag which determines if documents built
+     * by parseXMLStream() cache the number values of their nodes.
+     *
+     * @return true if the number values are cached, false otherwise.
+     */
+    bool
+    getCacheNodeNumbers() const
+    {
+        return m_cacheNodeNumbers;
+    }
+
+    /**
+     * Set the value of the flag which determines if documents built
+     * by parseXMLStream() cache the number values of their nodes.
+     * The cache is made once the document is parsed, and it may be
+     * shared between threads.
+     *
+     * @param fValue The new value for the flag.
+     */
+    void
+    setCacheNodeNumbers(bool    fValue)
+    {
+        m_cacheNodeNumbers = fValue;
+    }
+
+    /**
+     * Get the projection used when parsing documents.
+     *
+     * @return The projection, or 0 if every node is built.
+     */
+    const XalanSourceTreeProjection*
+    getProjection() const
+    {
+        return m_projection;
+    }
+
+    /**
+     * Set the projection to use when parsing documents with
+     * parseXMLStream().  Only the parts of a document which are
+     * in the projection are built.
+     *
+     * @param theProjection The projection, or 0 to build every node.
+     */
+    void
+    setProjection(const XalanSourceTreeProjection*  theProjection)
+    {
+        m_projection = theProjection;
+    }
+
     // These interfaces are inherited from XMLParserLiaison...
 
     virtual void
@@ -197,6 +250,45 @@ public:
             DTDHandler*             theDTDHandler = 0,
             LexicalHandler*         theLexicalHandler = 0);
 
+    /**
+     * Begin a progressive parse using a SAX2 ContentHandler, DTDHandler,
+     * and LexicalHandler.  The parser stops after the first markup item,
+     * and parseNext() must be called to continue.
+     *
+     * @param theInputSource The input source for the parser
+     * @param theToken The scan token which keeps the state of the parse
+     * @param theContentHandler The ContentHandler to use
+     * @param theDTDHandler The DTDHandler to use.  May be null.
+     * @param theLexicalHandler The LexicalHandler to use.  May be null.
+     * @return true if the parse started, false if not.
+     */
+    bool
+    parseFirst(
+            const InputSource&      theInputSource,
+            XMLPScanToken&          theToken,
+            ContentHandler&         theContentHandler,
+            DTDHandler*             theDTDHandler = 0,
+            LexicalHandler*         theLexicalHandler = 0);
+
+    /**
+     * Continue a progressive parse started by parseFirst(), up to
+     * the next markup item.
+     *
+     * @param theToken The scan token passed to parseFirst()
+     * @return true if there is more to parse, false at the end of the
+     * document.
+     */
+    bool
+    parseNext(XMLPScanToken&    theToken);
+
+    /**
+     * Abandon a progressive parse, so the parser can be used again.
+     *
+     * @param theToken The scan token passed to parseFirst()
+     */
+    void
+    parseReset(XMLPScanToken&   theToken);
+
     virtual DOMDocument_Type*
     createDOMFactory();
 
@@ -384,7 +476,11 @@ private:
 
     bool                        m_poolAllText;
 
+    bool                        m_cacheNodeNumbers;
+
     SAX2XMLReaderImpl*          m_xmlReader;
+
+    const XalanSourceTreeProjection*    m_projection;
 };
 
 
@@ -0,0 +1,181 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "XalanSourceTreeProjection.hpp"
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+XalanSourceTreeProjection::XalanSourceTreeProjection(MemoryManager&     theManager) :
+    m_namespaceURIs(theManager),
+    m_localNames(theManager),
+    m_flags(theManager),
+    m_restrictDocumentElement(false)
+{
+}
+
+
+
+XalanSourceTreeProjection::~XalanSourceTreeProjection()
+{
+}
+
+
+
+XalanSourceTreeProjection::size_type
+XalanSourceTreeProjection::addElementName(
+            const XalanDOMString&   theNamespaceURI,
+            const XalanDOMString&   theLocalName)
+{
+    const size_type     theIndex = find(theNamespaceURI.c_str(), theLocalName.c_str());
+
+    if (theIndex != m_localNames.size())
+    {
+        return theIndex;
+    }
+    else
+    {
+        m_namespaceURIs.push_back(theNamespaceURI);
+        m_localNames.push_back(theLocalName);
+        m_flags.push_back(0);
+
+        return theIndex;
+    }
+}
+
+
+
+XalanSourceTreeProjection::eElementType
+XalanSourceTreeProjection::getElementType(
+            const XalanDOMChar*     theNamespaceURI,
+            const XalanDOMChar*     theLocalName) const
+{
+    const size_type     theIndex = find(theNamespaceURI, theLocalName);
+
+    if (theIndex == m_localNames.size())
+    {
+        return eSkipElement;
+    }
+    else if ((m_flags[theIndex] & eSubtreeFlag) != 0)
+    {
+        return eBuildSubtree;
+    }
+    else
+    {
+        return eBuildElement;
+    }
+}
+
+
+
+void
+XalanSourceTreeProjection::restrictDocumentElement(const XalanVector<size_type>&    theIndices)
+{
+    const FlagsVectorType::size_type    theSize = m_flags.size();
+
+    for (FlagsVectorType::size_type i = 0; i < theSize; ++i)
+    {
+        m_flags[i] &= ~eDocumentElementFlag;
+    }
+
+    const XalanVector<size_type>::const_iterator    theEnd = theIndices.end();
+
+    for (XalanVector<size_type>::const_iterator i = theIndices.begin(); i != theEnd; ++i)
+    {
+        assert(*i < theSize);
+
+        m_flags[*i] |= eDocumentElementFlag;
+    }
+
+    m_restrictDocumentElement = true;
+}
+
+
+
+bool
+XalanSourceTreeProjection::isAllowedDocumentElement(
+            const XalanDOMChar*     theNamespaceURI,
+            const XalanDOMChar*     theLocalName) const
+{
+    if (m_restrictDocumentElement == false)
+    {
+        return true;
+    }
+    else
+    {
+        const size_type     theIndex = find(theNamespaceURI, theLocalName);
+
+        return theIndex != m_localNames.size() &&
+               (m_flags[theIndex] & eDocumentElementFlag) != 0;
+    }
+}
+
+
+
+void
+XalanSourceTreeProjection::clear()
+{
+    m_namespaceURIs.clear();
+    m_localNames.clear();
+    m_flags.clear();
+
+    m_restrictDocumentElement = false;
+}
+
+
+
+XalanSourceTreeProjection::size_type
+XalanSourceTreeProjection::find(
+            const XalanDOMChar*     theNamespaceURI,
+            const XalanDOMChar*     theLocalName) const
+{
+    assert(theLocalName != 0);
+
+    // Stylesheets name only a handful of elements, so a linear
+    // search is faster than hashing the name of every element.
+    const size_type     theSize = m_localNames.size();
+
+    for (size_type i = 0; i < theSize; ++i)
+    {
+        if (XalanDOMString::equals(m_localNames[i], theLocalName) == true)
+        {
+            const XalanDOMString&   theURI = m_namespaceURIs[i];
+
+            if (theNamespaceURI == 0 || *theNamespaceURI == 0)
+            {
+                if (theURI.empty() == true)
+                {
+                    return i;
+                }
+            }
+            else if (XalanDOMString::equals(theURI, theNamespaceURI) == true)
+            {
+                return i;
+            }
+        }
+    }
+
+    return theSize;
+}
+
+
+
+}
@@ -0,0 +1,192 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANSOURCETREEPROJECTION_HEADER_GUARD_1357924680)
+#define XALANSOURCETREEPROJECTION_HEADER_GUARD_1357924680
+
+
+
+#include <xalanc/XalanSourceTree/XalanSourceTreeDefinitions.hpp>
+
+
+
+#include <xalanc/Include/XalanVector.hpp>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * A projection of a source document, which holds the elements that a
+ * stylesheet can reach by name.  When a XalanSourceTreeContentHandler
+ * is given a projection, only these elements and their ancestors are
+ * built, along with their attributes.  The content of an element is
+ * only built if the projection says that the whole subtree is needed.
+ * Everything else inside of the document element is skipped.
+ */
+class XALAN_XALANSOURCETREE_EXPORT XalanSourceTreeProjection
+{
+public:
+
+    typedef XalanVector<XalanDOMString>     StringVectorType;
+    typedef XalanVector<char>               FlagsVectorType;
+    typedef StringVectorType::size_type     size_type;
+
+    enum eElementType
+    {
+        // The element is skipped, unless it's an ancestor of an
+        // element which is built.
+        eSkipElement,
+
+        // The element and its attributes are built.
+        eBuildElement,
+
+        // The element and everything in it is built.
+        eBuildSubtree
+    };
+
+    explicit
+    XalanSourceTreeProjection(MemoryManager&    theManager);
+
+    ~XalanSourceTreeProjection();
+
+    /**
+     * Add the expanded name of an element to the projection, if
+     * it's not already there.
+     *
+     * @param theNamespaceURI The namespace URI of the element, which is empty for no namespace
+     * @param theLocalName The local name of the element
+     * @return The index of the name
+     */
+    size_type
+    addElementName(
+            const XalanDOMString&   theNamespaceURI,
+            const XalanDOMString&   theLocalName);
+
+    /**
+     * Get the number of element names in the projection.
+     *
+     * @return The number of names
+     */
+    size_type
+    getElementNameCount() const
+    {
+        return m_localNames.size();
+    }
+
+    /**
+     * Require the whole subtree of the elements with a name.
+     *
+     * @param theIndex The index of the name
+     */
+    void
+    setBuildSubtree(size_type   theIndex)
+    {
+        assert(theIndex < m_flags.size());
+
+        m_flags[theIndex] |= eSubtreeFlag;
+    }
+
+    bool
+    getBuildSubtree(size_type   theIndex) const
+    {
+        assert(theIndex < m_flags.size());
+
+        return (m_flags[theIndex] & eSubtreeFlag) != 0;
+    }
+
+    /**
+     * Determine how much of an element to build.
+     *
+     * @param theNamespaceURI The namespace URI of the element, which may be null for no namespace
+     * @param theLocalName The local name of the element
+     * @return The type of the element
+     */
+    eElementType
+    getElementType(
+            const XalanDOMChar*     theNamespaceURI,
+            const XalanDOMChar*     theLocalName) const;
+
+    /**
+     * Restrict the names that the document element may have.  When the
+     * document element has any other name, the projection can't be used,
+     * and the whole document is built.
+     *
+     * @param theIndices The indices of the names allowed.
+     */
+    void
+    restrictDocumentElement(const XalanVector<size_type>&   theIndices);
+
+    /**
+     * Determine if the projection can be used for a document, given
+     * the name of its document element.
+     *
+     * @param theNamespaceURI The namespace URI of the element, which may be null for no namespace
+     * @param theLocalName The local name of the element
+     * @return true if the projection can be used
+     */
+    bool
+    isAllowedDocumentElement(
+            const XalanDOMChar*     theNamespaceURI,
+            const XalanDOMChar*     theLocalName) const;
+
+    void
+    clear();
+
+private:
+
+    enum
+    {
+        eSubtreeFlag = 1,
+        eDocumentElementFlag = 2
+    };
+
+    size_type
+    find(
+            const XalanDOMChar*     theNamespaceURI,
+            const XalanDOMChar*     theLocalName) const;
+
+    // Not implemented...
+    XalanSourceTreeProjection(const XalanSourceTreeProjection&);
+
+    XalanSourceTreeProjection&
+    operator=(const XalanSourceTreeProjection&);
+
+
+    // Data members...
+    StringVectorType    m_namespaceURIs;
+
+    StringVectorType    m_localNames;
+
+    FlagsVectorType     m_flags;
+
+    bool                m_restrictDocumentElement;
+};
+
+
+
+}
+
+
+
+#endif  // XALANSOURCETREEPROJECTION_HEADER_GUARD_1357924680
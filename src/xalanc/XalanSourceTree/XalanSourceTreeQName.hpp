@@ -0,0 +1,132 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANSOURCETREEQNAME_HEADER_GUARD_1357924680)
+#define XALANSOURCETREEQNAME_HEADER_GUARD_1357924680
+
+
+
+#include <xalanc/XalanSourceTree/XalanSourceTreeDefinitions.hpp>
+
+
+
+#include <cassert>
+
+
+
+#include <xalanc/XalanDOM/XalanDOMString.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * The local name, namespace URI and prefix of a namespace-qualified
+ * element or attribute in a source tree document.  The document keeps
+ * one instance for each distinct name, and the nodes refer to it, so
+ * each node needs one pointer for its name, rather than a reference to
+ * each of the strings.
+ */
+class XALAN_XALANSOURCETREE_EXPORT XalanSourceTreeQName
+{
+public:
+
+    XalanSourceTreeQName() :
+        m_localName(0),
+        m_namespaceURI(0),
+        m_prefix(0),
+        m_next(0)
+    {
+    }
+
+    /**
+     * Constructor.  The strings must live as long as the instance.
+     *
+     * @param theLocalName The local name
+     * @param theNamespaceURI The namespace URI
+     * @param thePrefix The namespace prefix
+     * @param theNext The next name with the same local name, if any.
+     */
+    XalanSourceTreeQName(
+            const XalanDOMString&           theLocalName,
+            const XalanDOMString&           theNamespaceURI,
+            const XalanDOMString&           thePrefix,
+            const XalanSourceTreeQName*     theNext = 0) :
+        m_localName(&theLocalName),
+        m_namespaceURI(&theNamespaceURI),
+        m_prefix(&thePrefix),
+        m_next(theNext)
+    {
+    }
+
+    const XalanDOMString&
+    getLocalName() const
+    {
+        assert(m_localName != 0);
+
+        return *m_localName;
+    }
+
+    const XalanDOMString&
+    getNamespaceURI() const
+    {
+        assert(m_namespaceURI != 0);
+
+        return *m_namespaceURI;
+    }
+
+    const XalanDOMString&
+    getPrefix() const
+    {
+        assert(m_prefix != 0);
+
+        return *m_prefix;
+    }
+
+    /**
+     * Get the next name with the same local name, but a different
+     * namespace URI or prefix.
+     *
+     * @return the next name, or 0 if there are no more.
+     */
+    const XalanSourceTreeQName*
+    getNext() const
+    {
+        return m_next;
+    }
+
+private:
+
+    // Data members...
+    const XalanDOMString*           m_localName;
+
+    const XalanDOMString*           m_namespaceURI;
+
+    const XalanDOMString*           m_prefix;
+
+    const XalanSourceTreeQName*     m_next;
+};
+
+
+
+}
+
+
+
+#endif  // !defined(XALANSOURCETREEQNAME_HEADER_GUARD_1357924680)
@@ -104,6 +104,25 @@ XalanDefaultParsedSourceDOMSupport::isNodeAfter(
 
 
 
+bool
+XalanDefaultParsedSourceDOMSupport::getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const
+{
+    // Check the wrapped XalanSourceTreeDOMSupport instance...
+    if (m_domSupport.getNodeNumber(theNode, theNumber) == true)
+    {
+        return true;
+    }
+    else
+    {
+        // Chain up to our parent...
+        return XalanSourceTreeDOMSupport::getNodeNumber(theNode, theNumber);
+    }
+}
+
+
+
 XalanDefaultParsedSourceHelper::XalanDefaultParsedSourceHelper(
             const XalanSourceTreeDOMSupport&    theSourceDOMSupport,
             MemoryManager&                      theManager) :
@@ -166,8 +185,10 @@ XalanDefaultParsedSource::XalanDefaultParsedSource(
             const XalanDOMChar*     theExternalSchemaLocation,
             const XalanDOMChar*     theExternalNoNamespaceSchemaLocation,
             bool                    fPoolAllTextNodes,
-            MemoryManager&          theManager) :
-    XalanParsedSource(),
+            MemoryManager&          theManager,
+            const XalanSourceTreeProjection*    theProjection,
+            bool                    fCacheNodeNumbers) :
+    XalanParsedSource(theManager),
     m_parserLiaison(theManager),
     m_domSupport(m_parserLiaison),
     m_parsedSource(0),
@@ -180,10 +201,17 @@ XalanDefaultParsedSource::XalanDefaultParsedSource(
     m_parserLiaison.setExternalSchemaLocation(theExternalSchemaLocation);
     m_parserLiaison.setExternalNoNamespaceSchemaLocation(theExternalNoNamespaceSchemaLocation);
     m_parserLiaison.setPoolAllText(fPoolAllTextNodes);
+    m_parserLiaison.setCacheNodeNumbers(fCacheNodeNumbers);
+
+    // The projection only applies to this document, and not to
+    // any documents loaded later by the document() function.
+    m_parserLiaison.setProjection(theProjection);
 
     m_parsedSource = m_parserLiaison.mapDocument(m_parserLiaison.parseXMLStream(theInputSource));
     assert(m_parsedSource != 0);
 
+    m_parserLiaison.setProjection(0);
+
     m_domSupport.setParserLiaison(&m_parserLiaison);
 
     const XalanDOMChar* const   theSystemID = theInputSource.getSystemId();
@@ -217,7 +245,9 @@ XalanDefaultParsedSource::create(
             XMLEntityResolver*      theXMLEntityResolver,
             const XalanDOMChar*     theExternalSchemaLocation,
             const XalanDOMChar*     theExternalNoNamespaceSchemaLocation,
-            bool                    fPoolAllTextNodes)
+            bool                    fPoolAllTextNodes,
+            const XalanSourceTreeProjection*    theProjection,
+            bool                    fCacheNodeNumbers)
 {
     typedef XalanDefaultParsedSource ThisType;
 
@@ -235,7 +265,9 @@ XalanDefaultParsedSource::create(
                                 theExternalSchemaLocation,
                                 theExternalNoNamespaceSchemaLocation,
                                 fPoolAllTextNodes,
-                                theManager);
+                                theManager,
+                                theProjection,
+                                fCacheNodeNumbers);
 
     theGuard.release();
 
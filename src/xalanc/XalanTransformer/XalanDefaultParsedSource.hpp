@@ -69,6 +69,11 @@ public:
             const XalanNode&    node1,
             const XalanNode&    node2) const;
 
+    virtual bool
+    getNodeNumber(
+            const XalanNode&    theNode,
+            double&             theNumber) const;
+
 private:
 
     // Not implemented...
@@ -137,7 +142,9 @@ public:
             const XalanDOMChar*     theExternalSchemaLocation = 0,
             const XalanDOMChar*     theExternalNoNamespaceSchemaLocation = 0,
             bool                    fPoolAllTextNodes = XalanSourceTreeDocument::getPoolAllTextNodes(),
-            MemoryManager&          theManager XALAN_DEFAULT_MEMMGR);
+            MemoryManager&          theManager XALAN_DEFAULT_MEMMGR,
+            const XalanSourceTreeProjection*    theProjection = 0,
+            bool                    fCacheNodeNumbers = false);
 
     static XalanDefaultParsedSource*
     create(
@@ -149,7 +156,9 @@ public:
             XMLEntityResolver*      theXMLEntityResolver = 0,
             const XalanDOMChar*     theExternalSchemaLocation = 0,
             const XalanDOMChar*     theExternalNoNamespaceSchemaLocation = 0,
-            bool                    fPoolAllTextNodes = XalanSourceTreeDocument::getPoolAllTextNodes());
+            bool                    fPoolAllTextNodes = XalanSourceTreeDocument::getPoolAllTextNodes(),
+            const XalanSourceTreeProjection*    theProjection = 0,
+            bool                    fCacheNodeNumbers = false);
 
     virtual
     ~XalanDefaultParsedSource();
@@ -163,6 +172,12 @@ public:
     virtual const XalanDOMString&
     getURI() const;
 
+    XalanSourceTreeDocument*
+    getSourceTreeDocument() const
+    {
+        return m_parsedSource;
+    }
+
 private:
 
     // Not implemented...
@@ -19,11 +19,16 @@
 
 
 
+#include <xalanc/XSLT/XalanKeyIndexCache.hpp>
+
+
+
 namespace XALAN_CPP_NAMESPACE {
 
 
     
-XalanParsedSource::XalanParsedSource()
+XalanParsedSource::XalanParsedSource(MemoryManager&  theManager) :
+    m_keyIndexCache(XalanKeyIndexCache::create(theManager))
 {
 }
 
@@ -31,6 +36,9 @@ XalanParsedSource::XalanParsedSource()
 
 XalanParsedSource::~XalanParsedSource()
 {
+    XalanDestroy(
+        m_keyIndexCache->getMemoryManager(),
+        m_keyIndexCache);
 }
 
 
@@ -38,6 +38,7 @@ namespace XALAN_CPP_NAMESPACE {
 
 
 class DOMSupport;
+class XalanKeyIndexCache;
 class XMLParserLiaison;
 
 
@@ -78,7 +79,7 @@ class XALAN_TRANSFORMER_EXPORT XalanParsedSource
 {
 public:
 
-    XalanParsedSource();
+    XalanParsedSource(MemoryManager&    theManager XALAN_DEFAULT_MEMMGR);
 
     virtual
     ~XalanParsedSource();
@@ -111,6 +112,30 @@ public:
      */
     virtual const XalanDOMString&
     getURI() const = 0;
+
+    /**
+     * Get the cache of xsl:key indexes for the source document.  The
+     * cache can be shared by transforms of the document on different
+     * threads.
+     *
+     * @return A reference to the cache.
+     */
+    XalanKeyIndexCache&
+    getKeyIndexCache() const
+    {
+        return *m_keyIndexCache;
+    }
+
+private:
+
+    // Not implemented...
+    XalanParsedSource(const XalanParsedSource&);
+
+    XalanParsedSource&
+    operator=(const XalanParsedSource&);
+
+
+    XalanKeyIndexCache* const   m_keyIndexCache;
 };
 
 
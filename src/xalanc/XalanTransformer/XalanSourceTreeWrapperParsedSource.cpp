@@ -43,7 +43,7 @@ XalanSourceTreeWrapperParsedSource::XalanSourceTreeWrapperParsedSource(
             XalanSourceTreeDOMSupport&      theDOMSupport,
             const XalanDOMString&           theURI,
             MemoryManager&              theManager) :
-    XalanParsedSource(),
+    XalanParsedSource(theManager),
     m_parserLiaison(theParserLiaison),
     m_domSupport(theDOMSupport),
     m_parsedSource(theDocument),
@@ -0,0 +1,122 @@
+/*
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements. See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership. The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the  "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#if !defined(XALANSTREAMEDSOURCE_HEADER_GUARD)
+#define XALANSTREAMEDSOURCE_HEADER_GUARD
+
+
+
+// Base include file.  Must be first.
+#include <xalanc/XalanTransformer/XalanTransformerDefinitions.hpp>
+
+
+
+#include <xalanc/XalanSourceTree/XalanSourceTreeDocument.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeDOMSupport.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeParserLiaison.hpp>
+
+
+
+#include <xalanc/XSLT/XalanStreamingSource.hpp>
+
+
+
+#include <xalanc/XalanTransformer/XalanParsedSource.hpp>
+
+
+
+namespace XALAN_CPP_NAMESPACE {
+
+
+
+/**
+ * This is designed to allow a XalanTransformer object to transform a
+ * document while it is parsed, using a XalanStreamingSource.  The
+ * document is parsed by the transformation, so an instance can only
+ * be used for one transformation.
+ */
+class XALAN_TRANSFORMER_EXPORT XalanStreamedSource : public XalanParsedSource
+{
+public:
+
+    XalanStreamedSource(
+            const InputSource&      theInputSource,
+            bool                    fValidate = false,
+            ErrorHandler*           theErrorHandler = 0,
+            EntityResolver*         theEntityResolver = 0,
+            XMLEntityResolver*      theXMLEntityResolver = 0,
+            const XalanDOMChar*     theExternalSchemaLocation = 0,
+            const XalanDOMChar*     theExternalNoNamespaceSchemaLocation = 0,
+            bool                    fPoolAllTextNodes = XalanSourceTreeDocument::getPoolAllTextNodes(),
+            MemoryManager&          theManager XALAN_DEFAULT_MEMMGR);
+
+    static XalanStreamedSource*
+    create(
+            MemoryManager&          theManager,
+            const InputSource&      theInputSource,
+            bool                    fValidate = false,
+            ErrorHandler*           theErrorHandler = 0,
+            EntityResolver*         theEntityResolver = 0,
+            XMLEntityResolver*      theXMLEntityResolver = 0,
+            const XalanDOMChar*     theExternalSchemaLocation = 0,
+            const XalanDOMChar*     theExternalNoNamespaceSchemaLocation = 0,
+            bool                    fPoolAllTextNodes = XalanSourceTreeDocument::getPoolAllTextNodes());
+
+    virtual
+    ~XalanStreamedSource();
+
+    virtual XalanDocument*
+    getDocument() const;
+
+    virtual XalanParsedSourceHelper*
+    createHelper(MemoryManager&     theManager) const;
+
+    virtual const XalanDOMString&
+    getURI() const;
+
+    XalanStreamingSource&
+    getStreamingSource()
+    {
+        return m_streamingSource;
+    }
+
+private:
+
+    // Not implemented...
+    XalanStreamedSource(const XalanStreamedSource&);
+
+    XalanStreamedSource&
+    operator=(const XalanStreamedSource&);
+
+
+    // Data members...
+    XalanSourceTreeParserLiaison    m_parserLiaison;
+
+    XalanSourceTreeDOMSupport       m_domSupport;
+
+    XalanStreamingSource            m_streamingSource;
+
+    XalanDOMString                  m_uri;
+};
+
+
+
+}
+
+
+
+#endif  // XALANSTREAMEDSOURCE_HEADER_GUARD
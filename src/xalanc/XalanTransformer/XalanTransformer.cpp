@@ -18,6 +18,7 @@
 #include "XalanTransformer.hpp"
 
 #include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <cstring>
 
@@ -32,6 +33,7 @@
 
 #include <xalanc/PlatformSupport/DOMStringHelper.hpp>
 #include <xalanc/PlatformSupport/DOMStringPrintWriter.hpp>
+#include <xalanc/PlatformSupport/XalanMemoryMappedFile.hpp>
 #include <xalanc/PlatformSupport/XalanMessageLoader.hpp>
 #include <xalanc/PlatformSupport/XalanOutputStreamPrintWriter.hpp>
 
@@ -52,6 +54,7 @@
 
 
 #include <xalanc/XalanSourceTree/XalanSourceTreeDOMSupport.hpp>
+#include <xalanc/XalanSourceTree/XalanSourceTreeImage.hpp>
 #include <xalanc/XalanSourceTree/XalanSourceTreeParserLiaison.hpp>
 
 
@@ -81,6 +84,7 @@
 #include "XalanCompiledStylesheetDefault.hpp"
 #include "XalanDefaultDocumentBuilder.hpp"
 #include "XalanDefaultParsedSource.hpp"
+#include "XalanStreamedSource.hpp"
 #include "XalanTransformerOutputStream.hpp"
 #include "XalanTransformerProblemListener.hpp"
 #include "XercesDOMParsedSource.hpp"
@@ -117,6 +121,11 @@ XalanTransformer::XalanTransformer(MemoryManager&   theManager):
     m_errorStream(0),
     m_warningStream(&std::cerr),
     m_outputEncoding(m_memoryManager),
+    m_cacheNodeNumbers(false),
+    m_streamingMode(false),
+    m_useSourceProjection(false),
+    m_useTransformArena(false),
+    m_transformArena(m_memoryManager),
     m_topXObjectFactory(XObjectFactoryDefault::create(m_memoryManager)),
     m_stylesheetExecutionContext(StylesheetExecutionContextDefault::create(m_memoryManager))
 {
@@ -291,9 +300,27 @@ XalanTransformer::transform(
             const XalanCompiledStylesheet*  theCompiledStylesheet,
             const XSLTResultTarget&         theResultTarget)
 {
+    assert(theCompiledStylesheet != 0);
+
+    if (m_streamingMode == true &&
+        theCompiledStylesheet->getStylesheetRoot()->isStreamable() == true)
+    {
+        return doStreamedTransform(
+                    theInputSource,
+                    theCompiledStylesheet,
+                    theResultTarget);
+    }
+
     const XalanParsedSource*    theParsedSource = 0;
- 
-    const int   theResult = parseSource(theInputSource, theParsedSource);
+
+    const int   theResult =
+        doParseSource(
+            theInputSource,
+            theParsedSource,
+            false,
+            m_useSourceProjection == true ?
+                theCompiledStylesheet->getStylesheetRoot()->getSourceProjection() :
+                0);
  
     if (theResult != 0)
     {
@@ -547,6 +574,27 @@ LoadErrorMessage(
 
 
 
+static void
+LoadErrorMessage(
+            XPathExecutionContext&      theExecutionContext,
+            XalanMessages::Codes        theCode,
+            const char*                 theParameter,
+            CharVectorType&             theMessage)
+{
+    typedef XPathExecutionContext::GetCachedString  GetCachedString;
+
+    const GetCachedString   theGuard(theExecutionContext);
+
+    XalanMessageLoader::getMessage(
+        theGuard.get(),
+        theCode,
+        theParameter);
+
+    TranscodeToLocalCodePage(theGuard.get(), theMessage, true);
+}
+
+
+
 int
 XalanTransformer::compileStylesheet(
             const XSLTInputSource&              theStylesheetSource,
@@ -735,6 +783,22 @@ XalanTransformer::parseSource(
             const XSLTInputSource&      theInputSource,
             const XalanParsedSource*&   theParsedSource,
             bool                        useXercesDOM)
+{
+    return doParseSource(
+                theInputSource,
+                theParsedSource,
+                useXercesDOM,
+                0);
+}
+
+
+
+int
+XalanTransformer::doParseSource(
+            const XSLTInputSource&              theInputSource,
+            const XalanParsedSource*&           theParsedSource,
+            bool                                useXercesDOM,
+            const XalanSourceTreeProjection*    theProjection)
 {
     // Clear the error message.
     m_errorMessage.clear();
@@ -771,7 +835,10 @@ XalanTransformer::parseSource(
                         m_entityResolver,
                         m_xmlEntityResolver,
                         getExternalSchemaLocation(),
-                        getExternalNoNamespaceSchemaLocation());
+                        getExternalNoNamespaceSchemaLocation(),
+                        XalanSourceTreeDocument::getPoolAllTextNodes(),
+                        theProjection,
+                        m_cacheNodeNumbers);
         }
 
         // Store it in a vector.
@@ -959,6 +1026,231 @@ XalanTransformer::removeTraceListener(TraceListener*    theTraceListener)
 
 
 
+int
+XalanTransformer::createSourceImage(
+            const XSLTInputSource&  theInputSource,
+            const char*             theImageFileName)
+{
+    // Clear the error message.
+    m_errorMessage.clear();
+    m_errorMessage.push_back(0);
+
+    int theResult = 0;
+
+    try
+    {
+        const XalanDefaultParsedSource  theParsedSource(
+                theInputSource,
+                m_useValidation,
+                m_errorHandler,
+                m_entityResolver,
+                m_xmlEntityResolver,
+                getExternalSchemaLocation(),
+                getExternalNoNamespaceSchemaLocation(),
+                XalanSourceTreeDocument::getPoolAllTextNodes(),
+                m_memoryManager);
+
+        std::ofstream   theStream(
+                theImageFileName,
+                std::ios_base::out | std::ios_base::binary);
+
+        if (theStream.is_open() == false)
+        {
+            LoadErrorMessage(
+                *m_stylesheetExecutionContext,
+                XalanMessages::ErrorOpeningFile_1Param,
+                theImageFileName,
+                m_errorMessage);
+
+            theResult = -1;
+        }
+        else
+        {
+            XalanSourceTreeImage::write(
+                *theParsedSource.getSourceTreeDocument(),
+                theParsedSource.getURI(),
+                theStream,
+                m_memoryManager);
+
+            theStream.close();
+
+            if (theStream.fail() == true)
+            {
+                LoadErrorMessage(
+                    *m_stylesheetExecutionContext,
+                    XalanMessages::ErrorWritingFile_1Param,
+                    theImageFileName,
+                    m_errorMessage);
+
+                theResult = -1;
+            }
+        }
+    }
+    catch(const XSLException&   e)
+    {
+        XalanDOMString theBuffer(m_memoryManager);
+
+        e.defaultFormat(theBuffer);
+
+        TranscodeToLocalCodePage(theBuffer, m_errorMessage, true);
+
+        theResult = -1;
+    }
+    catch(const SAXParseException&  e)
+    {
+        FormatSAXParseException(
+            *m_stylesheetExecutionContext,
+            e,
+            m_errorMessage);
+
+        theResult = -2;
+    }
+    catch(const SAXException&   e)
+    {
+        TranscodeToLocalCodePage(e.getMessage(), m_errorMessage, true);
+
+        theResult = -2;
+    }
+    catch(const XMLException&   e)
+    {
+        TranscodeToLocalCodePage(e.getMessage(), m_errorMessage, true);
+
+        theResult = -3;
+    }
+    catch(const XalanDOMException&  e)
+    {
+        FormatXalanDOMException(
+            *m_stylesheetExecutionContext,
+            e,
+            m_errorMessage);
+
+        theResult = -4;
+    }
+
+    return theResult;
+}
+
+
+
+int
+XalanTransformer::parseSourceImage(
+            const char*                 theImageFileName,
+            const XalanParsedSource*&   theParsedSource)
+{
+    // Clear the error message.
+    m_errorMessage.clear();
+    m_errorMessage.push_back(0);
+
+    XalanMemoryMappedFile   theImageFile(m_memoryManager);
+
+    if (theImageFile.open(XalanDOMString(theImageFileName, m_memoryManager)) == false)
+    {
+        LoadErrorMessage(
+            *m_stylesheetExecutionContext,
+            XalanMessages::ErrorOpeningFile_1Param,
+            theImageFileName,
+            m_errorMessage);
+
+        return -1;
+    }
+
+    XalanDOMString  theURI(m_memoryManager);
+
+    if (XalanSourceTreeImage::validate(
+            theImageFile.getData(),
+            theImageFile.getSize(),
+            theURI) == false)
+    {
+        LoadErrorMessage(
+            *m_stylesheetExecutionContext,
+            XalanMessages::InvalidSourceImage_1Param,
+            theImageFileName,
+            m_errorMessage);
+
+        return -1;
+    }
+
+    int theResult = 0;
+
+    try
+    {
+        // Allocate the memory now, to avoid leaking if push_back() fails.
+        m_parsedSources.reserve(m_parsedSources.size() + 1);
+
+        XalanMemMgrAutoPtr<XalanDefaultDocumentBuilder>     theBuilder(
+                m_memoryManager,
+                XalanDefaultDocumentBuilder::create(m_memoryManager, theURI));
+
+        if (XalanSourceTreeImage::read(
+                theImageFile.getData(),
+                theImageFile.getSize(),
+                *theBuilder->getContentHandler(),
+                theBuilder->getDTDHandler(),
+                theBuilder->getLexicalHandler(),
+                m_memoryManager) == false)
+        {
+            LoadErrorMessage(
+                *m_stylesheetExecutionContext,
+                XalanMessages::InvalidSourceImage_1Param,
+                theImageFileName,
+                m_errorMessage);
+
+            theResult = -1;
+        }
+        else
+        {
+            theParsedSource = theBuilder.releasePtr();
+
+            // Store it in a vector.
+            m_parsedSources.push_back(theParsedSource);
+        }
+    }
+    catch(const XSLException&   e)
+    {
+        XalanDOMString theBuffer(m_memoryManager);
+
+        e.defaultFormat(theBuffer);
+
+        TranscodeToLocalCodePage(theBuffer, m_errorMessage, true);
+
+        theResult = -1;
+    }
+    catch(const SAXParseException&  e)
+    {
+        FormatSAXParseException(
+            *m_stylesheetExecutionContext,
+            e,
+            m_errorMessage);
+
+        theResult = -2;
+    }
+    catch(const SAXException&   e)
+    {
+        TranscodeToLocalCodePage(e.getMessage(), m_errorMessage, true);
+
+        theResult = -2;
+    }
+    catch(const XMLException&   e)
+    {
+        TranscodeToLocalCodePage(e.getMessage(), m_errorMessage, true);
+
+        theResult = -3;
+    }
+    catch(const XalanDOMException&  e)
+    {
+        FormatXalanDOMException(
+            *m_stylesheetExecutionContext,
+            e,
+            m_errorMessage);
+
+        theResult = -4;
+    }
+
+    return theResult;
+}
+
+
+
 XalanDocumentBuilder*
 XalanTransformer::createDocumentBuilder(const XalanDOMString&   theURI)
 {
@@ -1072,6 +1364,38 @@ XalanTransformer::setIndent(int indentAmount)
 
 
 
+XalanSize_t
+XalanTransformer::getParallelSortThreshold() const
+{
+    return m_stylesheetExecutionContext->getParallelSortThreshold();
+}
+
+
+
+void
+XalanTransformer::setParallelSortThreshold(XalanSize_t  theThreshold)
+{
+    m_stylesheetExecutionContext->setParallelSortThreshold(theThreshold);
+}
+
+
+
+unsigned int
+XalanTransformer::getParallelSortThreadCount() const
+{
+    return m_stylesheetExecutionContext->getParallelSortThreadCount();
+}
+
+
+
+void
+XalanTransformer::setParallelSortThreadCount(unsigned int   theCount)
+{
+    m_stylesheetExecutionContext->setParallelSortThreadCount(theCount);
+}
+
+
+
 XalanTransformer::eEscapeURLs
 XalanTransformer::getEscapeURLs() const
 {
@@ -1233,12 +1557,43 @@ XalanTransformer::EnsureReset::~EnsureReset()
 
 
 
+int
+XalanTransformer::doStreamedTransform(
+            const XSLTInputSource&          theInputSource,
+            const XalanCompiledStylesheet*  theCompiledStylesheet,
+            const XSLTResultTarget&         theResultTarget)
+{
+    // The source is parsed by the transformation, so it's not
+    // kept with the other parsed sources.
+    XalanMemMgrAutoPtr<XalanStreamedSource>     theStreamedSource(
+            m_memoryManager,
+            XalanStreamedSource::create(
+                m_memoryManager,
+                theInputSource,
+                m_useValidation,
+                m_errorHandler,
+                m_entityResolver,
+                m_xmlEntityResolver,
+                getExternalSchemaLocation(),
+                getExternalNoNamespaceSchemaLocation()));
+
+    return doTransform(
+                *theStreamedSource,
+                theCompiledStylesheet,
+                0,
+                theResultTarget,
+                &theStreamedSource->getStreamingSource());
+}
+
+
+
 int
 XalanTransformer::doTransform(
             const XalanParsedSource&        theParsedXML,
             const XalanCompiledStylesheet*  theCompiledStylesheet,
             const XSLTInputSource*          theStylesheetSource,
-            const XSLTResultTarget&         theResultTarget)
+            const XSLTResultTarget&         theResultTarget,
+            XalanStreamingSource*           theStreamingSource)
 {
     int     theResult = 0;
 
@@ -1248,6 +1603,13 @@ XalanTransformer::doTransform(
     // Store error messages from problem listener.
     XalanDOMString  theErrorMessage(m_memoryManager);
 
+    // The objects which only live for the transformation can
+    // come from the arena, which is released when it's done.
+    MemoryManager&  theTransformManager =
+        m_useTransformArena == true ?
+            static_cast<MemoryManager&>(m_transformArena) :
+            m_memoryManager;
+
     try
     {
         XalanDocument* const    theSourceDocument = theParsedXML.getDocument();
@@ -1270,7 +1632,7 @@ XalanTransformer::doTransform(
         theParserLiaison.setUseValidation(m_useValidation);
 
         // Create some more support objects...
-        XSLTProcessorEnvSupportDefault  theXSLTProcessorEnvSupport(m_memoryManager);
+        XSLTProcessorEnvSupportDefault  theXSLTProcessorEnvSupport(theTransformManager);
 
         const XalanDOMString&   theSourceURI = theParsedXML.getURI();
 
@@ -1293,13 +1655,13 @@ XalanTransformer::doTransform(
             }
         }
 
-        XObjectFactoryDefault   theXObjectFactory(m_memoryManager);
+        XObjectFactoryDefault   theXObjectFactory(theTransformManager);
 
-        XPathFactoryBlock       theXPathFactory(m_memoryManager);
+        XPathFactoryBlock       theXPathFactory(theTransformManager);
 
         // Create a processor...
         XSLTEngineImpl  theProcessor(
-                    m_memoryManager,
+                    theTransformManager,
                     theParserLiaison,
                     theXSLTProcessorEnvSupport,
                     theDOMSupport,
@@ -1319,6 +1681,10 @@ XalanTransformer::doTransform(
 
         m_stylesheetExecutionContext->setXSLTProcessor(&theProcessor);
 
+        m_stylesheetExecutionContext->setKeyIndexCache(
+            theSourceDocument,
+            &theParsedXML.getKeyIndexCache());
+
         // Create a problem listener and send output to a XalanDOMString.  Do this before
         // pushing params, since there could be a problem resolving a QName.
         DOMStringPrintWriter    thePrintWriter(theErrorMessage);
@@ -1384,11 +1750,19 @@ XalanTransformer::doTransform(
 
             m_stylesheetExecutionContext->setStylesheetRoot(theCompiledStylesheet->getStylesheetRoot());
 
+            m_stylesheetExecutionContext->setStreamingSource(theStreamingSource);
+
             // Do the transformation...
             theProcessor.process(
                         theDocumentInputSource,
                         tempResultTarget,
                         *m_stylesheetExecutionContext);
+
+            if (theStreamingSource != 0)
+            {
+                // Parse the rest of the document, so any errors are reported.
+                theStreamingSource->finish();
+            }
         }
         else
         {
@@ -1480,6 +1854,12 @@ XalanTransformer::doTransform(
         theResult = -4;
     }
 
+    if (m_useTransformArena == true)
+    {
+        // Everything allocated from the arena is gone by now.
+        m_transformArena.reset();
+    }
+
     return theResult;
 }
 
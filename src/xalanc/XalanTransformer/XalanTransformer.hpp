@@ -34,6 +34,7 @@
 
 #include <xalanc/XalanDOM/XalanNode.hpp>
 #include <xalanc/Include/XalanMap.hpp>
+#include <xalanc/PlatformSupport/XalanArenaMemoryManager.hpp>
 #include <xalanc/XSLT/XalanParamHolder.hpp>
 #include <xalanc/XPath/XObjectFactoryDefault.hpp>
 
@@ -76,6 +77,8 @@ class XSLTInit;
 class XalanDocumentBuilder;
 class XalanCompiledStylesheet;
 class XalanParsedSource;
+class XalanSourceTreeProjection;
+class XalanStreamingSource;
 class XalanTransformerOutputStream;
 
 class XObjectFactoryDefault;
@@ -126,6 +129,13 @@ public:
      * instances of XalanTransformer.  This call is not thread-safe,
      * so you must serialize any calls to it, and you must track the
      * initialization state, so you do not call it more than once.
+     *
+     * Processes which run many transformations at once can use an
+     * instance of XalanThreadCachingMemoryManager, so most allocations
+     * don't contend for a lock.  The same instance must also be passed
+     * to XMLPlatformUtils::Initialize(), because Xerces-C frees some of
+     * the memory Xalan allocates with its own memory manager.  It can
+     * then be passed here, and to each XalanTransformer.
      */
     static void
     initialize(MemoryManager&   theManager = XalanMemMgrs::getDefaultXercesMemMgr());
@@ -415,6 +425,37 @@ public:
     int
     destroyParsedSource(const XalanParsedSource*    theParsedSource);
 
+    /**
+     * Parse a source XML document and write a binary image of it
+     * to a file.  The image can be loaded by parseSourceImage()
+     * much more quickly than the document can be parsed, so a large
+     * document which is transformed many times, or by many processes,
+     * only needs to be parsed once.  See XalanSourceTreeImage.
+     *
+     * @param theInputSource input source
+     * @param theImageFileName the name of the file for the image
+     * @return 0 for success
+     */
+    int
+    createSourceImage(
+            const XSLTInputSource&  theInputSource,
+            const char*             theImageFileName);
+
+    /**
+     * Load a document from an image written by createSourceImage().
+     * The file is mapped into memory, rather than read, while the
+     * document is built.  The XalanTransformer instance owns the
+     * XalanParsedSource instance, just as it does for parseSource().
+     *
+     * @param theImageFileName the name of the file with the image
+     * @param theParsedSource a reference to a pointer to a XalanParsedSource.
+     * @return 0 for success
+     */
+    int
+    parseSourceImage(
+            const char*                 theImageFileName,
+            const XalanParsedSource*&   theParsedSource);
+
     /**
      * Create a document builder.  Using the document builder, you
      * can construct a document using SAX2 interfaces.  The XalanTransformer
@@ -828,6 +869,134 @@ public:
         m_poolAllTextNodes = fPool;
     }
 
+    /**
+      * This member function gets the flag which determines if a default
+      * parsed source tree caches the number values of its nodes.
+      *
+      * @return The boolean value for the flag.
+      */
+    bool
+    getCacheNodeNumbers() const
+    {
+        return m_cacheNodeNumbers;
+    }
+
+    /**
+      * This member function sets the flag which determines if a default
+      * parsed source tree caches the number values of its nodes.  The
+      * table is made when the source is parsed, so it only applies to
+      * sources parsed by parseSource() and transform(), and not to source
+      * images or streamed documents.  This can speed up stylesheets
+      * which compare the same attributes or elements as numbers many
+      * times, at the cost of 8 bytes for every node.  A parsed source
+      * with the cache may be shared between threads.
+      *
+      * @param fCache The boolean value for the flag.
+      */
+    void
+    setCacheNodeNumbers(bool    fCache)
+    {
+        m_cacheNodeNumbers = fCache;
+    }
+
+    /**
+      * This member function gets the flag which determines if documents
+      * are transformed while they are parsed, when possible.
+      *
+      * @return The boolean value for the flag.
+      */
+    bool
+    getStreamingMode() const
+    {
+        return m_streamingMode;
+    }
+
+    /**
+      * This member function sets the flag which determines if documents
+      * are transformed while they are parsed, when possible.  This only
+      * applies to transformations of an input source with a compiled
+      * stylesheet which only navigates forward and down through the
+      * source document.  Since the processed parts of the document
+      * are discarded, this can result in significant memory savings
+      * for large documents.
+      *
+      * @param fStreaming The boolean value for the flag.
+      */
+    void
+    setStreamingMode(bool   fStreaming)
+    {
+        m_streamingMode = fStreaming;
+    }
+
+    /**
+      * This member function gets the flag which determines if only the
+      * parts of a document which a compiled stylesheet can reach are
+      * built.
+      *
+      * @return The boolean value for the flag.
+      */
+    bool
+    getUseSourceProjection() const
+    {
+        return m_useSourceProjection;
+    }
+
+    /**
+      * This member function sets the flag which determines if only the
+      * parts of a document which a compiled stylesheet can reach are
+      * built.  This only applies to transformations of an input source
+      * with a compiled stylesheet which has a projection.  Elements
+      * which are not named by the stylesheet, and which have no such
+      * elements inside of them, are skipped while the document is
+      * parsed.  Stylesheets which use constructs that might reach
+      * skipped elements have no projection, so the whole document is
+      * built as usual.
+      *
+      * @param fProjection The boolean value for the flag.
+      */
+    void
+    setUseSourceProjection(bool     fProjection)
+    {
+        m_useSourceProjection = fProjection;
+    }
+
+    /**
+      * This member function gets the flag which determines if the
+      * objects created while a transformation runs are allocated
+      * from an arena.
+      *
+      * @return The boolean value for the flag.
+      */
+    bool
+    getUseTransformArena() const
+    {
+        return m_useTransformArena;
+    }
+
+    /**
+      * This member function sets the flag which determines if the
+      * objects created while a transformation runs are allocated
+      * from an arena.  The processor, the XObjects and the XPaths
+      * of a transformation then come from large blocks which are all
+      * released when the transformation is done, instead of going to
+      * the memory manager one at a time.  Memory freed during the
+      * transformation is reused by later requests of the same size
+      * class.
+      *
+      * Only those objects use the arena.  The execution context is
+      * kept from one transformation to the next, so it and its caches
+      * still use the transformer's memory manager, as do the source
+      * and result documents.  XObjects in the arena are still
+      * reference counted and recycled by their factory as usual.
+      *
+      * @param fArena The boolean value for the flag.
+      */
+    void
+    setUseTransformArena(bool   fArena)
+    {
+        m_useTransformArena = fArena;
+    }
+
     /**
      * This method returns the installed ProblemListener instance.
      *
@@ -906,6 +1075,48 @@ public:
     void
     setIndent(int   indentAmount);
 
+    /**
+     * Get the minimum number of nodes for which the work of a sort
+     * is split between several threads.
+     *
+     * @return the threshold, or 0 if sorts are never split
+     */
+    XalanSize_t
+    getParallelSortThreshold() const;
+
+    /**
+     * Set the minimum number of nodes for which the work of a sort
+     * is split between several threads.  Those threads belong to a
+     * pool which every transformer shares, and which has one thread
+     * fewer than there are processors, since the transforming thread
+     * does some of the work as well.  Sort keys which are "." or an
+     * attribute, such as "@id", are read from the source tree on the
+     * pool's threads, so the transformer's memory manager must be
+     * thread-safe, as the default one is.
+     *
+     * @param theThreshold the threshold, or 0 to never split sorts
+     */
+    void
+    setParallelSortThreshold(XalanSize_t    theThreshold);
+
+    /**
+     * Get the maximum number of threads used for a sort, including
+     * the transforming thread.
+     *
+     * @return the number of threads, or 0 to use every thread of the pool
+     */
+    unsigned int
+    getParallelSortThreadCount() const;
+
+    /**
+     * Set the maximum number of threads used for a sort, including
+     * the transforming thread.
+     *
+     * @param theCount the number of threads, or 0 to use every thread of the pool
+     */
+    void
+    setParallelSortThreadCount(unsigned int     theCount);
+
     /**
      * Enums to determine whether or not run-time escaping of URLs has been set.
      */
@@ -1149,8 +1360,22 @@ private:
             const XalanParsedSource&        theParsedXML, 
             const XalanCompiledStylesheet*  theCompiledStylesheet,
             const XSLTInputSource*          theStylesheetSource,
+            const XSLTResultTarget&         theResultTarget,
+            XalanStreamingSource*           theStreamingSource = 0);
+
+    int
+    doStreamedTransform(
+            const XSLTInputSource&          theInputSource,
+            const XalanCompiledStylesheet*  theCompiledStylesheet,
             const XSLTResultTarget&         theResultTarget);
 
+    int
+    doParseSource(
+            const XSLTInputSource&              theInputSource,
+            const XalanParsedSource*&           theParsedSource,
+            bool                                useXercesDOM,
+            const XalanSourceTreeProjection*    theProjection);
+
 
     // Data members...
     MemoryManager&                          m_memoryManager;
@@ -1189,6 +1414,16 @@ private:
 
     bool                                    m_poolAllTextNodes;
 
+    bool                                    m_cacheNodeNumbers;
+
+    bool                                    m_streamingMode;
+
+    bool                                    m_useSourceProjection;
+
+    bool                                    m_useTransformArena;
+
+    XalanArenaMemoryManager                 m_transformArena;
+
     XObjectFactoryDefault*                  m_topXObjectFactory;
 
     // This should always be the latest data member!!!
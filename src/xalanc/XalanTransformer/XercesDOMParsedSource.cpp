@@ -87,7 +87,7 @@ XercesDOMParsedSource::XercesDOMParsedSource(
             const XalanDOMChar*     theExternalSchemaLocation,
             const XalanDOMChar*     theExternalNoNamespaceSchemaLocation,
             MemoryManager&          theManager) :
-    XalanParsedSource(),
+    XalanParsedSource(theManager),
     m_parserLiaison(theManager),
     m_parsedSource(0),
     m_uri(theManager)
@@ -46,7 +46,7 @@ XercesDOMWrapperParsedSource::XercesDOMWrapperParsedSource(
             XercesDOMSupport&           theDOMSupport,
             const XalanDOMString&       theURI,
             MemoryManager&          theManager) :
-    XalanParsedSource(),
+    XalanParsedSource(theManager),
     m_parserLiaison(theParserLiaison),
     m_domSupport(theDOMSupport),
     m_parsedSource(theParserLiaison.createDocument(theDocument, true, true)),
@@ -68,7 +68,7 @@ XercesDOMWrapperParsedSource::XercesDOMWrapperParsedSource(
             XercesDOMSupport&           theDOMSupport,
             const XalanDOMString&       theURI,
             MemoryManager&          theManager) :
-    XalanParsedSource(),
+    XalanParsedSource(theManager),
     m_parserLiaison(theParserLiaison),
     m_domSupport(theDOMSupport),
     m_parsedSource(theParserLiaison.createDocument(theDocument, true, true)),